@@ -55,6 +55,10 @@ _crinit-ctl() {
         status
         notify
         list
+        graph
+        trace
+        stats
+        locks
         reboot
         poweroff"
 
@@ -75,6 +79,9 @@ _crinit-ctl() {
         enable|disable|stop|kill|restart|status|notify)
             _add_static_options "--verbose $(crinit-ctl list 2>/dev/null | tail -n +2 | cut -f1 -d ' ')"
             ;;
+        stats)
+            _add_static_options "--prometheus --verbose"
+            ;;
         *)
             _add_static_options "--verbose"
     esac
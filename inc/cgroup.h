@@ -151,6 +151,23 @@ int crinitCGroupConfigure(crinitCgroup_t *cgroup);
  */
 int crinitCGroupAssignPID(crinitCgroup_t *cgroup, pid_t pid);
 
+/**
+ * @brief Send a signal to all processes in a cgroup.
+ *
+ * Opens (but does not create) the cgroup named by @p cgroup->name. For
+ * @c SIGKILL, the cgroup is killed as a whole by writing to @c cgroup.kill if
+ * the kernel supports it (Linux 5.14+), which also catches processes forking
+ * in the meantime. Otherwise, and for all other signals, each PID listed in
+ * @c cgroup.procs is signalled individually.
+ *
+ * @param[in] cgroup    Pointer to a crinitCgroup_t that holds a valid, non-empty name.
+ *                      Must not be NULL.
+ * @param[in] sig       The signal to send.
+ *
+ * @return On sucess 0, otherwise -1
+ */
+int crinitCGroupSignal(crinitCgroup_t *cgroup, int sig);
+
 /**
  * @brief Create all global cgroups (includes root cgroup if configured)
  * @return On sucess 0, otherwise -1
@@ -8,6 +8,7 @@
 
 #include "envset.h"
 #include "ioredir.h"
+#include "procattr.h"
 
 /**
  * Extract an array of strings from the value mapped to an indexed key in an crinitConfKvList_t.
@@ -94,3 +95,61 @@ int crinitConfConvToIntegerLL(long long *x, const char *confVal, int base);
  * @return  0 on success, -1 on error.
  */
 int crinitConfConvToBool(bool *b, const char *confVal);
+
+/**
+ * Converts a list of CPUs to the CPU affinity bitmask of a crinitProcAttr_t.
+ *
+ * The list consists of CPU numbers and ranges of CPU numbers (`<first>-<last>`), separated by commas and/or spaces,
+ * for example `0-3,6`.
+ *
+ * @param pa       The crinitProcAttr_t whose crinitProcAttr_t::cpus shall be set. Previously set CPUs are cleared.
+ * @param confVal  The string to convert.
+ *
+ * @return  0 on success, -1 on error.
+ */
+int crinitConfConvToCpuSet(crinitProcAttr_t *pa, const char *confVal);
+/**
+ * Converts a scheduling policy name to its numerical value.
+ *
+ * String must be one of `OTHER`, `BATCH`, `IDLE`, `FIFO`, or `RR` (case-insensitive), corresponding to the `SCHED_*`
+ * policies of the same name.
+ *
+ * @param policy   Output pointer for the scheduling policy.
+ * @param confVal  The string to convert.
+ *
+ * @return  0 on success, -1 on error.
+ */
+int crinitConfConvToSchedPolicy(int *policy, const char *confVal);
+/**
+ * Converts an I/O priority statement to a value suitable for ioprio_set().
+ *
+ * The string must be of the form
+ * ```
+ * <REALTIME | BEST_EFFORT | IDLE> [ LEVEL ]
+ * ```
+ * where LEVEL is the priority level within the class from 0 (highest) to 7 (lowest). The default level is 4. The IDLE
+ * class does not take a level.
+ *
+ * @param ioprio   Output pointer for the I/O priority value, see CRINIT_IOPRIO_VALUE().
+ * @param confVal  The string to convert.
+ *
+ * @return  0 on success, -1 on error.
+ */
+int crinitConfConvToIoPrio(int *ioprio, const char *confVal);
+/**
+ * Converts a resource limit statement to a resource and its limits.
+ *
+ * The string must be of the form
+ * ```
+ * <RESOURCE> <SOFT_LIMIT> [ HARD_LIMIT ]
+ * ```
+ * where RESOURCE is the name of a resource as in setrlimit() without the `RLIMIT_` prefix, for example `NOFILE` or
+ * `CORE`. The limits are either numeric or `INFINITY`. If HARD_LIMIT is not given, it is set equal to SOFT_LIMIT.
+ *
+ * @param resource  Output pointer for the resource (`RLIMIT_*`).
+ * @param rlim      Output pointer for the soft and hard limits.
+ * @param confVal   The string to convert.
+ *
+ * @return  0 on success, -1 on error.
+ */
+int crinitConfConvToRlimit(int *resource, struct rlimit *rlim, const char *confVal);
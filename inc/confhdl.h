@@ -54,12 +54,32 @@ int crinitCfgPrvHandler(void *tgt, const char *val, crinitConfigType_t type);
 int crinitCfgRespHandler(void *tgt, const char *val, crinitConfigType_t type);
 /** Handler for `RESPAWN_RETRIES` config directives. See crinitConfigHandler_t. **/
 int crinitCfgRespRetHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `RESPAWN_DELAY_MS` config directives. See crinitConfigHandler_t. **/
+int crinitCfgRespDelayHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `RESPAWN_DELAY_MAX_MS` config directives. See crinitConfigHandler_t. **/
+int crinitCfgRespDelayMaxHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `RESPAWN_RESET_MS` config directives. See crinitConfigHandler_t. **/
+int crinitCfgRespResetHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `STOP_TIMEOUT_MS` config directives. See crinitConfigHandler_t. **/
+int crinitCfgStopTimeoutHandler(void *tgt, const char *val, crinitConfigType_t type);
 /** Handler for `INCLUDE` config directives. See crinitConfigHandler_t. **/
 int crinitTaskIncludeHandler(void *tgt, const char *val, crinitConfigType_t type);
 /** Handler for `USER` config directives. See crinitConfigHandler_t **/
 int crinitCfgUserHandler(void *tgt, const char *val, crinitConfigType_t type);
 /** Handler for `GROUP` config directives. See crinitConfigHandler_t **/
 int crinitCfgGroupHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `CPU_AFFINITY` config directives. See crinitConfigHandler_t **/
+int crinitCfgCpuAffinityHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `SCHED_POLICY` config directives. See crinitConfigHandler_t **/
+int crinitCfgSchedPolicyHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `SCHED_PRIORITY` config directives. See crinitConfigHandler_t **/
+int crinitCfgSchedPrioHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `NICE` config directives. See crinitConfigHandler_t **/
+int crinitCfgNiceHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `IOPRIO` config directives. See crinitConfigHandler_t **/
+int crinitCfgIoPrioHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `RLIMIT` config directives. See crinitConfigHandler_t **/
+int crinitCfgRlimitHandler(void *tgt, const char *val, crinitConfigType_t type);
 #ifdef ENABLE_CGROUP
 /** Handler for "CGROUP_NAME" config directives. See crinitConfigHandler_t **/
 int crinitCfgCgroupNameHandler(void *tgt, const char *val, crinitConfigType_t type);
@@ -101,6 +121,12 @@ int crinitCfgElosPortHandler(void *tgt, const char *val, crinitConfigType_t type
 int crinitCfgElosEventPollIntervalHandler(void *tgt, const char *val, crinitConfigType_t type);
 /** Handler for `LAUNCHER_CMD` config directive. See crinitConfigHandler_t. **/
 int crinitCfgLauncherCmdHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `ASYNC_LOG_RECORDS` config directive. See crinitConfigHandler_t. **/
+int crinitCfgAsyncLogRecordsHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `TIMER_SLACK_MS` config directive. See crinitConfigHandler_t. **/
+int crinitCfgTimerSlackHandler(void *tgt, const char *val, crinitConfigType_t type);
+/** Handler for `TIMER_STATE_FILE` config directive. See crinitConfigHandler_t. **/
+int crinitCfgTimerStateFileHandler(void *tgt, const char *val, crinitConfigType_t type);
 #ifdef ENABLE_CGROUP
 /** Handler for "CGROUP_ROOT_NAME" config directives. See crinitConfigHandler_t **/
 int crinitCfgCgroupRootNameHandler(void *tgt, const char *val, crinitConfigType_t type);
@@ -41,6 +41,12 @@
 #define CRINIT_CONFIG_KEYSTR_ELOS_EVENT_POLL_INTERVAL "ELOS_EVENT_POLL_INTERVAL"
 /**  Config file key for LAUNCHER_CMD global option. **/
 #define CRINIT_CONFIG_KEYSTR_LAUNCHER_CMD "LAUNCHER_CMD"
+/**  Config file key for ASYNC_LOG_RECORDS global option. **/
+#define CRINIT_CONFIG_KEYSTR_ASYNC_LOG_RECORDS "ASYNC_LOG_RECORDS"
+/**  Config file key for TIMER_SLACK_MS global option. **/
+#define CRINIT_CONFIG_KEYSTR_TIMER_SLACK "TIMER_SLACK_MS"
+/**  Config file key for TIMER_STATE_FILE global option. **/
+#define CRINIT_CONFIG_KEYSTR_TIMER_STATE_FILE "TIMER_STATE_FILE"
 /**  Config file key for INCLUDE_SUFFIX global option. **/
 #define CRINIT_CONFIG_KEYSTR_INCL_SUFFIX "INCLUDE_SUFFIX"
 /**  Config key for the task file extension in dynamic configurations. **/
@@ -81,12 +87,32 @@
 #define CRINIT_CONFIG_KEYSTR_RESPAWN "RESPAWN"
 /**  Config key to set how often a task is allowed to respawn on failure. **/
 #define CRINIT_CONFIG_KEYSTR_RESPAWN_RETRIES "RESPAWN_RETRIES"
+/**  Config key to set the initial respawn delay of a crashing task in milliseconds. **/
+#define CRINIT_CONFIG_KEYSTR_RESPAWN_DELAY "RESPAWN_DELAY_MS"
+/**  Config key to set the maximum respawn delay of a crashing task in milliseconds. **/
+#define CRINIT_CONFIG_KEYSTR_RESPAWN_DELAY_MAX "RESPAWN_DELAY_MAX_MS"
+/**  Config key to set the run time in milliseconds after which a failing task is not considered crashing. **/
+#define CRINIT_CONFIG_KEYSTR_RESPAWN_RESET "RESPAWN_RESET_MS"
 /**  Config key to add a stop command to the task. **/
 #define CRINIT_CONFIG_KEYSTR_STOP_COMMAND "STOP_COMMAND"
+/**  Config key to set the time in milliseconds a task may take to stop on shutdown. **/
+#define CRINIT_CONFIG_KEYSTR_STOP_TIMEOUT "STOP_TIMEOUT_MS"
 /**  Config key to set a specific user to run task's commands. **/
 #define CRINIT_CONFIG_KEYSTR_USER "USER"
 /**  Config key to set a specific group to run task's commands. **/
 #define CRINIT_CONFIG_KEYSTR_GROUP "GROUP"
+/**  Config key to set the CPUs a task's commands may run on. **/
+#define CRINIT_CONFIG_KEYSTR_CPU_AFFINITY "CPU_AFFINITY"
+/**  Config key to set the scheduling policy of a task's commands. **/
+#define CRINIT_CONFIG_KEYSTR_SCHED_POLICY "SCHED_POLICY"
+/**  Config key to set the real-time scheduling priority of a task's commands. **/
+#define CRINIT_CONFIG_KEYSTR_SCHED_PRIORITY "SCHED_PRIORITY"
+/**  Config key to set the nice value of a task's commands. **/
+#define CRINIT_CONFIG_KEYSTR_NICE "NICE"
+/**  Config key to set the I/O scheduling class and priority of a task's commands. **/
+#define CRINIT_CONFIG_KEYSTR_IOPRIO "IOPRIO"
+/**  Config key to set a resource limit for a task's commands. **/
+#define CRINIT_CONFIG_KEYSTR_RLIMIT "RLIMIT"
 #ifdef ENABLE_CGROUP
 /**  Config key to set or reference a cgroup name. **/
 #define CRINIT_CONFIG_KEYSTR_CGROUP_NAME "CGROUP_NAME"
@@ -128,6 +154,10 @@
 #endif
 /**  Default value for SHUTDOWN_GRACE_PERIOD_US global option **/
 #define CRINIT_CONFIG_DEFAULT_SHDGRACEP 100000uLL
+/**  Default value for ASYNC_LOG_RECORDS global option, log messages are written synchronously. **/
+#define CRINIT_CONFIG_DEFAULT_ASYNC_LOG_RECORDS 0uLL
+/**  Default value for TIMER_SLACK_MS global option, timers expire exactly on time. **/
+#define CRINIT_CONFIG_DEFAULT_TIMER_SLACK 0uLL
 /**  Default value for USE_SYSLOG global option. **/
 #define CRINIT_CONFIG_DEFAULT_USE_SYSLOG false
 /**  Default value for USE_ELOS global option. **/
@@ -170,20 +200,33 @@ typedef enum crinitConfigs {
     CRINIT_CONFIG_PROVIDES,
     CRINIT_CONFIG_RESPAWN,
     CRINIT_CONFIG_RESPAWN_RETRIES,
+    CRINIT_CONFIG_RESPAWN_DELAY,
+    CRINIT_CONFIG_RESPAWN_DELAY_MAX,
+    CRINIT_CONFIG_RESPAWN_RESET,
     CRINIT_CONFIG_SHDGRACEP,
     CRINIT_CONFIG_SIGKEYDIR,
     CRINIT_CONFIG_SIGNATURES,
     CRINIT_CONFIG_STOP_COMMAND,
+    CRINIT_CONFIG_STOP_TIMEOUT,
     CRINIT_CONFIG_TASK_FILE_SUFFIX,
     CRINIT_CONFIG_TASKDIR,
     CRINIT_CONFIG_TASKDIR_FOLLOW_SYMLINKS,
     CRINIT_CONFIG_TASKS,
+    CRINIT_CONFIG_TIMER_SLACK,
+    CRINIT_CONFIG_TIMER_STATE_FILE,
     CRINIT_CONFIG_TRIGGER,
     CRINIT_CONFIG_TRIGGER_REARM,
     CRINIT_CONFIG_USE_SYSLOG,
     CRINIT_CONFIG_USE_ELOS,
     CRINIT_CONFIG_USER,
     CRINIT_CONFIG_LAUNCHER_CMD,
+    CRINIT_CONFIG_ASYNC_LOG_RECORDS,
+    CRINIT_CONFIG_CPU_AFFINITY,
+    CRINIT_CONFIG_SCHED_POLICY,
+    CRINIT_CONFIG_SCHED_PRIORITY,
+    CRINIT_CONFIG_NICE,
+    CRINIT_CONFIG_IOPRIO,
+    CRINIT_CONFIG_RLIMIT,
 #ifdef ENABLE_CAPABILITIES
     CRINIT_CONFIG_CAP_CLEAR,
     CRINIT_CONFIG_CAP_SET,
@@ -225,6 +268,8 @@ typedef struct crinitConfKvList {
  * If the Kernel command line option `crinit.signatures` is set to `yes`, this function will also check the
  * configuration file's signature. A non-matching signature is handled as a parser error.
  *
+ * Loading the file and checking its signature are recorded in the boot trace, see trace.h.
+ *
  * @param confList  will return a pointer to dynamically allocated memory of a ConfKvList filled with the
  *                  key/value-pairs from the config file.
  * @param filename  Path to the configuration file.
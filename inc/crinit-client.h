@@ -239,6 +239,27 @@ int crinitClientTaskRestart(const char *taskName);
 int crinitClientTaskGetStatus(crinitTaskState_t *s, pid_t *pid, struct timespec *ct, struct timespec *st,
                               struct timespec *et, gid_t *gid, uid_t *uid, char **username, char **groupname,
                               const char *taskName);
+/**
+ * Request Crinit to report the resource usage of a task and of each of its commands from its TaskDB.
+ *
+ * The resource usage is accumulated over all processes of the task which have terminated so far, i.e. a process which
+ * is still running is not yet included. If a command has been run more than once, e.g. due to RESPAWN, the usage of
+ * all its runs is accumulated.
+ *
+ * The returned object should be freed with crinitClientFreeTaskUsage().
+ *
+ * @param ui        Return pointer for the task's resource usage.
+ * @param taskName  The name of the task.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitClientTaskGetUsage(crinitTaskUsageInfo_t **ui, const char *taskName);
+/**
+ * Free the resource usage obtained from crinitClientTaskGetUsage().
+ *
+ * @param ui    The resource usage.
+ */
+void crinitClientFreeTaskUsage(crinitTaskUsageInfo_t *ui);
 /**
  * Request Crinit to report the list of task names from its TaskDB.
  *
@@ -255,6 +276,70 @@ int crinitClientGetTaskList(crinitTaskList_t **tl);
  * @param tl    The list of tasks.
  */
 void crinitClientFreeTaskList(crinitTaskList_t *tl);
+/**
+ * Request Crinit to analyze the dependency graph of its TaskDB and report the results.
+ *
+ * For each task, the result contains the depth of the task within the graph of remaining dependencies, the number of
+ * tasks directly waiting on it, the length and estimated run time of the longest dependency chain starting at it, and
+ * whether it lies on the critical path. Crinit uses the same analysis to decide the order in which it spawns tasks
+ * which become ready at the same time. Run times are estimated from the last start and end of each task.
+ *
+ * The returned object should be freed with crinitClientFreeTaskGraph().
+ *
+ * @param tg    Return pointer for the analyzed graph.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitClientGetTaskGraph(crinitTaskGraph_t **tg);
+/**
+ * Free the graph analysis results obtained from crinitClientGetTaskGraph().
+ *
+ * @param tg    The analyzed graph.
+ */
+void crinitClientFreeTaskGraph(crinitTaskGraph_t *tg);
+/**
+ * Request the boot trace recorded by Crinit.
+ *
+ * Crinit records timestamped events such as the loading of configuration files, the insertion, dispatch, and state
+ * changes of tasks, spawned commands, fulfilled dependencies, and waits for contended locks into an in-memory ring
+ * buffer. The events are returned in the order they were recorded. If the buffer has been overwritten since startup,
+ * the oldest events are missing and crinitBootTrace_t::dropped is non-zero. See crinitTraceEventType_t for the meaning
+ * of the name and argument of each event.
+ *
+ * The returned object should be freed with crinitClientFreeBootTrace().
+ *
+ * @param bt    Return pointer for the boot trace.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitClientGetBootTrace(crinitBootTrace_t **bt);
+/**
+ * Free the boot trace obtained from crinitClientGetBootTrace().
+ *
+ * @param bt    The boot trace.
+ */
+void crinitClientFreeBootTrace(crinitBootTrace_t *bt);
+/**
+ * Request the internal metrics of Crinit.
+ *
+ * The metrics comprise latency histograms (e.g. from a task becoming ready until it is spawned, per-command request
+ * latency of the notification/service interface, and wait and hold times of the TaskDB lock), counters, and gauges of
+ * the current state of Crinit's subsystems. Histograms count observations in fixed buckets with the upper bounds given
+ * by #CRINIT_METRIC_BUCKET_BOUNDS_NS. Names and labels follow the Prometheus conventions.
+ *
+ * The returned object should be freed with crinitClientFreeStats().
+ *
+ * @param st    Return pointer for the metrics.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitClientGetStats(crinitStats_t **st);
+/**
+ * Free the metrics obtained from crinitClientGetStats().
+ *
+ * @param st    The metrics.
+ */
+void crinitClientFreeStats(crinitStats_t *st);
 /**
  * Request Crinit to initiate an immediate shutdown or reboot.
  *
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include "lockprof.h"
 #include "logio.h"
 #include "thrpool.h"
 
@@ -167,10 +168,11 @@ crinitElosVirtualTable_t *crinitElosGetVTable(void);
  *
  * @param session      Session to disconnect.
  * @param sessionLock  The session lock.
+ * @param lockId       The profiled lock \a sessionLock belongs to, see lockprof.h.
  *
  * @return Returns 0 on success, -1 otherwise.
  */
-int crinitElosDisconnect(crinitElosSession_t *session, pthread_mutex_t *sessionLock);
+int crinitElosDisconnect(crinitElosSession_t *session, pthread_mutex_t *sessionLock, crinitLockId_t lockId);
 
 /**
  * Macro to simplify checking for a valid elos session.
@@ -182,14 +184,15 @@ int crinitElosDisconnect(crinitElosSession_t *session, pthread_mutex_t *sessionL
  *
  * @param session       Elos session to be used.
  * @param sessionLock   The session lock.
+ * @param lockId        The profiled lock \a sessionLock belongs to, see lockprof.h.
  * @param func          Elos function to be called.
  * @param err_msg       Error message to be returned on error.
  */
-#define crinitElosTryExec(session, sessionLock, func, err_msg, ...)                                                   \
+#define crinitElosTryExec(session, sessionLock, lockId, func, err_msg, ...)                                           \
     __extension__({                                                                                                   \
         int res = SAFU_RESULT_OK;                                                                                     \
                                                                                                                       \
-        if ((errno = pthread_mutex_lock(sessionLock)) != 0) {                                                         \
+        if ((errno = crinitMutexLock(sessionLock, lockId)) != 0) {                                                    \
             crinitErrnoPrint("Failed to lock elos session.");                                                         \
             res = -1;                                                                                                 \
         } else {                                                                                                      \
@@ -227,7 +230,7 @@ int crinitElosDisconnect(crinitElosSession_t *session, pthread_mutex_t *sessionL
                     crinitErrPrint(err_msg);                                                                          \
                 }                                                                                                     \
                                                                                                                       \
-                if ((errno = pthread_mutex_unlock(sessionLock)) != 0) {                                               \
+                if ((errno = crinitMutexUnlock(sessionLock, lockId)) != 0) {                                          \
                     crinitErrnoPrint("Failed to unlock elos session.");                                               \
                     res = -1;                                                                                         \
                 }                                                                                                     \
@@ -13,9 +13,27 @@
 
 #define CRINIT_ELOSLOG_FEATURE_NAME "elos"
 #define CRINIT_ELOSLOG_EVENT_LIMIT 0x400
+/** Maximum size of an event payload including the terminating zero, longer payloads are truncated. **/
+#define CRINIT_ELOSLOG_PAYLOAD_MAX 256
+
+/**
+ * Counters of the elos event logging, see crinitEloslogGetStats().
+ */
+typedef struct crinitEloslogStats {
+    uint64_t enqueued;   ///< Number of events which have been put into the event buffer.
+    uint64_t published;  ///< Number of events which have been published to elos.
+    uint64_t failed;     ///< Number of events which could not be published to elos.
+    uint64_t dropped;    ///< Number of events which have been dropped because the event buffer was full.
+    uint64_t truncated;  ///< Number of events whose payload has been truncated to #CRINIT_ELOSLOG_PAYLOAD_MAX.
+    uint64_t batches;    ///< Number of batches the events have been published in.
+    uint64_t queued;     ///< Number of events currently in the event buffer, including the batch being published.
+} crinitEloslogStats_t;
 
 /**
  * Initialize all components needed to handle event logging.
+ *
+ * Allocates a buffer for #CRINIT_ELOSLOG_EVENT_LIMIT events up front, so logging an event does not need to allocate
+ * memory.
  */
 int crinitEloslogInit(void);
 
@@ -36,6 +54,10 @@ int crinitEloslogActivate(bool e);
 /**
  * Log a crinit event to elos.
  *
+ * The event is copied into the event buffer and published by the transmitter thread together with all other events
+ * buffered until it wakes up. If the buffer is full, the event is dropped and counted in
+ * crinitEloslogStats_t::dropped.
+ *
  * Modifies errno.
  *
  * @param severity        The event severity.
@@ -48,4 +70,13 @@ int crinitEloslogActivate(bool e);
 int crinitElosLog(crinitElosSeverityE_t severity, crinitElosEventMessageCodeE_t messageCode, uint64_t classification,
                   const char *format, ...);
 
+/**
+ * Get the counters of the elos event logging.
+ *
+ * @param stats  Return pointer for the counters.
+ *
+ * @return Returns 0 on success, -1 otherwise.
+ */
+int crinitEloslogGetStats(crinitEloslogStats_t *stats);
+
 #endif /* __ELOSLOG_H__ */
@@ -36,6 +36,9 @@ typedef struct crinitGlobOptStore {
     char **tasks;                              ///< Value for the TASKS global option.
     char *launcherCmd;                         ///< Value for the LAUNCHER_CMD global option.
     unsigned long long shdGraceP;              ///< Value for the SHUTDOWN_GRACE_PERIOD_US global option.
+    unsigned long long timerSlack;             ///< Value for the TIMER_SLACK_MS global option.
+    unsigned long long asyncLogRecords;        ///< Value for the ASYNC_LOG_RECORDS global option.
+    char *timerStateFile;                      ///< Value for the TIMER_STATE_FILE global option, NULL if unset.
     crinitEnvSet_t globEnv;                    ///< Storage for global task environment variables.
     crinitEnvSet_t globFilters;                ///< Storage for global task filter variables.
 #ifdef ENABLE_CAPABILITIES
@@ -63,6 +66,9 @@ typedef struct crinitGlobOptStore {
 #define CRINIT_GLOBOPT_TASKS tasks                                     ///< TASKS global option
 #define CRINIT_GLOBOPT_LAUNCHER_CMD launcherCmd                        ///< LAUNCHER_CMD global option
 #define CRINIT_GLOBOPT_SHDGRACEP shdGraceP                             ///< SHUTDOWN_GRACE_PERIOD_US global option
+#define CRINIT_GLOBOPT_TIMER_SLACK timerSlack                          ///< TIMER_SLACK_MS global option
+#define CRINIT_GLOBOPT_ASYNC_LOG_RECORDS asyncLogRecords               ///< ASYNC_LOG_RECORDS global option
+#define CRINIT_GLOBOPT_TIMER_STATE_FILE timerStateFile                 ///< TIMER_STATE_FILE global option
 #define CRINIT_GLOBOPT_ENV globEnv                                     ///< Reference to the global task environment
 #define CRINIT_GLOBOPT_FILTERS globFilters                             ///< Reference to the global task filters
 #define CRINIT_GLOBOPT_SIGNATURES signatures  ///< Reference to global setting of signature checking.
@@ -150,6 +156,31 @@ crinitGlobOptStore_t *crinitGlobOptBorrow(void);
  */
 int crinitGlobOptRemit(void);
 
+/**
+ * Get a read-only snapshot of the global option storage without locking.
+ *
+ * The snapshot is an immutable copy of all boolean, numeric, and string options in crinitGlobOptStore_t, the strings
+ * are part of the snapshot and need not be freed. The env sets, TASKS, and cgroup definitions are not part of the
+ * snapshot and are empty/NULL in it, use crinitGlobOptGet() or crinitGlobOptBorrow() for those.
+ *
+ * Writers do not modify a published snapshot. Every change to the global option storage (through crinitGlobOptSet() or
+ * crinitGlobOptBorrow()/crinitGlobOptRemit()) marks the snapshot as stale and the next call to this function publishes
+ * a new one. Readers keep the snapshot they hold until they call crinitGlobOptSnapshotRelease(), the memory of a
+ * replaced snapshot is freed when its last reader releases it. As long as no option has changed, the function only
+ * takes a reference using atomic operations and does neither lock nor allocate.
+ *
+ * @return  A pointer to the current snapshot on success, a NULL pointer if a new snapshot could not be created.
+ */
+const crinitGlobOptStore_t *crinitGlobOptSnapshotAcquire(void);
+/**
+ * Release a snapshot acquired with crinitGlobOptSnapshotAcquire().
+ *
+ * The snapshot and all strings in it must not be used afterwards.
+ *
+ * @param snap  The snapshot to release, may be NULL.
+ */
+void crinitGlobOptSnapshotRelease(const crinitGlobOptStore_t *snap);
+
 /**
  * Stores a string value for a global option.
  *
@@ -214,11 +245,12 @@ int crinitGlobOptSetEnvSet(size_t memberOffset, const crinitEnvSet_t *val);
 /**
  * Retrieves a string value from a global option.
  *
- * Consider using the type-generic macro crinitGlobOptGet() which can be used with member names instead of offsets. Will
- * lock the global option storage as long as needed and is thread-safe.
+ * Consider using the type-generic macro crinitGlobOptGet() which can be used with member names instead of offsets.
+ * Reads from the snapshot returned by crinitGlobOptSnapshotAcquire() and is thread-safe.
  *
  * Will allocate memory for the returned string. When no longer in use, free() should be called on the returned pointer
- * to free the memory.
+ * to free the memory. If the option has no value (as the optional TIMER_STATE_FILE), the returned pointer is NULL. To
+ * read a string without allocation, use crinitGlobOptSnapshotAcquire().
  *
  * @param memberOffset  The offset of the member of the global option struct to set.
  * @param val           Return pointer for the retrieved string. Memory will be allocated.
@@ -229,8 +261,8 @@ int crinitGlobOptGetString(size_t memberOffset, char **val);
 /**
  * Retrieves a boolean value from a global option.
  *
- * Consider using the type-generic macro crinitGlobOptGet() which can be used with member names instead of offsets. Will
- * lock the global option storage as long as needed and is thread-safe.
+ * Consider using the type-generic macro crinitGlobOptGet() which can be used with member names instead of offsets.
+ * Reads from the snapshot returned by crinitGlobOptSnapshotAcquire() and is thread-safe.
  *
  * @param memberOffset  The global option to set.
  * @param val           Return pointer for the retrieved boolean value.
@@ -241,8 +273,8 @@ int crinitGlobOptGetBoolean(size_t memberOffset, bool *val);
 /**
  * Retrieves an integer value from a global option.
  *
- * Consider using the type-generic macro crinitGlobOptGet() which can be used with member names instead of offsets. Will
- * lock the global option storage as long as needed and is thread-safe.
+ * Consider using the type-generic macro crinitGlobOptGet() which can be used with member names instead of offsets.
+ * Reads from the snapshot returned by crinitGlobOptSnapshotAcquire() and is thread-safe.
  *
  * @param memberOffset  The global option to set.
  * @param val           Return pointer for the retrieved integer value.
@@ -253,8 +285,8 @@ int crinitGlobOptGetInteger(size_t memberOffset, int *val);
 /**
  * Retrieves an unsigned long long value from a global option.
  *
- * Consider using the type-generic macro crinitGlobOptGet() which can be used with member names instead of offsets. Will
- * lock the global option storage as long as needed and is thread-safe.
+ * Consider using the type-generic macro crinitGlobOptGet() which can be used with member names instead of offsets.
+ * Reads from the snapshot returned by crinitGlobOptSnapshotAcquire() and is thread-safe.
  *
  * @param memberOffset  The global option to set.
  * @param val           Return pointer for the unsigned long long integer value.
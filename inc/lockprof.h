@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file lockprof.h
+ * @brief Header related to the optional lock contention profiler.
+ *
+ * The global mutexes of Crinit are locked and unlocked through crinitMutexLock(), crinitMutexUnlock(),
+ * crinitMutexCondWait() and crinitMutexCondTimedWait(). Without the `ENABLE_LOCK_PROFILING` build option these are
+ * plain aliases for the pthread functions. With it, the time spent waiting for and holding each lock is recorded in a
+ * histogram and the acquisitions, contended acquisitions, wait and hold times are additionally counted per call site.
+ * The results are part of the STATS runtime command and can be shown using `crinit-ctl locks`.
+ */
+#ifndef __LOCKPROF_H__
+#define __LOCKPROF_H__
+
+#include <pthread.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "metrics.h"
+
+/**
+ * The profiled locks.
+ */
+typedef enum crinitLockId {
+    CRINIT_LOCK_TASKDB = 0,         ///< crinitTaskDB_t::lock of the central TaskDB.
+    CRINIT_LOCK_LOG,                ///< The lock serializing log output and logging options.
+    CRINIT_LOCK_GLOBOPT,            ///< The lock serializing writers of the global options.
+    CRINIT_LOCK_REAPER,             ///< The lock of the reaper, held while registering and reaping child processes.
+    CRINIT_LOCK_TIMERDB,            ///< The lock of the TimerDB.
+    CRINIT_LOCK_ELOSDEP_FILTERS,    ///< The lock of the list of tasks waiting for elos events.
+    CRINIT_LOCK_ELOSDEP_SESSION,    ///< The lock of the elos session used for event subscriptions.
+    CRINIT_LOCK_ELOSLOG_SESSION,    ///< The lock of the elos session used to publish events.
+    /**
+     * The locks of the filter lists of the single tasks waiting for elos events. They are only taken while holding
+     * #CRINIT_LOCK_ELOSDEP_FILTERS, so at most one of them is held at a time and they can share their statistics.
+     */
+    CRINIT_LOCK_ELOSDEP_TASK_FILTERS,
+    CRINIT_LOCK_ELOSDEP_ACTIVATED,  ///< The lock of the connection state of the elos event subscriptions.
+    CRINIT_LOCK_ELOSLOG_ACTIVATED,  ///< The lock of the connection state of the elos event publishing.
+    CRINIT_LOCK_ELOSLOG_QUEUE,      ///< The lock of the buffer of events waiting to be published to elos.
+    CRINIT_LOCKS                    ///< Number of profiled locks, not a valid lock itself.
+} crinitLockId_t;
+
+/** Maximum number of call sites recorded per lock, the last one collects all sites beyond. **/
+#define CRINIT_LOCKPROF_SITES 8
+/** Number of metrics per call site, see crinitLockProfRead(). **/
+#define CRINIT_LOCKPROF_SITE_METRICS 4
+/** Maximum number of metrics returned by crinitLockProfRead(). **/
+#define CRINIT_LOCKPROF_SAMPLES (CRINIT_LOCKS * (2 + CRINIT_LOCKPROF_SITES * CRINIT_LOCKPROF_SITE_METRICS))
+
+/** Helper to turn the expansion of a macro into a string literal. **/
+#define CRINIT_LOCKPROF_STR(x) CRINIT_LOCKPROF_STR_(x)
+/** Helper for CRINIT_LOCKPROF_STR(). **/
+#define CRINIT_LOCKPROF_STR_(x) #x
+
+#ifdef ENABLE_LOCK_PROFILING
+
+/** The current call site as a string literal `<file>:<line>`. **/
+#define CRINIT_LOCKPROF_SITE (__FILE__ ":" CRINIT_LOCKPROF_STR(__LINE__))
+
+/** Lock a profiled mutex, see pthread_mutex_lock(). **/
+#define crinitMutexLock(mutex, id) crinitLockProfLock(mutex, id, CRINIT_LOCKPROF_SITE)
+/** Unlock a profiled mutex, see pthread_mutex_unlock(). **/
+#define crinitMutexUnlock(mutex, id) crinitLockProfUnlock(mutex, id)
+/** Wait on a condition variable associated with a profiled mutex, see pthread_cond_wait(). **/
+#define crinitMutexCondWait(cond, mutex, id) crinitLockProfCondWait(cond, mutex, NULL, id)
+/** Wait on a condition variable associated with a profiled mutex with a timeout, see pthread_cond_timedwait(). **/
+#define crinitMutexCondTimedWait(cond, mutex, abstime, id) crinitLockProfCondWait(cond, mutex, abstime, id)
+
+#else
+
+/** The current call site, not recorded without lock profiling. **/
+#define CRINIT_LOCKPROF_SITE NULL
+
+/*
+ * The lock ID is only referenced through sizeof, so it is not evaluated but a parameter solely passed on as lock ID
+ * does not cause unused parameter warnings.
+ */
+/** Lock a mutex, see pthread_mutex_lock(). **/
+#define crinitMutexLock(mutex, id) ((void)sizeof(id), pthread_mutex_lock(mutex))
+/** Unlock a mutex, see pthread_mutex_unlock(). **/
+#define crinitMutexUnlock(mutex, id) ((void)sizeof(id), pthread_mutex_unlock(mutex))
+/** Wait on a condition variable, see pthread_cond_wait(). **/
+#define crinitMutexCondWait(cond, mutex, id) ((void)sizeof(id), pthread_cond_wait(cond, mutex))
+/** Wait on a condition variable with a timeout, see pthread_cond_timedwait(). **/
+#define crinitMutexCondTimedWait(cond, mutex, abstime, id) \
+    ((void)sizeof(id), pthread_cond_timedwait(cond, mutex, abstime))
+
+#endif
+
+/**
+ * Lock a mutex and record the acquisition.
+ *
+ * Works like pthread_mutex_lock(). If the mutex is contended, the time spent waiting is recorded along with a boot
+ * trace event. The call site is counted in the statistics of the lock while holding it, so the per-site data is
+ * protected by the profiled mutex itself.
+ *
+ * @param mutex  The mutex to lock.
+ * @param id     The lock \a mutex belongs to.
+ * @param site   The call site as a string literal, see #CRINIT_LOCKPROF_SITE. Sites are told apart by address.
+ *
+ * @return  0 on success, an error number as returned by pthread_mutex_lock() otherwise
+ */
+int crinitLockProfLock(pthread_mutex_t *mutex, crinitLockId_t id, const char *site);
+/**
+ * Record the hold time of a mutex locked by crinitLockProfLock() and unlock it.
+ *
+ * @param mutex  The mutex to unlock.
+ * @param id     The lock \a mutex belongs to.
+ *
+ * @return  0 on success, an error number as returned by pthread_mutex_unlock() otherwise
+ */
+int crinitLockProfUnlock(pthread_mutex_t *mutex, crinitLockId_t id);
+/**
+ * Wait on a condition variable associated with a mutex locked by crinitLockProfLock().
+ *
+ * The mutex is released during the wait, so its current hold time is recorded before and a new one started after.
+ *
+ * @param cond     The condition variable to wait on.
+ * @param mutex    The locked mutex.
+ * @param abstime  Absolute timeout as for pthread_cond_timedwait(), or NULL to wait without timeout.
+ * @param id       The lock \a mutex belongs to.
+ *
+ * @return  0 on success, an error number as returned by pthread_cond_wait() or pthread_cond_timedwait() otherwise
+ */
+int crinitLockProfCondWait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime,
+                           crinitLockId_t id);
+/**
+ * Copy the current statistics of all locks which have been acquired at least once.
+ *
+ * The metrics are grouped by name: the wait time histograms `crinit_lock_wait_seconds` and the hold time histograms
+ * `crinit_lock_hold_seconds` labeled with the `lock`, followed by the counters `crinit_lock_site_acquisitions_total`,
+ * `crinit_lock_site_contentions_total`, `crinit_lock_site_wait_nanoseconds_total` and
+ * `crinit_lock_site_hold_nanoseconds_total` labeled with the `lock` and the call `site`.
+ *
+ * @param out  Array for at least \a max samples.
+ * @param max  Maximum number of samples to copy, #CRINIT_LOCKPROF_SAMPLES to get all of them.
+ *
+ * @return  The number of copied samples.
+ */
+size_t crinitLockProfRead(crinitMetricSample_t *out, size_t max);
+
+#endif /* __LOCKPROF_H__ */
@@ -7,7 +7,9 @@
 #define __LOGIO_H__
 
 #include <errno.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -21,6 +23,17 @@
  */
 #define CRINIT_PRINT_PREFIX "[CRINIT] "
 
+/**
+ * Maximum length of a message in asynchronous logging mode including the terminating zero, see crinitLogAsyncStart().
+ * Longer messages are truncated.
+ */
+#define CRINIT_LOG_RECORD_MAX 320
+
+/**
+ * Maximum number of records in the asynchronous log buffer, see crinitLogAsyncStart().
+ */
+#define CRINIT_LOG_ASYNC_RECORDS_MAX 16384
+
 /**
  * Constant to use if one wishes to output an empty line using an output function, e.g.
  * crinitInfoPrint(CRINIT_PRINT_EMPTY_LINE). The output will still contain everything the output function adds, e.g.
@@ -94,17 +107,56 @@ void crinitSetUseSyslog(bool sl);
  */
 void crinitInfoPrint(const char *format, ...) __attribute__((format(printf, 1, 2)));
 /**
- * Print an info message if DEBUG global option is set.
+ * Cached value of the DEBUG global option, kept up to date by crinitGlobOptSet() using crinitSetDebugOutput().
+ *
+ * Only to be read by crinitDbgInfoPrint(), so disabled debug output costs a single atomic load and no locking.
+ */
+extern atomic_bool crinitDbgOutputEnabled;
+/**
+ * Specify if debug output should be printed.
+ *
+ * Called by the global option storage whenever the DEBUG global option is set, there should be no need to call it
+ * elsewhere.
+ *
+ * @param dbg  `true` if crinitDbgInfoPrint() should generate output, `false` otherwise.
+ */
+void crinitSetDebugOutput(bool dbg);
+
+/**
+ * Macro to print an info message using crinitDbgInfoPrintUnchecked() if the DEBUG global option is set.
+ *
+ * The check is done before the arguments are evaluated and only reads a cached copy of the option, so a disabled debug
+ * print is cheap enough for hot paths. If Crinit is built with `CRINIT_DISABLE_DEBUG_OUTPUT` defined (CMake option
+ * `DEBUG_OUTPUT=Off`), debug prints are removed at compile time, but the arguments are still type-checked.
+ */
+#ifdef CRINIT_DISABLE_DEBUG_OUTPUT
+#define crinitDbgInfoPrint(...)                       \
+    do {                                              \
+        if (0) {                                      \
+            crinitDbgInfoPrintUnchecked(__VA_ARGS__); \
+        }                                             \
+    } while (0)
+#else
+#define crinitDbgInfoPrint(...)                                                    \
+    do {                                                                           \
+        if (atomic_load_explicit(&crinitDbgOutputEnabled, memory_order_relaxed)) { \
+            crinitDbgInfoPrintUnchecked(__VA_ARGS__);                              \
+        }                                                                          \
+    } while (0)
+#endif
+/**
+ * Print a debug message regardless of the DEBUG global option.
  *
  * Can be used like printf(). In contrast to printf(), this function adds the Crinit prefix at the start and a newline
- * at the end. It uses the output stream specified by crinitSetInfoStream() or stdout if unset. There will be no output
- * if the global option DEBUG is set to false using crinitGlobOptSetBoolean(). The function uses mutexes internally and
- * is thread-safe.
+ * at the end. It uses the output stream specified by crinitSetInfoStream() or stdout if unset. The function uses
+ * mutexes internally and is thread-safe.
  *
  * If configured (`USE_SYSLOG = true`) and available (a task has provided `syslog`), the function will instead write to
  * syslog.
+ *
+ * The macro crinitDbgInfoPrint() should be used instead, so that there is no output if DEBUG is not set.
  */
-void crinitDbgInfoPrint(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void crinitDbgInfoPrintUnchecked(const char *format, ...) __attribute__((format(printf, 1, 2)));
 
 /**
  * Macro to print an error message including the offending source file, function, and line using crinitErrPrintFFL().
@@ -154,4 +206,48 @@ void crinitErrnoPrintFFL(const char *file, const char *func, int line, const cha
  */
 void crinitInitKmsgLogging(void);
 
+/**
+ * Counters of the asynchronous logging mode.
+ */
+typedef struct crinitLogStats {
+    uint64_t written;  ///< Number of messages written out by the writer thread.
+    uint64_t dropped;  ///< Number of info and debug messages dropped because the log buffer was full.
+    uint64_t direct;   ///< Number of error messages written synchronously because the log buffer was full.
+} crinitLogStats_t;
+
+/**
+ * Switch the logging functions to asynchronous mode.
+ *
+ * Afterwards, the print functions format their message into a lock-free buffer of preformatted records and return. A
+ * dedicated writer thread takes the records out of the buffer in order and writes them to the configured target
+ * (stream, /dev/kmsg, or syslog), so that a slow console does not stall the threads producing log output. The buffer
+ * holds \a records messages of up to #CRINIT_LOG_RECORD_MAX bytes each.
+ *
+ * If the buffer is full, info and debug messages are dropped and the writer thread reports the number of dropped
+ * messages once it catches up. Error messages are never dropped but written synchronously instead, which means they
+ * may appear ahead of older messages still in the buffer.
+ *
+ * There is no way back to synchronous mode. crinitLogFlush() is registered with atexit() so pending messages are
+ * written out on exit.
+ *
+ * @param records  Number of records in the buffer, rounded up to the next power of two. Must be between 1 and
+ *                 #CRINIT_LOG_ASYNC_RECORDS_MAX.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitLogAsyncStart(size_t records);
+/**
+ * Wait until all messages logged before the call have been written out.
+ *
+ * Returns immediately if asynchronous logging is not active. Waits for at most two seconds, so that a blocked log
+ * target cannot stall a shutdown.
+ */
+void crinitLogFlush(void);
+/**
+ * Get the counters of the asynchronous logging mode.
+ *
+ * @param stats  Return pointer for the counters.
+ */
+void crinitLogGetStats(crinitLogStats_t *stats);
+
 #endif /* __LOGIO_H__ */
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file metrics.h
+ * @brief Header related to the internal metrics registry.
+ *
+ * The registry holds counters and fixed-bucket histograms of durations which are updated with relaxed atomic
+ * operations, so recording a value never takes a lock and is cheap enough to be always on. The metrics can be read out
+ * through the STATS runtime command together with the counters kept by other parts of Crinit, see
+ * crinitClientGetStats() and `crinit-ctl stats`.
+ */
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crinit-sdefs.h"
+#include "rtimopmap.h"
+
+/**
+ * Histograms in the metrics registry, all of them record durations in nanoseconds.
+ */
+typedef enum crinitMetricHisto {
+    CRINIT_METRIC_SPAWN_LATENCY = 0,  ///< Time from a task becoming ready until its first command has been spawned.
+    CRINIT_METRIC_TASKDB_LOCK_WAIT,   ///< Time spent waiting to acquire the TaskDB lock.
+    CRINIT_METRIC_TASKDB_LOCK_HOLD,   ///< Time the TaskDB lock has been held.
+    CRINIT_METRIC_HISTOS              ///< Number of histograms, not a valid histogram itself.
+} crinitMetricHisto_t;
+
+/**
+ * Counters in the metrics registry.
+ */
+typedef enum crinitMetricCounter {
+    CRINIT_METRIC_RESPAWNS = 0,  ///< Number of times a task has been started again after it had ended.
+    CRINIT_METRIC_COUNTERS       ///< Number of counters, not a valid counter itself.
+} crinitMetricCounter_t;
+
+/**
+ * A point-in-time copy of a single metric.
+ */
+typedef struct crinitMetricSample {
+    const char *name;         ///< Name of the metric.
+    const char *labels;       ///< Labels of the metric in Prometheus syntax without braces, or NULL if there are none.
+    crinitMetricType_t type;  ///< The metric type.
+    uint64_t value;           ///< Value of a counter or gauge, sum of all observations in nanoseconds for histograms.
+    /** Number of observations per bucket of a histogram (not cumulative), unused for other types. **/
+    uint64_t buckets[CRINIT_METRIC_BUCKETS];
+} crinitMetricSample_t;
+
+/**
+ * A histogram of durations with the buckets given by #CRINIT_METRIC_BUCKET_BOUNDS_NS.
+ *
+ * Used for the histograms of the registry and available to other parts of Crinit which keep their own histograms.
+ */
+typedef struct crinitMetricsHistogram {
+    atomic_uint_fast64_t sum;                             ///< Sum of all observations in nanoseconds.
+    atomic_uint_fast64_t buckets[CRINIT_METRIC_BUCKETS];  ///< Number of observations per bucket.
+} crinitMetricsHistogram_t;
+
+/**
+ * Number of metrics returned by crinitMetricsRead(), i.e. all histograms including the IPC request latency of each
+ * command and all counters.
+ */
+#define CRINIT_METRICS_SAMPLES (CRINIT_METRIC_HISTOS + CRINIT_RTIMCMD_NUM_CMDS + CRINIT_METRIC_COUNTERS)
+
+/**
+ * Increment a counter in the metrics registry.
+ *
+ * Thread-safe and lock-free.
+ *
+ * @param c  The counter to increment.
+ */
+void crinitMetricsCount(crinitMetricCounter_t c);
+/**
+ * Record a duration in a histogram of the metrics registry.
+ *
+ * Thread-safe and lock-free.
+ *
+ * @param h   The histogram to record to.
+ * @param ns  The duration in nanoseconds.
+ */
+void crinitMetricsObserve(crinitMetricHisto_t h, uint64_t ns);
+/**
+ * Record the latency of a request to the notification/service interface.
+ *
+ * Thread-safe and lock-free. Requests with a response opcode are counted for the corresponding command.
+ *
+ * @param op  The opcode of the request.
+ * @param ns  The time from receiving the request until the response was sent in nanoseconds.
+ */
+void crinitMetricsObserveIpc(crinitRtimOp_t op, uint64_t ns);
+/**
+ * Copy the current values of all metrics in the registry.
+ *
+ * The histograms come first, followed by the counters. The values are read without locking, so observations recorded
+ * concurrently may be included in the buckets of a histogram but not yet in its sum or vice versa.
+ *
+ * @param out  Array for at least \a max samples.
+ * @param max  Maximum number of samples to copy, #CRINIT_METRICS_SAMPLES to get all of them.
+ *
+ * @return  The number of copied samples.
+ */
+size_t crinitMetricsRead(crinitMetricSample_t *out, size_t max);
+/**
+ * Record a duration in a histogram.
+ *
+ * Thread-safe and lock-free.
+ *
+ * @param h   The histogram to record to.
+ * @param ns  The duration in nanoseconds.
+ */
+void crinitMetricsHistogramAdd(crinitMetricsHistogram_t *h, uint64_t ns);
+/**
+ * Copy a histogram into a sample.
+ *
+ * @param out     The sample to fill.
+ * @param h       The histogram to copy.
+ * @param name    The name of the histogram.
+ * @param labels  The labels of the histogram, may be NULL.
+ */
+void crinitMetricsHistogramRead(crinitMetricSample_t *out, crinitMetricsHistogram_t *h, const char *name,
+                                const char *labels);
+
+#endif /* __METRICS_H__ */
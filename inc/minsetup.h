@@ -26,14 +26,4 @@ int crinitMountDevtmpfs(void);
  */
 int crinitSetupSystemFs(void);
 
-/**
- * Forks the calling process, parent will enter a wait-loop, child will return.
- *
- * Meant to be used during early startup if the calling process is PID 1. After the call, PID 1 will be in a permanent
- * wait-loop to take care of orphaned processes. The new process will return from the funtion and go on.
- *
- * @return -1 if fork() fails, 0 on success in the child process, parent process will never return
- */
-int crinitForkZombieReaper(void);
-
 #endif /* __MINSETUP_H__ */
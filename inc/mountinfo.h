@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file mountinfo.h
+ * @brief Header related to reading the tree of mounted filesystems from `/proc/self/mountinfo`.
+ */
+#ifndef __MOUNTINFO_H__
+#define __MOUNTINFO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Path to the mountinfo file of the calling process. **/
+#define CRINIT_MOUNTINFO_PATH "/proc/self/mountinfo"
+
+/** Value of crinitMountEntry_t::parent if the parent mount is not part of the tree. **/
+#define CRINIT_MOUNTINFO_NO_PARENT SIZE_MAX
+
+/**
+ * A single mounted filesystem.
+ */
+typedef struct crinitMountEntry {
+    int mountId;     ///< Unique ID of the mount.
+    int parentId;    ///< ID of the parent mount, equal to crinitMountEntry_t::mountId for the top of the tree.
+    char *target;    ///< The mount point, relative to the root directory of the process.
+    char *fsType;    ///< The filesystem type.
+    char *source;    ///< Filesystem-specific mount source, e.g. a block device or `none`.
+    bool readOnly;   ///< True if the mount is read-only.
+    size_t parent;   ///< Index of the parent mount in crinitMountTree_t::mounts, or CRINIT_MOUNTINFO_NO_PARENT.
+    size_t numChld;  ///< Number of mounts which have this mount as their parent.
+} crinitMountEntry_t;
+
+/**
+ * The tree of mounted filesystems as listed in `/proc/self/mountinfo`.
+ */
+typedef struct crinitMountTree {
+    crinitMountEntry_t *mounts;  ///< Dynamic array of mounts in the order of the mountinfo file (oldest first).
+    size_t numMounts;            ///< Number of elements in crinitMountTree_t::mounts.
+} crinitMountTree_t;
+
+/**
+ * Reads a mount tree from a stream in the format of `/proc/<pid>/mountinfo`.
+ *
+ * Escape sequences in paths (e.g. `\040` for a space) are resolved. Parent/child relationships are resolved via the
+ * mount IDs. Lines which can not be parsed are skipped with an error message.
+ *
+ * @param tree    Return pointer for the mount tree, will contain allocated memory that can be freed via
+ *                crinitMountTreeDestroy().
+ * @param stream  The stream to read from, e.g. an opened #CRINIT_MOUNTINFO_PATH.
+ *
+ * @return  0 on success, -1 otherwise
+ */
+int crinitMountTreeParse(crinitMountTree_t *tree, FILE *stream);
+
+/**
+ * Frees memory associated with a crinitMountTree_t.
+ *
+ * @param tree  The mount tree whose memory shall be deallocated, may be NULL.
+ */
+void crinitMountTreeDestroy(crinitMountTree_t *tree);
+
+#endif /* __MOUNTINFO_H__ */
@@ -20,5 +20,14 @@
  * @return 0 on success, -1 on error
  */
 int crinitStartInterfaceServer(crinitTaskDB_t *ctx, const char *sockfile);
+/**
+ * Get the current size of the worker thread pool of the interface server and the number of idle worker threads.
+ *
+ * @param poolSize     Return pointer for the number of worker threads.
+ * @param threadAvail  Return pointer for the number of worker threads waiting for a connection.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitInterfaceServerGetStats(size_t *poolSize, size_t *threadAvail);
 
 #endif /*__NOTISERV_H__ */
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file procattr.h
+ * @brief Header related to the scheduling and resource attributes of the processes started for a task.
+ */
+#ifndef __PROCATTR_H__
+#define __PROCATTR_H__
+
+#include <stdint.h>
+#include <sys/resource.h>
+
+/** Type to store a bitmask of the process attributes configured for a task. **/
+typedef unsigned long crinitProcAttrFlags_t;
+/** Bitmask indicating crinitProcAttr_t::cpus is set, corresponds to CPU_AFFINITY. **/
+#define CRINIT_PROC_ATTR_CPUS (1 << 0)
+/** Bitmask indicating crinitProcAttr_t::policy is set, corresponds to SCHED_POLICY. **/
+#define CRINIT_PROC_ATTR_POLICY (1 << 1)
+/** Bitmask indicating crinitProcAttr_t::priority is set, corresponds to SCHED_PRIORITY. **/
+#define CRINIT_PROC_ATTR_PRIORITY (1 << 2)
+/** Bitmask indicating crinitProcAttr_t::nice is set, corresponds to NICE. **/
+#define CRINIT_PROC_ATTR_NICE (1 << 3)
+/** Bitmask indicating crinitProcAttr_t::ioprio is set, corresponds to IOPRIO. **/
+#define CRINIT_PROC_ATTR_IOPRIO (1 << 4)
+
+/** Lowest static scheduling priority allowed for SCHED_PRIORITY, the only valid one for non-real-time policies. **/
+#define CRINIT_PROC_ATTR_PRIORITY_MIN 0
+/** Highest static scheduling priority allowed for SCHED_PRIORITY, see sched_get_priority_max(). **/
+#define CRINIT_PROC_ATTR_PRIORITY_MAX 99
+/** Lowest (i.e. most favorable) nice value allowed for NICE. **/
+#define CRINIT_PROC_ATTR_NICE_MIN (-20)
+/** Highest (i.e. least favorable) nice value allowed for NICE. **/
+#define CRINIT_PROC_ATTR_NICE_MAX 19
+
+/** Number of bits the I/O scheduling class is shifted by in an I/O priority value, see ioprio_set(). **/
+#define CRINIT_IOPRIO_CLASS_SHIFT 13
+/** I/O scheduling class "real-time", see ioprio_set(). **/
+#define CRINIT_IOPRIO_CLASS_RT 1
+/** I/O scheduling class "best-effort", see ioprio_set(). **/
+#define CRINIT_IOPRIO_CLASS_BE 2
+/** I/O scheduling class "idle", see ioprio_set(). **/
+#define CRINIT_IOPRIO_CLASS_IDLE 3
+/** Highest (i.e. least important) priority level within an I/O scheduling class. **/
+#define CRINIT_IOPRIO_LEVEL_MAX 7
+/** Default priority level within the real-time and best-effort I/O scheduling classes. **/
+#define CRINIT_IOPRIO_LEVEL_DEFAULT 4
+/** Build an I/O priority value as used by ioprio_set() from a scheduling class and a priority level. **/
+#define CRINIT_IOPRIO_VALUE(class, level) (((class) << CRINIT_IOPRIO_CLASS_SHIFT) | (level))
+/** The `which` argument to ioprio_set() to target a single thread/process. **/
+#define CRINIT_IOPRIO_WHO_PROCESS 1
+
+/** Maximum number of CPUs which can be addressed in crinitProcAttr_t::cpus, equal to glibc's `CPU_SETSIZE`. **/
+#define CRINIT_PROC_ATTR_MAX_CPUS 1024
+/** Number of bits in a single element of crinitProcAttr_t::cpus. **/
+#define CRINIT_PROC_ATTR_CPU_BITS 64
+/** Number of elements in crinitProcAttr_t::cpus. **/
+#define CRINIT_PROC_ATTR_CPU_WORDS (CRINIT_PROC_ATTR_MAX_CPUS / CRINIT_PROC_ATTR_CPU_BITS)
+/** Check if a CPU is set in crinitProcAttr_t::cpus. **/
+#define crinitProcAttrCpuIsSet(pa, cpu) \
+    (((pa)->cpus[(cpu) / CRINIT_PROC_ATTR_CPU_BITS] >> ((cpu) % CRINIT_PROC_ATTR_CPU_BITS)) & 1u)
+/** Add a CPU to crinitProcAttr_t::cpus. **/
+#define crinitProcAttrCpuSet(pa, cpu) \
+    ((pa)->cpus[(cpu) / CRINIT_PROC_ATTR_CPU_BITS] |= (uint64_t)1 << ((cpu) % CRINIT_PROC_ATTR_CPU_BITS))
+
+/** Number of resource limits which can be set for a task. **/
+#define CRINIT_PROC_ATTR_RLIMITS RLIM_NLIMITS
+
+/**
+ * Type to store the scheduling and resource attributes the processes of a task shall be started with.
+ *
+ * The type does not contain any dynamically allocated memory and can be copied by assignment.
+ */
+typedef struct crinitProcAttr {
+    crinitProcAttrFlags_t flags;                      ///< Bitmask indicating which of the attributes below are set.
+    uint64_t cpus[CRINIT_PROC_ATTR_CPU_WORDS];        ///< Bitmask of the CPUs the processes may run on.
+    int policy;                                       ///< Scheduling policy, for example `SCHED_FIFO`.
+    int priority;                                     ///< Static scheduling priority for `SCHED_FIFO`/`SCHED_RR`.
+    int nice;                                         ///< Nice value, see setpriority().
+    int ioprio;                                       ///< I/O priority value, see CRINIT_IOPRIO_VALUE().
+    unsigned long rlimitsSet;                         ///< Bitmask with bit `(1 << RLIMIT_*)` set for each limit in
+                                                      ///< crinitProcAttr_t::rlimits which shall be applied.
+    struct rlimit rlimits[CRINIT_PROC_ATTR_RLIMITS];  ///< Resource limits, indexed by `RLIMIT_*`.
+} crinitProcAttr_t;
+
+#endif /* __PROCATTR_H__ */
@@ -32,18 +32,4 @@
  */
 int crinitProcDispatchSpawnFunc(crinitTaskDB_t *ctx, const crinitTask_t *t, crinitDispatchThreadMode_t mode);
 
-/**
- * Turn waiting for child processes on or off.
- *
- * If \a inh is set to true, the process dispatch threads will block before waiting for a child process until
- * waiting is reactivated, leaving terminated child processes as zombies for the time being.
- *
- * Modifies errno.
- *
- * @param inh  Set true to inhibit waiting or false to reactivate waiting.
- *
- * @return 0 on success, -1 on error
- */
-int crinitSetInhibitWait(bool inh);
-
 #endif /* __PROCDIP_H__ */
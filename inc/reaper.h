@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file reaper.h
+ * @brief Header related to the central reaper of child processes.
+ */
+#ifndef __REAPER_H__
+#define __REAPER_H__
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <time.h>
+
+/** Initial capacity of the table of child processes watched by the reaper. **/
+#define CRINIT_REAPER_INITIAL_CAP 64
+
+/**
+ * Initializes the reaper and starts the reaper thread.
+ *
+ * Blocks `SIGCHLD` for the calling thread and creates a signalfd for it. The reaper thread will then reap every
+ * terminated child process of Crinit, including orphaned descendants which have been re-parented to Crinit because it
+ * is PID 1 or a child subreaper. Exit statuses of processes started via crinitReaperSpawn() are kept until they are
+ * collected by crinitReaperWait(), all other processes are reaped silently.
+ *
+ * Must be called from the main thread before any other thread is created, so that `SIGCHLD` stays blocked in all
+ * threads of Crinit. Processes spawned by crinitReaperSpawn() need to be started with an empty signal mask, see
+ * `POSIX_SPAWN_SETSIGMASK`.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitReaperInit(void);
+
+/**
+ * Spawns a new process and registers it with the reaper.
+ *
+ * Arguments are the same as for posix_spawn(). The process is spawned without holding the lock of the reaper, so
+ * concurrent calls, the reaper thread and crinitReaperWait() do not wait for each other's posix_spawn(). While a
+ * process is being spawned, only already registered processes are reaped, so the exit status of the new process can
+ * not get lost even if it terminates immediately. Other child processes are reaped as soon as no spawn is in progress
+ * anymore. Every process spawned this way must be collected using crinitReaperWait().
+ *
+ * Modifies errno.
+ *
+ * @param pid       Return pointer for the PID of the new process.
+ * @param path      Path to the executable.
+ * @param fileact   File actions as given to posix_spawn(), may be NULL.
+ * @param attrp     Spawn attributes as given to posix_spawn(), may be NULL.
+ * @param argv      Argument vector of the new process.
+ * @param envp      Environment of the new process.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitReaperSpawn(pid_t *pid, const char *path, const posix_spawn_file_actions_t *fileact,
+                      const posix_spawnattr_t *attrp, char *const argv[], char *const envp[]);
+
+/**
+ * Waits for a process spawned by crinitReaperSpawn() to terminate.
+ *
+ * Blocks until the reaper thread has reaped the process and returns its exit status and resource usage. On success,
+ * the reaper keeps the PID as collected until crinitReaperRelease() is called, so crinitReaperKill() refuses to signal
+ * it while the caller may still hand it out (e.g. as crinitTask_t::pid). If waiting fails, the process is no longer
+ * known to the reaper.
+ *
+ * Modifies errno.
+ *
+ * @param pid     The PID of the process to wait for.
+ * @param status  Return pointer for the exit status of the process in the format of waitid(), may be NULL. Only
+ *                `si_pid`, `si_code`, and `si_status` are set.
+ * @param ru      Return pointer for the resource usage of the process as returned by wait4(), may be NULL.
+ *
+ * @return 0 on success, -1 on error, errno will be set to `ECHILD` if \a pid has not been registered with
+ *         crinitReaperSpawn() or has already been waited for.
+ */
+int crinitReaperWait(pid_t pid, siginfo_t *status, struct rusage *ru);
+
+/**
+ * Forgets a process collected by crinitReaperWait().
+ *
+ * Must be called once the caller will not pass the PID on anymore. Afterwards crinitReaperKill() treats the PID like
+ * any other one, as it may have been reused for another process.
+ *
+ * Modifies errno.
+ *
+ * @param pid  The PID of the collected process.
+ *
+ * @return 0 on success, -1 on error, errno will be set to `ECHILD` if \a pid has not been collected by
+ *         crinitReaperWait() or has already been released.
+ */
+int crinitReaperRelease(pid_t pid);
+
+/**
+ * Sends a signal to a process without racing the reaper.
+ *
+ * No child process is reaped while the signal is sent, so \a pid can not be recycled for another process in between.
+ * If \a pid belongs to a process spawned by crinitReaperSpawn() which has already terminated, also if it has been
+ * collected but not yet released (see crinitReaperRelease()), no signal is sent. Other PIDs (for example a main PID
+ * reported via sd_notify()) are only signalled if they are child processes of Crinit, i.e. re-parented to Crinit
+ * because it is PID 1 or a child subreaper. Crinit can not tell if any other PID still refers to the same process.
+ *
+ * Modifies errno.
+ *
+ * @param pid  The PID of the process to signal.
+ * @param sig  The signal to send.
+ *
+ * @return 0 on success, -1 on error, errno will be set to `ESRCH` if the process has already terminated or is not a
+ *         child process of Crinit.
+ */
+int crinitReaperKill(pid_t pid, int sig);
+
+/**
+ * Waits until Crinit has no child processes left.
+ *
+ * Returns as soon as all child processes, whether spawned by crinitReaperSpawn() or re-parented to Crinit, have
+ * terminated and been reaped. Exit statuses of processes spawned by crinitReaperSpawn() are still kept for
+ * crinitReaperWait(). Meant to be used during shutdown after all processes have been signalled.
+ *
+ * Modifies errno.
+ *
+ * @param deadline  Absolute point in time on `CLOCK_MONOTONIC` after which to give up waiting.
+ *
+ * @return 0 on success, -1 on error, errno will be set to `ETIMEDOUT` if \a deadline has passed while child processes
+ *         are still running.
+ */
+int crinitReaperWaitAll(const struct timespec *deadline);
+
+#endif /* __REAPER_H__ */
@@ -17,6 +17,20 @@
 #define CRINIT_RTIMCMD_RES_OK "RES_OK"    ///< Value of first argument in a positive (successful) response message.
 #define CRINIT_RTIMCMD_RES_ERR "RES_ERR"  ///< Value of first argument in a negative (unsuccessful) response message.
 
+#define CRINIT_RTIMCMD_GRAPH_FIELDS 6  ///< Number of response arguments per task in a response to the "graph" command.
+
+#define CRINIT_RTIMCMD_TRACE_FIELDS 6  ///< Number of response arguments per event in a response to the "trace" command.
+/** Maximum number of events in a single response to the "trace" command. **/
+#define CRINIT_RTIMCMD_TRACE_CHUNK 256
+
+/** Number of response arguments per metric in a response to the "stats" command, not counting histogram buckets. **/
+#define CRINIT_RTIMCMD_STATS_FIELDS 3
+
+#define CRINIT_RTIMCMD_STATUS_ARGS 10  ///< Number of arguments in a positive response to the "status" command.
+
+/** Number of response arguments per usage record in a response to the "usage" command. **/
+#define CRINIT_RTIMCMD_USAGE_FIELDS 6
+
 /**
  * Structure holding a command or response message with its crinitRtimOp_t opcode and arguments array.
  */
@@ -13,7 +13,7 @@
  */
 #define crinitGenOpMap(f)                                                                                   \
     f(ADDTASK) f(ADDSERIES) f(ENABLE) f(DISABLE) f(STOP) f(KILL) f(RESTART) f(NOTIFY) f(STATUS) f(TASKLIST) \
-        f(SHUTDOWN) f(GETVER)
+        f(SHUTDOWN) f(GETVER) f(GRAPH) f(TRACE) f(STATS) f(USAGE)
 /**
  * Macro to generate the opcode enum for crinitGenOpMap().
  *
@@ -24,6 +24,14 @@
  * Macro to generate the opcode-to-string mapping for crinitGenOpMap().
  */
 #define crinitGenOpStruct(x) {CRINIT_RTIMCMD_C_##x, "C_" #x}, {CRINIT_RTIMCMD_R_##x, "R_" #x},
+/**
+ * Macro to count the commands in crinitGenOpMap().
+ */
+#define crinitGenOpCount(x) +1
+/**
+ * Number of commands in crinitGenOpMap(). The command opcode of the n-th command is `2 * n`.
+ */
+#define CRINIT_RTIMCMD_NUM_CMDS (0 crinitGenOpMap(crinitGenOpCount))
 
 /**
  * Enum of the available opcodes, including commands and results/responses.
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file shutdown.h
+ * @brief Header related to stopping the tasks of a TaskDB in dependency order on shutdown.
+ */
+#ifndef __SHUTDOWN_H__
+#define __SHUTDOWN_H__
+
+#include <limits.h>
+
+#include "taskdb.h"
+
+/**
+ * Maximum time in milliseconds between two checks if a stopping task has terminated.
+ *
+ * Termination of processes spawned by Crinit is signalled via crinitTaskDB_t::changed. This is only relevant for
+ * processes which are not children of Crinit, e.g. a main PID reported via sd_notify().
+ */
+#define CRINIT_SHUTDOWN_POLL_INTERVAL_MS 100
+
+/** Maximum number of threads syncing and unmounting filesystems in parallel, including the calling thread. **/
+#define CRINIT_SHUTDOWN_UMOUNT_THREADS 4
+
+/**
+ * Stack size for the threads syncing and unmounting filesystems.
+ */
+#define CRINIT_SHUTDOWN_UMOUNT_THREAD_STACK_SIZE (PTHREAD_STACK_MIN + 112 * 1024)
+
+/**
+ * Stop all tasks of a TaskDB in reverse dependency order.
+ *
+ * A task is stopped once all tasks depending on it (via DEPENDS on the task itself or on a feature it PROVIDES) have
+ * been stopped, independent tasks are stopped in parallel. To stop a task, its STOP_COMMANDs are run if there are any,
+ * otherwise its process receives `SIGTERM`. If the task has its own cgroup, the signal is sent to all processes of the
+ * cgroup. The task counts as stopped as soon as its STOP_COMMANDs have finished and its process has terminated. If
+ * that does not happen within its STOP_TIMEOUT_MS (or \a defaultTimeoutUs if unset), the task is killed using
+ * `SIGKILL`, via `cgroup.kill` if available.
+ *
+ * Tasks caught in a dependency cycle are stopped together once nothing else can make progress.
+ *
+ * Spawning of new tasks should be inhibited using crinitTaskDBSetSpawnInhibit() beforehand. The function uses
+ * crinitTaskDB_t::lock for synchronization and is thread-safe.
+ *
+ * @param ctx               The TaskDB containing the tasks to stop.
+ * @param defaultTimeoutUs  Time in microseconds a task may take to stop if it does not set STOP_TIMEOUT_MS.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitShutdownStopTasks(crinitTaskDB_t *ctx, unsigned long long defaultTimeoutUs);
+
+/**
+ * Prepares mounted filesystems for shutdown.
+ *
+ * Reads the tree of mounted filesystems from `/proc/self/mountinfo` and unmounts everything except the root mount,
+ * always unmounting children before their parents. Independent subtrees are handled in parallel by up to
+ * #CRINIT_SHUTDOWN_UMOUNT_THREADS threads. Each filesystem is synced using syncfs() before it is unmounted. Busy
+ * filesystems are detached using `MNT_DETACH`. As before, mounts with the source `none` are left alone. The time each
+ * unmount took is logged.
+ *
+ * Finally, the root mount is remounted read-only if it was writable before and everything is synced once more.
+ *
+ * @return  0 on success, -1 if any filesystem could not be unmounted or remounted
+ */
+int crinitShutdownFilesystems(void);
+
+#endif /* __SHUTDOWN_H__ */
@@ -14,6 +14,7 @@
 #include "crinit-sdefs.h"
 #include "envset.h"
 #include "ioredir.h"
+#include "procattr.h"
 
 #ifdef ENABLE_CGROUP
 #include "cgroup.h"
@@ -30,6 +31,15 @@ typedef unsigned long crinitTaskOpts_t;
 /** Default value for TRIGGER_REARM option. **/
 #define CRINIT_TASK_OPT_TRIGGER_REARM_DEFAULT false
 
+/** Default value for RESPAWN_DELAY_MS, the initial respawn backoff in milliseconds. **/
+#define CRINIT_TASK_RESPAWN_DELAY_DEFAULT 100
+/** Default value for RESPAWN_DELAY_MAX_MS, the maximum respawn backoff in milliseconds. **/
+#define CRINIT_TASK_RESPAWN_DELAY_MAX_DEFAULT 30000
+/** Default value for RESPAWN_RESET_MS, run time in milliseconds after which a failure does not count as a crash. **/
+#define CRINIT_TASK_RESPAWN_RESET_DEFAULT 10000
+/** Default value for STOP_TIMEOUT_MS, 0 means the global SHUTDOWN_GRACE_PERIOD_US is used. **/
+#define CRINIT_TASK_STOP_TIMEOUT_DEFAULT 0
+
 /** Dependency event that fires when a task reaches the RUNNING state. **/
 #define CRINIT_TASK_EVENT_RUNNING "spawn"
 /** Dependency event that fires when a task reaches the DONE state. **/
@@ -60,8 +70,10 @@ typedef enum crinitTaskTimestampType {
  * Type to store a single command within a task.
  */
 typedef struct crinitTaskCmd {
-    int argc;     ///< Number of arguments within argv.
-    char **argv;  ///< String array containing the program arguments, argv[0] contains absolute path to executable.
+    int argc;                 ///< Number of arguments within argv.
+    char **argv;              ///< String array containing the program arguments, argv[0] contains absolute path to
+                              ///< executable.
+    crinitTaskUsage_t usage;  ///< Resource usage accumulated over all runs of the command.
 } crinitTaskCmd_t;
 
 /**
@@ -80,6 +92,17 @@ typedef struct crinitTaskPrv {
     crinitTaskState_t stateReq;  ///< The task state required to be reached to provide the feature.
 } crinitTaskPrv_t;
 
+/**
+ * Type to store the results of the dependency graph analysis for a single task (see taskgraph.h).
+ */
+typedef struct crinitTaskGraphInfo {
+    size_t depth;      ///< Length of the longest chain of unfulfilled dependencies leading up to the task.
+    size_t fanOut;     ///< Number of tasks directly waiting on this task.
+    size_t chainLen;   ///< Number of tasks on the longest dependency chain starting at this task (including itself).
+    uint64_t chainNs;  ///< Estimated run time of the longest dependency chain starting at this task in nanoseconds.
+    bool critical;     ///< True if the task lies on the overall critical path of the TaskDB.
+} crinitTaskGraphInfo_t;
+
 /**
  * Type to store a single task.
  */
@@ -93,6 +116,8 @@ typedef struct crinitTask {
     crinitEnvSet_t elosFilters;  ///< Elos filter definitions valid for use in dependencies of this task.
     crinitTaskDep_t *deps;       ///< Dynamic array of dependencies, corresponds to DEPENDS in the config file.
     size_t depsSize;             ///< Number of dependencies in deps array.
+    crinitTaskDep_t *cfgDeps;    ///< Copy of deps as loaded, not affected by fulfillment. Used to order shutdown.
+    size_t cfgDepsSize;          ///< Number of dependencies in cfgDeps array.
     crinitTaskDep_t *trig;       ///< Dynamic array of trigger, corresponds to TRIGGER in the config file.
     size_t trigSize;             ///< Number of trigger in trig array.
     bool triggered;              ///< Task was triggered (or no trigger where set) and can be run
@@ -108,6 +133,13 @@ typedef struct crinitTask {
     int failCount;               ///< Counts consecutive respawns after failure (see crinitTaskOpts_t::maxRetries).
                                  ///< Resets on a successful completion (i.e. all COMMANDs in the task have returned 0).
     bool inhibitRespawn;         ///< If task was stopped via user interaction, do not respawn it.
+    uint32_t respawnDelay;       ///< Initial respawn backoff in milliseconds after a crash, 0 disables the backoff.
+    uint32_t respawnDelayMax;    ///< Maximum respawn backoff in milliseconds.
+    uint32_t respawnReset;       ///< Minimum run time in milliseconds for a failure not to be counted as a crash.
+    uint32_t backoffLevel;       ///< Number of consecutive crashes, i.e. failures before crinitTask_t::respawnReset.
+    bool respawnHeld;            ///< The task waits for its respawn backoff timer and is not ready in the meantime.
+    uint32_t stopTimeout;        ///< Time in milliseconds the task may take to stop on shutdown, 0 for the default.
+    size_t stopThreads;          ///< Number of dispatch threads currently executing the STOP_COMMANDs of the task.
     struct timespec createTime;  ///< The time the task was created (i.e. has been loaded and parsed).
     struct timespec startTime;   ///< The time the task last became 'running'.
     struct timespec endTime;     ///< The time the task last became 'done' or 'failed.
@@ -124,6 +156,9 @@ typedef struct crinitTask {
 #ifdef ENABLE_CGROUP
     crinitCgroup_t *cgroup;  ///< Object that holds an optional cgroup for the task.
 #endif
+    crinitTaskGraphInfo_t graph;  ///< Results of the last dependency graph analysis, see crinitTaskGraphAnalyze().
+    crinitProcAttr_t procAttr;    ///< Scheduling and resource attributes for the task's processes.
+    crinitTaskUsage_t usage;      ///< Resource usage accumulated over all terminated processes of the task.
 } crinitTask_t;
 
 /**
@@ -194,6 +229,36 @@ int crinitTaskDup(crinitTask_t **out, const crinitTask_t *orig);
  */
 int crinitTaskCopy(crinitTask_t *out, const crinitTask_t *orig);
 
+/**
+ * Calculate the respawn backoff of a task after it has failed.
+ *
+ * If the task has run for less than crinitTask_t::respawnReset milliseconds, the failure counts as a crash and
+ * crinitTask_t::backoffLevel is incremented. The backoff then is crinitTask_t::respawnDelay doubled for each
+ * consecutive crash but the first, limited to crinitTask_t::respawnDelayMax. To avoid crash-looping tasks being
+ * restarted in lockstep, a random jitter is applied so that the returned delay lies between half of and the full
+ * backoff. If the task has run for long enough or crinitTask_t::respawnDelay is 0, crinitTask_t::backoffLevel is reset
+ * and the function returns 0.
+ *
+ * @param t          The task which has failed, crinitTask_t::backoffLevel will be updated.
+ * @param runtimeNs  How long the failed process(es) of the task have run in nanoseconds.
+ * @param rnd        A random value used for the jitter.
+ *
+ * @return  The delay in milliseconds after which the task may be respawned, 0 if it may be respawned immediately.
+ */
+uint32_t crinitTaskRespawnBackoff(crinitTask_t *t, uint64_t runtimeNs, uint32_t rnd);
+
+/**
+ * Add the resource usage of a terminated process to an accumulated resource usage.
+ *
+ * CPU times and block I/O counts are summed up, crinitTaskUsage_t::maxRss is the maximum over all processes.
+ *
+ * @param u   The accumulated resource usage to update.
+ * @param ru  The resource usage of a single terminated process as returned by wait4().
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTaskUsageAdd(crinitTaskUsage_t *u, const struct rusage *ru);
+
 /**
  * Merges the options set in a given include file into the target crinitTask_t.
  *
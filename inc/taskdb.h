@@ -8,7 +8,9 @@
 
 #include <pthread.h>
 #include <stddef.h>
+#include <stdint.h>
 
+#include "lockprof.h"
 #include "task.h"
 
 #define CRINIT_MONITOR_DEP_NAME "@crinitmon"  ///< Special dependency name to depend on monitor events (not yet impl.).
@@ -36,10 +38,17 @@ typedef struct crinitTaskDB {
 
     bool
         spawnInhibit;  ///< Specifies if process spawning is currently inhibited, respected by crinitTaskDBSpawnReady().
+    /**
+     * Specifies if crinitTask_t::graph of all tasks is up to date. Reset whenever tasks are inserted, their remaining
+     * dependencies change or they end, so crinitTaskGraphAnalyze() only needs to run again after such a change.
+     */
+    bool graphValid;
 
     pthread_mutex_t lock;    ///< Mutex to lock the TaskDB, shall be used for any operations on the data structure if
                              ///< multiple threads are involved.
-    pthread_cond_t changed;  ///< Condition variable to be signalled if taskSet or spawnInhibit is changed.
+    pthread_cond_t changed;  ///< Condition variable to be signalled if taskSet or spawnInhibit is changed. Uses
+                             ///< `CLOCK_MONOTONIC` for timed waits.
+    uint64_t lockedAt;       ///< Time the lock was last acquired by crinitTaskDBLock(), guarded by the lock itself.
 } crinitTaskDB_t;
 
 /**
@@ -93,6 +102,21 @@ int crinitTaskDBInsert(crinitTaskDB_t *ctx, const crinitTask_t *t, bool overwrit
  * @return 0 on success, -1 otherwise
  */
 int crinitTaskDBFulfillDep(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, crinitTask_t *target);
+/**
+ * Fulfill several dependencies for all tasks inside a task database at once.
+ *
+ * Same as calling crinitTaskDBFulfillDep() with a NULL target for each element of \a deps but takes
+ * crinitTaskDB_t::lock and signals crinitTaskDB_t::changed only once.
+ *
+ * Modifies errno.
+ *
+ * @param ctx      The crinitTaskDB_t context in which to fulfill the dependencies.
+ * @param deps     Array of the dependencies to be fulfilled.
+ * @param numDeps  Number of elements in \a deps.
+ *
+ * @return 0 on success, -1 otherwise
+ */
+int crinitTaskDBFulfillDeps(crinitTaskDB_t *ctx, const crinitTaskDep_t *deps, size_t numDeps);
 /**
  * Fulfill feature dependencies implemented by a provider task.
  *
@@ -195,6 +219,10 @@ int crinitTaskRearmTrigger(crinitTaskDB_t *ctx, const char *taskName);
  * crinitTask_t::failCount will be reset to 0. The function uses crinitTaskDB_t::lock for synchronization and is
  * thread-safe.
  *
+ * If a respawning task fails and crinitTaskRespawnBackoff() returns a delay, the task is marked with
+ * #CRINIT_TASK_STATE_CRASHLOOP and held back from respawning until a timer started through
+ * crinitTimerDBAddRespawnTimer() calls crinitTaskDBReleaseRespawn().
+ *
  * Modifies errno.
  *
  * @param ctx       The crinitTaskDB_t context in which the task is held.
@@ -237,6 +265,27 @@ int crinitTaskDBGetTaskState(crinitTaskDB_t *ctx, crinitTaskState_t *s, const ch
  * @return 0 on success, -1 otherwise.
  */
 int crinitTaskDBSetTaskPID(crinitTaskDB_t *ctx, pid_t pid, const char *taskName);
+
+/**
+ * Account the resource usage of a terminated process to a task in a task database.
+ *
+ * Will search \a ctx for an crinitTask_t with crinitTask_t::name lexicographically equal to \a taskName and add \a ru
+ * to crinitTask_t::usage as well as to crinitTaskCmd_t::usage of the command the process was started for, see
+ * crinitTaskUsageAdd(). If such a task does not exit in \a ctx, an error is returned. The function uses
+ * crinitTaskDB_t::lock for synchronization and is thread-safe.
+ *
+ * Modifies errno.
+ *
+ * @param ctx       The crinitTaskDB_t context in which the task is held.
+ * @param ru        The resource usage of the terminated process.
+ * @param mode      Selects if \a cmdIdx refers to crinitTask_t::cmds or crinitTask_t::stopCmds.
+ * @param cmdIdx    Index of the command the process was started for.
+ * @param taskName  The task's name.
+ *
+ * @return 0 on success, -1 otherwise.
+ */
+int crinitTaskDBAddTaskUsage(crinitTaskDB_t *ctx, const struct rusage *ru, crinitDispatchThreadMode_t mode,
+                             size_t cmdIdx, const char *taskName);
 /**
  * Get the PID of a task in a task database
  *
@@ -288,6 +337,63 @@ int crinitTaskDBGetTaskStateAndPID(crinitTaskDB_t *ctx, crinitTaskState_t *s, pi
  */
 int crinitTaskDBSetTaskRespawnInhibit(crinitTaskDB_t *ctx, bool inhibit, const char *taskName);
 
+/**
+ * Ends the respawn backoff of a task.
+ *
+ * Resets crinitTask_t::respawnHeld so that the task becomes ready for respawning again and signals
+ * crinitTaskDB_t::changed. Called by the TimerDB once the backoff timer of the task has expired.
+ *
+ * Modifies errno.
+ *
+ * @param ctx       The crinitTaskDB_t context in which the task is held.
+ * @param taskName  The task's name.
+ *
+ * @return  0 on success, -1 otherwise.
+ */
+int crinitTaskDBReleaseRespawn(crinitTaskDB_t *ctx, const char *taskName);
+
+/**
+ * Lock the mutex of a task database.
+ *
+ * Works like pthread_mutex_lock() on crinitTaskDB_t::lock but additionally records the time spent waiting for and
+ * holding the lock in the metrics registry, and a boot trace event if the lock was contended. With lock profiling, the
+ * acquisition is also recorded for the calling site, see lockprof.h. The lock must be released using
+ * crinitTaskDBUnlock().
+ *
+ * @param ctx  The TaskDB to lock.
+ *
+ * @return  0 on success, an error number as returned by pthread_mutex_lock() otherwise
+ */
+#define crinitTaskDBLock(ctx) crinitTaskDBLockAt(ctx, CRINIT_LOCKPROF_SITE)
+/**
+ * Implementation of crinitTaskDBLock() taking the call site explicitly.
+ *
+ * @param ctx   The TaskDB to lock.
+ * @param site  The call site, see #CRINIT_LOCKPROF_SITE.
+ *
+ * @return  0 on success, an error number as returned by pthread_mutex_lock() otherwise
+ */
+int crinitTaskDBLockAt(crinitTaskDB_t *ctx, const char *site);
+/**
+ * Unlock the mutex of a task database locked by crinitTaskDBLock().
+ *
+ * @param ctx  The TaskDB to unlock.
+ *
+ * @return  0 on success, an error number as returned by pthread_mutex_unlock() otherwise
+ */
+int crinitTaskDBUnlock(crinitTaskDB_t *ctx);
+/**
+ * Wait for crinitTaskDB_t::changed on a task database locked by crinitTaskDBLock().
+ *
+ * The lock is released during the wait, so its hold time is recorded before and a new one started after.
+ *
+ * @param ctx      The locked TaskDB.
+ * @param abstime  Absolute timeout as for pthread_cond_timedwait(), or NULL to wait without timeout.
+ *
+ * @return  0 on success, an error number as returned by pthread_cond_wait() or pthread_cond_timedwait() otherwise
+ */
+int crinitTaskDBWaitChanged(crinitTaskDB_t *ctx, const struct timespec *abstime);
+
 /**
  * Provide direct thread-safe access to a task within a task database
  *
@@ -332,6 +438,10 @@ int crinitTaskDBRemit(crinitTaskDB_t *ctx);
  * If crinitTaskDB::spawnInhibit is true, no tasks are considered startable and this function will return successfully
  * without starting anything.
  *
+ * If more than one task is startable, the tasks are spawned in the order given by crinitTaskGraphCmpPriority(), i.e.
+ * tasks heading the longest remaining dependency chain go first. The dependency graph is only analyzed again if it has
+ * changed since the last analysis, see crinitTaskDB_t::graphValid.
+ *
  * Modifies errno.
  *
  * @param ctx  The TaskDB context from which tasks will be started.
@@ -340,6 +450,20 @@ int crinitTaskDBRemit(crinitTaskDB_t *ctx);
  * @return 0 on success, -1 otherwise
  */
 int crinitTaskDBSpawnReady(crinitTaskDB_t *ctx, crinitDispatchThreadMode_t mode);
+/**
+ * Run the dependency graph analysis on all tasks in a task database.
+ *
+ * Updates crinitTask_t::graph of every task, see crinitTaskGraphAnalyze() for details. Does nothing if the results of
+ * the last analysis are still valid, see crinitTaskDB_t::graphValid. The function uses crinitTaskDB_t::lock for
+ * synchronization and is thread-safe.
+ *
+ * Modifies errno.
+ *
+ * @param ctx  The TaskDB context to analyze.
+ *
+ * @return 0 on success, -1 otherwise
+ */
+int crinitTaskDBAnalyzeGraph(crinitTaskDB_t *ctx);
 /**
  * Inhibit or un-inhibit spawning of processes by setting crinitTaskDB_t::spawnInhibit.
  *
@@ -354,6 +478,34 @@ int crinitTaskDBSpawnReady(crinitTaskDB_t *ctx, crinitDispatchThreadMode_t mode)
  * @return 0 on success, -1 otherwise
  */
 int crinitTaskDBSetSpawnInhibit(crinitTaskDB_t *ctx, bool inh);
+/**
+ * Spawn the STOP_COMMANDs of a task.
+ *
+ * Calls crinitTaskDB_t::spawnFunc in mode CRINIT_DISPATCH_THREAD_MODE_STOP for the task and increments its
+ * crinitTask_t::stopThreads. The function uses crinitTaskDB_t::lock for synchronization and is thread-safe.
+ *
+ * Modifies errno.
+ *
+ * @param ctx       The TaskDB context containing the task.
+ * @param taskName  The name of the task to stop.
+ *
+ * @return 0 on success, -1 otherwise
+ */
+int crinitTaskDBSpawnStopCommands(crinitTaskDB_t *ctx, const char *taskName);
+/**
+ * Signal that a dispatch thread executing the STOP_COMMANDs of a task has finished.
+ *
+ * Decrements crinitTask_t::stopThreads of the task and signals crinitTaskDB_t::changed. The function uses
+ * crinitTaskDB_t::lock for synchronization and is thread-safe.
+ *
+ * Modifies errno.
+ *
+ * @param ctx       The TaskDB context containing the task.
+ * @param taskName  The name of the task whose STOP_COMMANDs have finished.
+ *
+ * @return 0 on success, -1 otherwise
+ */
+int crinitTaskDBStopThreadDone(crinitTaskDB_t *ctx, const char *taskName);
 
 /**
  *  Initialize the internals of an crinitTaskDB_t with a specified initial size for crinitTaskDB_t::taskSet.
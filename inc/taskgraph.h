@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file taskgraph.h
+ * @brief Header related to the analysis of the dependency graph formed by the tasks of a TaskDB.
+ */
+#ifndef __TASKGRAPH_H__
+#define __TASKGRAPH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "task.h"
+
+/**
+ * Analyze the dependency graph formed by an array of tasks.
+ *
+ * Edges of the graph are given by the remaining (i.e. not yet fulfilled) dependencies of each task. A dependency of the
+ * form `<taskname>:<event>` creates an edge from the named task to the dependent task, a dependency of the form
+ * `@provided:<feature>` creates an edge from each task which PROVIDES `<feature>` to the dependent task. Other special
+ * dependencies (`@ctl`, `@elos`, `@timer`, ...) do not refer to another task and are ignored.
+ *
+ * The estimated run time of a single task is taken from its last run, i.e. the difference between
+ * crinitTask_t::endTime and crinitTask_t::startTime if the task has ended after it was last started. Tasks without
+ * such a history are assumed to take no time, so that the number of tasks on a chain decides in that case.
+ *
+ * The results are written to crinitTask_t::graph of each task. Dependency cycles are broken at the first edge closing
+ * the cycle.
+ *
+ * The function does not lock anything. If the tasks are part of a TaskDB, the caller must hold crinitTaskDB_t::lock.
+ *
+ * @param tasks     Array of tasks to analyze.
+ * @param numTasks  Number of elements in \a tasks.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTaskGraphAnalyze(crinitTask_t *tasks, size_t numTasks);
+
+/**
+ * Get the estimated run time of a single task from its timestamps.
+ *
+ * @param t  The task in question.
+ *
+ * @return  The time in nanoseconds between the last start and the last end of \a t, or 0 if \a t has not yet ended
+ *          after its last start.
+ */
+uint64_t crinitTaskGraphTaskDuration(const crinitTask_t *t);
+
+/**
+ * Compare two tasks by their spawn priority for use with qsort().
+ *
+ * Both arguments are pointers to `crinitTask_t *`. A task sorts before another if its critical dependency chain takes
+ * longer, then if the chain contains more tasks, then if more tasks directly depend on it. Ties are broken by the
+ * position in memory so that the order is stable with regard to the TaskDB.
+ *
+ * @param a  Pointer to the first task pointer.
+ * @param b  Pointer to the second task pointer.
+ *
+ * @return  A negative value if \a a should be spawned first, a positive value if \a b should be spawned first.
+ */
+int crinitTaskGraphCmpPriority(const void *a, const void *b);
+
+/**
+ * Order in which the tasks of an array shall be stopped, see crinitTaskGraphStopPlan().
+ *
+ * A task may be stopped as soon as all tasks depending on it have been stopped, i.e. once its
+ * crinitTaskGraphStopPlan_t::waitCount has dropped to 0. Each time a task has been stopped, the
+ * crinitTaskGraphStopPlan_t::waitCount of all tasks it depends on needs to be decremented.
+ */
+typedef struct crinitTaskGraphStopPlan {
+    size_t numTasks;    ///< Number of tasks in the plan.
+    size_t *waitCount;  ///< Number of tasks depending on each task, i.e. which need to be stopped before it.
+    size_t *depStart;   ///< Index of the first dependency of each task in depList (plus one end marker).
+    size_t *depList;    ///< Indices of the tasks each task depends on, grouped by task.
+} crinitTaskGraphStopPlan_t;
+
+/**
+ * Build the order in which an array of tasks shall be stopped.
+ *
+ * Uses the same edges as crinitTaskGraphAnalyze() but built from the dependencies as they were loaded
+ * (crinitTask_t::cfgDeps), so that the order does not depend on which dependencies have already been fulfilled.
+ * Dependency cycles are not broken, the caller needs to handle tasks whose crinitTaskGraphStopPlan_t::waitCount never
+ * drops to 0.
+ *
+ * The function does not lock anything. If the tasks are part of a TaskDB, the caller must hold crinitTaskDB_t::lock.
+ * The plan must be freed using crinitTaskGraphStopPlanDestroy().
+ *
+ * @param plan      Return pointer for the plan.
+ * @param tasks     Array of tasks to plan for.
+ * @param numTasks  Number of elements in \a tasks.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTaskGraphStopPlan(crinitTaskGraphStopPlan_t *plan, crinitTask_t *tasks, size_t numTasks);
+
+/**
+ * Free the memory held by a crinitTaskGraphStopPlan_t.
+ *
+ * @param plan  The plan to free the members of.
+ */
+void crinitTaskGraphStopPlanDestroy(crinitTaskGraphStopPlan_t *plan);
+
+#endif /* __TASKGRAPH_H__ */
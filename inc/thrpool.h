@@ -72,5 +72,17 @@ int crinitThreadPoolThreadBusyCallback(crinitThreadPool_t *ctx);
  * @return 0 on success, -1 otherwise
  */
 int crinitThreadPoolThreadAvailCallback(crinitThreadPool_t *ctx);
+/**
+ * Get the current size of the pool and the number of available worker threads.
+ *
+ * Modifies errno.
+ *
+ * @param ctx          The crinitThreadPool_t context.
+ * @param poolSize     Return pointer for crinitThreadPool_t::poolSize.
+ * @param threadAvail  Return pointer for crinitThreadPool_t::threadAvail.
+ *
+ * @return 0 on success, -1 otherwise
+ */
+int crinitThreadPoolGetStats(crinitThreadPool_t *ctx, size_t *poolSize, size_t *threadAvail);
 
 #endif /* __THRPOOL_H__ */
@@ -19,16 +19,66 @@ typedef struct crinitTimerDef {
     uint8_t minutes[2];
     uint8_t seconds[2];
     int8_t timezone[2];
+    uint64_t intervalNs;  ///< Period of an interval timer in nanoseconds, 0 for a calendar timer.
+    bool sinceArmed;      ///< If the timer expires once, a period after its task has been armed (`after:`).
 } crinitTimerDef_t;
 
+/**
+ * Upper limit for crinitTimerDef_t::intervalNs, one year.
+ */
+#define CRINIT_TIMER_INTERVAL_MAX_NS (UINT64_C(366) * 24 * 3600 * 1000000000)
+
+/**
+ * A timer definition compiled for fast calculation of its next expiration.
+ *
+ * Created from a crinitTimerDef_t using crinitTimerCompile(). Every field is stored as a bitset of its matching values,
+ * days of the month are pre-combined with the months and the weekdays into lookup tables.
+ */
+typedef struct crinitTimerCompiled {
+    uint64_t seconds;           ///< Bit n is set if second n of a minute matches.
+    uint64_t minutes;           ///< Bit n is set if minute n of an hour matches.
+    uint32_t hours;             ///< Bit n is set if hour n of a day matches.
+    uint32_t monthDays[2][13];  ///< Bit n is set if day n of a month matches, indexed by leap year and month (1..12).
+    uint32_t weekdayDays[7];    ///< Bit n is set if day n matches the weekdays, indexed by weekday (Mon = 0) of day 1.
+    uint16_t years[2];          ///< Range of matching years, wraps around if the start is after the end.
+    long tzOffset;              ///< Offset of the timezone from UTC in seconds.
+} crinitTimerCompiled_t;
+
+/**
+ * The kind of a crinit timer object.
+ */
+typedef enum crinitTimerType {
+    CRINIT_TIMER_TYPE_CALENDAR = 0,  ///< Recurring wall-clock timer fulfilling `@timer:<name>` dependencies.
+    CRINIT_TIMER_TYPE_INTERVAL,      ///< Recurring boottime timer fulfilling `@timer:every:<period>` dependencies.
+    CRINIT_TIMER_TYPE_RESPAWN,       ///< One-shot monotonic timer ending the respawn backoff of the task `<name>`.
+    /**
+     * One-shot boottime timer fulfilling the `@timer:after:<period>` dependency of a single task. The name holds the
+     * task name followed by the spelling of the dependency in the same allocation, separated by its terminating zero.
+     */
+    CRINIT_TIMER_TYPE_AFTER
+} crinitTimerType_t;
+
 /**
  * The type of a crinit timer object.
  */
 typedef struct crinitTimer {
     crinitTimerDef_t def;
+    crinitTimerCompiled_t compiled;
     char *name;
     size_t refs;
     struct itimerspec next;
+    crinitTimerType_t type;
+    struct crinitTimerEntry *entry;  ///< Index entry of a timer fulfilling `@timer` dependencies, NULL otherwise.
+    /**
+     * `CLOCK_BOOTTIME` of the last expiration of a calendar timer or of when it has been added. Tells how much time
+     * has really passed since then if the system time is set.
+     */
+    struct timespec lastBoot;
+    /**
+     * If the system time was before the last expiration of a calendar timer in the timer store when it was added, so
+     * missed expirations can only be checked for once the system time is set.
+     */
+    bool catchUpPending;
 } crinitTimer_t;
 
 /**
@@ -119,13 +169,51 @@ bool crinitTimerParse(char *s, crinitTimerDef_t *td);
 /**
  * Calculate the next time the timer should trigger.
  *
+ * Compiles \a td using crinitTimerCompile() and uses crinitTimerNextTimeCompiled(). Use these directly if the next time
+ * of the same timer is needed repeatedly.
+ *
  * @param last  the last timestamp to calculate the next from
  * @param td    the timer definition to calculate the next time from
  *
- * @return the timestamp the timer is fullfiled next
+ * @return the timestamp the timer is fullfiled next, 0 if there is none
  */
 struct timespec crinitTimerNextTime(struct timespec *last, crinitTimerDef_t *td);
 
+/**
+ * Compile a timer definition for use with crinitTimerNextTimeCompiled().
+ *
+ * @param td  the timer definition to compile, should be valid according to crinitCheckTimerDef()
+ * @param tc  the compiled timer to set
+ */
+void crinitTimerCompile(const crinitTimerDef_t *td, crinitTimerCompiled_t *tc);
+
+/**
+ * Calculate the next time a compiled timer should trigger.
+ *
+ * Finds the first full second after \a last matching the timer definition directly, skipping over whole non-matching
+ * years, months, days, hours, and minutes. The nanoseconds of \a last are kept.
+ *
+ * @param last  the last timestamp to calculate the next from
+ * @param tc    the compiled timer definition
+ *
+ * @return the timestamp the timer is fullfiled next, 0 if there is none
+ */
+struct timespec crinitTimerNextTimeCompiled(const struct timespec *last, const crinitTimerCompiled_t *tc);
+
+/**
+ * Calculate the next time an interval timer should trigger.
+ *
+ * Only adds up periods, no calendar calculations are involved. Periods which have already passed at \a now are skipped,
+ * so a late timer expires once and then continues on its original schedule.
+ *
+ * @param last        the last expiration, the time the timer has been armed at, or 0 for the time of boot
+ * @param now         the current time on the same clock as \a last
+ * @param intervalNs  the period of the timer in nanoseconds
+ *
+ * @return the first time after \a now which is a whole number of periods after \a last, 0 if \a intervalNs is 0
+ */
+struct timespec crinitTimerNextInterval(const struct timespec *last, const struct timespec *now, uint64_t intervalNs);
+
 /**
  * Get a `struct tm` similar to `gmtime_r` with a specific timezone.
  *
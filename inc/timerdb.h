@@ -9,28 +9,79 @@
 
 #include "taskdb.h"
 #include "timer.h"
+#include "timerheap.h"
+#include "timerindex.h"
+#include "timerstore.h"
 
 /**
  * the initial capacity for the crinit timer db.
  */
 #define TIMER_DB_INITIAL_CAP 256
 
+/**
+ * A queue of timers on the same clock, driven by a single timerfd.
+ */
+typedef struct crinitTimerQueue {
+    crinitTimerHeap_t heap;  ///< The timers, ordered by their next expiration.
+    clockid_t clock;         ///< The clock crinitTimer_t::next of all timers refers to.
+    int fd;                  ///< Timerfd on crinitTimerQueue_t::clock, armed for the first timer in the heap.
+} crinitTimerQueue_t;
+
+/**
+ * Upper limit for the TIMER_SLACK_MS global option, larger values are clamped.
+ */
+#define CRINIT_TIMER_DB_MAX_SLACK_MS 3600000uLL
+
+/**
+ * Counters of the TimerDB to measure how often the timer thread wakes up, see crinitTimerDBGetStats().
+ */
+typedef struct crinitTimerDBStats {
+    uint64_t wakeups;      ///< Number of times the timer thread has been woken up by an expired timer.
+    uint64_t expirations;  ///< Number of expirations of calendar, interval and after timers.
+    uint64_t batches;      ///< Number of batches the expired calendar and interval timers were passed to the TaskDB in.
+    uint64_t respawns;     ///< Number of expired respawn timers.
+    uint64_t clockSets;    ///< Number of times the system time has been set and the calendar timers were rescheduled.
+    uint64_t catchUps;     ///< Number of missed expirations of calendar timers which have been made up for.
+} crinitTimerDBStats_t;
+
 /**
  * the type for the crinit timer db.
  */
 typedef struct crinitTimerDB {
-    size_t cap;
-    size_t size;
-    crinitTimer_t *timerList;
-    struct pollfd *pollList;
+    crinitTimerQueue_t calendar;  ///< Recurring wall-clock timers fulfilling `@timer` dependencies.
+    crinitTimerQueue_t interval;  ///< Recurring boottime timers fulfilling `@timer:every:` dependencies.
+    crinitTimerQueue_t respawn;   ///< One-shot monotonic timers ending the respawn backoff of a task.
+    crinitTimerQueue_t after;     ///< One-shot boottime timers fulfilling the `@timer:after:` dependency of a task.
+    crinitTimerIndex_t index;     ///< The calendar and interval timers by spelling and by parsed definition.
+    int eventFd;                  ///< Eventfd to wake up the timer thread after timers have been added or removed.
+    unsigned long long slackMs;   ///< Calendar timers may expire this much late to be batched, see TIMER_SLACK_MS.
+    crinitTimerStore_t lastRuns;  ///< Last expirations of calendar timers, only kept if TIMER_STATE_FILE is set.
+    crinitTimerDBStats_t stats;   ///< Counters of the timer thread.
     crinitTaskDB_t *taskDB;
     pthread_t timerThread;
-    pthread_mutex_t lock;  ///< Mutex to lock the TimerDB, shall be used for any operations on the data structure if
+    pthread_mutex_t lock;  ///< Mutex to lock the TimerDB, shall be used for any operations on the data structure.
 } crinitTimerDB_t;
 
 /**
  * Initialize the timer db handling all of crinit's timers.
  *
+ * Interval timers (`@timer:every:<period>`) are kept on `CLOCK_BOOTTIME` and are rescheduled by adding up their
+ * period, so they are neither affected by changes of the system time nor by the slack below. They are passed to the
+ * TaskDB in the same batch as the calendar timers expiring at the same time. `@timer:after:<period>` timers are not
+ * shared, see crinitTimerDBArmTaskTimer().
+ *
+ * Reads the TIMER_SLACK_MS global option. If it is set, the timer thread only wakes up on multiples of the slack
+ * (counted from the Unix epoch) to handle calendar timers, so all calendar timers expiring within the same window are
+ * handled with a single wakeup and passed to the TaskDB using a single call to crinitTaskDBFulfillDeps().
+ *
+ * The calendar timers are armed to be cancelled if the system time is set. The timer thread then calls
+ * crinitTimerDBClockSet().
+ *
+ * Reads the TIMER_STATE_FILE global option. If it is set, the last expiration of every calendar timer is loaded from
+ * that file here. The timer thread writes the file once all timers expired at a wakeup have been handled, without
+ * holding the TimerDB lock. A timer added later on (i.e. after a reboot or when a task
+ * re-arms its `@timer` dependency) which has missed an expiration since then expires once right away.
+ *
  * @param taskDB  the task db to initialize the timerdb for
  *
  * @return 0 on success, -1 on error
@@ -46,14 +97,89 @@ int crinitTimerDBSpawn(void);
 /**
  * Adds a timer to crinits timerDB.
  *
+ * Timers are reference counted. A spelling already in the TimerDB is looked up in O(1) without parsing it. A new
+ * spelling which parses to the same definition as an existing timer (e.g. `daily` and `*-*-*-00:00:00`) shares that
+ * timer, it then fulfills the dependencies of all spellings when it expires.
+ *
  * @param timerStr  the configuration string/name for the timer
  */
 void crinitTimerDBAddTimer(char *timerStr);
 /**
  * Removes a timer from crinits timerDB.
  *
+ * Drops a reference added by crinitTimerDBAddTimer() in O(log n), the timer is removed with the last one.
+ *
  * @param timerStr  the configuration string/name for the timer
  */
 void crinitTimerDBRemoveTimer(char *timerStr);
 
+/**
+ * Adds a one-shot timer ending the respawn backoff of a task.
+ *
+ * After \a delayMs milliseconds, crinitTaskDBReleaseRespawn() is called for the task and the timer is removed. The
+ * timer uses `CLOCK_MONOTONIC` and is therefore not affected by changes of the system time.
+ *
+ * The timer thread releases the TimerDB lock before calling into the TaskDB, so this may be called while holding
+ * crinitTaskDB_t::lock.
+ *
+ * @param taskName  The name of the task whose respawn is held back.
+ * @param delayMs   The delay in milliseconds.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerDBAddRespawnTimer(const char *taskName, uint32_t delayMs);
+/**
+ * Check if an `@timer` dependency is armed per task using crinitTimerDBArmTaskTimer() instead of being shared using
+ * crinitTimerDBAddTimer().
+ *
+ * @param timerStr  The spelling of the timer, i.e. the event of the `@timer` dependency.
+ *
+ * @return true for an `after:<period>` timer, false otherwise
+ */
+bool crinitTimerDBIsTaskTimer(const char *timerStr);
+/**
+ * Arms the `@timer:after:<period>` dependency of a task.
+ *
+ * The timer expires \a timerStr's period from now on `CLOCK_BOOTTIME`. It then fulfills the dependency of this task
+ * only, using crinitTaskDBRemoveDepFromTask(), and is removed. If the timer of this task and spelling is already
+ * armed, its deadline is reset instead, so the period always counts from the latest call.
+ *
+ * The timer thread releases the TimerDB lock before calling into the TaskDB, so this may be called while holding
+ * crinitTaskDB_t::lock.
+ *
+ * @param taskName  The name of the task.
+ * @param timerStr  The spelling of the timer, see crinitTimerDBIsTaskTimer().
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerDBArmTaskTimer(const char *taskName, const char *timerStr);
+/**
+ * Disarms a timer armed using crinitTimerDBArmTaskTimer(), does nothing if it is not armed.
+ *
+ * @param taskName  The name of the task.
+ * @param timerStr  The spelling of the timer.
+ */
+void crinitTimerDBDisarmTaskTimer(const char *taskName, const char *timerStr);
+/**
+ * Recompute the next expiration of all calendar timers in one pass after the system time has been set.
+ *
+ * A timer expires once right away, together with all others, only if it has really missed an expiration: One which
+ * was due within the time that has passed on `CLOCK_BOOTTIME` since the timer last expired or has been added. For a
+ * timer whose last expiration in the state file was ahead of the system time when it was added, the missed expiration
+ * is checked from that last expiration instead. All other timers are rescheduled relative to \a now, so setting the
+ * time forward (e.g. on a system without RTC) does not let every timer expire at once.
+ *
+ * @param now      The new system time.
+ * @param bootNow  The current time on `CLOCK_BOOTTIME`.
+ */
+void crinitTimerDBClockSet(const struct timespec *now, const struct timespec *bootNow);
+/**
+ * Get the counters of the TimerDB.
+ *
+ * @param stats  Return pointer for the counters.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerDBGetStats(crinitTimerDBStats_t *stats);
+
 #endif /* __TIMER_DB_H__ */
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file timerheap.h
+ * @brief Header related to a priority queue of timers ordered by their next expiration.
+ */
+#ifndef __TIMER_HEAP_H__
+#define __TIMER_HEAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "timer.h"
+
+/** Value returned by crinitTimerHeapFind() if no matching timer is found. **/
+#define CRINIT_TIMER_HEAP_NOT_FOUND SIZE_MAX
+
+/**
+ * A binary min-heap of timers, ordered by the `it_value` of crinitTimer_t::next.
+ *
+ * The timer expiring first is always at index 0. Insertion and removal take O(log n). If crinitTimer_t::entry is set,
+ * crinitTimerEntry_t::heapIdx always holds the current index of the timer, so it can be removed without searching.
+ */
+typedef struct crinitTimerHeap {
+    crinitTimer_t *timers;  ///< Dynamic array holding the heap.
+    size_t size;            ///< Number of timers in the heap.
+    size_t cap;             ///< Number of timers crinitTimerHeap_t::timers has space for.
+} crinitTimerHeap_t;
+
+/**
+ * Initialize an empty timer heap.
+ *
+ * @param h           The heap to initialize.
+ * @param initialCap  Number of timers to allocate space for, the heap grows as needed.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerHeapInit(crinitTimerHeap_t *h, size_t initialCap);
+/**
+ * Free all memory associated with a timer heap, including crinitTimer_t::name of all contained timers.
+ *
+ * @param h  The heap to destroy, may be NULL.
+ */
+void crinitTimerHeapDestroy(crinitTimerHeap_t *h);
+/**
+ * Insert a timer into the heap.
+ *
+ * The heap takes ownership of crinitTimer_t::name.
+ *
+ * @param h  The heap to insert into.
+ * @param t  The timer to insert, crinitTimer_t::next needs to be set.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerHeapPush(crinitTimerHeap_t *h, const crinitTimer_t *t);
+/**
+ * Remove a timer from the heap.
+ *
+ * Ownership of crinitTimer_t::name passes to the caller.
+ *
+ * @param h    The heap to remove from.
+ * @param idx  Index of the timer to remove, 0 for the one expiring first.
+ * @param out  Return pointer for the removed timer.
+ *
+ * @return 0 on success, -1 if \a idx is out of range
+ */
+int crinitTimerHeapRemove(crinitTimerHeap_t *h, size_t idx, crinitTimer_t *out);
+/**
+ * Restore the heap order after crinitTimer_t::next of a timer has been changed.
+ *
+ * @param h    The heap containing the timer.
+ * @param idx  Index of the changed timer.
+ */
+void crinitTimerHeapUpdate(crinitTimerHeap_t *h, size_t idx);
+/**
+ * Restore the heap order after crinitTimer_t::next of any number of timers has been changed.
+ *
+ * Takes O(n), cheaper than calling crinitTimerHeapUpdate() for every timer if most of them have changed.
+ *
+ * @param h  The heap to reorder, may be NULL.
+ */
+void crinitTimerHeapRebuild(crinitTimerHeap_t *h);
+/**
+ * Find a timer by name.
+ *
+ * Takes O(n).
+ *
+ * @param h     The heap to search.
+ * @param name  The name to search for.
+ *
+ * @return the index of the timer or #CRINIT_TIMER_HEAP_NOT_FOUND
+ */
+size_t crinitTimerHeapFind(const crinitTimerHeap_t *h, const char *name);
+
+#endif /* __TIMER_HEAP_H__ */
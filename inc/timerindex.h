@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file timerindex.h
+ * @brief Header related to the hash index of the timers fulfilling `@timer` dependencies.
+ */
+#ifndef __TIMER_INDEX_H__
+#define __TIMER_INDEX_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "timer.h"
+
+/** Value of crinitTimerEntry_t::heapIdx if the timer is in no heap. **/
+#define CRINIT_TIMER_INDEX_NO_HEAP SIZE_MAX
+
+/**
+ * A spelling of a timer as used in the `@timer:<name>` dependencies of tasks.
+ */
+typedef struct crinitTimerAlias {
+    char *name;                            ///< The spelling of the timer.
+    size_t refs;                           ///< Number of dependencies using this spelling.
+    struct crinitTimerEntry *entry;        ///< The timer this is a spelling of.
+    struct crinitTimerAlias *next;         ///< Next alias in the same bucket of crinitTimerIndex_t::names.
+    struct crinitTimerAlias *nextOfEntry;  ///< Next alias of crinitTimerAlias_t::entry.
+} crinitTimerAlias_t;
+
+/**
+ * A single timer, shared by all spellings of the same parsed timer definition.
+ */
+typedef struct crinitTimerEntry {
+    crinitTimerDef_t def;           ///< The parsed timer definition, key of crinitTimerIndex_t::entries.
+    size_t refs;                    ///< Number of dependencies using this timer, the sum of all aliases.
+    size_t heapIdx;                 ///< Index of the timer in its heap, kept up to date by the heap.
+    crinitTimerAlias_t *aliases;    ///< List of all spellings of this timer.
+    struct crinitTimerEntry *next;  ///< Next entry in the same bucket of crinitTimerIndex_t::entries.
+} crinitTimerEntry_t;
+
+/**
+ * Hash index of timers by their spelling and by their parsed definition.
+ *
+ * Looking up a known spelling takes O(1) without parsing it. Spellings which parse to the same definition (e.g.
+ * `daily` and `*-*-*-00:00:00`) share one crinitTimerEntry_t and with it one timer.
+ */
+typedef struct crinitTimerIndex {
+    crinitTimerAlias_t **names;    ///< Buckets of aliases, hashed by crinitTimerAlias_t::name.
+    size_t nameBuckets;            ///< Number of buckets in crinitTimerIndex_t::names.
+    size_t nameCount;              ///< Number of aliases in the index.
+    crinitTimerEntry_t **entries;  ///< Buckets of entries, hashed by crinitTimerEntry_t::def.
+    size_t entryBuckets;           ///< Number of buckets in crinitTimerIndex_t::entries.
+    size_t entryCount;             ///< Number of entries in the index.
+} crinitTimerIndex_t;
+
+/**
+ * Initialize an empty timer index.
+ *
+ * @param idx             The index to initialize.
+ * @param initialBuckets  Number of buckets to allocate for each table, the index grows as needed.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerIndexInit(crinitTimerIndex_t *idx, size_t initialBuckets);
+/**
+ * Free all memory associated with a timer index, including all entries and aliases.
+ *
+ * @param idx  The index to destroy, may be NULL.
+ */
+void crinitTimerIndexDestroy(crinitTimerIndex_t *idx);
+/**
+ * Add a reference to a timer by a spelling already in the index.
+ *
+ * @param idx   The index.
+ * @param name  The spelling of the timer.
+ *
+ * @return the timer if \a name is known, NULL otherwise
+ */
+crinitTimerEntry_t *crinitTimerIndexRef(crinitTimerIndex_t *idx, const char *name);
+/**
+ * Add a reference to a timer by a new spelling and its parsed definition.
+ *
+ * If a timer with the same definition exists, \a name becomes another spelling of it. Otherwise a new entry is created
+ * with crinitTimerEntry_t::heapIdx set to #CRINIT_TIMER_INDEX_NO_HEAP, the caller needs to add its timer.
+ *
+ * @param idx      The index.
+ * @param name     The spelling of the timer, will be copied if not yet in the index.
+ * @param def      The parsed timer definition of \a name.
+ * @param created  Return pointer, set to true if a new entry has been created.
+ *
+ * @return the timer on success, NULL on error
+ */
+crinitTimerEntry_t *crinitTimerIndexRefDef(crinitTimerIndex_t *idx, const char *name, const crinitTimerDef_t *def,
+                                           bool *created);
+/**
+ * Drop a reference to a timer by its spelling.
+ *
+ * A spelling without references is removed from the index. An entry without references stays in the index and needs
+ * to be removed using crinitTimerIndexRemove() after its timer has been removed.
+ *
+ * @param idx   The index.
+ * @param name  The spelling of the timer.
+ *
+ * @return the timer if \a name is known, NULL otherwise
+ */
+crinitTimerEntry_t *crinitTimerIndexUnref(crinitTimerIndex_t *idx, const char *name);
+/**
+ * Remove a timer and all of its spellings from the index and free it.
+ *
+ * @param idx    The index.
+ * @param entry  The timer to remove.
+ */
+void crinitTimerIndexRemove(crinitTimerIndex_t *idx, crinitTimerEntry_t *entry);
+
+#endif /* __TIMER_INDEX_H__ */
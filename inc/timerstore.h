@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file timerstore.h
+ * @brief Header related to the persistent store of the last expirations of calendar timers.
+ */
+#ifndef __TIMER_STORE_H__
+#define __TIMER_STORE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+/**
+ * The last expiration of a single calendar timer.
+ */
+typedef struct crinitTimerRun {
+    char *name;      ///< The name (definition string) of the timer.
+    time_t lastRun;  ///< Time of the last expiration in seconds since the epoch.
+} crinitTimerRun_t;
+
+/**
+ * Store of the last expirations of calendar timers, kept in memory and persisted to a file.
+ *
+ * The file contains one line per timer of the form `<lastRun> <name>`. It is replaced atomically on every save. As
+ * saving involves disk I/O, a user holding a lock on the store should save a copy after releasing the lock, see
+ * crinitTimerStoreCopy().
+ */
+typedef struct crinitTimerStore {
+    crinitTimerRun_t *runs;  ///< The last expirations, sorted by name.
+    size_t size;             ///< Number of elements in crinitTimerStore_t::runs.
+    size_t cap;              ///< Number of elements crinitTimerStore_t::runs has space for.
+    char *path;              ///< Path of the file the store is persisted to.
+    bool dirty;              ///< True if the store has changed since it was last loaded or saved.
+} crinitTimerStore_t;
+
+/**
+ * Initialize an empty timer store.
+ *
+ * @param s     The store to initialize.
+ * @param path  Absolute path of the file to persist the store to.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerStoreInit(crinitTimerStore_t *s, const char *path);
+/**
+ * Free all memory associated with a timer store. The file is left as is.
+ *
+ * @param s  The store to destroy, may be NULL.
+ */
+void crinitTimerStoreDestroy(crinitTimerStore_t *s);
+/**
+ * Load the last expirations from the file of the store.
+ *
+ * A missing file is not an error, the store just stays empty. Malformed lines are skipped.
+ *
+ * @param s  The store to load into.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerStoreLoad(crinitTimerStore_t *s);
+/**
+ * Copy a timer store including its path and crinitTimerStore_t::dirty.
+ *
+ * @param out  The store to initialize as a copy, must be freed using crinitTimerStoreDestroy().
+ * @param s    The store to copy.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerStoreCopy(crinitTimerStore_t *out, const crinitTimerStore_t *s);
+/**
+ * Write the last expirations to the file of the store if something has changed.
+ *
+ * Writes to a temporary file first, syncs it to disk and renames it, so the file is either in the old or in the new
+ * state even after a crash. The directory is synced afterwards to persist the rename.
+ *
+ * @param s  The store to save.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerStoreSave(crinitTimerStore_t *s);
+/**
+ * Get the last expiration of a timer.
+ *
+ * @param s     The store.
+ * @param name  The name of the timer.
+ *
+ * @return the time of the last expiration, 0 if unknown
+ */
+time_t crinitTimerStoreGet(const crinitTimerStore_t *s, const char *name);
+/**
+ * Set the last expiration of a timer.
+ *
+ * @param s        The store.
+ * @param name     The name of the timer, will be copied if not yet in the store.
+ * @param lastRun  The time of the expiration.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitTimerStoreSet(crinitTimerStore_t *s, const char *name, time_t lastRun);
+
+#endif /* __TIMER_STORE_H__ */
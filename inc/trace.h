@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file trace.h
+ * @brief Header related to the in-memory boot trace.
+ *
+ * Crinit records timestamped events about configuration loading, task life cycles, dependencies, and lock contention
+ * into a fixed-size ring buffer of binary records. The oldest records are overwritten once the buffer is full. The
+ * buffer can be read out through the TRACE runtime command, see crinitClientGetBootTrace() and `crinit-ctl trace`.
+ *
+ * For the meaning of the name and argument of each event type, see crinitTraceEventType_t in crinit-sdefs.h.
+ */
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "crinit-sdefs.h"
+
+/** Number of records in the trace ring buffer. **/
+#define CRINIT_TRACE_RECORDS 4096
+/** Size of the name buffer in a trace record including the terminating zero, longer names are truncated. **/
+#define CRINIT_TRACE_NAME_MAX 32
+
+/**
+ * A single binary record in the trace ring buffer.
+ */
+typedef struct crinitTraceRecord {
+    uint64_t ts;                       ///< `CLOCK_MONOTONIC` timestamp of the (start of the) event in nanoseconds.
+    uint64_t dur;                      ///< Duration of the event in nanoseconds, 0 for instant events.
+    int64_t arg;                       ///< Event-specific argument, see crinitTraceEventType_t.
+    pid_t tid;                         ///< Thread ID of the thread which recorded the event.
+    uint32_t type;                     ///< The crinitTraceEventType_t of the event.
+    char name[CRINIT_TRACE_NAME_MAX];  ///< Event-specific name, see crinitTraceEventType_t.
+} crinitTraceRecord_t;
+
+/**
+ * Get the current `CLOCK_MONOTONIC` time in nanoseconds, for use as the start time of crinitTraceSpan().
+ *
+ * @return  The current time in nanoseconds.
+ */
+uint64_t crinitTraceNow(void);
+/**
+ * Record an instant event in the trace ring buffer.
+ *
+ * Thread-safe. Newline characters in the name are replaced by spaces.
+ *
+ * @param type    The type of the event.
+ * @param arg     The event-specific argument.
+ * @param format  printf-style format string for the name of the event.
+ * @param ...     Arguments to \a format.
+ */
+void crinitTraceInstant(crinitTraceEventType_t type, int64_t arg, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+/**
+ * Record an event with a duration in the trace ring buffer.
+ *
+ * The event lasts from \a start until the time of the call. Thread-safe. Newline characters in the name are replaced by
+ * spaces.
+ *
+ * @param type    The type of the event.
+ * @param start   Start time of the event as returned by crinitTraceNow().
+ * @param arg     The event-specific argument.
+ * @param format  printf-style format string for the name of the event.
+ * @param ...     Arguments to \a format.
+ */
+void crinitTraceSpan(crinitTraceEventType_t type, uint64_t start, int64_t arg, const char *format, ...)
+    __attribute__((format(printf, 4, 5)));
+/**
+ * Copy records out of the trace ring buffer.
+ *
+ * Every record gets a sequence number, starting at 0 for the first record after startup. The function copies up to
+ * \a max records, beginning at the sequence number given in \a seq, and advances \a seq past the last copied record. If
+ * records starting at \a seq have already been overwritten, copying starts at the oldest record still available and
+ * the number of skipped records is returned in \a dropped.
+ *
+ * @param out      Array for at least \a max records.
+ * @param max      Maximum number of records to copy.
+ * @param seq      Sequence number of the first record to copy, will be set to the sequence number of the next record.
+ * @param dropped  Return pointer for the number of overwritten records which were skipped.
+ *
+ * @return  The number of copied records.
+ */
+size_t crinitTraceRead(crinitTraceRecord_t *out, size_t max, uint64_t *seq, uint64_t *dropped);
+/**
+ * Lock a mutex and record a CRINIT_TRACE_LOCK_WAIT event if the mutex was contended.
+ *
+ * Can be used as a drop-in replacement for pthread_mutex_lock(). An uncontended lock costs only an additional
+ * pthread_mutex_trylock().
+ *
+ * @param mutex     The mutex to lock.
+ * @param lockName  The name of the lock to use as the name of the event.
+ *
+ * @return  0 on success, an error number as returned by pthread_mutex_lock() otherwise
+ */
+int crinitTraceMutexLock(pthread_mutex_t *mutex, const char *lockName);
+
+#endif /* __TRACE_H__ */
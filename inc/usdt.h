@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file usdt.h
+ * @brief Static tracepoints (USDT probes) for external tracers.
+ *
+ * If the `ENABLE_USDT` build option is on and `sys/sdt.h` from SystemTap is found, the build defines `ENABLE_USDT` and
+ * the probes below are compiled into the binary as SystemTap/DTrace-style static tracepoints of the provider `crinit`.
+ * Each probe is a single `nop` instruction until a tracer such as bpftrace or perf attaches to it, so they can stay in
+ * production builds. Otherwise the probes are compiled out completely and their arguments are not evaluated.
+ *
+ * Available probes and their arguments:
+ *
+ * | Probe         | Arguments                                                                                   |
+ * |---------------|---------------------------------------------------------------------------------------------|
+ * | `task_ready`  | task name, 1 if the task is being stopped, 0 if started                                     |
+ * | `spawn_begin` | task name, command index, TID of the dispatch thread                                        |
+ * | `spawn_end`   | task name, command index, PID of the new process or -1, 0 on success or -1                  |
+ * | `reap`        | PID of the reaped process, wait status as returned by wait4()                               |
+ * | `task_state`  | task name, new crinitTaskState_t, previous crinitTaskState_t                                |
+ * | `dep_fulfill` | dependency name, dependency event, name of the only task to fulfill it for or NULL for all  |
+ * | `ipc_begin`   | crinitRtimOp_t of the request, PID of the client, first argument of the request or ""       |
+ * | `ipc_end`     | crinitRtimOp_t of the request, PID of the client, time to handle the request in nanoseconds |
+ * | `timer_fire`  | timer name (the task name for respawn and after timers), crinitTimerType_t                  |
+ * | `elos_event`  | name of the task waiting for the event, filter name, number of events read from the queue   |
+ */
+#ifndef __USDT_H__
+#define __USDT_H__
+
+#ifdef ENABLE_USDT
+
+#include <sys/sdt.h>
+
+/** Static tracepoint of the `crinit` provider without arguments. **/
+#define crinitProbe0(name) STAP_PROBE(crinit, name)
+/** Static tracepoint of the `crinit` provider with one argument. **/
+#define crinitProbe1(name, a1) STAP_PROBE1(crinit, name, a1)
+/** Static tracepoint of the `crinit` provider with two arguments. **/
+#define crinitProbe2(name, a1, a2) STAP_PROBE2(crinit, name, a1, a2)
+/** Static tracepoint of the `crinit` provider with three arguments. **/
+#define crinitProbe3(name, a1, a2, a3) STAP_PROBE3(crinit, name, a1, a2, a3)
+/** Static tracepoint of the `crinit` provider with four arguments. **/
+#define crinitProbe4(name, a1, a2, a3, a4) STAP_PROBE4(crinit, name, a1, a2, a3, a4)
+
+#else
+
+/*
+ * The arguments are only referenced through sizeof, so they are not evaluated but variables used solely as probe
+ * arguments do not cause unused variable warnings.
+ */
+/** Compiled-out probe without arguments. **/
+#define crinitProbe0(name) ((void)0)
+/** Compiled-out probe with one argument. **/
+#define crinitProbe1(name, a1) ((void)sizeof(a1))
+/** Compiled-out probe with two arguments. **/
+#define crinitProbe2(name, a1, a2) ((void)sizeof(a1), (void)sizeof(a2))
+/** Compiled-out probe with three arguments. **/
+#define crinitProbe3(name, a1, a2, a3) ((void)sizeof(a1), (void)sizeof(a2), (void)sizeof(a3))
+/** Compiled-out probe with four arguments. **/
+#define crinitProbe4(name, a1, a2, a3, a4) ((void)sizeof(a1), (void)sizeof(a2), (void)sizeof(a3), (void)sizeof(a4))
+
+#endif
+
+#endif /* __USDT_H__ */
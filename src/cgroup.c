@@ -8,6 +8,8 @@
 
 #include "cgroup.h"
 
+#include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -356,6 +358,59 @@ int crinitCGroupAssignPID(crinitCgroup_t *cgroup, pid_t pid) {
     return result;
 }
 
+int crinitCGroupSignal(crinitCgroup_t *cgroup, int sig) {
+    int result = -1;
+    crinitNullCheck(result, cgroup);
+    crinitNullCheck(result, cgroup->name);
+
+    if (crinitCgroupOpen(cgroup, false) == -1) {
+        crinitErrPrint("Could not open cgroup.");
+        return result;
+    }
+
+    if (sig == SIGKILL) {
+        int killFd = openat(cgroup->groupFd, "cgroup.kill", O_WRONLY | O_CLOEXEC);
+        if (killFd >= 0) {
+            if (write(killFd, "1", 1) == 1) {
+                result = 0;
+            } else {
+                crinitErrnoPrint("Could not kill cgroup %s.", cgroup->name);
+            }
+            close(killFd);
+            crinitCgroupClose(cgroup);
+            return result;
+        }
+        if (errno != ENOENT) {
+            crinitErrnoPrint("Could not open cgroup.kill of cgroup %s.", cgroup->name);
+        }
+    }
+
+    int procsFd = openat(cgroup->groupFd, "cgroup.procs", O_RDONLY | O_CLOEXEC);
+    FILE *procs = (procsFd >= 0) ? fdopen(procsFd, "r") : NULL;
+    if (procs == NULL) {
+        crinitErrnoPrint("Could not open cgroup.procs of cgroup %s.", cgroup->name);
+        if (procsFd >= 0) {
+            close(procsFd);
+        }
+        crinitCgroupClose(cgroup);
+        return result;
+    }
+
+    result = 0;
+    int pid = 0;
+    while (fscanf(procs, "%d", &pid) == 1) {
+        // The process may have exited since cgroup.procs was read.
+        if (kill((pid_t)pid, sig) == -1 && errno != ESRCH) {
+            crinitErrnoPrint("Could not send signal %d to process %d in cgroup %s.", sig, pid, cgroup->name);
+            result = -1;
+        }
+    }
+    fclose(procs);
+    crinitCgroupClose(cgroup);
+
+    return result;
+}
+
 /** Read buffer size to read controllers.
  *
  *  Should be sufficent for most cases to read all available controllers in one go.
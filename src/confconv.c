@@ -3,17 +3,55 @@
  * @file confconv.c
  * @brief Implementations of conversion operations from configuration values to structured data.
  */
-
+#define _GNU_SOURCE  ///< Needed for SCHED_BATCH and SCHED_IDLE.
 #include "confconv.h"
 
 #include <fcntl.h>
+#include <sched.h>
 #include <stdlib.h>
+#include <strings.h>
 #include <unistd.h>
 
 #include "common.h"
 #include "lexers.h"
 #include "logio.h"
 
+/** Mapping between the name of a resource limit in a configuration and its `RLIMIT_*` value. **/
+typedef struct crinitRlimitName {
+    const char *name;  ///< Name of the resource without the `RLIMIT_` prefix.
+    int resource;      ///< The resource as used by setrlimit().
+} crinitRlimitName_t;
+
+/** All resource limits which can be set in a configuration. **/
+static const crinitRlimitName_t crinitRlimitNames[] = {
+    {"AS", RLIMIT_AS},
+    {"CORE", RLIMIT_CORE},
+    {"CPU", RLIMIT_CPU},
+    {"DATA", RLIMIT_DATA},
+    {"FSIZE", RLIMIT_FSIZE},
+    {"LOCKS", RLIMIT_LOCKS},
+    {"MEMLOCK", RLIMIT_MEMLOCK},
+    {"MSGQUEUE", RLIMIT_MSGQUEUE},
+    {"NICE", RLIMIT_NICE},
+    {"NOFILE", RLIMIT_NOFILE},
+    {"NPROC", RLIMIT_NPROC},
+    {"RSS", RLIMIT_RSS},
+    {"RTPRIO", RLIMIT_RTPRIO},
+    {"RTTIME", RLIMIT_RTTIME},
+    {"SIGPENDING", RLIMIT_SIGPENDING},
+    {"STACK", RLIMIT_STACK},
+};
+
+/**
+ * Converts a single resource limit value which may be `INFINITY`.
+ *
+ * @param lim      Output pointer for the limit.
+ * @param confVal  The string to convert.
+ *
+ * @return  0 on success, -1 on error.
+ */
+static int crinitConfConvToRlimVal(rlim_t *lim, const char *confVal);
+
 /**
  * Copies a string while resolving all contained escape sequences.
  *
@@ -463,6 +501,181 @@ int crinitConfConvToEnvSetMember(crinitEnvSet_t *es, const char *confVal) {
     return 0;
 }
 
+int crinitConfConvToCpuSet(crinitProcAttr_t *pa, const char *confVal) {
+    crinitNullCheck(-1, pa, confVal);
+
+    int numElements = 0;
+    char **elements = crinitConfConvToStrArr(&numElements, confVal, false);
+    if (elements == NULL) {
+        crinitErrPrint("Could not extract CPU list from '%s'.", confVal);
+        return -1;
+    }
+
+    memset(pa->cpus, 0, sizeof(pa->cpus));
+    bool empty = true;
+    for (int i = 0; i < numElements; i++) {
+        char *rest = NULL;
+        for (char *tok = strtok_r(elements[i], ",", &rest); tok != NULL; tok = strtok_r(NULL, ",", &rest)) {
+            unsigned long long first, last;
+            char *endptr = NULL;
+            errno = 0;
+            first = strtoull(tok, &endptr, 10);
+            last = first;
+            if (errno == 0 && endptr != tok && *endptr == '-') {
+                char *lastStr = endptr + 1;
+                last = strtoull(lastStr, &endptr, 10);
+                if (endptr == lastStr) {
+                    errno = EINVAL;
+                }
+            }
+            if (errno != 0 || endptr == tok || *endptr != '\0' || first > last ||
+                last >= CRINIT_PROC_ATTR_MAX_CPUS) {
+                crinitErrPrint("Invalid CPU number or range '%s' in '%s'.", tok, confVal);
+                crinitFreeArgvArray(elements);
+                return -1;
+            }
+            for (unsigned long long cpu = first; cpu <= last; cpu++) {
+                crinitProcAttrCpuSet(pa, cpu);
+                empty = false;
+            }
+        }
+    }
+    crinitFreeArgvArray(elements);
+
+    if (empty) {
+        crinitErrPrint("The CPU list '%s' does not contain any CPUs.", confVal);
+        return -1;
+    }
+    return 0;
+}
+
+int crinitConfConvToSchedPolicy(int *policy, const char *confVal) {
+    crinitNullCheck(-1, policy, confVal);
+    if (strcasecmp(confVal, "OTHER") == 0) {
+        *policy = SCHED_OTHER;
+    } else if (strcasecmp(confVal, "BATCH") == 0) {
+        *policy = SCHED_BATCH;
+    } else if (strcasecmp(confVal, "IDLE") == 0) {
+        *policy = SCHED_IDLE;
+    } else if (strcasecmp(confVal, "FIFO") == 0) {
+        *policy = SCHED_FIFO;
+    } else if (strcasecmp(confVal, "RR") == 0) {
+        *policy = SCHED_RR;
+    } else {
+        crinitErrPrint("Unknown scheduling policy '%s'.", confVal);
+        return -1;
+    }
+    return 0;
+}
+
+int crinitConfConvToIoPrio(int *ioprio, const char *confVal) {
+    crinitNullCheck(-1, ioprio, confVal);
+
+    int numParams = 0;
+    char **params = crinitConfConvToStrArr(&numParams, confVal, false);
+    if (params == NULL) {
+        crinitErrPrint("Could not extract I/O priority parameters from '%s'.", confVal);
+        return -1;
+    }
+
+    int ioClass;
+    int level = CRINIT_IOPRIO_LEVEL_DEFAULT;
+    if (numParams < 1 || numParams > 2) {
+        crinitErrPrint("The I/O priority statement must have one or two parameters.");
+        goto fail;
+    }
+    if (strcasecmp(params[0], "REALTIME") == 0) {
+        ioClass = CRINIT_IOPRIO_CLASS_RT;
+    } else if (strcasecmp(params[0], "BEST_EFFORT") == 0) {
+        ioClass = CRINIT_IOPRIO_CLASS_BE;
+    } else if (strcasecmp(params[0], "IDLE") == 0) {
+        ioClass = CRINIT_IOPRIO_CLASS_IDLE;
+        level = 0;
+        if (numParams > 1) {
+            crinitErrPrint("The IDLE I/O scheduling class does not take a priority level.");
+            goto fail;
+        }
+    } else {
+        crinitErrPrint("Unknown I/O scheduling class '%s'.", params[0]);
+        goto fail;
+    }
+    if (numParams > 1) {
+        if (crinitConfConvToInteger(&level, params[1], 10) == -1 || level < 0 || level > CRINIT_IOPRIO_LEVEL_MAX) {
+            crinitErrPrint("The I/O priority level must be a number from 0 to %d.", CRINIT_IOPRIO_LEVEL_MAX);
+            goto fail;
+        }
+    }
+
+    crinitFreeArgvArray(params);
+    *ioprio = CRINIT_IOPRIO_VALUE(ioClass, level);
+    return 0;
+
+fail:
+    crinitFreeArgvArray(params);
+    return -1;
+}
+
+int crinitConfConvToRlimit(int *resource, struct rlimit *rlim, const char *confVal) {
+    crinitNullCheck(-1, resource, rlim, confVal);
+
+    int numParams = 0;
+    char **params = crinitConfConvToStrArr(&numParams, confVal, false);
+    if (params == NULL) {
+        crinitErrPrint("Could not extract resource limit parameters from '%s'.", confVal);
+        return -1;
+    }
+    if (numParams < 2 || numParams > 3) {
+        crinitErrPrint("The resource limit statement must have two or three parameters.");
+        goto fail;
+    }
+
+    const crinitRlimitName_t *rn = NULL;
+    for (size_t i = 0; i < crinitNumElements(crinitRlimitNames); i++) {
+        if (strcasecmp(params[0], crinitRlimitNames[i].name) == 0) {
+            rn = &crinitRlimitNames[i];
+            break;
+        }
+    }
+    if (rn == NULL) {
+        crinitErrPrint("Unknown resource '%s' in resource limit statement.", params[0]);
+        goto fail;
+    }
+
+    if (crinitConfConvToRlimVal(&rlim->rlim_cur, params[1]) == -1) {
+        goto fail;
+    }
+    rlim->rlim_max = rlim->rlim_cur;
+    if (numParams > 2 && crinitConfConvToRlimVal(&rlim->rlim_max, params[2]) == -1) {
+        goto fail;
+    }
+    if (rlim->rlim_cur > rlim->rlim_max) {
+        crinitErrPrint("The soft limit of resource '%s' must not be larger than the hard limit.", rn->name);
+        goto fail;
+    }
+
+    crinitFreeArgvArray(params);
+    *resource = rn->resource;
+    return 0;
+
+fail:
+    crinitFreeArgvArray(params);
+    return -1;
+}
+
+static int crinitConfConvToRlimVal(rlim_t *lim, const char *confVal) {
+    if (strcasecmp(confVal, "INFINITY") == 0) {
+        *lim = RLIM_INFINITY;
+        return 0;
+    }
+    unsigned long long val;
+    if (crinitConfConvToInteger(&val, confVal, 10) == -1 || *confVal == '-' || val >= RLIM_INFINITY) {
+        crinitErrPrint("Invalid resource limit '%s'.", confVal);
+        return -1;
+    }
+    *lim = (rlim_t)val;
+    return 0;
+}
+
 static char *crinitCopyEscaped(char *dst, const char *src, const char *end) {
     crinitNullCheck(NULL, dst, src, end);
     if (src > end) {
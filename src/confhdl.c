@@ -7,6 +7,7 @@
 
 #include <ctype.h>
 #include <grp.h>
+#include <inttypes.h>
 #include <pwd.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -69,6 +70,17 @@ static int crinitDepListHandler(crinitTaskDep_t **list, size_t *listSize, const
  * @return  0 on success, -1 on error
  */
 static inline int crinitCfgHandlerSetTaskOptFromStr(crinitTaskOpts_t *tgt, crinitTaskOpts_t opt, const char *val);
+
+/**
+ * Helper function to set a non-negative duration in milliseconds inside a crinitTask_t.
+ *
+ * @param tgt     Direct pointer to the member inside an crinitTask_t which shall be modified.
+ * @param val     The string value to convert, must be a decimal number between 0 and `UINT32_MAX`.
+ * @param keystr  The config key the value belongs to, used for error messages.
+ *
+ * @return  0 on success, -1 on error
+ */
+static int crinitCfgHandlerSetMillisFromStr(uint32_t *tgt, const char *val, const char *keystr);
 /**
  * (Re-)allocate memory for generic arrays.
  *
@@ -282,7 +294,8 @@ static int crinitDepListHandler(crinitTaskDep_t **list, size_t *listSize, const
             crinitFreeArgvArray(tempDeps);
             return -1;
         }
-        if (strcmp((*list)[i].name, "@timer") == 0) {
+        // Timers armed per task are armed once the task is in the TaskDB, see crinitTimerDBArmTaskTimer().
+        if (strcmp((*list)[i].name, "@timer") == 0 && !crinitTimerDBIsTaskTimer((*list)[i].event)) {
             crinitTimerDBAddTimer((*list)[i].event);
         }
 #ifndef ENABLE_ELOS
@@ -524,6 +537,34 @@ int crinitCfgRespRetHandler(void *tgt, const char *val, crinitConfigType_t type)
     return 0;
 }
 
+int crinitCfgRespDelayHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    return crinitCfgHandlerSetMillisFromStr(&t->respawnDelay, val, CRINIT_CONFIG_KEYSTR_RESPAWN_DELAY);
+}
+
+int crinitCfgRespDelayMaxHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    return crinitCfgHandlerSetMillisFromStr(&t->respawnDelayMax, val, CRINIT_CONFIG_KEYSTR_RESPAWN_DELAY_MAX);
+}
+
+int crinitCfgRespResetHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    return crinitCfgHandlerSetMillisFromStr(&t->respawnReset, val, CRINIT_CONFIG_KEYSTR_RESPAWN_RESET);
+}
+
+int crinitCfgStopTimeoutHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    return crinitCfgHandlerSetMillisFromStr(&t->stopTimeout, val, CRINIT_CONFIG_KEYSTR_STOP_TIMEOUT);
+}
+
 int crinitTaskIncludeHandler(void *tgt, const char *val, crinitConfigType_t type) {
     crinitNullCheck(-1, tgt, val);
     crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
@@ -681,6 +722,95 @@ failInit:
     return -1;
 }
 
+int crinitCfgCpuAffinityHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    if (crinitConfConvToCpuSet(&t->procAttr, val) == -1) {
+        crinitErrPrint("Could not parse value of option '%s'.", CRINIT_CONFIG_KEYSTR_CPU_AFFINITY);
+        return -1;
+    }
+    t->procAttr.flags |= CRINIT_PROC_ATTR_CPUS;
+    return 0;
+}
+
+int crinitCfgSchedPolicyHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    if (crinitConfConvToSchedPolicy(&t->procAttr.policy, val) == -1) {
+        crinitErrPrint("Could not parse value of option '%s'.", CRINIT_CONFIG_KEYSTR_SCHED_POLICY);
+        return -1;
+    }
+    t->procAttr.flags |= CRINIT_PROC_ATTR_POLICY;
+    return 0;
+}
+
+int crinitCfgSchedPrioHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    int prio;
+    if (crinitConfConvToInteger(&prio, val, 10) == -1) {
+        crinitErrPrint("Could not parse value of integral numeric option '%s'.", CRINIT_CONFIG_KEYSTR_SCHED_PRIORITY);
+        return -1;
+    }
+    if (prio < CRINIT_PROC_ATTR_PRIORITY_MIN || prio > CRINIT_PROC_ATTR_PRIORITY_MAX) {
+        crinitErrPrint("The value of '%s' must be between %d and %d.", CRINIT_CONFIG_KEYSTR_SCHED_PRIORITY,
+                       CRINIT_PROC_ATTR_PRIORITY_MIN, CRINIT_PROC_ATTR_PRIORITY_MAX);
+        return -1;
+    }
+    t->procAttr.priority = prio;
+    t->procAttr.flags |= CRINIT_PROC_ATTR_PRIORITY;
+    return 0;
+}
+
+int crinitCfgNiceHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    int nice;
+    if (crinitConfConvToInteger(&nice, val, 10) == -1) {
+        crinitErrPrint("Could not parse value of integral numeric option '%s'.", CRINIT_CONFIG_KEYSTR_NICE);
+        return -1;
+    }
+    if (nice < CRINIT_PROC_ATTR_NICE_MIN || nice > CRINIT_PROC_ATTR_NICE_MAX) {
+        crinitErrPrint("The value of '%s' must be between %d and %d.", CRINIT_CONFIG_KEYSTR_NICE,
+                       CRINIT_PROC_ATTR_NICE_MIN, CRINIT_PROC_ATTR_NICE_MAX);
+        return -1;
+    }
+    t->procAttr.nice = nice;
+    t->procAttr.flags |= CRINIT_PROC_ATTR_NICE;
+    return 0;
+}
+
+int crinitCfgIoPrioHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    if (crinitConfConvToIoPrio(&t->procAttr.ioprio, val) == -1) {
+        crinitErrPrint("Could not parse value of option '%s'.", CRINIT_CONFIG_KEYSTR_IOPRIO);
+        return -1;
+    }
+    t->procAttr.flags |= CRINIT_PROC_ATTR_IOPRIO;
+    return 0;
+}
+
+int crinitCfgRlimitHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    crinitNullCheck(-1, tgt, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_TASK);
+    crinitTask_t *t = tgt;
+    int resource;
+    struct rlimit rlim;
+    if (crinitConfConvToRlimit(&resource, &rlim, val) == -1) {
+        crinitErrPrint("Could not parse value of option '%s'.", CRINIT_CONFIG_KEYSTR_RLIMIT);
+        return -1;
+    }
+    t->procAttr.rlimits[resource] = rlim;
+    t->procAttr.rlimitsSet |= 1ul << resource;
+    return 0;
+}
+
 #ifdef ENABLE_CGROUP
 int crinitCfgCgroupNameHandler(void *tgt, const char *val, crinitConfigType_t type) {
     crinitNullCheck(-1, tgt, val);
@@ -1307,6 +1437,62 @@ int crinitCfgElosEventPollIntervalHandler(void *tgt, const char *val, crinitConf
     return 0;
 }
 
+int crinitCfgAsyncLogRecordsHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    CRINIT_PARAM_UNUSED(tgt);
+    crinitNullCheck(-1, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_SERIES);
+
+    unsigned long long records;
+    if (crinitConfConvToIntegerULL(&records, val, 10) == -1) {
+        crinitErrPrint("Could not parse value of integral numeric option '%s'.",
+                       CRINIT_CONFIG_KEYSTR_ASYNC_LOG_RECORDS);
+        return -1;
+    }
+    if (records > CRINIT_LOG_ASYNC_RECORDS_MAX) {
+        crinitErrPrint("Value of '%s' must not be larger than %d.", CRINIT_CONFIG_KEYSTR_ASYNC_LOG_RECORDS,
+                       CRINIT_LOG_ASYNC_RECORDS_MAX);
+        return -1;
+    }
+    if (crinitGlobOptSet(CRINIT_GLOBOPT_ASYNC_LOG_RECORDS, records) == -1) {
+        crinitErrPrint("Could not set global option '%s'.", CRINIT_CONFIG_KEYSTR_ASYNC_LOG_RECORDS);
+        return -1;
+    }
+    return 0;
+}
+
+int crinitCfgTimerSlackHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    CRINIT_PARAM_UNUSED(tgt);
+    crinitNullCheck(-1, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_SERIES);
+
+    unsigned long long slackMs;
+    if (crinitConfConvToIntegerULL(&slackMs, val, 10) == -1) {
+        crinitErrPrint("Could not parse value of integral numeric option '%s'.", CRINIT_CONFIG_KEYSTR_TIMER_SLACK);
+        return -1;
+    }
+    if (crinitGlobOptSet(CRINIT_GLOBOPT_TIMER_SLACK, slackMs) == -1) {
+        crinitErrPrint("Could not set global option '%s'.", CRINIT_CONFIG_KEYSTR_TIMER_SLACK);
+        return -1;
+    }
+    return 0;
+}
+
+int crinitCfgTimerStateFileHandler(void *tgt, const char *val, crinitConfigType_t type) {
+    CRINIT_PARAM_UNUSED(tgt);
+    crinitNullCheck(-1, val);
+    crinitCfgHandlerTypeCheck(CRINIT_CONFIG_TYPE_SERIES);
+
+    if (!crinitIsAbsPath(val)) {
+        crinitErrPrint("The value for '%s' must be an absolute path.", CRINIT_CONFIG_KEYSTR_TIMER_STATE_FILE);
+        return -1;
+    }
+    if (crinitGlobOptSet(CRINIT_GLOBOPT_TIMER_STATE_FILE, val) == -1) {
+        crinitErrPrint("Could not set global option '%s'.", CRINIT_CONFIG_KEYSTR_TIMER_STATE_FILE);
+        return -1;
+    }
+    return 0;
+}
+
 int crinitCfgLauncherCmdHandler(void *tgt, const char *val, crinitConfigType_t type) {
     CRINIT_PARAM_UNUSED(tgt);
     crinitNullCheck(-1, val);
@@ -1371,6 +1557,20 @@ static inline int crinitCfgHandlerSetTaskOptFromStr(crinitTaskOpts_t *tgt, crini
     return 0;
 }
 
+static int crinitCfgHandlerSetMillisFromStr(uint32_t *tgt, const char *val, const char *keystr) {
+    long long millis;
+    if (crinitConfConvToInteger(&millis, val, 10) == -1) {
+        crinitErrPrint("Could not parse value of integral numeric option '%s'.", keystr);
+        return -1;
+    }
+    if (millis < 0 || millis > UINT32_MAX) {
+        crinitErrPrint("The value of '%s' must be between 0 and %" PRIu32 ".", keystr, UINT32_MAX);
+        return -1;
+    }
+    *tgt = (uint32_t)millis;
+    return 0;
+}
+
 static inline void *crinitCfgHandlerManageArrayMem(void *dynArr, size_t elementSize, size_t curSize, size_t reqSize) {
     if (reqSize < curSize) {
         crinitErrPrint("Configuration value arrays can only be grown in size.");
@@ -20,23 +20,36 @@ const crinitConfigMapping_t crinitTaskCfgMap[] = {
     {CRINIT_CONFIG_CGROUP_PARAMS, CRINIT_CONFIG_KEYSTR_CGROUP_PARAMS, true, false, crinitCfgCgroupParamsHandler},
 #endif
     {CRINIT_CONFIG_COMMAND, CRINIT_CONFIG_KEYSTR_COMMAND, true, false, crinitCfgCmdHandler},
+    {CRINIT_CONFIG_CPU_AFFINITY, CRINIT_CONFIG_KEYSTR_CPU_AFFINITY, false, true, crinitCfgCpuAffinityHandler},
     {CRINIT_CONFIG_DEPENDS, CRINIT_CONFIG_KEYSTR_DEPENDS, true, true, crinitCfgDepHandler},
     {CRINIT_CONFIG_ENV_SET, CRINIT_CONFIG_KEYSTR_ENV_SET, true, true, crinitCfgEnvHandler},
     {CRINIT_CONFIG_FILTER_DEFINE, CRINIT_CONFIG_KEYSTR_FILTER_DEFINE, true, true, crinitCfgFilterHandler},
     {CRINIT_CONFIG_GROUP, CRINIT_CONFIG_KEYSTR_GROUP, true, false, crinitCfgGroupHandler},
     {CRINIT_CONFIG_INCLUDE, CRINIT_CONFIG_KEYSTR_INCLUDE, true, false, crinitTaskIncludeHandler},
+    {CRINIT_CONFIG_IOPRIO, CRINIT_CONFIG_KEYSTR_IOPRIO, false, true, crinitCfgIoPrioHandler},
     {CRINIT_CONFIG_IOREDIR, CRINIT_CONFIG_KEYSTR_IOREDIR, true, true, crinitCfgIoRedirHandler},
     {CRINIT_CONFIG_NAME, CRINIT_CONFIG_KEYSTR_NAME, false, false, crinitCfgNameHandler},
+    {CRINIT_CONFIG_NICE, CRINIT_CONFIG_KEYSTR_NICE, false, true, crinitCfgNiceHandler},
     {CRINIT_CONFIG_PROVIDES, CRINIT_CONFIG_KEYSTR_PROVIDES, true, false, crinitCfgPrvHandler},
     {CRINIT_CONFIG_RESPAWN, CRINIT_CONFIG_KEYSTR_RESPAWN, false, false, crinitCfgRespHandler},
+    {CRINIT_CONFIG_RESPAWN_DELAY_MAX, CRINIT_CONFIG_KEYSTR_RESPAWN_DELAY_MAX, false, true,
+     crinitCfgRespDelayMaxHandler},
+    {CRINIT_CONFIG_RESPAWN_DELAY, CRINIT_CONFIG_KEYSTR_RESPAWN_DELAY, false, true, crinitCfgRespDelayHandler},
+    {CRINIT_CONFIG_RESPAWN_RESET, CRINIT_CONFIG_KEYSTR_RESPAWN_RESET, false, true, crinitCfgRespResetHandler},
     {CRINIT_CONFIG_RESPAWN_RETRIES, CRINIT_CONFIG_KEYSTR_RESPAWN_RETRIES, false, false, crinitCfgRespRetHandler},
+    {CRINIT_CONFIG_RLIMIT, CRINIT_CONFIG_KEYSTR_RLIMIT, true, true, crinitCfgRlimitHandler},
+    {CRINIT_CONFIG_SCHED_POLICY, CRINIT_CONFIG_KEYSTR_SCHED_POLICY, false, true, crinitCfgSchedPolicyHandler},
+    {CRINIT_CONFIG_SCHED_PRIORITY, CRINIT_CONFIG_KEYSTR_SCHED_PRIORITY, false, true, crinitCfgSchedPrioHandler},
     {CRINIT_CONFIG_STOP_COMMAND, CRINIT_CONFIG_KEYSTR_STOP_COMMAND, true, false, crinitCfgStopCmdHandler},
+    {CRINIT_CONFIG_STOP_TIMEOUT, CRINIT_CONFIG_KEYSTR_STOP_TIMEOUT, false, true, crinitCfgStopTimeoutHandler},
     {CRINIT_CONFIG_TRIGGER, CRINIT_CONFIG_KEYSTR_TRIGGER, true, true, crinitCfgTrigHandler},
     {CRINIT_CONFIG_TRIGGER_REARM, CRINIT_CONFIG_KEYSTR_TRIGGER_REARM, false, false, crinitCfgTrigRearmHandler},
     {CRINIT_CONFIG_USER, CRINIT_CONFIG_KEYSTR_USER, false, false, crinitCfgUserHandler}};
 const size_t crinitTaskCfgMapSize = crinitNumElements(crinitTaskCfgMap);
 
 const crinitConfigMapping_t crinitSeriesCfgMap[] = {
+    {CRINIT_CONFIG_ASYNC_LOG_RECORDS, CRINIT_CONFIG_KEYSTR_ASYNC_LOG_RECORDS, false, false,
+     crinitCfgAsyncLogRecordsHandler},
 #ifdef ENABLE_CGROUP
     {CRINIT_CONFIG_CGROUP_GLOBAL_NAME, CRINIT_CONFIG_KEYSTR_CGROUP_GLOBAL_NAME, true, false,
      crinitCfgCgroupGlobalNameHandler},
@@ -66,6 +79,9 @@ const crinitConfigMapping_t crinitSeriesCfgMap[] = {
      crinitCfgTaskDirSlHandler},
     {CRINIT_CONFIG_TASKS, CRINIT_CONFIG_KEYSTR_TASKS, true, false, crinitCfgTasksHandler},
     {CRINIT_CONFIG_TASK_FILE_SUFFIX, CRINIT_CONFIG_KEYSTR_TASK_FILE_SUFFIX, false, false, crinitCfgTaskSuffixHandler},
+    {CRINIT_CONFIG_TIMER_SLACK, CRINIT_CONFIG_KEYSTR_TIMER_SLACK, false, false, crinitCfgTimerSlackHandler},
+    {CRINIT_CONFIG_TIMER_STATE_FILE, CRINIT_CONFIG_KEYSTR_TIMER_STATE_FILE, false, false,
+     crinitCfgTimerStateFileHandler},
     {CRINIT_CONFIG_USE_ELOS, CRINIT_CONFIG_KEYSTR_USE_ELOS, false, false, crinitCfgElosHandler},
     {CRINIT_CONFIG_USE_SYSLOG, CRINIT_CONFIG_KEYSTR_USE_SYSLOG, false, false, crinitCfgSyslogHandler}};
 const size_t crinitSeriesCfgMapSize = crinitNumElements(crinitSeriesCfgMap);
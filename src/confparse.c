@@ -19,6 +19,7 @@
 #include "ioredir.h"
 #include "lexers.h"
 #include "logio.h"
+#include "trace.h"
 
 #ifdef SIGNATURE_SUPPORT
 #include "sig.h"
@@ -38,10 +39,22 @@ typedef struct {
  * Parser handler for libinih.
  */
 static int crinitIniHandler(void *parserCtx, const char *section, const char *name, const char *value);
+/**
+ * Read and parse a config file, implementation of crinitParseConf() without the tracing.
+ */
+static int crinitParseConfFile(crinitConfKvList_t **confList, const char *filename);
 
 /* Parses config file and fills confList. confList is dynamically allocated and needs to be freed
  * using crinitFreeConfList() */
 int crinitParseConf(crinitConfKvList_t **confList, const char *filename) {
+    uint64_t start = crinitTraceNow();
+    int ret = crinitParseConfFile(confList, filename);
+    const char *baseName = strrchr(filename, '/');
+    crinitTraceSpan(CRINIT_TRACE_CONFIG_LOAD, start, ret, "%s", (baseName != NULL) ? baseName + 1 : filename);
+    return ret;
+}
+
+static int crinitParseConfFile(crinitConfKvList_t **confList, const char *filename) {
     FILE *cf = fopen(filename, "re");
     if (cf == NULL) {
         crinitErrnoPrint("Could not open \'%s\'.", filename);
@@ -86,7 +99,11 @@ int crinitParseConf(crinitConfKvList_t **confList, const char *filename) {
             return -1;
         }
 
-        if (crinitVerifySignature((uint8_t *)fileBuf, strnlen(fileBuf, fileLen), sigBuf) == -1) {
+        uint64_t sigStart = crinitTraceNow();
+        int sigRes = crinitVerifySignature((uint8_t *)fileBuf, strnlen(fileBuf, fileLen), sigBuf);
+        const char *baseName = strrchr(filename, '/');
+        crinitTraceSpan(CRINIT_TRACE_SIG_VERIFY, sigStart, sigRes, "%s", (baseName != NULL) ? baseName + 1 : filename);
+        if (sigRes == -1) {
             crinitErrPrint("The config file '%s' and its signature '%s' do not match.", filename, sigfn);
             free(fileBuf);
             free(sigfn);
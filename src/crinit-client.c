@@ -47,6 +47,33 @@ static const char *crinitSockFile = CRINIT_SOCKFILE;
  * @return 0 if \a res is valid and indicates success, -1 if not
  */
 static inline int crinitResponseCheck(const crinitRtimCmd_t *res, crinitRtimOp_t resCode);
+/**
+ * Parse a timestamp of the form `<seconds>.<nanoseconds>` from a response argument.
+ *
+ * @param ts   Return pointer for the parsed timestamp.
+ * @param str  The response argument to parse.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitParseTimespecArg(struct timespec *ts, const char *str);
+/**
+ * Parse a resource usage record of CRINIT_RTIMCMD_USAGE_FIELDS response arguments.
+ *
+ * @param u     Return pointer for the parsed resource usage.
+ * @param args  The response arguments to parse.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitParseUsageArgs(crinitTaskUsage_t *u, char **args);
+/**
+ * Parse an unsigned decimal number from a response argument.
+ *
+ * @param out  Return pointer for the parsed number.
+ * @param str  The response argument to parse.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitParseUllArg(unsigned long long *out, const char *str);
 
 /**
  * Library initialization function.
@@ -364,7 +391,7 @@ CRINIT_LIB_EXPORTED int crinitClientTaskGetStatus(crinitTaskState_t *s, pid_t *p
         *groupname = NULL;
     }
 
-    if (crinitResponseCheck(&res, CRINIT_RTIMCMD_R_STATUS) == 0 && res.argc == 10) {
+    if (crinitResponseCheck(&res, CRINIT_RTIMCMD_R_STATUS) == 0 && res.argc == CRINIT_RTIMCMD_STATUS_ARGS) {
         char *endPtr;
         if (s != NULL) {
             *s = strtoul(res.args[1], &endPtr, 10);
@@ -475,6 +502,99 @@ responseFail:
     return -1;
 }
 
+CRINIT_LIB_EXPORTED int crinitClientTaskGetUsage(crinitTaskUsageInfo_t **uiptr, const char *taskName) {
+    crinitNullCheck(-1, uiptr, taskName);
+
+    crinitRtimCmd_t cmd, res;
+    if (crinitBuildRtimCmd(&cmd, CRINIT_RTIMCMD_C_USAGE, 1, taskName) == -1) {
+        crinitErrPrint("Could not build RtimCmd to send to Crinit.");
+        return -1;
+    }
+
+    if (crinitXfer(crinitSockFile, &res, &cmd) == -1) {
+        crinitDestroyRtimCmd(&cmd);
+        crinitErrPrint("Could not complete data transfer from/to Crinit.");
+        return -1;
+    }
+    crinitDestroyRtimCmd(&cmd);
+
+    if (crinitResponseCheck(&res, CRINIT_RTIMCMD_R_USAGE) == -1) {
+        crinitDestroyRtimCmd(&res);
+        return -1;
+    }
+
+    unsigned long long numCmds = 0, numStopCmds = 0;
+    if (res.argc >= 3) {
+        char *endPtr;
+        errno = 0;
+        numCmds = strtoull(res.args[1], &endPtr, 10);
+        if (endPtr == res.args[1] || errno == ERANGE) {
+            numCmds = res.argc;
+        }
+        numStopCmds = strtoull(res.args[2], &endPtr, 10);
+        if (endPtr == res.args[2] || errno == ERANGE) {
+            numStopCmds = res.argc;
+        }
+    }
+    if (res.argc < 3 || numCmds >= res.argc || numStopCmds >= res.argc ||
+        res.argc != 3 + (1 + numCmds + numStopCmds) * CRINIT_RTIMCMD_USAGE_FIELDS) {
+        crinitErrPrint("Unexpected number of arguments in response from Crinit.");
+        crinitDestroyRtimCmd(&res);
+        return -1;
+    }
+
+    *uiptr = calloc(1, sizeof(crinitTaskUsageInfo_t));
+    if (*uiptr == NULL) {
+        crinitErrPrint("Could not allocate memory for task resource usage.");
+        crinitDestroyRtimCmd(&res);
+        return -1;
+    }
+    crinitTaskUsageInfo_t *ui = *uiptr;
+    ui->numCmds = numCmds;
+    ui->numStopCmds = numStopCmds;
+    ui->cmds = calloc(numCmds, sizeof(*(ui->cmds)));
+    ui->stopCmds = calloc(numStopCmds, sizeof(*(ui->stopCmds)));
+    if ((ui->cmds == NULL && numCmds > 0) || (ui->stopCmds == NULL && numStopCmds > 0)) {
+        crinitErrPrint("Could not allocate memory for command resource usage.");
+        goto fail;
+    }
+
+    char **usageArgs = &res.args[3];
+    if (crinitParseUsageArgs(&ui->total, usageArgs) == -1) {
+        goto fail;
+    }
+    for (size_t i = 0; i < numCmds; i++) {
+        usageArgs += CRINIT_RTIMCMD_USAGE_FIELDS;
+        if (crinitParseUsageArgs(&ui->cmds[i], usageArgs) == -1) {
+            goto fail;
+        }
+    }
+    for (size_t i = 0; i < numStopCmds; i++) {
+        usageArgs += CRINIT_RTIMCMD_USAGE_FIELDS;
+        if (crinitParseUsageArgs(&ui->stopCmds[i], usageArgs) == -1) {
+            goto fail;
+        }
+    }
+
+    crinitDestroyRtimCmd(&res);
+    return 0;
+
+fail:
+    crinitClientFreeTaskUsage(ui);
+    *uiptr = NULL;
+    crinitDestroyRtimCmd(&res);
+    return -1;
+}
+
+CRINIT_LIB_EXPORTED void crinitClientFreeTaskUsage(crinitTaskUsageInfo_t *ui) {
+    if (ui == NULL) {
+        return;
+    }
+    free(ui->cmds);
+    free(ui->stopCmds);
+    free(ui);
+}
+
 CRINIT_LIB_EXPORTED int crinitClientGetTaskList(crinitTaskList_t **tlptr) {
     if (tlptr == NULL) {
         crinitErrPrint("Pointer arguments must not be NULL");
@@ -576,6 +696,113 @@ CRINIT_LIB_EXPORTED void crinitClientFreeTaskList(crinitTaskList_t *tl) {
     free(tl);
 }
 
+CRINIT_LIB_EXPORTED int crinitClientGetTaskGraph(crinitTaskGraph_t **tgptr) {
+    if (tgptr == NULL) {
+        crinitErrPrint("Pointer arguments must not be NULL");
+        return -1;
+    }
+
+    crinitRtimCmd_t cmd, res;
+    if (crinitBuildRtimCmd(&cmd, CRINIT_RTIMCMD_C_GRAPH, 0) == -1) {
+        crinitErrPrint("Could not build RtimCmd to send to Crinit.");
+        return -1;
+    }
+
+    if (crinitXfer(crinitSockFile, &res, &cmd) == -1) {
+        crinitDestroyRtimCmd(&cmd);
+        crinitErrPrint("Could not complete data transfer from/to Crinit.");
+        return -1;
+    }
+    crinitDestroyRtimCmd(&cmd);
+
+    if (crinitResponseCheck(&res, CRINIT_RTIMCMD_R_GRAPH) == -1) {
+        crinitDestroyRtimCmd(&res);
+        return -1;
+    }
+
+    if ((res.argc - 1) % CRINIT_RTIMCMD_GRAPH_FIELDS != 0) {
+        crinitErrPrint("Unexpected number of arguments in response from Crinit.");
+        crinitDestroyRtimCmd(&res);
+        return -1;
+    }
+    size_t numTasks = (res.argc - 1) / CRINIT_RTIMCMD_GRAPH_FIELDS;
+
+    *tgptr = malloc(sizeof(crinitTaskGraph_t));
+    if (*tgptr == NULL) {
+        crinitErrPrint("Could not allocate memory for task graph.");
+        crinitDestroyRtimCmd(&res);
+        return -1;
+    }
+    crinitTaskGraph_t *tg = *tgptr;
+    tg->numTasks = 0;
+    tg->tasks = malloc(numTasks * sizeof(*(tg->tasks)));
+    if (tg->tasks == NULL && numTasks > 0) {
+        crinitErrPrint("Could not allocate memory for task graph entries.");
+        goto fail;
+    }
+
+    for (size_t i = 0; i < numTasks; i++) {
+        char **taskArgs = &res.args[1 + i * CRINIT_RTIMCMD_GRAPH_FIELDS];
+        crinitTaskGraphEntry_t *e = &tg->tasks[i];
+        unsigned long long num[CRINIT_RTIMCMD_GRAPH_FIELDS - 1];
+        long nsec = 0;
+        char *endPtr;
+
+        errno = 0;
+        for (size_t j = 1; j < CRINIT_RTIMCMD_GRAPH_FIELDS; j++) {
+            num[j - 1] = strtoull(taskArgs[j], &endPtr, 10);
+            if (endPtr == taskArgs[j] || errno == ERANGE) {
+                crinitErrPrint("Could not parse numerical value from '%s'.", taskArgs[j]);
+                goto fail;
+            }
+        }
+        char *decPlPtr = strchr(taskArgs[4], '.');
+        if (decPlPtr == NULL) {
+            crinitErrPrint("Could not parse numerical value from '%s'. Missing decimal point.", taskArgs[4]);
+            goto fail;
+        }
+        decPlPtr++;
+        nsec = strtol(decPlPtr, &endPtr, 10);
+        if (endPtr == decPlPtr || errno == ERANGE) {
+            crinitErrPrint("Could not parse numerical value from '%s'.", taskArgs[4]);
+            goto fail;
+        }
+
+        e->name = strdup(taskArgs[0]);
+        if (e->name == NULL) {
+            crinitErrPrint("Could not allocate memory for task graph entry name.");
+            goto fail;
+        }
+        e->depth = num[0];
+        e->fanOut = num[1];
+        e->chainLen = num[2];
+        e->chainTime.tv_sec = (time_t)num[3];
+        e->chainTime.tv_nsec = nsec;
+        e->critical = num[4] != 0;
+        tg->numTasks++;
+    }
+
+    crinitDestroyRtimCmd(&res);
+    return 0;
+
+fail:
+    crinitClientFreeTaskGraph(tg);
+    *tgptr = NULL;
+    crinitDestroyRtimCmd(&res);
+    return -1;
+}
+
+CRINIT_LIB_EXPORTED void crinitClientFreeTaskGraph(crinitTaskGraph_t *tg) {
+    if (tg == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < tg->numTasks; i++) {
+        free(tg->tasks[i].name);
+    }
+    free(tg->tasks);
+    free(tg);
+}
+
 CRINIT_LIB_EXPORTED int crinitClientShutdown(crinitShutdownCmd_t sCmd) {
     crinitRtimCmd_t cmd, res;
     char sCmdStr[2] = {0};
@@ -660,6 +887,59 @@ CRINIT_LIB_EXPORTED int crinitClientGetVersion(crinitVersion_t *v) {
     return ret;
 }
 
+static int crinitParseTimespecArg(struct timespec *ts, const char *str) {
+    char *endPtr;
+    errno = 0;
+    ts->tv_sec = strtoll(str, &endPtr, 10);
+    if (endPtr == str || *endPtr != '.' || errno == ERANGE) {
+        crinitErrPrint("Could not parse timestamp from '%s'.", str);
+        return -1;
+    }
+    const char *decPlPtr = endPtr + 1;
+    ts->tv_nsec = strtol(decPlPtr, &endPtr, 10);
+    if (endPtr == decPlPtr || errno == ERANGE) {
+        crinitErrPrint("Could not parse timestamp from '%s'.", str);
+        return -1;
+    }
+    return 0;
+}
+
+static int crinitParseUllArg(unsigned long long *out, const char *str) {
+    char *endPtr;
+    errno = 0;
+    *out = strtoull(str, &endPtr, 10);
+    if (endPtr == str || *endPtr != '\0' || errno == ERANGE) {
+        crinitErrPrint("Could not parse numerical value from '%s'.", str);
+        return -1;
+    }
+    return 0;
+}
+
+static int crinitParseUsageArgs(crinitTaskUsage_t *u, char **args) {
+    if (crinitParseTimespecArg(&u->userTime, args[0]) == -1 || crinitParseTimespecArg(&u->sysTime, args[1]) == -1) {
+        return -1;
+    }
+    long *counters[] = {&u->maxRss, &u->inBlock, &u->outBlock};
+    for (size_t i = 0; i < crinitNumElements(counters); i++) {
+        const char *arg = args[2 + i];
+        char *endPtr;
+        errno = 0;
+        *counters[i] = strtol(arg, &endPtr, 10);
+        if (endPtr == arg || errno == ERANGE) {
+            crinitErrPrint("Could not parse numerical value from '%s'.", arg);
+            return -1;
+        }
+    }
+    char *endPtr;
+    errno = 0;
+    u->numProcs = strtoul(args[5], &endPtr, 10);
+    if (endPtr == args[5] || errno == ERANGE) {
+        crinitErrPrint("Could not parse numerical value from '%s'.", args[5]);
+        return -1;
+    }
+    return 0;
+}
+
 static inline int crinitResponseCheck(const crinitRtimCmd_t *res, crinitRtimOp_t resCode) {
     if (res == NULL) {
         crinitErrPrint("Pointer arguments must not be NULL.");
@@ -686,3 +966,251 @@ static inline int crinitResponseCheck(const crinitRtimCmd_t *res, crinitRtimOp_t
 
     return -1;
 }
+
+CRINIT_LIB_EXPORTED int crinitClientGetBootTrace(crinitBootTrace_t **btptr) {
+    if (btptr == NULL) {
+        crinitErrPrint("Pointer arguments must not be NULL");
+        return -1;
+    }
+
+    *btptr = calloc(1, sizeof(crinitBootTrace_t));
+    if (*btptr == NULL) {
+        crinitErrPrint("Could not allocate memory for boot trace.");
+        return -1;
+    }
+    crinitBootTrace_t *bt = *btptr;
+
+    crinitRtimCmd_t cmd, res;
+    unsigned long long seq = 0;
+    size_t numEvents = 0;
+    // Crinit sends the trace in chunks, request chunks until we have caught up with the trace buffer.
+    do {
+        char seqStr[32];
+        snprintf(seqStr, sizeof(seqStr), "%llu", seq);
+        if (crinitBuildRtimCmd(&cmd, CRINIT_RTIMCMD_C_TRACE, 1, seqStr) == -1) {
+            crinitErrPrint("Could not build RtimCmd to send to Crinit.");
+            goto fail_nores;
+        }
+
+        if (crinitXfer(crinitSockFile, &res, &cmd) == -1) {
+            crinitDestroyRtimCmd(&cmd);
+            crinitErrPrint("Could not complete data transfer from/to Crinit.");
+            goto fail_nores;
+        }
+        crinitDestroyRtimCmd(&cmd);
+
+        if (crinitResponseCheck(&res, CRINIT_RTIMCMD_R_TRACE) == -1) {
+            goto fail;
+        }
+
+        if (res.argc < 3 || (res.argc - 3) % CRINIT_RTIMCMD_TRACE_FIELDS != 0) {
+            crinitErrPrint("Unexpected number of arguments in response from Crinit.");
+            goto fail;
+        }
+        numEvents = (res.argc - 3) / CRINIT_RTIMCMD_TRACE_FIELDS;
+
+        char *endPtr;
+        errno = 0;
+        unsigned long long nextSeq = strtoull(res.args[1], &endPtr, 10);
+        if (endPtr == res.args[1] || errno == ERANGE) {
+            crinitErrPrint("Could not parse numerical value from '%s'.", res.args[1]);
+            goto fail;
+        }
+        unsigned long long dropped = strtoull(res.args[2], &endPtr, 10);
+        if (endPtr == res.args[2] || errno == ERANGE) {
+            crinitErrPrint("Could not parse numerical value from '%s'.", res.args[2]);
+            goto fail;
+        }
+        seq = nextSeq;
+        bt->dropped += dropped;
+
+        crinitTraceEvent_t *newEvents = realloc(bt->events, (bt->numEvents + numEvents) * sizeof(*newEvents));
+        if (newEvents == NULL && numEvents > 0) {
+            crinitErrPrint("Could not allocate memory for boot trace events.");
+            goto fail;
+        }
+        if (newEvents != NULL) {
+            bt->events = newEvents;
+        }
+
+        for (size_t i = 0; i < numEvents; i++) {
+            char **evArgs = &res.args[3 + i * CRINIT_RTIMCMD_TRACE_FIELDS];
+            crinitTraceEvent_t *e = &bt->events[bt->numEvents];
+            unsigned long long num[3];
+
+            errno = 0;
+            for (size_t j = 0; j < 3; j++) {
+                num[j] = strtoull(evArgs[j], &endPtr, 10);
+                if (endPtr == evArgs[j] || errno == ERANGE) {
+                    crinitErrPrint("Could not parse numerical value from '%s'.", evArgs[j]);
+                    goto fail;
+                }
+            }
+            long tid = strtol(evArgs[3], &endPtr, 10);
+            if (endPtr == evArgs[3] || errno == ERANGE) {
+                crinitErrPrint("Could not parse numerical value from '%s'.", evArgs[3]);
+                goto fail;
+            }
+            long long arg = strtoll(evArgs[4], &endPtr, 10);
+            if (endPtr == evArgs[4] || errno == ERANGE) {
+                crinitErrPrint("Could not parse numerical value from '%s'.", evArgs[4]);
+                goto fail;
+            }
+
+            e->name = strdup(evArgs[5]);
+            if (e->name == NULL) {
+                crinitErrPrint("Could not allocate memory for boot trace event name.");
+                goto fail;
+            }
+            e->type = (crinitTraceEventType_t)num[0];
+            e->ts.tv_sec = (time_t)(num[1] / 1000000000uLL);
+            e->ts.tv_nsec = (long)(num[1] % 1000000000uLL);
+            e->dur.tv_sec = (time_t)(num[2] / 1000000000uLL);
+            e->dur.tv_nsec = (long)(num[2] % 1000000000uLL);
+            e->tid = (pid_t)tid;
+            e->arg = arg;
+            bt->numEvents++;
+        }
+
+        crinitDestroyRtimCmd(&res);
+    } while (numEvents == CRINIT_RTIMCMD_TRACE_CHUNK);
+
+    return 0;
+
+fail:
+    crinitDestroyRtimCmd(&res);
+fail_nores:
+    crinitClientFreeBootTrace(bt);
+    *btptr = NULL;
+    return -1;
+}
+
+CRINIT_LIB_EXPORTED void crinitClientFreeBootTrace(crinitBootTrace_t *bt) {
+    if (bt == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < bt->numEvents; i++) {
+        free(bt->events[i].name);
+    }
+    free(bt->events);
+    free(bt);
+}
+
+CRINIT_LIB_EXPORTED int crinitClientGetStats(crinitStats_t **stptr) {
+    if (stptr == NULL) {
+        crinitErrPrint("Pointer arguments must not be NULL");
+        return -1;
+    }
+
+    crinitRtimCmd_t cmd, res;
+    if (crinitBuildRtimCmd(&cmd, CRINIT_RTIMCMD_C_STATS, 0) == -1) {
+        crinitErrPrint("Could not build RtimCmd to send to Crinit.");
+        return -1;
+    }
+
+    if (crinitXfer(crinitSockFile, &res, &cmd) == -1) {
+        crinitDestroyRtimCmd(&cmd);
+        crinitErrPrint("Could not complete data transfer from/to Crinit.");
+        return -1;
+    }
+    crinitDestroyRtimCmd(&cmd);
+
+    if (crinitResponseCheck(&res, CRINIT_RTIMCMD_R_STATS) == -1) {
+        crinitDestroyRtimCmd(&res);
+        return -1;
+    }
+
+    *stptr = calloc(1, sizeof(crinitStats_t));
+    if (*stptr == NULL) {
+        crinitErrPrint("Could not allocate memory for metrics.");
+        crinitDestroyRtimCmd(&res);
+        return -1;
+    }
+    crinitStats_t *st = *stptr;
+    // Every metric takes at least CRINIT_RTIMCMD_STATS_FIELDS arguments, histograms are followed by their buckets.
+    size_t maxMetrics = (res.argc - 1) / CRINIT_RTIMCMD_STATS_FIELDS;
+    st->metrics = calloc(maxMetrics, sizeof(*(st->metrics)));
+    if (st->metrics == NULL && maxMetrics > 0) {
+        crinitErrPrint("Could not allocate memory for metric entries.");
+        goto fail;
+    }
+
+    size_t argIdx = 1;
+    while (argIdx < res.argc) {
+        if (res.argc - argIdx < CRINIT_RTIMCMD_STATS_FIELDS) {
+            crinitErrPrint("Unexpected number of arguments in response from Crinit.");
+            goto fail;
+        }
+        crinitMetric_t *m = &st->metrics[st->numMetrics];
+        unsigned long long type;
+        if (crinitParseUllArg(&type, res.args[argIdx]) == -1 ||
+            crinitParseUllArg(&m->value, res.args[argIdx + 2]) == -1) {
+            goto fail;
+        }
+        if (type > CRINIT_METRIC_HISTOGRAM) {
+            crinitErrPrint("Got unknown metric type %llu from Crinit.", type);
+            goto fail;
+        }
+        m->type = (crinitMetricType_t)type;
+
+        const char *fullName = res.args[argIdx + 1];
+        const char *labelStart = strchr(fullName, '{');
+        size_t nameLen = (labelStart != NULL) ? (size_t)(labelStart - fullName) : strlen(fullName);
+        m->name = strndup(fullName, nameLen);
+        if (m->name == NULL) {
+            crinitErrPrint("Could not allocate memory for metric name.");
+            goto fail;
+        }
+        st->numMetrics++;
+        if (labelStart != NULL) {
+            labelStart++;
+            size_t labelLen = strlen(labelStart);
+            if (labelLen == 0 || labelStart[labelLen - 1] != '}') {
+                crinitErrPrint("Could not parse metric labels from '%s'.", fullName);
+                goto fail;
+            }
+            m->labels = strndup(labelStart, labelLen - 1);
+            if (m->labels == NULL) {
+                crinitErrPrint("Could not allocate memory for metric labels.");
+                goto fail;
+            }
+        }
+        argIdx += CRINIT_RTIMCMD_STATS_FIELDS;
+
+        if (m->type != CRINIT_METRIC_HISTOGRAM) {
+            continue;
+        }
+        if (res.argc - argIdx < CRINIT_METRIC_BUCKETS) {
+            crinitErrPrint("Unexpected number of arguments in response from Crinit.");
+            goto fail;
+        }
+        for (size_t j = 0; j < CRINIT_METRIC_BUCKETS; j++) {
+            if (crinitParseUllArg(&m->buckets[j], res.args[argIdx + j]) == -1) {
+                goto fail;
+            }
+            m->count += m->buckets[j];
+        }
+        argIdx += CRINIT_METRIC_BUCKETS;
+    }
+
+    crinitDestroyRtimCmd(&res);
+    return 0;
+
+fail:
+    crinitClientFreeStats(st);
+    *stptr = NULL;
+    crinitDestroyRtimCmd(&res);
+    return -1;
+}
+
+CRINIT_LIB_EXPORTED void crinitClientFreeStats(crinitStats_t *st) {
+    if (st == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < st->numMetrics; i++) {
+        free(st->metrics[i].name);
+        free(st->metrics[i].labels);
+    }
+    free(st->metrics);
+    free(st);
+}
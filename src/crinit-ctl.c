@@ -35,12 +35,28 @@
  *            - Queries status bits, PID, and timestamps of <TASK_NAME>. The CTime, STime, and ETime fields
  *              represent the times the task was Created (loaded/parsed), last Started (became running), and
  *              last Ended (failed or is done). If the event has not occurred yet, the timestamp's value will
- *              be 'n/a'.
+ *              be 'n/a'. UTime, STime, MaxRSS, InBlock, and OutBlock show the CPU time, the largest resident
+ *              set size, and the block I/O operations of all processes of the task which have terminated, in
+ *              total and for each COMMAND and STOP_COMMAND. Procs is the number of these processes.
  *     notify <TASK_NAME> <"SD_NOTIFY_STRING">
  *            - Will send an sd_notify-style status report to Crinit. Only MAINPID and READY are
  *              implemented. See the sd_notify documentation for their meaning.
  *       list
  *            - Print the list of loaded tasks and their status.
+ *      graph
+ *            - Print the dependency graph analysis of all loaded tasks, i.e. their depth, fan-out, longest
+ *              dependency chain, and if they lie on the critical path.
+ *      trace [<PATH>]
+ *            - Write the boot trace recorded by Crinit in the Chrome trace event JSON format to <PATH> or to
+ *              stdout. The output can be opened in the Perfetto UI or in chrome://tracing.
+ *      stats [-p/--prometheus]
+ *            - Print the internal metrics of Crinit. Histograms are shown with their number of observations,
+ *              mean, and the bucket bounds of their 50th and 99th percentile in milliseconds.
+ *              '-p/--prometheus' - Print the metrics in the Prometheus text exposition format instead.
+ *      locks
+ *            - Print the lock contention profile of Crinit's global mutexes, i.e. acquisitions, contended
+ *              acquisitions, and wait and hold times per lock followed by the call sites with the longest total
+ *              wait time. Only available if Crinit has been built with ENABLE_LOCK_PROFILING.
  *     reboot
  *            - Will request Crinit to perform a graceful system reboot. crinit-ctl can be symlinked to
  *              reboot as a shortcut which will invoke this command automatically.
@@ -57,6 +73,7 @@
 #include <getopt.h>
 #include <inttypes.h>
 #include <libgen.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -68,6 +85,16 @@
 
 #define TIME_REPR_MAX_LEN 64                          ///< Maximum length of task time represented as a string.
 #define TIME_REPR_PRINTF_FORMAT "%" PRId64 ".%.9lds"  ///< Format string to represent a task timespec.
+#define CRINIT_CTL_LOCK_TOP_SITES 5                   ///< Maximum number of call sites shown per lock by "locks".
+
+/** Statistics of a single call site of a lock as reported by the lock profiler of Crinit. **/
+typedef struct crinitLockSiteStats {
+    const char *labels;               ///< The labels of the metrics of the call site.
+    unsigned long long acquisitions;  ///< Number of times the lock has been acquired at the call site.
+    unsigned long long contentions;   ///< Number of acquisitions which had to wait for another thread.
+    unsigned long long waitNs;        ///< Total time spent waiting for the lock in nanoseconds.
+    unsigned long long holdNs;        ///< Total time the lock has been held in nanoseconds.
+} crinitLockSiteStats_t;
 
 /**
  * Print usage information.
@@ -88,6 +115,102 @@ static void crinitPrintVersion(void);
  * @return a string representing the given task status code.
  */
 static const char *crinitTaskStateToStr(crinitTaskState_t s);
+/**
+ * Print the resource usage of a task or of one of its commands.
+ *
+ * @param kind  What the usage belongs to, i.e. "Total", "COMMAND", or "STOP_COMMAND".
+ * @param idx   Index of the command, ignored for the total.
+ * @param u     The resource usage to print.
+ */
+static void crinitPrintTaskUsage(const char *kind, size_t idx, const crinitTaskUsage_t *u);
+/**
+ * Write a boot trace in the Chrome trace event JSON format.
+ *
+ * Events with a duration become complete (`X`) events, all others become thread-scoped instant (`i`) events. Each
+ * event is put on the track of the Crinit thread which recorded it.
+ *
+ * @param out  The stream to write to.
+ * @param bt   The boot trace to write.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitWriteChromeTrace(FILE *out, const crinitBootTrace_t *bt);
+/**
+ * Write a string escaped for use inside of a JSON string.
+ *
+ * @param out  The stream to write to.
+ * @param str  The string to write.
+ */
+static void crinitWriteJsonStr(FILE *out, const char *str);
+/**
+ * Print metrics as a human-readable table.
+ *
+ * @param st  The metrics to print.
+ */
+static void crinitPrintStats(const crinitStats_t *st);
+/**
+ * Write metrics in the Prometheus text exposition format.
+ *
+ * Durations are converted to seconds and histogram buckets are made cumulative as the format requires.
+ *
+ * @param out  The stream to write to.
+ * @param st   The metrics to write.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitWritePrometheus(FILE *out, const crinitStats_t *st);
+/**
+ * Format the bucket bound of a percentile of a histogram in milliseconds.
+ *
+ * The result is the upper bound of the bucket the percentile falls into, or the largest bound with a leading `>` if it
+ * falls into the last bucket.
+ *
+ * @param buf  The buffer to write to.
+ * @param len  The size of \a buf.
+ * @param m    The histogram.
+ * @param q    The percentile as a fraction between 0 and 1.
+ */
+static void crinitFormatPercentile(char *buf, size_t len, const crinitMetric_t *m, double q);
+/**
+ * Print the lock contention profile contained in the metrics of Crinit as a human-readable table.
+ *
+ * Each lock is followed by up to #CRINIT_CTL_LOCK_TOP_SITES of its call sites, ordered by their total wait time.
+ *
+ * @param st  The metrics including those of the lock profiler.
+ *
+ * @return 0 on success, -1 on error or if the metrics do not contain lock profiling data
+ */
+static int crinitPrintLockStats(const crinitStats_t *st);
+/**
+ * Find a metric by name and labels.
+ *
+ * @param st      The metrics to search.
+ * @param name    The name of the metric.
+ * @param labels  The labels of the metric.
+ *
+ * @return  Pointer to the metric or NULL if it is not found.
+ */
+static const crinitMetric_t *crinitFindMetric(const crinitStats_t *st, const char *name, const char *labels);
+/**
+ * Extract the value of a label from a list of labels in Prometheus syntax.
+ *
+ * @param buf     The buffer to write the value to.
+ * @param len     The size of \a buf.
+ * @param labels  The labels, e.g. `lock="taskdb",site="taskdb.c:42"`.
+ * @param key     The name of the label, e.g. `site`.
+ *
+ * @return 0 on success, -1 if the label is not present
+ */
+static int crinitGetLabelValue(char *buf, size_t len, const char *labels, const char *key);
+/**
+ * qsort() comparison function to order call sites by descending total wait time.
+ *
+ * @param a  Pointer to the first crinitLockSiteStats_t.
+ * @param b  Pointer to the second crinitLockSiteStats_t.
+ *
+ * @return  A negative, zero, or positive value as required by qsort().
+ */
+static int crinitCmpLockSiteWait(const void *a, const void *b);
 
 int main(int argc, char *argv[]) {
     int getoptArgc = argc;
@@ -122,16 +245,18 @@ int main(int argc, char *argv[]) {
                                          {"ignore-deps", no_argument, 0, 'i'},
                                          {"override-deps", required_argument, 0, 'd'},
                                          {"overwrite", no_argument, 0, 'f'},
+                                         {"prometheus", no_argument, 0, 'p'},
                                          {"verbose", no_argument, 0, 'v'},
                                          {0, 0, 0, 0}};
     bool overwrite = false;
     bool ignoreDeps = false;
+    bool prometheus = false;
     const char *overDeps = NULL;
 
     bool verbose = false;
 
     while (true) {
-        opt = getopt_long(getoptArgc, getoptArgv, "hd:fiv", longOptions, NULL);
+        opt = getopt_long(getoptArgc, getoptArgv, "hd:fipv", longOptions, NULL);
         if (opt == -1) {
             break;
         }
@@ -145,6 +270,9 @@ int main(int argc, char *argv[]) {
             case 'f':
                 overwrite = true;
                 break;
+            case 'p':
+                prometheus = true;
+                break;
             case 'v':
                 verbose = true;
                 break;
@@ -277,6 +405,18 @@ int main(int argc, char *argv[]) {
                         ctStr, stStr, etStr, username, uid, groupname, gid);
         free(username);
         free(groupname);
+
+        crinitTaskUsageInfo_t *ui = NULL;
+        if (crinitClientTaskGetUsage(&ui, getoptArgv[optind]) == 0) {
+            crinitPrintTaskUsage("Total", 0, &ui->total);
+            for (size_t i = 0; i < ui->numCmds; i++) {
+                crinitPrintTaskUsage("COMMAND", i, &ui->cmds[i]);
+            }
+            for (size_t i = 0; i < ui->numStopCmds; i++) {
+                crinitPrintTaskUsage("STOP_COMMAND", i, &ui->stopCmds[i]);
+            }
+            crinitClientFreeTaskUsage(ui);
+        }
         return EXIT_SUCCESS;
     }
     if (strcmp(getoptArgv[0], "notify") == 0) {
@@ -339,6 +479,96 @@ int main(int argc, char *argv[]) {
         crinitClientFreeTaskList(tl);
         return EXIT_SUCCESS;
     }
+    if (strcmp(getoptArgv[0], "graph") == 0) {
+        if (getoptArgv[optind] != NULL) {
+            crinitPrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        crinitTaskGraph_t *tg;
+        if (crinitClientGetTaskGraph(&tg) == -1) {
+            crinitErrPrint("Querying dependency graph analysis failed.");
+            return EXIT_FAILURE;
+        }
+        int maxNameLen = strlen("NAME");
+        for (size_t i = 0; i < tg->numTasks; i++) {
+            int len = strlen(tg->tasks[i].name);
+            if (len > maxNameLen) {
+                maxNameLen = len;
+            }
+        }
+        crinitInfoPrint("%-*s  %5s  %6s  %5s  %14s  %s", maxNameLen, "NAME", "DEPTH", "FANOUT", "CHAIN", "CHAINTIME",
+                        "CRITICAL");
+        for (size_t i = 0; i < tg->numTasks; i++) {
+            const crinitTaskGraphEntry_t *e = &tg->tasks[i];
+            char ctStr[TIME_REPR_MAX_LEN] = {'\0'};
+            snprintf(ctStr, sizeof(ctStr), TIME_REPR_PRINTF_FORMAT, (int64_t)e->chainTime.tv_sec, e->chainTime.tv_nsec);
+            crinitInfoPrint("%-*s  %5zu  %6zu  %5zu  %14s  %s", maxNameLen, e->name, e->depth, e->fanOut, e->chainLen,
+                            ctStr, (e->critical) ? "*" : "");
+        }
+        crinitClientFreeTaskGraph(tg);
+        return EXIT_SUCCESS;
+    }
+    if (strcmp(getoptArgv[0], "trace") == 0) {
+        const char *outPath = getoptArgv[optind];
+        if (outPath != NULL && getoptArgv[optind + 1] != NULL) {
+            crinitPrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        crinitBootTrace_t *bt;
+        if (crinitClientGetBootTrace(&bt) == -1) {
+            crinitErrPrint("Querying boot trace failed.");
+            return EXIT_FAILURE;
+        }
+        if (bt->dropped > 0) {
+            crinitErrPrint("The oldest %zu events of the boot trace have been overwritten.", bt->dropped);
+        }
+        FILE *out = (outPath != NULL) ? fopen(outPath, "we") : stdout;
+        if (out == NULL) {
+            crinitErrnoPrint("Could not open \'%s\' for writing.", outPath);
+            crinitClientFreeBootTrace(bt);
+            return EXIT_FAILURE;
+        }
+        int ret = crinitWriteChromeTrace(out, bt);
+        if (out != stdout && fclose(out) != 0) {
+            crinitErrnoPrint("Could not close \'%s\'.", outPath);
+            ret = -1;
+        }
+        crinitClientFreeBootTrace(bt);
+        return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (strcmp(getoptArgv[0], "stats") == 0) {
+        if (getoptArgv[optind] != NULL) {
+            crinitPrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        crinitStats_t *st;
+        if (crinitClientGetStats(&st) == -1) {
+            crinitErrPrint("Querying metrics failed.");
+            return EXIT_FAILURE;
+        }
+        int ret = 0;
+        if (prometheus) {
+            ret = crinitWritePrometheus(stdout, st);
+        } else {
+            crinitPrintStats(st);
+        }
+        crinitClientFreeStats(st);
+        return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (strcmp(getoptArgv[0], "locks") == 0) {
+        if (getoptArgv[optind] != NULL) {
+            crinitPrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        crinitStats_t *st;
+        if (crinitClientGetStats(&st) == -1) {
+            crinitErrPrint("Querying metrics failed.");
+            return EXIT_FAILURE;
+        }
+        int ret = crinitPrintLockStats(st);
+        crinitClientFreeStats(st);
+        return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
     if (strcmp(basename(getoptArgv[0]), "poweroff") == 0) {
         if (crinitClientShutdown(CRINIT_SHD_POWEROFF) == -1) {
             crinitErrPrint("System poweroff request failed.");
@@ -407,8 +637,13 @@ static void crinitPrintUsage(char *prgmPath) {
         "             - Queries status bits, PID, and timestamps of <TASK_NAME>. The CTime, STime, and ETime fields\n"
         "               represent the times the task was Created (loaded/parsed), last Started (became running), and\n"
         "               last Ended (failed or is done). If the event has not occurred yet, the timestamp's value will\n"
-        "               be 'n/a'.\n"
-        "               See \"list\" for a detailed description of different statuses.\n"
+        "               be 'n/a'. UTime, STime, MaxRSS, InBlock, and OutBlock show the CPU time, the largest resident\n"
+        "               set size, and the block I/O operations of all processes of the task which have terminated, in\n"
+        "               total and for each COMMAND and STOP_COMMAND. Procs is the number of these processes.\n"
+        "               See \"list\" for a detailed description of different statuses.\n",
+        prgmPath);
+    fprintf(
+        stderr,
         "      notify <TASK_NAME> <\"SD_NOTIFY_STRING\">\n"
         "             - Will send an sd_notify-style status report to Crinit. Only MAINPID and READY are\n"
         "               implemented. See the sd_notify documentation for their meaning.\n"
@@ -423,6 +658,20 @@ static void crinitPrintUsage(char *prgmPath) {
         "               The states \"running\", \"done\" and \"failed\" can appear with the\n"
         "               postfix \"(notified)\", too. That means that the information was transmitted\n"
         "               to crinit\n via the sd_notify API.\n"
+        "       graph\n"
+        "             - Print the dependency graph analysis of all loaded tasks, i.e. their depth, fan-out, longest\n"
+        "               dependency chain, and if they lie on the critical path.\n"
+        "       trace [<PATH>]\n"
+        "             - Write the boot trace recorded by Crinit in the Chrome trace event JSON format to <PATH> or to\n"
+        "               stdout. The output can be opened in the Perfetto UI or in chrome://tracing.\n"
+        "       stats [-p/--prometheus]\n"
+        "             - Print the internal metrics of Crinit. Histograms are shown with their number of observations,\n"
+        "               mean, and the bucket bounds of their 50th and 99th percentile in milliseconds.\n"
+        "               \'-p/--prometheus\' - Print the metrics in the Prometheus text exposition format instead.\n"
+        "       locks\n"
+        "             - Print the lock contention profile of Crinit\'s global mutexes, i.e. acquisitions, contended\n"
+        "               acquisitions, and wait and hold times per lock followed by the call sites with the longest\n"
+        "               total wait time. Only available if Crinit has been built with ENABLE_LOCK_PROFILING.\n"
         "      reboot\n"
         "             - Will request Crinit to perform a graceful system reboot. crinit-ctl can be symlinked to\n"
         "               reboot as a shortcut which will invoke this command automatically.\n"
@@ -433,8 +682,7 @@ static void crinitPrintUsage(char *prgmPath) {
         "        --verbose/-v - Be verbose.\n"
         "        --help/-h    - Print this help.\n"
         "        --version/-V - Print version information about crinit-ctl, the crinit-client library,\n"
-        "                       and -- if connection is successful -- the crinit daemon.\n",
-        prgmPath);
+        "                       and -- if connection is successful -- the crinit daemon.\n");
 }
 
 static void crinitPrintVersion(void) {
@@ -453,7 +701,8 @@ static void crinitPrintVersion(void) {
 
 static const char *crinitTaskStateToStr(crinitTaskState_t s) {
     bool notified = s & CRINIT_TASK_STATE_NOTIFIED;
-    s &= ~CRINIT_TASK_STATE_NOTIFIED;
+    bool crashLoop = s & CRINIT_TASK_STATE_CRASHLOOP;
+    s &= ~(CRINIT_TASK_STATE_NOTIFIED | CRINIT_TASK_STATE_CRASHLOOP);
 
     switch (s) {
         case CRINIT_TASK_STATE_LOADED:
@@ -465,8 +714,326 @@ static const char *crinitTaskStateToStr(crinitTaskState_t s) {
         case CRINIT_TASK_STATE_DONE:
             return (notified) ? "done (notified)" : "done";
         case CRINIT_TASK_STATE_FAILED:
+            if (crashLoop) {
+                return "failed (crash loop)";
+            }
             return (notified) ? "failed (notified)" : "failed";
         default:
             return "(invalid)";
     }
 }
+
+static void crinitPrintTaskUsage(const char *kind, size_t idx, const crinitTaskUsage_t *u) {
+    char prefix[32];
+    if (strcmp(kind, "Total") == 0) {
+        snprintf(prefix, sizeof(prefix), "%s", kind);
+    } else {
+        snprintf(prefix, sizeof(prefix), "%s[%zu]", kind, idx);
+    }
+    crinitInfoPrint("%s: UTime: " TIME_REPR_PRINTF_FORMAT " STime: " TIME_REPR_PRINTF_FORMAT
+                    " MaxRSS: %ldkB InBlock: %ld OutBlock: %ld Procs: %lu",
+                    prefix, (int64_t)u->userTime.tv_sec, u->userTime.tv_nsec, (int64_t)u->sysTime.tv_sec,
+                    u->sysTime.tv_nsec, u->maxRss, u->inBlock, u->outBlock, u->numProcs);
+}
+
+static int crinitWriteChromeTrace(FILE *out, const crinitBootTrace_t *bt) {
+    static const char *const typeStr[CRINIT_TRACE_EVENT_TYPES] = {
+        [CRINIT_TRACE_CONFIG_LOAD] = "config_load", [CRINIT_TRACE_SIG_VERIFY] = "sig_verify",
+        [CRINIT_TRACE_TASK_INSERT] = "insert",      [CRINIT_TRACE_TASK_READY] = "ready",
+        [CRINIT_TRACE_TASK_SPAWN] = "spawn",        [CRINIT_TRACE_CMD_EXEC] = "exec",
+        [CRINIT_TRACE_NOTIFY] = "notify",           [CRINIT_TRACE_DEP_FULFILL] = "dep_fulfill",
+        [CRINIT_TRACE_STATE_CHANGE] = "state",      [CRINIT_TRACE_LOCK_WAIT] = "lock_wait",
+    };
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedEvents\":%zu},\"traceEvents\":[\n", bt->dropped);
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"crinit\"}}");
+    for (size_t i = 0; i < bt->numEvents; i++) {
+        const crinitTraceEvent_t *e = &bt->events[i];
+        const char *type = ((size_t)e->type < CRINIT_TRACE_EVENT_TYPES) ? typeStr[e->type] : "unknown";
+        bool hasDur = e->type == CRINIT_TRACE_CONFIG_LOAD || e->type == CRINIT_TRACE_SIG_VERIFY ||
+                      e->type == CRINIT_TRACE_TASK_SPAWN || e->type == CRINIT_TRACE_CMD_EXEC ||
+                      e->type == CRINIT_TRACE_LOCK_WAIT;
+
+        // Timestamps are in microseconds.
+        fprintf(out, ",\n{\"name\":\"%s ", type);
+        crinitWriteJsonStr(out, e->name);
+        fprintf(out, "\",\"cat\":\"%s\",\"ph\":\"%s\",\"ts\":%" PRId64 ".%.3ld", type, (hasDur) ? "X" : "i",
+                (int64_t)e->ts.tv_sec * 1000000 + e->ts.tv_nsec / 1000, e->ts.tv_nsec % 1000);
+        if (hasDur) {
+            fprintf(out, ",\"dur\":%" PRId64 ".%.3ld", (int64_t)e->dur.tv_sec * 1000000 + e->dur.tv_nsec / 1000,
+                    e->dur.tv_nsec % 1000);
+        } else {
+            fprintf(out, ",\"s\":\"t\"");
+        }
+        fprintf(out, ",\"pid\":1,\"tid\":%d,\"args\":{", (int)e->tid);
+        switch (e->type) {
+            case CRINIT_TRACE_CONFIG_LOAD:
+            case CRINIT_TRACE_SIG_VERIFY:
+                fprintf(out, "\"result\":%lld", e->arg);
+                break;
+            case CRINIT_TRACE_TASK_SPAWN:
+                fprintf(out, "\"stop\":%s", (e->arg != 0) ? "true" : "false");
+                break;
+            case CRINIT_TRACE_CMD_EXEC:
+                fprintf(out, "\"pid\":%lld", e->arg);
+                break;
+            case CRINIT_TRACE_NOTIFY:
+                if (e->arg == 0) {
+                    break;  // The notification did not change the state, e.g. if it only set MAINPID.
+                }
+                // fall through
+            case CRINIT_TRACE_STATE_CHANGE:
+                fprintf(out, "\"state\":\"%s\"", crinitTaskStateToStr((crinitTaskState_t)e->arg));
+                break;
+            case CRINIT_TRACE_TASK_INSERT:
+            case CRINIT_TRACE_TASK_READY:
+            case CRINIT_TRACE_DEP_FULFILL:
+            case CRINIT_TRACE_LOCK_WAIT:
+            case CRINIT_TRACE_EVENT_TYPES:
+            default:
+                break;
+        }
+        fprintf(out, "}}");
+    }
+    fprintf(out, "\n]}\n");
+
+    if (fflush(out) != 0 || ferror(out)) {
+        crinitErrPrint("Could not write boot trace.");
+        return -1;
+    }
+    return 0;
+}
+
+static void crinitWriteJsonStr(FILE *out, const char *str) {
+    for (const char *c = str; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(out, "\\%c", *c);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(out, "\\u%04x", (unsigned)*c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+}
+
+static void crinitPrintStats(const crinitStats_t *st) {
+    int maxNameLen = strlen("NAME");
+    for (size_t i = 0; i < st->numMetrics; i++) {
+        const crinitMetric_t *m = &st->metrics[i];
+        int len = strlen(m->name) + ((m->labels != NULL) ? strlen(m->labels) + 2 : 0);
+        if (len > maxNameLen) {
+            maxNameLen = len;
+        }
+    }
+    crinitInfoPrint("%-*s  %12s  %12s  %12s  %12s", maxNameLen, "NAME", "VALUE/COUNT", "AVG(ms)", "P50(ms)", "P99(ms)");
+    for (size_t i = 0; i < st->numMetrics; i++) {
+        const crinitMetric_t *m = &st->metrics[i];
+        char name[256];
+        if (m->labels != NULL) {
+            snprintf(name, sizeof(name), "%s{%s}", m->name, m->labels);
+        } else {
+            snprintf(name, sizeof(name), "%s", m->name);
+        }
+        if (m->type != CRINIT_METRIC_HISTOGRAM) {
+            crinitInfoPrint("%-*s  %12llu", maxNameLen, name, m->value);
+            continue;
+        }
+        char avgStr[32] = "-", p50Str[32] = "-", p99Str[32] = "-";
+        if (m->count > 0) {
+            snprintf(avgStr, sizeof(avgStr), "%.3f", (double)m->value / (double)m->count / 1e6);
+            crinitFormatPercentile(p50Str, sizeof(p50Str), m, 0.5);
+            crinitFormatPercentile(p99Str, sizeof(p99Str), m, 0.99);
+        }
+        crinitInfoPrint("%-*s  %12llu  %12s  %12s  %12s", maxNameLen, name, m->count, avgStr, p50Str, p99Str);
+    }
+}
+
+static int crinitWritePrometheus(FILE *out, const crinitStats_t *st) {
+    static const char *const typeStr[] = {
+        [CRINIT_METRIC_COUNTER] = "counter", [CRINIT_METRIC_GAUGE] = "gauge", [CRINIT_METRIC_HISTOGRAM] = "histogram"};
+    static const unsigned long long bounds[CRINIT_METRIC_BUCKETS - 1] = CRINIT_METRIC_BUCKET_BOUNDS_NS;
+
+    for (size_t i = 0; i < st->numMetrics; i++) {
+        const crinitMetric_t *m = &st->metrics[i];
+        const char *labels = (m->labels != NULL) ? m->labels : "";
+        const char *sep = (m->labels != NULL) ? "," : "";
+        char labelSet[256] = "";
+        if (m->labels != NULL) {
+            snprintf(labelSet, sizeof(labelSet), "{%s}", m->labels);
+        }
+
+        // Metrics of the same family are sent consecutively and share a single TYPE line.
+        if (i == 0 || strcmp(m->name, st->metrics[i - 1].name) != 0) {
+            fprintf(out, "# TYPE %s %s\n", m->name, typeStr[m->type]);
+        }
+        if (m->type != CRINIT_METRIC_HISTOGRAM) {
+            fprintf(out, "%s%s %llu\n", m->name, labelSet, m->value);
+            continue;
+        }
+        unsigned long long cumulative = 0;
+        for (size_t j = 0; j < CRINIT_METRIC_BUCKETS - 1; j++) {
+            cumulative += m->buckets[j];
+            fprintf(out, "%s_bucket{%s%sle=\"%g\"} %llu\n", m->name, labels, sep, (double)bounds[j] / 1e9, cumulative);
+        }
+        fprintf(out, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", m->name, labels, sep, m->count);
+        fprintf(out, "%s_sum%s %.9f\n", m->name, labelSet, (double)m->value / 1e9);
+        fprintf(out, "%s_count%s %llu\n", m->name, labelSet, m->count);
+    }
+
+    if (fflush(out) != 0 || ferror(out)) {
+        crinitErrPrint("Could not write metrics.");
+        return -1;
+    }
+    return 0;
+}
+
+static void crinitFormatPercentile(char *buf, size_t len, const crinitMetric_t *m, double q) {
+    static const unsigned long long bounds[CRINIT_METRIC_BUCKETS - 1] = CRINIT_METRIC_BUCKET_BOUNDS_NS;
+
+    // The observation with this rank (counting from 1) is the percentile.
+    unsigned long long rank = (unsigned long long)(q * (double)m->count);
+    if ((double)rank < q * (double)m->count || rank == 0) {
+        rank++;
+    }
+    unsigned long long cumulative = 0;
+    for (size_t j = 0; j < CRINIT_METRIC_BUCKETS - 1; j++) {
+        cumulative += m->buckets[j];
+        if (cumulative >= rank) {
+            snprintf(buf, len, "<=%g", (double)bounds[j] / 1e6);
+            return;
+        }
+    }
+    snprintf(buf, len, ">%g", (double)bounds[CRINIT_METRIC_BUCKETS - 2] / 1e6);
+}
+
+static int crinitPrintLockStats(const crinitStats_t *st) {
+    static const char *const sitePrefix = "crinit_lock_site_";
+
+    crinitLockSiteStats_t *sites = calloc(st->numMetrics + 1, sizeof(*sites));
+    if (sites == NULL) {
+        crinitErrnoPrint("Could not allocate memory for lock call sites.");
+        return -1;
+    }
+
+    bool found = false;
+    for (size_t i = 0; i < st->numMetrics; i++) {
+        const crinitMetric_t *wait = &st->metrics[i];
+        char lockName[64];
+        if (strcmp(wait->name, "crinit_lock_wait_seconds") != 0 || wait->labels == NULL ||
+            crinitGetLabelValue(lockName, sizeof(lockName), wait->labels, "lock") == -1) {
+            continue;
+        }
+        if (!found) {
+            crinitInfoPrint("%-24s  %10s  %10s  %10s  %12s  %12s  %10s  %12s  %12s", "LOCK/SITE", "ACQUIRED",
+                            "CONTENDED", "WAIT(ms)", "P50 WAIT(ms)", "P99 WAIT(ms)", "HOLD(ms)", "P50 HOLD(ms)",
+                            "P99 HOLD(ms)");
+            found = true;
+        }
+
+        // The call sites of a lock carry its labels followed by the site label.
+        size_t prefixLen = strlen(wait->labels);
+        size_t numSites = 0;
+        unsigned long long contentions = 0;
+        for (size_t j = 0; j < st->numMetrics; j++) {
+            const crinitMetric_t *m = &st->metrics[j];
+            if (strncmp(m->name, sitePrefix, strlen(sitePrefix)) != 0 || m->labels == NULL ||
+                strncmp(m->labels, wait->labels, prefixLen) != 0 || m->labels[prefixLen] != ',') {
+                continue;
+            }
+            crinitLockSiteStats_t *site = NULL;
+            for (size_t k = 0; k < numSites && site == NULL; k++) {
+                if (strcmp(sites[k].labels, m->labels) == 0) {
+                    site = &sites[k];
+                }
+            }
+            if (site == NULL) {
+                site = &sites[numSites++];
+                *site = (crinitLockSiteStats_t){.labels = m->labels};
+            }
+
+            const char *field = m->name + strlen(sitePrefix);
+            if (strcmp(field, "acquisitions_total") == 0) {
+                site->acquisitions = m->value;
+            } else if (strcmp(field, "contentions_total") == 0) {
+                site->contentions = m->value;
+                contentions += m->value;
+            } else if (strcmp(field, "wait_nanoseconds_total") == 0) {
+                site->waitNs = m->value;
+            } else if (strcmp(field, "hold_nanoseconds_total") == 0) {
+                site->holdNs = m->value;
+            }
+        }
+        qsort(sites, numSites, sizeof(*sites), crinitCmpLockSiteWait);
+
+        char waitP50[32] = "-", waitP99[32] = "-", holdP50[32] = "-", holdP99[32] = "-";
+        if (wait->count > 0) {
+            crinitFormatPercentile(waitP50, sizeof(waitP50), wait, 0.5);
+            crinitFormatPercentile(waitP99, sizeof(waitP99), wait, 0.99);
+        }
+        const crinitMetric_t *hold = crinitFindMetric(st, "crinit_lock_hold_seconds", wait->labels);
+        double holdMs = 0.0;
+        if (hold != NULL && hold->count > 0) {
+            holdMs = (double)hold->value / 1e6;
+            crinitFormatPercentile(holdP50, sizeof(holdP50), hold, 0.5);
+            crinitFormatPercentile(holdP99, sizeof(holdP99), hold, 0.99);
+        }
+        crinitInfoPrint("%-24s  %10llu  %10llu  %10.3f  %12s  %12s  %10.3f  %12s  %12s", lockName, wait->count,
+                        contentions, (double)wait->value / 1e6, waitP50, waitP99, holdMs, holdP50, holdP99);
+
+        for (size_t k = 0; k < numSites && k < CRINIT_CTL_LOCK_TOP_SITES; k++) {
+            char siteName[64];
+            if (crinitGetLabelValue(siteName, sizeof(siteName), sites[k].labels, "site") == -1) {
+                continue;
+            }
+            crinitInfoPrint("  %-22s  %10llu  %10llu  %10.3f  %12s  %12s  %10.3f", siteName, sites[k].acquisitions,
+                            sites[k].contentions, (double)sites[k].waitNs / 1e6, "", "", (double)sites[k].holdNs / 1e6);
+        }
+    }
+    free(sites);
+
+    if (!found) {
+        crinitErrPrint("Crinit did not report any lock profiling data, it needs to be built with "
+                       "ENABLE_LOCK_PROFILING.");
+        return -1;
+    }
+    return 0;
+}
+
+static const crinitMetric_t *crinitFindMetric(const crinitStats_t *st, const char *name, const char *labels) {
+    for (size_t i = 0; i < st->numMetrics; i++) {
+        const crinitMetric_t *m = &st->metrics[i];
+        if (strcmp(m->name, name) == 0 && m->labels != NULL && strcmp(m->labels, labels) == 0) {
+            return m;
+        }
+    }
+    return NULL;
+}
+
+static int crinitGetLabelValue(char *buf, size_t len, const char *labels, const char *key) {
+    size_t keyLen = strlen(key);
+    const char *cur = labels;
+    while (cur != NULL) {
+        if (strncmp(cur, key, keyLen) == 0 && strncmp(cur + keyLen, "=\"", 2) == 0) {
+            const char *val = cur + keyLen + 2;
+            const char *end = strchr(val, '"');
+            if (end == NULL) {
+                return -1;
+            }
+            snprintf(buf, len, "%.*s", (int)(end - val), val);
+            return 0;
+        }
+        cur = strchr(cur, ',');
+        if (cur != NULL) {
+            cur++;
+        }
+    }
+    return -1;
+}
+
+static int crinitCmpLockSiteWait(const void *a, const void *b) {
+    const crinitLockSiteStats_t *sa = a, *sb = b;
+    if (sa->waitNs != sb->waitNs) {
+        return (sa->waitNs < sb->waitNs) ? 1 : -1;
+    }
+    return (sa->acquisitions < sb->acquisitions) - (sa->acquisitions > sb->acquisitions);
+}
@@ -12,6 +12,8 @@
  *   user UID of the user to be used to start the specified command. If not given, the user of the crinit process is
  * used. groups Comma separated list of GIDs that shall be used to start the specified command. The first one will be
  * used as the primary group, all others as suplimentary groups. If not given the group of the crinit process is used.
+ *   rlimit Resource limit to set for the specified command, given as `<RESOURCE>:<SOFT>:<HARD>` where RESOURCE is the
+ * numerical value of an RLIMIT_* constant and the limits are numerical or `infinity`. May be given multiple times.
  *
  * After the delimiter -- the arguments of the specifed command can be given, if there are any.
  * General Options:
@@ -23,6 +25,7 @@
 #include <getopt.h>
 #include <grp.h>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
 #ifdef ENABLE_CAPABILITIES
@@ -42,6 +45,7 @@ static void crinitPrintUsage(void) {
     fprintf(
         stderr,
         "USAGE: crinit-launch --cmd=/path/to/targetcmd [--user=UID --groups=GID[,SGID1,SGID2]] "
+        "[--rlimit=RESOURCE:SOFT:HARD ...] "
 #ifdef ENABLE_CGROUP
         "--cgroup=<cgroup> "
 #endif
@@ -57,6 +61,8 @@ static void crinitPrintUsage(void) {
         "will\n"
         "       be used as the primary group, all others as suplimentary groups. If not given the group of the crinit "
         "process is used.\n"
+        "    rlimit Resource limit as <RESOURCE>:<SOFT>:<HARD> where RESOURCE is the numerical value of an RLIMIT_*\n"
+        "       constant and the limits are numerical or 'infinity'. May be given multiple times.\n"
 #ifdef ENABLE_CGROUP
         "    cgroup Name of the cgroup that shall be used to start the target process in. If the cgroup has a parent "
         "cgroup, \n"
@@ -122,6 +128,60 @@ int crinitExtractGroups(char *input, gid_t **groups, size_t *groupSize) {
     return 0;
 }
 
+/**
+ * Converts a single limit value given to `--rlimit` to an rlim_t.
+ *
+ * @param out    Output pointer for the limit.
+ * @param input  Either a decimal number or `infinity`.
+ *
+ * @return  0 on success, -1 on error.
+ */
+static int crinitParseRlimitValue(rlim_t *out, const char *input) {
+    if (strcmp(input, "infinity") == 0) {
+        *out = RLIM_INFINITY;
+        return 0;
+    }
+    char *endptr = NULL;
+    errno = 0;
+    unsigned long long val = strtoull(input, &endptr, 10);
+    if (endptr == input || *endptr != '\0' || errno != 0 || *input == '-') {
+        return -1;
+    }
+    *out = (rlim_t)val;
+    return 0;
+}
+
+int crinitApplyRlimit(char *input) {
+    char *rest = NULL;
+    char *resStr = strtok_r(input, ":", &rest);
+    char *softStr = strtok_r(NULL, ":", &rest);
+    char *hardStr = strtok_r(NULL, ":", &rest);
+    if (resStr == NULL || softStr == NULL || hardStr == NULL || strtok_r(NULL, ":", &rest) != NULL) {
+        crinitErrPrint("Malformed input for rlimit parameter.\n");
+        return -1;
+    }
+
+    char *endptr = NULL;
+    errno = 0;
+    unsigned long resource = strtoul(resStr, &endptr, 10);
+    if (endptr == resStr || *endptr != '\0' || errno != 0 || resource >= RLIM_NLIMITS) {
+        crinitErrPrint("Malformed resource for rlimit parameter: %s.\n", resStr);
+        return -1;
+    }
+
+    struct rlimit rlim;
+    if (crinitParseRlimitValue(&rlim.rlim_cur, softStr) != 0 || crinitParseRlimitValue(&rlim.rlim_max, hardStr) != 0) {
+        crinitErrPrint("Malformed limits for rlimit parameter: %s:%s.\n", softStr, hardStr);
+        return -1;
+    }
+
+    if (setrlimit((int)resource, &rlim) != 0) {
+        crinitErrnoPrint("Failed to set resource limit %lu.\n", resource);
+        return -1;
+    }
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
     int opt;
     const struct option longOptions[] = {{"help", no_argument, 0, 'h'},
@@ -129,6 +189,7 @@ int main(int argc, char *argv[]) {
                                          {"cmd", required_argument, 0, 'c'},
                                          {"user", required_argument, 0, 'u'},
                                          {"groups", required_argument, 0, 'g'},
+                                         {"rlimit", required_argument, 0, 'l'},
 #ifdef ENABLE_CAPABILITIES
                                          {"caps", required_argument, 0, 'p'},
 #endif
@@ -161,7 +222,7 @@ int main(int argc, char *argv[]) {
 #else
 #define CGROUPOPTS ""
 #endif
-    const char *opts = "hc:u:g:V" CAPOPTS CGROUPOPTS;
+    const char *opts = "hc:u:g:l:V" CAPOPTS CGROUPOPTS;
 
     while (true) {
         opt = getopt_long(argc, argv, opts, longOptions, NULL);
@@ -198,6 +259,13 @@ int main(int argc, char *argv[]) {
                     goto failureExit;
                 }
                 break;
+            case 'l':
+                // Apply right away, raising a hard limit is only possible before dropping privileges.
+                if (crinitApplyRlimit(optarg) != 0) {
+                    crinitErrPrint("Failed to apply resource limit.\n");
+                    goto failureExit;
+                }
+                break;
 #ifdef ENABLE_CAPABILITIES
             case 'p':
                 caps = strtoul(optarg, NULL, 16);
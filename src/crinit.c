@@ -14,11 +14,13 @@
 #include "crinit-version.h"
 #include "globopt.h"
 #include "kcmdline.h"
+#include "lockprof.h"
 #include "logio.h"
 #include "minsetup.h"
 #include "notiserv.h"
 #include "optfeat.h"
 #include "procdip.h"
+#include "reaper.h"
 #include "rtimopmap.h"
 #include "timerdb.h"
 
@@ -48,8 +50,8 @@ static void crinitTaskPrint(const crinitTask_t *t);
 /**
  * Main function of crinit.
  *
- * Will perform minimal system setup, fork from PID 1 (which remains as a zombie reaper process), construct a TaskDB
- * from the given configuration and then spawn tasks as they are ready.
+ * Will perform minimal system setup, start the reaper of child processes, construct a TaskDB from the given
+ * configuration and then spawn tasks as they are ready.
  */
 int main(int argc, char *argv[]) {
     const char *seriesFname = CRINIT_DEFAULT_CONFIG_SERIES;
@@ -122,20 +124,13 @@ int main(int argc, char *argv[]) {
             crinitErrnoPrint("Could not set PR_SET_CHILD_SUBREAPER to %d.", subReaper);
             return EXIT_FAILURE;
         }
-    } else if (!isPidOne) {
-        // In case we're not PID 1, we also need to check our subreaper attribute if the
-        // option wasn't given. Someone may have set the attribute for crinit prior to exec(),
-        // i.e. without our knowledge. In that case we still need to fork the Zombie reaper.
-        if (prctl(PR_GET_CHILD_SUBREAPER, &subReaper) == -1) {
-            crinitErrnoPrint("Could not check crinit's CHILD_SUBREAPER process attribute.");
-        }
     }
 
-    if (isPidOne || subReaper != SUBREAPER_FLAG_RESET) {
-        if (crinitForkZombieReaper() == -1) {
-            crinitErrPrint("Could not create a zombie reaper process.");
-            return EXIT_FAILURE;
-        }
+    // Must happen before any other thread is created. If we are PID 1 or a child subreaper, this will also take care of
+    // orphaned descendants.
+    if (crinitReaperInit() == -1) {
+        crinitErrPrint("Could not initialize the reaper of child processes.");
+        return EXIT_FAILURE;
     }
 
     if (sysMounts) {
@@ -188,6 +183,15 @@ int main(int argc, char *argv[]) {
         goto failFreeSigs;
     }
 
+    unsigned long long asyncLogRecords = CRINIT_CONFIG_DEFAULT_ASYNC_LOG_RECORDS;
+    if (crinitGlobOptGet(CRINIT_GLOBOPT_ASYNC_LOG_RECORDS, &asyncLogRecords) == -1) {
+        crinitErrPrint("Could not get value of '%s', logging synchronously.", CRINIT_CONFIG_KEYSTR_ASYNC_LOG_RECORDS);
+        asyncLogRecords = 0;
+    }
+    if (asyncLogRecords > 0 && crinitLogAsyncStart(asyncLogRecords) == -1) {
+        crinitErrPrint("Could not switch to asynchronous logging, logging synchronously.");
+    }
+
     // Initialize optional features as soon as possible.
     crinitInfoPrint("Initialize optional features.");
     if (crinitFeatureHook(NULL, CRINIT_HOOK_INIT, NULL) == -1) {
@@ -284,10 +288,10 @@ int main(int argc, char *argv[]) {
 
     while (true) {
         crinitTaskDBSpawnReady(&tdb, CRINIT_DISPATCH_THREAD_MODE_START);
-        pthread_mutex_lock(&tdb.lock);
+        crinitTaskDBLock(&tdb);
         crinitDbgInfoPrint("Waiting for Task to be ready.");
-        pthread_cond_wait(&tdb.changed, &tdb.lock);
-        pthread_mutex_unlock(&tdb.lock);
+        crinitTaskDBWaitChanged(&tdb, NULL);
+        crinitTaskDBUnlock(&tdb);
     }
     crinitTaskDBDestroy(&tdb);
     crinitGlobOptDestroy();
@@ -114,11 +114,11 @@ crinitElosVirtualTable_t *crinitElosGetVTable(void) {
     return &crinitElosVTable;
 }
 
-int crinitElosDisconnect(crinitElosSession_t *session, pthread_mutex_t *sessionLock) {
+int crinitElosDisconnect(crinitElosSession_t *session, pthread_mutex_t *sessionLock, crinitLockId_t lockId) {
     int res = SAFU_RESULT_OK;
 
     if (session != NULL) {
-        if ((errno = pthread_mutex_lock(sessionLock)) != 0) {
+        if ((errno = crinitMutexLock(sessionLock, lockId)) != 0) {
             crinitErrnoPrint("Failed to lock elos session.");
             return SAFU_RESULT_FAILED;
         }
@@ -128,7 +128,7 @@ int crinitElosDisconnect(crinitElosSession_t *session, pthread_mutex_t *sessionL
             crinitErrPrint("Failed to disconnect from elosd.");
         }
 
-        if ((errno = pthread_mutex_unlock(sessionLock)) != 0) {
+        if ((errno = crinitMutexUnlock(sessionLock, lockId)) != 0) {
             crinitErrnoPrint("Failed to unlock elos session.");
             res = SAFU_RESULT_FAILED;
         }
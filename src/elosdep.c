@@ -3,23 +3,32 @@
  * @file elosdep.c
  * @brief Implementation of elos connection.
  */
+#define _GNU_SOURCE  ///< Needed for POLLRDHUP and ppoll().
 #include "elosdep.h"
 
+#include <ctype.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <pthread.h>
 #include <stdlib.h>
+#include <sys/eventfd.h>
+#include <time.h>
 
 #include "common.h"
 #include "elos-common.h"
 #include "globopt.h"
 #include "list.h"
+#include "lockprof.h"
 #include "logio.h"
 #include "task.h"
 #include "taskdb.h"
+#include "usdt.h"
 
 #define CRINIT_ELOS_IDENT "crinit"  ///< Identification string for crinit logging to syslog
 /* HINT: We are relying on the major library version here. */
 #define CRINIT_ELOS_DEPENDENCY "@elos"  ///< Elos filter dependency prefix
+/** Shortest interval in microseconds between polls of the event queues, used right after events or subscriptions. **/
+#define CRINIT_ELOSDEP_POLL_INTERVAL_MIN_US 1000uLL
 
 static bool crinitElosActivated = false;  ///< Indicates if the elos connection and handler thread has been set up.
 static pthread_mutex_t crinitElosActivatedLock = PTHREAD_MUTEX_INITIALIZER;  ///< Mutex to guard crinitElosActivated.
@@ -34,14 +43,26 @@ typedef struct crinitElosdepFilterTask {
     crinitList_t list;           ///< List handle for filter task list
 } crinitElosdepFilterTask_t;
 
+/**
+ * A single elos subscription, shared by all filters with the same normalized filter rule.
+ */
+typedef struct crinitElosdepSubscription {
+    char *filter;                           ///< The normalized filter rule string
+    crinitElosEventQueueId_t eventQueueId;  ///< ID of the elos event queue related to this subscription
+    size_t refs;                            ///< Number of filters using this subscription
+    crinitList_t filters;                   ///< List of filters using this subscription
+    crinitList_t list;                      ///< List handle for subscription list
+} crinitElosdepSubscription_t;
+
 /**
  * Definition of a single filter related to a task.
  */
 typedef struct crinitElosdepFilter {
     char *name;                             ///< Name of the filter
-    char *filter;                           ///< The filter rule string
-    crinitElosEventQueueId_t eventQueueId;  ///< ID of the elos event queue related to this filter
+    crinitElosdepSubscription_t *sub;       ///< The elos subscription of the filter rule
+    struct crinitElosdepFilterTask *owner;  ///< The task this filter belongs to
     crinitList_t list;                      ///< List handle for filter list
+    crinitList_t subList;                   ///< List handle for crinitElosdepSubscription_t::filters
 } crinitElosdepFilter_t;
 
 /**
@@ -52,11 +73,15 @@ static struct crinitElosEventThread {
     bool elosStarted;              ///< Wether or not an initial conenction to elos has been established
     crinitTaskDB_t *taskDb;        ///< Pointer to crinit task database
     crinitElosSession_t *session;  ///< Elos session handle
-} crinitTinfo;
+    int wakeFd;                    ///< Eventfd waking up the listener on new subscriptions or deactivation
+} crinitTinfo = {.wakeFd = -1};
 
 /** List of tasks with elos filter dependencies **/
 static crinitList_t crinitFilterTasks = CRINIT_LIST_INIT(crinitFilterTasks);
 
+/** List of elos subscriptions, guarded by crinitElosdepFilterTaskLock **/
+static crinitList_t crinitElosdepSubscriptions = CRINIT_LIST_INIT(crinitElosdepSubscriptions);
+
 /** Mutex synchronizing elos filter task registration **/
 static pthread_mutex_t crinitElosdepFilterTaskLock = PTHREAD_MUTEX_INITIALIZER;
 
@@ -64,16 +89,126 @@ static pthread_mutex_t crinitElosdepFilterTaskLock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t crinitElosdepSessionLock = PTHREAD_MUTEX_INITIALIZER;
 
 /**
- * Frees the heap allocated members of the filter.
+ * Wakes up the event listener thread, e.g. to poll a new subscription right away.
+ */
+static void crinitElosdepWakeListener(void) {
+    uint64_t u = 1;
+    if (crinitTinfo.wakeFd != -1 && write(crinitTinfo.wakeFd, &u, sizeof(u)) != sizeof(u)) {
+        crinitErrnoPrint("Failed to wake up elos event listener.");
+    }
+}
+
+/**
+ * Frees the heap allocated members of the filter and drops its reference to the subscription.
+ *
+ * The subscription itself is kept, even if no filter uses it anymore. Needs crinitElosdepFilterTaskLock to be held.
  *
  * @param filter Filter to be destroyed.
  */
 static void crinitElosdepFilterDestroy(crinitElosdepFilter_t *filter) {
+    if (filter->sub != NULL) {
+        crinitListDelete(&filter->subList);
+        filter->sub->refs--;
+    }
     free(filter->name);
-    free(filter->filter);
     free(filter);
 }
 
+/**
+ * Normalizes an elos filter rule, so rules which only differ in whitespace share a subscription.
+ *
+ * Leading and trailing whitespace is removed and runs of whitespace outside of string literals are collapsed into a
+ * single space.
+ *
+ * @param rule  The filter rule as given in the task configuration.
+ *
+ * @return Returns the normalized rule on success which needs to be freed, NULL otherwise.
+ */
+static char *crinitElosdepFilterNormalize(const char *rule) {
+    char *out = malloc(strlen(rule) + 1);
+    if (out == NULL) {
+        crinitErrnoPrint("Failed to allocate memory for the elos filter rule.");
+        return NULL;
+    }
+
+    char *o = out;
+    char quote = '\0';
+    bool space = false;
+    for (const char *c = rule; *c != '\0'; c++) {
+        if (quote == '\0' && isspace((unsigned char)*c)) {
+            space = (o != out);
+            continue;
+        }
+        if (space) {
+            *o++ = ' ';
+            space = false;
+        }
+        if (quote != '\0' && *c == '\\' && c[1] != '\0') {
+            *o++ = *c++;
+        } else if (quote == '\0' && (*c == '\'' || *c == '"')) {
+            quote = *c;
+        } else if (*c == quote) {
+            quote = '\0';
+        }
+        *o++ = *c;
+    }
+    *o = '\0';
+
+    return out;
+}
+
+/**
+ * Finds the subscription for a filter rule or creates it if there is none yet.
+ *
+ * A new subscription has no event queue yet. Needs crinitElosdepFilterTaskLock to be held.
+ *
+ * @param rule     The filter rule, will be normalized.
+ * @param created  Set to true if a new subscription has been created.
+ *
+ * @return Returns the subscription on success, NULL otherwise.
+ */
+static crinitElosdepSubscription_t *crinitElosdepSubscriptionGet(const char *rule, bool *created) {
+    crinitElosdepSubscription_t *sub;
+    char *filter = crinitElosdepFilterNormalize(rule);
+    if (filter == NULL) {
+        return NULL;
+    }
+
+    *created = false;
+    crinitListForEachEntry(sub, &crinitElosdepSubscriptions, list) {
+        if (strcmp(sub->filter, filter) == 0) {
+            free(filter);
+            return sub;
+        }
+    }
+
+    sub = malloc(sizeof(*sub));
+    if (sub == NULL) {
+        crinitErrnoPrint("Failed to allocate memory for the elos subscription.");
+        free(filter);
+        return NULL;
+    }
+    sub->filter = filter;
+    sub->eventQueueId = ELOS_ID_INVALID;
+    sub->refs = 0;
+    crinitListInit(&sub->filters);
+    crinitListAppend(&crinitElosdepSubscriptions, &sub->list);
+    *created = true;
+
+    return sub;
+}
+
+/**
+ * Removes a subscription from the subscription list and frees it. Needs crinitElosdepFilterTaskLock to be held.
+ *
+ * @param sub  The subscription to destroy, must not be used by any filter anymore.
+ */
+static void crinitElosdepSubscriptionDestroy(crinitElosdepSubscription_t *sub) {
+    crinitListDelete(&sub->list);
+    free(sub->filter);
+    free(sub);
+}
+
 /**
  * Inserts an elos filter into the list of filter subscriptions.
  *
@@ -85,14 +220,14 @@ static void crinitElosdepFilterDestroy(crinitElosdepFilter_t *filter) {
  * @return Returns 0 if the filter has been inserted, -1 otherwise.
  */
 static int crinitElosdepFilterRegister(crinitElosdepFilterTask_t *filterTask, crinitElosdepFilter_t *filter) {
-    if ((errno = pthread_mutex_lock(&filterTask->filterLock)) != 0) {
+    if ((errno = crinitMutexLock(&filterTask->filterLock, CRINIT_LOCK_ELOSDEP_TASK_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to lock elos filter list.");
         return -1;
     }
 
     crinitListAppend(&filterTask->filterList, &filter->list);
 
-    if ((errno = pthread_mutex_unlock(&filterTask->filterLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&filterTask->filterLock, CRINIT_LOCK_ELOSDEP_TASK_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to unlock elos filter list.");
         return -1;
     }
@@ -111,7 +246,7 @@ static int crinitElosdepFilterRegister(crinitElosdepFilterTask_t *filterTask, cr
  * @return Returns 0 on success, -1 otherwise.
  */
 static int crinitElosdepFilterUnregister(crinitElosdepFilterTask_t *filterTask, crinitElosdepFilter_t *filter) {
-    if ((errno = pthread_mutex_lock(&filterTask->filterLock)) != 0) {
+    if ((errno = crinitMutexLock(&filterTask->filterLock, CRINIT_LOCK_ELOSDEP_TASK_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to lock elos filter list.");
         return -1;
     }
@@ -119,7 +254,7 @@ static int crinitElosdepFilterUnregister(crinitElosdepFilterTask_t *filterTask,
     crinitListDelete(&filter->list);
     crinitElosdepFilterDestroy(filter);
 
-    if ((errno = pthread_mutex_unlock(&filterTask->filterLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&filterTask->filterLock, CRINIT_LOCK_ELOSDEP_TASK_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to unlock elos filter list.");
         return -1;
     }
@@ -139,7 +274,7 @@ static int crinitElosdepFilterUnregister(crinitElosdepFilterTask_t *filterTask,
 static int crinitElosdepFilterListClear(crinitElosdepFilterTask_t *filterTask) {
     crinitElosdepFilter_t *cur, *temp;
 
-    if ((errno = pthread_mutex_lock(&filterTask->filterLock)) != 0) {
+    if ((errno = crinitMutexLock(&filterTask->filterLock, CRINIT_LOCK_ELOSDEP_TASK_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to lock elos filter list.");
         return -1;
     }
@@ -149,7 +284,7 @@ static int crinitElosdepFilterListClear(crinitElosdepFilterTask_t *filterTask) {
         crinitElosdepFilterDestroy(cur);
     }
 
-    if ((errno = pthread_mutex_unlock(&filterTask->filterLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&filterTask->filterLock, CRINIT_LOCK_ELOSDEP_TASK_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to unlock elos filter list.");
         return -1;
     }
@@ -185,7 +320,7 @@ static int crinitElosdepFilterTaskListClear(void) {
     crinitElosdepFilterTask_t *cur, *temp;
 
     /* Insert into list of filters of filter task */
-    if ((errno = pthread_mutex_lock(&crinitElosdepFilterTaskLock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to lock elos filter task list.");
         return -1;
     }
@@ -199,7 +334,14 @@ static int crinitElosdepFilterTaskListClear(void) {
         }
     }
 
-    if ((errno = pthread_mutex_unlock(&crinitElosdepFilterTaskLock)) != 0) {
+    if (res == 0) {
+        crinitElosdepSubscription_t *sub, *tempSub;
+        crinitListForEachEntrySafe(sub, tempSub, &crinitElosdepSubscriptions, list) {
+            crinitElosdepSubscriptionDestroy(sub);
+        }
+    }
+
+    if ((errno = crinitMutexUnlock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to unlock elos filter task list.");
         return -1;
     }
@@ -208,97 +350,79 @@ static int crinitElosdepFilterTaskListClear(void) {
 }
 
 /**
- * Create and register a new elos event filter handle from a given environment set.
+ * Looks up the rule of an elos filter in the filter definitions of a task.
  *
- * @param task   Task to create elos filter for.
- * @param name   Name of the filter to register.
- * @param filter Pointer to the created filter.
+ * @param task   Task to look up the elos filter for.
+ * @param name   Name of the filter.
  *
- * @return Returns 0 on success, -1 otherwise.
+ * @return Returns the filter rule on success, NULL otherwise.
  */
-static int crinitElosdepFilterFromEnvSet(const crinitTask_t *task, const char *name, crinitElosdepFilter_t **filter) {
-    int res = -1;
-    crinitElosdepFilter_t *temp;
+static const char *crinitElosdepFilterRuleFromEnvSet(const crinitTask_t *task, const char *name) {
     const crinitEnvSet_t *es = &task->elosFilters;
-    char *out;
 
     if (strchr(name, '=') != NULL) {
         crinitErrPrint("Environment variable names must not contain '='.");
-        return res;
+        return NULL;
     }
 
     size_t cmpLen = strlen(name);
 
     for (size_t i = 0; es->envp[i] != NULL; i++) {
-        out = strchr(es->envp[i], '=');
-        if (out == NULL) {
-            continue;
+        if (strncmp(es->envp[i], name, cmpLen) == 0 && es->envp[i][cmpLen] == '=') {
+            return es->envp[i] + cmpLen + 1;
         }
-
-        if (strncmp(es->envp[i], name, cmpLen) != 0 || es->envp[i][cmpLen] != '=') {
-            continue;
-        }
-
-        temp = malloc(sizeof(*temp));
-        if (temp == NULL) {
-            crinitErrPrint("Failed to allocate memory for the elos filter.");
-            break;
-        }
-
-        temp->name = strndup(es->envp[i], cmpLen);
-        temp->filter = strdup(es->envp[i] + cmpLen + 1);
-        temp->eventQueueId = ELOS_ID_INVALID;
-
-        *filter = temp;
-        res = 0;
-        break;
     }
 
-    return res;
+    return NULL;
 }
 
 /**
- * Subscribes the filter with elos.
+ * Subscribes the filter rule of a subscription with elos.
  *
- * @param filter The filter to subscribe.
+ * @param sub The subscription to subscribe.
  *
  * @return Returns 0 on success, -1 otherwise.
  */
-static inline int crinitElosdepFilterSubscribe(crinitElosdepFilter_t *filter) {
-    crinitDbgInfoPrint("Try to subscribe with filter %s: %s\n", filter->name, filter->filter);
-    return crinitElosTryExec(crinitTinfo.session, &crinitElosdepSessionLock, crinitElosGetVTable()->eventSubscribe,
-                             "Failed to subscribe with filter.", crinitTinfo.session, (const char **)&filter->filter, 1,
-                             &filter->eventQueueId);
+static inline int crinitElosdepSubscriptionSubscribe(crinitElosdepSubscription_t *sub) {
+    crinitDbgInfoPrint("Try to subscribe with filter: %s\n", sub->filter);
+    return crinitElosTryExec(crinitTinfo.session, &crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION,
+                             crinitElosGetVTable()->eventSubscribe, "Failed to subscribe with filter.",
+                             crinitTinfo.session, (const char **)&sub->filter, 1, &sub->eventQueueId);
 }
 
 /**
- * Subscribes all filters currently registered with elosdep.
+ * Subscribes all subscriptions currently registered with elosdep which have no event queue yet.
  *
  * Modifies errno.
  *
+ * @param resubscribe  Forget the event queues of all subscriptions first, e.g. because they belong to a lost session.
+ *
  * @return Returns 0 on success, -1 otherwise.
  */
-static int crinitElosdepFilterListSubscribe(void) {
+static int crinitElosdepFilterListSubscribe(bool resubscribe) {
     int res = 0;
-    crinitElosdepFilter_t *filter;
-    crinitElosdepFilterTask_t *filterTask;
+    crinitElosdepSubscription_t *sub;
 
-    if ((errno = pthread_mutex_lock(&crinitElosdepFilterTaskLock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to lock elos filter task list.");
         return -1;
     }
 
-    crinitListForEachEntry(filterTask, &crinitFilterTasks, list) {
-        crinitListForEachEntry(filter, &filterTask->filterList, list) {
-            if ((res = crinitElosdepFilterSubscribe(filter)) != 0) {
-                crinitErrPrint("Failed to subscribe filter.");
-                goto err;
-            }
+    crinitListForEachEntry(sub, &crinitElosdepSubscriptions, list) {
+        if (resubscribe) {
+            sub->eventQueueId = ELOS_ID_INVALID;
+        }
+        if (sub->eventQueueId != ELOS_ID_INVALID) {
+            continue;
+        }
+        if ((res = crinitElosdepSubscriptionSubscribe(sub)) != 0) {
+            crinitErrPrint("Failed to subscribe filter.");
+            goto err;
         }
     }
 
 err:
-    if ((errno = pthread_mutex_unlock(&crinitElosdepFilterTaskLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to unlock elos filter list.");
         res = -1;
     }
@@ -307,44 +431,45 @@ err:
 }
 
 /**
- * Unsubscribes the filter from elos.
+ * Unsubscribes the filter rule of a subscription from elos.
  *
- * @param filter The filter to unsubscribe.
+ * @param sub The subscription to unsubscribe.
  *
  * @return Returns 0 on success, -1 otherwise.
  */
-static inline int crinitElosdepFilterUnsubscribe(crinitElosdepFilter_t *filter) {
-    return crinitElosTryExec(crinitTinfo.session, &crinitElosdepSessionLock, crinitElosGetVTable()->eventUnsubscribe,
-                             "Failed to unsubscribe filter.", crinitTinfo.session, filter->eventQueueId);
+static inline int crinitElosdepSubscriptionUnsubscribe(crinitElosdepSubscription_t *sub) {
+    return crinitElosTryExec(crinitTinfo.session, &crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION,
+                             crinitElosGetVTable()->eventUnsubscribe, "Failed to unsubscribe filter.",
+                             crinitTinfo.session, sub->eventQueueId);
 }
 
 /**
- * Extracts all filter defines for each task and creates a local
- * elos filter handle, which will be used to subscribe for this filter.
+ * Unsubscribes all subscriptions currently registered with elosdep from elos.
  *
  * @return Returns 0 on success, -1 otherwise.
  */
 static int crinitElosdepFilterListUnsubscribe(void) {
     int res = 0;
-    crinitElosdepFilter_t *filter;
-    crinitElosdepFilterTask_t *filterTask;
+    crinitElosdepSubscription_t *sub;
 
-    if ((errno = pthread_mutex_lock(&crinitElosdepFilterTaskLock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to lock elos filter task list.");
         return -1;
     }
 
-    crinitListForEachEntry(filterTask, &crinitFilterTasks, list) {
-        crinitListForEachEntry(filter, &filterTask->filterList, list) {
-            if ((res = crinitElosdepFilterUnsubscribe(filter)) != 0) {
-                crinitErrPrint("Failed to subscribe filter.");
-                goto err;
-            }
+    crinitListForEachEntry(sub, &crinitElosdepSubscriptions, list) {
+        if (sub->eventQueueId == ELOS_ID_INVALID) {
+            continue;
+        }
+        if ((res = crinitElosdepSubscriptionUnsubscribe(sub)) != 0) {
+            crinitErrPrint("Failed to unsubscribe filter.");
+            goto err;
         }
+        sub->eventQueueId = ELOS_ID_INVALID;
     }
 
 err:
-    if ((errno = pthread_mutex_unlock(&crinitElosdepFilterTaskLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to unlock elos filter list.");
         res = -1;
     }
@@ -388,35 +513,74 @@ static int crinitElosdepRegisterFilterDep(crinitTask_t *task, crinitTaskDep_t *d
 
         crinitListInit(&(*filterTask)->filterList);
 
-        if ((errno = pthread_mutex_lock(&crinitElosdepFilterTaskLock)) != 0) {
+        if ((errno = crinitMutexLock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
             crinitErrnoPrint("Failed to lock elos filter task list.");
             return -1;
         }
 
         crinitListAppend(&crinitFilterTasks, &(*filterTask)->list);
 
-        if ((errno = pthread_mutex_unlock(&crinitElosdepFilterTaskLock)) != 0) {
+        if ((errno = crinitMutexUnlock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
             crinitErrnoPrint("Failed to unlock elos filter task list.");
             return -1;
         }
     }
 
     crinitDbgInfoPrint("Searching for filter for dependency %s:%s.", dep->name, dep->event);
-    if ((res = crinitElosdepFilterFromEnvSet(task, dep->event, &filter)) != 0) {
+    const char *rule = crinitElosdepFilterRuleFromEnvSet(task, dep->event);
+    if (rule == NULL) {
         crinitErrPrint("Failed to find filter for dependency %s:%s.", dep->name, dep->event);
-        return res;
+        return -1;
+    }
+
+    filter = calloc(1, sizeof(*filter));
+    if (filter == NULL || (filter->name = strdup(dep->event)) == NULL) {
+        crinitErrnoPrint("Failed to allocate memory for the elos filter.");
+        free(filter);
+        return -1;
+    }
+    filter->owner = *filterTask;
+
+    if ((errno = crinitMutexLock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
+        crinitErrnoPrint("Failed to lock elos filter task list.");
+        crinitElosdepFilterDestroy(filter);
+        return -1;
     }
 
+    /* Tasks waiting for the same events share a single subscription. */
+    bool created = false;
+    crinitElosdepSubscription_t *sub = crinitElosdepSubscriptionGet(rule, &created);
+    if (sub == NULL) {
+        crinitErrPrint("Failed to create subscription for dependency %s:%s.", dep->name, dep->event);
+        crinitElosdepFilterDestroy(filter);
+        res = -1;
+        goto out;
+    }
+    filter->sub = sub;
+    sub->refs++;
+    crinitListAppend(&sub->filters, &filter->subList);
+
     if ((res = crinitElosdepFilterRegister(*filterTask, filter)) != 0) {
         crinitErrPrint("Failed to register filter for dependency %s:%s.", dep->name, dep->event);
         crinitElosdepFilterDestroy(filter);
-        return res;
+        if (sub->refs == 0) {
+            crinitElosdepSubscriptionDestroy(sub);
+        }
+        goto out;
     }
 
-    /* Subscribing the filter might fail if elos is not started yet */
-    if (crinitTinfo.elosStarted && (res = crinitElosdepFilterSubscribe(filter)) != 0) {
-        crinitErrPrint("Failed to subscribe filter for dependency %s:%s.", dep->name, dep->event);
-        return res;
+    /* The listener subscribes new filters, so no request to elos blocks while holding the filter list lock here. If
+     * elos is not started yet, it subscribes all filters once it is. */
+    if (crinitTinfo.elosStarted && sub->eventQueueId == ELOS_ID_INVALID) {
+        crinitElosdepWakeListener();
+    } else if (!created) {
+        crinitDbgInfoPrint("Dependency %s:%s shares the subscription '%s'.", dep->name, dep->event, sub->filter);
+    }
+
+out:
+    if ((errno = crinitMutexUnlock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
+        crinitErrnoPrint("Failed to unlock elos filter task list.");
+        return -1;
     }
     return res;
 }
@@ -445,78 +609,181 @@ int crinitElosdepTaskAdded(crinitTask_t *task) {
     return res;
 }
 
+/**
+ * Waits until the event queues need to be polled again.
+ *
+ * Blocks on crinitElosEventThread::wakeFd and on a hangup of the elos session socket. Elos only hands out events on
+ * request, so with subscriptions the wait is also limited by \a timeoutUs.
+ *
+ * @param timeoutUs  Maximum time to wait in microseconds, 0 to wait without a time limit.
+ * @param woken      Set to true if the listener has been woken up through crinitElosdepWakeListener().
+ * @param sessionFd  Set to the socket of the elos session if it has been hung up, -1 otherwise.
+ *
+ * @return Returns 0 on success, -1 otherwise.
+ */
+static int crinitElosdepWait(unsigned long long timeoutUs, bool *woken, int *sessionFd) {
+    struct pollfd pfds[2] = {
+        {.fd = crinitTinfo.wakeFd, .events = POLLIN},
+        {.fd = -1, .events = POLLRDHUP},
+    };
+    if ((errno = crinitMutexLock(&crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION)) != 0) {
+        crinitErrnoPrint("Failed to lock elos session.");
+        return -1;
+    }
+    if (crinitTinfo.session != NULL && crinitTinfo.session->connected) {
+        pfds[1].fd = crinitTinfo.session->fd;
+    }
+    if ((errno = crinitMutexUnlock(&crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION)) != 0) {
+        crinitErrnoPrint("Failed to unlock elos session.");
+        return -1;
+    }
+
+    struct timespec timeout = {.tv_sec = (time_t)(timeoutUs / 1000000), .tv_nsec = (long)(timeoutUs % 1000000) * 1000};
+    *woken = false;
+    *sessionFd = -1;
+    if (ppoll(pfds, crinitNumElements(pfds), (timeoutUs > 0) ? &timeout : NULL, NULL) == -1) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        crinitErrnoPrint("Failed to wait for elos events.");
+        return -1;
+    }
+    if (pfds[0].revents & POLLIN) {
+        uint64_t u;
+        if (read(crinitTinfo.wakeFd, &u, sizeof(u)) == -1 && errno != EAGAIN) {
+            crinitErrnoPrint("Failed to read wakeup of elos event listener.");
+        }
+        *woken = true;
+    }
+    if (pfds[1].revents & (POLLRDHUP | POLLHUP | POLLERR)) {
+        *sessionFd = pfds[1].fd;
+    }
+    return 0;
+}
+
+/**
+ * Reconnects to elos after the session socket has been hung up and subscribes all registered filters again.
+ *
+ * @param sessionFd  The socket which has been hung up.
+ *
+ * @return Returns 0 on success, -1 otherwise.
+ */
+static int crinitElosdepReconnect(int sessionFd) {
+    if ((errno = crinitMutexLock(&crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION)) != 0) {
+        crinitErrnoPrint("Failed to lock elos session.");
+        return -1;
+    }
+    // Another thread may have reconnected in the meantime.
+    if (crinitTinfo.session != NULL && crinitTinfo.session->connected && crinitTinfo.session->fd == sessionFd) {
+        close(sessionFd);
+        crinitTinfo.session->connected = false;
+    }
+    if ((errno = crinitMutexUnlock(&crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION)) != 0) {
+        crinitErrnoPrint("Failed to unlock elos session.");
+        return -1;
+    }
+    crinitInfoPrint("Connection to elosd has been closed, reconnecting.");
+    return crinitElosdepFilterListSubscribe(true);
+}
+
 static void *crinitElosdepEventListener(void *arg) {
     int err = -1;
     const char *version;
     crinitElosdepFilter_t *filter, *tempFilter;
-    crinitElosdepFilterTask_t *filterTask;
+    crinitElosdepSubscription_t *sub, *tempSub;
     crinitElosEventVector_t *eventVector = NULL;
+    unsigned long long pollInterval = CRINIT_ELOSDEP_POLL_INTERVAL_MIN_US;
 
     struct crinitElosEventThread *tinfo = arg;
 
     tinfo->elosStarted = true;
 
-    err = crinitElosTryExec(crinitTinfo.session, &crinitElosdepSessionLock, crinitElosGetVTable()->getVersion,
-                            "Failed to request elos version.", tinfo->session, &version);
+    err = crinitElosTryExec(crinitTinfo.session, &crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION,
+                            crinitElosGetVTable()->getVersion, "Failed to request elos version.", tinfo->session,
+                            &version);
     if (err == SAFU_RESULT_OK) {
         crinitInfoPrint("Connected to elosd version %s for event reception.", version);
     } else {
         goto err_connection_lost;
     }
 
-    if ((err = crinitElosdepFilterListSubscribe()) != 0) {
+    if ((err = crinitElosdepFilterListSubscribe(false)) != 0) {
         crinitErrnoPrint("Failed to subscribe already registered elos filters.");
         goto err_connection_lost;
     }
 
     while (1) {
-        if ((errno = pthread_mutex_lock(&crinitElosActivatedLock)) != 0) {
+        if ((errno = crinitMutexLock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSDEP_ACTIVATED)) != 0) {
             crinitErrnoPrint("Failed to lock elos connection activation indicator.");
             goto err_connection_lost;
         }
         if (!crinitElosActivated) {
-            if ((errno = pthread_mutex_unlock(&crinitElosActivatedLock)) != 0) {
+            if ((errno = crinitMutexUnlock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSDEP_ACTIVATED)) != 0) {
                 crinitErrnoPrint("Failed to unlock elos connection activation indicator.");
             }
             goto err_connection_lost;
         }
-        if ((errno = pthread_mutex_unlock(&crinitElosActivatedLock)) != 0) {
+        if ((errno = crinitMutexUnlock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSDEP_ACTIVATED)) != 0) {
             crinitErrnoPrint("Failed to unlock elos connection activation indicator.");
             goto err_connection_lost;
         }
 
-        if ((errno = pthread_mutex_lock(&crinitElosdepFilterTaskLock)) != 0) {
+        if ((errno = crinitMutexLock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
             crinitErrnoPrint("Failed to lock elos filter task list.");
             goto err_connection_lost;
         }
 
-        crinitListForEachEntry(filterTask, &crinitFilterTasks, list) {
-            crinitListForEachEntrySafe(filter, tempFilter, &filterTask->filterList, list) {
-                err = crinitElosTryExec(crinitTinfo.session, &crinitElosdepSessionLock,
-                                        crinitElosGetVTable()->eventQueueRead, "Failed to read elos event queue.",
-                                        tinfo->session, filter->eventQueueId, &eventVector);
-                if (err == SAFU_RESULT_OK && eventVector && eventVector->elementCount > 0) {
-                    const crinitTaskDep_t taskDep = {
-                        .name = CRINIT_ELOS_DEPENDENCY,
-                        .event = filter->name,
-                    };
-
-                    if ((err = crinitTaskDBFulfillDep(tinfo->taskDb, &taskDep, filterTask->task)) != 0) {
-                        crinitErrnoPrint("Failed to fulfill dependency %s:%s.", taskDep.name, taskDep.event);
-                        goto err_session;
-                    }
-
-                    // only remove elos filter when task will not be rearmed
-                    if (!(filterTask->task->opts & CRINIT_TASK_OPT_TRIGGER_REARM) &&
-                        (err = crinitElosdepFilterUnregister(filterTask, filter)) != 0) {
-                        crinitErrnoPrint("Failed to remove filter from dependency list.");
-                        goto err_session;
-                    }
+        bool subscribed = false, received = false;
+        crinitListForEachEntrySafe(sub, tempSub, &crinitElosdepSubscriptions, list) {
+            if (sub->eventQueueId == ELOS_ID_INVALID) {
+                continue;
+            }
+            subscribed = true;
+            err = crinitElosTryExec(crinitTinfo.session, &crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION,
+                                    crinitElosGetVTable()->eventQueueRead, "Failed to read elos event queue.",
+                                    tinfo->session, sub->eventQueueId, &eventVector);
+            size_t numEvents = (err == SAFU_RESULT_OK && eventVector != NULL) ? eventVector->elementCount : 0;
+            bool hasEvents = numEvents > 0;
+            if (eventVector != NULL) {
+                crinitElosGetVTable()->eventVectorDelete(eventVector);
+                eventVector = NULL;
+            }
+            if (!hasEvents) {
+                continue;
+            }
+
+            received = true;
+            crinitListForEachEntrySafe(filter, tempFilter, &sub->filters, subList) {
+                crinitElosdepFilterTask_t *filterTask = filter->owner;
+                const crinitTaskDep_t taskDep = {
+                    .name = CRINIT_ELOS_DEPENDENCY,
+                    .event = filter->name,
+                };
+                crinitProbe3(elos_event, filterTask->task->name, filter->name, numEvents);
+
+                if ((err = crinitTaskDBFulfillDep(tinfo->taskDb, &taskDep, filterTask->task)) != 0) {
+                    crinitErrnoPrint("Failed to fulfill dependency %s:%s.", taskDep.name, taskDep.event);
+                    goto err_session;
                 }
+
+                // only remove elos filter when task will not be rearmed
+                if (!(filterTask->task->opts & CRINIT_TASK_OPT_TRIGGER_REARM) &&
+                    (err = crinitElosdepFilterUnregister(filterTask, filter)) != 0) {
+                    crinitErrnoPrint("Failed to remove filter from dependency list.");
+                    goto err_session;
+                }
+            }
+
+            // The last interested task is gone, so the events of this filter are not needed anymore.
+            if (sub->refs == 0) {
+                if (crinitElosdepSubscriptionUnsubscribe(sub) != 0) {
+                    crinitErrPrint("Failed to unsubscribe filter '%s'.", sub->filter);
+                }
+                crinitElosdepSubscriptionDestroy(sub);
             }
         }
 
-        if ((errno = pthread_mutex_unlock(&crinitElosdepFilterTaskLock)) != 0) {
+        if ((errno = crinitMutexUnlock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
             crinitErrnoPrint("Failed to unlock elos filter task list.");
         }
 
@@ -526,28 +793,54 @@ static void *crinitElosdepEventListener(void *arg) {
                            CRINIT_CONFIG_KEYSTR_ELOS_EVENT_POLL_INTERVAL);
             goto err_connection_lost;
         }
-        usleep(eventPollInterval);
+        // Events tend to come in bursts, so poll quickly after one and back off to the configured interval.
+        if (received) {
+            pollInterval = CRINIT_ELOSDEP_POLL_INTERVAL_MIN_US;
+        } else if (pollInterval < eventPollInterval) {
+            pollInterval *= 2;
+        }
+        if (pollInterval > eventPollInterval) {
+            pollInterval = eventPollInterval;
+        }
+
+        // Without subscriptions there is nothing to poll for until a task registers a filter.
+        bool woken = false;
+        int hungUpFd = -1;
+        if (crinitElosdepWait(subscribed ? ((pollInterval > 0) ? pollInterval : 1) : 0, &woken, &hungUpFd) == -1) {
+            goto err_connection_lost;
+        }
+        if (woken) {
+            pollInterval = CRINIT_ELOSDEP_POLL_INTERVAL_MIN_US;
+            // Subscriptions registered by crinitElosdepRegisterFilterDep() in the meantime.
+            if (crinitElosdepFilterListSubscribe(false) != 0) {
+                crinitErrPrint("Failed to subscribe newly registered elos filters.");
+            }
+        }
+        if (hungUpFd != -1 && crinitElosdepReconnect(hungUpFd) != 0) {
+            crinitErrPrint("Failed to reconnect to elosd.");
+            goto err_connection_lost;
+        }
     }
 
 err_connection_lost:
     if ((err = crinitElosdepFilterTaskListClear()) != 0) {
         crinitErrnoPrint("Failed to clear filter tasks.");
     }
-    if ((errno = pthread_mutex_lock(&crinitElosdepSessionLock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION)) != 0) {
         crinitErrnoPrint("Failed to lock elos session.");
         return NULL;
     }
     free(crinitTinfo.session);
     crinitTinfo.session = NULL;
     crinitTinfo.elosStarted = false;
-    if ((errno = pthread_mutex_unlock(&crinitElosdepSessionLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION)) != 0) {
         crinitErrnoPrint("Failed to unlock elos session.");
     }
 
     return NULL;
 
 err_session:
-    if ((errno = pthread_mutex_unlock(&crinitElosdepFilterTaskLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&crinitElosdepFilterTaskLock, CRINIT_LOCK_ELOSDEP_FILTERS)) != 0) {
         crinitErrnoPrint("Failed to unlock elos filter task list.");
     }
 
@@ -559,7 +852,7 @@ err_session:
         crinitErrnoPrint("Failed to clear filter tasks.");
     }
 
-    crinitElosDisconnect(crinitTinfo.session, &crinitElosdepSessionLock);
+    crinitElosDisconnect(crinitTinfo.session, &crinitElosdepSessionLock, CRINIT_LOCK_ELOSDEP_SESSION);
 
     return NULL;
 }
@@ -582,7 +875,7 @@ static int crinitElosdepInitThreadContext(crinitTaskDB_t *taskDb, struct crinitE
 int crinitElosdepActivate(crinitTaskDB_t *taskDb, bool e) {
     int res;
 
-    if ((errno = pthread_mutex_lock(&crinitElosActivatedLock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSDEP_ACTIVATED)) != 0) {
         crinitErrnoPrint("Failed to lock elos connection activation indicator.");
         return -1;
     }
@@ -592,6 +885,14 @@ int crinitElosdepActivate(crinitTaskDB_t *taskDb, bool e) {
             return -1;
         }
 
+        if (crinitTinfo.wakeFd == -1) {
+            crinitTinfo.wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (crinitTinfo.wakeFd == -1) {
+                crinitErrnoPrint("Could not create eventfd for elos event handler thread.");
+                return -1;
+            }
+        }
+
         pthread_attr_t attrs;
         res = pthread_attr_init(&attrs);
         if (res != 0) {
@@ -628,9 +929,12 @@ int crinitElosdepActivate(crinitTaskDB_t *taskDb, bool e) {
         }
     }
 
+    if (!e && crinitElosActivated) {
+        crinitElosdepWakeListener();
+    }
     crinitElosActivated = e;
 
-    if ((errno = pthread_mutex_unlock(&crinitElosActivatedLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSDEP_ACTIVATED)) != 0) {
         crinitErrnoPrint("Failed to unlock elos connection activation indicator.");
         return -1;
     }
@@ -6,17 +6,19 @@
 #include "eloslog.h"
 
 #include <errno.h>
+#include <inttypes.h>
 #include <pthread.h>
 #include <safu/common.h>
-#include <safu/ringbuffer.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "common.h"
 #include "confparse.h"
 #include "globopt.h"
+#include "lockprof.h"
 
 #define STR_HELPER(x) #x
 #define STR(x) STR_HELPER(x)
@@ -38,15 +40,30 @@ static struct crinitElosEventThread {
 /** Mutex synchronizing elos connection **/
 static pthread_mutex_t crinitEloslogSessionLock = PTHREAD_MUTEX_INITIALIZER;
 
-/** Ring buffer of elos event messages */
-static safuRingBuffer_t crinitElosEventBuffer;
-
-/** Mutex synchronizing access to the transmitter condition variable **/
+/**
+ * A buffered event with its payload stored in place.
+ */
+typedef struct crinitEloslogRecord {
+    struct timespec date;                       ///< Time the event has been logged at.
+    crinitElosSeverityE_t severity;             ///< The event severity.
+    uint64_t classification;                    ///< The event classification bitmask.
+    crinitElosEventMessageCodeE_t messageCode;  ///< The event message code.
+    char payload[CRINIT_ELOSLOG_PAYLOAD_MAX];   ///< The formatted event message.
+} crinitEloslogRecord_t;
+
+/** Mutex synchronizing access to the event buffer and the transmitter condition variable **/
 static pthread_mutex_t crinitEloslogTrCondLock = PTHREAD_MUTEX_INITIALIZER;
 /** Condition variable to block the transmitter thread until there are events to send **/
 static pthread_cond_t crinitEloslogTransmitCondition = PTHREAD_COND_INITIALIZER;
-/** Counter to account for condition variable signalling while it is not being waited on **/
-static int crinitEloslogTransmitCounter = 0;
+
+/** Preallocated ring of #CRINIT_ELOSLOG_EVENT_LIMIT buffered events, guarded by crinitEloslogTrCondLock **/
+static crinitEloslogRecord_t *crinitEloslogSlab = NULL;
+/** Index of the oldest buffered event in crinitEloslogSlab, guarded by crinitEloslogTrCondLock **/
+static size_t crinitEloslogHead = 0;
+/** Number of buffered events in crinitEloslogSlab, guarded by crinitEloslogTrCondLock **/
+static size_t crinitEloslogCount = 0;
+/** Counters of the event logging, guarded by crinitEloslogTrCondLock **/
+static crinitEloslogStats_t crinitEloslogStats;
 
 static inline int crinitFetchHWId(char *hwId) {
     FILE *fp = NULL;
@@ -73,105 +90,138 @@ static inline int crinitFetchHWId(char *hwId) {
     return 0;
 }
 
-static inline int crinitPublishEvent(void const *element, void const *data) {
-    CRINIT_PARAM_UNUSED(data);
-
-    int res;
-    char hwId[CRINIT_MACHINE_ID_LENGTH + 1] = {0};
-    crinitElosEvent_t *event = *(crinitElosEvent_t **)element;
-    crinitElosEventSource_t eventSource = {.appName = "crinit", .pid = 1};
-    event->source = eventSource;
-
-    crinitDbgInfoPrint("Publishing event to elos: '%s'", event->payload);
-
-    res = crinitFetchHWId(&hwId[0]);
-    if (res != 0) {
-        crinitErrPrint("Failed to fetch hardware id - continue.");
-    } else {
-        event->hardwareid = &hwId[0];
+/**
+ * Publish a batch of buffered events. Called with crinitEloslogSessionLock held.
+ *
+ * The events stay in the buffer, the caller needs to release them afterwards.
+ *
+ * @param session    The elos session.
+ * @param start      Index of the first event in crinitEloslogSlab.
+ * @param n          Number of events to publish.
+ * @param hwId       The hardware id to set in all events, may be NULL.
+ * @param published  Return pointer for the number of events which have been published successfully.
+ *
+ * @return SAFU_RESULT_OK if all events have been published, SAFU_RESULT_FAILED otherwise
+ */
+static safuResultE_t crinitEloslogPublishBatch(crinitElosSession_t *session, size_t start, size_t n, char *hwId,
+                                               size_t *published) {
+    safuResultE_t res = SAFU_RESULT_OK;
+    for (size_t i = 0; i < n; i++) {
+        const crinitEloslogRecord_t *r = &crinitEloslogSlab[(start + i) % CRINIT_ELOSLOG_EVENT_LIMIT];
+        crinitElosEvent_t event = {
+            .date = r->date,
+            .source = {.appName = "crinit", .pid = 1},
+            .severity = r->severity,
+            .hardwareid = hwId,
+            .classification = r->classification,
+            .messageCode = r->messageCode,
+            .payload = (char *)r->payload,
+        };
+        crinitDbgInfoPrint("Publishing event to elos: '%s'", event.payload);
+        if (crinitElosGetVTable()->eventPublish(session, &event) == SAFU_RESULT_OK) {
+            (*published)++;
+        } else {
+            res = SAFU_RESULT_FAILED;
+        }
     }
-
-    return crinitElosTryExec(crinitTinfo.session, &crinitEloslogSessionLock, crinitElosGetVTable()->eventPublish,
-                             "Failed to publish crinit event.", crinitTinfo.session, event);
+    return res;
 }
 
 static void *crinitEloslogEventTransmitter(void *arg) {
     CRINIT_PARAM_UNUSED(arg);
 
     int res;
-    safuVec_t events = {0};
     const char *version;
+    uint64_t reportedDrops = 0;
 
-    res = crinitElosTryExec(crinitTinfo.session, &crinitEloslogSessionLock, crinitElosGetVTable()->getVersion,
-                            "Failed to request elos version.", crinitTinfo.session, &version);
+    res = crinitElosTryExec(crinitTinfo.session, &crinitEloslogSessionLock, CRINIT_LOCK_ELOSLOG_SESSION,
+                            crinitElosGetVTable()->getVersion, "Failed to request elos version.", crinitTinfo.session,
+                            &version);
     if (res == SAFU_RESULT_OK) {
         crinitInfoPrint("Connected to elosd version %s for event transmission.", version);
     }
 
+    // The machine id does not change at runtime, so read it once instead of for every event.
+    char hwIdBuf[CRINIT_MACHINE_ID_LENGTH + 1] = {0};
+    char *hwId = hwIdBuf;
+    if (res == SAFU_RESULT_OK && crinitFetchHWId(hwIdBuf) != 0) {
+        crinitErrPrint("Failed to fetch hardware id - continue.");
+        hwId = NULL;
+    }
+
     while (1) {
         if (res != SAFU_RESULT_OK) {
             break;
         }
-        if ((errno = pthread_mutex_lock(&crinitElosActivatedLock)) != 0) {
+        if ((errno = crinitMutexLock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSLOG_ACTIVATED)) != 0) {
             crinitErrnoPrint("Failed to lock elos connection activation indicator.");
             break;
         }
         if (!crinitElosActivated) {
-            if ((errno = pthread_mutex_unlock(&crinitElosActivatedLock)) != 0) {
+            if ((errno = crinitMutexUnlock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSLOG_ACTIVATED)) != 0) {
                 crinitErrnoPrint("Failed to unlock elos connection activation indicator.");
             }
             break;
         }
-        if ((errno = pthread_mutex_unlock(&crinitElosActivatedLock)) != 0) {
+        if ((errno = crinitMutexUnlock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSLOG_ACTIVATED)) != 0) {
             crinitErrnoPrint("Failed to unlock elos connection activation indicator.");
             break;
         }
-        res = safuRingBufferRead(&crinitElosEventBuffer, &events, NULL);
-        if (res == SAFU_RESULT_OK) {
-            safuVecIterate(&events, crinitPublishEvent, NULL);
-            safuVecFree(&events);
-        } else {
-            crinitErrPrint("Initializing elos event buffer failed.");
-            break;
-        }
-        if ((errno = pthread_mutex_lock(&crinitEloslogTrCondLock)) != 0) {
+        if ((errno = crinitMutexLock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
             crinitErrnoPrint("Could not queue up for mutex lock on condition variable.");
             break;
         }
-
-        /*
-         * In case the TransmitCounter was incremented after the safuRingBufferRead(), we do another loop so we don't
-         * delay any events more than necessary. As the ringbuffer will return at least all events that have been
-         * enqueued up to here (or more), we can set the TransmitCounter to zero. As the transmit counter (as a
-         * condition predicate) is synched by the same mutex as the condition variable, we never miss anything (but we
-         * *may* do a single unnecessary additional loop with a ringbuffer check sometimes).
-         */
-        if (crinitEloslogTransmitCounter > 0) {
-            crinitEloslogTransmitCounter = 0;
-            if ((errno = pthread_mutex_unlock(&crinitEloslogTrCondLock)) != 0) {
-                crinitErrnoPrint("Failed to unlock condition variable mutex.");
+        // The number of buffered events is the condition predicate, so no signal sent in between is missed.
+        while (crinitEloslogCount == 0) {
+            if ((errno = crinitMutexCondWait(&crinitEloslogTransmitCondition, &crinitEloslogTrCondLock,
+                                             CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
+                crinitErrnoPrint("Could not wait for event transmit condition variable.");
+                break;
             }
-            continue;
         }
+        // The batch stays owned by the transmitter until it is released below, crinitElosLog() only appends.
+        size_t start = crinitEloslogHead, n = crinitEloslogCount;
+        if ((errno = crinitMutexUnlock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
+            crinitErrnoPrint("Failed to unlock condition variable mutex.");
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+
+        // Publish everything buffered so far while holding the session only once.
+        size_t published = 0;
+        crinitElosTryExec(crinitTinfo.session, &crinitEloslogSessionLock, CRINIT_LOCK_ELOSLOG_SESSION,
+                          crinitEloslogPublishBatch, "Failed to publish crinit events.", crinitTinfo.session, start, n,
+                          hwId, &published);
 
-        if ((errno = pthread_cond_wait(&crinitEloslogTransmitCondition, &crinitEloslogTrCondLock)) != 0) {
-            crinitErrnoPrint("Could not wait for event transmit condition variable.");
-            pthread_mutex_unlock(&crinitEloslogTrCondLock);
+        if ((errno = crinitMutexLock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
+            crinitErrnoPrint("Could not queue up for mutex lock on condition variable.");
             break;
         }
-        if ((errno = pthread_mutex_unlock(&crinitEloslogTrCondLock)) != 0) {
+        crinitEloslogHead = (crinitEloslogHead + n) % CRINIT_ELOSLOG_EVENT_LIMIT;
+        crinitEloslogCount -= n;
+        crinitEloslogStats.published += published;
+        crinitEloslogStats.failed += n - published;
+        crinitEloslogStats.batches++;
+        uint64_t dropped = crinitEloslogStats.dropped;
+        if ((errno = crinitMutexUnlock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
             crinitErrnoPrint("Failed to unlock condition variable mutex.");
             break;
         }
+        if (dropped != reportedDrops) {
+            crinitErrPrint("Dropped %" PRIu64 " elos events as the event buffer was full.", dropped - reportedDrops);
+            reportedDrops = dropped;
+        }
     }
 
-    if ((errno = pthread_mutex_lock(&crinitEloslogSessionLock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitEloslogSessionLock, CRINIT_LOCK_ELOSLOG_SESSION)) != 0) {
         crinitErrnoPrint("Failed to lock elos session.");
         return NULL;
     }
     free(crinitTinfo.session);
     crinitTinfo.session = NULL;
-    if ((errno = pthread_mutex_unlock(&crinitEloslogSessionLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&crinitEloslogSessionLock, CRINIT_LOCK_ELOSLOG_SESSION)) != 0) {
         crinitErrnoPrint("Failed to unlock elos session.");
     }
 
@@ -180,8 +230,6 @@ static void *crinitEloslogEventTransmitter(void *arg) {
 
 int crinitElosLog(crinitElosSeverityE_t severity, crinitElosEventMessageCodeE_t messageCode, uint64_t classification,
                   const char *format, ...) {
-    safuResultE_t result;
-    size_t bytes;
     bool sendEvents;
 
     if (crinitGlobOptGet(useElos, &sendEvents) == -1) {
@@ -194,82 +242,103 @@ int crinitElosLog(crinitElosSeverityE_t severity, crinitElosEventMessageCodeE_t
         return 0;
     }
 
-    // Else we can enqueue the event even if elos connection is not yet set up as long as the ring buffer is allocated
-    // which crinit will do early on. (Otherwise safuRingBufferWrite() will fail.)
-    crinitElosEvent_t *event = calloc(1, sizeof(*event));
-    if (event == NULL) {
-        crinitErrnoPrint("Failed to allocate memory for the elos event.");
+    // Else we can enqueue the event even if elos connection is not yet set up as long as the event buffer is allocated
+    // which crinit will do early on.
+    char payload[CRINIT_ELOSLOG_PAYLOAD_MAX];
+    va_list argp;
+    va_start(argp, format);
+    int len = vsnprintf(payload, sizeof(payload), format, argp);
+    va_end(argp);
+    if (len < 0) {
+        crinitErrnoPrint("Failed to format the elos event message.");
         return -1;
     }
 
-    va_list argp, argp2;
-    va_start(argp, format);
-    va_copy(argp2, argp);
-    bytes = vsnprintf(NULL, 0, format, argp) + 1;
-    event->payload = calloc(1, bytes);
-    if (event->payload == NULL) {
-        crinitErrnoPrint("Failed to allocate memory for the elos event message.");
-        va_end(argp);
-        va_end(argp2);
-        free(event);
-        return SAFU_RESULT_FAILED;
+    struct timespec date;
+    if (clock_gettime(CLOCK_REALTIME, &date) == -1) {
+        crinitErrnoPrint("Could not get wallclock time for event to transmit.");
+        return -1;
     }
 
-    vsnprintf(event->payload, bytes, format, argp2);
-    va_end(argp2);
+    crinitDbgInfoPrint("Enqueuing elos event: '%s'", payload);
 
-    if (clock_gettime(CLOCK_REALTIME, &event->date) == -1) {
-        crinitErrnoPrint("Could not get wallclock time for event to transmit.");
-        free(event->payload);
-        free(event);
-        return SAFU_RESULT_FAILED;
+    if ((errno = crinitMutexLock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock on condition variable.");
+        return -1;
     }
-    event->severity = severity;
-    event->classification = classification;
-    event->messageCode = messageCode;
-
-    crinitDbgInfoPrint("Enqueuing elos event: '%s'", event->payload);
-
-    result = safuRingBufferWrite(&crinitElosEventBuffer, event);
-    if (result != SAFU_RESULT_OK) {
-        crinitErrPrint("Writing to elos event buffer failed.");
-        free(event->payload);
-        free(event);
-        return result;
+    if (crinitEloslogSlab == NULL) {
+        crinitMutexUnlock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE);
+        crinitErrPrint("Elos event buffer has not been initialized.");
+        return -1;
+    }
+    if (crinitEloslogCount == CRINIT_ELOSLOG_EVENT_LIMIT) {
+        // Reported by the transmitter thread, which is the one able to do something about it.
+        crinitEloslogStats.dropped++;
+        crinitMutexUnlock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE);
+        return 0;
     }
 
-    if ((errno = pthread_mutex_lock(&crinitEloslogTrCondLock)) != 0) {
-        crinitErrnoPrint("Could not queue up for mutex lock on condition variable.");
-        return SAFU_RESULT_FAILED;
+    size_t slot = (crinitEloslogHead + crinitEloslogCount) % CRINIT_ELOSLOG_EVENT_LIMIT;
+    crinitEloslogRecord_t *r = &crinitEloslogSlab[slot];
+    r->date = date;
+    r->severity = severity;
+    r->classification = classification;
+    r->messageCode = messageCode;
+    memcpy(r->payload, payload, sizeof(payload));
+    crinitEloslogCount++;
+    crinitEloslogStats.enqueued++;
+    if ((size_t)len >= sizeof(payload)) {
+        crinitEloslogStats.truncated++;
     }
-    crinitEloslogTransmitCounter++;
+
     if ((errno = pthread_cond_signal(&crinitEloslogTransmitCondition)) != 0) {
         crinitErrnoPrint("Could not signal event transmit condition variable.");
-        pthread_mutex_unlock(&crinitEloslogTrCondLock);
-        return SAFU_RESULT_FAILED;
+        crinitMutexUnlock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE);
+        return -1;
     }
-    if ((errno = pthread_mutex_unlock(&crinitEloslogTrCondLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
         crinitErrnoPrint("Failed to unlock condition variable mutex.");
-        return SAFU_RESULT_FAILED;
+        return -1;
     }
 
-    return result;
+    return 0;
 }
 
 int crinitEloslogInit(void) {
-    int res;
+    int res = 0;
 
     crinitInfoPrint("Initializing elos event logging.");
 
-    /* If deleting entries, the ring buffer can just use free() */
-    const safuRingBufferParam_t ringBufferParams = {
-        /* .deleteEntries = true, */
-        .elements = CRINIT_ELOSLOG_EVENT_LIMIT,
-    };
+    if ((errno = crinitMutexLock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock on condition variable.");
+        return -1;
+    }
+    if (crinitEloslogSlab == NULL) {
+        crinitEloslogSlab = calloc(CRINIT_ELOSLOG_EVENT_LIMIT, sizeof(*crinitEloslogSlab));
+        if (crinitEloslogSlab == NULL) {
+            crinitErrnoPrint("Initializing elos event buffer failed.");
+            res = -1;
+        }
+    }
+    if ((errno = crinitMutexUnlock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
+        crinitErrnoPrint("Failed to unlock condition variable mutex.");
+        return -1;
+    }
 
-    res = safuRingBufferInitialize(&crinitElosEventBuffer, &ringBufferParams);
-    if (res != SAFU_RESULT_OK) {
-        crinitErrPrint("Initializing elos event buffer failed.");
+    return res;
+}
+
+int crinitEloslogGetStats(crinitEloslogStats_t *stats) {
+    crinitNullCheck(-1, stats);
+
+    if ((errno = crinitMutexLock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock on condition variable.");
+        return -1;
+    }
+    *stats = crinitEloslogStats;
+    stats->queued = crinitEloslogCount;
+    if ((errno = crinitMutexUnlock(&crinitEloslogTrCondLock, CRINIT_LOCK_ELOSLOG_QUEUE)) != 0) {
+        crinitErrnoPrint("Failed to unlock condition variable mutex.");
         return -1;
     }
 
@@ -279,7 +348,7 @@ int crinitEloslogInit(void) {
 int crinitEloslogActivate(bool e) {
     int res;
 
-    if ((errno = pthread_mutex_lock(&crinitElosActivatedLock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSLOG_ACTIVATED)) != 0) {
         crinitErrnoPrint("Failed to lock elos connection activation indicator.");
         return -1;
     }
@@ -328,7 +397,7 @@ int crinitEloslogActivate(bool e) {
 
     crinitElosActivated = e;
 
-    if ((errno = pthread_mutex_unlock(&crinitElosActivatedLock)) != 0) {
+    if ((errno = crinitMutexUnlock(&crinitElosActivatedLock, CRINIT_LOCK_ELOSLOG_ACTIVATED)) != 0) {
         crinitErrnoPrint("Failed to unlock elos connection activation indicator.");
         return -1;
     }
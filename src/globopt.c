@@ -6,9 +6,12 @@
 #include "globopt.h"
 
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 
 #include "common.h"
+#include "lockprof.h"
 #include "logio.h"
 
 /** Common error message for crinitGlobOptInitDefault(). **/
@@ -32,20 +35,77 @@
         return -1;                                                                      \
     }
 
+/**
+ * Common boilerplate to release a lock on the global option storage after only reading from it.
+ *
+ * In contrast to crinitGlobOptCommonUnlock(), this does not mark the snapshot as stale.
+ */
+#define crinitGlobOptCommonReadUnlock()                                          \
+    if ((errno = crinitMutexUnlock(&crinitOptLock, CRINIT_LOCK_GLOBOPT)) != 0) { \
+        crinitErrnoPrint("Could not unlock global option mutex.");               \
+        return -1;                                                               \
+    }
+
+/** An immutable, reference counted copy of the global option storage, see crinitGlobOptSnapshotAcquire(). **/
+typedef struct crinitGlobOptSnapshot {
+    crinitGlobOptStore_t opts;  ///< The copied options, needs to be the first member.
+    atomic_size_t refs;         ///< Number of references, one is held as long as the snapshot is the current one.
+    char strings[];             ///< Storage for the copied strings of crinitGlobOptSnapshot_t::opts.
+} crinitGlobOptSnapshot_t;
+
 /** Central global option storage. **/
 static crinitGlobOptStore_t crinitGlobOpts;
 /** Mutex to synchronize access to globOptArr **/
 static pthread_mutex_t crinitOptLock = PTHREAD_MUTEX_INITIALIZER;
 
+/** The current snapshot of crinitGlobOpts, NULL until the first call to crinitGlobOptSnapshotAcquire(). **/
+static _Atomic(crinitGlobOptSnapshot_t *) crinitGlobOptSnap = NULL;
+/** `true` if crinitGlobOpts may have changed since crinitGlobOptSnap was created. **/
+static atomic_bool crinitGlobOptSnapStale = true;
+/** Number of readers between loading crinitGlobOptSnap and taking a reference on it. **/
+static atomic_size_t crinitGlobOptSnapReaders = 0;
+
+/** Offsets of the string members of crinitGlobOptStore_t which are copied into a snapshot. **/
+static const size_t crinitGlobOptSnapStrings[] = {
+    offsetof(crinitGlobOptStore_t, sigKeyDir),      offsetof(crinitGlobOptStore_t, elosServer),
+    offsetof(crinitGlobOptStore_t, inclDir),        offsetof(crinitGlobOptStore_t, inclSuffix),
+    offsetof(crinitGlobOptStore_t, taskDir),        offsetof(crinitGlobOptStore_t, taskFileSuffix),
+    offsetof(crinitGlobOptStore_t, launcherCmd),    offsetof(crinitGlobOptStore_t, timerStateFile),
+#ifdef ENABLE_CAPABILITIES
+    offsetof(crinitGlobOptStore_t, defaultCaps),
+#endif
+};
+
+/**
+ * Create a new snapshot of crinitGlobOpts, needs to be called with crinitOptLock held.
+ *
+ * @return  The new snapshot with a reference count of one, NULL on error.
+ */
+static crinitGlobOptSnapshot_t *crinitGlobOptSnapshotCreate(void);
+/**
+ * Replace the current snapshot, needs to be called with crinitOptLock held.
+ *
+ * Waits until no reader is between loading crinitGlobOptSnap and taking its reference anymore before dropping the
+ * reference of the replaced snapshot, so a reader can never take a reference on a freed snapshot.
+ *
+ * @param snap  The new snapshot or NULL.
+ */
+static void crinitGlobOptSnapshotPublish(crinitGlobOptSnapshot_t *snap);
+
 int crinitGlobOptInitDefault(void) {
     crinitGlobOptCommonLock();
 
     crinitGlobOpts.debug = CRINIT_CONFIG_DEFAULT_DEBUG;
+    crinitSetDebugOutput(CRINIT_CONFIG_DEFAULT_DEBUG);
     crinitGlobOpts.useSyslog = CRINIT_CONFIG_DEFAULT_USE_SYSLOG;
     crinitGlobOpts.useElos = CRINIT_CONFIG_DEFAULT_USE_ELOS;
     crinitGlobOpts.elosEventPollInterval = CRINIT_CONFIG_DEFAULT_ELOS_EVENT_POLLING_TIME;
     crinitGlobOpts.elosPort = CRINIT_CONFIG_DEFAULT_ELOS_PORT;
     crinitGlobOpts.shdGraceP = CRINIT_CONFIG_DEFAULT_SHDGRACEP;
+    crinitGlobOpts.timerSlack = CRINIT_CONFIG_DEFAULT_TIMER_SLACK;
+    crinitGlobOpts.asyncLogRecords = CRINIT_CONFIG_DEFAULT_ASYNC_LOG_RECORDS;
+    // Disabled unless configured.
+    crinitGlobOpts.timerStateFile = NULL;
     crinitGlobOpts.taskDirFollowSl = CRINIT_CONFIG_DEFAULT_TASKDIR_SYMLINKS;
     crinitGlobOpts.signatures = CRINIT_CONFIG_DEFAULT_SIGNATURES;
 #ifdef ENABLE_CAPABILITIES
@@ -144,21 +204,22 @@ int crinitGlobOptSetString(size_t memberOffset, const char *val) {
 
 int crinitGlobOptGetString(size_t memberOffset, char **val) {
     crinitNullCheck(-1, val);
-    char *goptBase = (char *)&crinitGlobOpts;
-    char *src = *(char **)(goptBase + memberOffset);
 
-    if (crinitGlobOptBorrow() == NULL) {
-        crinitErrPrint("Could not geti exclusive access to global option storage.");
+    const crinitGlobOptStore_t *snap = crinitGlobOptSnapshotAcquire();
+    if (snap == NULL) {
+        crinitErrPrint("Could not get a snapshot of the global option storage.");
         return -1;
     }
+    const char *src = *(char *const *)((const char *)snap + memberOffset);
+    if (src == NULL) {
+        *val = NULL;
+        crinitGlobOptSnapshotRelease(snap);
+        return 0;
+    }
     *val = strdup(src);
+    crinitGlobOptSnapshotRelease(snap);
     if (*val == NULL) {
-        crinitErrnoPrint("Could not duplicate string to global option storage.");
-        crinitGlobOptRemit();
-        return -1;
-    }
-    if (crinitGlobOptRemit() == -1) {
-        crinitErrPrint("Could not release exclusive access to global option storage.");
+        crinitErrnoPrint("Could not duplicate string from global option storage.");
         return -1;
     }
     return 0;
@@ -170,6 +231,9 @@ int crinitGlobOptSetBoolean(size_t memberOffset, bool val) {
 
     crinitGlobOptCommonLock();
     *tgt = val;
+    if (memberOffset == offsetof(crinitGlobOptStore_t, CRINIT_GLOBOPT_DEBUG)) {
+        crinitSetDebugOutput(val);
+    }
     crinitGlobOptCommonUnlock();
 
     return 0;
@@ -177,11 +241,14 @@ int crinitGlobOptSetBoolean(size_t memberOffset, bool val) {
 
 int crinitGlobOptGetBoolean(size_t memberOffset, bool *val) {
     crinitNullCheck(-1, val);
-    char *goptBase = (char *)&crinitGlobOpts;
 
-    crinitGlobOptCommonLock();
-    *val = *(bool *)(goptBase + memberOffset);
-    crinitGlobOptCommonUnlock();
+    const crinitGlobOptStore_t *snap = crinitGlobOptSnapshotAcquire();
+    if (snap == NULL) {
+        crinitErrPrint("Could not get a snapshot of the global option storage.");
+        return -1;
+    }
+    *val = *(const bool *)((const char *)snap + memberOffset);
+    crinitGlobOptSnapshotRelease(snap);
 
     return 0;
 }
@@ -199,11 +266,14 @@ int crinitGlobOptSetInteger(size_t memberOffset, int val) {
 
 int crinitGlobOptGetInteger(size_t memberOffset, int *val) {
     crinitNullCheck(-1, val);
-    char *goptBase = (char *)&crinitGlobOpts;
 
-    crinitGlobOptCommonLock();
-    *val = *(int *)(goptBase + memberOffset);
-    crinitGlobOptCommonUnlock();
+    const crinitGlobOptStore_t *snap = crinitGlobOptSnapshotAcquire();
+    if (snap == NULL) {
+        crinitErrPrint("Could not get a snapshot of the global option storage.");
+        return -1;
+    }
+    *val = *(const int *)((const char *)snap + memberOffset);
+    crinitGlobOptSnapshotRelease(snap);
 
     return 0;
 }
@@ -221,11 +291,14 @@ int crinitGlobOptSetUnsignedLL(size_t memberOffset, unsigned long long val) {
 
 int crinitGlobOptGetUnsignedLL(size_t memberOffset, unsigned long long *val) {
     crinitNullCheck(-1, val);
-    char *goptBase = (char *)&crinitGlobOpts;
 
-    crinitGlobOptCommonLock();
-    *val = *(unsigned long long *)(goptBase + memberOffset);
-    crinitGlobOptCommonUnlock();
+    const crinitGlobOptStore_t *snap = crinitGlobOptSnapshotAcquire();
+    if (snap == NULL) {
+        crinitErrPrint("Could not get a snapshot of the global option storage.");
+        return -1;
+    }
+    *val = *(const unsigned long long *)((const char *)snap + memberOffset);
+    crinitGlobOptSnapshotRelease(snap);
 
     return 0;
 }
@@ -261,16 +334,16 @@ int crinitGlobOptGetEnvSet(size_t memberOffset, crinitEnvSet_t *val) {
 
     if (crinitEnvSetDup(val, src) == -1) {
         crinitErrPrint("Could not duplicate environment set from global option storage.");
-        crinitGlobOptCommonUnlock();
+        crinitGlobOptCommonReadUnlock();
         return -1;
     }
 
-    crinitGlobOptCommonUnlock();
+    crinitGlobOptCommonReadUnlock();
     return 0;
 }
 
 crinitGlobOptStore_t *crinitGlobOptBorrow(void) {
-    if ((errno = pthread_mutex_lock(&crinitOptLock)) == -1) {
+    if ((errno = crinitMutexLock(&crinitOptLock, CRINIT_LOCK_GLOBOPT)) == -1) {
         crinitErrnoPrint("Could not wait for global option array mutex lock.");
         return NULL;
     }
@@ -278,9 +351,11 @@ crinitGlobOptStore_t *crinitGlobOptBorrow(void) {
 }
 
 int crinitGlobOptRemit(void) {
+    // The caller may have changed anything in the storage.
+    atomic_store(&crinitGlobOptSnapStale, true);
     // This *could* be called from a thread which does not actually own the mutex, so we need to check if
     // pthread_mutex_unlock() fails.
-    errno = pthread_mutex_unlock(&crinitOptLock);
+    errno = crinitMutexUnlock(&crinitOptLock, CRINIT_LOCK_GLOBOPT);
     if (errno != 0) {
         crinitErrnoPrint("Could not unlock global option mutex.");
         return -1;
@@ -289,7 +364,7 @@ int crinitGlobOptRemit(void) {
 }
 
 void crinitGlobOptDestroy(void) {
-    if (pthread_mutex_lock(&crinitOptLock) == -1) {
+    if (crinitMutexLock(&crinitOptLock, CRINIT_LOCK_GLOBOPT) == -1) {
         crinitErrnoPrint("Could not wait for global option array mutex lock during deinitialization.");
         return;
     }
@@ -300,6 +375,7 @@ void crinitGlobOptDestroy(void) {
     free(crinitGlobOpts.sigKeyDir);
     free(crinitGlobOpts.elosServer);
     free(crinitGlobOpts.launcherCmd);
+    free(crinitGlobOpts.timerStateFile);
 #ifdef ENABLE_CAPABILITIES
     free(crinitGlobOpts.defaultCaps);
 #endif
@@ -320,5 +396,99 @@ void crinitGlobOptDestroy(void) {
 #endif
     crinitEnvSetDestroy(&crinitGlobOpts.globEnv);
     crinitEnvSetDestroy(&crinitGlobOpts.globFilters);
-    pthread_mutex_unlock(&crinitOptLock);
+    crinitGlobOptSnapshotPublish(NULL);
+    atomic_store(&crinitGlobOptSnapStale, true);
+    crinitMutexUnlock(&crinitOptLock, CRINIT_LOCK_GLOBOPT);
+}
+
+const crinitGlobOptStore_t *crinitGlobOptSnapshotAcquire(void) {
+    if (atomic_load(&crinitGlobOptSnapStale)) {
+        if ((errno = crinitMutexLock(&crinitOptLock, CRINIT_LOCK_GLOBOPT)) != 0) {
+            crinitErrnoPrint("Could not wait for global option array mutex lock.");
+            return NULL;
+        }
+        // Another thread may have been faster.
+        if (atomic_load(&crinitGlobOptSnapStale)) {
+            crinitGlobOptSnapshot_t *snap = crinitGlobOptSnapshotCreate();
+            if (snap == NULL) {
+                crinitMutexUnlock(&crinitOptLock, CRINIT_LOCK_GLOBOPT);
+                return NULL;
+            }
+            crinitGlobOptSnapshotPublish(snap);
+            // Not before publishing, a reader seeing the flag cleared would get the old snapshot otherwise. Writers
+            // set the flag while holding crinitOptLock, so no change can get lost in between.
+            atomic_store(&crinitGlobOptSnapStale, false);
+        }
+        crinitMutexUnlock(&crinitOptLock, CRINIT_LOCK_GLOBOPT);
+    }
+
+    atomic_fetch_add(&crinitGlobOptSnapReaders, 1);
+    crinitGlobOptSnapshot_t *snap = atomic_load(&crinitGlobOptSnap);
+    if (snap != NULL) {
+        atomic_fetch_add(&snap->refs, 1);
+    }
+    atomic_fetch_sub(&crinitGlobOptSnapReaders, 1);
+    return (snap != NULL) ? &snap->opts : NULL;
+}
+
+void crinitGlobOptSnapshotRelease(const crinitGlobOptStore_t *snap) {
+    if (snap == NULL) {
+        return;
+    }
+    crinitGlobOptSnapshot_t *s = (crinitGlobOptSnapshot_t *)snap;
+    if (atomic_fetch_sub(&s->refs, 1) == 1) {
+        free(s);
+    }
+}
+
+static crinitGlobOptSnapshot_t *crinitGlobOptSnapshotCreate(void) {
+    const char *goptBase = (const char *)&crinitGlobOpts;
+    size_t strSize = 0;
+    for (size_t i = 0; i < crinitNumElements(crinitGlobOptSnapStrings); i++) {
+        const char *str = *(char *const *)(goptBase + crinitGlobOptSnapStrings[i]);
+        if (str != NULL) {
+            strSize += strlen(str) + 1;
+        }
+    }
+
+    crinitGlobOptSnapshot_t *snap = malloc(sizeof(*snap) + strSize);
+    if (snap == NULL) {
+        crinitErrnoPrint("Could not allocate memory for a snapshot of the global option storage.");
+        return NULL;
+    }
+    memcpy(&snap->opts, &crinitGlobOpts, sizeof(snap->opts));
+    char *snapBase = (char *)&snap->opts;
+    char *strPos = snap->strings;
+    for (size_t i = 0; i < crinitNumElements(crinitGlobOptSnapStrings); i++) {
+        char **str = (char **)(snapBase + crinitGlobOptSnapStrings[i]);
+        if (*str != NULL) {
+            size_t len = strlen(*str) + 1;
+            memcpy(strPos, *str, len);
+            *str = strPos;
+            strPos += len;
+        }
+    }
+    // Members owning memory which is not copied.
+    snap->opts.tasks = NULL;
+    memset(&snap->opts.globEnv, 0, sizeof(snap->opts.globEnv));
+    memset(&snap->opts.globFilters, 0, sizeof(snap->opts.globFilters));
+#ifdef ENABLE_CGROUP
+    snap->opts.rootCgroup = NULL;
+    snap->opts.globCgroups = NULL;
+    snap->opts.globCgroupsCount = 0;
+#endif
+    atomic_init(&snap->refs, 1);
+    return snap;
+}
+
+static void crinitGlobOptSnapshotPublish(crinitGlobOptSnapshot_t *snap) {
+    crinitGlobOptSnapshot_t *old = atomic_exchange(&crinitGlobOptSnap, snap);
+    if (old == NULL) {
+        return;
+    }
+    // A reader may still be about to take a reference on the old snapshot, this is a matter of a few instructions.
+    while (atomic_load(&crinitGlobOptSnapReaders) != 0) {
+        sched_yield();
+    }
+    crinitGlobOptSnapshotRelease(&old->opts);
 }
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file lockprof.c
+ * @brief Implementation of the optional lock contention profiler.
+ */
+#include "lockprof.h"
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "trace.h"
+
+/** Size of the buffer holding the labels of a call site. **/
+#define CRINIT_LOCKPROF_LABELS_LEN 64
+
+/** Statistics of a single call site of a lock. **/
+typedef struct crinitLockProfSite {
+    const char *site;                         ///< The call site, compared by address.
+    char labels[CRINIT_LOCKPROF_LABELS_LEN];  ///< The `lock` and `site` labels of the metrics of the call site.
+    atomic_uint_fast64_t acquisitions;        ///< Number of times the lock has been acquired at the call site.
+    atomic_uint_fast64_t contentions;         ///< Number of acquisitions which had to wait for another thread.
+    atomic_uint_fast64_t waitNs;              ///< Total time spent waiting for the lock in nanoseconds.
+    atomic_uint_fast64_t holdNs;              ///< Total time the lock has been held in nanoseconds.
+} crinitLockProfSite_t;
+
+/** Statistics of a single lock. **/
+typedef struct crinitLockProfData {
+    crinitMetricsHistogram_t wait;  ///< Time spent waiting for the lock, including uncontended acquisitions.
+    crinitMetricsHistogram_t hold;  ///< Time the lock has been held.
+    /**
+     * Number of used elements in crinitLockProfData_t::sites, only ever increased while holding the lock. Published
+     * with release semantics after the new element has been filled in.
+     */
+    atomic_size_t numSites;
+    crinitLockProfSite_t sites[CRINIT_LOCKPROF_SITES];  ///< Statistics per call site.
+    uint64_t lockedAt;                                  ///< Time the lock was acquired, guarded by the lock itself.
+    crinitLockProfSite_t *holder;                       ///< Call site holding the lock, guarded by the lock itself.
+} crinitLockProfData_t;
+
+/** Names of the profiled locks, indexed by crinitLockId_t. **/
+static const char *const crinitLockProfNames[CRINIT_LOCKS] = {
+    [CRINIT_LOCK_TASKDB] = "taskdb",
+    [CRINIT_LOCK_LOG] = "log",
+    [CRINIT_LOCK_GLOBOPT] = "globopt",
+    [CRINIT_LOCK_REAPER] = "reaper",
+    [CRINIT_LOCK_TIMERDB] = "timerdb",
+    [CRINIT_LOCK_ELOSDEP_FILTERS] = "elosdep_filters",
+    [CRINIT_LOCK_ELOSDEP_SESSION] = "elosdep_session",
+    [CRINIT_LOCK_ELOSLOG_SESSION] = "eloslog_session",
+    [CRINIT_LOCK_ELOSDEP_TASK_FILTERS] = "elosdep_task_filters",
+    [CRINIT_LOCK_ELOSDEP_ACTIVATED] = "elosdep_activated",
+    [CRINIT_LOCK_ELOSLOG_ACTIVATED] = "eloslog_activated",
+    [CRINIT_LOCK_ELOSLOG_QUEUE] = "eloslog_queue",
+};
+/** Labels of the histograms of the profiled locks, indexed by crinitLockId_t. **/
+static char crinitLockProfLabels[CRINIT_LOCKS][CRINIT_LOCKPROF_LABELS_LEN];
+/** Call site all acquisitions are accounted to once crinitLockProfData_t::sites is full. **/
+static const char crinitLockProfOtherSite[] = "(other)";
+
+/** The statistics of all profiled locks. **/
+static crinitLockProfData_t crinitLockProfData[CRINIT_LOCKS];
+
+/**
+ * Look up the statistics of a call site, adding it if it is new.
+ *
+ * Caller must hold the lock.
+ *
+ * @param d     The statistics of the lock.
+ * @param id    The lock.
+ * @param site  The call site.
+ *
+ * @return  The statistics of \a site or of crinitLockProfOtherSite if there is no more room for new call sites.
+ */
+static crinitLockProfSite_t *crinitLockProfSiteGet(crinitLockProfData_t *d, crinitLockId_t id, const char *site);
+/**
+ * Record the hold time of a lock, caller must still hold the lock.
+ *
+ * @param d    The statistics of the lock.
+ * @param now  The current time in nanoseconds.
+ */
+static void crinitLockProfHoldEnd(crinitLockProfData_t *d, uint64_t now);
+
+int crinitLockProfLock(pthread_mutex_t *mutex, crinitLockId_t id, const char *site) {
+    uint64_t start = crinitTraceNow();
+    int ret = pthread_mutex_trylock(mutex);
+    bool contended = (ret == EBUSY);
+    if (contended) {
+        ret = pthread_mutex_lock(mutex);
+    }
+    if (ret != 0 || id >= CRINIT_LOCKS) {
+        return ret;
+    }
+
+    uint64_t now = crinitTraceNow();
+    uint64_t waitNs = (now > start) ? now - start : 0;
+    crinitLockProfData_t *d = &crinitLockProfData[id];
+    crinitMetricsHistogramAdd(&d->wait, waitNs);
+
+    crinitLockProfSite_t *s = crinitLockProfSiteGet(d, id, site);
+    atomic_fetch_add_explicit(&s->acquisitions, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->waitNs, waitNs, memory_order_relaxed);
+    if (contended) {
+        atomic_fetch_add_explicit(&s->contentions, 1, memory_order_relaxed);
+        crinitTraceSpan(CRINIT_TRACE_LOCK_WAIT, start, 0, "%s", crinitLockProfNames[id]);
+    }
+    d->lockedAt = now;
+    d->holder = s;
+    return 0;
+}
+
+int crinitLockProfUnlock(pthread_mutex_t *mutex, crinitLockId_t id) {
+    if (id < CRINIT_LOCKS) {
+        crinitLockProfHoldEnd(&crinitLockProfData[id], crinitTraceNow());
+    }
+    return pthread_mutex_unlock(mutex);
+}
+
+int crinitLockProfCondWait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime,
+                           crinitLockId_t id) {
+    if (id >= CRINIT_LOCKS) {
+        return (abstime == NULL) ? pthread_cond_wait(cond, mutex) : pthread_cond_timedwait(cond, mutex, abstime);
+    }
+
+    crinitLockProfData_t *d = &crinitLockProfData[id];
+    crinitLockProfSite_t *holder = d->holder;
+    crinitLockProfHoldEnd(d, crinitTraceNow());
+    int ret = (abstime == NULL) ? pthread_cond_wait(cond, mutex) : pthread_cond_timedwait(cond, mutex, abstime);
+    // The mutex is held again in any case, the hold continues to be accounted to the site which locked it.
+    d->lockedAt = crinitTraceNow();
+    d->holder = holder;
+    return ret;
+}
+
+size_t crinitLockProfRead(crinitMetricSample_t *out, size_t max) {
+    if (out == NULL) {
+        return 0;
+    }
+
+    size_t numSites[CRINIT_LOCKS];
+    for (size_t i = 0; i < CRINIT_LOCKS; i++) {
+        numSites[i] = atomic_load_explicit(&crinitLockProfData[i].numSites, memory_order_acquire);
+    }
+
+    // Keep all metrics of the same name together as required by the Prometheus text format.
+    size_t n = 0;
+    for (size_t i = 0; i < CRINIT_LOCKS && n < max; i++) {
+        if (numSites[i] > 0) {
+            crinitMetricsHistogramRead(&out[n++], &crinitLockProfData[i].wait, "crinit_lock_wait_seconds",
+                                       crinitLockProfLabels[i]);
+        }
+    }
+    for (size_t i = 0; i < CRINIT_LOCKS && n < max; i++) {
+        if (numSites[i] > 0) {
+            crinitMetricsHistogramRead(&out[n++], &crinitLockProfData[i].hold, "crinit_lock_hold_seconds",
+                                       crinitLockProfLabels[i]);
+        }
+    }
+
+    static const char *const siteMetricNames[CRINIT_LOCKPROF_SITE_METRICS] = {
+        "crinit_lock_site_acquisitions_total", "crinit_lock_site_contentions_total",
+        "crinit_lock_site_wait_nanoseconds_total", "crinit_lock_site_hold_nanoseconds_total"};
+    for (size_t m = 0; m < CRINIT_LOCKPROF_SITE_METRICS; m++) {
+        for (size_t i = 0; i < CRINIT_LOCKS; i++) {
+            for (size_t j = 0; j < numSites[i] && n < max; j++) {
+                crinitLockProfSite_t *s = &crinitLockProfData[i].sites[j];
+                atomic_uint_fast64_t *values[CRINIT_LOCKPROF_SITE_METRICS] = {&s->acquisitions, &s->contentions,
+                                                                              &s->waitNs, &s->holdNs};
+                out[n++] = (crinitMetricSample_t){.name = siteMetricNames[m],
+                                                  .labels = s->labels,
+                                                  .type = CRINIT_METRIC_COUNTER,
+                                                  .value = atomic_load_explicit(values[m], memory_order_relaxed)};
+            }
+        }
+    }
+    return n;
+}
+
+static crinitLockProfSite_t *crinitLockProfSiteGet(crinitLockProfData_t *d, crinitLockId_t id, const char *site) {
+    size_t n = atomic_load_explicit(&d->numSites, memory_order_relaxed);
+    for (size_t i = 0; i < n; i++) {
+        if (d->sites[i].site == site) {
+            return &d->sites[i];
+        }
+    }
+    if (n == CRINIT_LOCKPROF_SITES) {
+        return &d->sites[CRINIT_LOCKPROF_SITES - 1];
+    }
+
+    if (n == 0) {
+        snprintf(crinitLockProfLabels[id], CRINIT_LOCKPROF_LABELS_LEN, "lock=\"%s\"", crinitLockProfNames[id]);
+    }
+    // The last element is reserved for all call sites which do not fit anymore.
+    const char *label = crinitLockProfOtherSite;
+    if (n == CRINIT_LOCKPROF_SITES - 1) {
+        site = crinitLockProfOtherSite;
+    } else if (site == NULL) {
+        label = "(unknown)";
+    } else {
+        const char *base = strrchr(site, '/');
+        label = (base != NULL) ? base + 1 : site;
+    }
+
+    crinitLockProfSite_t *s = &d->sites[n];
+    s->site = site;
+    snprintf(s->labels, sizeof(s->labels), "lock=\"%s\",site=\"%s\"", crinitLockProfNames[id], label);
+    atomic_store_explicit(&d->numSites, n + 1, memory_order_release);
+    return s;
+}
+
+static void crinitLockProfHoldEnd(crinitLockProfData_t *d, uint64_t now) {
+    // A lock taken without crinitLockProfLock() has not been recorded, so there is nothing to end.
+    if (d->holder == NULL) {
+        return;
+    }
+    uint64_t holdNs = (now > d->lockedAt) ? now - d->lockedAt : 0;
+    crinitMetricsHistogramAdd(&d->hold, holdNs);
+    atomic_fetch_add_explicit(&d->holder->holdNs, holdNs, memory_order_relaxed);
+    d->holder = NULL;
+}
@@ -5,19 +5,28 @@
  */
 #include "logio.h"
 
+#include <limits.h>
 #include <locale.h>
 #include <pthread.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <syslog.h>
+#include <time.h>
 
+#include "common.h"
 #include "globopt.h"
+#include "lockprof.h"
 
 #define CRINIT_ERROR_WITH_FFL_FMT "(%s:%s:%d) Error: "  ///< Format string error prefix with function, file and line.
 #define CRINIT_ERRNO_FMT " Errno: %s"                   ///< Format string errno suffix, to use with strerror().
 #define CRINIT_SYSLOG_IDENT "crinit"                    ///< Identification string for crinit logging to syslog.
 
+#define CRINIT_LOG_WRITER_STACK_SIZE (PTHREAD_STACK_MIN + 112 * 1024)  ///< Stack size of the log writer thread.
+#define CRINIT_LOG_FLUSH_TIMEOUT_MS 2000  ///< Maximum time crinitLogFlush() waits for the writer thread.
+
 /** Holds the Prefix to put in front of every printed line, defaults to #CRINIT_PRINT_PREFIX **/
 static char crinitPrintPrefix[CRINIT_PRINT_PREFIX_MAX_LEN] = CRINIT_PRINT_PREFIX;
 
@@ -26,9 +35,45 @@ static FILE *crinitErrStream = NULL;   ///< holds the stream to use for error me
 
 static bool crinitUseSyslog = false;  ///< specifies if we should use syslog calls instead of FILE streams.
 
+atomic_bool crinitDbgOutputEnabled = CRINIT_CONFIG_DEFAULT_DEBUG;
+
 /** Mutex synchronizing print output (so that print statements are atomic wrt. to each other). **/
 static pthread_mutex_t crinitLogLock = PTHREAD_MUTEX_INITIALIZER;
 
+/** A preformatted message in the asynchronous log buffer. **/
+typedef struct crinitLogRecord {
+    atomic_size_t seq;               ///< Sequence number telling producers and the writer thread who owns the slot.
+    int prio;                        ///< Syslog priority of the message.
+    char msg[CRINIT_LOG_RECORD_MAX];  ///< The message without prefix and trailing newline.
+} crinitLogRecord_t;
+
+/**
+ * State of the asynchronous logging mode.
+ *
+ * The buffer is a bounded multi-producer/single-consumer ring. Every slot carries a sequence number. A producer claims
+ * the slot at position `head` by a compare-and-swap on `head` if the sequence number of the slot equals `head`, writes
+ * the record and publishes it by setting the sequence number to `head + 1`. The writer thread consumes the slot at
+ * position `tail` once its sequence number is `tail + 1` and hands it back to producers by setting it to
+ * `tail + size`. Neither side takes a lock as long as the writer thread is busy.
+ */
+static struct {
+    crinitLogRecord_t *ring;  ///< The record slots.
+    size_t mask;              ///< Number of slots minus one, the number of slots is a power of two.
+    atomic_size_t head;       ///< Position of the next slot to claim by a producer.
+    size_t tail;              ///< Position of the next slot to consume, only used by the writer thread.
+    atomic_size_t done;       ///< Number of records fully written out by the writer thread.
+    atomic_bool active;       ///< `true` once the writer thread runs.
+    atomic_bool sleeping;     ///< `true` while the writer thread waits for new records.
+    atomic_uint_fast64_t written;      ///< Statistics, see crinitLogStats_t.
+    atomic_uint_fast64_t dropped;      ///< Statistics, see crinitLogStats_t.
+    atomic_uint_fast64_t direct;       ///< Statistics, see crinitLogStats_t.
+    atomic_uint_fast64_t dropPending;  ///< Dropped messages not yet reported in the log.
+    pthread_mutex_t lock;              ///< Protects the sleep/wake-up handshake with the writer thread.
+    pthread_cond_t wake;               ///< Signalled if there are new records for a sleeping writer thread.
+    pthread_cond_t drained;            ///< Broadcast by the writer thread after each written batch.
+} crinitLogAsync = {.lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER,
+                    .drained = PTHREAD_COND_INITIALIZER};
+
 /**
  * Thread-safe implementation of strerror() using strerror_l().
  *
@@ -40,46 +85,82 @@ static pthread_mutex_t crinitLogLock = PTHREAD_MUTEX_INITIALIZER;
  */
 static char *crinitThreadSafeStrerror(int errnum);
 
+/**
+ * Format a message and put it into the asynchronous log buffer.
+ *
+ * The message is formatted on the stack by the calling thread. If the buffer is full, info and debug messages are
+ * dropped and counted while error messages are left to the caller to be written synchronously.
+ *
+ * @param prio    The syslog priority of the message.
+ * @param file    Source file to put in front of the message or NULL for no file/function/line header.
+ * @param func    Function to put in front of the message.
+ * @param line    Line to put in front of the message.
+ * @param errNum  Error number to append as text to the message or -1.
+ * @param format  The printf-style format string.
+ * @param args    The arguments for \a format.
+ *
+ * @return true if the message was handled (queued or dropped), false if the caller needs to write it synchronously
+ */
+static bool crinitLogAsyncPush(int prio, const char *file, const char *func, int line, int errNum, const char *format,
+                               va_list args);
+/**
+ * Write out a single message, needs to be called with crinitLogLock held.
+ *
+ * @param prio  The syslog priority of the message.
+ * @param msg   The message without prefix and trailing newline.
+ */
+static void crinitLogWriteRecord(int prio, const char *msg);
+/**
+ * Thread function of the asynchronous log writer.
+ *
+ * @param args  Unused.
+ *
+ * @return Does not return.
+ */
+static void *crinitLogWriterThread(void *args);
+
 void crinitSetPrintPrefix(const char *prefix) {
-    pthread_mutex_lock(&crinitLogLock);
+    crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
     strncpy(crinitPrintPrefix, (prefix == NULL) ? CRINIT_PRINT_PREFIX : prefix, CRINIT_PRINT_PREFIX_MAX_LEN);
-    pthread_mutex_unlock(&crinitLogLock);
+    crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
 }
 
 void crinitSetInfoStream(FILE *stream) {
-    pthread_mutex_lock(&crinitLogLock);
+    crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
     crinitInfoStream = (stream == NULL) ? stdout : stream;
-    pthread_mutex_unlock(&crinitLogLock);
+    crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
 }
 
 void crinitSetErrStream(FILE *stream) {
-    pthread_mutex_lock(&crinitLogLock);
+    crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
     crinitErrStream = (stream == NULL) ? stderr : stream;
-    pthread_mutex_unlock(&crinitLogLock);
+    crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
 }
 
 void crinitSetUseSyslog(bool sl) {
-    pthread_mutex_lock(&crinitLogLock);
+    crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
     if (sl && !crinitUseSyslog) {
         openlog(CRINIT_SYSLOG_IDENT, LOG_CONS, LOG_DAEMON);
     } else if (!sl && crinitUseSyslog) {
         closelog();
     }
     crinitUseSyslog = sl;
-    pthread_mutex_unlock(&crinitLogLock);
+    crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
 }
 
-void crinitDbgInfoPrint(const char *format, ...) {
-    bool globOptDbg = false;
-    if (crinitGlobOptGet(CRINIT_GLOBOPT_DEBUG, &globOptDbg) == -1) {
-        crinitErrPrint("Could not read value for \'DEBUG\' from global options, assuming default.");
-        globOptDbg = CRINIT_CONFIG_DEFAULT_DEBUG;
-    }
-    if (!globOptDbg) {
+void crinitSetDebugOutput(bool dbg) {
+    atomic_store_explicit(&crinitDbgOutputEnabled, dbg, memory_order_relaxed);
+}
+
+void crinitDbgInfoPrintUnchecked(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    bool handled = crinitLogAsyncPush(LOG_DEBUG, NULL, NULL, 0, -1, format, args);
+    va_end(args);
+    if (handled) {
         return;
     }
-    va_list args;
-    pthread_mutex_lock(&crinitLogLock);
+    crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
     if (crinitInfoStream == NULL) {
         crinitInfoStream = stdout;
     }
@@ -94,12 +175,18 @@ void crinitDbgInfoPrint(const char *format, ...) {
         va_end(args);
         fprintf(crinitInfoStream, "\n");
     }
-    pthread_mutex_unlock(&crinitLogLock);
+    crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
 }
 
 void crinitInfoPrint(const char *format, ...) {
     va_list args;
-    pthread_mutex_lock(&crinitLogLock);
+    va_start(args, format);
+    bool handled = crinitLogAsyncPush(LOG_INFO, NULL, NULL, 0, -1, format, args);
+    va_end(args);
+    if (handled) {
+        return;
+    }
+    crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
     if (crinitInfoStream == NULL) {
         crinitInfoStream = stdout;
     }
@@ -114,12 +201,18 @@ void crinitInfoPrint(const char *format, ...) {
         va_end(args);
         fprintf(crinitInfoStream, "\n");
     }
-    pthread_mutex_unlock(&crinitLogLock);
+    crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
 }
 
 void crinitErrPrintFFL(const char *file, const char *func, int line, const char *format, ...) {
     va_list args;
-    pthread_mutex_lock(&crinitLogLock);
+    va_start(args, format);
+    bool handled = crinitLogAsyncPush(LOG_ERR, file, func, line, -1, format, args);
+    va_end(args);
+    if (handled) {
+        return;
+    }
+    crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
     if (crinitErrStream == NULL) {
         crinitErrStream = stderr;
     }
@@ -127,6 +220,7 @@ void crinitErrPrintFFL(const char *file, const char *func, int line, const char
         size_t n = snprintf(NULL, 0, CRINIT_ERROR_WITH_FFL_FMT "%s", file, func, line, format) + 1;
         char *syslogFmt = malloc(n);
         if (syslogFmt == NULL) {
+            crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
             return;
         }
         snprintf(syslogFmt, n, CRINIT_ERROR_WITH_FFL_FMT "%s", file, func, line, format);
@@ -141,13 +235,19 @@ void crinitErrPrintFFL(const char *file, const char *func, int line, const char
         va_end(args);
         fprintf(crinitErrStream, "\n");
     }
-    pthread_mutex_unlock(&crinitLogLock);
+    crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
 }
 
 void crinitErrnoPrintFFL(const char *file, const char *func, int line, const char *format, ...) {
     va_list args;
     int locErrno = errno;
-    pthread_mutex_lock(&crinitLogLock);
+    va_start(args, format);
+    bool handled = crinitLogAsyncPush(LOG_ERR, file, func, line, locErrno, format, args);
+    va_end(args);
+    if (handled) {
+        return;
+    }
+    crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
     if (crinitErrStream == NULL) {
         crinitErrStream = stderr;
     }
@@ -157,6 +257,7 @@ void crinitErrnoPrintFFL(const char *file, const char *func, int line, const cha
                    1;
         char *syslogFmt = malloc(n);
         if (syslogFmt == NULL) {
+            crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
             return;
         }
         snprintf(syslogFmt, n, CRINIT_ERROR_WITH_FFL_FMT "%s" CRINIT_ERRNO_FMT, file, func, line, format,
@@ -173,24 +274,257 @@ void crinitErrnoPrintFFL(const char *file, const char *func, int line, const cha
         fprintf(crinitErrStream, CRINIT_ERRNO_FMT, crinitThreadSafeStrerror(locErrno));
         fprintf(crinitErrStream, "\n");
     }
-    pthread_mutex_unlock(&crinitLogLock);
+    crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
 }
 
 void crinitInitKmsgLogging(void) {
     FILE *kmsg = fopen("/dev/kmsg", "w");
     if (kmsg == NULL) {
-        pthread_mutex_lock(&crinitLogLock);
+        crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
         crinitInfoStream = stdout;
         crinitErrStream = stderr;
-        pthread_mutex_unlock(&crinitLogLock);
+        crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
         crinitErrnoPrint("Error openeing /dev/kmsg.");
         return;
     }
     setvbuf(kmsg, NULL, _IOLBF, 128);
-    pthread_mutex_lock(&crinitLogLock);
+    crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
     crinitInfoStream = kmsg;
     crinitErrStream = kmsg;
-    pthread_mutex_unlock(&crinitLogLock);
+    crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
+}
+
+int crinitLogAsyncStart(size_t records) {
+    if (records == 0 || records > CRINIT_LOG_ASYNC_RECORDS_MAX) {
+        crinitErrPrint("The number of asynchronous log records must be between 1 and %d.",
+                       CRINIT_LOG_ASYNC_RECORDS_MAX);
+        return -1;
+    }
+    if (atomic_load(&crinitLogAsync.active)) {
+        crinitErrPrint("Asynchronous logging is already active.");
+        return -1;
+    }
+
+    size_t size = 1;
+    while (size < records) {
+        size <<= 1;
+    }
+    crinitLogRecord_t *ring = calloc(size, sizeof(*ring));
+    if (ring == NULL) {
+        crinitErrnoPrint("Could not allocate memory for %zu log records.", size);
+        return -1;
+    }
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&ring[i].seq, i);
+    }
+    crinitLogAsync.ring = ring;
+    crinitLogAsync.mask = size - 1;
+    crinitLogAsync.tail = 0;
+    atomic_store(&crinitLogAsync.head, 0);
+    atomic_store(&crinitLogAsync.done, 0);
+
+    pthread_t writer;
+    pthread_attr_t attrs;
+    if (pthread_attr_init(&attrs) != 0) {
+        crinitErrPrint("Could not initialize pthread attributes.");
+        goto fail;
+    }
+    if (pthread_attr_setdetachstate(&attrs, PTHREAD_CREATE_DETACHED) != 0 ||
+        pthread_attr_setstacksize(&attrs, CRINIT_LOG_WRITER_STACK_SIZE) != 0) {
+        crinitErrPrint("Could not set pthread attributes for the log writer thread.");
+        pthread_attr_destroy(&attrs);
+        goto fail;
+    }
+    errno = pthread_create(&writer, &attrs, crinitLogWriterThread, NULL);
+    pthread_attr_destroy(&attrs);
+    if (errno != 0) {
+        crinitErrnoPrint("Could not create the log writer thread.");
+        goto fail;
+    }
+
+    atomic_store(&crinitLogAsync.active, true);
+    static bool flushRegistered = false;
+    if (!flushRegistered && atexit(crinitLogFlush) == 0) {
+        flushRegistered = true;
+    }
+    return 0;
+
+fail:
+    crinitLogAsync.ring = NULL;
+    free(ring);
+    return -1;
+}
+
+void crinitLogFlush(void) {
+    if (!atomic_load(&crinitLogAsync.active)) {
+        return;
+    }
+    size_t target = atomic_load(&crinitLogAsync.head);
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += CRINIT_LOG_FLUSH_TIMEOUT_MS / 1000;
+    deadline.tv_nsec += (CRINIT_LOG_FLUSH_TIMEOUT_MS % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&crinitLogAsync.lock);
+    while (atomic_load(&crinitLogAsync.done) < target) {
+        if (pthread_cond_timedwait(&crinitLogAsync.drained, &crinitLogAsync.lock, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&crinitLogAsync.lock);
+}
+
+void crinitLogGetStats(crinitLogStats_t *stats) {
+    if (stats == NULL) {
+        return;
+    }
+    stats->written = atomic_load(&crinitLogAsync.written);
+    stats->dropped = atomic_load(&crinitLogAsync.dropped);
+    stats->direct = atomic_load(&crinitLogAsync.direct);
+}
+
+/**
+ * Add the return value of a snprintf()-like call to the length of a string, clamped to the size of its buffer.
+ *
+ * @param len   The current length of the string.
+ * @param n     The return value of the snprintf()-like call appending to the string.
+ * @param size  The size of the buffer holding the string.
+ *
+ * @return The new length of the string.
+ */
+static inline size_t crinitLogAdvance(size_t len, int n, size_t size) {
+    if (n < 0) {
+        return len;
+    }
+    return (len + (size_t)n < size) ? len + (size_t)n : size - 1;
+}
+
+static bool crinitLogAsyncPush(int prio, const char *file, const char *func, int line, int errNum, const char *format,
+                               va_list args) {
+    if (!atomic_load_explicit(&crinitLogAsync.active, memory_order_acquire)) {
+        return false;
+    }
+
+    char msg[CRINIT_LOG_RECORD_MAX] = {'\0'};
+    size_t len = 0;
+    if (file != NULL) {
+        len = crinitLogAdvance(len, snprintf(msg, sizeof(msg), CRINIT_ERROR_WITH_FFL_FMT, file, func, line),
+                               sizeof(msg));
+    }
+    len = crinitLogAdvance(len, vsnprintf(msg + len, sizeof(msg) - len, format, args), sizeof(msg));
+    if (errNum != -1) {
+        const char *errStr = crinitThreadSafeStrerror(errNum);
+        len = crinitLogAdvance(len, snprintf(msg + len, sizeof(msg) - len, CRINIT_ERRNO_FMT, errStr), sizeof(msg));
+    }
+
+    crinitLogRecord_t *rec = NULL;
+    size_t pos = atomic_load_explicit(&crinitLogAsync.head, memory_order_relaxed);
+    while (rec == NULL) {
+        crinitLogRecord_t *slot = &crinitLogAsync.ring[pos & crinitLogAsync.mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&crinitLogAsync.head, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                rec = slot;
+            }
+        } else if (diff < 0) {
+            // The writer thread has not yet consumed the record a full round ago, the buffer is full.
+            if (prio == LOG_ERR) {
+                atomic_fetch_add(&crinitLogAsync.direct, 1);
+                return false;
+            }
+            atomic_fetch_add(&crinitLogAsync.dropped, 1);
+            atomic_fetch_add(&crinitLogAsync.dropPending, 1);
+            return true;
+        } else {
+            pos = atomic_load_explicit(&crinitLogAsync.head, memory_order_relaxed);
+        }
+    }
+
+    rec->prio = prio;
+    memcpy(rec->msg, msg, len + 1);
+    atomic_store(&rec->seq, pos + 1);
+    if (atomic_load(&crinitLogAsync.sleeping)) {
+        pthread_mutex_lock(&crinitLogAsync.lock);
+        pthread_cond_signal(&crinitLogAsync.wake);
+        pthread_mutex_unlock(&crinitLogAsync.lock);
+    }
+    return true;
+}
+
+static void crinitLogWriteRecord(int prio, const char *msg) {
+    if (crinitUseSyslog) {
+        syslog(prio | LOG_DAEMON, "%s", msg);
+        return;
+    }
+    if (prio == LOG_ERR) {
+        if (crinitErrStream == NULL) {
+            crinitErrStream = stderr;
+        }
+        fprintf(crinitErrStream, "%s%s\n", crinitPrintPrefix, msg);
+    } else {
+        if (crinitInfoStream == NULL) {
+            crinitInfoStream = stdout;
+        }
+        fprintf(crinitInfoStream, "%s%s\n", crinitPrintPrefix, msg);
+    }
+}
+
+static void *crinitLogWriterThread(void *args) {
+    CRINIT_PARAM_UNUSED(args);
+    for (;;) {
+        size_t n = 0;
+        for (;;) {
+            crinitLogRecord_t *rec = &crinitLogAsync.ring[crinitLogAsync.tail & crinitLogAsync.mask];
+            if (atomic_load_explicit(&rec->seq, memory_order_acquire) != crinitLogAsync.tail + 1) {
+                break;
+            }
+            // Take the lock per record so a synchronous write of an error does not wait for the whole batch.
+            crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
+            crinitLogWriteRecord(rec->prio, rec->msg);
+            crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
+            atomic_store_explicit(&rec->seq, crinitLogAsync.tail + crinitLogAsync.mask + 1, memory_order_release);
+            crinitLogAsync.tail++;
+            n++;
+        }
+        crinitMutexLock(&crinitLogLock, CRINIT_LOCK_LOG);
+        uint_fast64_t dropped = atomic_exchange(&crinitLogAsync.dropPending, 0);
+        if (dropped > 0) {
+            char msg[CRINIT_LOG_RECORD_MAX];
+            snprintf(msg, sizeof(msg), "Dropped %llu log message(s), the log buffer was full.",
+                     (unsigned long long)dropped);
+            crinitLogWriteRecord(LOG_WARNING, msg);
+        }
+        if ((n > 0 || dropped > 0) && !crinitUseSyslog) {
+            if (crinitInfoStream != NULL) {
+                fflush(crinitInfoStream);
+            }
+            if (crinitErrStream != NULL) {
+                fflush(crinitErrStream);
+            }
+        }
+        crinitMutexUnlock(&crinitLogLock, CRINIT_LOCK_LOG);
+        atomic_fetch_add(&crinitLogAsync.written, n);
+
+        pthread_mutex_lock(&crinitLogAsync.lock);
+        atomic_store(&crinitLogAsync.done, crinitLogAsync.tail);
+        pthread_cond_broadcast(&crinitLogAsync.drained);
+        if (n == 0) {
+            atomic_store(&crinitLogAsync.sleeping, true);
+            crinitLogRecord_t *next = &crinitLogAsync.ring[crinitLogAsync.tail & crinitLogAsync.mask];
+            if (atomic_load(&next->seq) != crinitLogAsync.tail + 1 && atomic_load(&crinitLogAsync.dropPending) == 0) {
+                pthread_cond_wait(&crinitLogAsync.wake, &crinitLogAsync.lock);
+            }
+            atomic_store(&crinitLogAsync.sleeping, false);
+        }
+        pthread_mutex_unlock(&crinitLogAsync.lock);
+    }
+    return NULL;
 }
 
 static char *crinitThreadSafeStrerror(int errNum) {
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file metrics.c
+ * @brief Implementation of the internal metrics registry.
+ */
+#include "metrics.h"
+
+/** Macro to generate the `opcode` label of the IPC request latency histogram of a command for crinitGenOpMap(). **/
+#define crinitGenOpLabel(x) "opcode=\"" #x "\"",
+
+/** Upper bounds of the histogram buckets in nanoseconds. **/
+static const uint64_t crinitMetricsBounds[CRINIT_METRIC_BUCKETS - 1] = CRINIT_METRIC_BUCKET_BOUNDS_NS;
+
+/** Names of the histograms, indexed by crinitMetricHisto_t. **/
+static const char *const crinitMetricsHistoNames[CRINIT_METRIC_HISTOS] = {
+    [CRINIT_METRIC_SPAWN_LATENCY] = "crinit_spawn_latency_seconds",
+    [CRINIT_METRIC_TASKDB_LOCK_WAIT] = "crinit_taskdb_lock_wait_seconds",
+    [CRINIT_METRIC_TASKDB_LOCK_HOLD] = "crinit_taskdb_lock_hold_seconds",
+};
+/** Names of the counters, indexed by crinitMetricCounter_t. **/
+static const char *const crinitMetricsCounterNames[CRINIT_METRIC_COUNTERS] = {
+    [CRINIT_METRIC_RESPAWNS] = "crinit_respawns_total",
+};
+/** Labels of the IPC request latency histograms, indexed by command. **/
+static const char *const crinitMetricsIpcLabels[CRINIT_RTIMCMD_NUM_CMDS] = {crinitGenOpMap(crinitGenOpLabel)};
+
+/** The histograms of the registry. **/
+static crinitMetricsHistogram_t crinitMetricsHistos[CRINIT_METRIC_HISTOS];
+/** The IPC request latency histograms, one per command. **/
+static crinitMetricsHistogram_t crinitMetricsIpcHistos[CRINIT_RTIMCMD_NUM_CMDS];
+/** The counters of the registry. **/
+static atomic_uint_fast64_t crinitMetricsCounters[CRINIT_METRIC_COUNTERS];
+
+void crinitMetricsCount(crinitMetricCounter_t c) {
+    if (c >= CRINIT_METRIC_COUNTERS) {
+        return;
+    }
+    atomic_fetch_add_explicit(&crinitMetricsCounters[c], 1, memory_order_relaxed);
+}
+
+void crinitMetricsObserve(crinitMetricHisto_t h, uint64_t ns) {
+    if (h >= CRINIT_METRIC_HISTOS) {
+        return;
+    }
+    crinitMetricsHistogramAdd(&crinitMetricsHistos[h], ns);
+}
+
+void crinitMetricsObserveIpc(crinitRtimOp_t op, uint64_t ns) {
+    // Each command has an even command opcode followed by its response opcode.
+    size_t cmdIdx = (size_t)op / 2;
+    if (cmdIdx >= CRINIT_RTIMCMD_NUM_CMDS) {
+        return;
+    }
+    crinitMetricsHistogramAdd(&crinitMetricsIpcHistos[cmdIdx], ns);
+}
+
+size_t crinitMetricsRead(crinitMetricSample_t *out, size_t max) {
+    if (out == NULL) {
+        return 0;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < CRINIT_METRIC_HISTOS && n < max; i++) {
+        crinitMetricsHistogramRead(&out[n++], &crinitMetricsHistos[i], crinitMetricsHistoNames[i], NULL);
+    }
+    for (size_t i = 0; i < CRINIT_RTIMCMD_NUM_CMDS && n < max; i++) {
+        crinitMetricsHistogramRead(&out[n++], &crinitMetricsIpcHistos[i], "crinit_ipc_request_seconds",
+                                   crinitMetricsIpcLabels[i]);
+    }
+    for (size_t i = 0; i < CRINIT_METRIC_COUNTERS && n < max; i++) {
+        crinitMetricSample_t *s = &out[n++];
+        *s = (crinitMetricSample_t){.name = crinitMetricsCounterNames[i], .type = CRINIT_METRIC_COUNTER};
+        s->value = atomic_load_explicit(&crinitMetricsCounters[i], memory_order_relaxed);
+    }
+    return n;
+}
+
+void crinitMetricsHistogramAdd(crinitMetricsHistogram_t *h, uint64_t ns) {
+    size_t b = 0;
+    while (b < CRINIT_METRIC_BUCKETS - 1 && ns > crinitMetricsBounds[b]) {
+        b++;
+    }
+    atomic_fetch_add_explicit(&h->buckets[b], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum, ns, memory_order_relaxed);
+}
+
+void crinitMetricsHistogramRead(crinitMetricSample_t *out, crinitMetricsHistogram_t *h, const char *name,
+                                const char *labels) {
+    out->name = name;
+    out->labels = labels;
+    out->type = CRINIT_METRIC_HISTOGRAM;
+    out->value = atomic_load_explicit(&h->sum, memory_order_relaxed);
+    for (size_t i = 0; i < CRINIT_METRIC_BUCKETS; i++) {
+        out->buckets[i] = atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+    }
+}
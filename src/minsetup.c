@@ -5,35 +5,13 @@
  */
 #include "minsetup.h"
 
-#include <stdbool.h>
 #include <sys/mount.h>
 #include <sys/stat.h>
 #include <sys/types.h>
-#include <sys/wait.h>
 #include <unistd.h>
 
 #include "logio.h"
 
-int crinitForkZombieReaper(void) {
-    pid_t pid = fork();
-    if (pid == -1) {
-        crinitErrnoPrint("Could not fork to create a PID 1 zombie reaper parent.");
-        return -1;
-    }
-    if (pid != 0) {  // parent process (must be PID 1)
-        // lose in-/output
-        close(STDOUT_FILENO);
-        close(STDERR_FILENO);
-        close(STDIN_FILENO);
-        // becomes reaper of zombie processes
-        while (true) {
-            wait(NULL);
-        }
-    }
-    // child returns
-    return 0;
-}
-
 int crinitMountDevtmpfs(void) {
     umask(0);
 
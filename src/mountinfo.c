@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file mountinfo.c
+ * @brief Implementation of reading the tree of mounted filesystems from `/proc/self/mountinfo`.
+ */
+#include "mountinfo.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "logio.h"
+
+/** Initial number of mounts to allocate space for in crinitMountTreeParse(). **/
+#define CRINIT_MOUNTINFO_INITIAL_CAP 32
+
+/** Index of the mount point field in a mountinfo line. **/
+#define CRINIT_MOUNTINFO_FIELD_TARGET 4
+/** Index of the per-mount options field in a mountinfo line. **/
+#define CRINIT_MOUNTINFO_FIELD_OPTS 5
+
+/**
+ * Mapping from mount ID to array index, used to resolve parents.
+ */
+typedef struct crinitMountIdIdx {
+    int mountId;  ///< The mount ID.
+    size_t idx;   ///< Index of the mount in crinitMountTree_t::mounts.
+} crinitMountIdIdx_t;
+
+/**
+ * Parse a single line of a mountinfo file.
+ *
+ * On success, crinitMountEntry_t::target points to a single allocated buffer also holding crinitMountEntry_t::fsType
+ * and crinitMountEntry_t::source.
+ *
+ * @param out   Return pointer for the parsed mount, parent/child relationships are not filled in.
+ * @param line  The line to parse, will be modified.
+ *
+ * @return  0 on success, -1 otherwise
+ */
+static int crinitMountEntryParse(crinitMountEntry_t *out, char *line);
+/**
+ * Resolve octal escape sequences of the form `\ooo` in place.
+ *
+ * @param str  The string to unescape.
+ */
+static void crinitMountInfoUnescape(char *str);
+/**
+ * Fill in crinitMountEntry_t::parent and crinitMountEntry_t::numChld for all mounts of a tree.
+ *
+ * @param tree  The mount tree.
+ *
+ * @return  0 on success, -1 otherwise
+ */
+static int crinitMountTreeLink(crinitMountTree_t *tree);
+/**
+ * Comparison function for crinitMountIdIdx_t by mount ID, for use with qsort() and bsearch().
+ */
+static int crinitMountIdIdxCmp(const void *a, const void *b);
+
+int crinitMountTreeParse(crinitMountTree_t *tree, FILE *stream) {
+    crinitNullCheck(-1, tree, stream);
+
+    tree->mounts = NULL;
+    tree->numMounts = 0;
+    size_t cap = 0;
+    char *line = NULL;
+    size_t lineSize = 0;
+
+    while (getline(&line, &lineSize, stream) != -1) {
+        if (tree->numMounts == cap) {
+            size_t newCap = (cap == 0) ? CRINIT_MOUNTINFO_INITIAL_CAP : cap * 2;
+            crinitMountEntry_t *newMounts = realloc(tree->mounts, newCap * sizeof(*newMounts));
+            if (newMounts == NULL) {
+                crinitErrnoPrint("Could not allocate memory for %zu mount entries.", newCap);
+                goto fail;
+            }
+            tree->mounts = newMounts;
+            cap = newCap;
+        }
+        if (crinitMountEntryParse(&tree->mounts[tree->numMounts], line) == -1) {
+            crinitErrPrint("Could not parse mountinfo entry. Skipping.");
+            continue;
+        }
+        tree->numMounts++;
+    }
+    if (ferror(stream)) {
+        crinitErrPrint("Could not read mountinfo.");
+        goto fail;
+    }
+
+    if (crinitMountTreeLink(tree) == -1) {
+        crinitErrPrint("Could not determine the hierarchy of mounted filesystems.");
+        goto fail;
+    }
+    free(line);
+    return 0;
+
+fail:
+    free(line);
+    crinitMountTreeDestroy(tree);
+    return -1;
+}
+
+void crinitMountTreeDestroy(crinitMountTree_t *tree) {
+    if (tree == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < tree->numMounts; i++) {
+        free(tree->mounts[i].target);
+    }
+    free(tree->mounts);
+    tree->mounts = NULL;
+    tree->numMounts = 0;
+}
+
+static int crinitMountEntryParse(crinitMountEntry_t *out, char *line) {
+    char *strtokState = NULL;
+    char *target = NULL, *fsType = NULL, *source = NULL;
+    bool haveIds = false, sepFound = false;
+    size_t field = 0;
+
+    for (char *tok = strtok_r(line, " \n", &strtokState); tok != NULL; tok = strtok_r(NULL, " \n", &strtokState)) {
+        if (sepFound) {
+            if (fsType == NULL) {
+                fsType = tok;
+            } else if (source == NULL) {
+                source = tok;
+            }
+            continue;
+        }
+        switch (field) {
+            case 0:
+                out->mountId = (int)strtol(tok, NULL, 10);
+                break;
+            case 1:
+                out->parentId = (int)strtol(tok, NULL, 10);
+                haveIds = true;
+                break;
+            case CRINIT_MOUNTINFO_FIELD_TARGET:
+                target = tok;
+                break;
+            case CRINIT_MOUNTINFO_FIELD_OPTS:
+                out->readOnly = strcmp(tok, "ro") == 0 || strncmp(tok, "ro,", 3) == 0;
+                break;
+            default:
+                // Optional fields are terminated by a single hyphen.
+                sepFound = field > CRINIT_MOUNTINFO_FIELD_OPTS && strcmp(tok, "-") == 0;
+                break;
+        }
+        field++;
+    }
+    if (!haveIds || target == NULL || source == NULL) {
+        crinitErrPrint("Mountinfo entry is incomplete.");
+        return -1;
+    }
+
+    crinitMountInfoUnescape(target);
+    crinitMountInfoUnescape(source);
+    size_t targetLen = strlen(target) + 1, fsTypeLen = strlen(fsType) + 1, sourceLen = strlen(source) + 1;
+    out->target = malloc(targetLen + fsTypeLen + sourceLen);
+    if (out->target == NULL) {
+        crinitErrnoPrint("Could not allocate memory for mountinfo entry.");
+        return -1;
+    }
+    out->fsType = out->target + targetLen;
+    out->source = out->fsType + fsTypeLen;
+    memcpy(out->target, target, targetLen);
+    memcpy(out->fsType, fsType, fsTypeLen);
+    memcpy(out->source, source, sourceLen);
+    out->parent = CRINIT_MOUNTINFO_NO_PARENT;
+    out->numChld = 0;
+    return 0;
+}
+
+static void crinitMountInfoUnescape(char *str) {
+    char *out = str;
+    while (*str != '\0') {
+        if (str[0] == '\\' && str[1] >= '0' && str[1] <= '3' && str[2] >= '0' && str[2] <= '7' && str[3] >= '0' &&
+            str[3] <= '7') {
+            *out++ = (char)(((str[1] - '0') << 6) | ((str[2] - '0') << 3) | (str[3] - '0'));
+            str += 4;
+        } else {
+            *out++ = *str++;
+        }
+    }
+    *out = '\0';
+}
+
+static int crinitMountTreeLink(crinitMountTree_t *tree) {
+    if (tree->numMounts == 0) {
+        return 0;
+    }
+    crinitMountIdIdx_t *ids = malloc(tree->numMounts * sizeof(*ids));
+    if (ids == NULL) {
+        crinitErrnoPrint("Could not allocate memory for mount ID index.");
+        return -1;
+    }
+    for (size_t i = 0; i < tree->numMounts; i++) {
+        ids[i].mountId = tree->mounts[i].mountId;
+        ids[i].idx = i;
+    }
+    qsort(ids, tree->numMounts, sizeof(*ids), crinitMountIdIdxCmp);
+
+    for (size_t i = 0; i < tree->numMounts; i++) {
+        crinitMountEntry_t *m = &tree->mounts[i];
+        if (m->parentId == m->mountId) {
+            continue;
+        }
+        crinitMountIdIdx_t key = {.mountId = m->parentId};
+        const crinitMountIdIdx_t *p = bsearch(&key, ids, tree->numMounts, sizeof(*ids), crinitMountIdIdxCmp);
+        if (p != NULL) {
+            m->parent = p->idx;
+            tree->mounts[p->idx].numChld++;
+        }
+    }
+    free(ids);
+    return 0;
+}
+
+static int crinitMountIdIdxCmp(const void *a, const void *b) {
+    int idA = ((const crinitMountIdIdx_t *)a)->mountId;
+    int idB = ((const crinitMountIdIdx_t *)b)->mountId;
+    return (idA > idB) - (idA < idB);
+}
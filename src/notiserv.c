@@ -21,8 +21,11 @@
 #include "eloslog.h"
 #endif
 #include "logio.h"
+#include "metrics.h"
 #include "rtimcmd.h"
 #include "thrpool.h"
+#include "trace.h"
+#include "usdt.h"
 
 #ifndef SYS_gettid
 #error "SYS_gettid unavailable on this system"
@@ -205,6 +208,10 @@ int crinitStartInterfaceServer(crinitTaskDB_t *ctx, const char *sockFile) {
     return 0;
 }
 
+int crinitInterfaceServerGetStats(size_t *poolSize, size_t *threadAvail) {
+    return crinitThreadPoolGetStats(&crinitWorkers, poolSize, threadAvail);
+}
+
 static inline int crinitMkdirp(char *pathName, mode_t mode) {
     if (pathName == NULL) {
         crinitErrPrint("Input path name must not be NULL");
@@ -288,6 +295,7 @@ static void *crinitConnThread(void *args) {
             close(connSockFd);
             continue;
         }
+        uint64_t reqStart = crinitTraceNow();
 
         crinitDbgInfoPrint("(TID %d) Received string \'%s\' from client.", threadId, clientMsg);
         crinitDbgInfoPrint("(TID %d) Received following credentials from peer process: PID=%d, UID=%d, GID=%d",
@@ -301,6 +309,8 @@ static void *crinitConnThread(void *args) {
             continue;
         }
         free(clientMsg);
+        crinitRtimOp_t reqOp = cmd.op;
+        crinitProbe3(ipc_begin, (int)cmd.op, msgCreds.pid, (cmd.argc > 0) ? cmd.args[0] : "");
         if (!crinitCheckPerm(cmd.op, &msgCreds)) {
             crinitErrPrint("(TID %d) Client does not have permission to issue command.", threadId);
 #ifdef ENABLE_ELOS
@@ -342,6 +352,9 @@ static void *crinitConnThread(void *args) {
 
         free(resStr);
         close(connSockFd);
+        uint64_t reqDur = crinitTraceNow() - reqStart;
+        crinitMetricsObserveIpc(reqOp, reqDur);
+        crinitProbe3(ipc_end, (int)reqOp, msgCreds.pid, reqDur);
         crinitThreadPoolThreadAvailCallback(a->tpRef);
     }
     return NULL;
@@ -518,6 +531,10 @@ static inline bool crinitCheckPerm(crinitRtimOp_t op, const struct ucred *passed
         case CRINIT_RTIMCMD_C_STATUS:
         case CRINIT_RTIMCMD_C_TASKLIST:
         case CRINIT_RTIMCMD_C_GETVER:
+        case CRINIT_RTIMCMD_C_GRAPH:
+        case CRINIT_RTIMCMD_C_TRACE:
+        case CRINIT_RTIMCMD_C_STATS:
+        case CRINIT_RTIMCMD_C_USAGE:
             return true;
         case CRINIT_RTIMCMD_C_SHUTDOWN:
             if (crinitProcCapget(capdata, passedCreds->pid) == -1) {
@@ -537,6 +554,10 @@ static inline bool crinitCheckPerm(crinitRtimOp_t op, const struct ucred *passed
         case CRINIT_RTIMCMD_R_TASKLIST:
         case CRINIT_RTIMCMD_R_GETVER:
         case CRINIT_RTIMCMD_R_SHUTDOWN:
+        case CRINIT_RTIMCMD_R_GRAPH:
+        case CRINIT_RTIMCMD_R_TRACE:
+        case CRINIT_RTIMCMD_R_STATS:
+        case CRINIT_RTIMCMD_R_USAGE:
         default:
             crinitErrPrint("Unknown or unsupported opcode.");
             return false;
@@ -3,17 +3,21 @@
  * @file procdip.c
  * @brief Implementation of the Process Dispatcher.
  */
+#define _GNU_SOURCE  ///< Needed for cpu_set_t and sched_setaffinity().
 #include "procdip.h"
 
+#include <sched.h>
 #include <spawn.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include "reaper.h"
 #include "timerdb.h"
 
 #ifdef ENABLE_CAPABILITIES
@@ -24,6 +28,9 @@
 #include "globopt.h"
 #include "lexers.h"
 #include "logio.h"
+#include "metrics.h"
+#include "trace.h"
+#include "usdt.h"
 
 #ifndef SYS_gettid
 #error "SYS_gettid unavailable on this system"
@@ -32,20 +39,24 @@
 /** Macro wrapper for the gettid syscall in case glibc is not new enough to contain one itself **/
 #define crinitGettid() ((pid_t)syscall(SYS_gettid))
 
+#ifndef SYS_ioprio_set
+#error "SYS_ioprio_set unavailable on this system"
+#endif
+
+/** Macro wrapper for the ioprio_set syscall which has no glibc wrapper, targets the calling thread. **/
+#define crinitIoPrioSetSelf(ioprio) syscall(SYS_ioprio_set, CRINIT_IOPRIO_WHO_PROCESS, 0, (ioprio))
+
+/** Maximum length of a resource limit value formatted as a string for the launcher, including terminating zero. **/
+#define CRINIT_RLIM_STR_LEN 21
+
 /** Struct wrapper for arguments to dispatchThreadFunc **/
 typedef struct crinitDispThrArgs {
     crinitTaskDB_t *ctx;              ///< The TaskDB context to update on task state changes.
     const crinitTask_t *t;            ///< The task to run.
     crinitDispatchThreadMode_t mode;  ///< Select between start and stop commands
+    uint64_t readyTime;               ///< Time the task has been dispatched, see crinitTraceNow().
 } crinitDispThrArgs_t;
 
-/** Mutex to guard #crinitWaitInhibit **/
-static pthread_mutex_t crinitWaitInhibitLock = PTHREAD_MUTEX_INITIALIZER;
-/** Condition variable to signal threads waiting for #crinitWaitInhibit to become `false`. **/
-static pthread_cond_t crinitWaitInhibitCond = PTHREAD_COND_INITIALIZER;
-/** If true, all terminated child processes will be kept around as zombies (see crinitBlockOnWaitInhibit()). **/
-static bool crinitWaitInhibit = false;
-
 /**
  * Function to be started as a pthread from crinitProcDispatchThread().
  *
@@ -55,21 +66,13 @@ static bool crinitWaitInhibit = false;
  */
 static void *crinitDispatchThreadFunc(void *args);
 /**
- * Block calling thread until #crinitWaitInhibit becomes false.
- *
- * Called by dispatcher threads to delay reaping of zombie processes if needed.
+ * Wait for a process spawned by crinitSpawnSingleCommand() to terminate, discarding its exit status.
  *
- * @return 0 on success, -1 on error
- */
-static int crinitBlockOnWaitInhibit(void);
-/**
- * Reap a zombie process.
- *
- * Will call blockOnWaitInhibit() internally.
+ * The PID must already have been reset in the TaskDB, it is released using crinitReaperRelease() afterwards.
  *
  * @param pid  The PID of the process to wait for.
  *
- * @return 0 on success, -1 on error
+ * @return 0 on success or if \a pid has already been waited for, -1 on error
  */
 static int crinitReapPid(pid_t pid);
 
@@ -104,6 +107,35 @@ static int crinitPosixSpawnAddIOFileAction(posix_spawn_file_actions_t *fileact,
  */
 static int crinitEnsureFifo(const char *path, mode_t mode);
 
+/**
+ * Applies the CPU affinity, nice value, and I/O priority of a task to the calling (dispatch) thread.
+ *
+ * None of these can be set using posix_spawn() attributes. As they are per-thread on Linux and inherited by child
+ * processes, setting them on the dispatch thread before spawning has the same effect as setting them in the child. The
+ * dispatch thread is exclusive to a single start or stop of a task, so other tasks are not affected.
+ *
+ * @param pa        The process attributes of the task, only the ones marked in crinitProcAttr_t::flags are applied.
+ * @param threadId  Thread ID of the calling thread, used for log messages.
+ * @param name      Name of the task, used for log messages.
+ *
+ * @return  0 on success, -1 otherwise.
+ */
+static int crinitApplyThreadProcAttr(const crinitProcAttr_t *pa, pid_t threadId, const char *name);
+
+/**
+ * Formats a `--rlimit` parameter for the launcher.
+ *
+ * Follows the semantics of snprintf() regarding \a buf and \a bufLen.
+ *
+ * @param buf       Output buffer, may be NULL if \a bufLen is 0.
+ * @param bufLen    Size of \a buf.
+ * @param resource  The resource (`RLIMIT_*`) to format.
+ * @param rlim      The soft and hard limits of \a resource.
+ *
+ * @return  The number of characters (excluding the terminating zero) the full parameter needs, or -1 on error.
+ */
+static int crinitFormatRlimitParam(char *buf, size_t bufLen, int resource, const struct rlimit *rlim);
+
 int crinitProcDispatchSpawnFunc(crinitTaskDB_t *ctx, const crinitTask_t *t, crinitDispatchThreadMode_t mode) {
     pthread_t dispatchThread;
     pthread_attr_t dispatchThreadAttr;
@@ -116,6 +148,7 @@ int crinitProcDispatchSpawnFunc(crinitTaskDB_t *ctx, const crinitTask_t *t, crin
     threadArgs->ctx = ctx;
     threadArgs->t = t;
     threadArgs->mode = mode;
+    threadArgs->readyTime = crinitTraceNow();
 
     if ((errno = pthread_attr_init(&dispatchThreadAttr)) != 0) {
         crinitErrnoPrint("Could not initialize pthread attributes. Meant to create thread for task \'%s\'.", t->name);
@@ -129,8 +162,8 @@ int crinitProcDispatchSpawnFunc(crinitTaskDB_t *ctx, const crinitTask_t *t, crin
     }
 
     if ((errno = pthread_attr_setstacksize(&dispatchThreadAttr, CRINIT_PROC_DISPATCH_THREAD_STACK_SIZE)) != 0) {
-        crinitErrnoPrint("Could not set pthread stack size to %d. Meant to create thread for task \'%s\'.",
-                         CRINIT_PROC_DISPATCH_THREAD_STACK_SIZE, t->name);
+        crinitErrnoPrint("Could not set pthread stack size to %zu. Meant to create thread for task \'%s\'.",
+                         (size_t)CRINIT_PROC_DISPATCH_THREAD_STACK_SIZE, t->name);
         goto fail;
     }
 
@@ -149,14 +182,54 @@ fail:
 }
 
 int crinitSpawnSingleCommand(const char *cmd, char *const argv[], char *const envp[],
-                             posix_spawn_file_actions_t *fileact, const char *name, size_t cmdIdx, pid_t threadId,
-                             pid_t *pid) {
-    errno = posix_spawn(pid, cmd, fileact, NULL, argv, envp);
-    if (errno != 0 || *pid == -1) {
+                             posix_spawn_file_actions_t *fileact, const crinitProcAttr_t *procAttr, const char *name,
+                             size_t cmdIdx, pid_t threadId, pid_t *pid) {
+    posix_spawnattr_t spawnAttr;
+    short spawnFlags = POSIX_SPAWN_SETSIGMASK;
+    sigset_t emptySet;
+    sigemptyset(&emptySet);
+
+    if ((errno = posix_spawnattr_init(&spawnAttr)) != 0) {
+        crinitErrnoPrint("(TID: %d) Could not initialize posix_spawn attributes for command %zu of Task \'%s\'",
+                         threadId, cmdIdx, name);
+        return -1;
+    }
+    // SIGCHLD is blocked in all of Crinit's threads for the reaper, see crinitReaperInit().
+    if ((errno = posix_spawnattr_setsigmask(&spawnAttr, &emptySet)) != 0) {
+        crinitErrnoPrint("(TID: %d) Could not set signal mask for command %zu of Task \'%s\'", threadId, cmdIdx, name);
+        posix_spawnattr_destroy(&spawnAttr);
+        return -1;
+    }
+    if (procAttr != NULL && (procAttr->flags & CRINIT_PROC_ATTR_POLICY)) {
+        struct sched_param sp = {.sched_priority = procAttr->priority};
+        if ((errno = posix_spawnattr_setschedpolicy(&spawnAttr, procAttr->policy)) != 0 ||
+            (errno = posix_spawnattr_setschedparam(&spawnAttr, &sp)) != 0) {
+            crinitErrnoPrint("(TID: %d) Could not set scheduling attributes for command %zu of Task \'%s\'", threadId,
+                             cmdIdx, name);
+            posix_spawnattr_destroy(&spawnAttr);
+            return -1;
+        }
+        spawnFlags |= POSIX_SPAWN_SETSCHEDULER;
+    }
+    if ((errno = posix_spawnattr_setflags(&spawnAttr, spawnFlags)) != 0) {
+        crinitErrnoPrint("(TID: %d) Could not set posix_spawn flags for command %zu of Task \'%s\'", threadId, cmdIdx,
+                         name);
+        posix_spawnattr_destroy(&spawnAttr);
+        return -1;
+    }
+
+    uint64_t spawnStart = crinitTraceNow();
+    crinitProbe3(spawn_begin, name, cmdIdx, threadId);
+    int spawnRes = crinitReaperSpawn(pid, cmd, fileact, &spawnAttr, argv, envp);
+    crinitProbe4(spawn_end, name, cmdIdx, (spawnRes == -1) ? -1 : *pid, spawnRes);
+    crinitTraceSpan(CRINIT_TRACE_CMD_EXEC, spawnStart, (spawnRes == -1) ? -1 : *pid, "%s", name);
+    if (spawnRes == -1 || *pid == -1) {
         crinitErrnoPrint("(TID: %d) Could not spawn new process for command %zu of Task \'%s\'", threadId, cmdIdx,
                          name);
+        posix_spawnattr_destroy(&spawnAttr);
         return -1;
     }
+    posix_spawnattr_destroy(&spawnAttr);
     return 0;
 }
 
@@ -246,6 +319,19 @@ int crinitCreateLauncherParameters(crinitTaskCmd_t *taskCmd, crinitTask_t *tCopy
 #endif
     const char *const delimiterEndOfOptionsStr = "--";
     const size_t doubleDashLength = strlen(delimiterEndOfOptionsStr) + 1;
+    size_t rlimitParamCount = 0;
+    size_t rlimitParamTotalLength = 0;
+    for (int r = 0; r < CRINIT_PROC_ATTR_RLIMITS; r++) {
+        if (tCopy->procAttr.rlimitsSet & (1ul << r)) {
+            int rlimitParamLength = crinitFormatRlimitParam(NULL, 0, r, &tCopy->procAttr.rlimits[r]);
+            if (rlimitParamLength == -1) {
+                crinitErrPrint("Failed to calculate the size of the resource limit parameter string.");
+                return -1;
+            }
+            rlimitParamTotalLength += rlimitParamLength + 1;
+            rlimitParamCount++;
+        }
+    }
     const size_t cmdParamLength = snprintf(NULL, 0, cmdParamFormatStr, taskCmd->argv[0]) + 1;
     const size_t userParamLength = snprintf(NULL, 0, userParamFormatStr, tCopy->user) + 1;
     const size_t groupParamFixedPartLength = snprintf(NULL, 0, groupParamFormatStr, tCopy->group) + 1;
@@ -309,7 +395,7 @@ int crinitCreateLauncherParameters(crinitTaskCmd_t *taskCmd, crinitTask_t *tCopy
 #ifdef ENABLE_CGROUP
                                + cgroupParamLength
 #endif
-                               + doubleDashLength + targetParamTotalLength;
+                               + rlimitParamTotalLength + doubleDashLength + targetParamTotalLength;
 
     char *argBuf = NULL;
     char **av = NULL;
@@ -327,6 +413,7 @@ int crinitCreateLauncherParameters(crinitTaskCmd_t *taskCmd, crinitTask_t *tCopy
 #ifdef ENABLE_CGROUP
     launcherParamCount++;
 #endif
+    launcherParamCount += rlimitParamCount;
     av = calloc(launcherParamCount + taskCmd->argc, sizeof(*av));
     if (av == NULL) {
         crinitErrnoPrint("Failed to allocate memory for temporary argv to use with command launcher.\n");
@@ -377,6 +464,14 @@ int crinitCreateLauncherParameters(crinitTaskCmd_t *taskCmd, crinitTask_t *tCopy
     }
 #endif
 
+    for (int r = 0; r < CRINIT_PROC_ATTR_RLIMITS; r++) {
+        if (tCopy->procAttr.rlimitsSet & (1ul << r)) {
+            size_t bytesLeft = totalLength + 1 - (argBufCurr - argBuf);
+            av[argBufIdx++] = argBufCurr;
+            argBufCurr += crinitFormatRlimitParam(argBufCurr, bytesLeft, r, &tCopy->procAttr.rlimits[r]) + 1;
+        }
+    }
+
     av[argBufIdx++] = argBufCurr;
     memcpy(argBufCurr, delimiterEndOfOptionsStr, doubleDashLength);
     argBufCurr += doubleDashLength;
@@ -394,24 +489,19 @@ int crinitCreateLauncherParameters(crinitTaskCmd_t *taskCmd, crinitTask_t *tCopy
 }
 
 int crinitHandleCommands(crinitTaskDB_t *ctx, pid_t threadId, char *name, crinitTaskCmd_t *cmds, size_t cmdsSize,
-                         crinitTask_t *tCopy, pid_t *pid, bool deactivateFileactions) {
+                         crinitTask_t *tCopy, pid_t *pid, crinitDispatchThreadMode_t mode,
+                         bool deactivateFileactions, uint64_t readyTime) {
     char *cmd = NULL;
     char **argv = NULL;
     char *argvBuffer = NULL;
     bool useLauncher = false;
 
-    char *crinitLauncherCommand = NULL;
-    if (crinitGlobOptGet(CRINIT_GLOBOPT_LAUNCHER_CMD, &crinitLauncherCommand) != 0) {
-        crinitErrPrint("Could not retrieve value for global setting LAUNCHER_CMD.");
-        return -1;
-    }
-
-    if (tCopy->user != 0 || tCopy->group != 0
+    // Resource limits are applied by the launcher as there is no posix_spawn() attribute for them.
+    if (tCopy->user != 0 || tCopy->group != 0 || tCopy->procAttr.rlimitsSet != 0
 #ifdef ENABLE_CGROUP
         || tCopy->cgroup != NULL
 #endif
     ) {
-        cmd = crinitLauncherCommand;
         useLauncher = true;
     }
 
@@ -424,6 +514,10 @@ int crinitHandleCommands(crinitTaskDB_t *ctx, pid_t threadId, char *name, crinit
     }
 #endif
 
+    if (crinitApplyThreadProcAttr(&tCopy->procAttr, threadId, name) == -1) {
+        return -1;
+    }
+
     for (size_t i = 0; i < cmdsSize; i++) {
         posix_spawn_file_actions_t fileact;
         errno = posix_spawn_file_actions_init(&fileact);
@@ -431,33 +525,43 @@ int crinitHandleCommands(crinitTaskDB_t *ctx, pid_t threadId, char *name, crinit
             crinitErrnoPrint("(TID: %d) Could not initialize posix_spawn file actions for command %zu of Task '%s'",
                              threadId, i, name);
             posix_spawn_file_actions_destroy(&fileact);
-            free(crinitLauncherCommand);
             return -1;
         }
 
         if (crinitPrepareIoRedirectionsForSpawn(i, tCopy->redirs, tCopy->redirsSize, threadId, tCopy->name, &fileact) ==
             -1) {
             posix_spawn_file_actions_destroy(&fileact);
-            free(crinitLauncherCommand);
             return -1;
         }
 
+        // LAUNCHER_CMD is read from a snapshot of the global options which is only held until the command is spawned.
+        const crinitGlobOptStore_t *globOpts = NULL;
         if (!useLauncher) {
             cmd = cmds[i].argv[0];
             argv = cmds[i].argv;
         } else {
+            globOpts = crinitGlobOptSnapshotAcquire();
+            if (globOpts == NULL) {
+                crinitErrPrint("Could not retrieve value for global setting LAUNCHER_CMD.");
+                posix_spawn_file_actions_destroy(&fileact);
+                return -1;
+            }
+            cmd = globOpts->launcherCmd;
             if (crinitCreateLauncherParameters(&(cmds[i]), tCopy, cmd, &argv, &argvBuffer) != 0) {
                 crinitErrPrint("Failed to create launcher parameters.\n");
                 posix_spawn_file_actions_destroy(&fileact);
-                free(crinitLauncherCommand);
+                crinitGlobOptSnapshotRelease(globOpts);
                 free(argvBuffer);
                 free(argv);
                 return -1;
             }
         }
 
-        if (crinitSpawnSingleCommand(cmd, argv, tCopy->taskEnv.envp, deactivateFileactions == true ? NULL : &fileact,
-                                     name, i, threadId, pid) == -1) {
+        int spawnRes = crinitSpawnSingleCommand(cmd, argv, tCopy->taskEnv.envp,
+                                                deactivateFileactions == true ? NULL : &fileact, &tCopy->procAttr, name,
+                                                i, threadId, pid);
+        crinitGlobOptSnapshotRelease(globOpts);
+        if (spawnRes == -1) {
             posix_spawn_file_actions_destroy(&fileact);
             if (useLauncher) {
                 free(argvBuffer);
@@ -465,25 +569,25 @@ int crinitHandleCommands(crinitTaskDB_t *ctx, pid_t threadId, char *name, crinit
                 argvBuffer = NULL;
                 argv = NULL;
             }
-            free(crinitLauncherCommand);
             return -1;
         }
-        if (!useLauncher) {
-            cmd = NULL;
-        } else {
+        cmd = NULL;
+        if (useLauncher) {
             free(argvBuffer);
             free(argv);
             argvBuffer = NULL;
             argv = NULL;
         }
         posix_spawn_file_actions_destroy(&fileact);
+        if (i == 0 && mode == CRINIT_DISPATCH_THREAD_MODE_START) {
+            crinitMetricsObserve(CRINIT_METRIC_SPAWN_LATENCY, crinitTraceNow() - readyTime);
+        }
 
         crinitInfoPrint("(TID: %d) Started new process %d for command %zu of Task \'%s\' (\'%s\').", threadId, *pid, i,
                         name, cmds[i].argv[0]);
 
         if (crinitTaskDBSetTaskPID(ctx, *pid, name) == -1) {
             crinitErrPrint("(TID: %d) Could not set PID of Task \'%s\' to %d.", threadId, name, *pid);
-            free(crinitLauncherCommand);
             return -1;
         }
 
@@ -496,7 +600,6 @@ int crinitHandleCommands(crinitTaskDB_t *ctx, pid_t threadId, char *name, crinit
             if (crinitTaskDBFulfillDep(ctx, &spawnDep, NULL) == -1) {
                 crinitErrPrint("(TID: %d) Could not fulfill dependency %s:%s.", threadId, spawnDep.name,
                                spawnDep.event);
-                free(crinitLauncherCommand);
                 return -1;
             }
             crinitDbgInfoPrint("(TID: %d) Dependency \'%s:%s\' fulfilled.", threadId, spawnDep.name, spawnDep.event);
@@ -507,39 +610,44 @@ int crinitHandleCommands(crinitTaskDB_t *ctx, pid_t threadId, char *name, crinit
             crinitDbgInfoPrint("(TID: %d) Features of spawned task \'%s\' fulfilled.", threadId, name);
         }
 
-        int wret;
         siginfo_t status;
-        // Check if process has exited, but leave zombie.
-        do {
-            wret = waitid(P_PID, *pid, &status, WEXITED | WNOWAIT);
-        } while (wret != 0 && errno == EINTR);
-
-        if (wret != 0 || status.si_code != CLD_EXITED || status.si_status != 0) {
-            // There was some error, either Crinit-internal or the task returned an error code or the task was killed.
-            if (errno) {
-                crinitErrnoPrint("(TID: %d) Failed to wait for Task \'%s\' (PID %d).", threadId, name, *pid);
-                return -1;
-            } else if (status.si_code == CLD_EXITED) {
-                crinitInfoPrint("(TID: %d) Task \'%s\' (PID %d) returned error code %d.", threadId, name, *pid,
-                                status.si_status);
-            } else {
-                crinitInfoPrint("(TID: %d) Task \'%s\' (PID %d) failed.", threadId, name, *pid);
-            }
-            free(crinitLauncherCommand);
+        struct rusage ru;
+        const pid_t cmdPid = *pid;
+        const int wret = crinitReaperWait(cmdPid, &status, &ru);
+        // Forget the PID everywhere before the reaper does, it may be reused afterwards.
+        *pid = -1;
+        if (crinitTaskDBSetTaskPID(ctx, -1, name) == -1) {
+            crinitErrPrint("(TID: %d) Could not reset PID of Task \'%s\' to -1.", threadId, name);
+        }
+        if (wret == 0) {
+            crinitReaperRelease(cmdPid);
+        }
+
+        if (wret != 0) {
+            crinitErrnoPrint("(TID: %d) Failed to wait for Task \'%s\' (PID %d).", threadId, name, cmdPid);
             return -1;
         }
 
-        // command of task has returned successfully
-        if (crinitTaskDBSetTaskPID(ctx, -1, name) == -1) {
-            crinitErrPrint("(TID: %d) Could not reset PID of Task \'%s\' to -1.", threadId, name);
+        crinitInfoPrint("(TID: %d) Command %zu of Task \'%s\' (PID %d) used %ld.%06lds user and %ld.%06lds system CPU "
+                        "time, max. RSS %ldkB.",
+                        threadId, i, name, cmdPid, (long)ru.ru_utime.tv_sec, (long)ru.ru_utime.tv_usec,
+                        (long)ru.ru_stime.tv_sec, (long)ru.ru_stime.tv_usec, ru.ru_maxrss);
+        if (crinitTaskDBAddTaskUsage(ctx, &ru, mode, i, name) == -1) {
+            crinitErrPrint("(TID: %d) Could not account resource usage of command %zu to Task \'%s\'.", threadId, i,
+                           name);
         }
-        // Reap zombie of successful command.
-        if (crinitReapPid(*pid) == -1) {
-            crinitErrnoPrint("(TID: %d) Could not reap zombie for task \'%s\'.", threadId, name);
+        if (status.si_code != CLD_EXITED || status.si_status != 0) {
+            // The task returned an error code or the task was killed.
+            if (status.si_code == CLD_EXITED) {
+                crinitInfoPrint("(TID: %d) Task \'%s\' (PID %d) returned error code %d.", threadId, name, cmdPid,
+                                status.si_status);
+            } else {
+                crinitInfoPrint("(TID: %d) Task \'%s\' (PID %d) failed.", threadId, name, cmdPid);
+            }
+            return -1;
         }
     }
 
-    free(crinitLauncherCommand);
     return 0;
 }
 
@@ -730,21 +838,22 @@ static void *crinitDispatchThreadFunc(void *args) {
     crinitTask_t *tCopy = NULL;
     pid_t threadId = crinitGettid();
     pid_t pid = -1;
+    uint64_t threadStart = crinitTraceNow();
 
     crinitDbgInfoPrint("(TID: %d) New thread started.", threadId);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("(TID: %d) Could not queue up for mutex lock.", threadId);
         goto threadExit;
     }
 
     if (crinitTaskDup(&tCopy, t) == -1) {
         crinitErrPrint("(TID: %d) Could not get duplicate of Task to spawn.", threadId);
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         goto threadExit;
     }
 
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
 
     if (crinitEnvSetSet(&tCopy->taskEnv, CRINIT_ENV_NOTIFY_NAME, tCopy->name) == -1) {
         crinitErrPrint("Could not set notification environment variable for task \'%s\'", tCopy->name);
@@ -771,8 +880,8 @@ static void *crinitDispatchThreadFunc(void *args) {
     }
 
     // Do not execute IO redirections for STOP_COMMANDS for now.
-    if (crinitHandleCommands(ctx, threadId, tCopy->name, cmds, cmdsSize, tCopy, &pid,
-                             a->mode == CRINIT_DISPATCH_THREAD_MODE_STOP ? true : false) != 0) {
+    if (crinitHandleCommands(ctx, threadId, tCopy->name, cmds, cmdsSize, tCopy, &pid, a->mode,
+                             a->mode == CRINIT_DISPATCH_THREAD_MODE_STOP ? true : false, a->readyTime) != 0) {
         goto threadExitFail;
     }
 
@@ -801,7 +910,7 @@ threadExitFail:
     if (crinitTaskDBSetTaskPID(ctx, -1, tCopy->name) == -1) {
         crinitErrPrint("(TID: %d) Could not reset PID of failed Task \'%s\' to -1.", threadId, tCopy->name);
     }
-    // Reap zombie of failed command (if it was actually spawned).
+    // Wait for the command if it was spawned but its exit status has not been collected.
     if (pid > 0 && crinitReapPid(pid) == -1) {
         crinitErrPrint("(TID: %d) Could not reap zombie for task \'%s\'.", threadId, tCopy->name);
     }
@@ -829,73 +938,36 @@ threadExit:
         }
     } else {
         for (size_t i = 0; i < tCopy->trigSize; i++) {
-            if (0 == strcmp(tCopy->trig[i].name, "@timer")) {
+            if (0 != strcmp(tCopy->trig[i].name, "@timer")) {
+                continue;
+            }
+            if (crinitTimerDBIsTaskTimer(tCopy->trig[i].event)) {
+                crinitTimerDBDisarmTaskTimer(tCopy->name, tCopy->trig[i].event);
+            } else {
                 crinitTimerDBRemoveTimer(tCopy->trig[i].event);
             }
         }
     }
+    if (a->mode == CRINIT_DISPATCH_THREAD_MODE_STOP && crinitTaskDBStopThreadDone(ctx, tCopy->name) == -1) {
+        crinitErrPrint("(TID: %d) Could not signal finished STOP_COMMAND(s) of task \'%s\'.", threadId, tCopy->name);
+    }
+    crinitTraceSpan(CRINIT_TRACE_TASK_SPAWN, threadStart, a->mode == CRINIT_DISPATCH_THREAD_MODE_STOP, "%s",
+                    tCopy->name);
     crinitFreeTask(tCopy);
     free(args);
     return NULL;
 }
 
-int crinitSetInhibitWait(bool inh) {
-    int ret = 0;
-    errno = pthread_mutex_lock(&crinitWaitInhibitLock);
-    if (errno != 0) {
-        crinitErrnoPrint("Could not lock on mutex.");
-        return -1;
-    }
-    crinitWaitInhibit = inh;
-    if (!inh) {
-        errno = pthread_cond_broadcast(&crinitWaitInhibitCond);
-        if (errno != 0) {
-            ret = -1;
-            crinitErrnoPrint("Could not broadcast on condition variable.");
-        }
-    }
-    if (pthread_mutex_unlock(&crinitWaitInhibitLock)) {
-        ret = -1;
-        crinitErrnoPrint("Could not unlock mutex.");
-    }
-    return ret;
-}
-
-static int crinitBlockOnWaitInhibit(void) {
-    errno = pthread_mutex_lock(&crinitWaitInhibitLock);
-    if (errno != 0) {
-        crinitErrnoPrint("Could not lock on mutex.");
-        return -1;
-    }
-    while (crinitWaitInhibit) {
-        errno = pthread_cond_wait(&crinitWaitInhibitCond, &crinitWaitInhibitLock);
-        if (errno != 0) {
-            crinitErrnoPrint("Could not wait on condition variable.");
-            return -1;
-        }
-    }
-    if (pthread_mutex_unlock(&crinitWaitInhibitLock)) {
-        crinitErrnoPrint("Could not unlock mutex.");
-        return -1;
-    }
-    return 0;
-}
-
 static int crinitReapPid(pid_t pid) {
-    if (crinitBlockOnWaitInhibit() == -1) {
-        crinitErrPrint("Could not block on wait inhibition condition.");
-        return -1;
-    }
-    do {
-        waitpid(pid, NULL, 0);
-    } while (errno == EINTR);
-    if (errno == ECHILD) {
-        return 0;  // If the PID does not exist it has either already been reaped or never existed. In either case,
-                   // we're fine.
-    } else if (errno != 0) {
-        crinitErrnoPrint("Could not reap zombie for PID \'%d\'.", pid);
+    if (crinitReaperWait(pid, NULL, NULL) == -1) {
+        if (errno == ECHILD) {
+            return 0;  // Already waited for, nothing left to do.
+        }
+        crinitErrnoPrint("Could not wait for PID \'%d\'.", pid);
         return -1;
     }
+    // The caller has already reset the PID of the task.
+    crinitReaperRelease(pid);
     return 0;
 }
 
@@ -961,3 +1033,45 @@ static int crinitEnsureFifo(const char *path, mode_t mode) {
     }
     return 0;
 }
+
+static int crinitApplyThreadProcAttr(const crinitProcAttr_t *pa, pid_t threadId, const char *name) {
+    if (pa->flags & CRINIT_PROC_ATTR_CPUS) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (size_t cpu = 0; cpu < CRINIT_PROC_ATTR_MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+            if (crinitProcAttrCpuIsSet(pa, cpu)) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        if (sched_setaffinity(0, sizeof(cpus), &cpus) == -1) {
+            crinitErrnoPrint("(TID: %d) Could not set CPU affinity for Task \'%s\'.", threadId, name);
+            return -1;
+        }
+    }
+
+    if ((pa->flags & CRINIT_PROC_ATTR_NICE) && setpriority(PRIO_PROCESS, (id_t)threadId, pa->nice) == -1) {
+        crinitErrnoPrint("(TID: %d) Could not set nice value %d for Task \'%s\'.", threadId, pa->nice, name);
+        return -1;
+    }
+
+    if ((pa->flags & CRINIT_PROC_ATTR_IOPRIO) && crinitIoPrioSetSelf(pa->ioprio) == -1) {
+        crinitErrnoPrint("(TID: %d) Could not set I/O priority for Task \'%s\'.", threadId, name);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int crinitFormatRlimitParam(char *buf, size_t bufLen, int resource, const struct rlimit *rlim) {
+    char limStr[2][CRINIT_RLIM_STR_LEN];
+    const rlim_t lims[2] = {rlim->rlim_cur, rlim->rlim_max};
+
+    for (size_t i = 0; i < 2; i++) {
+        if (lims[i] == RLIM_INFINITY) {
+            snprintf(limStr[i], sizeof(limStr[i]), "infinity");
+        } else {
+            snprintf(limStr[i], sizeof(limStr[i]), "%llu", (unsigned long long)lims[i]);
+        }
+    }
+    return snprintf(buf, bufLen, "--rlimit=%d:%s:%s", resource, limStr[0], limStr[1]);
+}
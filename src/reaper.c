@@ -0,0 +1,499 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file reaper.c
+ * @brief Implementation of the central reaper of child processes.
+ */
+#include "reaper.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "lockprof.h"
+#include "logio.h"
+#include "usdt.h"
+
+/** A child process spawned via crinitReaperSpawn() which has not yet been collected by crinitReaperWait(). **/
+typedef struct crinitReaperEntry {
+    pid_t pid;         ///< PID of the process.
+    bool exited;       ///< True if the process has been reaped, crinitReaperEntry_t::status is valid afterwards.
+    siginfo_t status;  ///< Exit status of the process, see crinitReaperWait().
+    struct rusage ru;  ///< Resource usage of the process as returned by wait4().
+    bool released;     ///< True if nobody will collect the exit status, the entry is dropped once reaped.
+    /**
+     * True if the exit status has been collected by crinitReaperWait(). The entry is kept until crinitReaperRelease()
+     * so that crinitReaperKill() refuses to signal the PID while it may still be handed out by its former owner.
+     */
+    bool collected;
+} crinitReaperEntry_t;
+
+/** Type of the global reaper context. **/
+typedef struct crinitReaper {
+    pthread_mutex_t lock;          ///< Mutex guarding the whole context, also held while reaping.
+    pthread_cond_t changed;        ///< Condition variable signalled each time a process has been reaped, uses
+                                   ///< `CLOCK_MONOTONIC` for timed waits.
+    crinitReaperEntry_t *entries;  ///< Table of watched processes.
+    size_t size;                   ///< Number of used elements in crinitReaper_t::entries.
+    size_t cap;                    ///< Number of allocated elements in crinitReaper_t::entries.
+    /**
+     * Number of crinitReaperSpawn() calls between reserving an element in crinitReaper_t::entries and registering the
+     * new process. While non-zero, only watched processes are reaped so that an unregistered new process stays a zombie
+     * and its PID can not be reused before its exit status is stored.
+     */
+    size_t spawning;
+    int sfd;  ///< signalfd for `SIGCHLD`.
+} crinitReaper_t;
+
+/** The global reaper context. **/
+static crinitReaper_t crinitReaper = {.lock = PTHREAD_MUTEX_INITIALIZER,
+                                      .changed = PTHREAD_COND_INITIALIZER,
+                                      .entries = NULL,
+                                      .size = 0,
+                                      .cap = 0,
+                                      .spawning = 0,
+                                      .sfd = -1};
+
+/**
+ * The reaper thread function.
+ *
+ * Waits on the signalfd for `SIGCHLD` and calls crinitReapAll() each time it becomes readable.
+ *
+ * @param args  UNUSED
+ */
+static void *crinitReaperThread(void *args);
+/**
+ * Reaps all terminated child processes without blocking.
+ *
+ * Exit statuses of watched processes are stored in their table entries. While crinitReaper_t::spawning is non-zero,
+ * only watched processes are reaped, see crinitReapWatched(). Caller must hold crinitReaper_t::lock.
+ *
+ * @return  true if there are child processes left which are still running, false otherwise
+ */
+static bool crinitReapAll(void);
+/**
+ * Reaps all terminated watched processes without blocking, leaving other child processes alone.
+ *
+ * Caller must hold crinitReaper_t::lock.
+ *
+ * @return  true if a process has been reaped, false otherwise
+ */
+static bool crinitReapWatched(void);
+/**
+ * Stores the exit status of a reaped watched process or drops its entry if it has been released.
+ *
+ * Caller must hold crinitReaper_t::lock.
+ *
+ * @param idx      Index of the table entry of the process.
+ * @param wstatus  The wait status as returned by wait4().
+ * @param ru       The resource usage as returned by wait4().
+ *
+ * @return  true if the entry at \a idx has been dropped and replaced by another one, false otherwise
+ */
+static bool crinitReaperStore(size_t idx, int wstatus, const struct rusage *ru);
+/**
+ * Looks up a watched process whose exit status has not been collected yet. Caller must hold crinitReaper_t::lock.
+ *
+ * @param pid       The PID to search for.
+ * @param liveOnly  If true, skip entries of processes which have already been reaped. Their PID may already have been
+ *                  reused by a new process.
+ *
+ * @return  Pointer to the table entry of \a pid or NULL if \a pid is not watched.
+ */
+static crinitReaperEntry_t *crinitReaperFind(pid_t pid, bool liveOnly);
+/**
+ * Looks up the entry of a process whose exit status has been collected but which has not been released yet. Caller
+ * must hold crinitReaper_t::lock.
+ *
+ * @param pid  The PID to search for.
+ *
+ * @return  Pointer to the table entry of \a pid or NULL if there is none.
+ */
+static crinitReaperEntry_t *crinitReaperFindCollected(pid_t pid);
+
+int crinitReaperInit(void) {
+    sigset_t chldSet;
+    sigemptyset(&chldSet);
+    sigaddset(&chldSet, SIGCHLD);
+    if ((errno = pthread_sigmask(SIG_BLOCK, &chldSet, NULL)) != 0) {
+        crinitErrnoPrint("Could not block SIGCHLD.");
+        return -1;
+    }
+
+    // Timed waits in crinitReaperWaitAll() shall not be affected by changes of the system time.
+    pthread_condattr_t condAttr;
+    if ((errno = pthread_condattr_init(&condAttr)) != 0) {
+        crinitErrnoPrint("Could not initialize condition variable attributes.");
+        return -1;
+    }
+    if ((errno = pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC)) != 0) {
+        crinitErrnoPrint("Could not set clock of condition variable.");
+        pthread_condattr_destroy(&condAttr);
+        return -1;
+    }
+    pthread_cond_destroy(&crinitReaper.changed);
+    errno = pthread_cond_init(&crinitReaper.changed, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+    if (errno != 0) {
+        crinitErrnoPrint("Could not initialize condition variable.");
+        return -1;
+    }
+
+    crinitReaper.entries = calloc(CRINIT_REAPER_INITIAL_CAP, sizeof(*crinitReaper.entries));
+    if (crinitReaper.entries == NULL) {
+        crinitErrnoPrint("Could not allocate memory for the table of child processes.");
+        return -1;
+    }
+    crinitReaper.cap = CRINIT_REAPER_INITIAL_CAP;
+
+    crinitReaper.sfd = signalfd(-1, &chldSet, SFD_CLOEXEC);
+    if (crinitReaper.sfd == -1) {
+        crinitErrnoPrint("Could not create signalfd for SIGCHLD.");
+        goto fail;
+    }
+
+    pthread_t reaperThread;
+    pthread_attr_t reaperThreadAttr;
+    if ((errno = pthread_attr_init(&reaperThreadAttr)) != 0) {
+        crinitErrnoPrint("Could not initialize pthread attributes for the reaper thread.");
+        goto fail;
+    }
+    if ((errno = pthread_attr_setdetachstate(&reaperThreadAttr, PTHREAD_CREATE_DETACHED)) != 0) {
+        crinitErrnoPrint("Could not set PTHREAD_CREATE_DETACHED attribute for the reaper thread.");
+        pthread_attr_destroy(&reaperThreadAttr);
+        goto fail;
+    }
+    if ((errno = pthread_create(&reaperThread, &reaperThreadAttr, crinitReaperThread, NULL)) != 0) {
+        crinitErrnoPrint("Could not create the reaper thread.");
+        pthread_attr_destroy(&reaperThreadAttr);
+        goto fail;
+    }
+    pthread_attr_destroy(&reaperThreadAttr);
+    return 0;
+
+fail:
+    if (crinitReaper.sfd != -1) {
+        close(crinitReaper.sfd);
+        crinitReaper.sfd = -1;
+    }
+    free(crinitReaper.entries);
+    crinitReaper.entries = NULL;
+    crinitReaper.cap = 0;
+    return -1;
+}
+
+int crinitReaperSpawn(pid_t *pid, const char *path, const posix_spawn_file_actions_t *fileact,
+                      const posix_spawnattr_t *attrp, char *const argv[], char *const envp[]) {
+    crinitNullCheck(-1, pid, path, argv, envp);
+
+    if ((errno = crinitMutexLock(&crinitReaper.lock, CRINIT_LOCK_REAPER)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    // Reserve an element beforehand so that registration can not fail once the process exists.
+    if (crinitReaper.size + crinitReaper.spawning == crinitReaper.cap) {
+        size_t newCap = (crinitReaper.cap == 0) ? CRINIT_REAPER_INITIAL_CAP : crinitReaper.cap * 2;
+        crinitReaperEntry_t *newEntries = realloc(crinitReaper.entries, newCap * sizeof(*newEntries));
+        if (newEntries == NULL) {
+            crinitErrnoPrint("Could not grow the table of child processes to %zu elements.", newCap);
+            crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+            return -1;
+        }
+        crinitReaper.entries = newEntries;
+        crinitReaper.cap = newCap;
+    }
+    crinitReaper.spawning++;
+    crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+
+    // The new process can not be reaped before it is registered below, so there is no need to hold the lock.
+    int spawnErr = posix_spawn(pid, path, fileact, attrp, argv, envp);
+
+    if ((errno = crinitMutexLock(&crinitReaper.lock, CRINIT_LOCK_REAPER)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+    crinitReaper.spawning--;
+    if (spawnErr == 0) {
+        crinitReaperEntry_t *e = &crinitReaper.entries[crinitReaper.size++];
+        memset(e, 0, sizeof(*e));
+        e->pid = *pid;
+    }
+    // The new process and other children may have terminated in the meantime without having been reaped.
+    crinitReapAll();
+    if (crinitReaper.spawning == 0) {
+        pthread_cond_broadcast(&crinitReaper.changed);
+    }
+    crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+
+    if (spawnErr != 0) {
+        errno = spawnErr;
+        return -1;
+    }
+    return 0;
+}
+
+int crinitReaperWait(pid_t pid, siginfo_t *status, struct rusage *ru) {
+    if ((errno = crinitMutexLock(&crinitReaper.lock, CRINIT_LOCK_REAPER)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    crinitReaperEntry_t *e = crinitReaperFind(pid, false);
+    if (e == NULL || e->released) {
+        crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+        errno = ECHILD;
+        return -1;
+    }
+    while (!e->exited) {
+        if ((errno = crinitMutexCondWait(&crinitReaper.changed, &crinitReaper.lock, CRINIT_LOCK_REAPER)) != 0) {
+            crinitErrnoPrint("Could not wait on condition variable.");
+            // Nobody is going to collect the exit status, so drop the entry now or have the reaper drop it.
+            int errnoBackup = errno;
+            e = crinitReaperFind(pid, false);
+            if (e->exited) {
+                *e = crinitReaper.entries[--crinitReaper.size];
+            } else {
+                e->released = true;
+            }
+            crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+            errno = errnoBackup;
+            return -1;
+        }
+        // The table may have been reallocated or reordered in the meantime.
+        e = crinitReaperFind(pid, false);
+    }
+
+    if (status != NULL) {
+        *status = e->status;
+    }
+    if (ru != NULL) {
+        *ru = e->ru;
+    }
+    // Keep the PID blocked for crinitReaperKill() until the caller has forgotten it, see crinitReaperRelease().
+    e->collected = true;
+
+    crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+    return 0;
+}
+
+int crinitReaperRelease(pid_t pid) {
+    if ((errno = crinitMutexLock(&crinitReaper.lock, CRINIT_LOCK_REAPER)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    int ret = 0;
+    crinitReaperEntry_t *e = crinitReaperFindCollected(pid);
+    if (e == NULL) {
+        errno = ECHILD;
+        ret = -1;
+    } else {
+        *e = crinitReaper.entries[--crinitReaper.size];
+    }
+
+    int errnoBackup = errno;
+    crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+    errno = errnoBackup;
+    return ret;
+}
+
+int crinitReaperKill(pid_t pid, int sig) {
+    if ((errno = crinitMutexLock(&crinitReaper.lock, CRINIT_LOCK_REAPER)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    int ret = 0;
+    siginfo_t info;
+    if (crinitReaperFind(pid, true) != NULL) {
+        ret = kill(pid, sig);
+    } else if (crinitReaperFind(pid, false) != NULL || crinitReaperFindCollected(pid) != NULL) {
+        // Reaped, the PID may already belong to another process.
+        errno = ESRCH;
+        ret = -1;
+    } else if (waitid(P_PID, (id_t)pid, &info, WEXITED | WNOHANG | WNOWAIT) == -1) {
+        // Not a child of ours, so we can not tell if the PID is still the process the caller means.
+        errno = ESRCH;
+        ret = -1;
+    } else {
+        // A child which is not watched, e.g. re-parented to Crinit. It can not be reaped while we hold the lock.
+        ret = kill(pid, sig);
+    }
+
+    int errnoBackup = errno;
+    crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+    errno = errnoBackup;
+    return ret;
+}
+
+int crinitReaperWaitAll(const struct timespec *deadline) {
+    crinitNullCheck(-1, deadline);
+
+    if ((errno = crinitMutexLock(&crinitReaper.lock, CRINIT_LOCK_REAPER)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    // Reap ourselves in case there are no more SIGCHLD to come, i.e. if all children have already terminated.
+    while (crinitReapAll()) {
+        if ((errno = crinitMutexCondTimedWait(&crinitReaper.changed, &crinitReaper.lock, deadline,
+                                              CRINIT_LOCK_REAPER)) != 0) {
+            if (errno != ETIMEDOUT) {
+                crinitErrnoPrint("Could not wait on condition variable.");
+            }
+            int errnoBackup = errno;
+            crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+            errno = errnoBackup;
+            return -1;
+        }
+    }
+
+    crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+    return 0;
+}
+
+static void *crinitReaperThread(void *args) {
+    CRINIT_PARAM_UNUSED(args);
+
+    struct signalfd_siginfo ssi;
+    while (true) {
+        ssize_t rd = read(crinitReaper.sfd, &ssi, sizeof(ssi));
+        if (rd == -1 && errno != EINTR) {
+            crinitErrnoPrint("Could not read from SIGCHLD signalfd.");
+            continue;
+        }
+
+        if ((errno = crinitMutexLock(&crinitReaper.lock, CRINIT_LOCK_REAPER)) != 0) {
+            crinitErrnoPrint("Could not queue up for mutex lock.");
+            continue;
+        }
+        // Multiple SIGCHLD may be merged into one, so always reap everything there is.
+        crinitReapAll();
+        crinitMutexUnlock(&crinitReaper.lock, CRINIT_LOCK_REAPER);
+    }
+
+    return NULL;
+}
+
+static bool crinitReapAll(void) {
+    if (crinitReaper.spawning > 0) {
+        if (crinitReapWatched()) {
+            pthread_cond_broadcast(&crinitReaper.changed);
+        }
+        // At least the process being spawned is left.
+        return true;
+    }
+
+    bool changed = false;
+    bool childrenLeft = true;
+    while (true) {
+        int wstatus = 0;
+        struct rusage ru;
+        // waitid() can not return the resource usage of the process, so use wait4() and convert its status.
+        pid_t pid = wait4(-1, &wstatus, WNOHANG, &ru);
+        if (pid == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ECHILD) {
+                childrenLeft = false;
+            } else {
+                crinitErrnoPrint("Could not reap child processes.");
+            }
+            break;
+        }
+        if (pid == 0) {
+            break;
+        }
+        crinitProbe2(reap, pid, wstatus);
+
+        changed = true;
+        crinitReaperEntry_t *e = crinitReaperFind(pid, true);
+        if (e == NULL) {
+            crinitDbgInfoPrint("Reaped orphaned process %d.", pid);
+            continue;
+        }
+        crinitReaperStore((size_t)(e - crinitReaper.entries), wstatus, &ru);
+    }
+
+    if (changed) {
+        pthread_cond_broadcast(&crinitReaper.changed);
+    }
+    return childrenLeft;
+}
+
+static bool crinitReapWatched(void) {
+    bool changed = false;
+    size_t i = 0;
+    while (i < crinitReaper.size) {
+        crinitReaperEntry_t *e = &crinitReaper.entries[i];
+        int wstatus = 0;
+        struct rusage ru;
+        pid_t pid = 0;
+        if (!e->exited) {
+            do {
+                pid = wait4(e->pid, &wstatus, WNOHANG, &ru);
+            } while (pid == -1 && errno == EINTR);
+            if (pid == -1) {
+                crinitErrnoPrint("Could not reap child process %d.", e->pid);
+            }
+        }
+        if (pid <= 0) {
+            i++;
+            continue;
+        }
+        crinitProbe2(reap, pid, wstatus);
+
+        changed = true;
+        // If the entry has been dropped, another one has taken its place and needs to be looked at as well.
+        if (!crinitReaperStore(i, wstatus, &ru)) {
+            i++;
+        }
+    }
+    return changed;
+}
+
+static bool crinitReaperStore(size_t idx, int wstatus, const struct rusage *ru) {
+    crinitReaperEntry_t *e = &crinitReaper.entries[idx];
+    if (e->released) {
+        *e = crinitReaper.entries[--crinitReaper.size];
+        return idx < crinitReaper.size;
+    }
+    memset(&e->status, 0, sizeof(e->status));
+    e->status.si_signo = SIGCHLD;
+    e->status.si_pid = e->pid;
+    if (WIFEXITED(wstatus)) {
+        e->status.si_code = CLD_EXITED;
+        e->status.si_status = WEXITSTATUS(wstatus);
+    } else {
+        e->status.si_code = WCOREDUMP(wstatus) ? CLD_DUMPED : CLD_KILLED;
+        e->status.si_status = WTERMSIG(wstatus);
+    }
+    e->ru = *ru;
+    e->exited = true;
+    return false;
+}
+
+static crinitReaperEntry_t *crinitReaperFind(pid_t pid, bool liveOnly) {
+    for (size_t i = 0; i < crinitReaper.size; i++) {
+        const crinitReaperEntry_t *e = &crinitReaper.entries[i];
+        if (e->pid == pid && !e->collected && !(liveOnly && e->exited)) {
+            return &crinitReaper.entries[i];
+        }
+    }
+    return NULL;
+}
+
+static crinitReaperEntry_t *crinitReaperFindCollected(pid_t pid) {
+    for (size_t i = 0; i < crinitReaper.size; i++) {
+        if (crinitReaper.entries[i].pid == pid && crinitReaper.entries[i].collected) {
+            return &crinitReaper.entries[i];
+        }
+    }
+    return NULL;
+}
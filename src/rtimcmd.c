@@ -5,6 +5,7 @@
  */
 #include "rtimcmd.h"
 
+#include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
 #include <pthread.h>
@@ -12,7 +13,6 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/mount.h>
 #include <sys/reboot.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -22,8 +22,31 @@
 #include "crinit-version.h"
 #include "fseries.h"
 #include "globopt.h"
+#include "lockprof.h"
 #include "logio.h"
-#include "procdip.h"
+#include "metrics.h"
+#include "notiserv.h"
+#include "reaper.h"
+#include "shutdown.h"
+#include "timerdb.h"
+#include "trace.h"
+#ifdef ENABLE_ELOS
+#include "eloslog.h"
+#endif
+
+/** Size of the buffers used to format single numerical response arguments. **/
+#define CRINIT_RTIMCMD_NUM_STR_LEN 32
+/** Size of the buffers used to format the name and labels of a metric in a response to the "stats" command. **/
+#define CRINIT_RTIMCMD_METRIC_NAME_LEN 128
+/** Maximum number of metrics reported in addition to the metrics registry by the "stats" command. **/
+#define CRINIT_RTIMCMD_STATS_EXTRA 4
+#ifdef ENABLE_LOCK_PROFILING
+/** Maximum number of lock profiling metrics reported by the "stats" command. **/
+#define CRINIT_RTIMCMD_STATS_LOCKPROF CRINIT_LOCKPROF_SAMPLES
+#else
+/** Maximum number of lock profiling metrics reported by the "stats" command. **/
+#define CRINIT_RTIMCMD_STATS_LOCKPROF 0
+#endif
 
 /**
  * Argument structure for shdnThread().
@@ -33,14 +56,6 @@ typedef struct crinitShdnThrArgs {
     int shutdownCmd;      ///< The command for the reboot() syscall, see documentation of RB_* macros in man 7 reboot.
 } crinitShdnThrArgs_t;
 
-/**
- * A linked list to organize mount points that need to be handled before shutdown/reboot.
- */
-typedef struct crinitUnMountList {
-    struct crinitUnMountList *next;  ///< Pointer to next element.
-    char target[PATH_MAX];           ///< A mount point path.
-} crinitUnMountList_t;
-
 /**
  * Internal implementation of the "addtask" command on an crinitTaskDB_t.
  *
@@ -174,68 +189,96 @@ static int crinitExecRtimCmdTaskList(crinitTaskDB_t *ctx, crinitRtimCmd_t *res,
  * @return 0 on success, -1 on error
  */
 static int crinitExecRtimCmdGetVer(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd);
-
 /**
- * Internal implementation of the "shutdown" command.
+ * Internal implementation of the "graph" command on an crinitTaskDB_t.
  *
- * For documentation on the command itself, see crinitClientShutdown().
+ * For documentation on the command itself, see crinitClientGetTaskGraph().
  *
- * @param ctx  The currently running crinitTaskDB, needed to inhibit spawning of new processes during shutdown.
+ * @param ctx  The crinitTaskDB_t to operate on.
  * @param res  Return pointer for response/result.
- * @param cmd  The crinitRtimCmd to execute, used to pass the argument list.
+ * @param cmd  The crinitRtimCmd_t to execute, used to pass the argument list.
  *
  * @return 0 on success, -1 on error
  */
-static int crinitExecRtimCmdShutdown(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd);
+static int crinitExecRtimCmdGraph(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd);
 /**
- * Shutdown thread function.
+ * Internal implementation of the "trace" command.
  *
- * Run as a pthread, so that crinitExecRtimCmdShutdown() may return before the actual shutdown syscall is issued and the
- * requesting process is not blocked.
+ * For documentation on the command itself, see crinitClientGetBootTrace().
  *
- * @param args  Argument pointer, see ShdnThrArgs.
+ * @param ctx  Unused, the trace buffer is not part of the TaskDB.
+ * @param res  Return pointer for response/result.
+ * @param cmd  The crinitRtimCmd_t to execute, used to pass the argument list.
+ *
+ * @return 0 on success, -1 on error
  */
-static void *crinitShdnThread(void *args);
+static int crinitExecRtimCmdTrace(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd);
 /**
- * Wait function using nanosleep for the shutdown grace period.
+ * Internal implementation of the "stats" command.
  *
- * @param micros  Number of microseconds to wait.
+ * For documentation on the command itself, see crinitClientGetStats().
  *
- * @return  0 on success, -1 on error
+ * @param ctx  Unused, the metrics are not part of the TaskDB.
+ * @param res  Return pointer for response/result.
+ * @param cmd  The crinitRtimCmd_t to execute, used to pass the argument list.
+ *
+ * @return 0 on success, -1 on error
  */
-static inline int crinitGracePeriod(unsigned long long micros);
+static int crinitExecRtimCmdStats(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd);
 /**
- * Prepares mounted filesystems for shutdown.
+ * Internal implementation of the "usage" command.
  *
- * Performs MNT_DETACH if the file systems are not the root mount. The root mount is remounted read-only if it was
- * writable before.
+ * For documentation on the command itself, see crinitClientTaskGetUsage().
  *
- * @return  0 on success, -1 on error
+ * @param ctx  The TaskDB context to get the resource usage from.
+ * @param res  Return pointer for response/result.
+ * @param cmd  The crinitRtimCmd_t to execute, used to pass the argument list.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitExecRtimCmdUsage(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd);
+/**
+ * Append a counter or gauge to an array of metric samples.
+ *
+ * @param samples  The array to append to, must have room for another sample.
+ * @param n        Number of samples in \a samples, will be incremented.
+ * @param name     Name of the metric.
+ * @param type     Type of the metric, either CRINIT_METRIC_COUNTER or CRINIT_METRIC_GAUGE.
+ * @param value    Value of the metric.
  */
-static inline int crinitFsPrepareShutdown(void);
+static inline void crinitAppendMetricSample(crinitMetricSample_t *samples, size_t *n, const char *name,
+                                            crinitMetricType_t type, uint64_t value);
+
 /**
- * Generates a list of mount points that should be unmounted before shutdown/reboot.
+ * Internal implementation of the "shutdown" command.
+ *
+ * For documentation on the command itself, see crinitClientShutdown().
  *
- * The resulting list will include all entries from `/proc/mounts` whose source is not `none` and which are not the root
- * node. The list will be ordered newest mount first. Memory for the list elements will be allocated and needs to be
- * freed using crinitFreeUnMountList() when no longer in use.
+ * @param ctx  The currently running crinitTaskDB, needed to inhibit spawning of new processes during shutdown.
+ * @param res  Return pointer for response/result.
+ * @param cmd  The crinitRtimCmd to execute, used to pass the argument list.
  *
- * Additionally, crinitGenUnMountList() checks if the root mount entry is read-only, setting \a rootfsIsRo to true in
- * that case.
+ * @return 0 on success, -1 on error
+ */
+static int crinitExecRtimCmdShutdown(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd);
+/**
+ * Shutdown thread function.
  *
- * @param um          Return pointer for the UnMountList.
- * @param rootfsIsRo  Return pointer indicating if we are on a read-only rootfs.
+ * Run as a pthread, so that crinitExecRtimCmdShutdown() may return before the actual shutdown syscall is issued and the
+ * requesting process is not blocked.
  *
- * @return  0 on success, -1 on error
+ * @param args  Argument pointer, see ShdnThrArgs.
  */
-static inline int crinitGenUnMountList(crinitUnMountList_t **um, bool *rootfsIsRo);
+static void *crinitShdnThread(void *args);
 /**
- * Frees memory allocated for an crinitUnMountList_t by crinitGenUnMountList()
+ * Calculates the end of the shutdown grace period.
  *
- * @param um  The crinitUnMountList_t to free.
+ * @param deadline  Return pointer for the absolute point in time on `CLOCK_MONOTONIC` at which the grace period ends.
+ * @param micros    Length of the grace period in microseconds, starting now.
+ *
+ * @return  0 on success, -1 on error
  */
-static inline void crinitFreeUnMountList(crinitUnMountList_t *um);
-
+static inline int crinitGraceDeadline(struct timespec *deadline, unsigned long long micros);
 int crinitParseRtimCmd(crinitRtimCmd_t *out, const char *cmdStr) {
     if (out == NULL || cmdStr == NULL) {
         crinitErrPrint("Pointer parameters must not be NULL.");
@@ -415,6 +458,30 @@ int crinitExecRtimCmd(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRti
                 return -1;
             }
             return 0;
+        case CRINIT_RTIMCMD_C_GRAPH:
+            if (crinitExecRtimCmdGraph(ctx, res, cmd) == -1) {
+                crinitErrPrint("Could not execute runtime command \'GRAPH\'.");
+                return -1;
+            }
+            return 0;
+        case CRINIT_RTIMCMD_C_TRACE:
+            if (crinitExecRtimCmdTrace(ctx, res, cmd) == -1) {
+                crinitErrPrint("Could not execute runtime command \'TRACE\'.");
+                return -1;
+            }
+            return 0;
+        case CRINIT_RTIMCMD_C_STATS:
+            if (crinitExecRtimCmdStats(ctx, res, cmd) == -1) {
+                crinitErrPrint("Could not execute runtime command \'STATS\'.");
+                return -1;
+            }
+            return 0;
+        case CRINIT_RTIMCMD_C_USAGE:
+            if (crinitExecRtimCmdUsage(ctx, res, cmd) == -1) {
+                crinitErrPrint("Could not execute runtime command \'USAGE\'.");
+                return -1;
+            }
+            return 0;
 
         case CRINIT_RTIMCMD_R_ADDTASK:
         case CRINIT_RTIMCMD_R_ADDSERIES:
@@ -428,6 +495,10 @@ int crinitExecRtimCmd(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRti
         case CRINIT_RTIMCMD_R_TASKLIST:
         case CRINIT_RTIMCMD_R_SHUTDOWN:
         case CRINIT_RTIMCMD_R_GETVER:
+        case CRINIT_RTIMCMD_R_GRAPH:
+        case CRINIT_RTIMCMD_R_TRACE:
+        case CRINIT_RTIMCMD_R_STATS:
+        case CRINIT_RTIMCMD_R_USAGE:
         default:
             crinitErrPrint("Could not execute opcode %d. This is an unknown opcode or a response code.", cmd->op);
             return -1;
@@ -821,12 +892,6 @@ static int crinitExecRtimCmdStop(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, cons
         return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR, "Wrong number of arguments.");
     }
 
-    // Not sure if we need inhibit wait only for the kill branch.
-    if (crinitSetInhibitWait(true) == -1) {
-        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR,
-                                  "Could not inhibit waiting for processes.");
-    }
-
     if (crinitTaskDBSetTaskRespawnInhibit(ctx, true, cmd->args[0]) != 0) {
         return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR,
                                   "Could not access task to set respawnInhibit.");
@@ -836,33 +901,24 @@ static int crinitExecRtimCmdStop(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, cons
     if (crinitTaskDBGetTaskByName(ctx, &pTask, cmd->args[0]) != 0) {
         return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR, "Could not access task.");
     }
-    if (pTask->stopCmdsSize > 0) {
-        if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
-            return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR,
-                                      "Could not prepare to spawn STOP_COMMAND(s).");
-        }
-        if (ctx->spawnFunc(ctx, pTask, CRINIT_DISPATCH_THREAD_MODE_STOP) == -1) {
-            crinitErrPrint("Could not spawn new thread for execution STOP_COMMAND of task \'%s\'.", pTask->name);
-            pthread_mutex_unlock(&ctx->lock);
+    bool haveStopCmds = pTask->stopCmdsSize > 0;
+    pid_t taskPid = pTask->pid;
+    crinitFreeTask(pTask);
+    if (haveStopCmds) {
+        if (crinitTaskDBSpawnStopCommands(ctx, cmd->args[0]) == -1) {
             return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR,
                                       "Could not spawn STOP_COMMAND(s).");
         }
-        pthread_mutex_unlock(&ctx->lock);
     } else {
-        pid_t taskPid = pTask->pid;
         if (taskPid <= 0) {
             return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR,
                                       "No PID registered for task.");
         }
-        if (kill(taskPid, SIGTERM) == -1) {
+        if (crinitReaperKill(taskPid, SIGTERM) == -1) {
             return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR,
                                       "Could not send SIGTERM to process.");
         }
     }
-    if (crinitSetInhibitWait(false) == -1) {
-        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR,
-                                  "Could not reactivate waiting for processes.");
-    }
     return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 1, CRINIT_RTIMCMD_RES_OK);
 }
 
@@ -875,10 +931,6 @@ static int crinitExecRtimCmdKill(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, cons
         return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_KILL, 2, CRINIT_RTIMCMD_RES_ERR, "Wrong number of arguments.");
     }
 
-    if (crinitSetInhibitWait(true) == -1) {
-        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR,
-                                  "Could not inhibit waiting for processes.");
-    }
     pid_t taskPid = 0;
     if (crinitTaskDBGetTaskPID(ctx, &taskPid, cmd->args[0]) == -1) {
         return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_KILL, 2, CRINIT_RTIMCMD_RES_ERR, "Could not access task.");
@@ -886,14 +938,10 @@ static int crinitExecRtimCmdKill(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, cons
     if (taskPid <= 0) {
         return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_KILL, 2, CRINIT_RTIMCMD_RES_ERR, "No PID registered for task.");
     }
-    if (kill(taskPid, SIGKILL) == -1) {
+    if (crinitReaperKill(taskPid, SIGKILL) == -1) {
         return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_KILL, 2, CRINIT_RTIMCMD_RES_ERR,
                                   "Could not send SIGKILL to Process.");
     }
-    if (crinitSetInhibitWait(false) == -1) {
-        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STOP, 2, CRINIT_RTIMCMD_RES_ERR,
-                                  "Could not reactivate waiting for processes.");
-    }
     return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_KILL, 1, CRINIT_RTIMCMD_RES_OK);
 }
 
@@ -966,6 +1014,15 @@ static int crinitExecRtimCmdNotify(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, co
         }
     }
 
+    crinitTaskState_t notifiedState = 0;
+    if (ready > 0) {
+        notifiedState = CRINIT_TASK_STATE_RUNNING | CRINIT_TASK_STATE_NOTIFIED;
+    }
+    if (stopping > 0) {
+        notifiedState = CRINIT_TASK_STATE_DONE | CRINIT_TASK_STATE_NOTIFIED;
+    }
+    crinitTraceInstant(CRINIT_TRACE_NOTIFY, (int64_t)notifiedState, "%s", cmd->args[0]);
+
     if (pid > 0) {
         if (crinitTaskDBSetTaskPID(ctx, pid, cmd->args[0]) == -1) {
             return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_NOTIFY, 2, CRINIT_RTIMCMD_RES_ERR,
@@ -1105,8 +1162,8 @@ static int crinitExecRtimCmdStatus(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, co
     *groupnameStr = '\0';
     groupnameStr++;
 
-    if (crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STATUS, 10, CRINIT_RTIMCMD_RES_OK, resStr, pidStr, ctStr, stStr, etStr,
-                           userStr, groupStr, usernameStr, groupnameStr) == -1) {
+    if (crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STATUS, CRINIT_RTIMCMD_STATUS_ARGS, CRINIT_RTIMCMD_RES_OK, resStr,
+                           pidStr, ctStr, stStr, etStr, userStr, groupStr, usernameStr, groupnameStr) == -1) {
         free(resStr);
         return -1;
     }
@@ -1176,6 +1233,313 @@ static int crinitExecRtimCmdGetVer(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, co
                               crinitVersion.git);
 }
 
+static int crinitExecRtimCmdGraph(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd) {
+    crinitDbgInfoPrint("Will execute runtime command \'GRAPH\' with following arguments:");
+    for (size_t i = 0; i < cmd->argc; i++) {
+        crinitDbgInfoPrint("    args[%zu] = %s", i, cmd->args[i]);
+    }
+    if (cmd->argc != 0) {
+        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_GRAPH, 2, CRINIT_RTIMCMD_RES_ERR, "Wrong number of arguments.");
+    }
+
+    if (crinitTaskDBAnalyzeGraph(ctx) == -1) {
+        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_GRAPH, 2, CRINIT_RTIMCMD_RES_ERR,
+                                  "Could not analyze dependency graph.");
+    }
+
+    int ret = 0;
+    size_t numTasks;
+    char **tasks;
+    if (crinitTaskDBExportTaskNamesToArray(ctx, &tasks, &numTasks) == -1) {
+        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_GRAPH, 2, CRINIT_RTIMCMD_RES_ERR, "Memory allocation error.");
+    }
+
+    // One buffer per numerical field, i.e. all fields but the name.
+    const size_t numLen = 32;
+    const char **args = malloc((numTasks * CRINIT_RTIMCMD_GRAPH_FIELDS + 1) * sizeof(*args));
+    char *numBuf = malloc(numTasks * (CRINIT_RTIMCMD_GRAPH_FIELDS - 1) * numLen + 1);
+    if (args == NULL || numBuf == NULL) {
+        ret = crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_GRAPH, 2, CRINIT_RTIMCMD_RES_ERR, "Memory allocation error.");
+        goto out;
+    }
+
+    args[0] = CRINIT_RTIMCMD_RES_OK;
+    for (size_t i = 0; i < numTasks; i++) {
+        crinitTask_t *pTask = crinitTaskDBBorrowTask(ctx, tasks[i]);
+        if (pTask == NULL) {
+            ret = crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_GRAPH, 2, CRINIT_RTIMCMD_RES_ERR,
+                                     "Could not get access to task in TaskDB.");
+            goto out;
+        }
+        crinitTaskGraphInfo_t graph = pTask->graph;
+        if (crinitTaskDBRemit(ctx) == -1) {
+            crinitErrPrint(
+                "Could not release mutex on TaskDB. This should not happen. Will try to continue but Crinit may lock "
+                "up.");
+        }
+
+        const char **taskArgs = &args[1 + i * CRINIT_RTIMCMD_GRAPH_FIELDS];
+        char *taskBuf = &numBuf[i * (CRINIT_RTIMCMD_GRAPH_FIELDS - 1) * numLen];
+        taskArgs[0] = tasks[i];
+        for (size_t j = 1; j < CRINIT_RTIMCMD_GRAPH_FIELDS; j++) {
+            taskArgs[j] = &taskBuf[(j - 1) * numLen];
+        }
+        snprintf(&taskBuf[0], numLen, "%zu", graph.depth);
+        snprintf(&taskBuf[numLen], numLen, "%zu", graph.fanOut);
+        snprintf(&taskBuf[2 * numLen], numLen, "%zu", graph.chainLen);
+        snprintf(&taskBuf[3 * numLen], numLen, "%llu.%.9llu", (unsigned long long)(graph.chainNs / 1000000000uLL),
+                 (unsigned long long)(graph.chainNs % 1000000000uLL));
+        snprintf(&taskBuf[4 * numLen], numLen, "%d", graph.critical);
+    }
+
+    ret = crinitBuildRtimCmdArray(res, CRINIT_RTIMCMD_R_GRAPH, numTasks * CRINIT_RTIMCMD_GRAPH_FIELDS + 1, args);
+
+out:
+    free(args);
+    free(numBuf);
+    for (size_t i = 0; i < numTasks; i++) {
+        free(tasks[i]);
+    }
+    free(tasks);
+
+    return ret;
+}
+
+static int crinitExecRtimCmdTrace(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd) {
+    CRINIT_PARAM_UNUSED(ctx);
+    crinitDbgInfoPrint("Will execute runtime command \'TRACE\' with following arguments:");
+    for (size_t i = 0; i < cmd->argc; i++) {
+        crinitDbgInfoPrint("    args[%zu] = %s", i, cmd->args[i]);
+    }
+    if (cmd->argc != 1) {
+        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_TRACE, 2, CRINIT_RTIMCMD_RES_ERR, "Wrong number of arguments.");
+    }
+
+    char *endPtr = NULL;
+    errno = 0;
+    uint64_t seq = strtoull(cmd->args[0], &endPtr, 10);
+    if (errno != 0 || endPtr == cmd->args[0] || *endPtr != '\0') {
+        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_TRACE, 2, CRINIT_RTIMCMD_RES_ERR,
+                                  "Invalid trace sequence number.");
+    }
+
+    int ret = 0;
+    // One buffer per numerical field, i.e. all fields but the name, plus the two header fields.
+    const size_t numLen = CRINIT_RTIMCMD_NUM_STR_LEN;
+    const size_t maxArgs = CRINIT_RTIMCMD_TRACE_CHUNK * CRINIT_RTIMCMD_TRACE_FIELDS + 3;
+    crinitTraceRecord_t *recs = malloc(CRINIT_RTIMCMD_TRACE_CHUNK * sizeof(*recs));
+    const char **args = malloc(maxArgs * sizeof(*args));
+    char *numBuf = malloc((CRINIT_RTIMCMD_TRACE_CHUNK * (CRINIT_RTIMCMD_TRACE_FIELDS - 1) + 2) * numLen);
+    if (recs == NULL || args == NULL || numBuf == NULL) {
+        ret = crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_TRACE, 2, CRINIT_RTIMCMD_RES_ERR, "Memory allocation error.");
+        goto out;
+    }
+
+    uint64_t dropped = 0;
+    size_t numRecs = crinitTraceRead(recs, CRINIT_RTIMCMD_TRACE_CHUNK, &seq, &dropped);
+
+    args[0] = CRINIT_RTIMCMD_RES_OK;
+    args[1] = &numBuf[0];
+    args[2] = &numBuf[numLen];
+    snprintf(&numBuf[0], numLen, "%llu", (unsigned long long)seq);
+    snprintf(&numBuf[numLen], numLen, "%llu", (unsigned long long)dropped);
+    for (size_t i = 0; i < numRecs; i++) {
+        const crinitTraceRecord_t *r = &recs[i];
+        const char **recArgs = &args[3 + i * CRINIT_RTIMCMD_TRACE_FIELDS];
+        char *recBuf = &numBuf[(2 + i * (CRINIT_RTIMCMD_TRACE_FIELDS - 1)) * numLen];
+        for (size_t j = 0; j < CRINIT_RTIMCMD_TRACE_FIELDS - 1; j++) {
+            recArgs[j] = &recBuf[j * numLen];
+        }
+        recArgs[CRINIT_RTIMCMD_TRACE_FIELDS - 1] = r->name;
+        snprintf(&recBuf[0], numLen, "%u", (unsigned)r->type);
+        snprintf(&recBuf[numLen], numLen, "%llu", (unsigned long long)r->ts);
+        snprintf(&recBuf[2 * numLen], numLen, "%llu", (unsigned long long)r->dur);
+        snprintf(&recBuf[3 * numLen], numLen, "%d", (int)r->tid);
+        snprintf(&recBuf[4 * numLen], numLen, "%lld", (long long)r->arg);
+    }
+
+    ret = crinitBuildRtimCmdArray(res, CRINIT_RTIMCMD_R_TRACE, numRecs * CRINIT_RTIMCMD_TRACE_FIELDS + 3, args);
+
+out:
+    free(recs);
+    free(args);
+    free(numBuf);
+    return ret;
+}
+
+static int crinitExecRtimCmdStats(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd) {
+    CRINIT_PARAM_UNUSED(ctx);
+    crinitDbgInfoPrint("Will execute runtime command \'STATS\' with following arguments:");
+    for (size_t i = 0; i < cmd->argc; i++) {
+        crinitDbgInfoPrint("    args[%zu] = %s", i, cmd->args[i]);
+    }
+    if (cmd->argc != 0) {
+        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STATS, 2, CRINIT_RTIMCMD_RES_ERR, "Wrong number of arguments.");
+    }
+
+    int ret = 0;
+    const size_t maxSamples = CRINIT_METRICS_SAMPLES + CRINIT_RTIMCMD_STATS_LOCKPROF + CRINIT_RTIMCMD_STATS_EXTRA;
+    const size_t sampleFields = CRINIT_RTIMCMD_STATS_FIELDS + CRINIT_METRIC_BUCKETS;
+    const size_t numLen = CRINIT_RTIMCMD_NUM_STR_LEN, nameLen = CRINIT_RTIMCMD_METRIC_NAME_LEN;
+    const char **args = NULL;
+    char *numBuf = NULL, *nameBuf = NULL;
+    crinitMetricSample_t *samples = malloc(maxSamples * sizeof(*samples));
+    if (samples == NULL) {
+        ret = crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STATS, 2, CRINIT_RTIMCMD_RES_ERR, "Memory allocation error.");
+        goto out;
+    }
+
+    size_t numSamples = crinitMetricsRead(samples, CRINIT_METRICS_SAMPLES);
+#ifdef ENABLE_LOCK_PROFILING
+    numSamples += crinitLockProfRead(&samples[numSamples], CRINIT_LOCKPROF_SAMPLES);
+#endif
+
+    // Add the values kept by the subsystems themselves, skipping those which are unavailable.
+    size_t poolSize = 0, poolAvail = 0;
+    if (crinitInterfaceServerGetStats(&poolSize, &poolAvail) == 0) {
+        crinitAppendMetricSample(samples, &numSamples, "crinit_threadpool_threads", CRINIT_METRIC_GAUGE, poolSize);
+        crinitAppendMetricSample(samples, &numSamples, "crinit_threadpool_available_threads", CRINIT_METRIC_GAUGE,
+                                 poolAvail);
+    }
+    crinitTimerDBStats_t timerStats;
+    if (crinitTimerDBGetStats(&timerStats) == 0) {
+        crinitAppendMetricSample(samples, &numSamples, "crinit_timer_wakeups_total", CRINIT_METRIC_COUNTER,
+                                 timerStats.wakeups);
+    }
+#ifdef ENABLE_ELOS
+    crinitEloslogStats_t elosStats;
+    if (crinitEloslogGetStats(&elosStats) == 0) {
+        crinitAppendMetricSample(samples, &numSamples, "crinit_elos_queue_depth", CRINIT_METRIC_GAUGE,
+                                 elosStats.queued);
+    }
+#endif
+
+    // Most of the lock profiling metrics are typically unused, so only allocate for the samples actually read.
+    args = malloc((numSamples * sampleFields + 1) * sizeof(*args));
+    numBuf = malloc(numSamples * (sampleFields - 1) * numLen);
+    nameBuf = malloc(numSamples * nameLen);
+    if (args == NULL || numBuf == NULL || nameBuf == NULL) {
+        ret = crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_STATS, 2, CRINIT_RTIMCMD_RES_ERR, "Memory allocation error.");
+        goto out;
+    }
+
+    size_t argc = 0;
+    args[argc++] = CRINIT_RTIMCMD_RES_OK;
+    for (size_t i = 0; i < numSamples; i++) {
+        const crinitMetricSample_t *m = &samples[i];
+        char *sampleNum = &numBuf[i * (sampleFields - 1) * numLen];
+        char *sampleName = &nameBuf[i * nameLen];
+
+        snprintf(&sampleNum[0], numLen, "%d", (int)m->type);
+        if (m->labels != NULL) {
+            snprintf(sampleName, nameLen, "%s{%s}", m->name, m->labels);
+        } else {
+            snprintf(sampleName, nameLen, "%s", m->name);
+        }
+        snprintf(&sampleNum[numLen], numLen, "%llu", (unsigned long long)m->value);
+        args[argc++] = &sampleNum[0];
+        args[argc++] = sampleName;
+        args[argc++] = &sampleNum[numLen];
+        if (m->type != CRINIT_METRIC_HISTOGRAM) {
+            continue;
+        }
+        for (size_t j = 0; j < CRINIT_METRIC_BUCKETS; j++) {
+            char *bucketNum = &sampleNum[(2 + j) * numLen];
+            snprintf(bucketNum, numLen, "%llu", (unsigned long long)m->buckets[j]);
+            args[argc++] = bucketNum;
+        }
+    }
+
+    ret = crinitBuildRtimCmdArray(res, CRINIT_RTIMCMD_R_STATS, argc, args);
+
+out:
+    free(samples);
+    free(args);
+    free(numBuf);
+    free(nameBuf);
+    return ret;
+}
+
+static int crinitExecRtimCmdUsage(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd) {
+    crinitDbgInfoPrint("Will execute runtime command \'USAGE\' with following arguments:");
+    for (size_t i = 0; i < cmd->argc; i++) {
+        crinitDbgInfoPrint("    args[%zu] = %s", i, cmd->args[i]);
+    }
+    if (cmd->argc != 1) {
+        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_USAGE, 2, CRINIT_RTIMCMD_RES_ERR, "Wrong number of arguments.");
+    }
+
+    crinitTask_t *pTask = crinitTaskDBBorrowTask(ctx, cmd->args[0]);
+    if (pTask == NULL) {
+        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_USAGE, 2, CRINIT_RTIMCMD_RES_ERR,
+                                  "Could not get access to requested task in TaskDB.");
+    }
+
+    // The task's total comes first, followed by its COMMANDs and STOP_COMMANDs in order of definition.
+    size_t numCmds = pTask->cmdsSize, numStopCmds = pTask->stopCmdsSize;
+    size_t numUsages = 1 + numCmds + numStopCmds;
+    crinitTaskUsage_t *usages = malloc(numUsages * sizeof(*usages));
+    if (usages != NULL) {
+        usages[0] = pTask->usage;
+        for (size_t i = 0; i < numCmds; i++) {
+            usages[1 + i] = pTask->cmds[i].usage;
+        }
+        for (size_t i = 0; i < numStopCmds; i++) {
+            usages[1 + numCmds + i] = pTask->stopCmds[i].usage;
+        }
+    }
+
+    if (crinitTaskDBRemit(ctx) == -1) {
+        crinitErrPrint(
+            "Could not release mutex on TaskDB. This should not happen. Will try to continue but Crinit may lock up.");
+    }
+
+    if (usages == NULL) {
+        return crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_USAGE, 2, CRINIT_RTIMCMD_RES_ERR, "Memory allocation error.");
+    }
+
+    int ret = 0;
+    const size_t numLen = CRINIT_RTIMCMD_NUM_STR_LEN;
+    const size_t argc = 3 + numUsages * CRINIT_RTIMCMD_USAGE_FIELDS;
+    const char **args = malloc(argc * sizeof(*args));
+    char *numBuf = malloc((argc - 1) * numLen);
+    if (args == NULL || numBuf == NULL) {
+        ret = crinitBuildRtimCmd(res, CRINIT_RTIMCMD_R_USAGE, 2, CRINIT_RTIMCMD_RES_ERR, "Memory allocation error.");
+        goto out;
+    }
+
+    args[0] = CRINIT_RTIMCMD_RES_OK;
+    for (size_t i = 1; i < argc; i++) {
+        args[i] = &numBuf[(i - 1) * numLen];
+    }
+    snprintf(&numBuf[0], numLen, "%zu", numCmds);
+    snprintf(&numBuf[numLen], numLen, "%zu", numStopCmds);
+    for (size_t i = 0; i < numUsages; i++) {
+        const crinitTaskUsage_t *u = &usages[i];
+        char *usageBuf = &numBuf[(2 + i * CRINIT_RTIMCMD_USAGE_FIELDS) * numLen];
+        snprintf(&usageBuf[0], numLen, "%lld.%.9ld", (long long)u->userTime.tv_sec, u->userTime.tv_nsec);
+        snprintf(&usageBuf[numLen], numLen, "%lld.%.9ld", (long long)u->sysTime.tv_sec, u->sysTime.tv_nsec);
+        snprintf(&usageBuf[2 * numLen], numLen, "%ld", u->maxRss);
+        snprintf(&usageBuf[3 * numLen], numLen, "%ld", u->inBlock);
+        snprintf(&usageBuf[4 * numLen], numLen, "%ld", u->outBlock);
+        snprintf(&usageBuf[5 * numLen], numLen, "%lu", u->numProcs);
+    }
+
+    ret = crinitBuildRtimCmdArray(res, CRINIT_RTIMCMD_R_USAGE, argc, args);
+
+out:
+    free(usages);
+    free(args);
+    free(numBuf);
+    return ret;
+}
+
+static inline void crinitAppendMetricSample(crinitMetricSample_t *samples, size_t *n, const char *name,
+                                            crinitMetricType_t type, uint64_t value) {
+    samples[*n] = (crinitMetricSample_t){.name = name, .type = type, .value = value};
+    (*n)++;
+}
+
 static int crinitExecRtimCmdShutdown(crinitTaskDB_t *ctx, crinitRtimCmd_t *res, const crinitRtimCmd_t *cmd) {
     if (ctx == NULL || res == NULL || cmd == NULL) {
         crinitErrPrint("Pointer parameters must not be NULL");
@@ -1232,19 +1596,8 @@ static void *crinitShdnThread(void *args) {
     int shutdownCmd = a->shutdownCmd;
     free(args);
 
-    bool haveStopCommands = false;
-    if ((errno = pthread_mutex_lock(&ctx->lock)) == 0) {
-        crinitTask_t *pTask;
-        crinitTaskDbForEach(ctx, pTask) {
-            if (pTask->stopCmdsSize > 0) {
-                haveStopCommands = true;
-                if (ctx->spawnFunc(ctx, pTask, CRINIT_DISPATCH_THREAD_MODE_STOP) == -1) {
-                    crinitErrPrint("Could not spawn new thread for execution STOP_COMMAND of task \'%s\'.",
-                                   pTask->name);
-                }
-            }
-        }
-        pthread_mutex_unlock(&ctx->lock);
+    if (crinitTaskDBSetSpawnInhibit(ctx, true) == -1) {
+        crinitErrPrint("Could not inhibit spawning of new tasks. Continuing anyway.");
     }
 
     unsigned long long gpMicros = CRINIT_CONFIG_DEFAULT_SHDGRACEP;
@@ -1253,164 +1606,46 @@ static void *crinitShdnThread(void *args) {
         crinitErrPrint("Could not read global option for shutdown grace period, using default: %lluus.", gpMicros);
     }
 
-    if (haveStopCommands && crinitGracePeriod(gpMicros) == -1) {
-        crinitErrPrint("Could not wait out the shutdown grace period, continuing anyway.");
-    }
-
-    if (crinitTaskDBSetSpawnInhibit(ctx, true) == -1) {
-        crinitErrPrint("Could not inhibit spawning of new tasks. Continuing anyway.");
+    if (crinitShutdownStopTasks(ctx, gpMicros) == -1) {
+        crinitErrPrint("Could not stop all tasks in dependency order, continuing anyway.");
     }
 
+    // Catch everything not belonging to a task, e.g. processes started by a terminal login.
+    struct timespec deadline;
     kill(-1, SIGCONT);
     kill(-1, SIGTERM);
     crinitDbgInfoPrint("Sending SIGTERM to all processes.");
-    if (crinitGracePeriod(gpMicros) == -1) {
-        crinitErrPrint("Could not wait out the shutdown grace period, continuing anyway.");
+    // Continue as soon as all our children are gone, only processes not exiting within the grace period get SIGKILL.
+    if (crinitGraceDeadline(&deadline, gpMicros) == 0 && crinitReaperWaitAll(&deadline) == 0) {
+        crinitDbgInfoPrint("All processes have terminated.");
+    } else {
+        if (errno != ETIMEDOUT) {
+            crinitErrPrint("Could not wait for processes to terminate, continuing anyway.");
+        }
+        kill(-1, SIGKILL);
+        crinitDbgInfoPrint("Sending SIGKILL to all processes.");
     }
-    kill(-1, SIGKILL);
-    crinitDbgInfoPrint("Sending SIGKILL to all processes.");
-    if (crinitFsPrepareShutdown() == -1) {
+    if (crinitShutdownFilesystems() == -1) {
         crinitErrPrint(
             "Could not un- or remount filesystems cleanly, continuing anyway. Some filesystems may be dirty on "
             "next "
             "boot.");
     }
+    crinitLogFlush();
     if (reboot(shutdownCmd) == -1) {
         crinitErrnoPrint("Reboot syscall failed.");
     }
     return NULL;
 }
 
-static inline int crinitGracePeriod(unsigned long long micros) {
-    struct timespec t;
-    if (clock_gettime(CLOCK_MONOTONIC, &t) == -1) {
+static inline int crinitGraceDeadline(struct timespec *deadline, unsigned long long micros) {
+    if (clock_gettime(CLOCK_MONOTONIC, deadline) == -1) {
         crinitErrnoPrint("Could not get current time from monotonic clock.");
         return -1;
     }
-    t.tv_sec += (time_t)(micros / 1000000uLL);
-    unsigned long long nsec = ((micros % 1000000uLL) * 1000uLL) + (unsigned long long)t.tv_nsec;
-    t.tv_sec += (time_t)(nsec / 1000000000uLL);
-    t.tv_nsec = (long)(nsec % 1000000000uLL);
-    int ret = 0;
-    do {
-        ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL);
-    } while (ret == -1 && errno == EINTR);
-    if (ret == -1) {
-        crinitErrnoPrint("Could not sleep for %lluus.", micros);
-        return -1;
-    }
+    deadline->tv_sec += (time_t)(micros / 1000000uLL);
+    unsigned long long nsec = ((micros % 1000000uLL) * 1000uLL) + (unsigned long long)deadline->tv_nsec;
+    deadline->tv_sec += (time_t)(nsec / 1000000000uLL);
+    deadline->tv_nsec = (long)(nsec % 1000000000uLL);
     return 0;
 }
-
-static inline int crinitGenUnMountList(crinitUnMountList_t **ml, bool *rootfsIsRo) {
-    if (ml == NULL || rootfsIsRo == NULL) {
-        crinitErrPrint("Input parameters must not be NULL.");
-        return -1;
-    }
-    *rootfsIsRo = false;
-    FILE *mountListStream = fopen("/proc/mounts", "re");
-    if (mountListStream == NULL) {
-        crinitErrnoPrint("Could not open \'/proc/mounts\' for reading.");
-        return -1;
-    }
-    crinitUnMountList_t *pList = malloc(sizeof(crinitUnMountList_t));
-    if (pList == NULL) {
-        crinitErrnoPrint("Could not allocate memory for list of mount points to be unmounted.");
-        fclose(mountListStream);
-        return -1;
-    }
-    pList->next = NULL;
-    while (fgets(pList->target, sizeof(pList->target), mountListStream) != NULL) {
-        char *strtokState = NULL;
-        pList->target[sizeof(pList->target) - 1] = '\0';
-        // Filter out things like tmpfs, proc, sysfs mounted from 'none'.
-        char *runner = strtok_r(pList->target, " ", &strtokState);
-        if (runner == NULL || strcmp(runner, "none") == 0) {
-            pList->target[0] = '\0';
-            continue;
-        }
-        // Mountpoint
-        runner = strtok_r(NULL, " ", &strtokState);
-        if (runner == NULL) {
-            pList->target[0] = '\0';
-            continue;
-        }
-
-        // If it is the root mount...
-        if (strcmp(runner, "/") == 0) {
-            // jump over fstype...
-            runner = strtok_r(NULL, " ", &strtokState);
-            if (runner == NULL) {
-                pList->target[0] = '\0';
-                continue;
-            }
-            // and check if it's already mounted read-only.
-            runner = strtok_r(NULL, " ", &strtokState);
-            if (runner == NULL || (strncmp(runner, "ro,", 3) != 0 && strncmp(runner, "ro ", 3) != 0)) {
-                pList->target[0] = '\0';
-                continue;
-            }
-            *rootfsIsRo = true;
-        } else {
-            // Put the mount point into the list in reverse order so we're beginning with the newest entry.
-            memmove(pList->target, runner, strlen(runner) + 1);
-            crinitUnMountList_t *new = malloc(sizeof(crinitUnMountList_t));
-            if (new == NULL) {
-                crinitErrnoPrint("Could not allocate memory for list of mount points to be unmounted.");
-                fclose(mountListStream);
-                crinitFreeUnMountList(pList);
-                return -1;
-            }
-            new->next = pList;
-            new->target[0] = '\0';
-            pList = new;
-        }
-    }
-    *ml = pList;
-    fclose(mountListStream);
-    return 0;
-}
-
-static inline void crinitFreeUnMountList(crinitUnMountList_t *ml) {
-    crinitUnMountList_t *prev;
-    while (ml != NULL) {
-        prev = ml;
-        ml = ml->next;
-        free(prev);
-    }
-}
-
-static inline int crinitFsPrepareShutdown(void) {
-    int out = 0;
-    crinitUnMountList_t *um = NULL;
-    bool rootfsIsRo;
-
-    if (crinitGenUnMountList(&um, &rootfsIsRo) == -1) {
-        crinitErrPrint(
-            "Could not generate list of targets to unmount. Will at least try to remount root filesystem as "
-            "read-only.");
-        rootfsIsRo = false;
-        out = -1;
-    } else {
-        crinitUnMountList_t *runner = um;
-        while (runner != NULL) {
-            if (runner->target[0] != '\0') {
-                crinitDbgInfoPrint("Will unmount target \'%s\'.", runner->target);
-                // Perform a lazy unmount of all targets in the list (does not include root node).
-                if (umount2(runner->target, MNT_DETACH) == -1) {
-                    crinitErrnoPrint("Could not umount (detach) mountpoint \'%s\'. Continuing anyway.", runner->target);
-                    out = -1;
-                }
-            }
-            runner = runner->next;
-        }
-        crinitFreeUnMountList(um);
-    }
-    // If it is (possibly) an rw rootfs, try remounting it ro.
-    if (!rootfsIsRo && mount(NULL, "/", NULL, MS_REMOUNT | MS_RDONLY, NULL) == -1) {
-        crinitErrnoPrint("Could not remount rootfs read-only, continuing anyway. Filesystem may be dirty on boot.");
-        out = -1;
-    }
-    sync();
-    return out;
-}
@@ -0,0 +1,451 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file shutdown.c
+ * @brief Implementation of stopping the tasks of a TaskDB in dependency order and unmounting filesystems on shutdown.
+ */
+#define _GNU_SOURCE  ///< Needed for syncfs().
+#include "shutdown.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mount.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "logio.h"
+#include "mountinfo.h"
+#include "reaper.h"
+#include "taskgraph.h"
+
+/** Number of nanoseconds in a second. **/
+#define CRINIT_SHUTDOWN_NS_PER_SEC 1000000000LL
+
+/**
+ * Progress of a single task during crinitShutdownStopTasks().
+ */
+typedef enum crinitShutdownPhase {
+    CRINIT_SHUTDOWN_PENDING = 0,  ///< Waiting for the tasks depending on it to stop.
+    CRINIT_SHUTDOWN_STOPPING,     ///< STOP_COMMANDs have been started or `SIGTERM` has been sent.
+    CRINIT_SHUTDOWN_STOPPED       ///< The task has terminated or has been killed.
+} crinitShutdownPhase_t;
+
+/**
+ * State of a single task during crinitShutdownStopTasks().
+ */
+typedef struct crinitShutdownTask {
+    crinitShutdownPhase_t phase;  ///< Progress of the task.
+    pid_t mainPid;                ///< PID of the task's process at the time stopping began, -1 if there was none.
+    struct timespec deadline;     ///< Point in time on `CLOCK_MONOTONIC` at which the task will be killed.
+} crinitShutdownTask_t;
+
+/**
+ * Shared state of the threads of crinitShutdownFilesystems().
+ */
+typedef struct crinitShutdownFsCtx {
+    pthread_mutex_t lock;     ///< Protects all other members.
+    pthread_cond_t changed;   ///< Signalled when a mount has become ready or everything is done.
+    crinitMountTree_t tree;   ///< The mount tree, crinitMountEntry_t::numChld counts the children still mounted.
+    size_t *ready;            ///< Stack of indices of mounts without mounted children, waiting to be unmounted.
+    size_t numReady;          ///< Number of elements in crinitShutdownFsCtx_t::ready.
+    size_t remaining;         ///< Number of mounts not yet handled.
+    int result;               ///< Return value of crinitShutdownFilesystems(), set to -1 on any failure.
+} crinitShutdownFsCtx_t;
+
+/**
+ * Start stopping a task by spawning its STOP_COMMANDs or sending `SIGTERM`. Caller must hold crinitTaskDB_t::lock.
+ *
+ * @param ctx               The TaskDB containing the task.
+ * @param t                 The task to stop.
+ * @param st                The shutdown state of \a t.
+ * @param now               The current time on `CLOCK_MONOTONIC`.
+ * @param defaultTimeoutUs  Timeout in microseconds if crinitTask_t::stopTimeout is not set.
+ */
+static void crinitShutdownBegin(crinitTaskDB_t *ctx, crinitTask_t *t, crinitShutdownTask_t *st,
+                                const struct timespec *now, unsigned long long defaultTimeoutUs);
+/**
+ * Check if a stopping task has terminated. Caller must hold crinitTaskDB_t::lock.
+ *
+ * @param t   The task to check.
+ * @param st  The shutdown state of \a t.
+ *
+ * @return  true if the STOP_COMMANDs of \a t have finished and its process has terminated, false otherwise
+ */
+static bool crinitShutdownIsStopped(const crinitTask_t *t, const crinitShutdownTask_t *st);
+/**
+ * Send a signal to a task, using its cgroup if it has one of its own.
+ *
+ * @param t    The task to signal.
+ * @param pid  The PID to signal if the task has no cgroup of its own.
+ * @param sig  The signal to send.
+ */
+static void crinitShutdownSignal(crinitTask_t *t, pid_t pid, int sig);
+/**
+ * Mark a task as stopped and release the tasks it depends on.
+ *
+ * @param plan        The stop plan.
+ * @param st          The shutdown states of all tasks.
+ * @param idx         Index of the stopped task.
+ * @param numStopped  Counter of stopped tasks to increment.
+ */
+static void crinitShutdownFinish(crinitTaskGraphStopPlan_t *plan, crinitShutdownTask_t *st, size_t idx,
+                                 size_t *numStopped);
+/**
+ * Worker thread of crinitShutdownFilesystems(), handles ready mounts until all mounts are done.
+ *
+ * @param args  Pointer to the crinitShutdownFsCtx_t.
+ *
+ * @return  NULL
+ */
+static void *crinitShutdownFsWorker(void *args);
+/**
+ * Sync and unmount a single filesystem and log the time it took.
+ *
+ * Does nothing for the root mount and mounts from `none`.
+ *
+ * @param m  The mount to handle, its child mounts must already be unmounted.
+ *
+ * @return  0 on success, -1 on error
+ */
+static int crinitShutdownFsUnmount(const crinitMountEntry_t *m);
+/**
+ * Calculate the number of microseconds between two points in time.
+ *
+ * @return  \a end minus \a start in microseconds
+ */
+static inline long long crinitShutdownTimespecDiffUs(const struct timespec *start, const struct timespec *end);
+/**
+ * Add a number of microseconds to a timespec.
+ *
+ * @param ts      The timespec to modify.
+ * @param micros  The number of microseconds to add.
+ */
+static inline void crinitShutdownTimespecAddUs(struct timespec *ts, unsigned long long micros);
+/**
+ * Check if a timespec lies before another.
+ *
+ * @return  true if \a a is earlier than \a b, false otherwise
+ */
+static inline bool crinitShutdownTimespecBefore(const struct timespec *a, const struct timespec *b);
+
+int crinitShutdownStopTasks(crinitTaskDB_t *ctx, unsigned long long defaultTimeoutUs) {
+    crinitNullCheck(-1, ctx);
+
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    // Tasks added from here on are not part of the plan, they are covered by the final SIGTERM/SIGKILL to everyone.
+    size_t numTasks = ctx->taskSetItems;
+    crinitTaskGraphStopPlan_t plan;
+    if (crinitTaskGraphStopPlan(&plan, ctx->taskSet, numTasks) == -1) {
+        crinitErrPrint("Could not determine the order to stop tasks in.");
+        crinitTaskDBUnlock(ctx);
+        return -1;
+    }
+    crinitShutdownTask_t *st = calloc(numTasks, sizeof(*st));
+    if (numTasks > 0 && st == NULL) {
+        crinitErrnoPrint("Could not allocate memory for shutdown state of %zu tasks.", numTasks);
+        crinitTaskGraphStopPlanDestroy(&plan);
+        crinitTaskDBUnlock(ctx);
+        return -1;
+    }
+
+    int ret = 0;
+    size_t numStopped = 0;
+    while (numStopped < numTasks) {
+        struct timespec now;
+        if (clock_gettime(CLOCK_MONOTONIC, &now) == -1) {
+            crinitErrnoPrint("Could not get current time from monotonic clock.");
+            ret = -1;
+            break;
+        }
+        struct timespec wakeup = now;
+        crinitShutdownTimespecAddUs(&wakeup, CRINIT_SHUTDOWN_POLL_INTERVAL_MS * 1000uLL);
+
+        bool progress = false, stopping = false;
+        for (size_t i = 0; i < numTasks; i++) {
+            crinitTask_t *t = &ctx->taskSet[i];
+            if (st[i].phase == CRINIT_SHUTDOWN_PENDING && plan.waitCount[i] == 0) {
+                crinitShutdownBegin(ctx, t, &st[i], &now, defaultTimeoutUs);
+            }
+            if (st[i].phase != CRINIT_SHUTDOWN_STOPPING) {
+                continue;
+            }
+            if (crinitShutdownIsStopped(t, &st[i])) {
+                crinitDbgInfoPrint("Task \'%s\' has stopped.", t->name);
+            } else if (!crinitShutdownTimespecBefore(&now, &st[i].deadline)) {
+                crinitInfoPrint("Task \'%s\' did not stop in time, killing it.", t->name);
+                crinitShutdownSignal(t, st[i].mainPid, SIGKILL);
+                // A hanging STOP_COMMAND needs to go, too.
+                if (t->stopThreads > 0 && t->pid > 0 && t->pid != st[i].mainPid) {
+                    crinitReaperKill(t->pid, SIGKILL);
+                }
+            } else {
+                stopping = true;
+                if (crinitShutdownTimespecBefore(&st[i].deadline, &wakeup)) {
+                    wakeup = st[i].deadline;
+                }
+                continue;
+            }
+            crinitShutdownFinish(&plan, st, i, &numStopped);
+            progress = true;
+        }
+
+        if (progress) {
+            continue;
+        }
+        if (!stopping) {
+            crinitDbgInfoPrint("Dependency cycle among the remaining tasks detected. Stopping them together.");
+            for (size_t i = 0; i < numTasks; i++) {
+                plan.waitCount[i] = 0;
+            }
+            continue;
+        }
+        if ((errno = crinitTaskDBWaitChanged(ctx, &wakeup)) != 0 && errno != ETIMEDOUT) {
+            crinitErrnoPrint("Could not wait on condition variable.");
+            ret = -1;
+            break;
+        }
+    }
+
+    crinitTaskDBUnlock(ctx);
+    free(st);
+    crinitTaskGraphStopPlanDestroy(&plan);
+    return ret;
+}
+
+int crinitShutdownFilesystems(void) {
+    crinitShutdownFsCtx_t ctx = {.result = 0};
+    bool rootfsIsRo = false;
+
+    FILE *mountInfo = fopen(CRINIT_MOUNTINFO_PATH, "re");
+    if (mountInfo == NULL) {
+        crinitErrnoPrint("Could not open \'%s\' for reading.", CRINIT_MOUNTINFO_PATH);
+        ctx.result = -1;
+    } else if (crinitMountTreeParse(&ctx.tree, mountInfo) == -1) {
+        crinitErrPrint("Could not read mounted filesystems from \'%s\'.", CRINIT_MOUNTINFO_PATH);
+        ctx.result = -1;
+    }
+    if (mountInfo != NULL) {
+        fclose(mountInfo);
+    }
+    if (ctx.result == -1) {
+        crinitErrPrint("Will at least try to remount root filesystem as read-only.");
+        goto remount;
+    }
+
+    for (size_t i = 0; i < ctx.tree.numMounts; i++) {
+        // The last entry for '/' is the one on top.
+        if (strcmp(ctx.tree.mounts[i].target, "/") == 0) {
+            rootfsIsRo = ctx.tree.mounts[i].readOnly;
+        }
+    }
+
+    ctx.ready = malloc(ctx.tree.numMounts * sizeof(*ctx.ready));
+    if (ctx.tree.numMounts > 0 && ctx.ready == NULL) {
+        crinitErrnoPrint("Could not allocate memory for list of mount points to be unmounted.");
+        crinitMountTreeDestroy(&ctx.tree);
+        ctx.result = -1;
+        rootfsIsRo = false;
+        goto remount;
+    }
+    for (size_t i = 0; i < ctx.tree.numMounts; i++) {
+        if (ctx.tree.mounts[i].numChld == 0) {
+            ctx.ready[ctx.numReady++] = i;
+        }
+    }
+    ctx.remaining = ctx.tree.numMounts;
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.changed, NULL);
+
+    pthread_t workers[CRINIT_SHUTDOWN_UMOUNT_THREADS - 1];
+    size_t numWorkers = 0;
+    pthread_attr_t thrAttrs;
+    pthread_attr_init(&thrAttrs);
+    pthread_attr_setstacksize(&thrAttrs, CRINIT_SHUTDOWN_UMOUNT_THREAD_STACK_SIZE);
+    while (numWorkers < CRINIT_SHUTDOWN_UMOUNT_THREADS - 1 && numWorkers + 1 < ctx.tree.numMounts) {
+        if ((errno = pthread_create(&workers[numWorkers], &thrAttrs, crinitShutdownFsWorker, &ctx)) != 0) {
+            crinitErrnoPrint("Could not start thread to unmount filesystems. Continuing with %zu thread(s).",
+                             numWorkers + 1);
+            break;
+        }
+        numWorkers++;
+    }
+    pthread_attr_destroy(&thrAttrs);
+    // The calling thread takes part as well, so we will make progress even if no thread could be started.
+    crinitShutdownFsWorker(&ctx);
+    for (size_t i = 0; i < numWorkers; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&ctx.changed);
+    pthread_mutex_destroy(&ctx.lock);
+    free(ctx.ready);
+    crinitMountTreeDestroy(&ctx.tree);
+
+remount:
+    // If it is (possibly) an rw rootfs, try remounting it ro.
+    if (!rootfsIsRo && mount(NULL, "/", NULL, MS_REMOUNT | MS_RDONLY, NULL) == -1) {
+        crinitErrnoPrint("Could not remount rootfs read-only, continuing anyway. Filesystem may be dirty on boot.");
+        ctx.result = -1;
+    }
+    sync();
+    return ctx.result;
+}
+
+static void crinitShutdownBegin(crinitTaskDB_t *ctx, crinitTask_t *t, crinitShutdownTask_t *st,
+                                const struct timespec *now, unsigned long long defaultTimeoutUs) {
+    st->phase = CRINIT_SHUTDOWN_STOPPING;
+    st->mainPid = (t->pid > 0) ? t->pid : -1;
+    st->deadline = *now;
+    crinitShutdownTimespecAddUs(&st->deadline,
+                                (t->stopTimeout > 0) ? (unsigned long long)t->stopTimeout * 1000uLL : defaultTimeoutUs);
+
+    if (t->stopCmdsSize > 0) {
+        if (ctx->spawnFunc != NULL && ctx->spawnFunc(ctx, t, CRINIT_DISPATCH_THREAD_MODE_STOP) == 0) {
+            t->stopThreads++;
+            crinitDbgInfoPrint("Stopping task \'%s\' using its STOP_COMMAND(s).", t->name);
+            return;
+        }
+        crinitErrPrint("Could not spawn STOP_COMMAND(s) of task \'%s\'. Will send SIGTERM instead.", t->name);
+    }
+    if (st->mainPid > 0) {
+        crinitDbgInfoPrint("Stopping task \'%s\' using SIGTERM.", t->name);
+        crinitShutdownSignal(t, st->mainPid, SIGTERM);
+        crinitShutdownSignal(t, st->mainPid, SIGCONT);
+    }
+}
+
+static bool crinitShutdownIsStopped(const crinitTask_t *t, const crinitShutdownTask_t *st) {
+    if (t->stopThreads > 0) {
+        return false;
+    }
+    if (st->mainPid <= 0) {
+        return true;
+    }
+    // Fails with ESRCH once the process has been reaped, even if it has not been collected by its dispatch thread yet.
+    return crinitReaperKill(st->mainPid, 0) == -1 && errno == ESRCH;
+}
+
+static void crinitShutdownSignal(crinitTask_t *t, pid_t pid, int sig) {
+#ifdef ENABLE_CGROUP
+    // Global cgroups are shared with other tasks, so only a cgroup of the task's own can be signalled as a whole.
+    bool isGlobal = true;
+    if (t->cgroup != NULL && crinitCgroupNameIsGlobalCgroup(t->cgroup->name, &isGlobal) == 0 && !isGlobal &&
+        crinitCGroupSignal(t->cgroup, sig) == 0) {
+        return;
+    }
+#endif
+    if (pid > 0 && crinitReaperKill(pid, sig) == -1 && errno != ESRCH) {
+        crinitErrnoPrint("Could not send signal %d to process %d of task \'%s\'.", sig, pid, t->name);
+    }
+}
+
+static void crinitShutdownFinish(crinitTaskGraphStopPlan_t *plan, crinitShutdownTask_t *st, size_t idx,
+                                 size_t *numStopped) {
+    st[idx].phase = CRINIT_SHUTDOWN_STOPPED;
+    (*numStopped)++;
+    for (size_t d = plan->depStart[idx]; d < plan->depStart[idx + 1]; d++) {
+        size_t dep = plan->depList[d];
+        if (plan->waitCount[dep] > 0) {
+            plan->waitCount[dep]--;
+        }
+    }
+}
+
+static void *crinitShutdownFsWorker(void *args) {
+    crinitShutdownFsCtx_t *ctx = args;
+
+    pthread_mutex_lock(&ctx->lock);
+    while (true) {
+        while (ctx->numReady == 0 && ctx->remaining > 0) {
+            pthread_cond_wait(&ctx->changed, &ctx->lock);
+        }
+        if (ctx->numReady == 0) {
+            break;
+        }
+        size_t idx = ctx->ready[--ctx->numReady];
+        pthread_mutex_unlock(&ctx->lock);
+
+        int res = crinitShutdownFsUnmount(&ctx->tree.mounts[idx]);
+
+        pthread_mutex_lock(&ctx->lock);
+        if (res == -1) {
+            ctx->result = -1;
+        }
+        ctx->remaining--;
+        size_t parent = ctx->tree.mounts[idx].parent;
+        if (parent != CRINIT_MOUNTINFO_NO_PARENT && --ctx->tree.mounts[parent].numChld == 0) {
+            ctx->ready[ctx->numReady++] = parent;
+            pthread_cond_broadcast(&ctx->changed);
+        } else if (ctx->remaining == 0) {
+            pthread_cond_broadcast(&ctx->changed);
+        }
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    return NULL;
+}
+
+static int crinitShutdownFsUnmount(const crinitMountEntry_t *m) {
+    // Filter out the root mount and things like tmpfs, proc, sysfs mounted from 'none'.
+    if (strcmp(m->target, "/") == 0 || strcmp(m->source, "none") == 0) {
+        return 0;
+    }
+
+    struct timespec start, synced, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!m->readOnly) {
+        int fd = open(m->target, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd == -1 || syncfs(fd) == -1) {
+            crinitErrnoPrint("Could not sync filesystem mounted at \'%s\'. Continuing anyway.", m->target);
+        }
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &synced);
+
+    int out = 0;
+    const char *how = "Unmounted";
+    if (umount2(m->target, 0) == -1) {
+        if (errno != EBUSY) {
+            crinitErrnoPrint("Could not unmount \'%s\'. Continuing anyway.", m->target);
+            return -1;
+        }
+        // Still in use, at least make sure it is gone from the tree.
+        how = "Detached busy";
+        if (umount2(m->target, MNT_DETACH) == -1) {
+            crinitErrnoPrint("Could not umount (detach) mountpoint \'%s\'. Continuing anyway.", m->target);
+            out = -1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (out == 0) {
+        crinitInfoPrint("%s \'%s\' (%s) in %lldus, syncfs took %lldus.", how, m->target, m->fsType,
+                        crinitShutdownTimespecDiffUs(&start, &end), crinitShutdownTimespecDiffUs(&start, &synced));
+    }
+    return out;
+}
+
+static inline long long crinitShutdownTimespecDiffUs(const struct timespec *start, const struct timespec *end) {
+    return (long long)(end->tv_sec - start->tv_sec) * 1000000LL + (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+static inline void crinitShutdownTimespecAddUs(struct timespec *ts, unsigned long long micros) {
+    ts->tv_sec += (time_t)(micros / 1000000uLL);
+    long long nsec = (long long)((micros % 1000000uLL) * 1000uLL) + ts->tv_nsec;
+    ts->tv_sec += (time_t)(nsec / CRINIT_SHUTDOWN_NS_PER_SEC);
+    ts->tv_nsec = (long)(nsec % CRINIT_SHUTDOWN_NS_PER_SEC);
+}
+
+static inline bool crinitShutdownTimespecBefore(const struct timespec *a, const struct timespec *b) {
+    return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
@@ -5,6 +5,7 @@
  */
 #include "task.h"
 
+#include <sched.h>
 #include <stdlib.h>
 
 #include "common.h"
@@ -39,6 +40,17 @@ static inline int crinitTaskSetFromConfKvList(crinitTask_t *tgt, const crinitCon
  *  @return  0 on success, -1 on error
  */
 static int crinitCopyCommandBlock(char *name, size_t cmdsSize, crinitTaskCmd_t *origCmds, crinitTaskCmd_t **outCmds);
+/** Helper function to copy an array of dependencies.
+ *
+ *  @param name Name of task (for error messages, etc.)
+ *  @param origDeps Source dependency array
+ *  @param depsSize Number of elements in the dependency array
+ *  @param outDeps Destination dependency array, will be NULL if \a depsSize is 0
+ *
+ *  @return  0 on success, -1 on error
+ */
+static int crinitCopyDepList(const char *name, const crinitTaskDep_t *origDeps, size_t depsSize,
+                             crinitTaskDep_t **outDeps);
 
 int crinitTaskCreateFromConfKvList(crinitTask_t **out, const crinitConfKvList_t *in) {
     crinitNullCheck(-1, out, in);
@@ -52,6 +64,10 @@ int crinitTaskCreateFromConfKvList(crinitTask_t **out, const crinitConfKvList_t
     pTask->pid = -1;
     pTask->maxRetries = -1;
     pTask->inhibitRespawn = false;
+    pTask->respawnDelay = CRINIT_TASK_RESPAWN_DELAY_DEFAULT;
+    pTask->respawnDelayMax = CRINIT_TASK_RESPAWN_DELAY_MAX_DEFAULT;
+    pTask->respawnReset = CRINIT_TASK_RESPAWN_RESET_DEFAULT;
+    pTask->stopTimeout = CRINIT_TASK_STOP_TIMEOUT_DEFAULT;
 
     if (crinitGlobOptGet(CRINIT_GLOBOPT_ENV, &pTask->taskEnv) == -1) {
         crinitErrPrint("Could not retrieve global environment set during Task creation.");
@@ -79,9 +95,29 @@ int crinitTaskCreateFromConfKvList(crinitTask_t **out, const crinitConfKvList_t
         goto fail;
     }
 
+    // Real-time scheduling policies need a static priority greater than 0, all others only accept 0.
+    bool rtPolicy = (pTask->procAttr.flags & CRINIT_PROC_ATTR_POLICY) &&
+                    (pTask->procAttr.policy == SCHED_FIFO || pTask->procAttr.policy == SCHED_RR);
+    if (rtPolicy && (!(pTask->procAttr.flags & CRINIT_PROC_ATTR_PRIORITY) || pTask->procAttr.priority == 0)) {
+        crinitErrPrint("The task '%s' uses a real-time scheduling policy and needs a %s greater than 0.", pTask->name,
+                       CRINIT_CONFIG_KEYSTR_SCHED_PRIORITY);
+        goto fail;
+    }
+    if (!rtPolicy && pTask->procAttr.priority != 0) {
+        crinitErrPrint("The task '%s' sets a %s greater than 0 which needs %s to be 'FIFO' or 'RR'.", pTask->name,
+                       CRINIT_CONFIG_KEYSTR_SCHED_PRIORITY, CRINIT_CONFIG_KEYSTR_SCHED_POLICY);
+        goto fail;
+    }
+
     // an empty trigger list means the task doesn't have to wait for any trigger
     pTask->triggered = pTask->trigSize == 0;
 
+    // Dependencies get removed once fulfilled but are needed again to stop the task in the right order.
+    pTask->cfgDepsSize = pTask->depsSize;
+    if (crinitCopyDepList(pTask->name, pTask->deps, pTask->cfgDepsSize, &pTask->cfgDeps) == -1) {
+        goto fail;
+    }
+
     // Initialize timestamps and set creation time.
     if (clock_gettime(CLOCK_MONOTONIC, &pTask->createTime) == -1) {
         crinitErrnoPrint("Could not measure creation time of task '%s'. Will set to 0 (undefined) and continue.",
@@ -103,6 +139,7 @@ int crinitTaskCopy(crinitTask_t *out, const crinitTask_t *orig) {
     memcpy(out, orig, sizeof(*out));
     out->name = NULL;
     out->deps = NULL;
+    out->cfgDeps = NULL;
     out->trig = NULL;
     out->cmds = NULL;
     out->taskEnv.envp = NULL;
@@ -143,29 +180,11 @@ int crinitTaskCopy(crinitTask_t *out, const crinitTask_t *orig) {
         goto fail;
     }
 
-    if (out->depsSize > 0) {
-        out->deps = calloc(out->depsSize, sizeof(*out->deps));
-        if (out->deps == NULL) {
-            crinitErrnoPrint("Could not allocate memory for %zu TaskDeps during copy of Task \'%s\'.", out->depsSize,
-                             orig->name);
-            goto fail;
-        }
-
-        for (size_t i = 0; i < out->depsSize; i++) {
-            size_t depNameLen = strlen(orig->deps[i].name) + 1;
-            size_t depEventLen = strlen(orig->deps[i].event) + 1;
-            out->deps[i].name = malloc(depNameLen + depEventLen);
-            if (out->deps[i].name == NULL) {
-                crinitErrnoPrint(
-                    "Could not allocate memory for backing string in deps[%zu] during copy of Task \'%s\'.", i,
-                    orig->name);
-                goto fail;
-            }
-            memcpy(out->deps[i].name, orig->deps[i].name, depNameLen + depEventLen);
-            out->deps[i].event = out->deps[i].name + depNameLen;
-        }
-    } else {
-        out->deps = NULL;
+    if (crinitCopyDepList(orig->name, orig->deps, out->depsSize, &out->deps) == -1) {
+        goto fail;
+    }
+    if (crinitCopyDepList(orig->name, orig->cfgDeps, out->cfgDepsSize, &out->cfgDeps) == -1) {
+        goto fail;
     }
     if (out->trigSize > 0) {
         out->trig = calloc(out->trigSize, sizeof(*out->trig));
@@ -232,6 +251,11 @@ int crinitTaskCopy(crinitTask_t *out, const crinitTask_t *orig) {
     out->pid = orig->pid;
     out->maxRetries = orig->maxRetries;
     out->failCount = orig->failCount;
+    out->respawnDelay = orig->respawnDelay;
+    out->respawnDelayMax = orig->respawnDelayMax;
+    out->respawnReset = orig->respawnReset;
+    out->backoffLevel = orig->backoffLevel;
+    out->respawnHeld = orig->respawnHeld;
 
     out->user = orig->user;
     out->group = orig->group;
@@ -332,6 +356,12 @@ void crinitDestroyTask(crinitTask_t *t) {
         }
     }
     free(t->deps);
+    if (t->cfgDeps != NULL) {
+        for (size_t i = 0; i < t->cfgDepsSize; i++) {
+            free(t->cfgDeps[i].name);
+        }
+    }
+    free(t->cfgDeps);
     if (t->trig != NULL) {
         for (size_t i = 0; i < t->trigSize; i++) {
             free(t->trig[i].name);
@@ -371,33 +401,49 @@ void crinitDestroyTask(crinitTask_t *t) {
 #endif
 }
 
+uint32_t crinitTaskRespawnBackoff(crinitTask_t *t, uint64_t runtimeNs, uint32_t rnd) {
+    crinitNullCheck(0, t);
+
+    if (t->respawnDelay == 0 || runtimeNs >= (uint64_t)t->respawnReset * 1000000) {
+        t->backoffLevel = 0;
+        return 0;
+    }
+
+    if (t->backoffLevel < UINT32_MAX) {
+        t->backoffLevel++;
+    }
+    uint64_t backoff = t->respawnDelay;
+    uint64_t maxBackoff = (t->respawnDelayMax > t->respawnDelay) ? t->respawnDelayMax : t->respawnDelay;
+    for (uint32_t i = 1; i < t->backoffLevel && backoff < maxBackoff; i++) {
+        backoff *= 2;
+    }
+    if (backoff > maxBackoff) {
+        backoff = maxBackoff;
+    }
+
+    uint64_t half = backoff / 2;
+    return (uint32_t)(backoff - half + rnd % (half + 1));
+}
+
 int crinitTaskMergeInclude(crinitTask_t *tgt, const char *src, char *importList) {
     crinitNullCheck(-1, tgt, src);
 
-    char *inclDir = NULL, *inclSuffix = NULL, *inclPath = NULL;
-    if (crinitGlobOptGet(CRINIT_GLOBOPT_INCLDIR, &inclDir) == -1) {
-        crinitErrPrint("Could not recall path include directory from global options.");
-        return -1;
-    }
-    if (crinitGlobOptGet(CRINIT_GLOBOPT_INCL_SUFFIX, &inclSuffix) == -1) {
-        crinitErrPrint("Could not recall include file suffix from global options.");
-        free(inclDir);
+    const crinitGlobOptStore_t *globOpts = crinitGlobOptSnapshotAcquire();
+    if (globOpts == NULL) {
+        crinitErrPrint("Could not recall include directory and file suffix from global options.");
         return -1;
     }
 
-    size_t pathLen = snprintf(NULL, 0, "%s/%s%s", inclDir, src, inclSuffix);
-    inclPath = malloc(pathLen + 1);
+    size_t pathLen = snprintf(NULL, 0, "%s/%s%s", globOpts->inclDir, src, globOpts->inclSuffix);
+    char *inclPath = malloc(pathLen + 1);
     if (inclPath == NULL) {
         crinitErrnoPrint("Could not allocate memory for full include file path.");
-        free(inclDir);
-        free(inclSuffix);
+        crinitGlobOptSnapshotRelease(globOpts);
         return -1;
     }
 
-    sprintf(inclPath, "%s/%s%s", inclDir, src, inclSuffix);
-
-    free(inclDir);
-    free(inclSuffix);
+    sprintf(inclPath, "%s/%s%s", globOpts->inclDir, src, globOpts->inclSuffix);
+    crinitGlobOptSnapshotRelease(globOpts);
 
     crinitConfKvList_t *inclConfList;
     if (crinitParseConf(&inclConfList, inclPath) == -1) {
@@ -487,6 +533,7 @@ static int crinitCopyCommandBlock(char *name, size_t cmdsSize, crinitTaskCmd_t *
                 return -1;
             }
             (*outCmds)[i].argc = origCmds[i].argc;
+            (*outCmds)[i].usage = origCmds[i].usage;
             (*outCmds)[i].argv = calloc((*outCmds)[i].argc + 1, sizeof((*outCmds)[i].argv));
             if ((*outCmds)[i].argv == NULL) {
                 crinitErrnoPrint(
@@ -513,3 +560,57 @@ static int crinitCopyCommandBlock(char *name, size_t cmdsSize, crinitTaskCmd_t *
 
     return 0;
 }
+
+static int crinitCopyDepList(const char *name, const crinitTaskDep_t *origDeps, size_t depsSize,
+                             crinitTaskDep_t **outDeps) {
+    *outDeps = NULL;
+    if (depsSize == 0) {
+        return 0;
+    }
+
+    *outDeps = calloc(depsSize, sizeof(**outDeps));
+    if (*outDeps == NULL) {
+        crinitErrnoPrint("Could not allocate memory for %zu TaskDeps during copy of Task \'%s\'.", depsSize, name);
+        return -1;
+    }
+
+    for (size_t i = 0; i < depsSize; i++) {
+        size_t depNameLen = strlen(origDeps[i].name) + 1;
+        size_t depEventLen = strlen(origDeps[i].event) + 1;
+        (*outDeps)[i].name = malloc(depNameLen + depEventLen);
+        if ((*outDeps)[i].name == NULL) {
+            crinitErrnoPrint("Could not allocate memory for backing string in deps[%zu] during copy of Task \'%s\'.", i,
+                             name);
+            return -1;
+        }
+        memcpy((*outDeps)[i].name, origDeps[i].name, depNameLen);
+        (*outDeps)[i].event = (*outDeps)[i].name + depNameLen;
+        memcpy((*outDeps)[i].event, origDeps[i].event, depEventLen);
+    }
+
+    return 0;
+}
+
+int crinitTaskUsageAdd(crinitTaskUsage_t *u, const struct rusage *ru) {
+    crinitNullCheck(-1, u, ru);
+
+    u->userTime.tv_sec += ru->ru_utime.tv_sec;
+    u->userTime.tv_nsec += ru->ru_utime.tv_usec * 1000;
+    if (u->userTime.tv_nsec >= 1000000000L) {
+        u->userTime.tv_sec++;
+        u->userTime.tv_nsec -= 1000000000L;
+    }
+    u->sysTime.tv_sec += ru->ru_stime.tv_sec;
+    u->sysTime.tv_nsec += ru->ru_stime.tv_usec * 1000;
+    if (u->sysTime.tv_nsec >= 1000000000L) {
+        u->sysTime.tv_sec++;
+        u->sysTime.tv_nsec -= 1000000000L;
+    }
+    if (ru->ru_maxrss > u->maxRss) {
+        u->maxRss = ru->ru_maxrss;
+    }
+    u->inBlock += ru->ru_inblock;
+    u->outBlock += ru->ru_oublock;
+    u->numProcs++;
+    return 0;
+}
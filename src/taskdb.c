@@ -5,6 +5,7 @@
  */
 #include "taskdb.h"
 
+#include <inttypes.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,8 +18,13 @@
 #include "eloslog.h"
 #endif
 #include "globopt.h"
+#include "lockprof.h"
 #include "logio.h"
+#include "metrics.h"
 #include "optfeat.h"
+#include "taskgraph.h"
+#include "trace.h"
+#include "usdt.h"
 
 /**
  * Find index of a task in the crinitTaskDB_t::taskSet of an crinitTaskDB_t by name.
@@ -30,6 +36,27 @@
  * @return 0 on success, -1 otherwise
  */
 static int crinitFindTask(crinitTask_t **task, const char *taskName, const crinitTaskDB_t *in);
+/**
+ * Determine if a failed task shall be held back from respawning and for how long.
+ *
+ * Uses crinitTaskRespawnBackoff() on tasks which will be respawned. If the returned delay is non-zero, sets
+ * crinitTask_t::respawnHeld and adds #CRINIT_TASK_STATE_CRASHLOOP to crinitTask_t::state. The caller must hold
+ * crinitTaskDB_t::lock and start the respawn timer after releasing it.
+ *
+ * @param t          The task which has just failed, crinitTask_t::endTime must already be updated.
+ * @param prevState  The state of the task before it failed.
+ *
+ * @return  The respawn delay in milliseconds, 0 if the task can be respawned right away or will not be respawned.
+ */
+static uint32_t crinitTaskDBCrashLoopBackoff(crinitTask_t *t, crinitTaskState_t prevState);
+/**
+ * Simple xorshift pseudo-random number generator used for the jitter of respawn backoffs.
+ *
+ * Not thread-safe, the caller must hold crinitTaskDB_t::lock.
+ *
+ * @return  A pseudo-random number.
+ */
+static uint32_t crinitTaskDBJitterRandom(void);
 /**
  * Check if an crinitTask_t is considered ready to be started (startable).
  *
@@ -44,12 +71,42 @@ static bool crinitTaskIsReady(const crinitTask_t *t);
  * Remove dependency and check trigger for a task.
  * Doesn't lock the TaskDB!
  *
+ * @param ctx    The TaskDB context containing the task.
  * @param pTask  The task to remove the dependency/check the trigger for.
  * @param dep    The dependency/tirgger to remove/check.
  *
  * @return 0 on success and -1 if pTask or dep where not valid.
  */
-static int crinitTaskDBRemoveDepFromTaskStruct(crinitTask_t *pTask, const crinitTaskDep_t *dep);
+static int crinitTaskDBRemoveDepFromTaskStruct(crinitTaskDB_t *ctx, crinitTask_t *pTask, const crinitTaskDep_t *dep);
+/**
+ * Run crinitTaskGraphAnalyze() on all tasks in a task database unless the results are still valid.
+ * Doesn't lock the TaskDB!
+ *
+ * @param ctx  The TaskDB context.
+ *
+ * @return 0 on success, -1 otherwise
+ */
+static int crinitTaskDBUpdateGraph(crinitTaskDB_t *ctx);
+/**
+ * Mark a task as starting and run crinitTaskDB_t::spawnFunc on it.
+ *
+ * Doesn't lock the TaskDB! Resets the state of \a pTask if the spawn function fails.
+ *
+ * @param ctx    The TaskDB context containing the task.
+ * @param pTask  The task to spawn.
+ * @param mode   Distinguishes between start and stop commands.
+ *
+ * @return 0 on success, -1 otherwise
+ */
+static int crinitTaskDBSpawnTask(crinitTaskDB_t *ctx, crinitTask_t *pTask, crinitDispatchThreadMode_t mode);
+/**
+ * Arm or disarm the `@timer:after:` dependencies and triggers of a task, see crinitTimerDBArmTaskTimer().
+ *
+ * @param pTask  The task.
+ * @param arm    true to (re-)arm the timers, false to disarm them.
+ * @param deps   If the dependencies should be handled, otherwise only the triggers are.
+ */
+static void crinitTaskDBArmTaskTimers(const crinitTask_t *pTask, bool arm, bool deps);
 
 int crinitTaskDBInitWithSize(crinitTaskDB_t *ctx,
                              int (*spawnFunc)(crinitTaskDB_t *ctx, const crinitTask_t *,
@@ -65,6 +122,8 @@ int crinitTaskDBInitWithSize(crinitTaskDB_t *ctx,
     ctx->taskSetItems = 0;
     ctx->spawnFunc = NULL;
     ctx->spawnInhibit = true;
+    ctx->graphValid = false;
+    ctx->lockedAt = 0;
     ctx->taskSet = calloc(initialSize, sizeof(*ctx->taskSet));
     if (ctx->taskSet == NULL) {
         crinitErrnoPrint("Could not allocate memory for Task set of size %zu in TaskDB.", initialSize);
@@ -75,7 +134,21 @@ int crinitTaskDBInitWithSize(crinitTaskDB_t *ctx,
         crinitErrnoPrint("Could not initialize mutex for TaskDB.");
         goto fail;
     }
-    if ((errno = pthread_cond_init(&ctx->changed, NULL)) != 0) {
+    pthread_condattr_t condAttr;
+    if ((errno = pthread_condattr_init(&condAttr)) != 0) {
+        crinitErrnoPrint("Could not initialize condition variable attributes for TaskDB.");
+        pthread_mutex_destroy(&ctx->lock);
+        goto fail;
+    }
+    if ((errno = pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC)) != 0) {
+        crinitErrnoPrint("Could not set clock of condition variable for TaskDB.");
+        pthread_condattr_destroy(&condAttr);
+        pthread_mutex_destroy(&ctx->lock);
+        goto fail;
+    }
+    errno = pthread_cond_init(&ctx->changed, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+    if (errno != 0) {
         crinitErrnoPrint("Could not initialize condition variable for TaskDB.");
         pthread_mutex_destroy(&ctx->lock);
         goto fail;
@@ -114,7 +187,7 @@ int crinitTaskDBDestroy(crinitTaskDB_t *ctx) {
 int crinitTaskDBInsert(crinitTaskDB_t *ctx, const crinitTask_t *t, bool overwrite) {
     crinitNullCheck(-1, ctx, t);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -122,6 +195,7 @@ int crinitTaskDBInsert(crinitTaskDB_t *ctx, const crinitTask_t *t, bool overwrit
     crinitTask_t *pTask;
     if (crinitFindTask(&pTask, t->name, ctx) == 0) {
         if (overwrite) {
+            crinitTaskDBArmTaskTimers(pTask, false, true);
             crinitDestroyTask(pTask);
         } else {
             crinitErrPrint("Found task/include with name '%s' already in TaskDB but will not overwrite", t->name);
@@ -148,6 +222,9 @@ int crinitTaskDBInsert(crinitTaskDB_t *ctx, const crinitTask_t *t, bool overwrit
         crinitErrPrint("Could not copy new Task.");
         goto fail;
     }
+    crinitTraceInstant(CRINIT_TRACE_TASK_INSERT, 0, "%s", pTask->name);
+    crinitTaskDBArmTaskTimers(pTask, true, true);
+    ctx->graphValid = false;
 
 #ifdef ENABLE_ELOS
     if (crinitElosLog(ELOS_SEVERITY_INFO, ELOS_MSG_CODE_FILE_OPENED, ELOS_CLASSIFICATION_PROCESS, pTask->name) == -1) {
@@ -164,55 +241,95 @@ int crinitTaskDBInsert(crinitTaskDB_t *ctx, const crinitTask_t *t, bool overwrit
     }
 
     pthread_cond_broadcast(&ctx->changed);
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     return 0;
 fail:
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     return -1;
 }
 
 int crinitTaskDBSpawnReady(crinitTaskDB_t *ctx, crinitDispatchThreadMode_t mode) {
     crinitNullCheck(-1, ctx);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
 
     if (ctx->spawnInhibit) {
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return 0;
     }
 
     if (ctx->spawnFunc == NULL) {
         crinitErrPrint("Could not spawn ready tasks because spawn function pointer was set to NULL.");
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return -1;
     }
 
+    size_t numReady = 0;
     crinitTask_t *pTask;
     crinitTaskDbForEach(ctx, pTask) {
         if (crinitTaskIsReady(pTask)) {
-            crinitDbgInfoPrint("Task \'%s\' ready to spawn.", pTask->name);
-            pTask->state = CRINIT_TASK_STATE_STARTING;
+            numReady++;
+        }
+    }
 
-            if (ctx->spawnFunc(ctx, pTask, mode) == -1) {
-                crinitErrPrint("Could not spawn new thread for execution of task \'%s\'.", pTask->name);
-                pTask->state &= ~CRINIT_TASK_STATE_STARTING;
-                pthread_mutex_unlock(&ctx->lock);
-                return -1;
+    // If more than one task is ready, start the ones heading the longest dependency chains first.
+    crinitTask_t **readySet = NULL;
+    if (numReady > 1) {
+        readySet = malloc(numReady * sizeof(*readySet));
+        if (readySet == NULL || crinitTaskDBUpdateGraph(ctx) == -1) {
+            crinitErrPrint("Could not prioritize ready tasks. Will spawn them in TaskDB order.");
+            free(readySet);
+            readySet = NULL;
+        }
+    }
+
+    int ret = 0;
+    if (readySet != NULL) {
+        size_t i = 0;
+        crinitTaskDbForEach(ctx, pTask) {
+            if (crinitTaskIsReady(pTask)) {
+                readySet[i++] = pTask;
+            }
+        }
+        qsort(readySet, numReady, sizeof(*readySet), crinitTaskGraphCmpPriority);
+        for (i = 0; i < numReady && ret == 0; i++) {
+            ret = crinitTaskDBSpawnTask(ctx, readySet[i], mode);
+        }
+        free(readySet);
+    } else if (numReady > 0) {
+        crinitTaskDbForEach(ctx, pTask) {
+            if (crinitTaskIsReady(pTask) && crinitTaskDBSpawnTask(ctx, pTask, mode) == -1) {
+                ret = -1;
+                break;
             }
         }
     }
 
-    pthread_mutex_unlock(&ctx->lock);
-    return 0;
+    crinitTaskDBUnlock(ctx);
+    return ret;
+}
+
+int crinitTaskDBAnalyzeGraph(crinitTaskDB_t *ctx) {
+    crinitNullCheck(-1, ctx);
+
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    int ret = crinitTaskDBUpdateGraph(ctx);
+
+    crinitTaskDBUnlock(ctx);
+    return ret;
 }
 
 int crinitTaskDBSetSpawnInhibit(crinitTaskDB_t *ctx, bool inh) {
     crinitNullCheck(-1, ctx);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -223,14 +340,62 @@ int crinitTaskDBSetSpawnInhibit(crinitTaskDB_t *ctx, bool inh) {
             pthread_cond_broadcast(&ctx->changed);
         }
     }
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
+    return 0;
+}
+
+int crinitTaskDBSpawnStopCommands(crinitTaskDB_t *ctx, const char *taskName) {
+    crinitNullCheck(-1, ctx, taskName);
+
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    crinitTask_t *pTask;
+    if (crinitFindTask(&pTask, taskName, ctx) == -1) {
+        crinitErrPrint("Could not stop Task \'%s\' as it does not exist in TaskDB.", taskName);
+        crinitTaskDBUnlock(ctx);
+        return -1;
+    }
+    if (ctx->spawnFunc == NULL || ctx->spawnFunc(ctx, pTask, CRINIT_DISPATCH_THREAD_MODE_STOP) == -1) {
+        crinitErrPrint("Could not spawn new thread for execution STOP_COMMAND of task \'%s\'.", taskName);
+        crinitTaskDBUnlock(ctx);
+        return -1;
+    }
+    pTask->stopThreads++;
+
+    crinitTaskDBUnlock(ctx);
+    return 0;
+}
+
+int crinitTaskDBStopThreadDone(crinitTaskDB_t *ctx, const char *taskName) {
+    crinitNullCheck(-1, ctx, taskName);
+
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    crinitTask_t *pTask;
+    if (crinitFindTask(&pTask, taskName, ctx) == -1) {
+        crinitTaskDBUnlock(ctx);
+        crinitErrPrint("Could not find Task \'%s\' in TaskDB.", taskName);
+        return -1;
+    }
+    // The task may have been replaced in the meantime, so never wrap around.
+    if (pTask->stopThreads > 0) {
+        pTask->stopThreads--;
+    }
+    pthread_cond_broadcast(&ctx->changed);
+    crinitTaskDBUnlock(ctx);
     return 0;
 }
 
 int crinitTaskDBGetTaskByName(crinitTaskDB_t *ctx, crinitTask_t **task, const char *taskName) {
     crinitNullCheck(-1, ctx, taskName);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -240,20 +405,20 @@ int crinitTaskDBGetTaskByName(crinitTaskDB_t *ctx, crinitTask_t **task, const ch
         if (crinitTaskDup(task, pTask) != 0) {
             goto failFindTaskByName;
         }
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return 0;
     }
     crinitErrPrint("Could not get task structure of Task \'%s\' as it does not exist in TaskDB.", taskName);
 
 failFindTaskByName:
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     return -1;
 }
 
 int crinitTaskRearmTrigger(crinitTaskDB_t *ctx, const char *taskName) {
     crinitNullCheck(-1, ctx, taskName);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -262,9 +427,12 @@ int crinitTaskRearmTrigger(crinitTaskDB_t *ctx, const char *taskName) {
     if (res == 0) {
         pTask->triggered = pTask->trigSize == 0;
         pTask->state = CRINIT_TASK_STATE_LOADED;
+        // The period of `@timer:after:` triggers counts from now on.
+        crinitTaskDBArmTaskTimers(pTask, true, false);
+        ctx->graphValid = false;
     }
     pthread_cond_broadcast(&ctx->changed);
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     return res;
 }
 
@@ -280,7 +448,7 @@ int crinitTaskDBSetTaskState(crinitTaskDB_t *ctx, crinitTaskState_t s, const cha
         }
     }
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -292,12 +460,21 @@ int crinitTaskDBSetTaskState(crinitTaskDB_t *ctx, crinitTaskState_t s, const cha
         crinitElosEventMessageCodeE_t elosMsgCode = ELOS_MSG_CODE_INFO_LOG;
         uint64_t classification = ELOS_CLASSIFICATION_UNDEFINED;
 #endif
+        crinitTaskState_t prevState = pTask->state;
+        uint32_t respawnDelay = 0;
         pTask->state = s;
+        crinitTraceInstant(CRINIT_TRACE_STATE_CHANGE, (int64_t)s, "%s", taskName);
+        crinitProbe3(task_state, taskName, s, prevState);
         s &= ~CRINIT_TASK_STATE_NOTIFIED;  // Here we don't care if we got the state via notification or directly.
+        // Start and end times feed the run time estimate of the graph analysis, ended tasks drop out of the graph.
+        if ((s | prevState) & (CRINIT_TASK_STATE_RUNNING | CRINIT_TASK_STATE_DONE | CRINIT_TASK_STATE_FAILED)) {
+            ctx->graphValid = false;
+        }
         switch (s) {
             case CRINIT_TASK_STATE_FAILED:
                 pTask->failCount++;
                 memcpy(&pTask->endTime, &timestamp, sizeof(pTask->endTime));
+                respawnDelay = crinitTaskDBCrashLoopBackoff(pTask, prevState);
 #ifdef ENABLE_ELOS
                 elosSeverity = ELOS_SEVERITY_ERROR;
                 elosMsgCode = ELOS_MSG_CODE_EXIT_FAILURE;
@@ -306,6 +483,7 @@ int crinitTaskDBSetTaskState(crinitTaskDB_t *ctx, crinitTaskState_t s, const cha
                 break;
             case CRINIT_TASK_STATE_DONE:
                 pTask->failCount = 0;
+                pTask->backoffLevel = 0;
                 memcpy(&pTask->endTime, &timestamp, sizeof(pTask->endTime));
 #ifdef ENABLE_ELOS
                 elosMsgCode = ELOS_MSG_CODE_PROCESS_EXITED;
@@ -324,7 +502,13 @@ int crinitTaskDBSetTaskState(crinitTaskDB_t *ctx, crinitTaskState_t s, const cha
                 break;
         }
         pthread_cond_broadcast(&ctx->changed);
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
+
+        // Done without our lock, the fallback below needs to take it.
+        if (respawnDelay > 0 && crinitTimerDBAddRespawnTimer(taskName, respawnDelay) == -1) {
+            crinitErrPrint("Could not delay respawn of Task '%s'. Will respawn it immediately.", taskName);
+            crinitTaskDBReleaseRespawn(ctx, taskName);
+        }
 #ifdef ENABLE_ELOS
         if (crinitElosLog(elosSeverity, elosMsgCode, classification, taskName) == -1) {
             crinitErrPrint("Could not send task event to elos. Will continue but logging may be impaired.");
@@ -333,7 +517,7 @@ int crinitTaskDBSetTaskState(crinitTaskDB_t *ctx, crinitTaskState_t s, const cha
         return 0;
     }
 
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     crinitErrPrint("Could not set TaskState for Task \'%s\' as it does not exist in TaskDB.", taskName);
     return -1;
 }
@@ -342,7 +526,7 @@ int crinitTaskDBGetTaskState(crinitTaskDB_t *ctx, crinitTaskState_t *s, const ch
     crinitNullCheck(-1, ctx, taskName, s);
 
     *s = 0;
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -350,10 +534,10 @@ int crinitTaskDBGetTaskState(crinitTaskDB_t *ctx, crinitTaskState_t *s, const ch
     crinitTask_t *pTask;
     if (crinitFindTask(&pTask, taskName, ctx) == 0) {
         *s = pTask->state;
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return 0;
     }
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     crinitErrPrint("Could not get TaskState of Task \'%s\' as it does not exist in TaskDB.", taskName);
     return -1;
 }
@@ -361,7 +545,7 @@ int crinitTaskDBGetTaskState(crinitTaskDB_t *ctx, crinitTaskState_t *s, const ch
 int crinitTaskDBSetTaskPID(crinitTaskDB_t *ctx, pid_t pid, const char *taskName) {
     crinitNullCheck(-1, ctx, taskName);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -369,19 +553,44 @@ int crinitTaskDBSetTaskPID(crinitTaskDB_t *ctx, pid_t pid, const char *taskName)
     crinitTask_t *pTask;
     if (crinitFindTask(&pTask, taskName, ctx) == 0) {
         pTask->pid = pid;
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return 0;
     }
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     crinitErrPrint("Could not set TaskState for Task \'%s\' as it does not exist in TaskDB.", taskName);
     return -1;
 }
 
+int crinitTaskDBAddTaskUsage(crinitTaskDB_t *ctx, const struct rusage *ru, crinitDispatchThreadMode_t mode,
+                             size_t cmdIdx, const char *taskName) {
+    crinitNullCheck(-1, ctx, ru, taskName);
+
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    crinitTask_t *pTask;
+    if (crinitFindTask(&pTask, taskName, ctx) == 0) {
+        crinitTaskCmd_t *cmds = (mode == CRINIT_DISPATCH_THREAD_MODE_STOP) ? pTask->stopCmds : pTask->cmds;
+        size_t cmdsSize = (mode == CRINIT_DISPATCH_THREAD_MODE_STOP) ? pTask->stopCmdsSize : pTask->cmdsSize;
+        crinitTaskUsageAdd(&pTask->usage, ru);
+        if (cmdIdx < cmdsSize) {
+            crinitTaskUsageAdd(&cmds[cmdIdx].usage, ru);
+        }
+        crinitTaskDBUnlock(ctx);
+        return 0;
+    }
+    crinitTaskDBUnlock(ctx);
+    crinitErrPrint("Could not add resource usage to Task \'%s\' as it does not exist in TaskDB.", taskName);
+    return -1;
+}
+
 int crinitTaskDBGetTaskPID(crinitTaskDB_t *ctx, pid_t *pid, const char *taskName) {
     crinitNullCheck(-1, ctx, taskName, pid);
 
     *pid = -1;
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -389,10 +598,10 @@ int crinitTaskDBGetTaskPID(crinitTaskDB_t *ctx, pid_t *pid, const char *taskName
     crinitTask_t *pTask;
     if (crinitFindTask(&pTask, taskName, ctx) == 0) {
         *pid = pTask->pid;
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return 0;
     }
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     crinitErrPrint("Could not get TaskState of Task \'%s\' as it does not exist in TaskDB.", taskName);
     return -1;
 }
@@ -402,7 +611,7 @@ int crinitTaskDBGetTaskStateAndPID(crinitTaskDB_t *ctx, crinitTaskState_t *s, pi
 
     *s = 0;
     *pid = 0;
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -411,10 +620,10 @@ int crinitTaskDBGetTaskStateAndPID(crinitTaskDB_t *ctx, crinitTaskState_t *s, pi
     if (crinitFindTask(&pTask, taskName, ctx) == 0) {
         *s = pTask->state;
         *pid = pTask->pid;
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return 0;
     }
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     crinitErrPrint("Could not get TaskState of Task \'%s\' as it does not exist in TaskDB.", taskName);
     return -1;
 }
@@ -422,7 +631,7 @@ int crinitTaskDBGetTaskStateAndPID(crinitTaskDB_t *ctx, crinitTaskState_t *s, pi
 int crinitTaskDBSetTaskRespawnInhibit(crinitTaskDB_t *ctx, bool inhibit, const char *taskName) {
     crinitNullCheck(-1, ctx, taskName);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -430,18 +639,70 @@ int crinitTaskDBSetTaskRespawnInhibit(crinitTaskDB_t *ctx, bool inhibit, const c
     crinitTask_t *pTask;
     if (crinitFindTask(&pTask, taskName, ctx) == 0) {
         pTask->inhibitRespawn = inhibit;
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return 0;
     }
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     crinitErrPrint("Could not set inhibitRespawn for Task \'%s\' as it does not exist in TaskDB.", taskName);
     return -1;
 }
 
+int crinitTaskDBReleaseRespawn(crinitTaskDB_t *ctx, const char *taskName) {
+    crinitNullCheck(-1, ctx, taskName);
+
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    crinitTask_t *pTask;
+    if (crinitFindTask(&pTask, taskName, ctx) == 0) {
+        pTask->respawnHeld = false;
+        pthread_cond_broadcast(&ctx->changed);
+        crinitTaskDBUnlock(ctx);
+        return 0;
+    }
+    crinitTaskDBUnlock(ctx);
+    crinitErrPrint("Could not release respawn of Task \'%s\' as it does not exist in TaskDB.", taskName);
+    return -1;
+}
+
+int crinitTaskDBLockAt(crinitTaskDB_t *ctx, const char *site) {
+    uint64_t start = crinitTraceNow();
+#ifdef ENABLE_LOCK_PROFILING
+    int ret = crinitLockProfLock(&ctx->lock, CRINIT_LOCK_TASKDB, site);
+#else
+    CRINIT_PARAM_UNUSED(site);
+    int ret = crinitTraceMutexLock(&ctx->lock, "TaskDB");
+#endif
+    if (ret != 0) {
+        return ret;
+    }
+    uint64_t now = crinitTraceNow();
+    crinitMetricsObserve(CRINIT_METRIC_TASKDB_LOCK_WAIT, now - start);
+    ctx->lockedAt = now;
+    return 0;
+}
+
+int crinitTaskDBUnlock(crinitTaskDB_t *ctx) {
+    // Still holding the lock, so crinitTaskDB_t::lockedAt cannot change underneath us.
+    crinitMetricsObserve(CRINIT_METRIC_TASKDB_LOCK_HOLD, crinitTraceNow() - ctx->lockedAt);
+    return crinitMutexUnlock(&ctx->lock, CRINIT_LOCK_TASKDB);
+}
+
+int crinitTaskDBWaitChanged(crinitTaskDB_t *ctx, const struct timespec *abstime) {
+    crinitMetricsObserve(CRINIT_METRIC_TASKDB_LOCK_HOLD, crinitTraceNow() - ctx->lockedAt);
+    int ret = (abstime == NULL) ? crinitMutexCondWait(&ctx->changed, &ctx->lock, CRINIT_LOCK_TASKDB)
+                                : crinitMutexCondTimedWait(&ctx->changed, &ctx->lock, abstime, CRINIT_LOCK_TASKDB);
+    // The mutex is held again in any case.
+    ctx->lockedAt = crinitTraceNow();
+    return ret;
+}
+
 crinitTask_t *crinitTaskDBBorrowTask(crinitTaskDB_t *ctx, const char *taskName) {
     crinitNullCheck(NULL, ctx, taskName);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) == -1) {
+    if ((errno = crinitTaskDBLock(ctx)) == -1) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return NULL;
     }
@@ -449,7 +710,7 @@ crinitTask_t *crinitTaskDBBorrowTask(crinitTaskDB_t *ctx, const char *taskName)
     crinitTask_t *pTask;
     if (crinitFindTask(&pTask, taskName, ctx) == -1) {
         crinitErrPrint("Could not find task '%s' in TaskDB.", taskName);
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return NULL;
     }
     return pTask;
@@ -460,7 +721,7 @@ int crinitTaskDBRemit(crinitTaskDB_t *ctx) {
 
     // This *could* be called from a thread which does not actually own the mutex, so we need to check if
     // pthread_mutex_unlock() fails.
-    errno = pthread_mutex_unlock(&ctx->lock);
+    errno = crinitTaskDBUnlock(ctx);
     if (errno != 0) {
         crinitErrnoPrint("Could not unlock task database mutex.");
         return -1;
@@ -471,7 +732,7 @@ int crinitTaskDBRemit(crinitTaskDB_t *ctx) {
 int crinitTaskDBAddDepToTask(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, const char *taskName) {
     crinitNullCheck(-1, ctx, dep, taskName);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -482,7 +743,7 @@ int crinitTaskDBAddDepToTask(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, co
         // Return immediately if dependency is already present
         crinitTaskForEachDep(pTask, pDep) {
             if (strcmp(pDep->name, dep->name) == 0 && strcmp(pDep->event, dep->event) == 0) {
-                pthread_mutex_unlock(&ctx->lock);
+                crinitTaskDBUnlock(ctx);
                 return 0;
             }
         }
@@ -491,7 +752,7 @@ int crinitTaskDBAddDepToTask(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, co
         if (pTempDeps == NULL) {
             crinitErrnoPrint("Could not reallocate memory of dependency array for task \'%s\'.", taskName);
             pTask->depsSize--;
-            pthread_mutex_unlock(&ctx->lock);
+            crinitTaskDBUnlock(ctx);
             return -1;
         }
         pTask->deps = pTempDeps;
@@ -503,33 +764,42 @@ int crinitTaskDBAddDepToTask(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, co
         if (pTask->deps[lastIdx].name == NULL) {
             crinitErrnoPrint("Could not allocate memory for dependency backing string for task \'%s\'.", taskName);
             pTask->depsSize--;
-            pthread_mutex_unlock(&ctx->lock);
+            crinitTaskDBUnlock(ctx);
             return -1;
         }
         pTask->deps[lastIdx].event = pTask->deps[lastIdx].name + nameCopyLen;
         memcpy(pTask->deps[lastIdx].name, dep->name, nameCopyLen);
         memcpy(pTask->deps[lastIdx].event, dep->event, eventCopyLen);
-        pthread_mutex_unlock(&ctx->lock);
+        if (strcmp(dep->name, "@timer") == 0 && crinitTimerDBIsTaskTimer(dep->event)) {
+            crinitTimerDBArmTaskTimer(pTask->name, dep->event);
+        }
+        ctx->graphValid = false;
+        crinitTaskDBUnlock(ctx);
         return 0;
     }
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     crinitErrPrint("Could not find task \'%s\' in TaskDB.", taskName);
     return -1;
 }
 
-static int crinitTaskDBRemoveDepFromTaskStruct(crinitTask_t *pTask, const crinitTaskDep_t *dep) {
-    crinitNullCheck(-1, pTask, dep);
+static int crinitTaskDBRemoveDepFromTaskStruct(crinitTaskDB_t *ctx, crinitTask_t *pTask, const crinitTaskDep_t *dep) {
+    crinitNullCheck(-1, ctx, pTask, dep);
     for (size_t j = 0; j < pTask->depsSize; j++) {
         if ((strcmp(pTask->deps[j].name, dep->name) == 0) && (strcmp(pTask->deps[j].event, dep->event) == 0)) {
             crinitDbgInfoPrint("Removing dependency \'%s:%s\' in \'%s\'.", dep->name, dep->event, pTask->name);
             if (0 == strcmp(dep->name, "@timer")) {
-                crinitTimerDBRemoveTimer(dep->event);
+                if (crinitTimerDBIsTaskTimer(dep->event)) {
+                    crinitTimerDBDisarmTaskTimer(pTask->name, dep->event);
+                } else {
+                    crinitTimerDBRemoveTimer(dep->event);
+                }
             }
             free(pTask->deps[j].name);
             if (j < pTask->depsSize - 1) {
                 pTask->deps[j] = pTask->deps[pTask->depsSize - 1];
             }
             pTask->depsSize--;
+            ctx->graphValid = false;
         }
     }
     for (size_t j = 0; j < pTask->trigSize; j++) {
@@ -544,19 +814,19 @@ static int crinitTaskDBRemoveDepFromTaskStruct(crinitTask_t *pTask, const crinit
 int crinitTaskDBRemoveDepFromTask(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, const char *taskName) {
     crinitNullCheck(-1, ctx, dep, taskName);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
 
     crinitTask_t *pTask;
     if (crinitFindTask(&pTask, taskName, ctx) == 0) {
-        crinitTaskDBRemoveDepFromTaskStruct(pTask, dep);
+        crinitTaskDBRemoveDepFromTaskStruct(ctx, pTask, dep);
         pthread_cond_broadcast(&ctx->changed);
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return 0;
     }
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     crinitErrPrint("Could not find task \'%s\' in TaskDB.", taskName);
     return -1;
 }
@@ -564,21 +834,46 @@ int crinitTaskDBRemoveDepFromTask(crinitTaskDB_t *ctx, const crinitTaskDep_t *de
 int crinitTaskDBFulfillDep(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, crinitTask_t *target) {
     crinitNullCheck(-1, ctx, dep);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
 
+    crinitTraceInstant(CRINIT_TRACE_DEP_FULFILL, 0, "%s:%s", dep->name, dep->event);
+    crinitProbe3(dep_fulfill, dep->name, dep->event, (target != NULL) ? target->name : NULL);
     if (target != NULL) {
-        crinitTaskDBRemoveDepFromTaskStruct(target, dep);
+        crinitTaskDBRemoveDepFromTaskStruct(ctx, target, dep);
     } else {
         crinitTask_t *pTask;
         crinitTaskDbForEach(ctx, pTask) {
-            crinitTaskDBRemoveDepFromTaskStruct(pTask, dep);
+            crinitTaskDBRemoveDepFromTaskStruct(ctx, pTask, dep);
         }
     }
     pthread_cond_broadcast(&ctx->changed);
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
+    return 0;
+}
+
+int crinitTaskDBFulfillDeps(crinitTaskDB_t *ctx, const crinitTaskDep_t *deps, size_t numDeps) {
+    crinitNullCheck(-1, ctx, deps);
+
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+
+    for (size_t i = 0; i < numDeps; i++) {
+        crinitTraceInstant(CRINIT_TRACE_DEP_FULFILL, 0, "%s:%s", deps[i].name, deps[i].event);
+        crinitProbe3(dep_fulfill, deps[i].name, deps[i].event, (const char *)NULL);
+    }
+    crinitTask_t *pTask;
+    crinitTaskDbForEach(ctx, pTask) {
+        for (size_t i = 0; i < numDeps; i++) {
+            crinitTaskDBRemoveDepFromTaskStruct(ctx, pTask, &deps[i]);
+        }
+    }
+    pthread_cond_broadcast(&ctx->changed);
+    crinitTaskDBUnlock(ctx);
     return 0;
 }
 
@@ -611,7 +906,7 @@ int crinitTaskDBProvideFeature(crinitTaskDB_t *ctx, const crinitTask_t *provider
 int crinitTaskDBProvideFeatureByTaskName(crinitTaskDB_t *ctx, const char *taskName, crinitTaskState_t newState) {
     crinitNullCheck(-1, ctx, taskName);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -621,7 +916,7 @@ int crinitTaskDBProvideFeatureByTaskName(crinitTaskDB_t *ctx, const char *taskNa
         crinitErrPrint("Could not find task \'%s\' in TaskDB.", taskName);
         return -1;
     }
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
 
     return crinitTaskDBProvideFeature(ctx, provider, newState);
 }
@@ -632,7 +927,7 @@ int crinitTaskDBExportTaskNamesToArray(crinitTaskDB_t *ctx, char **tasks[], size
 
     crinitNullCheck(-1, ctx, tasks, numTasks);
 
-    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+    if ((errno = crinitTaskDBLock(ctx)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
@@ -641,7 +936,7 @@ int crinitTaskDBExportTaskNamesToArray(crinitTaskDB_t *ctx, char **tasks[], size
     *tasks = calloc(ctx->taskSetItems, sizeof(*tasks));
     if (*tasks == NULL) {
         crinitErrnoPrint("Could not allocate memory for task array.");
-        pthread_mutex_unlock(&ctx->lock);
+        crinitTaskDBUnlock(ctx);
         return -1;
     }
 
@@ -664,7 +959,7 @@ int crinitTaskDBExportTaskNamesToArray(crinitTaskDB_t *ctx, char **tasks[], size
         *tasks = NULL;
     }
 
-    pthread_mutex_unlock(&ctx->lock);
+    crinitTaskDBUnlock(ctx);
     return ret;
 }
 
@@ -684,6 +979,36 @@ static int crinitFindTask(crinitTask_t **task, const char *taskName, const crini
     return -1;
 }
 
+static int crinitTaskDBSpawnTask(crinitTaskDB_t *ctx, crinitTask_t *pTask, crinitDispatchThreadMode_t mode) {
+    crinitDbgInfoPrint("Task \'%s\' ready to spawn.", pTask->name);
+    crinitTraceInstant(CRINIT_TRACE_TASK_READY, 0, "%s", pTask->name);
+    crinitProbe2(task_ready, pTask->name, (int)(mode == CRINIT_DISPATCH_THREAD_MODE_STOP));
+    // A task which has ended before is being respawned.
+    if (mode == CRINIT_DISPATCH_THREAD_MODE_START &&
+        (pTask->state & (CRINIT_TASK_STATE_DONE | CRINIT_TASK_STATE_FAILED))) {
+        crinitMetricsCount(CRINIT_METRIC_RESPAWNS);
+    }
+    pTask->state = CRINIT_TASK_STATE_STARTING;
+
+    if (ctx->spawnFunc(ctx, pTask, mode) == -1) {
+        crinitErrPrint("Could not spawn new thread for execution of task \'%s\'.", pTask->name);
+        pTask->state &= ~CRINIT_TASK_STATE_STARTING;
+        return -1;
+    }
+    return 0;
+}
+
+static int crinitTaskDBUpdateGraph(crinitTaskDB_t *ctx) {
+    if (ctx->graphValid) {
+        return 0;
+    }
+    if (crinitTaskGraphAnalyze(ctx->taskSet, ctx->taskSetItems) == -1) {
+        return -1;
+    }
+    ctx->graphValid = true;
+    return 0;
+}
+
 static bool crinitTaskIsReady(const crinitTask_t *t) {
     crinitNullCheck(false, t);
 
@@ -699,6 +1024,9 @@ static bool crinitTaskIsReady(const crinitTask_t *t) {
     if ((t->opts & CRINIT_TASK_OPT_RESPAWN) && t->inhibitRespawn) {
         return false;
     }
+    if (t->respawnHeld) {
+        return false;
+    }
     if (t->state & (CRINIT_TASK_STATE_FAILED | CRINIT_TASK_STATE_DONE)) {
         if (!(t->opts & CRINIT_TASK_OPT_RESPAWN)) {
             return false;
@@ -709,3 +1037,65 @@ static bool crinitTaskIsReady(const crinitTask_t *t) {
     }
     return true;
 }
+
+static uint32_t crinitTaskDBCrashLoopBackoff(crinitTask_t *t, crinitTaskState_t prevState) {
+    if (!(t->opts & CRINIT_TASK_OPT_RESPAWN) || t->inhibitRespawn ||
+        (t->maxRetries != -1 && t->failCount > t->maxRetries)) {
+        return 0;
+    }
+
+    // A task failing before it was running (e.g. because the executable is missing) has not run at all.
+    uint64_t runtimeNs = 0;
+    if (prevState & CRINIT_TASK_STATE_RUNNING) {
+        runtimeNs = crinitTaskGraphTaskDuration(t);
+    }
+
+    uint32_t delay = crinitTaskRespawnBackoff(t, runtimeNs, crinitTaskDBJitterRandom());
+    if (delay > 0) {
+        t->respawnHeld = true;
+        t->state |= CRINIT_TASK_STATE_CRASHLOOP;
+        crinitInfoPrint("Task '%s' crashed %" PRIu32 " time(s) in a row. Will respawn it in %" PRIu32 "ms.", t->name,
+                        t->backoffLevel, delay);
+    }
+    return delay;
+}
+
+static uint32_t crinitTaskDBJitterRandom(void) {
+    static uint32_t state = 0;
+    if (state == 0) {
+        struct timespec seed;
+        clock_gettime(CLOCK_MONOTONIC, &seed);
+        state = (uint32_t)seed.tv_nsec | 1;
+    }
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static void crinitTaskDBArmTaskTimers(const crinitTask_t *pTask, bool arm, bool deps) {
+    const crinitTaskDep_t *pDep;
+    crinitTaskForEachTrig(pTask, pDep) {
+        if (strcmp(pDep->name, "@timer") != 0 || !crinitTimerDBIsTaskTimer(pDep->event)) {
+            continue;
+        }
+        if (!arm) {
+            crinitTimerDBDisarmTaskTimer(pTask->name, pDep->event);
+        } else if (crinitTimerDBArmTaskTimer(pTask->name, pDep->event) == -1) {
+            crinitErrPrint("Could not arm trigger '@timer:%s' of task '%s'.", pDep->event, pTask->name);
+        }
+    }
+    if (!deps) {
+        return;
+    }
+    crinitTaskForEachDep(pTask, pDep) {
+        if (strcmp(pDep->name, "@timer") != 0 || !crinitTimerDBIsTaskTimer(pDep->event)) {
+            continue;
+        }
+        if (!arm) {
+            crinitTimerDBDisarmTaskTimer(pTask->name, pDep->event);
+        } else if (crinitTimerDBArmTaskTimer(pTask->name, pDep->event) == -1) {
+            crinitErrPrint("Could not arm dependency '@timer:%s' of task '%s'.", pDep->event, pTask->name);
+        }
+    }
+}
@@ -0,0 +1,441 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file taskgraph.c
+ * @brief Implementation of the dependency graph analysis for a set of tasks.
+ */
+#include "taskgraph.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "logio.h"
+#include "taskdb.h"
+
+/** Number of nanoseconds in a second. **/
+#define CRINIT_TASKGRAPH_NS_PER_SEC 1000000000LL
+/** Marker for a missing task index. **/
+#define CRINIT_TASKGRAPH_NO_TASK SIZE_MAX
+
+/**
+ * Visiting state of a task during the depth-first traversals of the dependency graph.
+ */
+typedef enum crinitTaskGraphMark {
+    CRINIT_TASKGRAPH_UNVISITED = 0,  ///< Task has not been visited yet.
+    CRINIT_TASKGRAPH_IN_PROGRESS,    ///< Task is on the current traversal path, reaching it again means a cycle.
+    CRINIT_TASKGRAPH_DONE            ///< Results for the task have been computed.
+} crinitTaskGraphMark_t;
+
+/**
+ * A single edge in the dependency graph, pointing from a task to one of the tasks waiting on it.
+ */
+typedef struct crinitTaskGraphEdge {
+    size_t from;  ///< Index of the task which needs to make progress first.
+    size_t to;    ///< Index of the task waiting on crinitTaskGraphEdge_t::from.
+} crinitTaskGraphEdge_t;
+
+/**
+ * Working memory for a single run of crinitTaskGraphAnalyze().
+ */
+typedef struct crinitTaskGraphWork {
+    crinitTask_t *tasks;           ///< The analyzed task array.
+    size_t numTasks;               ///< Number of elements in crinitTaskGraphWork_t::tasks.
+    crinitTaskGraphEdge_t *edges;  ///< Dynamic array of edges, sorted by source after crinitTaskGraphBuild().
+    size_t numEdges;               ///< Number of elements in crinitTaskGraphWork_t::edges.
+    size_t edgesCap;               ///< Allocated size of crinitTaskGraphWork_t::edges.
+    size_t *succStart;             ///< Index of the first outgoing edge of each task (plus one end marker).
+    size_t *predStart;             ///< Index of the first predecessor of each task in predList (plus end marker).
+    size_t *predList;              ///< Predecessor task indices, grouped by task.
+    size_t *bestSucc;              ///< The successor on the longest chain starting at each task, if any.
+    crinitTaskGraphMark_t *mark;   ///< Visiting state for each task.
+    const crinitTask_t **byName;   ///< Task pointers sorted by name for lookups.
+} crinitTaskGraphWork_t;
+
+/**
+ * Allocate the working memory of a crinitTaskGraphWork_t and fill in the edges.
+ *
+ * @param g         The graph to initialize.
+ * @param tasks     The task array to analyze.
+ * @param numTasks  Number of elements in \a tasks.
+ * @param cfgDeps   Build the edges from crinitTask_t::cfgDeps (true) or crinitTask_t::deps (false).
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitTaskGraphBuild(crinitTaskGraphWork_t *g, crinitTask_t *tasks, size_t numTasks, bool cfgDeps);
+/**
+ * Free the working memory of a crinitTaskGraphWork_t.
+ *
+ * @param g  The graph to free the members of.
+ */
+static void crinitTaskGraphDestroy(crinitTaskGraphWork_t *g);
+/**
+ * Add an edge to the graph, growing the edge array if necessary.
+ *
+ * @param g     The graph to add the edge to.
+ * @param from  Index of the task which is depended upon.
+ * @param to    Index of the dependent task.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitTaskGraphAddEdge(crinitTaskGraphWork_t *g, size_t from, size_t to);
+/**
+ * Compute crinitTaskGraphInfo_t::chainLen, crinitTaskGraphInfo_t::chainNs, and crinitTaskGraphInfo_t::fanOut for a task
+ * and, recursively, all tasks waiting on it.
+ *
+ * @param g    The graph.
+ * @param idx  Index of the task to visit.
+ */
+static void crinitTaskGraphVisitChain(crinitTaskGraphWork_t *g, size_t idx);
+/**
+ * Compute crinitTaskGraphInfo_t::depth for a task and, recursively, all tasks it waits on.
+ *
+ * @param g    The graph.
+ * @param idx  Index of the task to visit.
+ */
+static void crinitTaskGraphVisitDepth(crinitTaskGraphWork_t *g, size_t idx);
+/**
+ * Check if the dependency chain starting at one task is longer than the one starting at another.
+ *
+ * @param a  The first task.
+ * @param b  The second task.
+ *
+ * @return  true if the chain of \a a takes more time or, with equal time, contains more tasks than the one of \a b
+ */
+static inline bool crinitTaskGraphChainLonger(const crinitTask_t *a, const crinitTask_t *b);
+/**
+ * Check if a task still has work ahead of it, i.e. it has not finished or it will be respawned.
+ *
+ * @param t  The task to check.
+ *
+ * @return  true if \a t is pending, false otherwise
+ */
+static inline bool crinitTaskGraphIsPending(const crinitTask_t *t);
+/**
+ * qsort() comparison function for task pointers by name.
+ */
+static int crinitTaskGraphCmpName(const void *a, const void *b);
+/**
+ * bsearch() comparison function between a task name and a task pointer.
+ */
+static int crinitTaskGraphCmpNameKey(const void *key, const void *elem);
+/**
+ * qsort() comparison function for crinitTaskGraphEdge_t by source and then destination.
+ */
+static int crinitTaskGraphCmpEdge(const void *a, const void *b);
+
+int crinitTaskGraphAnalyze(crinitTask_t *tasks, size_t numTasks) {
+    crinitNullCheck(-1, tasks);
+
+    if (numTasks == 0) {
+        return 0;
+    }
+
+    crinitTaskGraphWork_t g;
+    if (crinitTaskGraphBuild(&g, tasks, numTasks, false) == -1) {
+        crinitErrPrint("Could not build dependency graph of %zu tasks.", numTasks);
+        return -1;
+    }
+
+    for (size_t i = 0; i < numTasks; i++) {
+        tasks[i].graph.critical = false;
+        if (g.mark[i] == CRINIT_TASKGRAPH_UNVISITED) {
+            crinitTaskGraphVisitChain(&g, i);
+        }
+    }
+
+    memset(g.mark, 0, numTasks * sizeof(*g.mark));
+    for (size_t i = 0; i < numTasks; i++) {
+        if (g.mark[i] == CRINIT_TASKGRAPH_UNVISITED) {
+            crinitTaskGraphVisitDepth(&g, i);
+        }
+    }
+
+    size_t critStart = CRINIT_TASKGRAPH_NO_TASK;
+    for (size_t i = 0; i < numTasks; i++) {
+        if (crinitTaskGraphIsPending(&tasks[i]) &&
+            (critStart == CRINIT_TASKGRAPH_NO_TASK || crinitTaskGraphChainLonger(&tasks[i], &tasks[critStart]))) {
+            critStart = i;
+        }
+    }
+    for (size_t i = critStart; i != CRINIT_TASKGRAPH_NO_TASK; i = g.bestSucc[i]) {
+        tasks[i].graph.critical = true;
+    }
+
+    crinitTaskGraphDestroy(&g);
+    return 0;
+}
+
+uint64_t crinitTaskGraphTaskDuration(const crinitTask_t *t) {
+    crinitNullCheck(0, t);
+
+    if (t->startTime.tv_sec == 0 && t->startTime.tv_nsec == 0) {
+        return 0;
+    }
+    long long diff = (t->endTime.tv_sec - t->startTime.tv_sec) * CRINIT_TASKGRAPH_NS_PER_SEC +
+                     (t->endTime.tv_nsec - t->startTime.tv_nsec);
+    return (diff > 0) ? (uint64_t)diff : 0;
+}
+
+int crinitTaskGraphCmpPriority(const void *a, const void *b) {
+    const crinitTask_t *ta = *(const crinitTask_t *const *)a;
+    const crinitTask_t *tb = *(const crinitTask_t *const *)b;
+
+    if (crinitTaskGraphChainLonger(ta, tb)) {
+        return -1;
+    }
+    if (crinitTaskGraphChainLonger(tb, ta)) {
+        return 1;
+    }
+    if (ta->graph.fanOut != tb->graph.fanOut) {
+        return (ta->graph.fanOut > tb->graph.fanOut) ? -1 : 1;
+    }
+    return (ta < tb) ? -1 : (ta > tb);
+}
+
+int crinitTaskGraphStopPlan(crinitTaskGraphStopPlan_t *plan, crinitTask_t *tasks, size_t numTasks) {
+    crinitNullCheck(-1, plan, tasks);
+
+    memset(plan, 0, sizeof(*plan));
+    if (numTasks == 0) {
+        return 0;
+    }
+
+    crinitTaskGraphWork_t g;
+    if (crinitTaskGraphBuild(&g, tasks, numTasks, true) == -1) {
+        crinitErrPrint("Could not build dependency graph of %zu tasks.", numTasks);
+        return -1;
+    }
+
+    // The graph already holds what we need: the successors of a task depend on it and the predecessors are what it
+    // depends on.
+    plan->numTasks = numTasks;
+    plan->waitCount = malloc(numTasks * sizeof(*plan->waitCount));
+    if (plan->waitCount == NULL) {
+        crinitErrnoPrint("Could not allocate memory for stop plan of %zu tasks.", numTasks);
+        crinitTaskGraphDestroy(&g);
+        return -1;
+    }
+    for (size_t i = 0; i < numTasks; i++) {
+        plan->waitCount[i] = g.succStart[i + 1] - g.succStart[i];
+    }
+    plan->depStart = g.predStart;
+    plan->depList = g.predList;
+    g.predStart = NULL;
+    g.predList = NULL;
+
+    crinitTaskGraphDestroy(&g);
+    return 0;
+}
+
+void crinitTaskGraphStopPlanDestroy(crinitTaskGraphStopPlan_t *plan) {
+    if (plan == NULL) {
+        return;
+    }
+    free(plan->waitCount);
+    free(plan->depStart);
+    free(plan->depList);
+    memset(plan, 0, sizeof(*plan));
+}
+
+static int crinitTaskGraphBuild(crinitTaskGraphWork_t *g, crinitTask_t *tasks, size_t numTasks, bool cfgDeps) {
+    memset(g, 0, sizeof(*g));
+    g->tasks = tasks;
+    g->numTasks = numTasks;
+
+    g->byName = malloc(numTasks * sizeof(*g->byName));
+    g->mark = calloc(numTasks, sizeof(*g->mark));
+    g->bestSucc = malloc(numTasks * sizeof(*g->bestSucc));
+    g->succStart = calloc(numTasks + 1, sizeof(*g->succStart));
+    g->predStart = calloc(numTasks + 1, sizeof(*g->predStart));
+    if (g->byName == NULL || g->mark == NULL || g->bestSucc == NULL || g->succStart == NULL || g->predStart == NULL) {
+        crinitErrnoPrint("Could not allocate memory for dependency graph analysis.");
+        goto fail;
+    }
+
+    for (size_t i = 0; i < numTasks; i++) {
+        g->byName[i] = &tasks[i];
+    }
+    qsort(g->byName, numTasks, sizeof(*g->byName), crinitTaskGraphCmpName);
+
+    for (size_t i = 0; i < numTasks; i++) {
+        const crinitTaskDep_t *deps = cfgDeps ? tasks[i].cfgDeps : tasks[i].deps;
+        size_t depsSize = cfgDeps ? tasks[i].cfgDepsSize : tasks[i].depsSize;
+        for (const crinitTaskDep_t *dep = deps; dep != deps + depsSize; dep++) {
+            if (strcmp(dep->name, CRINIT_PROVIDE_DEP_NAME) == 0) {
+                for (size_t j = 0; j < numTasks; j++) {
+                    for (size_t k = 0; k < tasks[j].prvSize; k++) {
+                        if (j != i && strcmp(tasks[j].prv[k].name, dep->event) == 0 &&
+                            crinitTaskGraphAddEdge(g, j, i) == -1) {
+                            goto fail;
+                        }
+                    }
+                }
+                continue;
+            }
+            if (dep->name[0] == '@') {
+                continue;
+            }
+            const crinitTask_t **found =
+                bsearch(dep->name, g->byName, numTasks, sizeof(*g->byName), crinitTaskGraphCmpNameKey);
+            if (found != NULL && *found != &tasks[i] && crinitTaskGraphAddEdge(g, *found - tasks, i) == -1) {
+                goto fail;
+            }
+        }
+    }
+
+    // Sort and deduplicate (a task may e.g. depend on both the spawn and the wait event of another task).
+    if (g->numEdges > 0) {
+        qsort(g->edges, g->numEdges, sizeof(*g->edges), crinitTaskGraphCmpEdge);
+        size_t uniq = 1;
+        for (size_t e = 1; e < g->numEdges; e++) {
+            if (g->edges[e].from != g->edges[uniq - 1].from || g->edges[e].to != g->edges[uniq - 1].to) {
+                g->edges[uniq++] = g->edges[e];
+            }
+        }
+        g->numEdges = uniq;
+    }
+
+    g->predList = malloc((g->numEdges + 1) * sizeof(*g->predList));
+    if (g->predList == NULL) {
+        crinitErrnoPrint("Could not allocate memory for dependency graph analysis.");
+        goto fail;
+    }
+
+    for (size_t e = 0; e < g->numEdges; e++) {
+        g->succStart[g->edges[e].from + 1]++;
+        g->predStart[g->edges[e].to + 1]++;
+    }
+    for (size_t i = 0; i < numTasks; i++) {
+        g->succStart[i + 1] += g->succStart[i];
+        g->predStart[i + 1] += g->predStart[i];
+        g->bestSucc[i] = CRINIT_TASKGRAPH_NO_TASK;
+    }
+    for (size_t e = 0; e < g->numEdges; e++) {
+        g->predList[g->predStart[g->edges[e].to]++] = g->edges[e].from;
+    }
+    // The fill loop above has advanced each start index to the start of the next task, so shift them back.
+    for (size_t i = numTasks; i > 0; i--) {
+        g->predStart[i] = g->predStart[i - 1];
+    }
+    g->predStart[0] = 0;
+
+    return 0;
+
+fail:
+    crinitTaskGraphDestroy(g);
+    return -1;
+}
+
+static void crinitTaskGraphDestroy(crinitTaskGraphWork_t *g) {
+    free(g->edges);
+    free(g->succStart);
+    free(g->predStart);
+    free(g->predList);
+    free(g->bestSucc);
+    free(g->mark);
+    free(g->byName);
+    memset(g, 0, sizeof(*g));
+}
+
+static int crinitTaskGraphAddEdge(crinitTaskGraphWork_t *g, size_t from, size_t to) {
+    if (g->numEdges == g->edgesCap) {
+        size_t newCap = (g->edgesCap == 0) ? g->numTasks : g->edgesCap * 2;
+        crinitTaskGraphEdge_t *newEdges = realloc(g->edges, newCap * sizeof(*newEdges));
+        if (newEdges == NULL) {
+            crinitErrnoPrint("Could not allocate memory for %zu dependency graph edges.", newCap);
+            return -1;
+        }
+        g->edges = newEdges;
+        g->edgesCap = newCap;
+    }
+    g->edges[g->numEdges].from = from;
+    g->edges[g->numEdges].to = to;
+    g->numEdges++;
+    return 0;
+}
+
+static void crinitTaskGraphVisitChain(crinitTaskGraphWork_t *g, size_t idx) {
+    crinitTask_t *t = &g->tasks[idx];
+    g->mark[idx] = CRINIT_TASKGRAPH_IN_PROGRESS;
+
+    size_t best = CRINIT_TASKGRAPH_NO_TASK;
+    for (size_t e = g->succStart[idx]; e < g->succStart[idx + 1]; e++) {
+        size_t succ = g->edges[e].to;
+        if (g->mark[succ] == CRINIT_TASKGRAPH_IN_PROGRESS) {
+            crinitDbgInfoPrint("Dependency cycle between \'%s\' and \'%s\' detected. Ignoring the edge.", t->name,
+                               g->tasks[succ].name);
+            continue;
+        }
+        if (g->mark[succ] == CRINIT_TASKGRAPH_UNVISITED) {
+            crinitTaskGraphVisitChain(g, succ);
+        }
+        if (best == CRINIT_TASKGRAPH_NO_TASK || crinitTaskGraphChainLonger(&g->tasks[succ], &g->tasks[best])) {
+            best = succ;
+        }
+    }
+
+    t->graph.fanOut = g->succStart[idx + 1] - g->succStart[idx];
+    t->graph.chainLen = 1;
+    t->graph.chainNs = crinitTaskGraphTaskDuration(t);
+    if (best != CRINIT_TASKGRAPH_NO_TASK) {
+        t->graph.chainLen += g->tasks[best].graph.chainLen;
+        t->graph.chainNs += g->tasks[best].graph.chainNs;
+    }
+    g->bestSucc[idx] = best;
+    g->mark[idx] = CRINIT_TASKGRAPH_DONE;
+}
+
+static void crinitTaskGraphVisitDepth(crinitTaskGraphWork_t *g, size_t idx) {
+    crinitTask_t *t = &g->tasks[idx];
+    g->mark[idx] = CRINIT_TASKGRAPH_IN_PROGRESS;
+
+    t->graph.depth = 0;
+    for (size_t p = g->predStart[idx]; p < g->predStart[idx + 1]; p++) {
+        size_t pred = g->predList[p];
+        if (g->mark[pred] == CRINIT_TASKGRAPH_IN_PROGRESS) {
+            continue;
+        }
+        if (g->mark[pred] == CRINIT_TASKGRAPH_UNVISITED) {
+            crinitTaskGraphVisitDepth(g, pred);
+        }
+        if (g->tasks[pred].graph.depth + 1 > t->graph.depth) {
+            t->graph.depth = g->tasks[pred].graph.depth + 1;
+        }
+    }
+    g->mark[idx] = CRINIT_TASKGRAPH_DONE;
+}
+
+static inline bool crinitTaskGraphChainLonger(const crinitTask_t *a, const crinitTask_t *b) {
+    if (a->graph.chainNs != b->graph.chainNs) {
+        return a->graph.chainNs > b->graph.chainNs;
+    }
+    return a->graph.chainLen > b->graph.chainLen;
+}
+
+static inline bool crinitTaskGraphIsPending(const crinitTask_t *t) {
+    return !(t->state & (CRINIT_TASK_STATE_DONE | CRINIT_TASK_STATE_FAILED)) || (t->opts & CRINIT_TASK_OPT_RESPAWN);
+}
+
+static int crinitTaskGraphCmpName(const void *a, const void *b) {
+    const crinitTask_t *ta = *(const crinitTask_t *const *)a;
+    const crinitTask_t *tb = *(const crinitTask_t *const *)b;
+    return strcmp(ta->name, tb->name);
+}
+
+static int crinitTaskGraphCmpNameKey(const void *key, const void *elem) {
+    const crinitTask_t *t = *(const crinitTask_t *const *)elem;
+    return strcmp(key, t->name);
+}
+
+static int crinitTaskGraphCmpEdge(const void *a, const void *b) {
+    const crinitTaskGraphEdge_t *ea = a;
+    const crinitTaskGraphEdge_t *eb = b;
+    if (ea->from != eb->from) {
+        return (ea->from < eb->from) ? -1 : 1;
+    }
+    if (ea->to != eb->to) {
+        return (ea->to < eb->to) ? -1 : 1;
+    }
+    return 0;
+}
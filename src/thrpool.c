@@ -159,6 +159,21 @@ int crinitThreadPoolThreadAvailCallback(crinitThreadPool_t *ctx) {
     return 0;
 }
 
+int crinitThreadPoolGetStats(crinitThreadPool_t *ctx, size_t *poolSize, size_t *threadAvail) {
+    if (ctx == NULL || poolSize == NULL || threadAvail == NULL) {
+        crinitErrPrint("Pointer parameters must not be NULL.");
+        return -1;
+    }
+    if ((errno = pthread_mutex_lock(&ctx->lock)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock on thread pool.");
+        return -1;
+    }
+    *poolSize = ctx->poolSize;
+    *threadAvail = ctx->threadAvail;
+    pthread_mutex_unlock(&ctx->lock);
+    return 0;
+}
+
 static int crinitThreadPoolGrow(crinitThreadPool_t *ctx, size_t newSize) {
     if (ctx == NULL) {
         crinitErrPrint("The given thread pool context must not be NULL.");
@@ -6,6 +6,7 @@
 #include "timer.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -39,41 +40,63 @@ static const char *crinitMonthToStr(uint8_t m);
  */
 static int crinitMonthLength(uint8_t month, uint16_t year);
 /**
- * Get the next value for a range.
+ * Get a bitset of all values in a range.
  *
- * @param last      the value to get the next from
- * @param interval  the interval in which the next needs to be
- * @param start     the lowest possible value
- * @param limit     the highest possible value
+ * @param range  the range, wraps around from \a hi to \a lo if range[0] > range[1]
+ * @param lo     the lowest possible value
+ * @param hi     the highest possible value
  *
- * @param res: next value after last
- * @param off: the offset to the last value
+ * @return the bitset with bit n set if n is in the range
+ */
+static uint64_t crinitRangeBits(unsigned range[2], unsigned lo, unsigned hi);
+/**
+ * Get the number of days since 1970-01-01 of a date.
+ *
+ * @param year   the year
+ * @param month  the month starting at 1 for Jan
+ * @param day    the day of the month starting at 1
  *
- * @return true if the res is after last and false if the next interval needs to be updated as well
+ * @return  the number of days, negative for dates before 1970
  */
-static bool crinitNext(int last, uint8_t interval[2], int start, int limit, int *res, long long int *offs);
+static long long crinitDaysFromCivil(long long year, unsigned month, unsigned day);
 /**
- * get the next year
+ * Get the date of a number of days since 1970-01-01, inverse of crinitDaysFromCivil().
  *
- * @param last      the year from which to start finding the next
- * @param interval  the interval in which the next year needs to be in
+ * @param days   the number of days
+ * @param year   return pointer for the year
+ * @param month  return pointer for the month starting at 1 for Jan
+ * @param day    return pointer for the day of the month starting at 1
+ */
+static void crinitCivilFromDays(long long days, long long *year, unsigned *month, unsigned *day);
+/**
+ * Get the lowest set bit at or above a position.
+ *
+ * @param bits  the bitset to search
+ * @param from  the position to start searching
+ *
+ * @return the position of the bit, -1 if there is none
+ */
+static int crinitBitFrom(uint64_t bits, unsigned from);
+/**
+ * Find the first matching day at or after a date.
  *
- * @param res   the resulting next year
- * @param offs  the offset the next year has to the last
+ * @param tc     the compiled timer
+ * @param year   the year to start from, updated to the year of the matching day
+ * @param month  the month to start from, updated to the month of the matching day
+ * @param day    the day to start from, may be past the end of the month, updated to the matching day
  *
- * @return true if a next year is found/possible in the interval, false if not
+ * @return true if a matching day was found, false if there is none
  */
-static bool crinitNextYear(int last, uint16_t interval[2], int *res, long long int *offs);
+static bool crinitTimerNextDay(const crinitTimerCompiled_t *tc, long long *year, unsigned *month, unsigned *day);
 /**
- * Returns the number of days from start of the year to the first of the specified month
- * ie. 0 for 1 (Jan), 31 for 2 (Feb), 59 (or 60 in a leap year) for 3 (Mar) and so on
+ * Find the first matching time of a day at or after a given second of that day.
  *
- * @param m     the month to get how many days the year had before the fist of it
- * @param year  the year to check in
+ * @param tc   the compiled timer
+ * @param sec  the second of the day to start from
  *
- * @return  the number of days the year had before the first of that month
+ * @return the matching second of the day, -1 if there is none left that day
  */
-static int crinitDaysToMonth(uint8_t m, uint16_t year);
+static long crinitTimerNextSecOfDay(const crinitTimerCompiled_t *tc, long sec);
 
 void crinitTimerSetDefault(crinitTimerDef_t *td) {
     td->wDay = 0x7f;
@@ -91,6 +114,8 @@ void crinitTimerSetDefault(crinitTimerDef_t *td) {
     td->seconds[1] = 0;
     td->timezone[0] = 0;
     td->timezone[1] = 0;
+    td->intervalNs = 0;
+    td->sinceArmed = false;
 }
 
 static bool crinitIsLeapYear(uint16_t year) {
@@ -108,6 +133,10 @@ static const char *crinitMonthToStr(uint8_t m) {
 
 int crinitSPrintTimerDef(char *s, crinitTimerDef_t *td) {
     int off = 0;
+    if (td->intervalNs > 0) {
+        return sprintf(s, "%s %" PRIu64 ".%09" PRIu64 "s", td->sinceArmed ? "after" : "every",
+                       td->intervalNs / 1000000000, td->intervalNs % 1000000000);
+    }
     if (td->years[0] == td->years[1]) {
         off += sprintf(s + off, "%04d-", td->years[0]);
     } else {
@@ -216,7 +245,7 @@ bool crinitCheckTimerTime(struct timespec ts, crinitTimerDef_t *td) {
     return (CC_RANGE(td->seconds[0], t.tm_sec, td->seconds[1]) || CO_RANGE(t.tm_sec, td->seconds[1], td->seconds[0]) ||
             OC_RANGE(td->seconds[1], td->seconds[0], t.tm_sec)) &&
            (CC_RANGE(td->minutes[0], t.tm_min, td->minutes[1]) || CO_RANGE(t.tm_min, td->minutes[1], td->minutes[0]) ||
-            OC_RANGE(td->minutes[0], td->minutes[1], t.tm_min)) &&
+            OC_RANGE(td->minutes[1], td->minutes[0], t.tm_min)) &&
            (CC_RANGE(td->hours[0], t.tm_hour, td->hours[1]) || CO_RANGE(t.tm_hour, td->hours[1], td->hours[0]) ||
             OC_RANGE(td->hours[1], td->hours[0], t.tm_hour)) &&
            (CC_RANGE(td->days[0], t.tm_mday, td->days[1]) || CO_RANGE(t.tm_mday, td->days[1], td->days[0]) ||
@@ -250,95 +279,6 @@ static int crinitMonthLength(uint8_t month, uint16_t year) {
     }
 }
 
-static bool crinitNext(int last, uint8_t interval[2], int start, int limit, int *res, long long int *offs) {
-    uint8_t range[2] = {start <= interval[0] ? interval[0] : start, interval[1] <= limit ? interval[1] : limit};
-    long long int off = 0;
-    bool done = false;
-    if (range[0] == range[1]) {
-        // if its a single possible value set the offset to the difference
-        // what amount needs to change to get to that value
-        off += (range[0] - last);
-    } else if (range[0] < range[1]) {
-        // a "standard" range of start < end
-        if (CO_RANGE(range[0], last, range[1])) {
-            // if last is in the range [start, end) it just 1 needs to be added
-            off += 1;
-        } else {
-            // if not next needs to be set to start
-            off += (range[0] - last);
-        }
-    } else if (range[0] > range[1]) {
-        // if the range wraps around
-        // ie is a range from start to range[1] and one from range[0] to limit
-        if (CO_RANGE(range[1], last, range[0])) {
-            // last is in the not allowed interval between range[1] and range[0]
-            // set next to range[0]
-            off += (range[0] - last);
-        } else if (last == limit) {
-            // last is the limit set next to start
-            off -= (limit - start);
-        } else {
-            // otherwise just 1 can be added
-            off += 1;
-        }
-    }
-    if (off > 0) {
-        // if the offset is positive the next value can be found
-        // within the range without rolling over
-        done = true;
-    }
-    *offs = off;
-    *res = last + off;
-    return done;
-}
-
-static bool crinitNextYear(int last, uint16_t interval[2], int *res, long long int *offs) {
-    if (interval[0] == interval[1]) {
-        crinitErrPrint("was only supposed to run in the year %d", last);
-        return false;
-    } else if (interval[0] < interval[1]) {
-        if (CO_RANGE(interval[0], last, interval[1])) {
-            *res = last + 1;
-            *offs = 1;
-            return true;
-        } else {
-            crinitErrPrint("%d was the last possible year", last);
-            return false;
-        }
-    } else {
-        if (last < interval[1]) {
-            *res = last + 1;
-            *offs = 1;
-            return true;
-        } else if (last >= interval[0]) {
-            *offs = 1;
-            *res = last + 1;
-            return true;
-        } else {
-            *res = interval[0];
-            *offs = interval[0] - last;
-            crinitErrPrint("something super weird with the year %d", last);
-            return false;
-        }
-    }
-    return false;
-}
-
-static const int crinitDayToMonthLookup[] = {
-    [1] = 0,   [2] = 31,  [3] = 59,  [4] = 90,   [5] = 120,  [6] = 151,
-    [7] = 181, [8] = 212, [9] = 243, [10] = 273, [11] = 304, [12] = 334,
-};
-
-static int crinitDaysToMonth(uint8_t m, uint16_t year) {
-    if (m != 0 && m <= 2) {
-        return crinitDayToMonthLookup[m];
-    } else if (m <= 12) {
-        return crinitDayToMonthLookup[m] + crinitIsLeapYear(year);
-    } else {
-        return -1;
-    }
-}
-
 struct tm *crinitZonedTimeR(const time_t *time, int8_t timezone[2], struct tm *restrict result) {
     long off = (long)timezone[0] * 3600 + (long)timezone[1] * 60;
     time_t tmpT = (*time) + off;
@@ -348,74 +288,187 @@ struct tm *crinitZonedTimeR(const time_t *time, int8_t timezone[2], struct tm *r
 }
 
 struct timespec crinitTimerNextTime(struct timespec *last, crinitTimerDef_t *td) {
-    time_t t = last->tv_sec;
-    struct tm times = {0};
-    crinitZonedTimeR(&t, td->timezone, &times);
+    crinitTimerCompiled_t tc;
+    crinitTimerCompile(td, &tc);
+    return crinitTimerNextTimeCompiled(last, &tc);
+}
 
+struct timespec crinitTimerNextInterval(const struct timespec *last, const struct timespec *now, uint64_t intervalNs) {
     struct timespec next = {0};
+    if (intervalNs == 0) {
+        return next;
+    }
+    int64_t lastNs = (int64_t)last->tv_sec * 1000000000 + last->tv_nsec;
+    int64_t nowNs = (int64_t)now->tv_sec * 1000000000 + now->tv_nsec;
+    uint64_t periods = (nowNs >= lastNs) ? (uint64_t)(nowNs - lastNs) / intervalNs + 1 : 1;
+    int64_t nextNs = lastNs + (int64_t)(periods * intervalNs);
+    next.tv_sec = (time_t)(nextNs / 1000000000);
+    next.tv_nsec = (long)(nextNs % 1000000000);
+    return next;
+}
 
-    // tells if a next time is already found
-    bool done = false;
+static uint64_t crinitRangeBits(unsigned range[2], unsigned lo, unsigned hi) {
+    uint64_t bits = 0;
+    for (unsigned i = lo; i <= hi; i++) {
+        if (CC_RANGE(range[0], i, range[1]) || CO_RANGE(i, range[1], range[0]) || OC_RANGE(range[1], range[0], i)) {
+            bits |= UINT64_C(1) << i;
+        }
+    }
+    return bits;
+}
 
-    long long int offSec = 0;
-    long long int offMin = 0;
-    long long int offHour = 0;
-    long long int offDays = 0;
+void crinitTimerCompile(const crinitTimerDef_t *td, crinitTimerCompiled_t *tc) {
+    unsigned seconds[2] = {td->seconds[0], td->seconds[1]};
+    unsigned minutes[2] = {td->minutes[0], td->minutes[1]};
+    unsigned hours[2] = {td->hours[0], td->hours[1]};
+    unsigned days[2] = {td->days[0], td->days[1]};
+    unsigned months[2] = {td->month[0], td->month[1]};
 
-    long long int off = 0;
-    int partRes = 0;
-    // update seconds
-    done = crinitNext(times.tm_sec, td->seconds, 0, 59, &partRes, &offSec);
-    if (!done || !CC_RANGE(td->minutes[0], times.tm_min, td->minutes[1])) {
-        // update minutes only if last time wasn't a valid timestamp or no valid time was found yet
-        // if a valid next second is still at an invalid minute the whole timestamp is still invalid
-        done = crinitNext(times.tm_min, td->minutes, 0, 59, &partRes, &offMin);
+    tc->seconds = crinitRangeBits(seconds, 0, 59);
+    tc->minutes = crinitRangeBits(minutes, 0, 59);
+    tc->hours = (uint32_t)crinitRangeBits(hours, 0, 23);
+    tc->years[0] = td->years[0];
+    tc->years[1] = td->years[1];
+    tc->tzOffset = (long)td->timezone[0] * 3600 + (long)td->timezone[1] * 60;
+
+    uint64_t dayBits = crinitRangeBits(days, 1, 31);
+    uint64_t monthBits = crinitRangeBits(months, 1, 12);
+    for (unsigned leap = 0; leap < 2; leap++) {
+        tc->monthDays[leap][0] = 0;
+        for (unsigned m = 1; m <= 12; m++) {
+            // Year 2000 is a leap year, 2001 is not.
+            int len = crinitMonthLength((uint8_t)m, leap ? 2000 : 2001);
+            uint64_t inMonth = ((UINT64_C(1) << (len + 1)) - 1) & ~UINT64_C(1);
+            tc->monthDays[leap][m] = (monthBits & (UINT64_C(1) << m)) ? (uint32_t)(dayBits & inMonth) : 0;
+        }
     }
-    if (!done || !CC_RANGE(td->hours[0], times.tm_hour, td->hours[1])) {
-        done = crinitNext(times.tm_hour, td->hours, 0, 23, &partRes, &offHour);
+    for (unsigned first = 0; first < 7; first++) {
+        tc->weekdayDays[first] = 0;
+        for (unsigned d = 1; d <= 31; d++) {
+            if (td->wDay & (1 << ((first + d - 1) % 7))) {
+                tc->weekdayDays[first] |= UINT32_C(1) << d;
+            }
+        }
     }
-    int day = times.tm_mday;
-    int month = times.tm_mon + 1;
-    int year = times.tm_year + 1900;
-    int tries = 0;
-    do {
-        if (!done || !CC_RANGE(td->days[0], day, td->days[1])) {
-            int last = day;
-            // special case needed for Feb 29 to stay on Feb 29 and just update the year
-            if (td->days[0] == 29 && td->days[1] == 29 && td->month[0] == 2 && td->month[1] == 2 && day == 29) {
-                done = false;
-            } else {
-                int ml = crinitMonthLength(month, year);
-                done = crinitNext(last, td->days, 1, ml, &day, &off);
-                offDays += off;
+}
+
+static long long crinitDaysFromCivil(long long year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yoe = (unsigned)(year - era * 400);
+    unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (long long)doe - 719468;
+}
+
+static void crinitCivilFromDays(long long days, long long *year, unsigned *month, unsigned *day) {
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned doe = (unsigned)(days - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    *day = doy - (153 * mp + 2) / 5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year = (long long)yoe + era * 400 + (*month <= 2);
+}
+
+static int crinitBitFrom(uint64_t bits, unsigned from) {
+    if (from >= 64) {
+        return -1;
+    }
+    bits &= UINT64_MAX << from;
+    return bits ? __builtin_ctzll(bits) : -1;
+}
+
+static bool crinitTimerNextDay(const crinitTimerCompiled_t *tc, long long *year, unsigned *month, unsigned *day) {
+    long long y = *year;
+    unsigned m = *month, d = *day;
+    while (y <= UINT16_MAX) {
+        long long nextY = y;
+        if (tc->years[0] <= tc->years[1]) {
+            if (nextY < tc->years[0]) {
+                nextY = tc->years[0];
+            } else if (nextY > tc->years[1]) {
+                return false;
             }
+        } else if (nextY > tc->years[1] && nextY < tc->years[0]) {
+            nextY = tc->years[0];
         }
-        if (!done || !CC_RANGE(td->month[0], month, td->month[1])) {
-            int last = month;
-            done = crinitNext(last, td->month, 1, 12, &month, &off);
-            offDays += crinitDaysToMonth(month, year) - crinitDaysToMonth(last, year);
+        if (nextY != y) {
+            y = nextY;
+            m = 1;
+            d = 1;
         }
-        if (!done || !CC_RANGE(td->years[0], year, td->years[1])) {
-            int last = year;
-            done = crinitNextYear(last, td->years, &year, &off);
-            offDays += off * (365 + (crinitIsLeapYear(last) ? 1 : 0));
+
+        uint32_t days = tc->monthDays[crinitIsLeapYear((uint16_t)y)][m];
+        if (days != 0 && d <= 31) {
+            unsigned firstWDay = (unsigned)(((crinitDaysFromCivil(y, m, 1) + 3) % 7 + 7) % 7);
+            int found = crinitBitFrom(days & tc->weekdayDays[firstWDay], d);
+            if (found != -1) {
+                *year = y;
+                *month = m;
+                *day = (unsigned)found;
+                return true;
+            }
+        }
+        d = 1;
+        if (++m > 12) {
+            m = 1;
+            y++;
         }
-        if (!done) {
-            crinitErrPrint("No possible next time found for timer");
-            break;
+    }
+    return false;
+}
+
+static long crinitTimerNextSecOfDay(const crinitTimerCompiled_t *tc, long sec) {
+    int h = crinitBitFrom(tc->hours, (unsigned)(sec / 3600));
+    int m = (h == sec / 3600) ? crinitBitFrom(tc->minutes, (unsigned)(sec / 60 % 60)) : crinitBitFrom(tc->minutes, 0);
+    int s = (h == sec / 3600 && m == sec / 60 % 60) ? crinitBitFrom(tc->seconds, (unsigned)(sec % 60))
+                                                     : crinitBitFrom(tc->seconds, 0);
+    if (h != -1 && m != -1 && s == -1) {
+        m = crinitBitFrom(tc->minutes, (unsigned)m + 1);
+        s = crinitBitFrom(tc->seconds, 0);
+    }
+    if (h != -1 && m == -1) {
+        h = crinitBitFrom(tc->hours, (unsigned)h + 1);
+        m = crinitBitFrom(tc->minutes, 0);
+        s = crinitBitFrom(tc->seconds, 0);
+    }
+    if (h == -1 || m == -1 || s == -1) {
+        return -1;
+    }
+    return (long)h * 3600 + m * 60 + s;
+}
+
+struct timespec crinitTimerNextTimeCompiled(const struct timespec *last, const crinitTimerCompiled_t *tc) {
+    struct timespec next = {0};
+    if (tc->seconds == 0 || tc->minutes == 0 || tc->hours == 0) {
+        return next;
+    }
+
+    long long local = (long long)last->tv_sec + tc->tzOffset + 1;
+    long long days = (local >= 0 ? local : local - 86399) / 86400;
+    long sec = (long)(local - days * 86400);
+    long long year;
+    unsigned month, day;
+    crinitCivilFromDays(days, &year, &month, &day);
+
+    // Loops at most twice, the first day after a matching one without a matching time left starts at midnight.
+    while (crinitTimerNextDay(tc, &year, &month, &day)) {
+        long long found = crinitDaysFromCivil(year, month, day);
+        if (found != days) {
+            days = found;
+            sec = 0;
         }
-        if (done) {
+        long secOfDay = crinitTimerNextSecOfDay(tc, sec);
+        if (secOfDay != -1) {
+            next.tv_sec = (time_t)(days * 86400 + secOfDay - tc->tzOffset);
             next.tv_nsec = last->tv_nsec;
-            next.tv_sec = last->tv_sec + offSec + offMin * 60 + offHour * 3600 + offDays * 86400;
-            done = crinitCheckTimerTime(next, td);
+            return next;
         }
-        // because we don't consider the weekday when updating the day/month/year
-        // we repeat that step until everything including the weekday is valid
-        // or a limit of tries is reached that was enough reliably find Feb 29 for individual weekdays
-    } while (!done && tries++ <= 40);
-    if (!done) {
-        next.tv_sec = 0;
-        next.tv_nsec = 0;
+        day++;
     }
+    crinitErrPrint("No possible next time found for timer");
     return next;
 }
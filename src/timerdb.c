@@ -5,20 +5,50 @@
  */
 #include "timerdb.h"
 
+#include <errno.h>
+#include <inttypes.h>
 #include <poll.h>
 #include <pthread.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/eventfd.h>
 #include <sys/timerfd.h>
 #include <unistd.h>
 
 #include "common.h"
+#include "confparse.h"
+#include "globopt.h"
+#include "lockprof.h"
 #include "logio.h"
 #include "taskdb.h"
 #include "timer.h"
+#include "timerstore.h"
+#include "usdt.h"
 
-crinitTimerDB_t crinitTimerPool = {0};
+/** Number of file descriptors polled by the timer thread: the eventfd and one timerfd per crinitTimerQueue_t. **/
+#define CRINIT_TIMER_DB_POLL_FDS 5
+
+/** Number of nanoseconds in a millisecond. **/
+#define CRINIT_TIMER_DB_NS_PER_MS 1000000LL
+/** Number of nanoseconds in a second. **/
+#define CRINIT_TIMER_DB_NS_PER_SEC 1000000000LL
+
+crinitTimerDB_t crinitTimerPool = {
+    .calendar.fd = -1, .interval.fd = -1, .respawn.fd = -1, .after.fd = -1, .eventFd = -1};
+
+/**
+ * A growable list of expired timers, collected by the timer thread to be passed to the TaskDB.
+ */
+typedef struct crinitTimerExpiredList {
+    /**
+     * The `@timer` dependencies to fulfill. For respawn timers, the task names as event. For after timers, the task
+     * name as name and the spelling as event, both in the same allocation starting at the name.
+     */
+    crinitTaskDep_t *deps;
+    size_t size;  ///< Number of elements in crinitTimerExpiredList_t::deps.
+    size_t cap;   ///< Number of elements crinitTimerExpiredList_t::deps has space for.
+} crinitTimerExpiredList_t;
 
 /**
  * The TimerDB thread function that handles the triggering of all timer events.
@@ -34,129 +64,378 @@ static void *crinitTimerDBRunPool(void *args);
 static void crinitPrintTimerPool(crinitTimerDB_t *pool);
 /**
  * Insert a timer into the timerDB.
- * The timer needs to be fully initialized including the next timestamp
+ * The timer needs to be fully initialized including the next timestamp as an absolute time on the clock of its queue.
  *
  * @param timer  the timer to insert
  *
  * @return 0 on success, -1 on error
  */
 static int crinitTimerDBInsertTimer(crinitTimer_t timer);
+/**
+ * Push a timer into the heap of its queue and wake up the timer thread if needed. Caller must hold
+ * crinitTimerDB_t::lock.
+ *
+ * @param timer  the timer to push, see crinitTimerDBInsertTimer()
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitTimerDBPushTimer(crinitTimer_t *timer);
+/**
+ * Initialize a timer queue including its timerfd.
+ *
+ * @param q      The queue to initialize.
+ * @param clock  The clock of the timers in the queue.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitTimerQueueInit(crinitTimerQueue_t *q, clockid_t clock);
+/**
+ * Take the next expired timer out of a queue and append it to a list. Caller must hold crinitTimerDB_t::lock.
+ *
+ * A recurring timer stays in the queue and is rescheduled, a copy of each of its spellings is appended. A one-shot
+ * timer is removed and the ownership of its name passes to the list, see crinitTimerExpiredList_t::deps.
+ *
+ * @param q     The queue to check.
+ * @param list  The list to append to.
+ *
+ * @return 1 if a timer has expired, 0 if none has, -1 on error
+ */
+static int crinitTimerQueueExpire(crinitTimerQueue_t *q, crinitTimerExpiredList_t *list);
+/**
+ * Make room for a number of timers in a list of expired timers.
+ *
+ * @param list  The list.
+ * @param n     The number of timers to be appended.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitTimerExpiredListReserve(crinitTimerExpiredList_t *list, size_t n);
+/**
+ * Take all expired timers out of a queue and append them to a list. Caller must hold crinitTimerDB_t::lock.
+ *
+ * @param q     The queue to check.
+ * @param list  The list to append to, takes ownership of the names, see crinitTimerExpiredList_t::deps.
+ */
+static void crinitTimerQueueCollect(crinitTimerQueue_t *q, crinitTimerExpiredList_t *list);
+/**
+ * Arm the timerfd of a queue for its first timer or disarm it if the queue is empty. Caller must hold
+ * crinitTimerDB_t::lock.
+ *
+ * @param q        The queue.
+ * @param slackMs  The timerfd is armed for the next multiple of this many milliseconds, 0 to arm it exactly.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitTimerQueueArm(crinitTimerQueue_t *q, unsigned long long slackMs);
+/**
+ * Wake up the timer thread so it re-arms the timerfds. Caller must hold crinitTimerDB_t::lock.
+ */
+static void crinitTimerDBNotify(void);
+/**
+ * Let a calendar timer expire right away if it has missed an expiration since its last one in
+ * crinitTimerDB_t::lastRuns. Caller must hold crinitTimerDB_t::lock.
+ *
+ * Sets crinitTimer_t::catchUpPending if the last expiration is after \a now, i.e. the system time has not been set yet.
+ *
+ * @param t    The timer, crinitTimer_t::next is set to \a now if it has missed an expiration.
+ * @param now  The current time.
+ *
+ * @return true if the timer has missed an expiration, false otherwise
+ */
+static bool crinitTimerDBCatchUp(crinitTimer_t *t, time_t now);
+/**
+ * Recompute the next expiration of all timers in a queue after the system time has been set. Caller must hold
+ * crinitTimerDB_t::lock.
+ *
+ * See crinitTimerDBClockSet(). This takes O(n) for all timers together.
+ *
+ * @param q        The queue of calendar timers.
+ * @param now      The new system time.
+ * @param bootNow  The current time on `CLOCK_BOOTTIME`.
+ */
+static void crinitTimerQueueReschedule(crinitTimerQueue_t *q, const struct timespec *now,
+                                       const struct timespec *bootNow);
+/**
+ * Get the queue a timer belongs to.
+ *
+ * @param type  The type of the timer.
+ *
+ * @return the queue for timers of \a type
+ */
+static crinitTimerQueue_t *crinitTimerDBQueueOf(crinitTimerType_t type);
+/**
+ * Remove an `@timer` dependency timer from its queue and from crinitTimerDB_t::index. Caller must hold
+ * crinitTimerDB_t::lock.
+ *
+ * @param e  The index entry of the timer.
+ */
+static void crinitTimerDBDropEntry(crinitTimerEntry_t *e);
+/**
+ * Find the timer armed for a task using crinitTimerDBArmTaskTimer(). Caller must hold crinitTimerDB_t::lock.
+ *
+ * Takes O(n).
+ *
+ * @param taskName  The name of the task.
+ * @param timerStr  The spelling of the timer.
+ *
+ * @return the index of the timer in the heap of crinitTimerDB_t::after or #CRINIT_TIMER_HEAP_NOT_FOUND
+ */
+static size_t crinitTimerDBFindTaskTimer(const char *taskName, const char *timerStr);
 
 int crinitTimerDBInit(crinitTaskDB_t *taskDB) {
     crinitNullCheck(-1, taskDB);
     crinitInfoPrint("Initializing TimerDB");
-    crinitTimerPool.cap = TIMER_DB_INITIAL_CAP;
-    crinitTimerPool.timerList = calloc(TIMER_DB_INITIAL_CAP, sizeof(crinitTimer_t));
-    if (crinitTimerPool.timerList == NULL) {
-        crinitErrnoPrint("Could not allocate memory for TimerDB.");
-        crinitTimerPool.cap = 0;
+    if (crinitTimerIndexInit(&crinitTimerPool.index, TIMER_DB_INITIAL_CAP) == -1) {
+        crinitErrPrint("Could not initialize timer index of TimerDB.");
         return -1;
     }
-    crinitTimerPool.pollList = calloc(TIMER_DB_INITIAL_CAP, sizeof(struct pollfd));
-    if (crinitTimerPool.pollList == NULL) {
-        crinitErrnoPrint("Could not allocate memory for TimerDB.");
-        goto failPollList;
+    if (crinitTimerQueueInit(&crinitTimerPool.calendar, CLOCK_REALTIME) == -1) {
+        crinitErrPrint("Could not initialize calendar timers of TimerDB.");
+        goto failCalendar;
+    }
+    // Interval timers count from boot, including time spent in suspend.
+    if (crinitTimerQueueInit(&crinitTimerPool.interval, CLOCK_BOOTTIME) == -1) {
+        crinitErrPrint("Could not initialize interval timers of TimerDB.");
+        goto failInterval;
+    }
+    // Respawn timers are relative to now and must not be affected by changes of the system time.
+    if (crinitTimerQueueInit(&crinitTimerPool.respawn, CLOCK_MONOTONIC) == -1) {
+        crinitErrPrint("Could not initialize respawn timers of TimerDB.");
+        goto failRespawn;
+    }
+    // After timers count from when a task is armed, including time spent in suspend.
+    if (crinitTimerQueueInit(&crinitTimerPool.after, CLOCK_BOOTTIME) == -1) {
+        crinitErrPrint("Could not initialize after timers of TimerDB.");
+        goto failAfter;
     }
-    crinitTimerPool.size = 0;
 
-    crinitTimerPool.pollList[0].fd = eventfd(0, 0);
-    if (crinitTimerPool.pollList[0].fd == -1) {
+    crinitTimerPool.eventFd = eventfd(0, EFD_CLOEXEC);
+    if (crinitTimerPool.eventFd == -1) {
         crinitErrnoPrint("Could not get eventfd for TimerDB.");
         goto fail;
     }
     crinitTimerPool.taskDB = taskDB;
-    crinitTimerPool.pollList[0].events = POLLIN;
-    crinitTimerPool.size = 1;
+
+    unsigned long long slackMs = CRINIT_CONFIG_DEFAULT_TIMER_SLACK;
+    if (crinitGlobOptGet(CRINIT_GLOBOPT_TIMER_SLACK, &slackMs) == -1) {
+        crinitErrPrint("Could not get value of '%s', timers will expire exactly.", CRINIT_CONFIG_KEYSTR_TIMER_SLACK);
+        slackMs = CRINIT_CONFIG_DEFAULT_TIMER_SLACK;
+    }
+    if (slackMs > CRINIT_TIMER_DB_MAX_SLACK_MS) {
+        crinitErrPrint("'%s' of %llums is too large, using %llums.", CRINIT_CONFIG_KEYSTR_TIMER_SLACK, slackMs,
+                       CRINIT_TIMER_DB_MAX_SLACK_MS);
+        slackMs = CRINIT_TIMER_DB_MAX_SLACK_MS;
+    }
+    crinitTimerPool.slackMs = slackMs;
+
+    char *stateFile = NULL;
+    if (crinitGlobOptGet(CRINIT_GLOBOPT_TIMER_STATE_FILE, &stateFile) == -1) {
+        crinitErrPrint("Could not get value of '%s', missed timers will not be caught up on.",
+                       CRINIT_CONFIG_KEYSTR_TIMER_STATE_FILE);
+    } else if (stateFile != NULL) {
+        if (crinitTimerStoreInit(&crinitTimerPool.lastRuns, stateFile) == 0 &&
+            crinitTimerStoreLoad(&crinitTimerPool.lastRuns) == -1) {
+            crinitErrPrint("Could not load last expirations of timers from '%s'.", stateFile);
+        }
+        free(stateFile);
+    }
 
     if ((errno = pthread_mutex_init(&crinitTimerPool.lock, NULL)) != 0) {
         crinitErrnoPrint("Could not initialize mutex for TimerDB.");
+        close(crinitTimerPool.eventFd);
+        crinitTimerPool.eventFd = -1;
         goto fail;
     }
     return 0;
 
 fail:
-    free(crinitTimerPool.pollList);
-    crinitTimerPool.pollList = NULL;
-failPollList:
-    free(crinitTimerPool.timerList);
-    crinitTimerPool.timerList = NULL;
-    crinitTimerPool.cap = 0;
-    crinitTimerPool.size = 0;
+    close(crinitTimerPool.after.fd);
+    crinitTimerPool.after.fd = -1;
+    crinitTimerHeapDestroy(&crinitTimerPool.after.heap);
+failAfter:
+    close(crinitTimerPool.respawn.fd);
+    crinitTimerPool.respawn.fd = -1;
+    crinitTimerHeapDestroy(&crinitTimerPool.respawn.heap);
+failRespawn:
+    close(crinitTimerPool.interval.fd);
+    crinitTimerPool.interval.fd = -1;
+    crinitTimerHeapDestroy(&crinitTimerPool.interval.heap);
+failInterval:
+    close(crinitTimerPool.calendar.fd);
+    crinitTimerPool.calendar.fd = -1;
+    crinitTimerHeapDestroy(&crinitTimerPool.calendar.heap);
+failCalendar:
+    crinitTimerIndexDestroy(&crinitTimerPool.index);
     return -1;
 }
 
 static void *crinitTimerDBRunPool(void *args) {
     CRINIT_PARAM_UNUSED(args);
+    struct pollfd pollList[CRINIT_TIMER_DB_POLL_FDS] = {
+        {.fd = crinitTimerPool.eventFd, .events = POLLIN},
+        {.fd = crinitTimerPool.calendar.fd, .events = POLLIN},
+        {.fd = crinitTimerPool.interval.fd, .events = POLLIN},
+        {.fd = crinitTimerPool.respawn.fd, .events = POLLIN},
+        {.fd = crinitTimerPool.after.fd, .events = POLLIN},
+    };
+    crinitTimerExpiredList_t expired = {0}, respawn = {0}, after = {0};
+    crinitTimerStore_t lastRuns = {0};
+
     while (1) {
-        int ready = poll(crinitTimerPool.pollList, crinitTimerPool.size, -1);
-        if (ready == -1) {
-            crinitErrnoPrint("polling failed.");
-            return NULL;
-        }
-        if ((errno = pthread_mutex_lock(&crinitTimerPool.lock)) != 0) {
-            crinitErrnoPrint("Could not queue up for mutex lock.");
-            return NULL;
-        }
+        // Drain whatever has woken us up, all fds are non-blocking.
         uint64_t u = 0;
-        if (crinitTimerPool.pollList[0].revents & POLLIN) {
-            if (read(crinitTimerPool.pollList[0].fd, &u, sizeof(uint64_t)) != sizeof(uint64_t)) {
-                crinitErrnoPrint("Couldn't read update events.");
+        bool timerExpired = false, clockSet = false;
+        for (size_t i = 0; i < CRINIT_TIMER_DB_POLL_FDS; i++) {
+            if (pollList[i].revents & (POLLERR | POLLNVAL)) {
+                crinitErrPrint("Couldn't poll timer or update events.");
+                continue;
+            }
+            if (!(pollList[i].revents & POLLIN)) {
+                continue;
+            }
+            if (read(pollList[i].fd, &u, sizeof(uint64_t)) == -1) {
+                if (errno == ECANCELED) {
+                    // Only the calendar timerfd is armed with TFD_TIMER_CANCEL_ON_SET.
+                    clockSet = true;
+                } else if (errno != EAGAIN) {
+                    crinitErrnoPrint("Couldn't read timer or update events.");
+                }
+            } else if (pollList[i].fd != crinitTimerPool.eventFd) {
+                timerExpired = true;
             }
-            pthread_mutex_unlock(&crinitTimerPool.lock);
-            continue;
-        } else if (crinitTimerPool.pollList[0].revents != 0) {
-            crinitErrnoPrint("Couldn't poll update events.");
         }
-        for (size_t i = 0; i < crinitTimerPool.size; i++) {
-            if (crinitTimerPool.pollList[i].revents == POLLIN) {
-                if (read(crinitTimerPool.pollList[i].fd, &u, sizeof(uint64_t)) != sizeof(uint64_t)) {
-                    crinitErrnoPrint("Couldn't read timer.");
+
+        // Collect all expired timers at once and pass them on in batches, the TaskDB must be called without our lock.
+        while (1) {
+            if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
+                crinitErrnoPrint("Could not queue up for mutex lock.");
+                return NULL;
+            }
+            if (timerExpired) {
+                crinitTimerPool.stats.wakeups++;
+                timerExpired = false;
+            }
+            if (clockSet) {
+                crinitInfoPrint("System time has been set, rescheduling calendar timers.");
+                struct timespec now, bootNow;
+                if (clock_gettime(CLOCK_REALTIME, &now) == -1 || clock_gettime(CLOCK_BOOTTIME, &bootNow) == -1) {
+                    crinitErrnoPrint("Could not get current time.");
+                } else {
+                    crinitTimerQueueReschedule(&crinitTimerPool.calendar, &now, &bootNow);
+                }
+                crinitTimerPool.stats.clockSets++;
+                clockSet = false;
+            }
+            // Calendar and interval timers both fulfill `@timer` dependencies and are passed on together.
+            crinitTimerQueueCollect(&crinitTimerPool.calendar, &expired);
+            crinitTimerQueueCollect(&crinitTimerPool.interval, &expired);
+            crinitTimerQueueCollect(&crinitTimerPool.respawn, &respawn);
+            crinitTimerQueueCollect(&crinitTimerPool.after, &after);
+            if (expired.size == 0 && respawn.size == 0 && after.size == 0) {
+                crinitTimerQueueArm(&crinitTimerPool.calendar, crinitTimerPool.slackMs);
+                crinitTimerQueueArm(&crinitTimerPool.interval, 0);
+                crinitTimerQueueArm(&crinitTimerPool.respawn, 0);
+                crinitTimerQueueArm(&crinitTimerPool.after, 0);
+                // The expirations of all batches are saved at once, the file is written after unlocking.
+                if (crinitTimerPool.lastRuns.dirty) {
+                    if (crinitTimerStoreCopy(&lastRuns, &crinitTimerPool.lastRuns) == 0) {
+                        crinitTimerPool.lastRuns.dirty = false;
+                    } else {
+                        crinitErrPrint("Could not copy last expirations of timers.");
+                    }
                 }
-                crinitTaskDep_t dep = {.name = "@timer", .event = crinitTimerPool.timerList[i].name};
-                crinitTaskDBFulfillDep(crinitTimerPool.taskDB, &dep, NULL);
-                struct timespec ts = crinitTimerPool.timerList[i].next.it_value;
-
-                crinitTimerPool.timerList[i].next.it_value =
-                    crinitTimerNextTime(&ts, &crinitTimerPool.timerList[i].def);
-
-                if (timerfd_settime(crinitTimerPool.pollList[i].fd, TFD_TIMER_ABSTIME,
-                                    &crinitTimerPool.timerList[i].next, NULL) == -1) {
-                    char buf[100];
-                    crinitSPrintTimerDef(buf, &crinitTimerPool.timerList->def);
-                    crinitErrnoPrint("Couldn't reset timer %s.", buf);
+                crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
+                break;
+            }
+            crinitTimerPool.stats.expirations += expired.size + after.size;
+            crinitTimerPool.stats.batches += (expired.size > 0);
+            crinitTimerPool.stats.respawns += respawn.size;
+            crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
+
+            if (expired.size > 0 &&
+                crinitTaskDBFulfillDeps(crinitTimerPool.taskDB, expired.deps, expired.size) == -1) {
+                crinitErrPrint("Could not fulfill dependencies of %zu expired timers.", expired.size);
+            }
+            for (size_t i = 0; i < respawn.size; i++) {
+                crinitTaskDBReleaseRespawn(crinitTimerPool.taskDB, respawn.deps[i].event);
+            }
+            // An after timer only ever fulfills the dependency of the task it has been armed for.
+            for (size_t i = 0; i < after.size; i++) {
+                const crinitTaskDep_t dep = {"@timer", after.deps[i].event};
+                if (crinitTaskDBRemoveDepFromTask(crinitTimerPool.taskDB, &dep, after.deps[i].name) == -1) {
+                    crinitErrPrint("Could not fulfill dependency '@timer:%s' of task '%s'.", after.deps[i].event,
+                                   after.deps[i].name);
                 }
-            } else if (crinitTimerPool.pollList[i].revents != 0) {
-                crinitErrnoPrint("Couldn't poll timer.");
             }
+            for (size_t i = 0; i < expired.size; i++) {
+                free(expired.deps[i].event);
+            }
+            for (size_t i = 0; i < respawn.size; i++) {
+                free(respawn.deps[i].event);
+            }
+            for (size_t i = 0; i < after.size; i++) {
+                free(after.deps[i].name);
+            }
+            expired.size = 0;
+            respawn.size = 0;
+            after.size = 0;
+        }
+
+        if (lastRuns.path != NULL) {
+            if (crinitTimerStoreSave(&lastRuns) == -1) {
+                crinitErrPrint("Could not save last expirations of timers.");
+                // Try again with the next expiration.
+                if (crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB) == 0) {
+                    crinitTimerPool.lastRuns.dirty = true;
+                    crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
+                }
+            }
+            crinitTimerStoreDestroy(&lastRuns);
+        }
+
+        if (poll(pollList, CRINIT_TIMER_DB_POLL_FDS, -1) == -1 && errno != EINTR) {
+            crinitErrnoPrint("polling failed.");
+            free(expired.deps);
+            free(respawn.deps);
+            free(after.deps);
+            return NULL;
         }
-        pthread_mutex_unlock(&crinitTimerPool.lock);
     }
     return NULL;
 }
 
 static void crinitPrintTimerPool(crinitTimerDB_t *pool) {
-    crinitInfoPrint("TimerPool: size=%ld  cap=%ld", pool->size, pool->cap);
-    for (size_t i = 1; i < pool->size; i++) {
+    const crinitTimerHeap_t *h = &pool->calendar.heap;
+    crinitInfoPrint("TimerPool: size=%zu  cap=%zu  interval=%zu  respawn=%zu  after=%zu", h->size, h->cap,
+                    pool->interval.heap.size, pool->respawn.heap.size, pool->after.heap.size);
+    for (size_t i = 0; i < h->size; i++) {
         char buff[100];
-        crinitSPrintTimerDef(buff, &pool->timerList[i].def);
-        crinitInfoPrint("timer[%lu]:", i);
+        crinitSPrintTimerDef(buff, &h->timers[i].def);
+        crinitInfoPrint("timer[%zu]:", i);
         crinitInfoPrint("    def=%s", buff);
 
         struct tm t = {0};
-        crinitZonedTimeR(&pool->timerList[i].next.it_value.tv_sec, pool->timerList[i].def.timezone, &t);
+        crinitZonedTimeR(&h->timers[i].next.it_value.tv_sec, h->timers[i].def.timezone, &t);
         strftime(buff, 100, "%F %H:%M:%S %z", &t);
-        crinitInfoPrint("    name='%s'  refs=%lu  next=%s", pool->timerList[i].name, pool->timerList[i].refs, buff);
+        crinitInfoPrint("    name='%s'  refs=%zu  next=%s", h->timers[i].name, h->timers[i].entry->refs, buff);
+    }
+    h = &pool->interval.heap;
+    for (size_t i = 0; i < h->size; i++) {
+        const crinitTimer_t *t = &h->timers[i];
+        crinitInfoPrint("interval timer[%zu]:", i);
+        crinitInfoPrint("    name='%s'  refs=%zu  next=%lld.%09lds after boot", t->name, t->entry->refs,
+                        (long long)t->next.it_value.tv_sec, t->next.it_value.tv_nsec);
     }
 }
 
 int crinitTimerDBSpawn(void) {
     int res = 0;
-    if ((errno = pthread_mutex_lock(&crinitTimerPool.lock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
     crinitPrintTimerPool(&crinitTimerPool);
-    if (errno = (pthread_mutex_unlock(&crinitTimerPool.lock)) != 0) {
+    if (errno = (crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
         crinitErrnoPrint("failed to unlock the timer pool.");
         return -1;
     }
@@ -168,109 +447,521 @@ int crinitTimerDBSpawn(void) {
 }
 
 static int crinitTimerDBInsertTimer(crinitTimer_t timer) {
-    int res = 0;
-    if ((errno = pthread_mutex_lock(&crinitTimerPool.lock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return -1;
     }
-    if (crinitTimerPool.size >= crinitTimerPool.cap) {
-        // TODO:  properly handle reallocating when list is full.
-        crinitErrPrint("TimerDB has no space left for additionall timer!!");
-        res = -1;
-        goto end;
-    }
+    int res = crinitTimerDBPushTimer(&timer);
+    crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
+    return res;
+}
 
-    int fd = timerfd_create(CLOCK_REALTIME, 0);
-    if (fd == -1) {
-        res = -1;
-        goto end;
+static int crinitTimerDBPushTimer(crinitTimer_t *timer) {
+    crinitTimerQueue_t *q = crinitTimerDBQueueOf(timer->type);
+    if (timer->type == CRINIT_TIMER_TYPE_CALENDAR) {
+        struct timespec now;
+        timespec_get(&now, TIME_UTC);
+        if (clock_gettime(CLOCK_BOOTTIME, &timer->lastBoot) == -1) {
+            crinitErrnoPrint("Could not get current time from boottime clock.");
+        }
+        if (crinitTimerDBCatchUp(timer, now.tv_sec)) {
+            crinitInfoPrint("Timer @timer:%s has missed an expiration, it will expire right away.", timer->name);
+            crinitTimerPool.stats.catchUps++;
+        }
     }
-    if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &timer.next, NULL) == -1) {
-        res = -1;
-        goto end;
+    if (crinitTimerHeapPush(&q->heap, timer) == -1) {
+        crinitErrPrint("Could not add timer '%s' to TimerDB.", timer->name);
+        return -1;
     }
-
-    crinitTimerPool.timerList[crinitTimerPool.size] = timer;
-    crinitTimerPool.pollList[crinitTimerPool.size].fd = fd;
-    crinitTimerPool.pollList[crinitTimerPool.size].events = POLLIN;
-    crinitTimerPool.size += 1;
-
-    uint64_t u = 1;
-    if (write(crinitTimerPool.pollList[0].fd, &u, sizeof(uint64_t)) != sizeof(uint64_t)) {
-        crinitErrPrint("failed to notify timerpool");
-        res = -1;
+    // Only a new first timer changes when the timer thread needs to wake up.
+    if (q->heap.timers[0].name == timer->name) {
+        crinitTimerDBNotify();
     }
-
-end:
-    pthread_mutex_unlock(&crinitTimerPool.lock);
-    return res;
+    return 0;
 }
 
 void crinitTimerDBRemoveTimer(char *timerStr) {
-    if ((errno = pthread_mutex_lock(&crinitTimerPool.lock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return;
     }
-    uint64_t u = 1;
-    for (size_t i = 1; i < crinitTimerPool.size; i++) {
-        if (0 == strcmp(crinitTimerPool.timerList[i].name, timerStr)) {
-            if (write(crinitTimerPool.pollList[0].fd, &u, sizeof(uint64_t)) != sizeof(uint64_t)) {
-                crinitErrPrint("failed to notify timerpool");
-            }
-            if (crinitTimerPool.timerList[i].refs > 0) {
-                crinitTimerPool.timerList[i].refs -= 1;
-            }
-            if (crinitTimerPool.timerList[i].refs == 0) {
-                if (i < crinitTimerPool.size - 1) {
-                    free(crinitTimerPool.timerList[i].name);
-                    crinitTimerPool.timerList[i] = crinitTimerPool.timerList[crinitTimerPool.size - 1];
-                    crinitTimerPool.pollList[i] = crinitTimerPool.pollList[crinitTimerPool.size - 1];
-                }
-                crinitTimerPool.size -= 1;
-            }
-        }
+    crinitTimerEntry_t *e = crinitTimerIndexUnref(&crinitTimerPool.index, timerStr);
+    if (e != NULL && e->refs == 0) {
+        crinitTimerDBDropEntry(e);
     }
-    pthread_mutex_unlock(&crinitTimerPool.lock);
+    crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
 }
 
 void crinitTimerDBAddTimer(char *timerStr) {
-    if ((errno = pthread_mutex_lock(&crinitTimerPool.lock)) != 0) {
+    if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
         crinitErrnoPrint("Could not queue up for mutex lock.");
         return;
     }
-    for (size_t i = 1; i < crinitTimerPool.size; i++) {
-        if (0 == strcmp(crinitTimerPool.timerList[i].name, timerStr)) {
-            uint64_t u = 1;
-            if (write(crinitTimerPool.pollList[0].fd, &u, sizeof(uint64_t)) != sizeof(uint64_t)) {
-                crinitErrPrint("failed to notify timerpool");
-            }
-            crinitTimerPool.timerList[i].refs += 1;
-            if (pthread_mutex_unlock(&crinitTimerPool.lock) != 0) {
-                crinitErrnoPrint("error unlocking mutex.");
-            }
-            return;
+    if (crinitTimerIndexRef(&crinitTimerPool.index, timerStr) != NULL) {
+        if (crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB) != 0) {
+            crinitErrnoPrint("error unlocking mutex.");
         }
+        return;
     }
-    if (pthread_mutex_unlock(&crinitTimerPool.lock) != 0) {
+    if (crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB) != 0) {
         crinitErrnoPrint("error unlocking mutex in add.");
     }
 
     crinitTimer_t timer = {0};
     timer.name = strdup(timerStr);
-    crinitTimerParse(timer.name, &(timer.def));
+    if (timer.name == NULL) {
+        crinitErrnoPrint("Could not allocate memory for Timer @timer:%s.", timerStr);
+        return;
+    }
+    if (!crinitTimerParse(timer.name, &(timer.def))) {
+        crinitErrPrint("Could not parse Timer @timer:%s, not adding it to TimerDB.", timerStr);
+        free(timer.name);
+        return;
+    }
 
-    struct timespec ti;
-    timespec_get(&ti, TIME_UTC);
+    if (timer.def.sinceArmed) {
+        crinitErrPrint("Timer @timer:%s is armed per task, not adding it to TimerDB.", timerStr);
+        free(timer.name);
+        return;
+    }
 
-    ti = crinitTimerNextTime(&ti, &(timer.def));
+    struct timespec ti;
+    if (timer.def.intervalNs > 0) {
+        timer.type = CRINIT_TIMER_TYPE_INTERVAL;
+        struct timespec now;
+        if (clock_gettime(CLOCK_BOOTTIME, &now) == -1) {
+            crinitErrnoPrint("Could not get current time from boottime clock.");
+            free(timer.name);
+            return;
+        }
+        // Aligned to multiples of the period since boot.
+        const struct timespec since = {0};
+        ti = crinitTimerNextInterval(&since, &now, timer.def.intervalNs);
+    } else {
+        crinitTimerCompile(&timer.def, &timer.compiled);
+        timespec_get(&ti, TIME_UTC);
+        // Calendar timers have a resolution of one second, so let them expire at the full second together.
+        ti.tv_nsec = 0;
+        ti = crinitTimerNextTimeCompiled(&ti, &timer.compiled);
+    }
+    if (ti.tv_sec == 0 && ti.tv_nsec == 0) {
+        crinitErrPrint("Timer @timer:%s will never expire, not adding it to TimerDB.", timerStr);
+        free(timer.name);
+        return;
+    }
     timer.refs = 1;
     timer.next.it_value = ti;
     timer.next.it_interval.tv_sec = 0;
     timer.next.it_interval.tv_nsec = 0;
 
-    if (crinitTimerDBInsertTimer(timer) == -1) {
+    if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        free(timer.name);
+        return;
+    }
+    // The timer may have been added meanwhile, under this or another spelling of the same definition.
+    bool created = false;
+    timer.entry = crinitTimerIndexRefDef(&crinitTimerPool.index, timerStr, &timer.def, &created);
+    if (timer.entry == NULL) {
+        crinitErrPrint("Failed to insert Timer @timer:%s into TimerDB", timerStr);
+        free(timer.name);
+    } else if (!created) {
+        crinitDbgInfoPrint("Timer @timer:%s shares an existing timer in TimerDB", timerStr);
+        free(timer.name);
+    } else if (crinitTimerDBPushTimer(&timer) == -1) {
         crinitErrPrint("Failed to insert Timer @timer:%s into TimerDB", timerStr);
+        crinitTimerIndexRemove(&crinitTimerPool.index, timer.entry);
+        free(timer.name);
     } else {
         crinitDbgInfoPrint("Successfully inserted Timer @timer:%s into TimerDB", timerStr);
     }
+    crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
+}
+
+int crinitTimerDBAddRespawnTimer(const char *taskName, uint32_t delayMs) {
+    crinitNullCheck(-1, taskName);
+
+    crinitTimer_t timer = {0};
+    timer.type = CRINIT_TIMER_TYPE_RESPAWN;
+    timer.refs = 1;
+    if (clock_gettime(CLOCK_MONOTONIC, &timer.next.it_value) == -1) {
+        crinitErrnoPrint("Could not get current time from monotonic clock.");
+        return -1;
+    }
+    timer.next.it_value.tv_sec += delayMs / 1000;
+    timer.next.it_value.tv_nsec += (long)(delayMs % 1000) * 1000000L;
+    if (timer.next.it_value.tv_nsec >= 1000000000L) {
+        timer.next.it_value.tv_sec++;
+        timer.next.it_value.tv_nsec -= 1000000000L;
+    }
+    timer.name = strdup(taskName);
+    if (timer.name == NULL) {
+        crinitErrnoPrint("Could not allocate memory for respawn timer of task '%s'.", taskName);
+        return -1;
+    }
+
+    if (crinitTimerDBInsertTimer(timer) == -1) {
+        crinitErrPrint("Failed to insert respawn timer for task '%s' into TimerDB", taskName);
+        free(timer.name);
+        return -1;
+    }
+    crinitDbgInfoPrint("Task '%s' will be respawned in %" PRIu32 "ms.", taskName, delayMs);
+    return 0;
+}
+
+bool crinitTimerDBIsTaskTimer(const char *timerStr) {
+    return timerStr != NULL && strncmp(timerStr, "after:", strlen("after:")) == 0;
+}
+
+int crinitTimerDBArmTaskTimer(const char *taskName, const char *timerStr) {
+    crinitNullCheck(-1, taskName, timerStr);
+
+    crinitTimer_t timer = {0};
+    timer.type = CRINIT_TIMER_TYPE_AFTER;
+    timer.refs = 1;
+    // The task name and the spelling share one allocation, see CRINIT_TIMER_TYPE_AFTER.
+    size_t taskLen = strlen(taskName) + 1;
+    timer.name = malloc(taskLen + strlen(timerStr) + 1);
+    if (timer.name == NULL) {
+        crinitErrnoPrint("Could not allocate memory for Timer @timer:%s of task '%s'.", timerStr, taskName);
+        return -1;
+    }
+    memcpy(timer.name, taskName, taskLen);
+    char *spelling = timer.name + taskLen;
+    strcpy(spelling, timerStr);
+    if (!crinitTimerParse(spelling, &timer.def)) {
+        crinitErrPrint("Could not parse Timer @timer:%s of task '%s', not arming it.", timerStr, taskName);
+        free(timer.name);
+        return -1;
+    }
+    if (!timer.def.sinceArmed) {
+        crinitErrPrint("Timer @timer:%s of task '%s' is not armed per task.", timerStr, taskName);
+        free(timer.name);
+        return -1;
+    }
+    struct timespec now;
+    if (clock_gettime(CLOCK_BOOTTIME, &now) == -1) {
+        crinitErrnoPrint("Could not get current time from boottime clock.");
+        free(timer.name);
+        return -1;
+    }
+    timer.next.it_value = crinitTimerNextInterval(&now, &now, timer.def.intervalNs);
+
+    if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        free(timer.name);
+        return -1;
+    }
+    int res = 0;
+    crinitTimerQueue_t *q = &crinitTimerPool.after;
+    size_t i = crinitTimerDBFindTaskTimer(taskName, timerStr);
+    if (i != CRINIT_TIMER_HEAP_NOT_FOUND) {
+        // Re-armed before it has expired, the period counts from now.
+        q->heap.timers[i].next = timer.next;
+        crinitTimerHeapUpdate(&q->heap, i);
+        crinitTimerDBNotify();
+        free(timer.name);
+    } else if (crinitTimerDBPushTimer(&timer) == -1) {
+        crinitErrPrint("Failed to arm Timer @timer:%s of task '%s'.", timerStr, taskName);
+        free(timer.name);
+        res = -1;
+    }
+    crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
+    if (res == 0) {
+        crinitDbgInfoPrint("Armed Timer @timer:%s of task '%s'.", timerStr, taskName);
+    }
+    return res;
+}
+
+void crinitTimerDBDisarmTaskTimer(const char *taskName, const char *timerStr) {
+    if (taskName == NULL || timerStr == NULL) {
+        return;
+    }
+    if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return;
+    }
+    size_t i = crinitTimerDBFindTaskTimer(taskName, timerStr);
+    crinitTimer_t removed;
+    if (i != CRINIT_TIMER_HEAP_NOT_FOUND && crinitTimerHeapRemove(&crinitTimerPool.after.heap, i, &removed) == 0) {
+        free(removed.name);
+        // Only a removed first timer changes when the timer thread needs to wake up.
+        if (i == 0) {
+            crinitTimerDBNotify();
+        }
+    }
+    crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
+}
+
+static int crinitTimerQueueInit(crinitTimerQueue_t *q, clockid_t clock) {
+    if (crinitTimerHeapInit(&q->heap, TIMER_DB_INITIAL_CAP) == -1) {
+        return -1;
+    }
+    q->clock = clock;
+    q->fd = timerfd_create(clock, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (q->fd == -1) {
+        crinitErrnoPrint("Could not create timerfd.");
+        crinitTimerHeapDestroy(&q->heap);
+        return -1;
+    }
+    return 0;
+}
+
+static int crinitTimerQueueExpire(crinitTimerQueue_t *q, crinitTimerExpiredList_t *list) {
+    if (q->heap.size == 0) {
+        return 0;
+    }
+    struct timespec now;
+    if (clock_gettime(q->clock, &now) == -1) {
+        crinitErrnoPrint("Could not get current time.");
+        return -1;
+    }
+    crinitTimer_t *first = &q->heap.timers[0];
+    const struct timespec *due = &first->next.it_value;
+    if (due->tv_sec > now.tv_sec || (due->tv_sec == now.tv_sec && due->tv_nsec > now.tv_nsec)) {
+        return 0;
+    }
+    crinitProbe2(timer_fire, first->name, (int)first->type);
+
+    if (first->type == CRINIT_TIMER_TYPE_RESPAWN || first->type == CRINIT_TIMER_TYPE_AFTER) {
+        crinitTimer_t removed;
+        // Make room first, so an expired timer is never lost.
+        if (crinitTimerExpiredListReserve(list, 1) == -1 || crinitTimerHeapRemove(&q->heap, 0, &removed) == -1) {
+            return -1;
+        }
+        if (removed.type == CRINIT_TIMER_TYPE_AFTER) {
+            list->deps[list->size].name = removed.name;
+            list->deps[list->size].event = removed.name + strlen(removed.name) + 1;
+        } else {
+            list->deps[list->size].name = "@timer";
+            list->deps[list->size].event = removed.name;
+        }
+        list->size++;
+        return 1;
+    }
+
+    // Fulfill the dependencies of every spelling of the timer.
+    size_t aliases = 0;
+    for (const crinitTimerAlias_t *a = first->entry->aliases; a != NULL; a = a->nextOfEntry) {
+        aliases++;
+    }
+    if (crinitTimerExpiredListReserve(list, aliases) == -1) {
+        return -1;
+    }
+    for (const crinitTimerAlias_t *a = first->entry->aliases; a != NULL; a = a->nextOfEntry) {
+        char *name = strdup(a->name);
+        if (name == NULL) {
+            crinitErrnoPrint("Could not allocate memory for name of expired timer '%s'.", a->name);
+            continue;
+        }
+        list->deps[list->size].name = "@timer";
+        list->deps[list->size].event = name;
+        list->size++;
+    }
+    struct timespec ts = first->next.it_value;
+    if (first->type == CRINIT_TIMER_TYPE_INTERVAL) {
+        // Just count on by whole periods, skipping the ones which have already passed.
+        first->next.it_value = crinitTimerNextInterval(&ts, &now, first->def.intervalNs);
+        crinitTimerHeapUpdate(&q->heap, 0);
+        return 1;
+    }
+    if (crinitTimerPool.lastRuns.path != NULL &&
+        crinitTimerStoreSet(&crinitTimerPool.lastRuns, first->name, ts.tv_sec) == -1) {
+        crinitErrPrint("Could not remember expiration of timer '%s'.", first->name);
+    }
+    first->catchUpPending = false;
+    if (clock_gettime(CLOCK_BOOTTIME, &first->lastBoot) == -1) {
+        crinitErrnoPrint("Could not get current time from boottime clock.");
+    }
+    first->next.it_value = crinitTimerNextTimeCompiled(&ts, &first->compiled);
+    // Never go back in time, e.g. after the system time has been set forward. Missed expirations are coalesced.
+    if (first->next.it_value.tv_sec <= now.tv_sec) {
+        first->next.it_value = crinitTimerNextTimeCompiled(&now, &first->compiled);
+    }
+    if (first->next.it_value.tv_sec <= now.tv_sec) {
+        crinitErrPrint("Timer '%s' will not expire again, removing it.", first->name);
+        crinitTimerDBDropEntry(first->entry);
+        return 1;
+    }
+    crinitTimerHeapUpdate(&q->heap, 0);
+    return 1;
+}
+
+static void crinitTimerQueueCollect(crinitTimerQueue_t *q, crinitTimerExpiredList_t *list) {
+    while (crinitTimerQueueExpire(q, list) == 1) {
+    }
+}
+
+static int crinitTimerExpiredListReserve(crinitTimerExpiredList_t *list, size_t n) {
+    if (list->size + n <= list->cap) {
+        return 0;
+    }
+    size_t newCap = (list->cap > 0) ? list->cap : TIMER_DB_INITIAL_CAP;
+    while (newCap < list->size + n) {
+        newCap *= 2;
+    }
+    crinitTaskDep_t *newDeps = realloc(list->deps, newCap * sizeof(*newDeps));
+    if (newDeps == NULL) {
+        crinitErrnoPrint("Could not allocate memory for %zu expired timers.", newCap);
+        return -1;
+    }
+    list->deps = newDeps;
+    list->cap = newCap;
+    return 0;
+}
+
+static int crinitTimerQueueArm(crinitTimerQueue_t *q, unsigned long long slackMs) {
+    // A zero it_value disarms the timer.
+    struct itimerspec next = {0};
+    if (q->heap.size > 0) {
+        next.it_value = q->heap.timers[0].next.it_value;
+        if (slackMs > 0) {
+            // Round up to the slack so timers expiring close to each other are handled together.
+            long long slackNs = (long long)slackMs * CRINIT_TIMER_DB_NS_PER_MS;
+            long long dueNs = (long long)next.it_value.tv_sec * CRINIT_TIMER_DB_NS_PER_SEC + next.it_value.tv_nsec;
+            dueNs = (dueNs + slackNs - 1) / slackNs * slackNs;
+            next.it_value.tv_sec = (time_t)(dueNs / CRINIT_TIMER_DB_NS_PER_SEC);
+            next.it_value.tv_nsec = (long)(dueNs % CRINIT_TIMER_DB_NS_PER_SEC);
+        }
+        if (next.it_value.tv_sec == 0 && next.it_value.tv_nsec == 0) {
+            next.it_value.tv_nsec = 1;
+        }
+    }
+    // Wall-clock timers also wake up the timer thread if the system time is set, see crinitTimerQueueReschedule().
+    int flags = (q->clock == CLOCK_REALTIME) ? TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET : TFD_TIMER_ABSTIME;
+    if (timerfd_settime(q->fd, flags, &next, NULL) == -1) {
+        // The heap may be empty here, so name the queue rather than its first timer.
+        const char *queue = "respawn";
+        if (q == &crinitTimerPool.calendar) {
+            queue = "calendar";
+        } else if (q == &crinitTimerPool.interval) {
+            queue = "interval";
+        } else if (q == &crinitTimerPool.after) {
+            queue = "after";
+        }
+        crinitErrnoPrint("Couldn't arm timerfd of %s timer queue.", queue);
+        return -1;
+    }
+    return 0;
+}
+
+static void crinitTimerDBNotify(void) {
+    uint64_t u = 1;
+    if (write(crinitTimerPool.eventFd, &u, sizeof(uint64_t)) != sizeof(uint64_t)) {
+        crinitErrPrint("failed to notify timerpool");
+    }
+}
+
+static bool crinitTimerDBCatchUp(crinitTimer_t *t, time_t now) {
+    time_t lastRun = crinitTimerStoreGet(&crinitTimerPool.lastRuns, t->name);
+    t->catchUpPending = lastRun > now;
+    if (lastRun <= 0 || lastRun >= now) {
+        return false;
+    }
+    struct timespec last = {.tv_sec = lastRun, .tv_nsec = 0};
+    struct timespec missed = crinitTimerNextTimeCompiled(&last, &t->compiled);
+    if (missed.tv_sec == 0 || missed.tv_sec > now) {
+        return false;
+    }
+    t->next.it_value.tv_sec = now;
+    t->next.it_value.tv_nsec = 0;
+    return true;
+}
+
+void crinitTimerDBClockSet(const struct timespec *now, const struct timespec *bootNow) {
+    if (now == NULL || bootNow == NULL) {
+        return;
+    }
+    if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return;
+    }
+    crinitTimerQueueReschedule(&crinitTimerPool.calendar, now, bootNow);
+    crinitTimerPool.stats.clockSets++;
+    crinitTimerDBNotify();
+    crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
+}
+
+static void crinitTimerQueueReschedule(crinitTimerQueue_t *q, const struct timespec *now,
+                                       const struct timespec *bootNow) {
+    const struct timespec from = {.tv_sec = now->tv_sec, .tv_nsec = 0};
+    for (size_t i = 0; i < q->heap.size; i++) {
+        crinitTimer_t *t = &q->heap.timers[i];
+        bool missed = false;
+        if (t->catchUpPending) {
+            // The time was before the last expiration in the store when the timer was added, so check it now.
+            missed = crinitTimerDBCatchUp(t, from.tv_sec);
+        } else {
+            // An expiration is only missed if it has really passed since the timer last expired or has been added,
+            // not if it has merely been skipped over by setting the time forward.
+            struct timespec since = {.tv_sec = from.tv_sec - (bootNow->tv_sec - t->lastBoot.tv_sec), .tv_nsec = 0};
+            struct timespec due = crinitTimerNextTimeCompiled(&since, &t->compiled);
+            missed = due.tv_sec != 0 && due.tv_sec <= from.tv_sec;
+            if (missed) {
+                t->next.it_value = from;
+            }
+        }
+        if (missed) {
+            // Expire once together with all others, regardless of how many expirations have been missed.
+            crinitTimerPool.stats.catchUps++;
+            continue;
+        }
+        // Possibly earlier than before if the time has been set back.
+        struct timespec next = crinitTimerNextTimeCompiled(&from, &t->compiled);
+        if (next.tv_sec != 0) {
+            t->next.it_value = next;
+        }
+    }
+    crinitTimerHeapRebuild(&q->heap);
+}
+
+static crinitTimerQueue_t *crinitTimerDBQueueOf(crinitTimerType_t type) {
+    switch (type) {
+        case CRINIT_TIMER_TYPE_INTERVAL:
+            return &crinitTimerPool.interval;
+        case CRINIT_TIMER_TYPE_RESPAWN:
+            return &crinitTimerPool.respawn;
+        case CRINIT_TIMER_TYPE_AFTER:
+            return &crinitTimerPool.after;
+        case CRINIT_TIMER_TYPE_CALENDAR:
+        default:
+            return &crinitTimerPool.calendar;
+    }
+}
+
+static void crinitTimerDBDropEntry(crinitTimerEntry_t *e) {
+    crinitTimerQueue_t *q =
+        crinitTimerDBQueueOf((e->def.intervalNs > 0) ? CRINIT_TIMER_TYPE_INTERVAL : CRINIT_TIMER_TYPE_CALENDAR);
+    size_t i = e->heapIdx;
+    crinitTimer_t removed;
+    if (i != CRINIT_TIMER_INDEX_NO_HEAP && crinitTimerHeapRemove(&q->heap, i, &removed) == 0) {
+        free(removed.name);
+        // Only a removed first timer changes when the timer thread needs to wake up.
+        if (i == 0) {
+            crinitTimerDBNotify();
+        }
+    }
+    crinitTimerIndexRemove(&crinitTimerPool.index, e);
+}
+
+static size_t crinitTimerDBFindTaskTimer(const char *taskName, const char *timerStr) {
+    const crinitTimerHeap_t *h = &crinitTimerPool.after.heap;
+    for (size_t i = 0; i < h->size; i++) {
+        const char *name = h->timers[i].name;
+        if (strcmp(name, taskName) == 0 && strcmp(name + strlen(name) + 1, timerStr) == 0) {
+            return i;
+        }
+    }
+    return CRINIT_TIMER_HEAP_NOT_FOUND;
+}
+
+int crinitTimerDBGetStats(crinitTimerDBStats_t *stats) {
+    crinitNullCheck(-1, stats);
+    if ((errno = crinitMutexLock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB)) != 0) {
+        crinitErrnoPrint("Could not queue up for mutex lock.");
+        return -1;
+    }
+    *stats = crinitTimerPool.stats;
+    crinitMutexUnlock(&crinitTimerPool.lock, CRINIT_LOCK_TIMERDB);
+    return 0;
 }
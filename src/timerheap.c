@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file timerheap.c
+ * @brief Implementation of a priority queue of timers ordered by their next expiration.
+ */
+#include "timerheap.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "logio.h"
+#include "timerindex.h"
+
+/**
+ * Check if a timer expires before another.
+ *
+ * @return  true if \a a expires before \a b, false otherwise
+ */
+static inline bool crinitTimerHeapLess(const crinitTimer_t *a, const crinitTimer_t *b);
+/**
+ * Put a timer at a position of the heap and keep crinitTimerEntry_t::heapIdx of its index entry up to date.
+ *
+ * @param h    The heap.
+ * @param idx  The position.
+ * @param t    The timer.
+ */
+static inline void crinitTimerHeapPlace(crinitTimerHeap_t *h, size_t idx, const crinitTimer_t *t);
+/**
+ * Move a timer towards the top of the heap until the heap order is restored.
+ *
+ * @param h    The heap.
+ * @param idx  Index of the timer to move.
+ *
+ * @return the new index of the timer
+ */
+static size_t crinitTimerHeapSiftUp(crinitTimerHeap_t *h, size_t idx);
+/**
+ * Move a timer towards the bottom of the heap until the heap order is restored.
+ *
+ * @param h    The heap.
+ * @param idx  Index of the timer to move.
+ */
+static void crinitTimerHeapSiftDown(crinitTimerHeap_t *h, size_t idx);
+
+int crinitTimerHeapInit(crinitTimerHeap_t *h, size_t initialCap) {
+    crinitNullCheck(-1, h);
+    h->size = 0;
+    h->cap = (initialCap > 0) ? initialCap : 1;
+    h->timers = malloc(h->cap * sizeof(*h->timers));
+    if (h->timers == NULL) {
+        crinitErrnoPrint("Could not allocate memory for %zu timers.", h->cap);
+        h->cap = 0;
+        return -1;
+    }
+    return 0;
+}
+
+void crinitTimerHeapDestroy(crinitTimerHeap_t *h) {
+    if (h == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < h->size; i++) {
+        free(h->timers[i].name);
+    }
+    free(h->timers);
+    h->timers = NULL;
+    h->size = 0;
+    h->cap = 0;
+}
+
+int crinitTimerHeapPush(crinitTimerHeap_t *h, const crinitTimer_t *t) {
+    crinitNullCheck(-1, h, t);
+    if (h->size == h->cap) {
+        size_t newCap = (h->cap > 0) ? h->cap * 2 : 1;
+        crinitTimer_t *newTimers = realloc(h->timers, newCap * sizeof(*newTimers));
+        if (newTimers == NULL) {
+            crinitErrnoPrint("Could not grow timer heap to %zu timers.", newCap);
+            return -1;
+        }
+        h->timers = newTimers;
+        h->cap = newCap;
+    }
+    h->timers[h->size] = *t;
+    h->size++;
+    crinitTimerHeapSiftUp(h, h->size - 1);
+    return 0;
+}
+
+int crinitTimerHeapRemove(crinitTimerHeap_t *h, size_t idx, crinitTimer_t *out) {
+    crinitNullCheck(-1, h, out);
+    if (idx >= h->size) {
+        crinitErrPrint("Timer index %zu is out of range.", idx);
+        return -1;
+    }
+    *out = h->timers[idx];
+    if (out->entry != NULL) {
+        out->entry->heapIdx = CRINIT_TIMER_INDEX_NO_HEAP;
+    }
+    h->size--;
+    if (idx < h->size) {
+        h->timers[idx] = h->timers[h->size];
+        crinitTimerHeapUpdate(h, idx);
+    }
+    return 0;
+}
+
+void crinitTimerHeapUpdate(crinitTimerHeap_t *h, size_t idx) {
+    if (h == NULL || idx >= h->size) {
+        return;
+    }
+    if (crinitTimerHeapSiftUp(h, idx) == idx) {
+        crinitTimerHeapSiftDown(h, idx);
+    }
+}
+
+void crinitTimerHeapRebuild(crinitTimerHeap_t *h) {
+    if (h == NULL) {
+        return;
+    }
+    // Sift down all inner nodes bottom-up, the leaves are trivially valid heaps.
+    for (size_t i = h->size / 2; i > 0; i--) {
+        crinitTimerHeapSiftDown(h, i - 1);
+    }
+}
+
+size_t crinitTimerHeapFind(const crinitTimerHeap_t *h, const char *name) {
+    if (h == NULL || name == NULL) {
+        return CRINIT_TIMER_HEAP_NOT_FOUND;
+    }
+    for (size_t i = 0; i < h->size; i++) {
+        if (strcmp(h->timers[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return CRINIT_TIMER_HEAP_NOT_FOUND;
+}
+
+static inline bool crinitTimerHeapLess(const crinitTimer_t *a, const crinitTimer_t *b) {
+    const struct timespec *ta = &a->next.it_value, *tb = &b->next.it_value;
+    return ta->tv_sec < tb->tv_sec || (ta->tv_sec == tb->tv_sec && ta->tv_nsec < tb->tv_nsec);
+}
+
+static inline void crinitTimerHeapPlace(crinitTimerHeap_t *h, size_t idx, const crinitTimer_t *t) {
+    h->timers[idx] = *t;
+    if (t->entry != NULL) {
+        t->entry->heapIdx = idx;
+    }
+}
+
+static size_t crinitTimerHeapSiftUp(crinitTimerHeap_t *h, size_t idx) {
+    crinitTimer_t t = h->timers[idx];
+    while (idx > 0) {
+        size_t parent = (idx - 1) / 2;
+        if (!crinitTimerHeapLess(&t, &h->timers[parent])) {
+            break;
+        }
+        crinitTimerHeapPlace(h, idx, &h->timers[parent]);
+        idx = parent;
+    }
+    crinitTimerHeapPlace(h, idx, &t);
+    return idx;
+}
+
+static void crinitTimerHeapSiftDown(crinitTimerHeap_t *h, size_t idx) {
+    crinitTimer_t t = h->timers[idx];
+    while (true) {
+        size_t child = 2 * idx + 1;
+        if (child >= h->size) {
+            break;
+        }
+        if (child + 1 < h->size && crinitTimerHeapLess(&h->timers[child + 1], &h->timers[child])) {
+            child++;
+        }
+        if (!crinitTimerHeapLess(&h->timers[child], &t)) {
+            break;
+        }
+        crinitTimerHeapPlace(h, idx, &h->timers[child]);
+        idx = child;
+    }
+    crinitTimerHeapPlace(h, idx, &t);
+}
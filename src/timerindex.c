@@ -0,0 +1,362 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file timerindex.c
+ * @brief Implementation of the hash index of the timers fulfilling `@timer` dependencies.
+ */
+#include "timerindex.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "logio.h"
+
+/** Offset basis of the 64-bit FNV-1a hash. **/
+#define CRINIT_TIMER_INDEX_FNV_OFFSET UINT64_C(14695981039346656037)
+/** Prime of the 64-bit FNV-1a hash. **/
+#define CRINIT_TIMER_INDEX_FNV_PRIME UINT64_C(1099511628211)
+
+/**
+ * Continue a FNV-1a hash over a number of bytes.
+ *
+ * @param h    The hash so far, #CRINIT_TIMER_INDEX_FNV_OFFSET to start a new one.
+ * @param buf  The bytes to hash.
+ * @param len  The number of bytes in \a buf.
+ *
+ * @return the updated hash
+ */
+static uint64_t crinitTimerIndexHashBytes(uint64_t h, const void *buf, size_t len);
+/**
+ * Hash a spelling of a timer.
+ */
+static uint64_t crinitTimerIndexHashName(const char *name);
+/**
+ * Hash a parsed timer definition.
+ *
+ * Hashes field by field as the padding of crinitTimerDef_t is undefined.
+ */
+static uint64_t crinitTimerIndexHashDef(const crinitTimerDef_t *def);
+/**
+ * Check if two parsed timer definitions are the same.
+ */
+static bool crinitTimerIndexDefEqual(const crinitTimerDef_t *a, const crinitTimerDef_t *b);
+/**
+ * Find an alias by its spelling.
+ *
+ * @param idx   The index.
+ * @param name  The spelling.
+ * @param prev  Return pointer for the link pointing to the alias, may be NULL.
+ *
+ * @return the alias if found, NULL otherwise
+ */
+static crinitTimerAlias_t *crinitTimerIndexFindName(const crinitTimerIndex_t *idx, const char *name,
+                                                    crinitTimerAlias_t ***prev);
+/**
+ * Find an entry by its parsed timer definition.
+ *
+ * @param idx  The index.
+ * @param def  The timer definition.
+ *
+ * @return the entry if found, NULL otherwise
+ */
+static crinitTimerEntry_t *crinitTimerIndexFindDef(const crinitTimerIndex_t *idx, const crinitTimerDef_t *def);
+/**
+ * Double the number of buckets of both tables if they are more than fully loaded.
+ *
+ * Failing to grow is not an error, the index just gets slower.
+ *
+ * @param idx  The index.
+ */
+static void crinitTimerIndexGrow(crinitTimerIndex_t *idx);
+/**
+ * Unlink an alias from the name table and from its entry and free it.
+ *
+ * @param idx    The index.
+ * @param alias  The alias to remove.
+ */
+static void crinitTimerIndexRemoveAlias(crinitTimerIndex_t *idx, crinitTimerAlias_t *alias);
+
+int crinitTimerIndexInit(crinitTimerIndex_t *idx, size_t initialBuckets) {
+    crinitNullCheck(-1, idx);
+    // Bucket counts are kept at powers of two, so a hash can be masked instead of divided.
+    size_t buckets = 1;
+    while (buckets < initialBuckets) {
+        buckets *= 2;
+    }
+    idx->names = calloc(buckets, sizeof(*idx->names));
+    idx->entries = calloc(buckets, sizeof(*idx->entries));
+    if (idx->names == NULL || idx->entries == NULL) {
+        crinitErrnoPrint("Could not allocate memory for timer index with %zu buckets.", buckets);
+        free(idx->names);
+        free(idx->entries);
+        idx->names = NULL;
+        idx->entries = NULL;
+        return -1;
+    }
+    idx->nameBuckets = buckets;
+    idx->entryBuckets = buckets;
+    idx->nameCount = 0;
+    idx->entryCount = 0;
+    return 0;
+}
+
+void crinitTimerIndexDestroy(crinitTimerIndex_t *idx) {
+    if (idx == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < idx->nameBuckets; i++) {
+        crinitTimerAlias_t *a = idx->names[i];
+        while (a != NULL) {
+            crinitTimerAlias_t *next = a->next;
+            free(a->name);
+            free(a);
+            a = next;
+        }
+    }
+    for (size_t i = 0; i < idx->entryBuckets; i++) {
+        crinitTimerEntry_t *e = idx->entries[i];
+        while (e != NULL) {
+            crinitTimerEntry_t *next = e->next;
+            free(e);
+            e = next;
+        }
+    }
+    free(idx->names);
+    free(idx->entries);
+    idx->names = NULL;
+    idx->entries = NULL;
+    idx->nameBuckets = 0;
+    idx->entryBuckets = 0;
+    idx->nameCount = 0;
+    idx->entryCount = 0;
+}
+
+crinitTimerEntry_t *crinitTimerIndexRef(crinitTimerIndex_t *idx, const char *name) {
+    if (idx == NULL || name == NULL || idx->nameBuckets == 0) {
+        return NULL;
+    }
+    crinitTimerAlias_t *a = crinitTimerIndexFindName(idx, name, NULL);
+    if (a == NULL) {
+        return NULL;
+    }
+    a->refs++;
+    a->entry->refs++;
+    return a->entry;
+}
+
+crinitTimerEntry_t *crinitTimerIndexRefDef(crinitTimerIndex_t *idx, const char *name, const crinitTimerDef_t *def,
+                                           bool *created) {
+    crinitNullCheck(NULL, idx, name, def, created);
+    if (idx->nameBuckets == 0) {
+        crinitErrPrint("Timer index has not been initialized.");
+        return NULL;
+    }
+    *created = false;
+    // Someone else may have added the same spelling in the meantime.
+    crinitTimerEntry_t *e = crinitTimerIndexRef(idx, name);
+    if (e != NULL) {
+        return e;
+    }
+
+    crinitTimerAlias_t *a = calloc(1, sizeof(*a));
+    if (a == NULL) {
+        crinitErrnoPrint("Could not allocate memory for timer '%s'.", name);
+        return NULL;
+    }
+    a->name = strdup(name);
+    if (a->name == NULL) {
+        crinitErrnoPrint("Could not allocate memory for name of timer '%s'.", name);
+        free(a);
+        return NULL;
+    }
+
+    e = crinitTimerIndexFindDef(idx, def);
+    if (e == NULL) {
+        e = calloc(1, sizeof(*e));
+        if (e == NULL) {
+            crinitErrnoPrint("Could not allocate memory for timer '%s'.", name);
+            free(a->name);
+            free(a);
+            return NULL;
+        }
+        e->def = *def;
+        e->heapIdx = CRINIT_TIMER_INDEX_NO_HEAP;
+        size_t b = crinitTimerIndexHashDef(def) & (idx->entryBuckets - 1);
+        e->next = idx->entries[b];
+        idx->entries[b] = e;
+        idx->entryCount++;
+        *created = true;
+    }
+
+    a->refs = 1;
+    a->entry = e;
+    a->nextOfEntry = e->aliases;
+    e->aliases = a;
+    e->refs++;
+    size_t b = crinitTimerIndexHashName(name) & (idx->nameBuckets - 1);
+    a->next = idx->names[b];
+    idx->names[b] = a;
+    idx->nameCount++;
+
+    crinitTimerIndexGrow(idx);
+    return e;
+}
+
+crinitTimerEntry_t *crinitTimerIndexUnref(crinitTimerIndex_t *idx, const char *name) {
+    if (idx == NULL || name == NULL || idx->nameBuckets == 0) {
+        return NULL;
+    }
+    crinitTimerAlias_t *a = crinitTimerIndexFindName(idx, name, NULL);
+    if (a == NULL) {
+        return NULL;
+    }
+    crinitTimerEntry_t *e = a->entry;
+    if (a->refs > 0) {
+        a->refs--;
+        e->refs--;
+    }
+    if (a->refs == 0) {
+        crinitTimerIndexRemoveAlias(idx, a);
+    }
+    return e;
+}
+
+void crinitTimerIndexRemove(crinitTimerIndex_t *idx, crinitTimerEntry_t *entry) {
+    if (idx == NULL || entry == NULL || idx->entryBuckets == 0) {
+        return;
+    }
+    while (entry->aliases != NULL) {
+        crinitTimerIndexRemoveAlias(idx, entry->aliases);
+    }
+    size_t b = crinitTimerIndexHashDef(&entry->def) & (idx->entryBuckets - 1);
+    for (crinitTimerEntry_t **link = &idx->entries[b]; *link != NULL; link = &(*link)->next) {
+        if (*link == entry) {
+            *link = entry->next;
+            idx->entryCount--;
+            break;
+        }
+    }
+    free(entry);
+}
+
+static uint64_t crinitTimerIndexHashBytes(uint64_t h, const void *buf, size_t len) {
+    const unsigned char *p = buf;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= CRINIT_TIMER_INDEX_FNV_PRIME;
+    }
+    return h;
+}
+
+static uint64_t crinitTimerIndexHashName(const char *name) {
+    return crinitTimerIndexHashBytes(CRINIT_TIMER_INDEX_FNV_OFFSET, name, strlen(name));
+}
+
+static uint64_t crinitTimerIndexHashDef(const crinitTimerDef_t *def) {
+    uint64_t h = CRINIT_TIMER_INDEX_FNV_OFFSET;
+    h = crinitTimerIndexHashBytes(h, &def->wDay, sizeof(def->wDay));
+    h = crinitTimerIndexHashBytes(h, def->years, sizeof(def->years));
+    h = crinitTimerIndexHashBytes(h, def->month, sizeof(def->month));
+    h = crinitTimerIndexHashBytes(h, def->days, sizeof(def->days));
+    h = crinitTimerIndexHashBytes(h, def->hours, sizeof(def->hours));
+    h = crinitTimerIndexHashBytes(h, def->minutes, sizeof(def->minutes));
+    h = crinitTimerIndexHashBytes(h, def->seconds, sizeof(def->seconds));
+    h = crinitTimerIndexHashBytes(h, def->timezone, sizeof(def->timezone));
+    h = crinitTimerIndexHashBytes(h, &def->intervalNs, sizeof(def->intervalNs));
+    unsigned char sinceArmed = def->sinceArmed;
+    return crinitTimerIndexHashBytes(h, &sinceArmed, sizeof(sinceArmed));
+}
+
+static bool crinitTimerIndexDefEqual(const crinitTimerDef_t *a, const crinitTimerDef_t *b) {
+    return a->wDay == b->wDay && memcmp(a->years, b->years, sizeof(a->years)) == 0 &&
+           memcmp(a->month, b->month, sizeof(a->month)) == 0 && memcmp(a->days, b->days, sizeof(a->days)) == 0 &&
+           memcmp(a->hours, b->hours, sizeof(a->hours)) == 0 &&
+           memcmp(a->minutes, b->minutes, sizeof(a->minutes)) == 0 &&
+           memcmp(a->seconds, b->seconds, sizeof(a->seconds)) == 0 &&
+           memcmp(a->timezone, b->timezone, sizeof(a->timezone)) == 0 && a->intervalNs == b->intervalNs &&
+           a->sinceArmed == b->sinceArmed;
+}
+
+static crinitTimerAlias_t *crinitTimerIndexFindName(const crinitTimerIndex_t *idx, const char *name,
+                                                    crinitTimerAlias_t ***prev) {
+    size_t b = crinitTimerIndexHashName(name) & (idx->nameBuckets - 1);
+    for (crinitTimerAlias_t **link = &idx->names[b]; *link != NULL; link = &(*link)->next) {
+        if (strcmp((*link)->name, name) == 0) {
+            if (prev != NULL) {
+                *prev = link;
+            }
+            return *link;
+        }
+    }
+    return NULL;
+}
+
+static crinitTimerEntry_t *crinitTimerIndexFindDef(const crinitTimerIndex_t *idx, const crinitTimerDef_t *def) {
+    size_t b = crinitTimerIndexHashDef(def) & (idx->entryBuckets - 1);
+    for (crinitTimerEntry_t *e = idx->entries[b]; e != NULL; e = e->next) {
+        if (crinitTimerIndexDefEqual(&e->def, def)) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void crinitTimerIndexGrow(crinitTimerIndex_t *idx) {
+    if (idx->nameCount > idx->nameBuckets) {
+        size_t newBuckets = idx->nameBuckets * 2;
+        crinitTimerAlias_t **names = calloc(newBuckets, sizeof(*names));
+        if (names != NULL) {
+            for (size_t i = 0; i < idx->nameBuckets; i++) {
+                crinitTimerAlias_t *a = idx->names[i];
+                while (a != NULL) {
+                    crinitTimerAlias_t *next = a->next;
+                    size_t b = crinitTimerIndexHashName(a->name) & (newBuckets - 1);
+                    a->next = names[b];
+                    names[b] = a;
+                    a = next;
+                }
+            }
+            free(idx->names);
+            idx->names = names;
+            idx->nameBuckets = newBuckets;
+        }
+    }
+    if (idx->entryCount > idx->entryBuckets) {
+        size_t newBuckets = idx->entryBuckets * 2;
+        crinitTimerEntry_t **entries = calloc(newBuckets, sizeof(*entries));
+        if (entries != NULL) {
+            for (size_t i = 0; i < idx->entryBuckets; i++) {
+                crinitTimerEntry_t *e = idx->entries[i];
+                while (e != NULL) {
+                    crinitTimerEntry_t *next = e->next;
+                    size_t b = crinitTimerIndexHashDef(&e->def) & (newBuckets - 1);
+                    e->next = entries[b];
+                    entries[b] = e;
+                    e = next;
+                }
+            }
+            free(idx->entries);
+            idx->entries = entries;
+            idx->entryBuckets = newBuckets;
+        }
+    }
+}
+
+static void crinitTimerIndexRemoveAlias(crinitTimerIndex_t *idx, crinitTimerAlias_t *alias) {
+    crinitTimerAlias_t **link = NULL;
+    if (crinitTimerIndexFindName(idx, alias->name, &link) == alias) {
+        *link = alias->next;
+        idx->nameCount--;
+    }
+    for (crinitTimerAlias_t **l = &alias->entry->aliases; *l != NULL; l = &(*l)->nextOfEntry) {
+        if (*l == alias) {
+            *l = alias->nextOfEntry;
+            break;
+        }
+    }
+    // References held through this spelling are gone with it.
+    alias->entry->refs -= alias->refs;
+    free(alias->name);
+    free(alias);
+}
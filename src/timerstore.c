@@ -0,0 +1,267 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file timerstore.c
+ * @brief Implementation of the persistent store of the last expirations of calendar timers.
+ */
+#include "timerstore.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "logio.h"
+
+/** Initial number of timers to allocate space for. **/
+#define CRINIT_TIMER_STORE_INITIAL_CAP 16
+/** Suffix of the temporary file written by crinitTimerStoreSave(). **/
+#define CRINIT_TIMER_STORE_TMP_SUFFIX ".tmp"
+
+/**
+ * Find the position of a timer in the store.
+ *
+ * @param s      The store.
+ * @param name   The name of the timer.
+ * @param found  Return pointer, set to true if the timer is in the store.
+ *
+ * @return the index of the timer if found, otherwise the index it would need to be inserted at
+ */
+static size_t crinitTimerStoreFind(const crinitTimerStore_t *s, const char *name, bool *found);
+/**
+ * Sync the directory containing a file to disk, so a rename of the file is persisted.
+ *
+ * @param path  Absolute path of the file.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitTimerStoreSyncDir(const char *path);
+
+int crinitTimerStoreInit(crinitTimerStore_t *s, const char *path) {
+    crinitNullCheck(-1, s, path);
+    s->runs = NULL;
+    s->size = 0;
+    s->cap = 0;
+    s->dirty = false;
+    s->path = strdup(path);
+    if (s->path == NULL) {
+        crinitErrnoPrint("Could not allocate memory for path of timer store.");
+        return -1;
+    }
+    return 0;
+}
+
+void crinitTimerStoreDestroy(crinitTimerStore_t *s) {
+    if (s == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < s->size; i++) {
+        free(s->runs[i].name);
+    }
+    free(s->runs);
+    free(s->path);
+    s->runs = NULL;
+    s->path = NULL;
+    s->size = 0;
+    s->cap = 0;
+}
+
+int crinitTimerStoreCopy(crinitTimerStore_t *out, const crinitTimerStore_t *s) {
+    crinitNullCheck(-1, out, s);
+    if (crinitTimerStoreInit(out, s->path) == -1) {
+        return -1;
+    }
+    if (s->size > 0) {
+        out->runs = malloc(s->size * sizeof(*out->runs));
+        if (out->runs == NULL) {
+            crinitErrnoPrint("Could not allocate memory for copy of timer store.");
+            crinitTimerStoreDestroy(out);
+            return -1;
+        }
+        out->cap = s->size;
+    }
+    for (size_t i = 0; i < s->size; i++) {
+        out->runs[i].name = strdup(s->runs[i].name);
+        if (out->runs[i].name == NULL) {
+            crinitErrnoPrint("Could not allocate memory for name of timer '%s'.", s->runs[i].name);
+            crinitTimerStoreDestroy(out);
+            return -1;
+        }
+        out->runs[i].lastRun = s->runs[i].lastRun;
+        out->size++;
+    }
+    out->dirty = s->dirty;
+    return 0;
+}
+
+int crinitTimerStoreLoad(crinitTimerStore_t *s) {
+    crinitNullCheck(-1, s);
+    FILE *f = fopen(s->path, "r");
+    if (f == NULL) {
+        if (errno == ENOENT) {
+            return 0;
+        }
+        crinitErrnoPrint("Could not open timer store '%s'.", s->path);
+        return -1;
+    }
+
+    int res = 0;
+    char *line = NULL;
+    size_t lineSize = 0;
+    ssize_t len;
+    while ((len = getline(&line, &lineSize, f)) != -1) {
+        if (len > 0 && line[len - 1] == '\n') {
+            line[len - 1] = '\0';
+        }
+        if (line[0] == '\0') {
+            continue;
+        }
+        char *name = NULL;
+        long long lastRun = strtoll(line, &name, 10);
+        if (name == line || *name != ' ' || name[1] == '\0' || lastRun <= 0) {
+            crinitErrPrint("Skipping malformed line in timer store '%s'.", s->path);
+            continue;
+        }
+        if (crinitTimerStoreSet(s, name + 1, (time_t)lastRun) == -1) {
+            res = -1;
+            break;
+        }
+    }
+    if (ferror(f)) {
+        crinitErrPrint("Could not read timer store '%s'.", s->path);
+        res = -1;
+    }
+    free(line);
+    fclose(f);
+    s->dirty = false;
+    return res;
+}
+
+int crinitTimerStoreSave(crinitTimerStore_t *s) {
+    crinitNullCheck(-1, s);
+    if (!s->dirty) {
+        return 0;
+    }
+
+    size_t tmpPathLen = strlen(s->path) + sizeof(CRINIT_TIMER_STORE_TMP_SUFFIX);
+    char *tmpPath = malloc(tmpPathLen);
+    if (tmpPath == NULL) {
+        crinitErrnoPrint("Could not allocate memory for temporary path of timer store.");
+        return -1;
+    }
+    snprintf(tmpPath, tmpPathLen, "%s%s", s->path, CRINIT_TIMER_STORE_TMP_SUFFIX);
+
+    FILE *f = fopen(tmpPath, "we");
+    if (f == NULL) {
+        crinitErrnoPrint("Could not open '%s' for writing.", tmpPath);
+        free(tmpPath);
+        return -1;
+    }
+    bool failed = false;
+    for (size_t i = 0; i < s->size && !failed; i++) {
+        failed = fprintf(f, "%lld %s\n", (long long)s->runs[i].lastRun, s->runs[i].name) < 0;
+    }
+    failed = failed || fflush(f) != 0 || fsync(fileno(f)) == -1;
+    if (fclose(f) != 0 || failed) {
+        crinitErrnoPrint("Could not write timer store to '%s'.", tmpPath);
+        remove(tmpPath);
+        free(tmpPath);
+        return -1;
+    }
+    if (rename(tmpPath, s->path) == -1) {
+        crinitErrnoPrint("Could not replace timer store '%s'.", s->path);
+        remove(tmpPath);
+        free(tmpPath);
+        return -1;
+    }
+    free(tmpPath);
+    if (crinitTimerStoreSyncDir(s->path) == -1) {
+        return -1;
+    }
+    s->dirty = false;
+    return 0;
+}
+
+time_t crinitTimerStoreGet(const crinitTimerStore_t *s, const char *name) {
+    if (s == NULL || name == NULL) {
+        return 0;
+    }
+    bool found = false;
+    size_t idx = crinitTimerStoreFind(s, name, &found);
+    return found ? s->runs[idx].lastRun : 0;
+}
+
+int crinitTimerStoreSet(crinitTimerStore_t *s, const char *name, time_t lastRun) {
+    crinitNullCheck(-1, s, name);
+    bool found = false;
+    size_t idx = crinitTimerStoreFind(s, name, &found);
+    if (found) {
+        s->dirty |= (s->runs[idx].lastRun != lastRun);
+        s->runs[idx].lastRun = lastRun;
+        return 0;
+    }
+
+    if (s->size == s->cap) {
+        size_t newCap = (s->cap > 0) ? s->cap * 2 : CRINIT_TIMER_STORE_INITIAL_CAP;
+        crinitTimerRun_t *newRuns = realloc(s->runs, newCap * sizeof(*newRuns));
+        if (newRuns == NULL) {
+            crinitErrnoPrint("Could not grow timer store to %zu timers.", newCap);
+            return -1;
+        }
+        s->runs = newRuns;
+        s->cap = newCap;
+    }
+    char *nameCopy = strdup(name);
+    if (nameCopy == NULL) {
+        crinitErrnoPrint("Could not allocate memory for name of timer '%s'.", name);
+        return -1;
+    }
+    memmove(&s->runs[idx + 1], &s->runs[idx], (s->size - idx) * sizeof(*s->runs));
+    s->runs[idx].name = nameCopy;
+    s->runs[idx].lastRun = lastRun;
+    s->size++;
+    s->dirty = true;
+    return 0;
+}
+
+static size_t crinitTimerStoreFind(const crinitTimerStore_t *s, const char *name, bool *found) {
+    size_t lo = 0, hi = s->size;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(s->runs[mid].name, name);
+        if (cmp == 0) {
+            *found = true;
+            return mid;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *found = false;
+    return lo;
+}
+
+static int crinitTimerStoreSyncDir(const char *path) {
+    const char *sep = strrchr(path, '/');
+    char *dir = (sep == NULL || sep == path) ? strdup((sep == NULL) ? "." : "/") : strndup(path, (size_t)(sep - path));
+    if (dir == NULL) {
+        crinitErrnoPrint("Could not allocate memory for directory of timer store.");
+        return -1;
+    }
+    int fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1 || fsync(fd) == -1) {
+        crinitErrnoPrint("Could not sync directory '%s' of timer store.", dir);
+        if (fd != -1) {
+            close(fd);
+        }
+        free(dir);
+        return -1;
+    }
+    close(fd);
+    free(dir);
+    return 0;
+}
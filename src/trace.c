@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file trace.c
+ * @brief Implementation of the in-memory boot trace.
+ */
+#include "trace.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef SYS_gettid
+#error "SYS_gettid unavailable on this system"
+#endif
+
+/** Macro wrapper for the gettid syscall in case glibc is not new enough to contain one itself **/
+#define crinitGettid() ((pid_t)syscall(SYS_gettid))
+
+/** The trace ring buffer, crinitTraceNext % #CRINIT_TRACE_RECORDS is the slot of the next record. **/
+static crinitTraceRecord_t crinitTraceRing[CRINIT_TRACE_RECORDS];
+/** Sequence number of the next record, equal to the number of records written since startup. **/
+static uint64_t crinitTraceNext = 0;
+/** Mutex to synchronize access to the trace ring buffer. **/
+static pthread_mutex_t crinitTraceLock = PTHREAD_MUTEX_INITIALIZER;
+/** Cached thread ID of the calling thread, 0 until its first event. **/
+static _Thread_local pid_t crinitTraceTid = 0;
+
+/**
+ * Write a record into the trace ring buffer.
+ *
+ * @param type    The type of the event.
+ * @param ts      Timestamp of the event in nanoseconds.
+ * @param dur     Duration of the event in nanoseconds.
+ * @param arg     The event-specific argument.
+ * @param format  printf-style format string for the name of the event.
+ * @param args    Arguments to \a format.
+ */
+static void crinitTraceWrite(crinitTraceEventType_t type, uint64_t ts, uint64_t dur, int64_t arg, const char *format,
+                             va_list args) __attribute__((format(printf, 5, 0)));
+
+uint64_t crinitTraceNow(void) {
+    struct timespec now;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) == -1) {
+        return 0;
+    }
+    return (uint64_t)now.tv_sec * 1000000000uLL + (uint64_t)now.tv_nsec;
+}
+
+void crinitTraceInstant(crinitTraceEventType_t type, int64_t arg, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    crinitTraceWrite(type, crinitTraceNow(), 0, arg, format, args);
+    va_end(args);
+}
+
+void crinitTraceSpan(crinitTraceEventType_t type, uint64_t start, int64_t arg, const char *format, ...) {
+    uint64_t now = crinitTraceNow();
+    va_list args;
+    va_start(args, format);
+    crinitTraceWrite(type, start, (now > start) ? now - start : 0, arg, format, args);
+    va_end(args);
+}
+
+size_t crinitTraceRead(crinitTraceRecord_t *out, size_t max, uint64_t *seq, uint64_t *dropped) {
+    if (out == NULL || seq == NULL || dropped == NULL) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&crinitTraceLock);
+    uint64_t oldest = (crinitTraceNext > CRINIT_TRACE_RECORDS) ? crinitTraceNext - CRINIT_TRACE_RECORDS : 0;
+    *dropped = 0;
+    if (*seq < oldest) {
+        *dropped = oldest - *seq;
+        *seq = oldest;
+    }
+    size_t n = 0;
+    while (n < max && *seq < crinitTraceNext) {
+        out[n++] = crinitTraceRing[*seq % CRINIT_TRACE_RECORDS];
+        (*seq)++;
+    }
+    pthread_mutex_unlock(&crinitTraceLock);
+    return n;
+}
+
+int crinitTraceMutexLock(pthread_mutex_t *mutex, const char *lockName) {
+    int ret = pthread_mutex_trylock(mutex);
+    if (ret != EBUSY) {
+        return ret;
+    }
+
+    uint64_t start = crinitTraceNow();
+    ret = pthread_mutex_lock(mutex);
+    if (ret == 0) {
+        crinitTraceSpan(CRINIT_TRACE_LOCK_WAIT, start, 0, "%s", lockName);
+    }
+    return ret;
+}
+
+static void crinitTraceWrite(crinitTraceEventType_t type, uint64_t ts, uint64_t dur, int64_t arg, const char *format,
+                             va_list args) {
+    if (crinitTraceTid == 0) {
+        crinitTraceTid = crinitGettid();
+    }
+
+    // Format outside of the lock, the name is copied into the ring along with the rest of the record.
+    crinitTraceRecord_t rec = {.ts = ts, .dur = dur, .arg = arg, .tid = crinitTraceTid, .type = type};
+    vsnprintf(rec.name, sizeof(rec.name), format, args);
+    for (char *c = rec.name; *c != '\0'; c++) {
+        if (*c == '\n') {
+            *c = ' ';
+        }
+    }
+
+    pthread_mutex_lock(&crinitTraceLock);
+    crinitTraceRing[crinitTraceNext % CRINIT_TRACE_RECORDS] = rec;
+    crinitTraceNext++;
+    pthread_mutex_unlock(&crinitTraceLock);
+}
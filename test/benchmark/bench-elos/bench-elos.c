@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file bench-elos.c
+ * @brief Benchmark of the elos integration against a local stand-in for elosd.
+ *
+ * Registers one task per filter with elosdep and measures how long it takes from publishing a matching event until the
+ * dependency of the task is fulfilled, for several values of the ELOS_EVENT_POLL_INTERVAL global option. Fulfilling
+ * the dependency is the point where crinit would spawn the task, so the TaskDB is replaced by a stub recording the
+ * time. The event queue reads crinit sends to the daemon while idle are counted as the cost of polling. Afterwards,
+ * events are logged through eloslog as fast as possible to measure the publish throughput.
+ *
+ * See fake-elos.h for the protocol subset the stand-in supports.
+ *
+ * Usage: `bench-elos [NUM_FILTERS [SAMPLES [NUM_EVENTS]]]`, defaults are #CRINIT_BENCH_DEFAULT_FILTERS,
+ * #CRINIT_BENCH_DEFAULT_SAMPLES and #CRINIT_BENCH_DEFAULT_EVENTS.
+ */
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "elosdep.h"
+#include "eloslog.h"
+#include "fake-elos.h"
+#include "globopt.h"
+#include "logio.h"
+#include "task.h"
+#include "taskdb.h"
+
+/** Default number of filters, each of a different task. **/
+#define CRINIT_BENCH_DEFAULT_FILTERS 200
+/** Default number of latency samples per poll interval. **/
+#define CRINIT_BENCH_DEFAULT_SAMPLES 10
+/** Default number of events to log for the throughput measurement. **/
+#define CRINIT_BENCH_DEFAULT_EVENTS 20000
+/** Time in microseconds to wait for a dependency to be fulfilled before giving up on a sample. **/
+#define CRINIT_BENCH_TIMEOUT_US 5000000LL
+/** Prefix of elos filter dependencies. **/
+#define CRINIT_BENCH_ELOS_DEPENDENCY "@elos"
+/** Name of the filter of every task. **/
+#define CRINIT_BENCH_FILTER_NAME "BENCH"
+
+/** Values of ELOS_EVENT_POLL_INTERVAL to measure, in microseconds. **/
+static const unsigned long long crinitBenchIntervals[] = {1000, 10000, 100000, 500000};
+
+/** The tasks with elos filter dependencies. **/
+static crinitTask_t *crinitBenchTasks;
+/** Index of the task whose dependency is expected to be fulfilled next. **/
+static atomic_size_t crinitBenchExpected;
+/** Time the expected dependency has been fulfilled at on `CLOCK_MONOTONIC` in microseconds, 0 if not yet. **/
+static atomic_llong crinitBenchFulfilledUs;
+/** Number of dependencies fulfilled for other tasks than the expected one. **/
+static atomic_size_t crinitBenchUnexpected;
+
+/**
+ * Get the current time of `CLOCK_MONOTONIC` in microseconds.
+ */
+static long long crinitBenchNowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/**
+ * Stub replacing the TaskDB, records when the dependency of the expected task is fulfilled.
+ */
+int crinitTaskDBFulfillDep(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, crinitTask_t *target) {
+    CRINIT_PARAM_UNUSED(ctx);
+    CRINIT_PARAM_UNUSED(dep);
+    if ((size_t)(target - crinitBenchTasks) == atomic_load(&crinitBenchExpected)) {
+        atomic_store(&crinitBenchFulfilledUs, crinitBenchNowUs());
+    } else {
+        atomic_fetch_add(&crinitBenchUnexpected, 1);
+    }
+    return 0;
+}
+
+/**
+ * Compare two latencies for qsort().
+ */
+static int crinitBenchCmp(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Set up a task with a single `@elos` dependency on a filter matching the payload `bench-<i>`.
+ *
+ * The tasks are rearmed so that the filters stay subscribed for all samples.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitBenchTaskInit(crinitTask_t *t, size_t i) {
+    char name[32], rule[64];
+    snprintf(name, sizeof(name), "bench-%zu", i);
+    snprintf(rule, sizeof(rule), ".event.payload '%s' STRCMP", name);
+    t->name = strdup(name);
+    t->opts = CRINIT_TASK_OPT_TRIGGER_REARM;
+    t->deps = calloc(1, sizeof(*t->deps));
+    if (t->name == NULL || t->deps == NULL || crinitEnvSetInit(&t->elosFilters, 4, 4) == -1 ||
+        crinitEnvSetSet(&t->elosFilters, CRINIT_BENCH_FILTER_NAME, rule) == -1) {
+        return -1;
+    }
+    t->deps[0].name = CRINIT_BENCH_ELOS_DEPENDENCY;
+    t->deps[0].event = CRINIT_BENCH_FILTER_NAME;
+    t->depsSize = 1;
+    return 0;
+}
+
+/**
+ * Measure the latency from publishing an event to the fulfillment of the dependency of a task.
+ *
+ * The samples are spread over random idle times, so events arrive at arbitrary points of the polling.
+ *
+ * @param producer    Session to publish the events with.
+ * @param numFilters  Number of tasks with filters.
+ * @param samples     Number of samples to take.
+ * @param interval    The poll interval to configure.
+ */
+static void crinitBenchLatency(crinitElosSession_t *producer, size_t numFilters, size_t samples,
+                               unsigned long long interval) {
+    long long *lat = calloc(samples, sizeof(*lat));
+    if (lat == NULL) {
+        return;
+    }
+    crinitGlobOptSet(CRINIT_GLOBOPT_ELOS_EVENT_POLL_INTERVAL, interval);
+
+    long long idleUs = 0;
+    uint64_t idleReads = 0;
+    size_t taken = 0;
+    for (size_t s = 0; s < samples; s++) {
+        size_t i = (size_t)rand() % numFilters;
+        char payload[32];
+        snprintf(payload, sizeof(payload), "bench-%zu", i);
+        crinitElosEvent_t event = {
+            .source = {.appName = "bench"},
+            .severity = ELOS_SEVERITY_INFO,
+            .messageCode = ELOS_MSG_CODE_INFO_LOG,
+            .payload = payload,
+        };
+
+        // Idle long enough for the listener to back off to the configured interval.
+        crinitFakeElosStats_t before, after;
+        long long idle = (long long)interval * 2 + rand() % (long long)interval;
+        crinitFakeElosdGetStats(&before);
+        usleep((useconds_t)idle);
+        crinitFakeElosdGetStats(&after);
+        idleUs += idle;
+        idleReads += after.reads - before.reads;
+
+        atomic_store(&crinitBenchExpected, i);
+        atomic_store(&crinitBenchFulfilledUs, 0);
+        long long start = crinitBenchNowUs();
+        if (crinitElosGetVTable()->eventPublish(producer, &event) != SAFU_RESULT_OK) {
+            fprintf(stderr, "Could not publish event.\n");
+            break;
+        }
+        long long done;
+        while ((done = atomic_load(&crinitBenchFulfilledUs)) == 0 &&
+               crinitBenchNowUs() - start < CRINIT_BENCH_TIMEOUT_US) {
+            usleep(50);
+        }
+        if (done == 0) {
+            fprintf(stderr, "Dependency of task %zu has not been fulfilled.\n", i);
+            continue;
+        }
+        lat[taken++] = done - start;
+    }
+
+    if (taken > 0) {
+        long long sum = 0;
+        for (size_t s = 0; s < taken; s++) {
+            sum += lat[s];
+        }
+        qsort(lat, taken, sizeof(*lat), crinitBenchCmp);
+        printf("poll interval %6.1f ms:  latency avg/p50/max %7.2f / %7.2f / %7.2f ms, %8.1f queue reads/s idle\n",
+               (double)interval / 1000.0, (double)sum / (double)taken / 1000.0, (double)lat[taken / 2] / 1000.0,
+               (double)lat[taken - 1] / 1000.0, (double)idleReads * 1e6 / (double)idleUs);
+    }
+    free(lat);
+}
+
+/**
+ * Wait until eloslog has handed at least \a n events to the daemon or given up on them.
+ *
+ * @param n      Number of events.
+ * @param stats  Return pointer for the eloslog counters.
+ */
+static void crinitBenchWaitLogged(uint64_t n, crinitEloslogStats_t *stats) {
+    long long start = crinitBenchNowUs();
+    while (crinitEloslogGetStats(stats) == 0 && stats->published + stats->failed + stats->dropped < n &&
+           crinitBenchNowUs() - start < CRINIT_BENCH_TIMEOUT_US) {
+        usleep(100);
+    }
+}
+
+/**
+ * Measure how fast events logged through eloslog arrive at the daemon.
+ *
+ * The events are logged in chunks of half the event buffer, so the throughput of the transmitter is measured rather
+ * than how many events the buffer drops.
+ *
+ * @param numEvents  Number of events to log.
+ */
+static void crinitBenchPublish(size_t numEvents) {
+    const size_t chunk = CRINIT_ELOSLOG_EVENT_LIMIT / 2;
+    crinitGlobOptSet(CRINIT_GLOBOPT_USE_ELOS, true);
+    if (crinitEloslogInit() == -1 || crinitEloslogActivate(true) == -1) {
+        fprintf(stderr, "Could not activate elos event logging.\n");
+        return;
+    }
+
+    crinitFakeElosStats_t before, after;
+    crinitEloslogStats_t stats;
+    long long logNs = 0;
+    crinitFakeElosdGetStats(&before);
+    long long start = crinitBenchNowUs();
+    for (size_t i = 0; i < numEvents; i++) {
+        if (i >= chunk && i % chunk == 0) {
+            crinitBenchWaitLogged(i - chunk, &stats);
+        }
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        crinitElosLog(ELOS_SEVERITY_INFO, ELOS_MSG_CODE_PROCESS_CREATED, ELOS_CLASSIFICATION_PROCESS,
+                      "Started task 'bench-event-%zu'", i);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        logNs += (t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec);
+    }
+    crinitBenchWaitLogged(numEvents, &stats);
+    long long total = crinitBenchNowUs() - start;
+    crinitFakeElosdGetStats(&after);
+
+    printf("log event:                 %.2f us/event\n", (double)logNs / (double)numEvents / 1000.0);
+    printf("publish throughput:        %.0f events/s, %.1f events/batch\n",
+           (double)(after.published - before.published) * 1e6 / (double)total,
+           (stats.batches > 0) ? (double)stats.published / (double)stats.batches : 0.0);
+    printf("dropped/failed events:     %" PRIu64 " / %" PRIu64 "\n", stats.dropped, stats.failed);
+    crinitEloslogActivate(false);
+}
+
+int main(int argc, char *argv[]) {
+    size_t numFilters = (argc > 1) ? strtoul(argv[1], NULL, 10) : CRINIT_BENCH_DEFAULT_FILTERS;
+    size_t samples = (argc > 2) ? strtoul(argv[2], NULL, 10) : CRINIT_BENCH_DEFAULT_SAMPLES;
+    size_t numEvents = (argc > 3) ? strtoul(argv[3], NULL, 10) : CRINIT_BENCH_DEFAULT_EVENTS;
+    if (numFilters == 0 || samples == 0 || numEvents == 0) {
+        fprintf(stderr, "Usage: %s [NUM_FILTERS [SAMPLES [NUM_EVENTS]]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    srand(1);
+    // Keep the connection messages of crinit out of the results.
+    FILE *devNull = fopen("/dev/null", "w");
+    if (devNull != NULL) {
+        crinitSetInfoStream(devNull);
+    }
+
+    uint16_t port;
+    if (crinitGlobOptInitDefault() == -1 || crinitFakeElosdStart(&port) == -1) {
+        fprintf(stderr, "Could not start fake elosd.\n");
+        return EXIT_FAILURE;
+    }
+    crinitFakeElosInstall(port);
+
+    crinitBenchTasks = calloc(numFilters, sizeof(*crinitBenchTasks));
+    if (crinitBenchTasks == NULL) {
+        fprintf(stderr, "Could not allocate memory.\n");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < numFilters; i++) {
+        if (crinitBenchTaskInit(&crinitBenchTasks[i], i) == -1 || crinitElosdepTaskAdded(&crinitBenchTasks[i]) == -1) {
+            fprintf(stderr, "Could not register task %zu.\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The listener subscribes all filters registered so far when it starts.
+    crinitTaskDB_t taskDB = {0};
+    crinitFakeElosStats_t stats;
+    long long start = crinitBenchNowUs();
+    if (crinitElosdepActivate(&taskDB, true) == -1) {
+        fprintf(stderr, "Could not activate elos dependencies.\n");
+        return EXIT_FAILURE;
+    }
+    do {
+        usleep(1000);
+        crinitFakeElosdGetStats(&stats);
+    } while (stats.subscriptions < numFilters && crinitBenchNowUs() - start < CRINIT_BENCH_TIMEOUT_US);
+    printf("filters:                   %zu\n", numFilters);
+    printf("subscribe all filters:     %.2f ms (%" PRIu64 " subscriptions)\n",
+           (double)(crinitBenchNowUs() - start) / 1000.0, stats.subscriptions);
+
+    crinitElosSession_t *producer = NULL;
+    if (crinitElosGetVTable()->connect("127.0.0.1", port, &producer) != SAFU_RESULT_OK) {
+        fprintf(stderr, "Could not connect to fake elosd.\n");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < crinitNumElements(crinitBenchIntervals); i++) {
+        crinitBenchLatency(producer, numFilters, samples, crinitBenchIntervals[i]);
+    }
+    if (atomic_load(&crinitBenchUnexpected) > 0) {
+        printf("unexpected fulfillments:   %zu\n", atomic_load(&crinitBenchUnexpected));
+    }
+    crinitElosGetVTable()->disconnect(producer);
+    free(producer);
+
+    crinitBenchPublish(numEvents);
+
+    crinitElosdepActivate(&taskDB, false);
+    if (devNull != NULL) {
+        crinitSetInfoStream(stdout);
+        fclose(devNull);
+    }
+    return EXIT_SUCCESS;
+}
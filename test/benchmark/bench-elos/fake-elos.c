@@ -0,0 +1,664 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file fake-elos.c
+ * @brief Implementation of a minimal stand-in for elosd and libelos.
+ */
+#include "fake-elos.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common.h"
+
+/** Version string reported by the fake daemon. **/
+#define CRINIT_FAKE_ELOS_VERSION "fake-elosd"
+
+/**
+ * Request types of the fake protocol.
+ */
+typedef enum crinitFakeElosMsgType {
+    CRINIT_FAKE_ELOS_MSG_VERSION = 1,  ///< No body, responds with the version string.
+    CRINIT_FAKE_ELOS_MSG_SUBSCRIBE,    ///< Body is the filter rule, responds with the queue id.
+    CRINIT_FAKE_ELOS_MSG_UNSUBSCRIBE,  ///< Body is the queue id, no response body.
+    CRINIT_FAKE_ELOS_MSG_READ,         ///< Body is the queue id, responds with all queued events.
+    CRINIT_FAKE_ELOS_MSG_PUBLISH,      ///< Body is a single event, no response body.
+} crinitFakeElosMsgType_t;
+
+/**
+ * Header of every request and response, followed by crinitFakeElosMsgHdr_t::len bytes of body.
+ *
+ * Events are encoded as three zero-terminated strings: the decimal message code, the source app name and the payload.
+ */
+typedef struct crinitFakeElosMsgHdr {
+    uint8_t type;    ///< The request type, see crinitFakeElosMsgType_t.
+    uint8_t status;  ///< 0 on success in a response, 1 on error.
+    uint16_t pad;    ///< Unused.
+    uint32_t len;    ///< Length of the body.
+} crinitFakeElosMsgHdr_t;
+
+/**
+ * Event field compared by a filter.
+ */
+typedef enum crinitFakeElosField {
+    CRINIT_FAKE_ELOS_FIELD_PAYLOAD,
+    CRINIT_FAKE_ELOS_FIELD_APPNAME,
+    CRINIT_FAKE_ELOS_FIELD_MESSAGE_CODE,
+} crinitFakeElosField_t;
+
+/**
+ * An event queue of the fake daemon, created by a subscription.
+ */
+typedef struct crinitFakeElosQueue {
+    int owner;                                         ///< Socket of the connection which has subscribed.
+    crinitFakeElosField_t field;                       ///< The event field to compare.
+    char *text;                                        ///< The string to compare to for string fields.
+    long code;                                         ///< The message code to compare to.
+    char *events[CRINIT_FAKE_ELOS_QUEUE_LIMIT];        ///< Ring of encoded events.
+    uint32_t eventLens[CRINIT_FAKE_ELOS_QUEUE_LIMIT];  ///< Lengths of the encoded events.
+    size_t head;                                       ///< Index of the oldest event.
+    size_t count;                                      ///< Number of queued events.
+} crinitFakeElosQueue_t;
+
+/**
+ * State of the fake daemon, guarded by crinitFakeElosd::lock.
+ */
+static struct crinitFakeElosd {
+    pthread_mutex_t lock;            ///< Guards all members.
+    int listenFd;                    ///< The listening socket.
+    crinitFakeElosQueue_t **queues;  ///< Event queues, the queue id is the index plus one.
+    size_t numQueues;                ///< Number of entries in crinitFakeElosd::queues.
+    crinitFakeElosStats_t stats;     ///< Counters of the daemon.
+} crinitFakeElosd = {.lock = PTHREAD_MUTEX_INITIALIZER, .listenFd = -1};
+
+/**
+ * Read or write exactly \a len bytes.
+ *
+ * @return 0 on success, -1 on error or end of file
+ */
+static int crinitFakeElosIo(int fd, void *buf, size_t len, bool wr) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = wr ? send(fd, p, len, MSG_NOSIGNAL) : recv(fd, p, len, 0);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * Send a message consisting of a header and a body.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int crinitFakeElosSend(int fd, uint8_t type, uint8_t status, const void *body, uint32_t len) {
+    crinitFakeElosMsgHdr_t hdr = {.type = type, .status = status, .len = len};
+    if (crinitFakeElosIo(fd, &hdr, sizeof(hdr), true) == -1) {
+        return -1;
+    }
+    return (len > 0) ? crinitFakeElosIo(fd, (void *)body, len, true) : 0;
+}
+
+/**
+ * Receive a message, the body is allocated and zero-terminated.
+ *
+ * @return 0 on success, -1 on error or end of file
+ */
+static int crinitFakeElosRecv(int fd, crinitFakeElosMsgHdr_t *hdr, char **body) {
+    if (crinitFakeElosIo(fd, hdr, sizeof(*hdr), false) == -1) {
+        return -1;
+    }
+    *body = malloc((size_t)hdr->len + 1);
+    if (*body == NULL) {
+        return -1;
+    }
+    if (crinitFakeElosIo(fd, *body, hdr->len, false) == -1) {
+        free(*body);
+        return -1;
+    }
+    (*body)[hdr->len] = '\0';
+    return 0;
+}
+
+/**
+ * Parse a filter rule into a queue.
+ *
+ * @return 0 on success, -1 if the rule is not supported
+ */
+static int crinitFakeElosParseFilter(const char *rule, crinitFakeElosQueue_t *q) {
+    int end = -1;
+    q->text = malloc(strlen(rule) + 1);
+    if (q->text == NULL) {
+        return -1;
+    }
+    if (sscanf(rule, " .event.payload '%[^']' STRCMP %n", q->text, &end) == 1 && end != -1 && rule[end] == '\0') {
+        q->field = CRINIT_FAKE_ELOS_FIELD_PAYLOAD;
+        return 0;
+    }
+    end = -1;
+    if (sscanf(rule, " .event.source.appName '%[^']' STRCMP %n", q->text, &end) == 1 && end != -1 &&
+        rule[end] == '\0') {
+        q->field = CRINIT_FAKE_ELOS_FIELD_APPNAME;
+        return 0;
+    }
+    end = -1;
+    if (sscanf(rule, " .event.messageCode %ld EQ %n", &q->code, &end) == 1 && end != -1 && rule[end] == '\0') {
+        q->field = CRINIT_FAKE_ELOS_FIELD_MESSAGE_CODE;
+        return 0;
+    }
+    free(q->text);
+    q->text = NULL;
+    return -1;
+}
+
+/**
+ * Free a queue and its events.
+ */
+static void crinitFakeElosQueueDestroy(crinitFakeElosQueue_t *q) {
+    for (size_t i = 0; i < q->count; i++) {
+        free(q->events[(q->head + i) % CRINIT_FAKE_ELOS_QUEUE_LIMIT]);
+    }
+    free(q->text);
+    free(q);
+}
+
+/**
+ * Subscribe a filter rule for a connection. Called with crinitFakeElosd::lock held.
+ *
+ * @return the queue id on success, ELOS_ID_INVALID on error
+ */
+static crinitElosEventQueueId_t crinitFakeElosdSubscribe(int owner, const char *rule) {
+    crinitFakeElosQueue_t *q = calloc(1, sizeof(*q));
+    if (q == NULL || crinitFakeElosParseFilter(rule, q) == -1) {
+        free(q);
+        return ELOS_ID_INVALID;
+    }
+    q->owner = owner;
+
+    size_t idx = 0;
+    while (idx < crinitFakeElosd.numQueues && crinitFakeElosd.queues[idx] != NULL) {
+        idx++;
+    }
+    if (idx == crinitFakeElosd.numQueues) {
+        size_t newSize = (idx > 0) ? idx * 2 : 16;
+        crinitFakeElosQueue_t **newQueues = realloc(crinitFakeElosd.queues, newSize * sizeof(*newQueues));
+        if (newQueues == NULL) {
+            crinitFakeElosQueueDestroy(q);
+            return ELOS_ID_INVALID;
+        }
+        memset(&newQueues[idx], 0, (newSize - idx) * sizeof(*newQueues));
+        crinitFakeElosd.queues = newQueues;
+        crinitFakeElosd.numQueues = newSize;
+    }
+    crinitFakeElosd.queues[idx] = q;
+    crinitFakeElosd.stats.subscriptions++;
+    return (crinitElosEventQueueId_t)(idx + 1);
+}
+
+/**
+ * Get a queue of a connection by its id. Called with crinitFakeElosd::lock held.
+ *
+ * @return the queue, NULL if there is no such queue
+ */
+static crinitFakeElosQueue_t *crinitFakeElosdQueue(int owner, const char *body, uint32_t len) {
+    crinitElosEventQueueId_t id;
+    if (len != sizeof(id)) {
+        return NULL;
+    }
+    memcpy(&id, body, sizeof(id));
+    if (id == ELOS_ID_INVALID || id > crinitFakeElosd.numQueues) {
+        return NULL;
+    }
+    crinitFakeElosQueue_t *q = crinitFakeElosd.queues[id - 1];
+    return (q != NULL && q->owner == owner) ? q : NULL;
+}
+
+/**
+ * Unsubscribe a queue. Called with crinitFakeElosd::lock held.
+ */
+static void crinitFakeElosdUnsubscribe(crinitFakeElosQueue_t *q) {
+    for (size_t i = 0; i < crinitFakeElosd.numQueues; i++) {
+        if (crinitFakeElosd.queues[i] == q) {
+            crinitFakeElosd.queues[i] = NULL;
+        }
+    }
+    crinitFakeElosQueueDestroy(q);
+    crinitFakeElosd.stats.subscriptions--;
+}
+
+/**
+ * Put a published event into all matching queues. Called with crinitFakeElosd::lock held.
+ *
+ * @return 0 on success, -1 if the event is malformed
+ */
+static int crinitFakeElosdPublish(const char *body, uint32_t len) {
+    const char *code = body;
+    const char *appName = code + strlen(code) + 1;
+    if (appName >= body + len) {
+        return -1;
+    }
+    const char *payload = appName + strlen(appName) + 1;
+    if (payload >= body + len) {
+        return -1;
+    }
+    long messageCode = strtol(code, NULL, 10);
+
+    crinitFakeElosd.stats.published++;
+    for (size_t i = 0; i < crinitFakeElosd.numQueues; i++) {
+        crinitFakeElosQueue_t *q = crinitFakeElosd.queues[i];
+        if (q == NULL) {
+            continue;
+        }
+        bool match = false;
+        switch (q->field) {
+            case CRINIT_FAKE_ELOS_FIELD_PAYLOAD:
+                match = strcmp(payload, q->text) == 0;
+                break;
+            case CRINIT_FAKE_ELOS_FIELD_APPNAME:
+                match = strcmp(appName, q->text) == 0;
+                break;
+            case CRINIT_FAKE_ELOS_FIELD_MESSAGE_CODE:
+                match = messageCode == q->code;
+                break;
+        }
+        if (!match) {
+            continue;
+        }
+        char *ev = malloc(len);
+        if (ev == NULL) {
+            continue;
+        }
+        memcpy(ev, body, len);
+        if (q->count == CRINIT_FAKE_ELOS_QUEUE_LIMIT) {
+            free(q->events[q->head]);
+            q->head = (q->head + 1) % CRINIT_FAKE_ELOS_QUEUE_LIMIT;
+            q->count--;
+        }
+        size_t slot = (q->head + q->count) % CRINIT_FAKE_ELOS_QUEUE_LIMIT;
+        q->events[slot] = ev;
+        q->eventLens[slot] = len;
+        q->count++;
+        crinitFakeElosd.stats.queued++;
+    }
+    return 0;
+}
+
+/**
+ * Drain a queue into a single response body. Called with crinitFakeElosd::lock held.
+ *
+ * @return the allocated body, NULL on error
+ */
+static char *crinitFakeElosdDrain(crinitFakeElosQueue_t *q, uint32_t *len) {
+    size_t total = 0;
+    for (size_t i = 0; i < q->count; i++) {
+        total += q->eventLens[(q->head + i) % CRINIT_FAKE_ELOS_QUEUE_LIMIT];
+    }
+    char *body = malloc(total + 1);
+    if (body == NULL) {
+        return NULL;
+    }
+    char *p = body;
+    for (size_t i = 0; i < q->count; i++) {
+        size_t slot = (q->head + i) % CRINIT_FAKE_ELOS_QUEUE_LIMIT;
+        memcpy(p, q->events[slot], q->eventLens[slot]);
+        p += q->eventLens[slot];
+        free(q->events[slot]);
+    }
+    q->head = 0;
+    q->count = 0;
+    *len = (uint32_t)total;
+    return body;
+}
+
+/**
+ * Serve the requests of a single connection until it is closed.
+ */
+static void *crinitFakeElosdConnection(void *arg) {
+    int fd = (int)(intptr_t)arg;
+    crinitFakeElosMsgHdr_t hdr;
+    char *body;
+
+    while (crinitFakeElosRecv(fd, &hdr, &body) == 0) {
+        char *resp = NULL;
+        uint32_t respLen = 0;
+        crinitElosEventQueueId_t id = ELOS_ID_INVALID;
+        uint8_t status = 0;
+
+        pthread_mutex_lock(&crinitFakeElosd.lock);
+        crinitFakeElosd.stats.requests++;
+        switch (hdr.type) {
+            case CRINIT_FAKE_ELOS_MSG_VERSION:
+                resp = strdup(CRINIT_FAKE_ELOS_VERSION);
+                respLen = (resp != NULL) ? sizeof(CRINIT_FAKE_ELOS_VERSION) : 0;
+                break;
+            case CRINIT_FAKE_ELOS_MSG_SUBSCRIBE:
+                id = crinitFakeElosdSubscribe(fd, body);
+                resp = malloc(sizeof(id));
+                if (resp != NULL) {
+                    memcpy(resp, &id, sizeof(id));
+                    respLen = sizeof(id);
+                }
+                status = (id == ELOS_ID_INVALID);
+                break;
+            case CRINIT_FAKE_ELOS_MSG_UNSUBSCRIBE: {
+                crinitFakeElosQueue_t *q = crinitFakeElosdQueue(fd, body, hdr.len);
+                if (q != NULL) {
+                    crinitFakeElosdUnsubscribe(q);
+                }
+                status = (q == NULL);
+                break;
+            }
+            case CRINIT_FAKE_ELOS_MSG_READ: {
+                crinitFakeElosQueue_t *q = crinitFakeElosdQueue(fd, body, hdr.len);
+                crinitFakeElosd.stats.reads++;
+                if (q != NULL) {
+                    resp = crinitFakeElosdDrain(q, &respLen);
+                }
+                status = (resp == NULL);
+                break;
+            }
+            case CRINIT_FAKE_ELOS_MSG_PUBLISH:
+                status = (crinitFakeElosdPublish(body, hdr.len) == -1);
+                break;
+            default:
+                status = 1;
+                break;
+        }
+        pthread_mutex_unlock(&crinitFakeElosd.lock);
+
+        int res = crinitFakeElosSend(fd, hdr.type, status, resp, respLen);
+        free(resp);
+        free(body);
+        if (res == -1) {
+            break;
+        }
+    }
+
+    // Like elosd, drop all subscriptions of a closed connection.
+    pthread_mutex_lock(&crinitFakeElosd.lock);
+    for (size_t i = 0; i < crinitFakeElosd.numQueues; i++) {
+        crinitFakeElosQueue_t *q = crinitFakeElosd.queues[i];
+        if (q != NULL && q->owner == fd) {
+            crinitFakeElosdUnsubscribe(q);
+        }
+    }
+    pthread_mutex_unlock(&crinitFakeElosd.lock);
+    close(fd);
+    return NULL;
+}
+
+/**
+ * Accept connections and serve each in its own thread.
+ */
+static void *crinitFakeElosdListener(void *arg) {
+    CRINIT_PARAM_UNUSED(arg);
+    while (1) {
+        int fd = accept(crinitFakeElosd.listenFd, NULL, NULL);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            perror("fake-elosd: accept");
+            return NULL;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        pthread_t t;
+        if (pthread_create(&t, NULL, crinitFakeElosdConnection, (void *)(intptr_t)fd) != 0) {
+            close(fd);
+            continue;
+        }
+        pthread_detach(t);
+    }
+}
+
+int crinitFakeElosdStart(uint16_t *port) {
+    crinitNullCheck(-1, port);
+
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK), .sin_port = 0};
+    socklen_t addrLen = sizeof(addr);
+    crinitFakeElosd.listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (crinitFakeElosd.listenFd == -1 || bind(crinitFakeElosd.listenFd, (struct sockaddr *)&addr, addrLen) == -1 ||
+        listen(crinitFakeElosd.listenFd, SOMAXCONN) == -1 ||
+        getsockname(crinitFakeElosd.listenFd, (struct sockaddr *)&addr, &addrLen) == -1) {
+        crinitErrnoPrint("Could not set up the fake elosd socket.");
+        return -1;
+    }
+
+    pthread_t t;
+    if ((errno = pthread_create(&t, NULL, crinitFakeElosdListener, NULL)) != 0) {
+        crinitErrnoPrint("Could not start the fake elosd thread.");
+        return -1;
+    }
+    pthread_detach(t);
+    *port = ntohs(addr.sin_port);
+    return 0;
+}
+
+void crinitFakeElosdGetStats(crinitFakeElosStats_t *stats) {
+    pthread_mutex_lock(&crinitFakeElosd.lock);
+    *stats = crinitFakeElosd.stats;
+    pthread_mutex_unlock(&crinitFakeElosd.lock);
+}
+
+/**
+ * Send a request and receive its response. Marks the session as disconnected on I/O errors.
+ *
+ * @param session  The session.
+ * @param type     The request type.
+ * @param body     The request body.
+ * @param len      The length of \a body.
+ * @param resp     Return pointer for the allocated response body, may be NULL if not needed.
+ * @param respLen  Return pointer for the length of the response body, may be NULL if not needed.
+ *
+ * @return SAFU_RESULT_OK on success, SAFU_RESULT_FAILED otherwise
+ */
+static safuResultE_t crinitFakeElosRequest(crinitElosSession_t *session, uint8_t type, const void *body, uint32_t len,
+                                           char **resp, uint32_t *respLen) {
+    crinitFakeElosMsgHdr_t hdr;
+    char *respBody;
+    if (session == NULL || !session->connected) {
+        return SAFU_RESULT_FAILED;
+    }
+    if (crinitFakeElosSend(session->fd, type, 0, body, len) == -1 ||
+        crinitFakeElosRecv(session->fd, &hdr, &respBody) == -1) {
+        session->connected = false;
+        return SAFU_RESULT_FAILED;
+    }
+    if (hdr.status != 0) {
+        free(respBody);
+        return SAFU_RESULT_FAILED;
+    }
+    if (respLen != NULL) {
+        *respLen = hdr.len;
+    }
+    if (resp != NULL) {
+        *resp = respBody;
+    } else {
+        free(respBody);
+    }
+    return SAFU_RESULT_OK;
+}
+
+/** Stand-in for elosConnectTcpip(). **/
+static safuResultE_t crinitFakeElosConnect(const char *host, uint16_t port, crinitElosSession_t **session) {
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port)};
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        return SAFU_RESULT_FAILED;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        return SAFU_RESULT_FAILED;
+    }
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(fd);
+        return SAFU_RESULT_FAILED;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    *session = malloc(sizeof(**session));
+    if (*session == NULL) {
+        close(fd);
+        return SAFU_RESULT_FAILED;
+    }
+    (*session)->fd = fd;
+    (*session)->connected = true;
+    return SAFU_RESULT_OK;
+}
+
+/** Stand-in for elosGetVersion(). **/
+static safuResultE_t crinitFakeElosGetVersion(crinitElosSession_t *session, const char **version) {
+    static char versionBuf[32];
+    char *resp = NULL;
+    if (crinitFakeElosRequest(session, CRINIT_FAKE_ELOS_MSG_VERSION, NULL, 0, &resp, NULL) != SAFU_RESULT_OK) {
+        return SAFU_RESULT_FAILED;
+    }
+    snprintf(versionBuf, sizeof(versionBuf), "%s", resp);
+    free(resp);
+    *version = versionBuf;
+    return SAFU_RESULT_OK;
+}
+
+/** Stand-in for elosEventSubscribe(), supports a single filter rule per call as used by crinit. **/
+static safuResultE_t crinitFakeElosSubscribe(crinitElosSession_t *session, const char *filters[], size_t numFilters,
+                                             crinitElosEventQueueId_t *id) {
+    char *resp = NULL;
+    uint32_t respLen = 0;
+    if (numFilters != 1 || crinitFakeElosRequest(session, CRINIT_FAKE_ELOS_MSG_SUBSCRIBE, filters[0],
+                                                 (uint32_t)strlen(filters[0]), &resp, &respLen) != SAFU_RESULT_OK) {
+        return SAFU_RESULT_FAILED;
+    }
+    if (respLen != sizeof(*id)) {
+        free(resp);
+        return SAFU_RESULT_FAILED;
+    }
+    memcpy(id, resp, sizeof(*id));
+    free(resp);
+    return SAFU_RESULT_OK;
+}
+
+/** Stand-in for elosEventUnsubscribe(). **/
+static safuResultE_t crinitFakeElosUnsubscribe(crinitElosSession_t *session, crinitElosEventQueueId_t id) {
+    return crinitFakeElosRequest(session, CRINIT_FAKE_ELOS_MSG_UNSUBSCRIBE, &id, sizeof(id), NULL, NULL);
+}
+
+/** Stand-in for elosEventQueueRead(). **/
+static safuResultE_t crinitFakeElosQueueRead(crinitElosSession_t *session, crinitElosEventQueueId_t id,
+                                             crinitElosEventVector_t **vector) {
+    char *resp = NULL;
+    uint32_t respLen = 0;
+    *vector = NULL;
+    if (crinitFakeElosRequest(session, CRINIT_FAKE_ELOS_MSG_READ, &id, sizeof(id), &resp, &respLen) !=
+        SAFU_RESULT_OK) {
+        return SAFU_RESULT_FAILED;
+    }
+
+    // Every event consists of three strings.
+    uint32_t numStrings = 0;
+    for (uint32_t i = 0; i < respLen; i++) {
+        numStrings += (resp[i] == '\0');
+    }
+    crinitElosEventVector_t *v = calloc(1, sizeof(*v));
+    if (v == NULL) {
+        free(resp);
+        return SAFU_RESULT_FAILED;
+    }
+    v->elementSize = sizeof(crinitElosEvent_t);
+    v->elementCount = numStrings / 3;
+    v->memorySize = v->elementCount * v->elementSize;
+    v->data = calloc((v->elementCount > 0) ? v->elementCount : 1, v->elementSize);
+    if (v->data == NULL) {
+        free(v);
+        free(resp);
+        return SAFU_RESULT_FAILED;
+    }
+    crinitElosEvent_t *events = v->data;
+    const char *p = resp;
+    for (uint32_t i = 0; i < v->elementCount; i++) {
+        events[i].messageCode = (crinitElosEventMessageCodeE_t)strtol(p, NULL, 10);
+        p += strlen(p) + 1;
+        events[i].source.appName = strdup(p);
+        p += strlen(p) + 1;
+        events[i].payload = strdup(p);
+        p += strlen(p) + 1;
+    }
+    free(resp);
+    *vector = v;
+    return SAFU_RESULT_OK;
+}
+
+/** Stand-in for safuVecGetLast(). **/
+static void *crinitFakeElosVecGetLast(const crinitElosEventVector_t *vector) {
+    if (vector == NULL || vector->elementCount == 0) {
+        return NULL;
+    }
+    return (char *)vector->data + (vector->elementCount - 1) * vector->elementSize;
+}
+
+/** Stand-in for elosEventVectorDelete(). **/
+static void crinitFakeElosVectorDelete(crinitElosEventVector_t *vector) {
+    if (vector == NULL) {
+        return;
+    }
+    crinitElosEvent_t *events = vector->data;
+    for (uint32_t i = 0; i < vector->elementCount; i++) {
+        free(events[i].source.appName);
+        free(events[i].payload);
+    }
+    free(vector->data);
+    free(vector);
+}
+
+/** Stand-in for elosEventPublish(). **/
+static safuResultE_t crinitFakeElosPublish(crinitElosSession_t *session, const crinitElosEvent_t *event) {
+    const char *appName = (event->source.appName != NULL) ? event->source.appName : "";
+    const char *payload = (event->payload != NULL) ? event->payload : "";
+    size_t len = (size_t)snprintf(NULL, 0, "%d", (int)event->messageCode) + strlen(appName) + strlen(payload) + 3;
+    char *body = malloc(len);
+    if (body == NULL) {
+        return SAFU_RESULT_FAILED;
+    }
+    int n = snprintf(body, len, "%d", (int)event->messageCode) + 1;
+    memcpy(body + n, appName, strlen(appName) + 1);
+    memcpy(body + n + strlen(appName) + 1, payload, strlen(payload) + 1);
+    safuResultE_t res = crinitFakeElosRequest(session, CRINIT_FAKE_ELOS_MSG_PUBLISH, body, (uint32_t)len, NULL, NULL);
+    free(body);
+    return res;
+}
+
+/** Stand-in for elosDisconnect(), the session itself is left to the caller as crinit keeps using the pointer. **/
+static safuResultE_t crinitFakeElosDisconnect(crinitElosSession_t *session) {
+    if (session != NULL && session->connected) {
+        close(session->fd);
+        session->connected = false;
+    }
+    return SAFU_RESULT_OK;
+}
+
+void crinitFakeElosInstall(uint16_t port) {
+    crinitElosVirtualTable_t *vt = crinitElosGetVTable();
+    vt->elosServer = "127.0.0.1";
+    vt->elosPort = port;
+    vt->connect = crinitFakeElosConnect;
+    vt->getVersion = crinitFakeElosGetVersion;
+    vt->eventSubscribe = crinitFakeElosSubscribe;
+    vt->eventUnsubscribe = crinitFakeElosUnsubscribe;
+    vt->eventQueueRead = crinitFakeElosQueueRead;
+    vt->eventVecGetLast = crinitFakeElosVecGetLast;
+    vt->eventVectorDelete = crinitFakeElosVectorDelete;
+    vt->eventPublish = crinitFakeElosPublish;
+    vt->disconnect = crinitFakeElosDisconnect;
+}
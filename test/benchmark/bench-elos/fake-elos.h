@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file fake-elos.h
+ * @brief Header related to a minimal stand-in for elosd and libelos.
+ *
+ * The fake daemon listens on a loopback TCP port and serves the requests crinit uses: version, subscribe, unsubscribe,
+ * reading an event queue and publishing an event. The client side mirrors the libelos functions in
+ * crinitElosVirtualTable_t and is installed into the elos vtable by crinitFakeElosInstall(), so elosdep and eloslog run
+ * unchanged against it.
+ *
+ * The wire format is not the one of elosd, but every call still takes one request/response round trip over its own
+ * connection. Like elosd, the fake daemon never pushes events, clients need to read their event queues.
+ *
+ * Filter rules support a single comparison of the forms `.event.payload '<text>' STRCMP`,
+ * `.event.source.appName '<text>' STRCMP` and `.event.messageCode <code> EQ`.
+ */
+#ifndef __FAKE_ELOS_H__
+#define __FAKE_ELOS_H__
+
+#include <stdint.h>
+
+#include "elos-common.h"
+
+/** Maximum number of events kept in an event queue, the oldest event is dropped on overflow. **/
+#define CRINIT_FAKE_ELOS_QUEUE_LIMIT 256
+
+/**
+ * Counters of the fake daemon.
+ */
+typedef struct crinitFakeElosStats {
+    uint64_t requests;       ///< Number of requests served.
+    uint64_t reads;          ///< Number of event queue reads.
+    uint64_t published;      ///< Number of published events.
+    uint64_t queued;         ///< Number of events put into an event queue.
+    uint64_t subscriptions;  ///< Number of currently active subscriptions.
+} crinitFakeElosStats_t;
+
+/**
+ * Start the fake daemon on an ephemeral loopback port.
+ *
+ * @param port  Return pointer for the port the daemon listens on.
+ *
+ * @return 0 on success, -1 on error
+ */
+int crinitFakeElosdStart(uint16_t *port);
+/**
+ * Get the counters of the fake daemon.
+ *
+ * @param stats  Return pointer for the counters.
+ */
+void crinitFakeElosdGetStats(crinitFakeElosStats_t *stats);
+/**
+ * Point the elos vtable of crinit to the fake client functions.
+ *
+ * Needs to be called before the elos features of crinit are activated, crinitElosInit() keeps an initialized vtable.
+ *
+ * @param port  The port of the fake daemon on 127.0.0.1.
+ */
+void crinitFakeElosInstall(uint16_t port);
+
+#endif /* __FAKE_ELOS_H__ */
@@ -0,0 +1,378 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file bench-logio.c
+ * @brief Benchmark of the logging overhead during parallel task spawns.
+ *
+ * Several threads emulate dispatch threads starting tasks. Each simulated spawn logs the lines Crinit typically prints
+ * while starting a task (debug output is enabled), every few spawns an error with errno is logged as well. Between the
+ * log lines, the thread sleeps for #CRINIT_BENCH_SPAWN_US to account for the time a spawn really takes. The time spent
+ * in the logging functions is measured per thread.
+ *
+ * Every run is done with the log output going to `/dev/null` and to a pipe drained at a fixed rate emulating a slow
+ * console, first with synchronous logging and then after switching to asynchronous logging with crinitLogAsyncStart().
+ * For asynchronous logging, the time crinitLogFlush() needs afterwards and the counters of crinitLogGetStats() are
+ * printed as well.
+ *
+ * Finally, with DEBUG switched off, the cost of the debug prints of a spawn is compared between crinitDbgInfoPrint()
+ * and the former approach of reading the DEBUG global option through crinitGlobOptGet() in every call.
+ *
+ * Usage: `bench-logio [THREADS [SPAWNS [RECORDS [BYTES_PER_SEC]]]]`, defaults are #CRINIT_BENCH_DEFAULT_THREADS,
+ * #CRINIT_BENCH_DEFAULT_SPAWNS spawns per thread, #CRINIT_BENCH_DEFAULT_RECORDS records for the asynchronous log
+ * buffer, and a console speed of #CRINIT_BENCH_DEFAULT_RATE bytes per second.
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "globopt.h"
+#include "logio.h"
+
+/** Default number of threads spawning tasks in parallel. **/
+#define CRINIT_BENCH_DEFAULT_THREADS 8
+/** Default number of simulated spawns per thread. **/
+#define CRINIT_BENCH_DEFAULT_SPAWNS 250
+/** Default number of records in the asynchronous log buffer. **/
+#define CRINIT_BENCH_DEFAULT_RECORDS 1024
+/** Default speed of the emulated console in bytes per second. **/
+#define CRINIT_BENCH_DEFAULT_RATE (1024 * 1024)
+/** Time in microseconds a simulated spawn takes besides logging, i.e. for fork() and exec(). **/
+#define CRINIT_BENCH_SPAWN_US 100
+/** An error message with errno is logged every this many spawns. **/
+#define CRINIT_BENCH_ERROR_EVERY 50
+/** Number of debug prints per simulated spawn when comparing the costs of disabled debug output. **/
+#define CRINIT_BENCH_DBG_PER_SPAWN 24
+/** Number of nanoseconds in a second. **/
+#define CRINIT_BENCH_NS_PER_SEC 1000000000LL
+
+/** Parameters and results of a thread simulating task spawns. **/
+typedef struct crinitBenchWorker {
+    pthread_t thread;  ///< The thread.
+    int id;            ///< Number of the thread, used in the task names.
+    size_t spawns;     ///< Number of spawns to simulate.
+    size_t calls;      ///< Number of calls to the logging functions.
+    long long sumNs;   ///< Time spent in the logging functions, in nanoseconds.
+    long long maxNs;   ///< Longest time spent logging for a single spawn, in nanoseconds.
+} crinitBenchWorker_t;
+
+/** The emulated slow console, a pipe read at a limited rate. **/
+typedef struct crinitBenchConsole {
+    int fds[2];            ///< The pipe.
+    FILE *stream;          ///< Stream on the write end of the pipe.
+    pthread_t reader;      ///< Thread reading from the pipe.
+    long long rate;        ///< Bytes per second read from the pipe.
+} crinitBenchConsole_t;
+
+/**
+ * Get the current time of `CLOCK_MONOTONIC` in nanoseconds.
+ */
+static long long crinitBenchNowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * CRINIT_BENCH_NS_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * Thread function reading the emulated console at its rate until the write end is closed.
+ */
+static void *crinitBenchConsoleReader(void *arg) {
+    crinitBenchConsole_t *con = arg;
+    char buf[4096];
+    long long start = crinitBenchNowNs();
+    long long total = 0;
+    ssize_t n;
+    while ((n = read(con->fds[0], buf, sizeof(buf))) > 0 || (n == -1 && errno == EINTR)) {
+        if (n <= 0) {
+            continue;
+        }
+        total += n;
+        long long dueNs = start + total * CRINIT_BENCH_NS_PER_SEC / con->rate;
+        long long nowNs = crinitBenchNowNs();
+        if (dueNs > nowNs) {
+            struct timespec ts = {.tv_sec = (dueNs - nowNs) / CRINIT_BENCH_NS_PER_SEC,
+                                  .tv_nsec = (dueNs - nowNs) % CRINIT_BENCH_NS_PER_SEC};
+            nanosleep(&ts, NULL);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Open the emulated console and start reading from it.
+ */
+static int crinitBenchConsoleOpen(crinitBenchConsole_t *con, long long rate) {
+    con->rate = rate;
+    if (pipe(con->fds) == -1) {
+        perror("pipe");
+        return -1;
+    }
+    con->stream = fdopen(con->fds[1], "w");
+    if (con->stream == NULL) {
+        perror("fdopen");
+        close(con->fds[0]);
+        close(con->fds[1]);
+        return -1;
+    }
+    setvbuf(con->stream, NULL, _IOLBF, 0);
+    if (pthread_create(&con->reader, NULL, crinitBenchConsoleReader, con) != 0) {
+        fprintf(stderr, "Could not start console reader thread.\n");
+        fclose(con->stream);
+        close(con->fds[0]);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Close the emulated console after the reader has consumed everything written to it.
+ */
+static void crinitBenchConsoleClose(crinitBenchConsole_t *con) {
+    fclose(con->stream);
+    pthread_join(con->reader, NULL);
+    close(con->fds[0]);
+}
+
+/**
+ * Thread function simulating task spawns and the log output they cause.
+ */
+static void *crinitBenchWorkerFn(void *arg) {
+    crinitBenchWorker_t *w = arg;
+    char name[32];
+    for (size_t i = 0; i < w->spawns; i++) {
+        snprintf(name, sizeof(name), "task-%d-%zu", w->id, i);
+        long long t0 = crinitBenchNowNs();
+        crinitDbgInfoPrint("Task \'%s\' is ready to start, all dependencies are fulfilled.", name);
+        crinitInfoPrint("Started task \'%s\' command 0 (PID %d).", name, 1000 + (int)i);
+        crinitDbgInfoPrint("Task \'%s\' changed its state to RUNNING.", name);
+        w->calls += 3;
+        long long t1 = crinitBenchNowNs();
+        usleep(CRINIT_BENCH_SPAWN_US);
+        t0 += crinitBenchNowNs() - t1;
+        if (i % CRINIT_BENCH_ERROR_EVERY == 0) {
+            errno = ENOENT;
+            crinitErrnoPrint("Could not open the working directory of task \'%s\'.", name);
+            w->calls++;
+        }
+        crinitInfoPrint("Command 0 of task \'%s\' (PID %d) returned 0.", name, 1000 + (int)i);
+        w->calls++;
+        long long d = crinitBenchNowNs() - t0;
+        w->sumNs += d;
+        if (d > w->maxNs) {
+            w->maxNs = d;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Former implementation of crinitDbgInfoPrint(), reading the DEBUG global option on every call.
+ */
+__attribute__((format(printf, 1, 2))) static void crinitBenchDbgFormer(const char *format, ...) {
+    bool globOptDbg = false;
+    if (crinitGlobOptGet(CRINIT_GLOBOPT_DEBUG, &globOptDbg) == -1 || !globOptDbg) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+/**
+ * Thread function issuing the debug prints of simulated spawns with DEBUG switched off.
+ *
+ * Uses crinitBenchDbgFormer() if crinitBenchWorker_t::id is odd and crinitDbgInfoPrint() otherwise.
+ */
+static void *crinitBenchDbgWorkerFn(void *arg) {
+    crinitBenchWorker_t *w = arg;
+    char name[32];
+    long long t0 = crinitBenchNowNs();
+    for (size_t i = 0; i < w->spawns; i++) {
+        snprintf(name, sizeof(name), "task-%d-%zu", w->id, i);
+        for (int j = 0; j < CRINIT_BENCH_DBG_PER_SPAWN; j++) {
+            if (w->id % 2) {
+                crinitBenchDbgFormer("Task \'%s\' step %d of spawn %zu.", name, j, i);
+            } else {
+                crinitDbgInfoPrint("Task \'%s\' step %d of spawn %zu.", name, j, i);
+            }
+        }
+        w->calls += CRINIT_BENCH_DBG_PER_SPAWN;
+    }
+    w->sumNs = crinitBenchNowNs() - t0;
+    return NULL;
+}
+
+/**
+ * Compare the costs of disabled debug prints, running the former and the current implementation on half of the threads
+ * each.
+ */
+static int crinitBenchRunDbgOff(size_t threads, size_t spawns) {
+    threads = (threads < 2) ? 2 : threads;
+    crinitBenchWorker_t *workers = calloc(threads, sizeof(*workers));
+    if (workers == NULL) {
+        perror("calloc");
+        return -1;
+    }
+    if (crinitGlobOptSet(CRINIT_GLOBOPT_DEBUG, false) == -1) {
+        free(workers);
+        return -1;
+    }
+    size_t started = 0;
+    for (; started < threads; started++) {
+        workers[started].id = (int)started;
+        workers[started].spawns = spawns * 10;
+        if (pthread_create(&workers[started].thread, NULL, crinitBenchDbgWorkerFn, &workers[started]) != 0) {
+            fprintf(stderr, "Could not start worker thread.\n");
+            break;
+        }
+    }
+    size_t calls[2] = {0};
+    long long sumNs[2] = {0};
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+        calls[i % 2] += workers[i].calls;
+        sumNs[i % 2] += workers[i].sumNs;
+    }
+    free(workers);
+    crinitGlobOptSet(CRINIT_GLOBOPT_DEBUG, true);
+
+    for (int k = 1; k >= 0; k--) {
+        printf("%-24s %7zu calls, %8.1f ns/call, %8.0f ns/spawn\n",
+               k ? "debug off, former check:" : "debug off, cached flag:", calls[k],
+               calls[k] ? (double)sumNs[k] / (double)calls[k] : 0.0,
+               calls[k] ? (double)sumNs[k] * CRINIT_BENCH_DBG_PER_SPAWN / (double)calls[k] : 0.0);
+    }
+    return (started == threads) ? 0 : -1;
+}
+
+/**
+ * Run the simulated spawns on all threads and print the results.
+ */
+static int crinitBenchRun(const char *label, size_t threads, size_t spawns, bool async) {
+    crinitBenchWorker_t *workers = calloc(threads, sizeof(*workers));
+    if (workers == NULL) {
+        perror("calloc");
+        return -1;
+    }
+    crinitLogStats_t before, after;
+    crinitLogGetStats(&before);
+
+    long long start = crinitBenchNowNs();
+    size_t started = 0;
+    for (; started < threads; started++) {
+        workers[started].id = (int)started;
+        workers[started].spawns = spawns;
+        if (pthread_create(&workers[started].thread, NULL, crinitBenchWorkerFn, &workers[started]) != 0) {
+            fprintf(stderr, "Could not start worker thread.\n");
+            break;
+        }
+    }
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    long long spawnedNs = crinitBenchNowNs() - start;
+    crinitLogFlush();
+    long long flushNs = crinitBenchNowNs() - start - spawnedNs;
+    crinitLogGetStats(&after);
+
+    size_t calls = 0;
+    long long sumNs = 0, maxNs = 0;
+    for (size_t i = 0; i < started; i++) {
+        calls += workers[i].calls;
+        sumNs += workers[i].sumNs;
+        if (workers[i].maxNs > maxNs) {
+            maxNs = workers[i].maxNs;
+        }
+    }
+    free(workers);
+
+    printf("%-24s %7zu calls, %8.0f ns/call, max %8.3f ms/spawn, spawns done after %8.3f ms", label, calls,
+           calls ? (double)sumNs / (double)calls : 0.0, (double)maxNs / 1e6, (double)spawnedNs / 1e6);
+    if (async) {
+        printf(", flushed after another %8.3f ms, %llu dropped, %llu direct",
+               (double)flushNs / 1e6, (unsigned long long)(after.dropped - before.dropped),
+               (unsigned long long)(after.direct - before.direct));
+    }
+    printf("\n");
+    return (started == threads) ? 0 : -1;
+}
+
+/**
+ * Run the simulated spawns against `/dev/null` and against the emulated console.
+ */
+static int crinitBenchRunAll(const char *mode, FILE *devNull, size_t threads, size_t spawns, long long rate,
+                             bool async) {
+    char label[64];
+    crinitSetInfoStream(devNull);
+    crinitSetErrStream(devNull);
+    snprintf(label, sizeof(label), "%s, /dev/null:", mode);
+    if (crinitBenchRun(label, threads, spawns, async) == -1) {
+        return -1;
+    }
+
+    crinitBenchConsole_t con;
+    if (crinitBenchConsoleOpen(&con, rate) == -1) {
+        return -1;
+    }
+    crinitSetInfoStream(con.stream);
+    crinitSetErrStream(con.stream);
+    snprintf(label, sizeof(label), "%s, console:", mode);
+    int ret = crinitBenchRun(label, threads, spawns, async);
+    crinitLogFlush();
+    crinitSetInfoStream(devNull);
+    crinitSetErrStream(devNull);
+    crinitBenchConsoleClose(&con);
+    return ret;
+}
+
+int main(int argc, char *argv[]) {
+    size_t threads = (argc > 1) ? strtoul(argv[1], NULL, 10) : CRINIT_BENCH_DEFAULT_THREADS;
+    size_t spawns = (argc > 2) ? strtoul(argv[2], NULL, 10) : CRINIT_BENCH_DEFAULT_SPAWNS;
+    size_t records = (argc > 3) ? strtoul(argv[3], NULL, 10) : CRINIT_BENCH_DEFAULT_RECORDS;
+    long long rate = (argc > 4) ? strtoll(argv[4], NULL, 10) : CRINIT_BENCH_DEFAULT_RATE;
+    if (threads == 0 || spawns == 0 || rate <= 0) {
+        fprintf(stderr, "Usage: %s [THREADS [SPAWNS [RECORDS [BYTES_PER_SEC]]]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (crinitGlobOptInitDefault() == -1 || crinitGlobOptSet(CRINIT_GLOBOPT_DEBUG, true) == -1) {
+        fprintf(stderr, "Could not initialize global options.\n");
+        return EXIT_FAILURE;
+    }
+    FILE *devNull = fopen("/dev/null", "w");
+    if (devNull == NULL) {
+        perror("fopen");
+        return EXIT_FAILURE;
+    }
+    setvbuf(devNull, NULL, _IOLBF, 0);
+
+    printf("%zu threads, %zu spawns each, %zu async log records, console at %lld bytes/s\n", threads, spawns, records,
+           rate);
+    int ret = crinitBenchRunAll("sync", devNull, threads, spawns, rate, false);
+    if (ret == 0) {
+        crinitSetInfoStream(devNull);
+        crinitSetErrStream(devNull);
+        if (crinitLogAsyncStart(records) == -1) {
+            fprintf(stderr, "Could not start asynchronous logging.\n");
+            ret = -1;
+        }
+    }
+    if (ret == 0) {
+        ret = crinitBenchRunAll("async", devNull, threads, spawns, rate, true);
+    }
+    if (ret == 0) {
+        ret = crinitBenchRunDbgOff(threads, spawns);
+    }
+
+    crinitLogFlush();
+    crinitSetInfoStream(NULL);
+    crinitSetErrStream(NULL);
+    fclose(devNull);
+    crinitGlobOptDestroy();
+    return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
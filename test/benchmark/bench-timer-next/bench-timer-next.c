@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file bench-timer-next.c
+ * @brief Microbenchmark of calculating the next expiration of calendar timers.
+ *
+ * Compares crinitTimerNextTimeCompiled() to the legacy iterative implementation (shared with the unit test
+ * `utest-crinit-timer-next-compiled`) for a set of dense and sparse timer definitions, each from the same set of
+ * random start times. Also measures the cost of crinitTimerCompile().
+ *
+ * Usage: `bench-timer-next [ITERATIONS]`, default is #CRINIT_BENCH_DEFAULT_ITERATIONS.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "common.h"
+#include "logio.h"
+#include "timer.h"
+
+/** Default number of calculations per timer definition and implementation. **/
+#define CRINIT_BENCH_DEFAULT_ITERATIONS 200000
+/** Number of distinct start times. **/
+#define CRINIT_BENCH_START_TIMES 1024
+/** Number of nanoseconds in a second. **/
+#define CRINIT_BENCH_NS_PER_SEC 1000000000LL
+
+/**
+ * The legacy iterative implementation of crinitTimerNextTime(), see `legacy-timer-next.c` of the unit test.
+ */
+struct timespec crinitLegacyTimerNextTime(struct timespec *last, crinitTimerDef_t *td);
+
+/**
+ * A named timer definition to benchmark.
+ */
+typedef struct crinitBenchTimer {
+    const char *name;      ///< Description printed with the results.
+    crinitTimerDef_t def;  ///< The timer definition.
+} crinitBenchTimer_t;
+
+/** Start times the next expiration is calculated from. **/
+static struct timespec crinitBenchStart[CRINIT_BENCH_START_TIMES];
+/** Sum of all results, printed so the calculations can not be optimized away. **/
+static long long crinitBenchSink;
+
+/**
+ * Get the current time of `CLOCK_MONOTONIC` in nanoseconds.
+ */
+static long long crinitBenchNowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * CRINIT_BENCH_NS_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * Fill in the benchmarked timer definitions, from dense to sparse.
+ *
+ * @return the number of timer definitions
+ */
+static size_t crinitBenchTimers(crinitBenchTimer_t *t) {
+    size_t n = 0;
+    crinitTimerSetDefault(&t[n].def);
+    t[n].name = "every second";
+    t[n].def.hours[1] = 23;
+    t[n].def.minutes[1] = 59;
+    t[n].def.seconds[1] = 59;
+    n++;
+
+    crinitTimerSetDefault(&t[n].def);
+    t[n].name = "daily 03:30";
+    t[n].def.hours[0] = t[n].def.hours[1] = 3;
+    t[n].def.minutes[0] = t[n].def.minutes[1] = 30;
+    n++;
+
+    crinitTimerSetDefault(&t[n].def);
+    t[n].name = "Mon..Fri 08..17:15";
+    t[n].def.wDay = 0x1f;
+    t[n].def.hours[0] = 8;
+    t[n].def.hours[1] = 17;
+    t[n].def.minutes[0] = t[n].def.minutes[1] = 15;
+    n++;
+
+    crinitTimerSetDefault(&t[n].def);
+    t[n].name = "31st of a month";
+    t[n].def.days[0] = t[n].def.days[1] = 31;
+    n++;
+
+    crinitTimerSetDefault(&t[n].def);
+    t[n].name = "Sun in Nov..Feb 23:59:59 +0530";
+    t[n].def.wDay = 0x40;
+    t[n].def.month[0] = 11;
+    t[n].def.month[1] = 2;
+    t[n].def.hours[0] = t[n].def.hours[1] = 23;
+    t[n].def.minutes[0] = t[n].def.minutes[1] = 59;
+    t[n].def.seconds[0] = t[n].def.seconds[1] = 59;
+    t[n].def.timezone[0] = 5;
+    t[n].def.timezone[1] = 30;
+    n++;
+
+    crinitTimerSetDefault(&t[n].def);
+    t[n].name = "Mon Feb 29";
+    t[n].def.wDay = 0x01;
+    t[n].def.month[0] = t[n].def.month[1] = 2;
+    t[n].def.days[0] = t[n].def.days[1] = 29;
+    n++;
+    return n;
+}
+
+int main(int argc, char *argv[]) {
+    size_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 10) : CRINIT_BENCH_DEFAULT_ITERATIONS;
+    if (iterations == 0) {
+        fprintf(stderr, "Usage: %s [ITERATIONS]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    // The legacy implementation reports every timer it can not find a next time for.
+    crinitSetErrStream(fopen("/dev/null", "w"));
+
+    srand(1);
+    for (size_t i = 0; i < CRINIT_BENCH_START_TIMES; i++) {
+        crinitBenchStart[i].tv_sec = (time_t)(rand() % 2000000000);
+    }
+
+    crinitBenchTimer_t timers[8];
+    size_t numTimers = crinitBenchTimers(timers);
+
+    printf("%-32s %12s %12s %12s %8s\n", "timer", "compile ns", "compiled ns", "legacy ns", "speedup");
+    for (size_t i = 0; i < numTimers; i++) {
+        crinitTimerCompiled_t tc;
+        long long start = crinitBenchNowNs();
+        for (size_t j = 0; j < iterations; j++) {
+            crinitTimerCompile(&timers[i].def, &tc);
+            crinitBenchSink += tc.tzOffset;
+        }
+        long long compileNs = crinitBenchNowNs() - start;
+
+        start = crinitBenchNowNs();
+        for (size_t j = 0; j < iterations; j++) {
+            crinitBenchSink += crinitTimerNextTimeCompiled(&crinitBenchStart[j % CRINIT_BENCH_START_TIMES], &tc).tv_sec;
+        }
+        long long compiledNs = crinitBenchNowNs() - start;
+
+        start = crinitBenchNowNs();
+        for (size_t j = 0; j < iterations; j++) {
+            crinitBenchSink +=
+                crinitLegacyTimerNextTime(&crinitBenchStart[j % CRINIT_BENCH_START_TIMES], &timers[i].def).tv_sec;
+        }
+        long long legacyNs = crinitBenchNowNs() - start;
+
+        printf("%-32s %12.1f %12.1f %12.1f %7.1fx\n", timers[i].name, (double)compileNs / (double)iterations,
+               (double)compiledNs / (double)iterations, (double)legacyNs / (double)iterations,
+               (double)legacyNs / (double)compiledNs);
+    }
+    printf("(checksum %lld)\n", crinitBenchSink);
+    return EXIT_SUCCESS;
+}
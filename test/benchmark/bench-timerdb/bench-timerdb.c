@@ -0,0 +1,342 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file bench-timerdb.c
+ * @brief Benchmark of the TimerDB with thousands of timers.
+ *
+ * Measures the cost of adding calendar timers, the number of file descriptors the TimerDB needs, how long it takes to
+ * dispatch a tick in which all timers expire at once, and how precisely respawn timers expire. For comparison, the
+ * dispatch of the same tick is also measured for the former design of one polled timerfd per timer.
+ *
+ * The TaskDB is replaced by stubs only counting the calls. The wakeup counters of the TimerDB are printed to show the
+ * effect of the TIMER_SLACK_MS global option.
+ *
+ * Usage: `bench-timerdb [NUM_TIMERS [SLACK_MS]]`, default is #CRINIT_BENCH_DEFAULT_TIMERS and no slack.
+ */
+#include <dirent.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "globopt.h"
+#include "logio.h"
+#include "taskdb.h"
+#include "timerdb.h"
+
+/** Default number of timers. **/
+#define CRINIT_BENCH_DEFAULT_TIMERS 5000
+/** Number of ticks in which all calendar timers expire to measure. **/
+#define CRINIT_BENCH_TICKS 3
+/** Time in microseconds given to a tick to finish before looking at the results. **/
+#define CRINIT_BENCH_SETTLE_US 500000
+/** Respawn timers are spread evenly over this many milliseconds. **/
+#define CRINIT_BENCH_RESPAWN_SPREAD_MS 1000
+/** Number of distinct start years used to make the timer strings unique. **/
+#define CRINIT_BENCH_YEARS 2000
+/** Number of distinct timezones used to make the timer strings unique. **/
+#define CRINIT_BENCH_TIMEZONES 15
+/** Number of nanoseconds in a second. **/
+#define CRINIT_BENCH_NS_PER_SEC 1000000000LL
+/** Number of seconds to count wakeups for timers spread over the seconds of a minute. **/
+#define CRINIT_BENCH_SPREAD_SECS 10
+
+/** Number of dependencies fulfilled using crinitTaskDBFulfillDeps() so far. **/
+static atomic_size_t crinitBenchFulfilled;
+/** Latest call to crinitTaskDBFulfillDeps() relative to the full second of `CLOCK_REALTIME`, in nanoseconds. **/
+static atomic_llong crinitBenchTickMaxNs;
+/** Number of calls to crinitTaskDBReleaseRespawn() so far. **/
+static atomic_size_t crinitBenchReleased;
+/** Sum of the delays of all respawn timers, in nanoseconds. **/
+static atomic_llong crinitBenchLatenessSumNs;
+/** Maximum delay of a respawn timer, in nanoseconds. **/
+static atomic_llong crinitBenchLatenessMaxNs;
+/** Expected expiration times of the respawn timers on `CLOCK_MONOTONIC`, in nanoseconds, indexed by name. **/
+static long long *crinitBenchRespawnDueNs;
+
+/**
+ * Get the current time of a clock in nanoseconds.
+ */
+static long long crinitBenchNowNs(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (long long)ts.tv_sec * CRINIT_BENCH_NS_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * Count the open file descriptors of the process.
+ */
+static size_t crinitBenchCountFds(void) {
+    size_t n = 0;
+    DIR *d = opendir("/proc/self/fd");
+    if (d == NULL) {
+        return 0;
+    }
+    while (readdir(d) != NULL) {
+        n++;
+    }
+    closedir(d);
+    // '.', '..' and the directory stream itself.
+    return (n >= 3) ? n - 3 : 0;
+}
+
+/**
+ * Build the definition of a calendar timer, made distinct by its range of years and its timezone.
+ *
+ * @param buf     Buffer for the definition.
+ * @param size    Size of \a buf.
+ * @param i       Number of the timer.
+ * @param spread  Expire once a minute on second `i % 60` instead of every second.
+ */
+static void crinitBenchTimerStr(char *buf, size_t size, size_t i, bool spread) {
+    char seconds[8] = "00..59";
+    if (spread) {
+        snprintf(seconds, sizeof(seconds), "%02zu", i % 60);
+    }
+    snprintf(buf, size, "Mon..Sun-%zu..65535-1..12-1..31-00..23:00..59:%s+%02zu00", i % CRINIT_BENCH_YEARS, seconds,
+             (i / CRINIT_BENCH_YEARS) % CRINIT_BENCH_TIMEZONES);
+}
+
+/**
+ * Sleep until shortly after the next full second of the realtime clock.
+ */
+static void crinitBenchSleepToNextSecond(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec++;
+    ts.tv_nsec = 0;
+    clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &ts, NULL);
+}
+
+/**
+ * Stub replacing the TaskDB, counts fulfilled `@timer` dependencies.
+ */
+int crinitTaskDBFulfillDeps(crinitTaskDB_t *ctx, const crinitTaskDep_t *deps, size_t numDeps) {
+    CRINIT_PARAM_UNUSED(ctx);
+    CRINIT_PARAM_UNUSED(deps);
+    // All timers expire at a full second, so this is how long the tick has taken so far.
+    long long tick = crinitBenchNowNs(CLOCK_REALTIME) % CRINIT_BENCH_NS_PER_SEC;
+    long long max = atomic_load(&crinitBenchTickMaxNs);
+    while (tick > max && !atomic_compare_exchange_weak(&crinitBenchTickMaxNs, &max, tick)) {
+    }
+    atomic_fetch_add(&crinitBenchFulfilled, numDeps);
+    return 0;
+}
+
+/**
+ * Stub replacing the TaskDB, records how late a respawn timer has expired.
+ */
+int crinitTaskDBReleaseRespawn(crinitTaskDB_t *ctx, const char *taskName) {
+    CRINIT_PARAM_UNUSED(ctx);
+    long long late = crinitBenchNowNs(CLOCK_MONOTONIC) - crinitBenchRespawnDueNs[strtoul(taskName, NULL, 10)];
+    atomic_fetch_add(&crinitBenchLatenessSumNs, late);
+    long long max = atomic_load(&crinitBenchLatenessMaxNs);
+    while (late > max && !atomic_compare_exchange_weak(&crinitBenchLatenessMaxNs, &max, late)) {
+    }
+    atomic_fetch_add(&crinitBenchReleased, 1);
+    return 0;
+}
+
+/**
+ * Stub replacing the TaskDB, the benchmark does not use `@timer:after:` timers.
+ */
+int crinitTaskDBRemoveDepFromTask(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, const char *taskName) {
+    CRINIT_PARAM_UNUSED(ctx);
+    CRINIT_PARAM_UNUSED(dep);
+    CRINIT_PARAM_UNUSED(taskName);
+    return 0;
+}
+
+/**
+ * Measure a tick in which all timers expire for the former design of one timerfd per timer.
+ *
+ * @param numTimers  The number of timers.
+ *
+ * @return the average time to dispatch a tick in nanoseconds, or -1 if not enough file descriptors are available
+ */
+static long long crinitBenchLegacyTick(size_t numTimers) {
+    struct pollfd *pfds = calloc(numTimers, sizeof(*pfds));
+    if (pfds == NULL) {
+        return -1;
+    }
+    size_t opened = 0;
+    for (; opened < numTimers; opened++) {
+        pfds[opened].fd = timerfd_create(CLOCK_REALTIME, 0);
+        pfds[opened].events = POLLIN;
+        if (pfds[opened].fd == -1) {
+            break;
+        }
+    }
+    long long total = -1;
+    if (opened == numTimers) {
+        total = 0;
+        for (size_t tick = 0; tick < CRINIT_BENCH_TICKS; tick++) {
+            struct itimerspec its = {0};
+            clock_gettime(CLOCK_REALTIME, &its.it_value);
+            its.it_value.tv_sec++;
+            its.it_value.tv_nsec = 0;
+            for (size_t i = 0; i < numTimers; i++) {
+                timerfd_settime(pfds[i].fd, TFD_TIMER_ABSTIME, &its, NULL);
+            }
+            crinitBenchSleepToNextSecond();
+            long long start = crinitBenchNowNs(CLOCK_REALTIME);
+            // One poll() and one scan of the whole list, then read and re-arm each expired timer.
+            poll(pfds, numTimers, -1);
+            for (size_t i = 0; i < numTimers; i++) {
+                if (pfds[i].revents & POLLIN) {
+                    uint64_t u;
+                    if (read(pfds[i].fd, &u, sizeof(u)) == sizeof(u)) {
+                        its.it_value.tv_sec++;
+                        timerfd_settime(pfds[i].fd, TFD_TIMER_ABSTIME, &its, NULL);
+                        its.it_value.tv_sec--;
+                    }
+                }
+            }
+            total += crinitBenchNowNs(CLOCK_REALTIME) - start;
+        }
+        total /= CRINIT_BENCH_TICKS;
+    }
+    for (size_t i = 0; i < opened; i++) {
+        close(pfds[i].fd);
+    }
+    free(pfds);
+    return total;
+}
+
+int main(int argc, char *argv[]) {
+    size_t numTimers = (argc > 1) ? strtoul(argv[1], NULL, 10) : CRINIT_BENCH_DEFAULT_TIMERS;
+    unsigned long long slackMs = (argc > 2) ? strtoull(argv[2], NULL, 10) : 0;
+    if (numTimers == 0 || numTimers > CRINIT_BENCH_YEARS * CRINIT_BENCH_TIMEZONES) {
+        fprintf(stderr, "Usage: %s [NUM_TIMERS [SLACK_MS]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    crinitGlobOptSet(CRINIT_GLOBOPT_TIMER_SLACK, slackMs);
+    // Keep the listing of all timers by crinitTimerDBSpawn() out of the results.
+    FILE *devNull = fopen("/dev/null", "w");
+    if (devNull != NULL) {
+        crinitSetInfoStream(devNull);
+    }
+
+    // The legacy comparison needs one fd per timer.
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    crinitTaskDB_t taskDB = {0};
+    size_t fdsBefore = crinitBenchCountFds();
+    if (crinitTimerDBInit(&taskDB) == -1) {
+        fprintf(stderr, "Could not initialize TimerDB.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Timers which expire every second, made distinct by their range of years and their timezone.
+    long long start = crinitBenchNowNs(CLOCK_MONOTONIC);
+    for (size_t i = 0; i < numTimers; i++) {
+        char timerStr[64];
+        crinitBenchTimerStr(timerStr, sizeof(timerStr), i, false);
+        crinitTimerDBAddTimer(timerStr);
+    }
+    long long addNs = crinitBenchNowNs(CLOCK_MONOTONIC) - start;
+    size_t fdsAfter = crinitBenchCountFds();
+
+    printf("timers:                         %zu\n", numTimers);
+    printf("add calendar timer:             %.2f us/timer\n", (double)addNs / (double)numTimers / 1000.0);
+    printf("file descriptors used:          %zu\n", fdsAfter - fdsBefore);
+
+    if (crinitTimerDBSpawn() == -1) {
+        fprintf(stderr, "Could not start timer thread.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Let the timers settle into expiring at the same second first.
+    crinitBenchSleepToNextSecond();
+    crinitBenchSleepToNextSecond();
+    usleep(CRINIT_BENCH_SETTLE_US);
+    atomic_store(&crinitBenchTickMaxNs, 0);
+    size_t fulfilledBefore = atomic_load(&crinitBenchFulfilled);
+    crinitTimerDBStats_t statsBefore, statsAfter;
+    crinitTimerDBGetStats(&statsBefore);
+    for (size_t tick = 0; tick < CRINIT_BENCH_TICKS; tick++) {
+        crinitBenchSleepToNextSecond();
+    }
+    // Give the last tick time to finish.
+    usleep(CRINIT_BENCH_SETTLE_US);
+    printf("expirations per tick:           %zu\n",
+           (atomic_load(&crinitBenchFulfilled) - fulfilledBefore) / CRINIT_BENCH_TICKS);
+    printf("dispatch tick, all expiring:    %.3f ms (worst of %d)\n", (double)atomic_load(&crinitBenchTickMaxNs) / 1e6,
+           CRINIT_BENCH_TICKS);
+    crinitTimerDBGetStats(&statsAfter);
+    printf("timer slack:                    %llu ms\n", slackMs);
+    printf("wakeups/batches per tick:       %.1f / %.1f\n",
+           (double)(statsAfter.wakeups - statsBefore.wakeups) / CRINIT_BENCH_TICKS,
+           (double)(statsAfter.batches - statsBefore.batches) / CRINIT_BENCH_TICKS);
+
+    // Replace the timers by ones expiring once a minute, each on one of the seconds.
+    for (size_t i = 0; i < numTimers; i++) {
+        char timerStr[64];
+        crinitBenchTimerStr(timerStr, sizeof(timerStr), i, false);
+        crinitTimerDBRemoveTimer(timerStr);
+        crinitBenchTimerStr(timerStr, sizeof(timerStr), i, true);
+        crinitTimerDBAddTimer(timerStr);
+    }
+    // Re-arming an `@timer` dependency of a task, as on every exit of the task, only references the existing timer.
+    start = crinitBenchNowNs(CLOCK_MONOTONIC);
+    for (size_t i = 0; i < numTimers; i++) {
+        char timerStr[64];
+        crinitBenchTimerStr(timerStr, sizeof(timerStr), i, true);
+        crinitTimerDBAddTimer(timerStr);
+        crinitTimerDBRemoveTimer(timerStr);
+    }
+    long long rearmNs = crinitBenchNowNs(CLOCK_MONOTONIC) - start;
+    printf("re-arm existing timer:          %.2f us/timer\n", (double)rearmNs / (double)numTimers / 1000.0);
+
+    crinitTimerDBGetStats(&statsBefore);
+    sleep(CRINIT_BENCH_SPREAD_SECS);
+    crinitTimerDBGetStats(&statsAfter);
+    printf("spread over a minute, %ds:      %" PRIu64 " wakeups, %" PRIu64 " expirations\n", CRINIT_BENCH_SPREAD_SECS,
+           statsAfter.wakeups - statsBefore.wakeups, statsAfter.expirations - statsBefore.expirations);
+
+    crinitBenchRespawnDueNs = calloc(numTimers, sizeof(*crinitBenchRespawnDueNs));
+    if (crinitBenchRespawnDueNs == NULL) {
+        fprintf(stderr, "Could not allocate memory.\n");
+        return EXIT_FAILURE;
+    }
+    start = crinitBenchNowNs(CLOCK_MONOTONIC);
+    for (size_t i = 0; i < numTimers; i++) {
+        char name[32];
+        uint32_t delayMs = (uint32_t)(i * CRINIT_BENCH_RESPAWN_SPREAD_MS / numTimers);
+        snprintf(name, sizeof(name), "%zu", i);
+        crinitBenchRespawnDueNs[i] = crinitBenchNowNs(CLOCK_MONOTONIC) + (long long)delayMs * 1000000LL;
+        crinitTimerDBAddRespawnTimer(name, delayMs);
+    }
+    addNs = crinitBenchNowNs(CLOCK_MONOTONIC) - start;
+    while (atomic_load(&crinitBenchReleased) < numTimers) {
+        usleep(10000);
+    }
+    printf("add respawn timer:              %.2f us/timer\n", (double)addNs / (double)numTimers / 1000.0);
+    printf("respawn timer lateness avg/max: %.3f ms / %.3f ms\n",
+           (double)atomic_load(&crinitBenchLatenessSumNs) / (double)numTimers / 1e6,
+           (double)atomic_load(&crinitBenchLatenessMaxNs) / 1e6);
+
+    long long legacyNs = crinitBenchLegacyTick(numTimers);
+    if (legacyNs < 0) {
+        printf("legacy timerfd per timer tick:  skipped, not enough file descriptors\n");
+    } else {
+        printf("legacy timerfd per timer tick:  %.3f ms\n", (double)legacyNs / 1e6);
+    }
+
+    free(crinitBenchRespawnDueNs);
+    if (devNull != NULL) {
+        crinitSetInfoStream(stdout);
+        fclose(devNull);
+    }
+    return EXIT_SUCCESS;
+}
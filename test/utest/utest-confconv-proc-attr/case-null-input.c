@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for the conversion functions of process attributes, handling of NULL pointer input.
+ */
+
+#include "common.h"
+#include "confconv.h"
+#include "unit_test.h"
+#include "utest-confconv-proc-attr.h"
+
+void crinitConfConvProcAttrTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitProcAttr_t pa;
+    int val;
+    struct rlimit rlim;
+
+    assert_int_equal(crinitConfConvToCpuSet(NULL, "0"), -1);
+    assert_int_equal(crinitConfConvToCpuSet(&pa, NULL), -1);
+    assert_int_equal(crinitConfConvToSchedPolicy(NULL, "FIFO"), -1);
+    assert_int_equal(crinitConfConvToSchedPolicy(&val, NULL), -1);
+    assert_int_equal(crinitConfConvToIoPrio(NULL, "IDLE"), -1);
+    assert_int_equal(crinitConfConvToIoPrio(&val, NULL), -1);
+    assert_int_equal(crinitConfConvToRlimit(NULL, &rlim, "CORE 0"), -1);
+    assert_int_equal(crinitConfConvToRlimit(&val, NULL, "CORE 0"), -1);
+    assert_int_equal(crinitConfConvToRlimit(&val, &rlim, NULL), -1);
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for the conversion functions of process attributes, successful execution.
+ */
+
+#include <sched.h>
+#include <string.h>
+
+#include "common.h"
+#include "confconv.h"
+#include "unit_test.h"
+#include "utest-confconv-proc-attr.h"
+
+void crinitConfConvProcAttrTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitProcAttr_t pa;
+    memset(&pa, 0, sizeof(pa));
+    assert_int_equal(crinitConfConvToCpuSet(&pa, "0-2,5 7"), 0);
+    for (size_t cpu = 0; cpu < CRINIT_PROC_ATTR_MAX_CPUS; cpu++) {
+        bool expected = cpu <= 2 || cpu == 5 || cpu == 7;
+        assert_int_equal(crinitProcAttrCpuIsSet(&pa, cpu), expected);
+    }
+    assert_int_equal(crinitConfConvToCpuSet(&pa, "1023"), 0);
+    assert_true(crinitProcAttrCpuIsSet(&pa, 1023));
+    assert_false(crinitProcAttrCpuIsSet(&pa, 0));
+
+    int policy = -1;
+    assert_int_equal(crinitConfConvToSchedPolicy(&policy, "FIFO"), 0);
+    assert_int_equal(policy, SCHED_FIFO);
+    assert_int_equal(crinitConfConvToSchedPolicy(&policy, "rr"), 0);
+    assert_int_equal(policy, SCHED_RR);
+    assert_int_equal(crinitConfConvToSchedPolicy(&policy, "Other"), 0);
+    assert_int_equal(policy, SCHED_OTHER);
+
+    int ioprio = -1;
+    assert_int_equal(crinitConfConvToIoPrio(&ioprio, "BEST_EFFORT"), 0);
+    assert_int_equal(ioprio, CRINIT_IOPRIO_VALUE(CRINIT_IOPRIO_CLASS_BE, CRINIT_IOPRIO_LEVEL_DEFAULT));
+    assert_int_equal(crinitConfConvToIoPrio(&ioprio, "realtime 0"), 0);
+    assert_int_equal(ioprio, CRINIT_IOPRIO_VALUE(CRINIT_IOPRIO_CLASS_RT, 0));
+    assert_int_equal(crinitConfConvToIoPrio(&ioprio, "IDLE"), 0);
+    assert_int_equal(ioprio, CRINIT_IOPRIO_VALUE(CRINIT_IOPRIO_CLASS_IDLE, 0));
+
+    int resource = -1;
+    struct rlimit rlim = {0, 0};
+    assert_int_equal(crinitConfConvToRlimit(&resource, &rlim, "NOFILE 1024 4096"), 0);
+    assert_int_equal(resource, RLIMIT_NOFILE);
+    assert_int_equal(rlim.rlim_cur, 1024);
+    assert_int_equal(rlim.rlim_max, 4096);
+    assert_int_equal(crinitConfConvToRlimit(&resource, &rlim, "core infinity"), 0);
+    assert_int_equal(resource, RLIMIT_CORE);
+    assert_true(rlim.rlim_cur == RLIM_INFINITY);
+    assert_true(rlim.rlim_max == RLIM_INFINITY);
+    assert_int_equal(crinitConfConvToRlimit(&resource, &rlim, "STACK 8388608"), 0);
+    assert_int_equal(resource, RLIMIT_STACK);
+    assert_int_equal(rlim.rlim_cur, 8388608);
+    assert_int_equal(rlim.rlim_max, 8388608);
+}
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-wrong-input.c
+ * @brief Unit test for the conversion functions of process attributes, handling of invalid string input.
+ */
+
+#include <string.h>
+
+#include "common.h"
+#include "confconv.h"
+#include "unit_test.h"
+#include "utest-confconv-proc-attr.h"
+
+void crinitConfConvProcAttrTestWrongInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitProcAttr_t pa;
+    memset(&pa, 0, sizeof(pa));
+    assert_int_equal(crinitConfConvToCpuSet(&pa, ""), -1);
+    assert_int_equal(crinitConfConvToCpuSet(&pa, "3-1"), -1);
+    assert_int_equal(crinitConfConvToCpuSet(&pa, "1-"), -1);
+    assert_int_equal(crinitConfConvToCpuSet(&pa, "-1"), -1);
+    assert_int_equal(crinitConfConvToCpuSet(&pa, "1024"), -1);
+    assert_int_equal(crinitConfConvToCpuSet(&pa, "zero"), -1);
+
+    int policy = -1;
+    assert_int_equal(crinitConfConvToSchedPolicy(&policy, "DEADLINE"), -1);
+    assert_int_equal(crinitConfConvToSchedPolicy(&policy, ""), -1);
+
+    int ioprio = -1;
+    assert_int_equal(crinitConfConvToIoPrio(&ioprio, "FAST"), -1);
+    assert_int_equal(crinitConfConvToIoPrio(&ioprio, "BEST_EFFORT 8"), -1);
+    assert_int_equal(crinitConfConvToIoPrio(&ioprio, "BEST_EFFORT -1"), -1);
+    assert_int_equal(crinitConfConvToIoPrio(&ioprio, "IDLE 3"), -1);
+    assert_int_equal(crinitConfConvToIoPrio(&ioprio, "REALTIME 1 2"), -1);
+
+    int resource = -1;
+    struct rlimit rlim = {0, 0};
+    assert_int_equal(crinitConfConvToRlimit(&resource, &rlim, "FOO 1"), -1);
+    assert_int_equal(crinitConfConvToRlimit(&resource, &rlim, "NOFILE"), -1);
+    assert_int_equal(crinitConfConvToRlimit(&resource, &rlim, "NOFILE -1"), -1);
+    assert_int_equal(crinitConfConvToRlimit(&resource, &rlim, "NOFILE 10 5"), -1);
+    assert_int_equal(crinitConfConvToRlimit(&resource, &rlim, "NOFILE 1 2 3"), -1);
+}
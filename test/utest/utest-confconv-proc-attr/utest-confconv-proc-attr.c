@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-confconv-proc-attr.c
+ * @brief Implementation of the unit test group for the conversion functions of process attributes.
+ */
+
+#include "utest-confconv-proc-attr.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitConfConvToCpuSet(), crinitConfConvToSchedPolicy(), crinitConfConvToIoPrio(), and
+ * crinitConfConvToRlimit() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitConfConvProcAttrTestSuccess),
+        cmocka_unit_test(crinitConfConvProcAttrTestWrongInput),
+        cmocka_unit_test(crinitConfConvProcAttrTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-confconv-proc-attr.h
+ * @brief Header declaring the unit tests for the conversion functions of process attributes.
+ */
+#ifndef __UTEST_CONFCONV_PROC_ATTR_H__
+#define __UTEST_CONFCONV_PROC_ATTR_H__
+
+/**
+ * Tests successful parsing of CPU lists, scheduling policies, I/O priorities, and resource limits.
+ */
+void crinitConfConvProcAttrTestSuccess(void **state);
+/**
+ * Tests unsuccessful parsing of CPU lists, scheduling policies, I/O priorities, and resource limits due to invalid
+ * syntax or values.
+ */
+void crinitConfConvProcAttrTestWrongInput(void **state);
+/**
+ * Tests detection of NULL pointer input.
+ */
+void crinitConfConvProcAttrTestNullInput(void **state);
+
+#endif /* __UTEST_CONFCONV_PROC_ATTR_H__ */
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-invalid-input.c
+ * @brief Unit test for crinitCfgAsyncLogRecordsHandler(), handling of invalid and out-of-range input.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common.h"
+#include "confhdl.h"
+#include "globopt.h"
+#include "logio.h"
+#include "unit_test.h"
+#include "utest-crinit-cfg-async-log-records-handler.h"
+
+void crinitCfgAsyncLogRecordsHandlerTestInvalidInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    const char *val = "this_is_not_a_number";
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitCfgAsyncLogRecordsHandler(NULL, val, CRINIT_CONFIG_TYPE_SERIES), -1);
+
+    char tooLarge[20];
+    snprintf(tooLarge, 20, "%d", CRINIT_LOG_ASYNC_RECORDS_MAX + 1);
+    assert_int_equal(crinitCfgAsyncLogRecordsHandler(NULL, tooLarge, CRINIT_CONFIG_TYPE_SERIES), -1);
+    crinitGlobOptDestroy();
+}
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitCfgAsyncLogRecordsHandler(), successful execution.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "confhdl.h"
+#include "globopt.h"
+#include "unit_test.h"
+#include "utest-crinit-cfg-async-log-records-handler.h"
+
+#define CONFIGURED_RECORDS 1024
+
+void crinitCfgAsyncLogRecordsHandlerTestRuntimeSettingSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    unsigned long long records = 0;
+    char val[20];
+    snprintf(val, 20, "%d", CONFIGURED_RECORDS);
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitCfgAsyncLogRecordsHandler(NULL, val, CRINIT_CONFIG_TYPE_SERIES), 0);
+    assert_int_equal(crinitGlobOptGet(CRINIT_GLOBOPT_ASYNC_LOG_RECORDS, &records), 0);
+    assert_int_equal(CONFIGURED_RECORDS, records);
+    crinitGlobOptDestroy();
+}
+
+void crinitCfgAsyncLogRecordsDefaultValue(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    unsigned long long records = 0;
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitGlobOptGet(CRINIT_GLOBOPT_ASYNC_LOG_RECORDS, &records), 0);
+    assert_int_equal(CRINIT_CONFIG_DEFAULT_ASYNC_LOG_RECORDS, records);
+    crinitGlobOptDestroy();
+}
@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-cfg-async-log-records-handler.c
+ * @brief Implementation of the crinitCfgAsyncLogRecordsHandler() unit test group.
+ */
+
+#include "utest-crinit-cfg-async-log-records-handler.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitCfgAsyncLogRecordsHandler() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitCfgAsyncLogRecordsHandlerTestRuntimeSettingSuccess),
+        cmocka_unit_test(crinitCfgAsyncLogRecordsDefaultValue),
+        cmocka_unit_test(crinitCfgAsyncLogRecordsHandlerTestInvalidInput),
+        cmocka_unit_test(crinitCfgAsyncLogRecordsHandlerTestNullInput),
+        cmocka_unit_test(crinitCfgAsyncLogRecordsHandlerTestEmptyInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-cfg-async-log-records-handler.h
+ * @brief Header declaring the unit tests for crinitCfgAsyncLogRecordsHandler().
+ */
+#ifndef __UTEST_CFG_ASYNC_LOG_RECORDS_HANDLER_H__
+#define __UTEST_CFG_ASYNC_LOG_RECORDS_HANDLER_H__
+
+/**
+ * Tests successful parsing of a number of log records.
+ */
+void crinitCfgAsyncLogRecordsHandlerTestRuntimeSettingSuccess(void **state);
+/**
+ * Tests default value.
+ */
+void crinitCfgAsyncLogRecordsDefaultValue(void **state);
+/**
+ * Tests unsuccessful parsing of an invalid or too large input value.
+ */
+void crinitCfgAsyncLogRecordsHandlerTestInvalidInput(void **state);
+/**
+ * Tests detection of NULL pointer input.
+ */
+void crinitCfgAsyncLogRecordsHandlerTestNullInput(void **state);
+/**
+ * Tests handling of empty value part.
+ */
+void crinitCfgAsyncLogRecordsHandlerTestEmptyInput(void **state);
+#endif /* __UTEST_CFG_ASYNC_LOG_RECORDS_HANDLER_H__ */
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitCfgTimerSlackHandler(), successful execution.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "confhdl.h"
+#include "globopt.h"
+#include "unit_test.h"
+#include "utest-crinit-cfg-timer-slack-handler.h"
+
+#define CONFIGURED_SLACK 5000
+
+void crinitCfgTimerSlackHandlerTestRuntimeSettingSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    unsigned long long slackMs = 0;
+    char val[20];
+    snprintf(val, 20, "%d", CONFIGURED_SLACK);
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitCfgTimerSlackHandler(NULL, val, CRINIT_CONFIG_TYPE_SERIES), 0);
+    assert_int_equal(crinitGlobOptGet(CRINIT_GLOBOPT_TIMER_SLACK, &slackMs), 0);
+    assert_int_equal(CONFIGURED_SLACK, slackMs);
+    crinitGlobOptDestroy();
+}
+
+void crinitCfgTimerSlackDefaultValue(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    unsigned long long slackMs = 0;
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitGlobOptGet(CRINIT_GLOBOPT_TIMER_SLACK, &slackMs), 0);
+    assert_int_equal(CRINIT_CONFIG_DEFAULT_TIMER_SLACK, slackMs);
+    crinitGlobOptDestroy();
+}
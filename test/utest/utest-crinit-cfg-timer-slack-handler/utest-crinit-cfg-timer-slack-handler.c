@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-cfg-timer-slack-handler.c
+ * @brief Implementation of the crinitCfgTimerSlackHandler() unit test group.
+ */
+
+#include "utest-crinit-cfg-timer-slack-handler.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitCfgTimerSlackHandler() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitCfgTimerSlackHandlerTestRuntimeSettingSuccess),
+        cmocka_unit_test(crinitCfgTimerSlackDefaultValue),
+        cmocka_unit_test(crinitCfgTimerSlackHandlerTestInvalidInput),
+        cmocka_unit_test(crinitCfgTimerSlackHandlerTestNullInput),
+        cmocka_unit_test(crinitCfgTimerSlackHandlerTestEmptyInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
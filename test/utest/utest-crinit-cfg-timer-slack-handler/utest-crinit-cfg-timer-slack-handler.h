@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-cfg-timer-slack-handler.h
+ * @brief Header declaring the unit tests for crinitCfgTimerSlackHandler().
+ */
+#ifndef __UTEST_CFG_TIMER_SLACK_HANDLER_H__
+#define __UTEST_CFG_TIMER_SLACK_HANDLER_H__
+
+/**
+ * Tests successful parsing of a slack in milliseconds.
+ */
+void crinitCfgTimerSlackHandlerTestRuntimeSettingSuccess(void **state);
+/**
+ * Tests default value.
+ */
+void crinitCfgTimerSlackDefaultValue(void **state);
+/**
+ * Tests unsuccessful parsing of an invalid input value.
+ */
+void crinitCfgTimerSlackHandlerTestInvalidInput(void **state);
+/**
+ * Tests detection of NULL pointer input.
+ */
+void crinitCfgTimerSlackHandlerTestNullInput(void **state);
+/**
+ * Tests handling of empty value part.
+ */
+void crinitCfgTimerSlackHandlerTestEmptyInput(void **state);
+#endif /* __UTEST_CFG_TIMER_SLACK_HANDLER_H__ */
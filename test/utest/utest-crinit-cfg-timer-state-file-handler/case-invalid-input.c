@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-invalid-input.c
+ * @brief Unit test for crinitCfgTimerStateFileHandler(), handling of invalid input.
+ */
+
+#include "common.h"
+#include "confhdl.h"
+#include "globopt.h"
+#include "unit_test.h"
+#include "utest-crinit-cfg-timer-state-file-handler.h"
+
+void crinitCfgTimerStateFileHandlerTestInvalidInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char *stateFile = "unchanged";
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitCfgTimerStateFileHandler(NULL, "var/lib/crinit/timers", CRINIT_CONFIG_TYPE_SERIES), -1);
+    assert_int_equal(crinitCfgTimerStateFileHandler(NULL, "", CRINIT_CONFIG_TYPE_SERIES), -1);
+    assert_int_equal(crinitCfgTimerStateFileHandler(NULL, "/var/lib/crinit/timers", CRINIT_CONFIG_TYPE_TASK), -1);
+    assert_int_equal(crinitGlobOptGet(CRINIT_GLOBOPT_TIMER_STATE_FILE, &stateFile), 0);
+    assert_null(stateFile);
+    crinitGlobOptDestroy();
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitCfgTimerStateFileHandler(), successful execution.
+ */
+
+#include <stdlib.h>
+
+#include "common.h"
+#include "confhdl.h"
+#include "globopt.h"
+#include "unit_test.h"
+#include "utest-crinit-cfg-timer-state-file-handler.h"
+
+void crinitCfgTimerStateFileHandlerTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char *stateFile = NULL;
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitCfgTimerStateFileHandler(NULL, "/var/lib/crinit/timers", CRINIT_CONFIG_TYPE_SERIES), 0);
+    assert_int_equal(crinitGlobOptGet(CRINIT_GLOBOPT_TIMER_STATE_FILE, &stateFile), 0);
+    assert_string_equal(stateFile, "/var/lib/crinit/timers");
+    free(stateFile);
+    crinitGlobOptDestroy();
+}
+
+void crinitCfgTimerStateFileDefaultValue(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char *stateFile = "unchanged";
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitGlobOptGet(CRINIT_GLOBOPT_TIMER_STATE_FILE, &stateFile), 0);
+    assert_null(stateFile);
+    crinitGlobOptDestroy();
+}
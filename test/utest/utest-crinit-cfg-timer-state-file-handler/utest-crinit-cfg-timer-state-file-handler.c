@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-cfg-timer-state-file-handler.c
+ * @brief Implementation of the crinitCfgTimerStateFileHandler() unit test group.
+ */
+
+#include "utest-crinit-cfg-timer-state-file-handler.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitCfgTimerStateFileHandler() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitCfgTimerStateFileHandlerTestSuccess),
+        cmocka_unit_test(crinitCfgTimerStateFileDefaultValue),
+        cmocka_unit_test(crinitCfgTimerStateFileHandlerTestInvalidInput),
+        cmocka_unit_test(crinitCfgTimerStateFileHandlerTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
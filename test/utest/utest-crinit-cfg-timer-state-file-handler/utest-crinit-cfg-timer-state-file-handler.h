@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-cfg-timer-state-file-handler.h
+ * @brief Header declaring the unit tests for crinitCfgTimerStateFileHandler().
+ */
+#ifndef __UTEST_CFG_TIMER_STATE_FILE_HANDLER_H__
+#define __UTEST_CFG_TIMER_STATE_FILE_HANDLER_H__
+
+/**
+ * Tests successful setting of an absolute path.
+ */
+void crinitCfgTimerStateFileHandlerTestSuccess(void **state);
+/**
+ * Tests default value.
+ */
+void crinitCfgTimerStateFileDefaultValue(void **state);
+/**
+ * Tests rejection of relative paths and empty input.
+ */
+void crinitCfgTimerStateFileHandlerTestInvalidInput(void **state);
+/**
+ * Tests detection of NULL pointer input.
+ */
+void crinitCfgTimerStateFileHandlerTestNullInput(void **state);
+#endif /* __UTEST_CFG_TIMER_STATE_FILE_HANDLER_H__ */
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitLockProfRead(), NULL pointer input.
+ */
+
+#include "common.h"
+#include "lockprof.h"
+#include "unit_test.h"
+#include "utest-crinit-lock-prof-read.h"
+
+void crinitLockProfReadTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    assert_int_equal(crinitLockProfRead(NULL, CRINIT_LOCKPROF_SAMPLES), 0);
+}
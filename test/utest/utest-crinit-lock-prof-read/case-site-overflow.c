@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-site-overflow.c
+ * @brief Unit test for crinitLockProfRead(), more call sites than can be recorded.
+ */
+
+#include <pthread.h>
+
+#include "common.h"
+#include "lockprof.h"
+#include "unit_test.h"
+#include "utest-crinit-lock-prof-read.h"
+
+void crinitLockProfReadTestSiteOverflow(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    static const char *const sites[CRINIT_LOCKPROF_SITES + 2] = {
+        "/src/dir/first.c:1", "a.c:2", "a.c:3", "a.c:4", "a.c:5", "a.c:6", "a.c:7", "a.c:8", "a.c:9", "a.c:10"};
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    for (size_t i = 0; i < CRINIT_LOCKPROF_SITES + 2; i++) {
+        assert_int_equal(crinitLockProfLock(&mutex, CRINIT_LOCK_LOG, sites[i]), 0);
+        assert_int_equal(crinitLockProfUnlock(&mutex, CRINIT_LOCK_LOG), 0);
+    }
+
+    // The lock from the previous test comes first, then this one with all of its call sites.
+    crinitMetricSample_t samples[CRINIT_LOCKPROF_SAMPLES];
+    size_t numSites = 2 + CRINIT_LOCKPROF_SITES;
+    assert_int_equal(crinitLockProfRead(samples, CRINIT_LOCKPROF_SAMPLES), 4 + numSites * CRINIT_LOCKPROF_SITE_METRICS);
+    assert_string_equal(samples[1].labels, "lock=\"log\"");
+    assert_string_equal(samples[3].labels, "lock=\"log\"");
+
+    const crinitMetricSample_t *first = &samples[4 + 2];
+    assert_string_equal(first->name, "crinit_lock_site_acquisitions_total");
+    assert_string_equal(first->labels, "lock=\"log\",site=\"first.c:1\"");
+    assert_int_equal(first->value, 1);
+
+    // The last recorded site collects all sites which did not fit.
+    const crinitMetricSample_t *other = &samples[4 + numSites - 1];
+    assert_string_equal(other->name, "crinit_lock_site_acquisitions_total");
+    assert_string_equal(other->labels, "lock=\"log\",site=\"(other)\"");
+    assert_int_equal(other->value, 3);
+}
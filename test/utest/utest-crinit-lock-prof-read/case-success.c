@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitLockProfRead(), successful execution.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+
+#include "common.h"
+#include "lockprof.h"
+#include "unit_test.h"
+#include "utest-crinit-lock-prof-read.h"
+
+/**
+ * Get the number of observations of a histogram sample.
+ *
+ * @param s  The histogram sample.
+ *
+ * @return  The sum of all buckets of \a s.
+ */
+static uint64_t crinitHistoCount(const crinitMetricSample_t *s) {
+    uint64_t count = 0;
+    for (size_t i = 0; i < CRINIT_METRIC_BUCKETS; i++) {
+        count += s->buckets[i];
+    }
+    return count;
+}
+
+void crinitLockProfReadTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+    const struct timespec past = {0, 0};
+
+    // Two acquisitions at the first call site, the second one splits its hold by waiting on a condition variable.
+    for (int i = 0; i < 2; i++) {
+        assert_int_equal(crinitMutexLock(&mutex, CRINIT_LOCK_TASKDB), 0);
+        if (i == 1) {
+            assert_int_equal(crinitMutexCondTimedWait(&cond, &mutex, &past, CRINIT_LOCK_TASKDB), ETIMEDOUT);
+        }
+        assert_int_equal(crinitMutexUnlock(&mutex, CRINIT_LOCK_TASKDB), 0);
+    }
+    // One acquisition at the second call site.
+    assert_int_equal(crinitMutexLock(&mutex, CRINIT_LOCK_TASKDB), 0);
+    assert_int_equal(crinitMutexUnlock(&mutex, CRINIT_LOCK_TASKDB), 0);
+
+    // The wait and hold histograms of the lock followed by the counters of the two call sites, grouped by name.
+    crinitMetricSample_t samples[CRINIT_LOCKPROF_SAMPLES];
+    assert_int_equal(crinitLockProfRead(samples, CRINIT_LOCKPROF_SAMPLES), 2 + 2 * CRINIT_LOCKPROF_SITE_METRICS);
+
+    assert_string_equal(samples[0].name, "crinit_lock_wait_seconds");
+    assert_string_equal(samples[0].labels, "lock=\"taskdb\"");
+    assert_int_equal(samples[0].type, CRINIT_METRIC_HISTOGRAM);
+    assert_int_equal(crinitHistoCount(&samples[0]), 3);
+    assert_string_equal(samples[1].name, "crinit_lock_hold_seconds");
+    assert_string_equal(samples[1].labels, "lock=\"taskdb\"");
+    assert_int_equal(crinitHistoCount(&samples[1]), 4);
+
+    static const char *const siteNames[CRINIT_LOCKPROF_SITE_METRICS] = {
+        "crinit_lock_site_acquisitions_total", "crinit_lock_site_contentions_total",
+        "crinit_lock_site_wait_nanoseconds_total", "crinit_lock_site_hold_nanoseconds_total"};
+    for (size_t i = 0; i < CRINIT_LOCKPROF_SITE_METRICS; i++) {
+        for (size_t j = 0; j < 2; j++) {
+            const crinitMetricSample_t *s = &samples[2 + 2 * i + j];
+            assert_string_equal(s->name, siteNames[i]);
+            assert_int_equal(s->type, CRINIT_METRIC_COUNTER);
+            assert_true(strncmp(s->labels, "lock=\"taskdb\",site=\"case-success.c:", 35) == 0);
+        }
+    }
+    assert_string_not_equal(samples[2].labels, samples[3].labels);
+    assert_int_equal(samples[2].value, 2);
+    assert_int_equal(samples[3].value, 1);
+    assert_int_equal(samples[4].value, 0);
+    assert_int_equal(samples[5].value, 0);
+
+    // Only as many samples as requested.
+    assert_int_equal(crinitLockProfRead(samples, 1), 1);
+    assert_int_equal(crinitLockProfRead(samples, 0), 0);
+}
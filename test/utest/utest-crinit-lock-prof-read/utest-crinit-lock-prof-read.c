@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-lock-prof-read.c
+ * @brief Implementation of the crinitLockProfRead() unit test group.
+ */
+
+#include "utest-crinit-lock-prof-read.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitLockProfRead() using the cmocka API.
+ *
+ * The tests share the statistics of the lock profiler and need to run in this order.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitLockProfReadTestSuccess),
+        cmocka_unit_test(crinitLockProfReadTestSiteOverflow),
+        cmocka_unit_test(crinitLockProfReadTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
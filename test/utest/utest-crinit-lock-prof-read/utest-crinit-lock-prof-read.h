@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-lock-prof-read.h
+ * @brief Header declaring the unit tests for crinitLockProfRead().
+ */
+#ifndef __UTEST_CRINIT_LOCK_PROF_READ_H__
+#define __UTEST_CRINIT_LOCK_PROF_READ_H__
+
+/**
+ * Tests reading back the wait and hold times of a lock and its call sites.
+ */
+void crinitLockProfReadTestSuccess(void **state);
+/**
+ * Tests accounting of call sites beyond #CRINIT_LOCKPROF_SITES.
+ */
+void crinitLockProfReadTestSiteOverflow(void **state);
+/**
+ * Tests detection of NULL pointer input.
+ */
+void crinitLockProfReadTestNullInput(void **state);
+
+#endif /* __UTEST_CRINIT_LOCK_PROF_READ_H__ */
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-ipc.c
+ * @brief Unit test for crinitMetricsRead(), IPC request latency per command.
+ */
+
+#include "common.h"
+#include "metrics.h"
+#include "unit_test.h"
+#include "utest-crinit-metrics-read.h"
+
+void crinitMetricsReadTestIpc(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitMetricsObserveIpc(CRINIT_RTIMCMD_C_STATUS, 3000);
+    crinitMetricsObserveIpc(CRINIT_RTIMCMD_R_STATUS, 4000);
+    crinitMetricsObserveIpc(CRINIT_RTIMCMD_C_ADDTASK, 1);
+    crinitMetricsObserveIpc((crinitRtimOp_t)(2 * CRINIT_RTIMCMD_NUM_CMDS), 1);
+
+    crinitMetricSample_t samples[CRINIT_METRICS_SAMPLES];
+    assert_int_equal(crinitMetricsRead(samples, CRINIT_METRICS_SAMPLES), CRINIT_METRICS_SAMPLES);
+
+    const crinitMetricSample_t *ipc = &samples[CRINIT_METRIC_HISTOS];
+    for (size_t i = 0; i < CRINIT_RTIMCMD_NUM_CMDS; i++) {
+        assert_string_equal(ipc[i].name, "crinit_ipc_request_seconds");
+        assert_int_equal(ipc[i].type, CRINIT_METRIC_HISTOGRAM);
+    }
+
+    const crinitMetricSample_t *add = &ipc[CRINIT_RTIMCMD_C_ADDTASK / 2];
+    assert_string_equal(add->labels, "opcode=\"ADDTASK\"");
+    assert_int_equal(add->value, 1);
+    assert_int_equal(add->buckets[0], 1);
+
+    const crinitMetricSample_t *status = &ipc[CRINIT_RTIMCMD_C_STATUS / 2];
+    assert_string_equal(status->labels, "opcode=\"STATUS\"");
+    assert_int_equal(status->value, 7000);
+    assert_int_equal(status->buckets[2], 2);
+
+    assert_string_equal(ipc[CRINIT_RTIMCMD_C_STATS / 2].labels, "opcode=\"STATS\"");
+    assert_int_equal(ipc[CRINIT_RTIMCMD_C_STATS / 2].value, 0);
+}
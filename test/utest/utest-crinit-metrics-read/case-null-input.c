@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitMetricsRead(), NULL pointer input.
+ */
+
+#include "common.h"
+#include "metrics.h"
+#include "unit_test.h"
+#include "utest-crinit-metrics-read.h"
+
+void crinitMetricsReadTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    assert_int_equal(crinitMetricsRead(NULL, CRINIT_METRICS_SAMPLES), 0);
+}
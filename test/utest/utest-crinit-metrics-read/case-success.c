@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitMetricsRead(), successful execution.
+ */
+
+#include "common.h"
+#include "metrics.h"
+#include "unit_test.h"
+#include "utest-crinit-metrics-read.h"
+
+void crinitMetricsReadTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    // Bounds are inclusive, everything above the largest bound goes into the last bucket.
+    crinitMetricsObserve(CRINIT_METRIC_SPAWN_LATENCY, 0);
+    crinitMetricsObserve(CRINIT_METRIC_SPAWN_LATENCY, 1000);
+    crinitMetricsObserve(CRINIT_METRIC_SPAWN_LATENCY, 1001);
+    crinitMetricsObserve(CRINIT_METRIC_SPAWN_LATENCY, 10000000000uLL);
+    crinitMetricsObserve(CRINIT_METRIC_SPAWN_LATENCY, 10000000001uLL);
+    crinitMetricsObserve(CRINIT_METRIC_HISTOS, 1000);
+    crinitMetricsCount(CRINIT_METRIC_RESPAWNS);
+    crinitMetricsCount(CRINIT_METRIC_RESPAWNS);
+    crinitMetricsCount(CRINIT_METRIC_COUNTERS);
+
+    crinitMetricSample_t samples[CRINIT_METRICS_SAMPLES];
+    assert_int_equal(crinitMetricsRead(samples, CRINIT_METRICS_SAMPLES), CRINIT_METRICS_SAMPLES);
+
+    const crinitMetricSample_t *h = &samples[CRINIT_METRIC_SPAWN_LATENCY];
+    assert_string_equal(h->name, "crinit_spawn_latency_seconds");
+    assert_null(h->labels);
+    assert_int_equal(h->type, CRINIT_METRIC_HISTOGRAM);
+    assert_int_equal(h->value, 20000002002uLL);
+    assert_int_equal(h->buckets[0], 2);
+    assert_int_equal(h->buckets[1], 1);
+    assert_int_equal(h->buckets[CRINIT_METRIC_BUCKETS - 2], 1);
+    assert_int_equal(h->buckets[CRINIT_METRIC_BUCKETS - 1], 1);
+    for (size_t i = 2; i < CRINIT_METRIC_BUCKETS - 2; i++) {
+        assert_int_equal(h->buckets[i], 0);
+    }
+
+    const crinitMetricSample_t *lw = &samples[CRINIT_METRIC_TASKDB_LOCK_WAIT];
+    assert_string_equal(lw->name, "crinit_taskdb_lock_wait_seconds");
+    assert_int_equal(lw->value, 0);
+
+    const crinitMetricSample_t *c = &samples[CRINIT_METRICS_SAMPLES - CRINIT_METRIC_COUNTERS + CRINIT_METRIC_RESPAWNS];
+    assert_string_equal(c->name, "crinit_respawns_total");
+    assert_int_equal(c->type, CRINIT_METRIC_COUNTER);
+    assert_int_equal(c->value, 2);
+
+    // Only as many samples as requested.
+    assert_int_equal(crinitMetricsRead(samples, 1), 1);
+    assert_int_equal(crinitMetricsRead(samples, 0), 0);
+}
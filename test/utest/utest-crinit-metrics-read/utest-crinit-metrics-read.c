@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-metrics-read.c
+ * @brief Implementation of the crinitMetricsRead() unit test group.
+ */
+
+#include "utest-crinit-metrics-read.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitMetricsRead() using the cmocka API.
+ *
+ * The tests share the metrics registry and need to run in this order.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitMetricsReadTestSuccess),
+        cmocka_unit_test(crinitMetricsReadTestIpc),
+        cmocka_unit_test(crinitMetricsReadTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-metrics-read.h
+ * @brief Header declaring the unit tests for crinitMetricsRead().
+ */
+#ifndef __UTEST_CRINIT_METRICS_READ_H__
+#define __UTEST_CRINIT_METRICS_READ_H__
+
+/**
+ * Tests reading back recorded counters and histogram observations.
+ */
+void crinitMetricsReadTestSuccess(void **state);
+/**
+ * Tests recording of the IPC request latency per command.
+ */
+void crinitMetricsReadTestIpc(void **state);
+/**
+ * Tests detection of NULL pointer input.
+ */
+void crinitMetricsReadTestNullInput(void **state);
+
+#endif /* __UTEST_CRINIT_METRICS_READ_H__ */
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitMountTreeParse(), NULL input.
+ */
+
+#include <stdio.h>
+
+#include "common.h"
+#include "mountinfo.h"
+#include "unit_test.h"
+#include "utest-crinit-mount-tree-parse.h"
+
+void crinitMountTreeParseTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitMountTree_t tree;
+    assert_int_equal(crinitMountTreeParse(&tree, NULL), -1);
+    assert_int_equal(crinitMountTreeParse(NULL, stdin), -1);
+    crinitMountTreeDestroy(NULL);
+}
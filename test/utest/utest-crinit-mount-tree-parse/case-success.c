@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitMountTreeParse(), successful execution.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common.h"
+#include "mountinfo.h"
+#include "unit_test.h"
+#include "utest-crinit-mount-tree-parse.h"
+
+/** Excerpt of a mountinfo file including optional fields, an escaped path, and a mount without its parent. **/
+#define CRINIT_TEST_MOUNTINFO                                                                         \
+    "21 1 0:20 / / ro,relatime shared:1 - ext4 /dev/mmcblk0p2 ro\n"                                   \
+    "22 21 0:21 / /proc rw,nosuid,nodev,noexec,relatime shared:12 - proc proc rw\n"                   \
+    "23 21 0:22 / /data rw,noatime shared:2 master:1 - ext4 /dev/mmcblk0p3 rw,errors=remount-ro\n"    \
+    "24 23 0:23 / /data/my\\040logs rw - tmpfs none rw,size=1024k\n"                                  \
+    "25 99 0:24 / /orphan rw - tmpfs tmpfs rw\n"
+
+void crinitMountTreeParseTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char buf[] = CRINIT_TEST_MOUNTINFO;
+    FILE *stream = fmemopen(buf, strlen(buf), "r");
+    assert_non_null(stream);
+
+    crinitMountTree_t tree;
+    assert_int_equal(crinitMountTreeParse(&tree, stream), 0);
+    fclose(stream);
+    assert_int_equal(tree.numMounts, 5);
+
+    const crinitMountEntry_t *m = tree.mounts;
+    assert_string_equal(m[0].target, "/");
+    assert_string_equal(m[0].fsType, "ext4");
+    assert_string_equal(m[0].source, "/dev/mmcblk0p2");
+    assert_true(m[0].readOnly);
+    assert_int_equal(m[0].parent, CRINIT_MOUNTINFO_NO_PARENT);
+    assert_int_equal(m[0].numChld, 2);
+
+    assert_string_equal(m[1].target, "/proc");
+    assert_false(m[1].readOnly);
+    assert_int_equal(m[1].parent, 0);
+    assert_int_equal(m[1].numChld, 0);
+
+    assert_string_equal(m[2].target, "/data");
+    assert_string_equal(m[2].source, "/dev/mmcblk0p3");
+    assert_int_equal(m[2].parent, 0);
+    assert_int_equal(m[2].numChld, 1);
+
+    assert_string_equal(m[3].target, "/data/my logs");
+    assert_string_equal(m[3].source, "none");
+    assert_int_equal(m[3].parent, 2);
+
+    assert_string_equal(m[4].target, "/orphan");
+    assert_int_equal(m[4].parent, CRINIT_MOUNTINFO_NO_PARENT);
+
+    crinitMountTreeDestroy(&tree);
+    assert_null(tree.mounts);
+    assert_int_equal(tree.numMounts, 0);
+}
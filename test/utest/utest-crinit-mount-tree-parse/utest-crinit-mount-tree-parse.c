@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-mount-tree-parse.c
+ * @brief Implementation of the unit test group for crinitMountTreeParse().
+ */
+
+#include "utest-crinit-mount-tree-parse.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitMountTreeParse() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitMountTreeParseTestSuccess),
+        cmocka_unit_test(crinitMountTreeParseTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-mount-tree-parse.h
+ * @brief Header declaring the unit tests for crinitMountTreeParse().
+ */
+#ifndef __UTEST_MOUNT_TREE_PARSE_H__
+#define __UTEST_MOUNT_TREE_PARSE_H__
+
+/**
+ * Unit test for crinitMountTreeParse(), successful execution on a typical mountinfo file.
+ *
+ * @param state  unused
+ */
+void crinitMountTreeParseTestSuccess(void **state);
+/**
+ * Unit test for crinitMountTreeParse(), handling of NULL input.
+ *
+ * @param state  unused
+ */
+void crinitMountTreeParseTestNullInput(void **state);
+
+#endif /* __UTEST_MOUNT_TREE_PARSE_H__ */
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-cycle.c
+ * @brief Unit test for crinitTaskGraphAnalyze() given a dependency cycle.
+ */
+
+#include "common.h"
+#include "taskgraph.h"
+#include "unit_test.h"
+#include "utest-crinit-task-graph-analyze.h"
+
+void crinitTaskGraphAnalyzeTestCycleSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTaskDep_t depsA[] = {{.name = "c", .event = "wait"}};
+    crinitTaskDep_t depsB[] = {{.name = "a", .event = "wait"}};
+    crinitTaskDep_t depsC[] = {{.name = "b", .event = "wait"}};
+    crinitTask_t tasks[] = {
+        {.name = "a", .deps = depsA, .depsSize = ARRAY_SIZE(depsA)},
+        {.name = "b", .deps = depsB, .depsSize = ARRAY_SIZE(depsB)},
+        {.name = "c", .deps = depsC, .depsSize = ARRAY_SIZE(depsC)},
+    };
+
+    assert_int_equal(crinitTaskGraphAnalyze(tasks, ARRAY_SIZE(tasks)), 0);
+
+    // The cycle is broken at one edge, so the remaining chain covers all three tasks exactly once.
+    size_t maxChain = 0, numCritical = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(tasks); i++) {
+        assert_int_equal(tasks[i].graph.fanOut, 1);
+        assert_in_range(tasks[i].graph.chainLen, 1, 3);
+        assert_in_range(tasks[i].graph.depth, 0, 2);
+        if (tasks[i].graph.chainLen > maxChain) {
+            maxChain = tasks[i].graph.chainLen;
+        }
+        if (tasks[i].graph.critical) {
+            numCritical++;
+        }
+    }
+    assert_int_equal(maxChain, 3);
+    assert_int_equal(numCritical, 3);
+}
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitTaskGraphAnalyze() given NULL or empty input.
+ */
+
+#include "common.h"
+#include "taskgraph.h"
+#include "unit_test.h"
+#include "utest-crinit-task-graph-analyze.h"
+
+void crinitTaskGraphAnalyzeTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTask_t t = {0};
+    assert_int_equal(crinitTaskGraphAnalyze(NULL, 1), -1);
+    assert_int_equal(crinitTaskGraphAnalyze(&t, 0), 0);
+    assert_int_equal(crinitTaskGraphTaskDuration(NULL), 0);
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitTaskGraphAnalyze(), successful execution.
+ */
+
+#include <stdlib.h>
+
+#include "common.h"
+#include "taskgraph.h"
+#include "unit_test.h"
+#include "utest-crinit-task-graph-analyze.h"
+
+void crinitTaskGraphAnalyzeTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    /*
+     * Graph under test (durations in seconds):
+     *
+     *   a (1) --> b (2) --> c (4)
+     *        \
+     *         --> d (1) --@provided:feat--> e (0)
+     *
+     * f (0) has no dependencies and nothing depends on it.
+     */
+    crinitTaskDep_t depsB[] = {{.name = "a", .event = "wait"}};
+    crinitTaskDep_t depsC[] = {{.name = "b", .event = "spawn"}, {.name = "b", .event = "wait"}};
+    crinitTaskDep_t depsD[] = {{.name = "a", .event = "wait"}, {.name = "@ctl", .event = "enable"}};
+    crinitTaskDep_t depsE[] = {{.name = "@provided", .event = "feat"}, {.name = "nonexistent", .event = "wait"}};
+    crinitTaskPrv_t prvD[] = {{.name = "feat", .stateReq = CRINIT_TASK_STATE_DONE}};
+
+    crinitTask_t tasks[] = {
+        {.name = "c",
+         .deps = depsC,
+         .depsSize = ARRAY_SIZE(depsC),
+         .startTime = {.tv_sec = 10},
+         .endTime = {.tv_sec = 14}},
+        {.name = "a", .startTime = {.tv_sec = 10}, .endTime = {.tv_sec = 11}},
+        {.name = "e", .deps = depsE, .depsSize = ARRAY_SIZE(depsE)},
+        {.name = "b",
+         .deps = depsB,
+         .depsSize = ARRAY_SIZE(depsB),
+         .startTime = {.tv_sec = 10},
+         .endTime = {.tv_sec = 12}},
+        {.name = "d",
+         .deps = depsD,
+         .depsSize = ARRAY_SIZE(depsD),
+         .prv = prvD,
+         .prvSize = ARRAY_SIZE(prvD),
+         .startTime = {.tv_sec = 10},
+         .endTime = {.tv_sec = 11}},
+        {.name = "f"},
+    };
+    crinitTask_t *c = &tasks[0], *a = &tasks[1], *e = &tasks[2], *b = &tasks[3], *d = &tasks[4], *f = &tasks[5];
+
+    assert_int_equal(crinitTaskGraphAnalyze(tasks, ARRAY_SIZE(tasks)), 0);
+
+    assert_int_equal(a->graph.depth, 0);
+    assert_int_equal(b->graph.depth, 1);
+    assert_int_equal(c->graph.depth, 2);
+    assert_int_equal(d->graph.depth, 1);
+    assert_int_equal(e->graph.depth, 2);
+    assert_int_equal(f->graph.depth, 0);
+
+    assert_int_equal(a->graph.fanOut, 2);
+    assert_int_equal(b->graph.fanOut, 1);
+    assert_int_equal(c->graph.fanOut, 0);
+    assert_int_equal(d->graph.fanOut, 1);
+    assert_int_equal(e->graph.fanOut, 0);
+
+    assert_int_equal(a->graph.chainLen, 3);
+    assert_int_equal(a->graph.chainNs, 7000000000uLL);
+    assert_int_equal(b->graph.chainNs, 6000000000uLL);
+    assert_int_equal(c->graph.chainNs, 4000000000uLL);
+    assert_int_equal(d->graph.chainLen, 2);
+    assert_int_equal(d->graph.chainNs, 1000000000uLL);
+    assert_int_equal(f->graph.chainLen, 1);
+    assert_int_equal(f->graph.chainNs, 0);
+
+    assert_true(a->graph.critical);
+    assert_true(b->graph.critical);
+    assert_true(c->graph.critical);
+    assert_false(d->graph.critical);
+    assert_false(e->graph.critical);
+    assert_false(f->graph.critical);
+
+    crinitTask_t *order[] = {f, e, d, c, b, a};
+    qsort(order, ARRAY_SIZE(order), sizeof(*order), crinitTaskGraphCmpPriority);
+    assert_ptr_equal(order[0], a);
+    assert_ptr_equal(order[1], b);
+    assert_ptr_equal(order[2], c);
+    assert_ptr_equal(order[3], d);
+}
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-task-graph-analyze.c
+ * @brief Implementation of the crinitTaskGraphAnalyze() unit test group.
+ */
+
+#include "utest-crinit-task-graph-analyze.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitTaskGraphAnalyze() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTaskGraphAnalyzeTestSuccess),
+        cmocka_unit_test(crinitTaskGraphAnalyzeTestCycleSuccess),
+        cmocka_unit_test(crinitTaskGraphAnalyzeTestNullInput),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
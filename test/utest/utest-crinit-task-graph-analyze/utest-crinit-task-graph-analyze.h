@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-task-graph-analyze.h
+ * @brief Header declaring the unit tests for crinitTaskGraphAnalyze().
+ */
+#ifndef __UTEST_TASK_GRAPH_ANALYZE_H__
+#define __UTEST_TASK_GRAPH_ANALYZE_H__
+
+/**
+ * Unit test for crinitTaskGraphAnalyze(), successful execution on a small graph including a PROVIDES dependency.
+ *
+ * @param state  unused
+ */
+void crinitTaskGraphAnalyzeTestSuccess(void **state);
+/**
+ * Unit test for crinitTaskGraphAnalyze(), successful execution on a graph containing a dependency cycle.
+ *
+ * @param state  unused
+ */
+void crinitTaskGraphAnalyzeTestCycleSuccess(void **state);
+/**
+ * Unit test for crinitTaskGraphAnalyze(), handling of NULL and empty input.
+ *
+ * @param state  unused
+ */
+void crinitTaskGraphAnalyzeTestNullInput(void **state);
+
+#endif /* __UTEST_TASK_GRAPH_ANALYZE_H__ */
@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitTaskGraphStopPlan(), NULL and empty input.
+ */
+
+#include "common.h"
+#include "taskgraph.h"
+#include "unit_test.h"
+#include "utest-crinit-task-graph-stop-plan.h"
+
+void crinitTaskGraphStopPlanTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTask_t task = {.name = "a"};
+    crinitTaskGraphStopPlan_t plan;
+
+    assert_int_equal(crinitTaskGraphStopPlan(NULL, &task, 1), -1);
+    assert_int_equal(crinitTaskGraphStopPlan(&plan, NULL, 1), -1);
+
+    assert_int_equal(crinitTaskGraphStopPlan(&plan, &task, 0), 0);
+    assert_int_equal(plan.numTasks, 0);
+    crinitTaskGraphStopPlanDestroy(&plan);
+    crinitTaskGraphStopPlanDestroy(NULL);
+}
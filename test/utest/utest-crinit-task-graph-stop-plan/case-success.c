@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitTaskGraphStopPlan(), successful execution.
+ */
+
+#include "common.h"
+#include "taskgraph.h"
+#include "unit_test.h"
+#include "utest-crinit-task-graph-stop-plan.h"
+
+void crinitTaskGraphStopPlanTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    /*
+     * Graph under test, as loaded:
+     *
+     *   net --> db --> app
+     *      \
+     *       --> dns --@provided:resolv--> app
+     *
+     * The remaining dependencies (crinitTask_t::deps) are all fulfilled and must not matter.
+     */
+    crinitTaskDep_t depsDb[] = {{.name = "net", .event = "wait"}};
+    crinitTaskDep_t depsDns[] = {{.name = "net", .event = "spawn"}, {.name = "@ctl", .event = "enable"}};
+    crinitTaskDep_t depsApp[] = {{.name = "db", .event = "spawn"}, {.name = "@provided", .event = "resolv"}};
+    crinitTaskPrv_t prvDns[] = {{.name = "resolv", .stateReq = CRINIT_TASK_STATE_RUNNING}};
+
+    crinitTask_t tasks[] = {
+        {.name = "app", .cfgDeps = depsApp, .cfgDepsSize = ARRAY_SIZE(depsApp)},
+        {.name = "net"},
+        {.name = "db", .cfgDeps = depsDb, .cfgDepsSize = ARRAY_SIZE(depsDb)},
+        {.name = "dns",
+         .cfgDeps = depsDns,
+         .cfgDepsSize = ARRAY_SIZE(depsDns),
+         .prv = prvDns,
+         .prvSize = ARRAY_SIZE(prvDns)},
+    };
+    const size_t app = 0, net = 1, db = 2, dns = 3;
+
+    crinitTaskGraphStopPlan_t plan;
+    assert_int_equal(crinitTaskGraphStopPlan(&plan, tasks, ARRAY_SIZE(tasks)), 0);
+    assert_int_equal(plan.numTasks, ARRAY_SIZE(tasks));
+
+    // Only the application can be stopped right away, the network goes last.
+    assert_int_equal(plan.waitCount[app], 0);
+    assert_int_equal(plan.waitCount[db], 1);
+    assert_int_equal(plan.waitCount[dns], 1);
+    assert_int_equal(plan.waitCount[net], 2);
+
+    assert_int_equal(plan.depStart[app + 1] - plan.depStart[app], 2);
+    assert_int_equal(plan.depStart[net + 1] - plan.depStart[net], 0);
+    assert_int_equal(plan.depStart[db + 1] - plan.depStart[db], 1);
+    assert_int_equal(plan.depList[plan.depStart[db]], net);
+    assert_int_equal(plan.depStart[dns + 1] - plan.depStart[dns], 1);
+    assert_int_equal(plan.depList[plan.depStart[dns]], net);
+
+    bool appOnDb = false, appOnDns = false;
+    for (size_t d = plan.depStart[app]; d < plan.depStart[app + 1]; d++) {
+        appOnDb |= plan.depList[d] == db;
+        appOnDns |= plan.depList[d] == dns;
+    }
+    assert_true(appOnDb);
+    assert_true(appOnDns);
+
+    crinitTaskGraphStopPlanDestroy(&plan);
+    assert_null(plan.waitCount);
+}
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-task-graph-stop-plan.c
+ * @brief Implementation of the unit test group for crinitTaskGraphStopPlan().
+ */
+
+#include "utest-crinit-task-graph-stop-plan.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitTaskGraphStopPlan() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTaskGraphStopPlanTestSuccess),
+        cmocka_unit_test(crinitTaskGraphStopPlanTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
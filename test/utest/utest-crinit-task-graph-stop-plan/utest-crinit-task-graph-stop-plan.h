@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-task-graph-stop-plan.h
+ * @brief Header declaring the unit tests for crinitTaskGraphStopPlan().
+ */
+#ifndef __UTEST_TASK_GRAPH_STOP_PLAN_H__
+#define __UTEST_TASK_GRAPH_STOP_PLAN_H__
+
+/**
+ * Unit test for crinitTaskGraphStopPlan(), successful execution on a small graph including a PROVIDES dependency.
+ *
+ * @param state  unused
+ */
+void crinitTaskGraphStopPlanTestSuccess(void **state);
+/**
+ * Unit test for crinitTaskGraphStopPlan(), handling of NULL and empty input.
+ *
+ * @param state  unused
+ */
+void crinitTaskGraphStopPlanTestNullInput(void **state);
+
+#endif /* __UTEST_TASK_GRAPH_STOP_PLAN_H__ */
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-disabled.c
+ * @brief Unit test for crinitTaskRespawnBackoff(), backoff disabled.
+ */
+
+#include "common.h"
+#include "task.h"
+#include "unit_test.h"
+#include "utest-crinit-task-respawn-backoff.h"
+
+void crinitTaskRespawnBackoffTestDisabled(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTask_t t = {.respawnDelay = 0, .respawnDelayMax = 30000, .respawnReset = 10000, .backoffLevel = 3};
+
+    for (int i = 0; i < 3; i++) {
+        assert_int_equal(crinitTaskRespawnBackoff(&t, 0, 12345), 0);
+        assert_int_equal(t.backoffLevel, 0);
+    }
+}
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitTaskRespawnBackoff(), NULL pointer input.
+ */
+
+#include "common.h"
+#include "task.h"
+#include "unit_test.h"
+#include "utest-crinit-task-respawn-backoff.h"
+
+void crinitTaskRespawnBackoffTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    assert_int_equal(crinitTaskRespawnBackoff(NULL, 0, 0), 0);
+}
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit tests for crinitTaskRespawnBackoff(), successful execution.
+ */
+
+#include <stdint.h>
+
+#include "common.h"
+#include "task.h"
+#include "unit_test.h"
+#include "utest-crinit-task-respawn-backoff.h"
+
+#define CRINIT_TEST_NS_PER_MS 1000000uLL
+
+void crinitTaskRespawnBackoffTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTask_t t = {.respawnDelay = 100, .respawnDelayMax = 1000, .respawnReset = 10000};
+
+    // Without jitter (rnd chosen to add the full half back), the delay doubles until it reaches the upper bound.
+    const uint32_t expected[] = {100, 200, 400, 800, 1000, 1000};
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        assert_int_equal(crinitTaskRespawnBackoff(&t, 0, expected[i] / 2), expected[i]);
+        assert_int_equal(t.backoffLevel, i + 1);
+    }
+
+    // The jitter only ever shortens the delay, and by at most one half.
+    t.backoffLevel = 0;
+    assert_int_equal(crinitTaskRespawnBackoff(&t, 0, 0), 50);
+    t.backoffLevel = 0;
+    assert_int_equal(crinitTaskRespawnBackoff(&t, 0, 51), 50);
+    t.backoffLevel = 0;
+    assert_int_equal(crinitTaskRespawnBackoff(&t, 0, UINT32_MAX), 50 + UINT32_MAX % 51);
+
+    // A maximum below the initial delay does not shorten the initial delay.
+    t.respawnDelayMax = 10;
+    t.backoffLevel = 0;
+    assert_int_equal(crinitTaskRespawnBackoff(&t, 0, 50), 100);
+    assert_int_equal(crinitTaskRespawnBackoff(&t, 0, 50), 100);
+
+    // A runtime just below the reset window still counts as a crash.
+    t.respawnDelayMax = 1000;
+    t.backoffLevel = 0;
+    assert_int_equal(crinitTaskRespawnBackoff(&t, 10000 * CRINIT_TEST_NS_PER_MS - 1, 50), 100);
+    assert_int_equal(t.backoffLevel, 1);
+}
+
+void crinitTaskRespawnBackoffTestResetWindow(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTask_t t = {.respawnDelay = 100, .respawnDelayMax = 30000, .respawnReset = 10000, .backoffLevel = 5};
+
+    assert_int_equal(crinitTaskRespawnBackoff(&t, 10000 * CRINIT_TEST_NS_PER_MS, 0), 0);
+    assert_int_equal(t.backoffLevel, 0);
+
+    // The next crash starts over with the initial delay.
+    assert_int_equal(crinitTaskRespawnBackoff(&t, 0, 50), 100);
+    assert_int_equal(t.backoffLevel, 1);
+}
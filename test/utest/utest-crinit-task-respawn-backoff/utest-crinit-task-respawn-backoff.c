@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-task-respawn-backoff.c
+ * @brief Implementation of the unit test group for crinitTaskRespawnBackoff().
+ */
+
+#include "utest-crinit-task-respawn-backoff.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitTaskRespawnBackoff() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTaskRespawnBackoffTestSuccess),
+        cmocka_unit_test(crinitTaskRespawnBackoffTestResetWindow),
+        cmocka_unit_test(crinitTaskRespawnBackoffTestDisabled),
+        cmocka_unit_test(crinitTaskRespawnBackoffTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
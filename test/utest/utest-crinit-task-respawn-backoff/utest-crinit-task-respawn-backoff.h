@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-task-respawn-backoff.h
+ * @brief Header declaring the unit tests for crinitTaskRespawnBackoff().
+ */
+#ifndef __UTEST_TASK_RESPAWN_BACKOFF_H__
+#define __UTEST_TASK_RESPAWN_BACKOFF_H__
+
+/**
+ * Tests the growth, the upper bound, and the jitter of the respawn delay on consecutive failures.
+ */
+void crinitTaskRespawnBackoffTestSuccess(void **state);
+/**
+ * Tests that a task which has run for at least the reset window is respawned without delay.
+ */
+void crinitTaskRespawnBackoffTestResetWindow(void **state);
+/**
+ * Tests that a respawn delay of 0 disables the backoff.
+ */
+void crinitTaskRespawnBackoffTestDisabled(void **state);
+/**
+ * Tests NULL pointer handling.
+ */
+void crinitTaskRespawnBackoffTestNullInput(void **state);
+
+#endif /* __UTEST_TASK_RESPAWN_BACKOFF_H__ */
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitTaskUsageAdd(), NULL pointer input.
+ */
+
+#include <string.h>
+
+#include "common.h"
+#include "task.h"
+#include "unit_test.h"
+#include "utest-crinit-task-usage-add.h"
+
+void crinitTaskUsageAddTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTaskUsage_t u;
+    memset(&u, 0, sizeof(u));
+    struct rusage ru;
+    memset(&ru, 0, sizeof(ru));
+
+    assert_int_equal(crinitTaskUsageAdd(NULL, &ru), -1);
+    assert_int_equal(crinitTaskUsageAdd(&u, NULL), -1);
+    assert_int_equal(crinitTaskUsageAdd(NULL, NULL), -1);
+    assert_int_equal(u.numProcs, 0);
+}
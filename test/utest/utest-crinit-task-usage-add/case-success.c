@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitTaskUsageAdd(), successful execution.
+ */
+
+#include <string.h>
+
+#include "common.h"
+#include "task.h"
+#include "unit_test.h"
+#include "utest-crinit-task-usage-add.h"
+
+void crinitTaskUsageAddTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTaskUsage_t u;
+    memset(&u, 0, sizeof(u));
+    struct rusage ru;
+    memset(&ru, 0, sizeof(ru));
+
+    ru.ru_utime.tv_sec = 1;
+    ru.ru_utime.tv_usec = 600000;
+    ru.ru_stime.tv_usec = 250;
+    ru.ru_maxrss = 2048;
+    ru.ru_inblock = 10;
+    ru.ru_oublock = 3;
+    assert_int_equal(crinitTaskUsageAdd(&u, &ru), 0);
+
+    ru.ru_utime.tv_sec = 0;
+    ru.ru_utime.tv_usec = 500000;
+    ru.ru_stime.tv_usec = 999999;
+    ru.ru_maxrss = 1024;
+    ru.ru_inblock = 5;
+    ru.ru_oublock = 7;
+    assert_int_equal(crinitTaskUsageAdd(&u, &ru), 0);
+
+    assert_int_equal(u.userTime.tv_sec, 2);
+    assert_int_equal(u.userTime.tv_nsec, 100000000L);
+    assert_int_equal(u.sysTime.tv_sec, 1);
+    assert_int_equal(u.sysTime.tv_nsec, 249000L);
+    assert_int_equal(u.maxRss, 2048);
+    assert_int_equal(u.inBlock, 15);
+    assert_int_equal(u.outBlock, 10);
+    assert_int_equal(u.numProcs, 2);
+}
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-task-usage-add.c
+ * @brief Implementation of the unit test group for crinitTaskUsageAdd().
+ */
+
+#include "utest-crinit-task-usage-add.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitTaskUsageAdd() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTaskUsageAddTestSuccess),
+        cmocka_unit_test(crinitTaskUsageAddTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-task-usage-add.h
+ * @brief Header declaring the unit tests for crinitTaskUsageAdd().
+ */
+#ifndef __UTEST_TASK_USAGE_ADD_H__
+#define __UTEST_TASK_USAGE_ADD_H__
+
+/**
+ * Tests accumulation of CPU times including the carry into seconds, the maximum RSS, and the block I/O counters.
+ */
+void crinitTaskUsageAddTestSuccess(void **state);
+/**
+ * Tests NULL pointer handling.
+ */
+void crinitTaskUsageAddTestNullInput(void **state);
+
+#endif /* __UTEST_TASK_USAGE_ADD_H__ */
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-entry.c
+ * @brief Unit test for the timer heap keeping crinitTimerEntry_t::heapIdx up to date.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "timerheap.h"
+#include "timerindex.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-heap.h"
+
+/** Number of timers used in the test. **/
+#define CRINIT_TEST_TIMERS 32
+
+/**
+ * Check that the index entry of every timer in the heap points back to it.
+ */
+static void crinitCheckEntries(const crinitTimerHeap_t *h) {
+    for (size_t i = 0; i < h->size; i++) {
+        assert_non_null(h->timers[i].entry);
+        assert_int_equal(h->timers[i].entry->heapIdx, i);
+    }
+}
+
+void crinitTimerHeapTestEntry(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerEntry_t entries[CRINIT_TEST_TIMERS] = {0};
+    crinitTimerHeap_t h;
+    assert_int_equal(crinitTimerHeapInit(&h, 0), 0);
+    for (size_t i = 0; i < CRINIT_TEST_TIMERS; i++) {
+        crinitTimer_t t = {0};
+        t.name = strdup("t");
+        assert_non_null(t.name);
+        t.next.it_value.tv_sec = (time_t)((i * 7) % CRINIT_TEST_TIMERS);
+        t.entry = &entries[i];
+        entries[i].heapIdx = CRINIT_TIMER_INDEX_NO_HEAP;
+        assert_int_equal(crinitTimerHeapPush(&h, &t), 0);
+        crinitCheckEntries(&h);
+    }
+
+    // Remove through the entry, as the TimerDB does.
+    crinitTimer_t t;
+    size_t idx = entries[5].heapIdx;
+    assert_int_equal(crinitTimerHeapRemove(&h, idx, &t), 0);
+    assert_ptr_equal(t.entry, &entries[5]);
+    assert_int_equal(entries[5].heapIdx, CRINIT_TIMER_INDEX_NO_HEAP);
+    free(t.name);
+    crinitCheckEntries(&h);
+
+    idx = entries[9].heapIdx;
+    h.timers[idx].next.it_value.tv_sec = 100;
+    crinitTimerHeapUpdate(&h, idx);
+    crinitCheckEntries(&h);
+
+    for (size_t i = 0; i < h.size; i++) {
+        h.timers[i].next.it_value.tv_sec = (time_t)(h.size - i);
+    }
+    crinitTimerHeapRebuild(&h);
+    crinitCheckEntries(&h);
+
+    while (h.size > 0) {
+        assert_int_equal(crinitTimerHeapRemove(&h, 0, &t), 0);
+        assert_int_equal(t.entry->heapIdx, CRINIT_TIMER_INDEX_NO_HEAP);
+        free(t.name);
+        crinitCheckEntries(&h);
+    }
+    crinitTimerHeapDestroy(&h);
+}
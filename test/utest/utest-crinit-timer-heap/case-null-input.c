@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for the timer heap functions, NULL input and invalid indices.
+ */
+
+#include "common.h"
+#include "timerheap.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-heap.h"
+
+void crinitTimerHeapTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerHeap_t h;
+    crinitTimer_t t = {0};
+
+    assert_int_equal(crinitTimerHeapInit(NULL, 1), -1);
+    assert_int_equal(crinitTimerHeapPush(NULL, &t), -1);
+    assert_int_equal(crinitTimerHeapRemove(NULL, 0, &t), -1);
+    assert_int_equal(crinitTimerHeapFind(NULL, "a"), CRINIT_TIMER_HEAP_NOT_FOUND);
+
+    assert_int_equal(crinitTimerHeapInit(&h, 1), 0);
+    assert_int_equal(crinitTimerHeapPush(&h, NULL), -1);
+    assert_int_equal(crinitTimerHeapRemove(&h, 0, NULL), -1);
+    assert_int_equal(crinitTimerHeapRemove(&h, 0, &t), -1);
+    assert_int_equal(crinitTimerHeapFind(&h, NULL), CRINIT_TIMER_HEAP_NOT_FOUND);
+    crinitTimerHeapUpdate(&h, 0);
+    crinitTimerHeapUpdate(NULL, 0);
+    crinitTimerHeapDestroy(&h);
+    crinitTimerHeapDestroy(NULL);
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-order.c
+ * @brief Unit test for crinitTimerHeapPush() and crinitTimerHeapRemove(), order of expiration.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "timerheap.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-heap.h"
+
+/** Number of timers to insert, more than the initial capacity to test growing. **/
+#define CRINIT_TEST_NUM_TIMERS 100
+
+void crinitTimerHeapTestOrder(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerHeap_t h;
+    assert_int_equal(crinitTimerHeapInit(&h, 4), 0);
+
+    // Insert in a scrambled order, including equal seconds with differing nanoseconds.
+    for (size_t i = 0; i < CRINIT_TEST_NUM_TIMERS; i++) {
+        size_t k = (i * 37) % CRINIT_TEST_NUM_TIMERS;
+        crinitTimer_t t = {0};
+        t.next.it_value.tv_sec = (time_t)(k / 2);
+        t.next.it_value.tv_nsec = (long)(k % 2);
+        t.name = malloc(16);
+        assert_non_null(t.name);
+        snprintf(t.name, 16, "%zu", k);
+        assert_int_equal(crinitTimerHeapPush(&h, &t), 0);
+    }
+    assert_int_equal(h.size, CRINIT_TEST_NUM_TIMERS);
+
+    for (size_t i = 0; i < CRINIT_TEST_NUM_TIMERS; i++) {
+        crinitTimer_t t;
+        assert_int_equal(crinitTimerHeapRemove(&h, 0, &t), 0);
+        assert_int_equal(t.next.it_value.tv_sec, (time_t)(i / 2));
+        assert_int_equal(t.next.it_value.tv_nsec, (long)(i % 2));
+        char expName[16];
+        snprintf(expName, sizeof(expName), "%zu", i);
+        assert_string_equal(t.name, expName);
+        free(t.name);
+    }
+    assert_int_equal(h.size, 0);
+
+    crinitTimerHeapDestroy(&h);
+}
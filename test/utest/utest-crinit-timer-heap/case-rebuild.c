@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-rebuild.c
+ * @brief Unit test for crinitTimerHeapRebuild(), order after changing all expirations at once.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "timerheap.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-heap.h"
+
+/** Number of timers to insert. **/
+#define CRINIT_TEST_NUM_TIMERS 100
+
+void crinitTimerHeapTestRebuild(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerHeap_t h;
+    assert_int_equal(crinitTimerHeapInit(&h, 4), 0);
+
+    for (size_t i = 0; i < CRINIT_TEST_NUM_TIMERS; i++) {
+        crinitTimer_t t = {0};
+        t.next.it_value.tv_sec = (time_t)i;
+        t.name = malloc(16);
+        assert_non_null(t.name);
+        snprintf(t.name, 16, "%zu", i);
+        assert_int_equal(crinitTimerHeapPush(&h, &t), 0);
+    }
+
+    // Reverse and scramble the order in place as after a change of the system time, then restore it in one pass.
+    for (size_t i = 0; i < h.size; i++) {
+        h.timers[i].next.it_value.tv_sec = (time_t)((atoi(h.timers[i].name) * 37) % CRINIT_TEST_NUM_TIMERS);
+    }
+    crinitTimerHeapRebuild(&h);
+    crinitTimerHeapRebuild(NULL);
+
+    for (size_t i = 0; i < CRINIT_TEST_NUM_TIMERS; i++) {
+        crinitTimer_t t;
+        assert_int_equal(crinitTimerHeapRemove(&h, 0, &t), 0);
+        assert_int_equal(t.next.it_value.tv_sec, (time_t)i);
+        assert_int_equal((atoi(t.name) * 37) % CRINIT_TEST_NUM_TIMERS, (int)i);
+        free(t.name);
+    }
+    assert_int_equal(h.size, 0);
+
+    crinitTimerHeapDestroy(&h);
+}
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-remove.c
+ * @brief Unit test for crinitTimerHeapRemove(), crinitTimerHeapUpdate() and crinitTimerHeapFind().
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "timerheap.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-heap.h"
+
+/**
+ * Push a timer with the given name and expiration second.
+ */
+static void crinitPushTimer(crinitTimerHeap_t *h, const char *name, time_t sec) {
+    crinitTimer_t t = {0};
+    t.name = strdup(name);
+    assert_non_null(t.name);
+    t.next.it_value.tv_sec = sec;
+    assert_int_equal(crinitTimerHeapPush(h, &t), 0);
+}
+
+void crinitTimerHeapTestRemove(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerHeap_t h;
+    assert_int_equal(crinitTimerHeapInit(&h, 0), 0);
+    crinitPushTimer(&h, "a", 50);
+    crinitPushTimer(&h, "b", 10);
+    crinitPushTimer(&h, "c", 40);
+    crinitPushTimer(&h, "d", 30);
+    crinitPushTimer(&h, "e", 20);
+    assert_string_equal(h.timers[0].name, "b");
+
+    assert_int_equal(crinitTimerHeapFind(&h, "x"), CRINIT_TIMER_HEAP_NOT_FOUND);
+
+    // Remove from the middle.
+    size_t idx = crinitTimerHeapFind(&h, "d");
+    assert_int_not_equal(idx, CRINIT_TIMER_HEAP_NOT_FOUND);
+    crinitTimer_t t;
+    assert_int_equal(crinitTimerHeapRemove(&h, idx, &t), 0);
+    assert_string_equal(t.name, "d");
+    free(t.name);
+    assert_int_equal(h.size, 4);
+    assert_int_equal(crinitTimerHeapFind(&h, "d"), CRINIT_TIMER_HEAP_NOT_FOUND);
+
+    // Reschedule the first timer to expire last, and the last one to expire first.
+    h.timers[0].next.it_value.tv_sec = 60;
+    crinitTimerHeapUpdate(&h, 0);
+    idx = crinitTimerHeapFind(&h, "a");
+    h.timers[idx].next.it_value.tv_sec = 5;
+    crinitTimerHeapUpdate(&h, idx);
+
+    const char *expOrder[] = {"a", "e", "c", "b"};
+    for (size_t i = 0; i < ARRAY_SIZE(expOrder); i++) {
+        assert_int_equal(crinitTimerHeapRemove(&h, 0, &t), 0);
+        assert_string_equal(t.name, expOrder[i]);
+        free(t.name);
+    }
+    assert_int_equal(h.size, 0);
+
+    crinitPushTimer(&h, "f", 1);
+    crinitTimerHeapDestroy(&h);
+    assert_null(h.timers);
+    assert_int_equal(h.size, 0);
+}
@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-heap.c
+ * @brief Implementation of the unit test group for the timer heap.
+ */
+
+#include "utest-crinit-timer-heap.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for the timer heap using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTimerHeapTestOrder),
+        cmocka_unit_test(crinitTimerHeapTestRemove),
+        cmocka_unit_test(crinitTimerHeapTestRebuild),
+        cmocka_unit_test(crinitTimerHeapTestEntry),
+        cmocka_unit_test(crinitTimerHeapTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
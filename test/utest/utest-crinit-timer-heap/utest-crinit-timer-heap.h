@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-heap.h
+ * @brief Header declaring the unit tests for the timer heap.
+ */
+#ifndef __UTEST_TIMER_HEAP_H__
+#define __UTEST_TIMER_HEAP_H__
+
+/**
+ * Unit test for crinitTimerHeapPush() and crinitTimerHeapRemove(), timers leave the heap in order of expiration.
+ *
+ * @param state  unused
+ */
+void crinitTimerHeapTestOrder(void **state);
+/**
+ * Unit test for crinitTimerHeapRemove(), crinitTimerHeapUpdate() and crinitTimerHeapFind() on arbitrary elements.
+ *
+ * @param state  unused
+ */
+void crinitTimerHeapTestRemove(void **state);
+/**
+ * Unit test for crinitTimerHeapRebuild(), timers leave the heap in order after all of them have been changed.
+ *
+ * @param state  unused
+ */
+void crinitTimerHeapTestRebuild(void **state);
+/**
+ * Unit test for the timer heap keeping crinitTimerEntry_t::heapIdx up to date.
+ *
+ * @param state  unused
+ */
+void crinitTimerHeapTestEntry(void **state);
+/**
+ * Unit test for the timer heap functions, handling of NULL input and invalid indices.
+ *
+ * @param state  unused
+ */
+void crinitTimerHeapTestNullInput(void **state);
+
+#endif /* __UTEST_TIMER_HEAP_H__ */
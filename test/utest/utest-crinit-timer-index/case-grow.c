@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-grow.c
+ * @brief Unit test for the timer index growing beyond its initial number of buckets.
+ */
+
+#include <stdio.h>
+
+#include "common.h"
+#include "timerindex.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-index.h"
+
+/** Number of timers used in the test. **/
+#define CRINIT_TEST_TIMERS 1000
+
+void crinitTimerIndexTestGrow(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerIndex_t idx;
+    assert_int_equal(crinitTimerIndexInit(&idx, 2), 0);
+    for (size_t i = 0; i < CRINIT_TEST_TIMERS; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "every:%zuus", i + 1);
+        crinitTimerDef_t def = {.intervalNs = (i + 1) * 1000};
+        bool created = false;
+        crinitTimerEntry_t *e = crinitTimerIndexRefDef(&idx, name, &def, &created);
+        assert_non_null(e);
+        assert_true(created);
+        e->heapIdx = i;
+    }
+    assert_int_equal(idx.nameCount, CRINIT_TEST_TIMERS);
+    assert_int_equal(idx.entryCount, CRINIT_TEST_TIMERS);
+    assert_true(idx.nameBuckets >= CRINIT_TEST_TIMERS);
+    assert_true(idx.entryBuckets >= CRINIT_TEST_TIMERS);
+
+    for (size_t i = 0; i < CRINIT_TEST_TIMERS; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "every:%zuus", i + 1);
+        crinitTimerEntry_t *e = crinitTimerIndexRef(&idx, name);
+        assert_non_null(e);
+        assert_int_equal(e->heapIdx, i);
+        assert_int_equal(e->def.intervalNs, (i + 1) * 1000);
+    }
+
+    crinitTimerIndexDestroy(&idx);
+}
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for the timer index functions, handling of NULL input.
+ */
+
+#include "common.h"
+#include "timerindex.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-index.h"
+
+void crinitTimerIndexTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerDef_t def = {0};
+    bool created = false;
+    assert_int_equal(crinitTimerIndexInit(NULL, 1), -1);
+    assert_null(crinitTimerIndexRef(NULL, "a"));
+    assert_null(crinitTimerIndexRefDef(NULL, "a", &def, &created));
+    assert_null(crinitTimerIndexUnref(NULL, "a"));
+
+    crinitTimerIndex_t idx;
+    assert_int_equal(crinitTimerIndexInit(&idx, 1), 0);
+    assert_null(crinitTimerIndexRef(&idx, NULL));
+    assert_null(crinitTimerIndexRefDef(&idx, NULL, &def, &created));
+    assert_null(crinitTimerIndexRefDef(&idx, "a", NULL, &created));
+    assert_null(crinitTimerIndexRefDef(&idx, "a", &def, NULL));
+    assert_null(crinitTimerIndexUnref(&idx, NULL));
+    crinitTimerIndexRemove(&idx, NULL);
+    crinitTimerIndexRemove(NULL, NULL);
+    crinitTimerIndexDestroy(&idx);
+    crinitTimerIndexDestroy(NULL);
+
+    // An index which has not been initialized knows no timers.
+    crinitTimerIndex_t empty = {0};
+    assert_null(crinitTimerIndexRef(&empty, "a"));
+    assert_null(crinitTimerIndexRefDef(&empty, "a", &def, &created));
+}
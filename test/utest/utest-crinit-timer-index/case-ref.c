@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-ref.c
+ * @brief Unit test for crinitTimerIndexRef(), crinitTimerIndexRefDef() and crinitTimerIndexUnref().
+ */
+
+#include "common.h"
+#include "timerindex.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-index.h"
+
+void crinitTimerIndexTestRef(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerIndex_t idx;
+    assert_int_equal(crinitTimerIndexInit(&idx, 4), 0);
+    crinitTimerDef_t def = {.intervalNs = 1000};
+
+    // Unknown spellings need to be added with their definition.
+    assert_null(crinitTimerIndexRef(&idx, "every:1us"));
+    bool created = false;
+    crinitTimerEntry_t *e = crinitTimerIndexRefDef(&idx, "every:1us", &def, &created);
+    assert_non_null(e);
+    assert_true(created);
+    assert_int_equal(e->refs, 1);
+    assert_int_equal(e->heapIdx, CRINIT_TIMER_INDEX_NO_HEAP);
+    assert_string_equal(e->aliases->name, "every:1us");
+
+    assert_ptr_equal(crinitTimerIndexRef(&idx, "every:1us"), e);
+    assert_ptr_equal(crinitTimerIndexRefDef(&idx, "every:1us", &def, &created), e);
+    assert_false(created);
+    assert_int_equal(e->refs, 3);
+    assert_int_equal(e->aliases->refs, 3);
+    assert_int_equal(idx.nameCount, 1);
+    assert_int_equal(idx.entryCount, 1);
+
+    assert_ptr_equal(crinitTimerIndexUnref(&idx, "every:1us"), e);
+    assert_ptr_equal(crinitTimerIndexUnref(&idx, "every:1us"), e);
+    assert_int_equal(e->refs, 1);
+    assert_null(crinitTimerIndexUnref(&idx, "unknown"));
+
+    // The last reference removes the spelling, the entry stays until it is removed explicitly.
+    assert_ptr_equal(crinitTimerIndexUnref(&idx, "every:1us"), e);
+    assert_int_equal(e->refs, 0);
+    assert_null(e->aliases);
+    assert_int_equal(idx.nameCount, 0);
+    assert_int_equal(idx.entryCount, 1);
+    assert_null(crinitTimerIndexRef(&idx, "every:1us"));
+    crinitTimerIndexRemove(&idx, e);
+    assert_int_equal(idx.entryCount, 0);
+
+    crinitTimerIndexDestroy(&idx);
+    assert_null(idx.names);
+    assert_null(idx.entries);
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-shared.c
+ * @brief Unit test for crinitTimerIndexRefDef(), spellings of the same definition share one entry.
+ */
+
+#include "common.h"
+#include "timerindex.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-index.h"
+
+void crinitTimerIndexTestShared(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerIndex_t idx;
+    assert_int_equal(crinitTimerIndexInit(&idx, 0), 0);
+    crinitTimerDef_t daily = {
+        .wDay = 0x7f, .years = {0, 65535}, .month = {1, 12}, .days = {1, 31}, .hours = {0, 0}, .minutes = {0, 0}};
+    crinitTimerDef_t hourly = daily;
+    hourly.hours[1] = 23;
+
+    bool created = false;
+    crinitTimerEntry_t *e = crinitTimerIndexRefDef(&idx, "daily", &daily, &created);
+    assert_non_null(e);
+    assert_true(created);
+    crinitTimerEntry_t *e2 = crinitTimerIndexRefDef(&idx, "*-*-*-00:00:00", &daily, &created);
+    assert_ptr_equal(e2, e);
+    assert_false(created);
+    crinitTimerEntry_t *h = crinitTimerIndexRefDef(&idx, "hourly", &hourly, &created);
+    assert_non_null(h);
+    assert_ptr_not_equal(h, e);
+    assert_true(created);
+
+    assert_int_equal(e->refs, 2);
+    assert_int_equal(idx.nameCount, 3);
+    assert_int_equal(idx.entryCount, 2);
+    size_t aliases = 0;
+    for (const crinitTimerAlias_t *a = e->aliases; a != NULL; a = a->nextOfEntry) {
+        assert_ptr_equal(a->entry, e);
+        aliases++;
+    }
+    assert_int_equal(aliases, 2);
+
+    // Dropping one spelling keeps the other.
+    assert_ptr_equal(crinitTimerIndexUnref(&idx, "daily"), e);
+    assert_int_equal(e->refs, 1);
+    assert_string_equal(e->aliases->name, "*-*-*-00:00:00");
+    assert_null(e->aliases->nextOfEntry);
+    assert_ptr_equal(crinitTimerIndexRef(&idx, "*-*-*-00:00:00"), e);
+
+    // Removing an entry removes all of its spellings.
+    crinitTimerIndexRemove(&idx, e);
+    assert_null(crinitTimerIndexRef(&idx, "*-*-*-00:00:00"));
+    assert_int_equal(idx.nameCount, 1);
+    assert_int_equal(idx.entryCount, 1);
+
+    crinitTimerIndexDestroy(&idx);
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-index.c
+ * @brief Implementation of the unit test group for the timer index.
+ */
+
+#include "utest-crinit-timer-index.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for the timer index using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTimerIndexTestRef),
+        cmocka_unit_test(crinitTimerIndexTestShared),
+        cmocka_unit_test(crinitTimerIndexTestGrow),
+        cmocka_unit_test(crinitTimerIndexTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-index.h
+ * @brief Header declaring the unit tests for the timer index.
+ */
+#ifndef __UTEST_TIMER_INDEX_H__
+#define __UTEST_TIMER_INDEX_H__
+
+/**
+ * Unit test for crinitTimerIndexRef(), crinitTimerIndexRefDef() and crinitTimerIndexUnref() on a single spelling.
+ *
+ * @param state  unused
+ */
+void crinitTimerIndexTestRef(void **state);
+/**
+ * Unit test for crinitTimerIndexRefDef(), different spellings of the same definition share one entry.
+ *
+ * @param state  unused
+ */
+void crinitTimerIndexTestShared(void **state);
+/**
+ * Unit test for the timer index growing beyond its initial number of buckets.
+ *
+ * @param state  unused
+ */
+void crinitTimerIndexTestGrow(void **state);
+/**
+ * Unit test for the timer index functions, handling of NULL input.
+ *
+ * @param state  unused
+ */
+void crinitTimerIndexTestNullInput(void **state);
+
+#endif /* __UTEST_TIMER_INDEX_H__ */
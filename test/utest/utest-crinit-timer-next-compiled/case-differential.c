@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-differential.c
+ * @brief Differential unit test of crinitTimerNextTimeCompiled() against the legacy implementation.
+ */
+
+#include <stdint.h>
+
+#include "common.h"
+#include "timer.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-next-compiled.h"
+
+/** Number of random timer definitions to test. **/
+#define CRINIT_DIFF_NUM_TIMERS 20000
+/** Maximum number of results to verify with a second-by-second search. **/
+#define CRINIT_DIFF_NUM_BRUTE_FORCE 64
+/** Maximum distance in seconds of a result to verify with a second-by-second search. **/
+#define CRINIT_DIFF_BRUTE_FORCE_MAX_SECS 86400
+
+/**
+ * Simple deterministic pseudo random number generator (xorshift32), so failures are reproducible.
+ */
+static uint32_t crinitDiffRand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * Set a random range, either the full one, a single value or two arbitrary values (possibly wrapping).
+ */
+static void crinitDiffRange(uint32_t *state, uint8_t range[2], unsigned lo, unsigned hi) {
+    switch (crinitDiffRand(state) % 3) {
+        case 0:
+            range[0] = (uint8_t)lo;
+            range[1] = (uint8_t)hi;
+            break;
+        case 1:
+            range[0] = range[1] = (uint8_t)(lo + crinitDiffRand(state) % (hi - lo + 1));
+            break;
+        default:
+            range[0] = (uint8_t)(lo + crinitDiffRand(state) % (hi - lo + 1));
+            range[1] = (uint8_t)(lo + crinitDiffRand(state) % (hi - lo + 1));
+            break;
+    }
+}
+
+void crinitTimerNextTimeCompiledDifferential(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    uint32_t rnd = 0x5eed1e55;
+    size_t numBruteForce = 0;
+    for (size_t i = 0; i < CRINIT_DIFF_NUM_TIMERS; i++) {
+        crinitTimerDef_t td = {0};
+        crinitTimerSetDefault(&td);
+        if (crinitDiffRand(&rnd) % 4 == 0) {
+            td.wDay = (uint8_t)(1 + crinitDiffRand(&rnd) % 0x7f);
+        }
+        crinitDiffRange(&rnd, td.month, 1, 12);
+        crinitDiffRange(&rnd, td.days, 1, 31);
+        crinitDiffRange(&rnd, td.hours, 0, 23);
+        crinitDiffRange(&rnd, td.minutes, 0, 59);
+        crinitDiffRange(&rnd, td.seconds, 0, 59);
+        if (crinitDiffRand(&rnd) % 5 == 0) {
+            td.years[0] = (uint16_t)(1970 + crinitDiffRand(&rnd) % 100);
+            td.years[1] = (uint16_t)(1970 + crinitDiffRand(&rnd) % 100);
+        }
+        if (crinitDiffRand(&rnd) % 4 == 0) {
+            td.timezone[0] = (int8_t)(crinitDiffRand(&rnd) % 27) - 11;
+            td.timezone[1] = (int8_t)(crinitDiffRand(&rnd) % 4 * 15);
+        }
+        if (!crinitCheckTimerDef(&td)) {
+            continue;
+        }
+
+        crinitTimerCompiled_t tc;
+        crinitTimerCompile(&td, &tc);
+        struct timespec now = {.tv_sec = crinitDiffRand(&rnd) % 2000000000, .tv_nsec = crinitDiffRand(&rnd) % 1000};
+        struct timespec next = crinitTimerNextTimeCompiled(&now, &tc);
+        struct timespec legacy = crinitLegacyTimerNextTime(&now, &td);
+
+        // Whatever the legacy implementation finds, the compiled one finds as well or an earlier matching time.
+        if (legacy.tv_sec != 0) {
+            assert_int_not_equal(next.tv_sec, 0);
+            assert_true(next.tv_sec <= legacy.tv_sec);
+        }
+        if (next.tv_sec == 0) {
+            continue;
+        }
+        assert_true(next.tv_sec > now.tv_sec);
+        assert_int_equal(next.tv_nsec, now.tv_nsec);
+        assert_true(crinitCheckTimerTime(next, &td));
+
+        // Check that no earlier time matches if that is cheap enough.
+        if (numBruteForce < CRINIT_DIFF_NUM_BRUTE_FORCE &&
+            next.tv_sec - now.tv_sec <= CRINIT_DIFF_BRUTE_FORCE_MAX_SECS) {
+            numBruteForce++;
+            struct timespec t = now;
+            for (t.tv_sec = now.tv_sec + 1; t.tv_sec < next.tv_sec; t.tv_sec++) {
+                assert_false(crinitCheckTimerTime(t, &td));
+            }
+        }
+    }
+    assert_int_equal(numBruteForce, CRINIT_DIFF_NUM_BRUTE_FORCE);
+}
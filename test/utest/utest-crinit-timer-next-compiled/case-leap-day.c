@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-leap-day.c
+ * @brief Unit test for crinitTimerNextTimeCompiled() with a timer expiring on Feb 29 falling on a Monday.
+ */
+
+#include "common.h"
+#include "timer.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-next-compiled.h"
+
+void crinitTimerNextTimeCompiledLeapDay(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerDef_t td = {0};
+    crinitTimerSetDefault(&td);
+    td.wDay = 1;
+    td.month[0] = td.month[1] = 2;
+    td.days[0] = td.days[1] = 29;
+    td.hours[0] = td.hours[1] = 12;
+    crinitTimerCompiled_t tc;
+    crinitTimerCompile(&td, &tc);
+
+    // 2024-03-01 00:00:00 UTC
+    struct timespec now = {.tv_sec = 1709251200, .tv_nsec = 7};
+    struct timespec next = crinitTimerNextTimeCompiled(&now, &tc);
+    // 2044-02-29 12:00:00 UTC
+    assert_int_equal(next.tv_sec, 2340360000);
+    assert_int_equal(next.tv_nsec, 7);
+    assert_true(crinitCheckTimerTime(next, &td));
+
+    next = crinitTimerNextTimeCompiled(&next, &tc);
+    // 2072-02-29 12:00:00 UTC
+    assert_int_equal(next.tv_sec, 3223972800);
+    assert_int_equal(next.tv_nsec, 7);
+}
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-month-end.c
+ * @brief Unit test for crinitTimerNextTimeCompiled() with a timer expiring on the 31st in a timezone ahead of UTC.
+ */
+
+#include "common.h"
+#include "timer.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-next-compiled.h"
+
+void crinitTimerNextTimeCompiledMonthEnd(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerDef_t td = {0};
+    crinitTimerSetDefault(&td);
+    td.days[0] = td.days[1] = 31;
+    td.timezone[0] = 2;
+    crinitTimerCompiled_t tc;
+    crinitTimerCompile(&td, &tc);
+
+    // 2025-04-30 23:59:59 +0200, April has no 31st.
+    struct timespec now = {.tv_sec = 1746050399, .tv_nsec = 0};
+    struct timespec next = crinitTimerNextTimeCompiled(&now, &tc);
+    // 2025-05-31 00:00:00 +0200
+    assert_int_equal(next.tv_sec, 1748642400);
+    assert_true(crinitCheckTimerTime(next, &td));
+
+    // June has no 31st either, next is July.
+    next = crinitTimerNextTimeCompiled(&next, &tc);
+    assert_int_equal(next.tv_sec, 1748642400 + (30 + 31) * 86400);
+}
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-never.c
+ * @brief Unit test for crinitTimerNextTimeCompiled() with a timer that will not expire again.
+ */
+
+#include "common.h"
+#include "timer.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-next-compiled.h"
+
+void crinitTimerNextTimeCompiledNever(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerDef_t td = {0};
+    crinitTimerSetDefault(&td);
+    td.years[0] = 2000;
+    td.years[1] = 2010;
+    crinitTimerCompiled_t tc;
+    crinitTimerCompile(&td, &tc);
+
+    struct timespec now = {.tv_sec = 1763460667, .tv_nsec = 12};
+    struct timespec next = crinitTimerNextTimeCompiled(&now, &tc);
+    assert_int_equal(next.tv_sec, 0);
+    assert_int_equal(next.tv_nsec, 0);
+
+    // The last second of 2010 is still reachable from before.
+    td.hours[1] = 23;
+    td.minutes[1] = 59;
+    td.seconds[1] = 59;
+    crinitTimerCompile(&td, &tc);
+    now.tv_sec = 1293839998;
+    next = crinitTimerNextTimeCompiled(&now, &tc);
+    assert_int_equal(next.tv_sec, 1293839999);
+    now.tv_sec = 1293839999;
+    next = crinitTimerNextTimeCompiled(&now, &tc);
+    assert_int_equal(next.tv_sec, 0);
+}
@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file legacy-timer-next.c
+ * @brief Reference implementation of the next expiration of a timer, stepping field by field.
+ *
+ * This is the algorithm crinitTimerNextTime() used before timer definitions were compiled to bitsets, kept unchanged
+ * to compare crinitTimerNextTimeCompiled() against. Its results match the timer definition but it may skip earlier
+ * matching times, e.g. if a higher field needs to roll over.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "logio.h"
+#include "timer.h"
+#include "utest-crinit-timer-next-compiled.h"
+
+static bool crinitIsLeapYear(uint16_t year) {
+    return (year % 4 == 0) && (!(year % 100 == 0) || (year % 400 == 0));
+}
+
+static int crinitMonthLength(uint8_t month, uint16_t year) {
+    switch (month) {
+        case 1:
+        case 3:
+        case 5:
+        case 7:
+        case 8:
+        case 10:
+        case 12:
+            return 31;
+        case 4:
+        case 6:
+        case 9:
+        case 11:
+            return 30;
+        case 2:
+            return crinitIsLeapYear(year) ? 29 : 28;
+        default:
+            return -1;
+    }
+}
+
+static bool crinitNext(int last, uint8_t interval[2], int start, int limit, int *res, long long int *offs) {
+    uint8_t range[2] = {start <= interval[0] ? interval[0] : start, interval[1] <= limit ? interval[1] : limit};
+    long long int off = 0;
+    bool done = false;
+    if (range[0] == range[1]) {
+        // if its a single possible value set the offset to the difference
+        // what amount needs to change to get to that value
+        off += (range[0] - last);
+    } else if (range[0] < range[1]) {
+        // a "standard" range of start < end
+        if (CO_RANGE(range[0], last, range[1])) {
+            // if last is in the range [start, end) it just 1 needs to be added
+            off += 1;
+        } else {
+            // if not next needs to be set to start
+            off += (range[0] - last);
+        }
+    } else if (range[0] > range[1]) {
+        // if the range wraps around
+        // ie is a range from start to range[1] and one from range[0] to limit
+        if (CO_RANGE(range[1], last, range[0])) {
+            // last is in the not allowed interval between range[1] and range[0]
+            // set next to range[0]
+            off += (range[0] - last);
+        } else if (last == limit) {
+            // last is the limit set next to start
+            off -= (limit - start);
+        } else {
+            // otherwise just 1 can be added
+            off += 1;
+        }
+    }
+    if (off > 0) {
+        // if the offset is positive the next value can be found
+        // within the range without rolling over
+        done = true;
+    }
+    *offs = off;
+    *res = last + off;
+    return done;
+}
+
+static bool crinitNextYear(int last, uint16_t interval[2], int *res, long long int *offs) {
+    if (interval[0] == interval[1]) {
+        crinitErrPrint("was only supposed to run in the year %d", last);
+        return false;
+    } else if (interval[0] < interval[1]) {
+        if (CO_RANGE(interval[0], last, interval[1])) {
+            *res = last + 1;
+            *offs = 1;
+            return true;
+        } else {
+            crinitErrPrint("%d was the last possible year", last);
+            return false;
+        }
+    } else {
+        if (last < interval[1]) {
+            *res = last + 1;
+            *offs = 1;
+            return true;
+        } else if (last >= interval[0]) {
+            *offs = 1;
+            *res = last + 1;
+            return true;
+        } else {
+            *res = interval[0];
+            *offs = interval[0] - last;
+            crinitErrPrint("something super weird with the year %d", last);
+            return false;
+        }
+    }
+    return false;
+}
+
+static const int crinitDayToMonthLookup[] = {
+    [1] = 0,   [2] = 31,  [3] = 59,  [4] = 90,   [5] = 120,  [6] = 151,
+    [7] = 181, [8] = 212, [9] = 243, [10] = 273, [11] = 304, [12] = 334,
+};
+
+static int crinitDaysToMonth(uint8_t m, uint16_t year) {
+    if (m != 0 && m <= 2) {
+        return crinitDayToMonthLookup[m];
+    } else if (m <= 12) {
+        return crinitDayToMonthLookup[m] + crinitIsLeapYear(year);
+    } else {
+        return -1;
+    }
+}
+
+struct timespec crinitLegacyTimerNextTime(struct timespec *last, crinitTimerDef_t *td) {
+    time_t t = last->tv_sec;
+    struct tm times = {0};
+    crinitZonedTimeR(&t, td->timezone, &times);
+
+    struct timespec next = {0};
+
+    // tells if a next time is already found
+    bool done = false;
+
+    long long int offSec = 0;
+    long long int offMin = 0;
+    long long int offHour = 0;
+    long long int offDays = 0;
+
+    long long int off = 0;
+    int partRes = 0;
+    // update seconds
+    done = crinitNext(times.tm_sec, td->seconds, 0, 59, &partRes, &offSec);
+    if (!done || !CC_RANGE(td->minutes[0], times.tm_min, td->minutes[1])) {
+        // update minutes only if last time wasn't a valid timestamp or no valid time was found yet
+        // if a valid next second is still at an invalid minute the whole timestamp is still invalid
+        done = crinitNext(times.tm_min, td->minutes, 0, 59, &partRes, &offMin);
+    }
+    if (!done || !CC_RANGE(td->hours[0], times.tm_hour, td->hours[1])) {
+        done = crinitNext(times.tm_hour, td->hours, 0, 23, &partRes, &offHour);
+    }
+    int day = times.tm_mday;
+    int month = times.tm_mon + 1;
+    int year = times.tm_year + 1900;
+    int tries = 0;
+    do {
+        if (!done || !CC_RANGE(td->days[0], day, td->days[1])) {
+            int last = day;
+            // special case needed for Feb 29 to stay on Feb 29 and just update the year
+            if (td->days[0] == 29 && td->days[1] == 29 && td->month[0] == 2 && td->month[1] == 2 && day == 29) {
+                done = false;
+            } else {
+                int ml = crinitMonthLength(month, year);
+                done = crinitNext(last, td->days, 1, ml, &day, &off);
+                offDays += off;
+            }
+        }
+        if (!done || !CC_RANGE(td->month[0], month, td->month[1])) {
+            int last = month;
+            done = crinitNext(last, td->month, 1, 12, &month, &off);
+            offDays += crinitDaysToMonth(month, year) - crinitDaysToMonth(last, year);
+        }
+        if (!done || !CC_RANGE(td->years[0], year, td->years[1])) {
+            int last = year;
+            done = crinitNextYear(last, td->years, &year, &off);
+            offDays += off * (365 + (crinitIsLeapYear(last) ? 1 : 0));
+        }
+        if (!done) {
+            crinitErrPrint("No possible next time found for timer");
+            break;
+        }
+        if (done) {
+            next.tv_nsec = last->tv_nsec;
+            next.tv_sec = last->tv_sec + offSec + offMin * 60 + offHour * 3600 + offDays * 86400;
+            done = crinitCheckTimerTime(next, td);
+        }
+        // because we don't consider the weekday when updating the day/month/year
+        // we repeat that step until everything including the weekday is valid
+        // or a limit of tries is reached that was enough reliably find Feb 29 for individual weekdays
+    } while (!done && tries++ <= 40);
+    if (!done) {
+        next.tv_sec = 0;
+        next.tv_nsec = 0;
+    }
+    return next;
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-next-compiled.c
+ * @brief Implementation of the crinitTimerNextTimeCompiled() unit test group.
+ */
+
+#include "utest-crinit-timer-next-compiled.h"
+
+#include "common.h"
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitTimerNextTimeCompiled() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTimerNextTimeCompiledDifferential),
+        cmocka_unit_test(crinitTimerNextTimeCompiledLeapDay),
+        cmocka_unit_test(crinitTimerNextTimeCompiledMonthEnd),
+        cmocka_unit_test(crinitTimerNextTimeCompiledNever),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-next-compiled.h
+ * @brief Header declaring the unit tests for crinitTimerNextTimeCompiled().
+ */
+#ifndef __UTEST_TIMER_NEXT_COMPILED_H__
+#define __UTEST_TIMER_NEXT_COMPILED_H__
+
+#include <time.h>
+
+#include "timer.h"
+
+/**
+ * The iterative implementation of crinitTimerNextTime() used before, as a reference.
+ *
+ * @param last  the last timestamp to calculate the next from
+ * @param td    the timer definition to calculate the next time from
+ *
+ * @return the timestamp the timer is fullfiled next, 0 if none was found
+ */
+struct timespec crinitLegacyTimerNextTime(struct timespec *last, crinitTimerDef_t *td);
+
+/**
+ * Compares crinitTimerNextTimeCompiled() to the legacy implementation and a brute force search for random timers.
+ */
+void crinitTimerNextTimeCompiledDifferential(void **state);
+/**
+ * Tests a timer only matching on Feb 29 falling on a Monday.
+ */
+void crinitTimerNextTimeCompiledLeapDay(void **state);
+/**
+ * Tests a timer on the 31st of every month in a timezone ahead of UTC.
+ */
+void crinitTimerNextTimeCompiledMonthEnd(void **state);
+/**
+ * Tests a timer whose range of years has passed.
+ */
+void crinitTimerNextTimeCompiledNever(void **state);
+
+#endif /* __UTEST_TIMER_NEXT_COMPILED_H__ */
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-since-armed.c
+ * @brief Unit test for crinitTimerNextInterval(), periods counted from arming the timer.
+ */
+
+#include "common.h"
+#include "timer.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-next-interval.h"
+
+void crinitTimerNextIntervalSinceArmed(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    const uint64_t period = UINT64_C(30000000000);
+    const struct timespec armed = {.tv_sec = 100, .tv_nsec = 123};
+
+    struct timespec next = crinitTimerNextInterval(&armed, &armed, period);
+    assert_int_equal(next.tv_sec, 130);
+    assert_int_equal(next.tv_nsec, 123);
+
+    // On time, the next period follows.
+    struct timespec now = next;
+    next = crinitTimerNextInterval(&next, &now, period);
+    assert_int_equal(next.tv_sec, 160);
+    assert_int_equal(next.tv_nsec, 123);
+
+    // Late by more than two periods, those are skipped but the schedule is kept.
+    now.tv_sec = 225;
+    next = crinitTimerNextInterval(&next, &now, period);
+    assert_int_equal(next.tv_sec, 250);
+    assert_int_equal(next.tv_nsec, 123);
+
+    // A last expiration in the future is followed by the next period.
+    now.tv_sec = 200;
+    next = crinitTimerNextInterval(&next, &now, period);
+    assert_int_equal(next.tv_sec, 280);
+    assert_int_equal(next.tv_nsec, 123);
+}
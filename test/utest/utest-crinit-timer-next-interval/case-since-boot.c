@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-since-boot.c
+ * @brief Unit test for crinitTimerNextInterval(), periods counted from boot.
+ */
+
+#include "common.h"
+#include "timer.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-next-interval.h"
+
+void crinitTimerNextIntervalSinceBoot(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    const struct timespec boot = {0};
+    const uint64_t period = 250000000;
+
+    struct timespec now = {.tv_sec = 12, .tv_nsec = 300000000};
+    struct timespec next = crinitTimerNextInterval(&boot, &now, period);
+    assert_int_equal(next.tv_sec, 12);
+    assert_int_equal(next.tv_nsec, 500000000);
+
+    // Exactly on a period, the next one is due.
+    now.tv_nsec = 500000000;
+    next = crinitTimerNextInterval(&boot, &now, period);
+    assert_int_equal(next.tv_sec, 12);
+    assert_int_equal(next.tv_nsec, 750000000);
+
+    // Crossing into the next second.
+    now.tv_nsec = 999999999;
+    next = crinitTimerNextInterval(&boot, &now, period);
+    assert_int_equal(next.tv_sec, 13);
+    assert_int_equal(next.tv_nsec, 0);
+
+    // Periods longer than a second which do not divide it.
+    now.tv_sec = 10;
+    now.tv_nsec = 0;
+    next = crinitTimerNextInterval(&boot, &now, UINT64_C(3500000000));
+    assert_int_equal(next.tv_sec, 10);
+    assert_int_equal(next.tv_nsec, 500000000);
+}
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-zero.c
+ * @brief Unit test for crinitTimerNextInterval() with a zero period.
+ */
+
+#include "common.h"
+#include "timer.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-next-interval.h"
+
+void crinitTimerNextIntervalZero(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    const struct timespec last = {.tv_sec = 5, .tv_nsec = 5};
+    const struct timespec now = {.tv_sec = 6, .tv_nsec = 6};
+    struct timespec next = crinitTimerNextInterval(&last, &now, 0);
+    assert_int_equal(next.tv_sec, 0);
+    assert_int_equal(next.tv_nsec, 0);
+}
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-next-interval.c
+ * @brief Implementation of the crinitTimerNextInterval() unit test group.
+ */
+
+#include "utest-crinit-timer-next-interval.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitTimerNextInterval() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTimerNextIntervalSinceBoot),
+        cmocka_unit_test(crinitTimerNextIntervalSinceArmed),
+        cmocka_unit_test(crinitTimerNextIntervalZero),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-next-interval.h
+ * @brief Header declaring the unit tests for crinitTimerNextInterval().
+ */
+#ifndef __UTEST_TIMER_NEXT_INTERVAL_H__
+#define __UTEST_TIMER_NEXT_INTERVAL_H__
+
+/**
+ * Unit test for crinitTimerNextInterval(), periods counted from boot.
+ *
+ * @param state  unused
+ */
+void crinitTimerNextIntervalSinceBoot(void **state);
+/**
+ * Unit test for crinitTimerNextInterval(), periods counted from arming the timer and skipping of missed periods.
+ *
+ * @param state  unused
+ */
+void crinitTimerNextIntervalSinceArmed(void **state);
+/**
+ * Unit test for crinitTimerNextInterval(), a zero period never expires.
+ *
+ * @param state  unused
+ */
+void crinitTimerNextIntervalZero(void **state);
+
+#endif /* __UTEST_TIMER_NEXT_INTERVAL_H__ */
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-copy.c
+ * @brief Unit test for copying the timer store and saving the copy.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "timerstore.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-store.h"
+
+void crinitTimerStoreTestCopy(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char dir[] = CRINIT_TEST_TIMER_STORE_DIR_TEMPLATE;
+    assert_non_null(mkdtemp(dir));
+    char path[sizeof(dir) + 16];
+    snprintf(path, sizeof(path), "%s/timers", dir);
+
+    crinitTimerStore_t s, copy;
+    assert_int_equal(crinitTimerStoreInit(&s, path), 0);
+    // An empty store copies fine.
+    assert_int_equal(crinitTimerStoreCopy(&copy, &s), 0);
+    assert_int_equal(copy.size, 0);
+    assert_false(copy.dirty);
+    crinitTimerStoreDestroy(&copy);
+
+    assert_int_equal(crinitTimerStoreSet(&s, "daily", 1000), 0);
+    assert_int_equal(crinitTimerStoreSet(&s, "hourly", 2000), 0);
+    assert_int_equal(crinitTimerStoreCopy(&copy, &s), 0);
+    assert_true(copy.dirty);
+    assert_string_equal(copy.path, s.path);
+    assert_ptr_not_equal(copy.path, s.path);
+
+    // The copy is independent of the original.
+    assert_int_equal(crinitTimerStoreSet(&s, "daily", 3000), 0);
+    assert_int_equal(crinitTimerStoreSet(&s, "weekly", 4000), 0);
+    assert_int_equal(copy.size, 2);
+    assert_int_equal(crinitTimerStoreGet(&copy, "daily"), 1000);
+    assert_int_equal(crinitTimerStoreGet(&copy, "weekly"), 0);
+
+    // Saving the copy writes the state at the time of copying.
+    assert_int_equal(crinitTimerStoreSave(&copy), 0);
+    assert_false(copy.dirty);
+    assert_true(s.dirty);
+    crinitTimerStoreDestroy(&copy);
+    crinitTimerStoreDestroy(&s);
+
+    assert_int_equal(crinitTimerStoreInit(&s, path), 0);
+    assert_int_equal(crinitTimerStoreLoad(&s), 0);
+    assert_int_equal(s.size, 2);
+    assert_int_equal(crinitTimerStoreGet(&s, "daily"), 1000);
+    assert_int_equal(crinitTimerStoreGet(&s, "hourly"), 2000);
+    crinitTimerStoreDestroy(&s);
+
+    assert_int_equal(unlink(path), 0);
+    assert_int_equal(rmdir(dir), 0);
+}
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-malformed.c
+ * @brief Unit test for crinitTimerStoreLoad(), handling of malformed lines.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "timerstore.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-store.h"
+
+void crinitTimerStoreTestMalformed(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char dir[] = CRINIT_TEST_TIMER_STORE_DIR_TEMPLATE;
+    assert_non_null(mkdtemp(dir));
+    char path[sizeof(dir) + 16];
+    snprintf(path, sizeof(path), "%s/timers", dir);
+
+    FILE *f = fopen(path, "w");
+    assert_non_null(f);
+    fputs("1700000000 *-*-*-*-03:00:00\n"
+          "garbage\n"
+          "1700000001\n"
+          "1700000002 \n"
+          "-5 *-*-*-*-04:00:00\n"
+          "\n"
+          "1700000003 Mon..Fri-*-*-*-12:00:00",
+          f);
+    assert_int_equal(fclose(f), 0);
+
+    crinitTimerStore_t s;
+    assert_int_equal(crinitTimerStoreInit(&s, path), 0);
+    assert_int_equal(crinitTimerStoreLoad(&s), 0);
+    assert_int_equal(s.size, 2);
+    assert_int_equal(crinitTimerStoreGet(&s, "*-*-*-*-03:00:00"), 1700000000);
+    assert_int_equal(crinitTimerStoreGet(&s, "Mon..Fri-*-*-*-12:00:00"), 1700000003);
+    assert_int_equal(crinitTimerStoreGet(&s, "*-*-*-*-04:00:00"), 0);
+    crinitTimerStoreDestroy(&s);
+
+    assert_int_equal(unlink(path), 0);
+    assert_int_equal(rmdir(dir), 0);
+}
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for the timer store functions, NULL input.
+ */
+
+#include "common.h"
+#include "timerstore.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-store.h"
+
+void crinitTimerStoreTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerStore_t s;
+    assert_int_equal(crinitTimerStoreInit(NULL, "/tmp/timers"), -1);
+    assert_int_equal(crinitTimerStoreInit(&s, NULL), -1);
+    assert_int_equal(crinitTimerStoreLoad(NULL), -1);
+    assert_int_equal(crinitTimerStoreSave(NULL), -1);
+    assert_int_equal(crinitTimerStoreCopy(NULL, &s), -1);
+    assert_int_equal(crinitTimerStoreCopy(&s, NULL), -1);
+    assert_int_equal(crinitTimerStoreSet(NULL, "a", 1), -1);
+    assert_int_equal(crinitTimerStoreGet(NULL, "a"), 0);
+
+    assert_int_equal(crinitTimerStoreInit(&s, "/tmp/timers"), 0);
+    assert_int_equal(crinitTimerStoreSet(&s, NULL, 1), -1);
+    assert_int_equal(crinitTimerStoreGet(&s, NULL), 0);
+    crinitTimerStoreDestroy(&s);
+    crinitTimerStoreDestroy(NULL);
+}
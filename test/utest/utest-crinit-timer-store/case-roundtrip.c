@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-roundtrip.c
+ * @brief Unit test for saving and loading the timer store.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "timerstore.h"
+#include "unit_test.h"
+#include "utest-crinit-timer-store.h"
+
+/** Number of timers to store, more than the initial capacity to test growing. **/
+#define CRINIT_TEST_NUM_TIMERS 40
+
+void crinitTimerStoreTestRoundtrip(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char dir[] = CRINIT_TEST_TIMER_STORE_DIR_TEMPLATE;
+    assert_non_null(mkdtemp(dir));
+    char path[sizeof(dir) + 16];
+    snprintf(path, sizeof(path), "%s/timers", dir);
+
+    crinitTimerStore_t s;
+    assert_int_equal(crinitTimerStoreInit(&s, path), 0);
+    // A missing file is fine, nothing has run yet.
+    assert_int_equal(crinitTimerStoreLoad(&s), 0);
+    assert_int_equal(s.size, 0);
+    assert_int_equal(crinitTimerStoreGet(&s, "Mon..Sun-*-*-*-03:00:00"), 0);
+
+    // Insert in a scrambled order and overwrite every other one.
+    for (int i = 0; i < CRINIT_TEST_NUM_TIMERS; i++) {
+        char name[32];
+        int k = (i * 7) % CRINIT_TEST_NUM_TIMERS;
+        snprintf(name, sizeof(name), "*-*-*-*-%02d:%02d:00", k / 60, k % 60);
+        assert_int_equal(crinitTimerStoreSet(&s, name, 1000 + k), 0);
+        if (k % 2 == 0) {
+            assert_int_equal(crinitTimerStoreSet(&s, name, 2000 + k), 0);
+        }
+    }
+    assert_int_equal(s.size, CRINIT_TEST_NUM_TIMERS);
+    assert_true(s.dirty);
+    assert_int_equal(crinitTimerStoreSave(&s), 0);
+    assert_false(s.dirty);
+    // Nothing changed, nothing to write.
+    assert_int_equal(crinitTimerStoreSave(&s), 0);
+    crinitTimerStoreDestroy(&s);
+
+    assert_int_equal(crinitTimerStoreInit(&s, path), 0);
+    assert_int_equal(crinitTimerStoreLoad(&s), 0);
+    assert_int_equal(s.size, CRINIT_TEST_NUM_TIMERS);
+    assert_false(s.dirty);
+    for (int k = 0; k < CRINIT_TEST_NUM_TIMERS; k++) {
+        char name[32];
+        snprintf(name, sizeof(name), "*-*-*-*-%02d:%02d:00", k / 60, k % 60);
+        assert_int_equal(crinitTimerStoreGet(&s, name), (k % 2 == 0) ? 2000 + k : 1000 + k);
+    }
+    assert_int_equal(crinitTimerStoreGet(&s, "Mon..Sun-*-*-*-03:00:00"), 0);
+    crinitTimerStoreDestroy(&s);
+
+    assert_int_equal(unlink(path), 0);
+    assert_int_equal(rmdir(dir), 0);
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-store.c
+ * @brief Implementation of the unit test group for the timer store.
+ */
+
+#include "utest-crinit-timer-store.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for the timer store using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTimerStoreTestRoundtrip),
+        cmocka_unit_test(crinitTimerStoreTestMalformed),
+        cmocka_unit_test(crinitTimerStoreTestCopy),
+        cmocka_unit_test(crinitTimerStoreTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timer-store.h
+ * @brief Header declaring the unit tests for the timer store.
+ */
+#ifndef __UTEST_TIMER_STORE_H__
+#define __UTEST_TIMER_STORE_H__
+
+/** Template for the temporary directory the unit tests put their timer store files in. **/
+#define CRINIT_TEST_TIMER_STORE_DIR_TEMPLATE "/tmp/utest-crinit-timer-store-XXXXXX"
+
+/**
+ * Unit test for crinitTimerStoreSet(), crinitTimerStoreSave() and crinitTimerStoreLoad(), the last expirations survive
+ * a save and load, a missing file gives an empty store.
+ *
+ * @param state  unused
+ */
+void crinitTimerStoreTestRoundtrip(void **state);
+/**
+ * Unit test for crinitTimerStoreLoad(), malformed lines are skipped.
+ *
+ * @param state  unused
+ */
+void crinitTimerStoreTestMalformed(void **state);
+/**
+ * Unit test for crinitTimerStoreCopy(), the copy is independent of the original and saving it writes the state at the
+ * time of copying.
+ *
+ * @param state  unused
+ */
+void crinitTimerStoreTestCopy(void **state);
+/**
+ * Unit test for the timer store functions, handling of NULL input.
+ *
+ * @param state  unused
+ */
+void crinitTimerStoreTestNullInput(void **state);
+
+#endif /* __UTEST_TIMER_STORE_H__ */
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-expire.c
+ * @brief Unit test for crinitTimerDBArmTaskTimer(), expiration of a timer.
+ */
+
+#include "common.h"
+#include "timerdb.h"
+#include "unit_test.h"
+#include "utest-crinit-timerdb-arm-task-timer.h"
+
+void crinitTimerDBArmTaskTimerTestExpire(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char taskName[CRINIT_UTEST_TIMERDB_NAME_SIZE], timerStr[CRINIT_UTEST_TIMERDB_NAME_SIZE];
+    assert_int_equal(crinitTimerDBArmTaskTimer("other", "after:1h"), 0);
+    assert_int_equal(crinitTimerDBArmTaskTimer("expire", "after:50ms"), 0);
+
+    // Only the dependency of the task the timer has been armed for is fulfilled, then the timer is gone.
+    assert_int_equal(crinitTimerDBTestWaitFulfilled(taskName, timerStr, 5000), 0);
+    assert_string_equal(taskName, "expire");
+    assert_string_equal(timerStr, "after:50ms");
+    assert_int_equal(crinitTimerDBTestCount("expire", "after:50ms", NULL), 0);
+    assert_int_equal(crinitTimerDBTestCount("other", "after:1h", NULL), 1);
+    assert_int_equal(crinitTimerDBTestWaitFulfilled(taskName, timerStr, 200), -1);
+
+    crinitTimerDBDisarmTaskTimer("other", "after:1h");
+}
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitTimerDBArmTaskTimer() and crinitTimerDBDisarmTaskTimer(), NULL pointer input.
+ */
+
+#include <stddef.h>
+
+#include "common.h"
+#include "timerdb.h"
+#include "unit_test.h"
+#include "utest-crinit-timerdb-arm-task-timer.h"
+
+void crinitTimerDBArmTaskTimerTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    assert_int_equal(crinitTimerDBArmTaskTimer(NULL, "after:1h"), -1);
+    assert_int_equal(crinitTimerDBArmTaskTimer("null", NULL), -1);
+    assert_false(crinitTimerDBIsTaskTimer(NULL));
+    crinitTimerDBDisarmTaskTimer(NULL, "after:1h");
+    crinitTimerDBDisarmTaskTimer("null", NULL);
+}
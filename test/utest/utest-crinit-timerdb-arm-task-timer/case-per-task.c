@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-per-task.c
+ * @brief Unit test for crinitTimerDBArmTaskTimer() and crinitTimerDBDisarmTaskTimer(), timers are armed per task.
+ */
+
+#include "common.h"
+#include "timerdb.h"
+#include "unit_test.h"
+#include "utest-crinit-timerdb-arm-task-timer.h"
+
+void crinitTimerDBArmTaskTimerTestPerTask(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    assert_true(crinitTimerDBIsTaskTimer("after:30s"));
+    assert_false(crinitTimerDBIsTaskTimer("every:30s"));
+    assert_false(crinitTimerDBIsTaskTimer("daily"));
+
+    // The same spelling in two tasks and two spellings in the same task give separate timers.
+    assert_int_equal(crinitTimerDBArmTaskTimer("taskA", "after:1h"), 0);
+    assert_int_equal(crinitTimerDBArmTaskTimer("taskB", "after:1h"), 0);
+    assert_int_equal(crinitTimerDBArmTaskTimer("taskA", "after:2h"), 0);
+    assert_int_equal(crinitTimerDBTestCount("taskA", "after:1h", NULL), 1);
+    assert_int_equal(crinitTimerDBTestCount("taskB", "after:1h", NULL), 1);
+    assert_int_equal(crinitTimerDBTestCount("taskA", "after:2h", NULL), 1);
+
+    crinitTimerDBDisarmTaskTimer("taskA", "after:1h");
+    assert_int_equal(crinitTimerDBTestCount("taskA", "after:1h", NULL), 0);
+    assert_int_equal(crinitTimerDBTestCount("taskB", "after:1h", NULL), 1);
+    assert_int_equal(crinitTimerDBTestCount("taskA", "after:2h", NULL), 1);
+
+    // Disarming a timer which is not armed does nothing.
+    crinitTimerDBDisarmTaskTimer("taskA", "after:1h");
+    crinitTimerDBDisarmTaskTimer("taskC", "after:2h");
+    assert_int_equal(crinitTimerDBTestCount("taskB", "after:1h", NULL), 1);
+    assert_int_equal(crinitTimerDBTestCount("taskA", "after:2h", NULL), 1);
+
+    // Only `after:` timers are armed per task.
+    assert_int_equal(crinitTimerDBArmTaskTimer("taskA", "every:1h"), -1);
+    assert_int_equal(crinitTimerDBArmTaskTimer("taskA", "after:"), -1);
+    assert_int_equal(crinitTimerDBTestCount("taskA", "every:1h", NULL), 0);
+
+    crinitTimerDBDisarmTaskTimer("taskB", "after:1h");
+    crinitTimerDBDisarmTaskTimer("taskA", "after:2h");
+    assert_int_equal(crinitTimerDBTestCount("taskB", "after:1h", NULL), 0);
+    assert_int_equal(crinitTimerDBTestCount("taskA", "after:2h", NULL), 0);
+}
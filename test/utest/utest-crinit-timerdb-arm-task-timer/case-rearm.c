@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-rearm.c
+ * @brief Unit test for crinitTimerDBArmTaskTimer(), re-arming resets the deadline.
+ */
+
+#include <time.h>
+
+#include "common.h"
+#include "timerdb.h"
+#include "unit_test.h"
+#include "utest-crinit-timerdb-arm-task-timer.h"
+
+/** Time to wait between arming a timer and arming it again. **/
+#define CRINIT_TEST_REARM_DELAY_NS 20000000L
+
+void crinitTimerDBArmTaskTimerTestRearm(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    struct timespec before, first, second;
+    assert_int_equal(clock_gettime(CLOCK_BOOTTIME, &before), 0);
+    assert_int_equal(crinitTimerDBArmTaskTimer("rearm", "after:1h"), 0);
+    assert_int_equal(crinitTimerDBTestCount("rearm", "after:1h", &first), 1);
+    // The period counts from when the timer has been armed.
+    assert_true(first.tv_sec >= before.tv_sec + 3600);
+    assert_true(first.tv_sec <= before.tv_sec + 3601);
+
+    const struct timespec delay = {.tv_sec = 0, .tv_nsec = CRINIT_TEST_REARM_DELAY_NS};
+    nanosleep(&delay, NULL);
+
+    // Arming it again moves the deadline instead of adding a second timer.
+    assert_int_equal(crinitTimerDBArmTaskTimer("rearm", "after:1h"), 0);
+    assert_int_equal(crinitTimerDBTestCount("rearm", "after:1h", &second), 1);
+    long long diffNs =
+        (long long)(second.tv_sec - first.tv_sec) * 1000000000LL + (long long)(second.tv_nsec - first.tv_nsec);
+    assert_true(diffNs >= CRINIT_TEST_REARM_DELAY_NS);
+
+    crinitTimerDBDisarmTaskTimer("rearm", "after:1h");
+    assert_int_equal(crinitTimerDBTestCount("rearm", "after:1h", NULL), 0);
+}
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timerdb-arm-task-timer.c
+ * @brief Implementation of the unit test group for the `@timer:after:` timers armed per task.
+ */
+
+#include "utest-crinit-timerdb-arm-task-timer.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "common.h"
+#include "globopt.h"
+#include "taskdb.h"
+#include "timerdb.h"
+#include "unit_test.h"
+
+extern crinitTimerDB_t crinitTimerPool;
+
+static crinitTaskDB_t crinitTestTaskDB;
+static pthread_mutex_t crinitTestLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t crinitTestFulfilled = PTHREAD_COND_INITIALIZER;
+static size_t crinitTestNumFulfilled = 0;
+static char crinitTestTaskName[CRINIT_UTEST_TIMERDB_NAME_SIZE];
+static char crinitTestTimerStr[CRINIT_UTEST_TIMERDB_NAME_SIZE];
+
+/**
+ * Stub replacing the TaskDB, the tests only use `@timer:after:` timers.
+ */
+int crinitTaskDBFulfillDeps(crinitTaskDB_t *ctx, const crinitTaskDep_t *deps, size_t numDeps) {
+    CRINIT_PARAM_UNUSED(ctx);
+    CRINIT_PARAM_UNUSED(deps);
+    CRINIT_PARAM_UNUSED(numDeps);
+    return 0;
+}
+
+/**
+ * Stub replacing the TaskDB, the tests only use `@timer:after:` timers.
+ */
+int crinitTaskDBReleaseRespawn(crinitTaskDB_t *ctx, const char *taskName) {
+    CRINIT_PARAM_UNUSED(ctx);
+    CRINIT_PARAM_UNUSED(taskName);
+    return 0;
+}
+
+/**
+ * Stub replacing the TaskDB, records the dependency fulfilled by the timer thread.
+ */
+int crinitTaskDBRemoveDepFromTask(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, const char *taskName) {
+    CRINIT_PARAM_UNUSED(ctx);
+    pthread_mutex_lock(&crinitTestLock);
+    if (strcmp(dep->name, "@timer") == 0) {
+        snprintf(crinitTestTaskName, sizeof(crinitTestTaskName), "%s", taskName);
+        snprintf(crinitTestTimerStr, sizeof(crinitTestTimerStr), "%s", dep->event);
+        crinitTestNumFulfilled++;
+        pthread_cond_broadcast(&crinitTestFulfilled);
+    }
+    pthread_mutex_unlock(&crinitTestLock);
+    return 0;
+}
+
+size_t crinitTimerDBTestCount(const char *taskName, const char *timerStr, struct timespec *next) {
+    size_t n = 0;
+    pthread_mutex_lock(&crinitTimerPool.lock);
+    const crinitTimerHeap_t *h = &crinitTimerPool.after.heap;
+    for (size_t i = 0; i < h->size; i++) {
+        const char *name = h->timers[i].name;
+        if (strcmp(name, taskName) == 0 && strcmp(name + strlen(name) + 1, timerStr) == 0) {
+            if (next != NULL) {
+                *next = h->timers[i].next.it_value;
+            }
+            n++;
+        }
+    }
+    pthread_mutex_unlock(&crinitTimerPool.lock);
+    return n;
+}
+
+int crinitTimerDBTestWaitFulfilled(char *taskName, char *timerStr, long timeoutMs) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += (timeoutMs % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    int res = 0;
+    pthread_mutex_lock(&crinitTestLock);
+    while (crinitTestNumFulfilled == 0 && res == 0) {
+        res = pthread_cond_timedwait(&crinitTestFulfilled, &crinitTestLock, &deadline);
+    }
+    if (crinitTestNumFulfilled > 0) {
+        memcpy(taskName, crinitTestTaskName, CRINIT_UTEST_TIMERDB_NAME_SIZE);
+        memcpy(timerStr, crinitTestTimerStr, CRINIT_UTEST_TIMERDB_NAME_SIZE);
+        crinitTestNumFulfilled--;
+        res = 0;
+    }
+    pthread_mutex_unlock(&crinitTestLock);
+    return (res == 0) ? 0 : -1;
+}
+
+/**
+ * Initializes the TimerDB and starts the timer thread once for all tests of the group.
+ */
+static int crinitTimerDBTestGroupSetup(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+    if (crinitGlobOptInitDefault() == -1 || crinitTimerDBInit(&crinitTestTaskDB) == -1) {
+        return -1;
+    }
+    return crinitTimerDBSpawn();
+}
+
+/**
+ * Runs the unit test group for the `@timer:after:` timers armed per task using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTimerDBArmTaskTimerTestRearm),
+        cmocka_unit_test(crinitTimerDBArmTaskTimerTestPerTask),
+        cmocka_unit_test(crinitTimerDBArmTaskTimerTestExpire),
+        cmocka_unit_test(crinitTimerDBArmTaskTimerTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, crinitTimerDBTestGroupSetup, NULL);
+}
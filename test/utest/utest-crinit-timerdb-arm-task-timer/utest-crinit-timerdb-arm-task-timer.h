@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timerdb-arm-task-timer.h
+ * @brief Header declaring the unit tests for the `@timer:after:` timers armed per task.
+ */
+#ifndef __UTEST_TIMERDB_ARM_TASK_TIMER_H__
+#define __UTEST_TIMERDB_ARM_TASK_TIMER_H__
+
+#include <stddef.h>
+#include <time.h>
+
+/** Size of the buffers for the task name and spelling of a fulfilled dependency. **/
+#define CRINIT_UTEST_TIMERDB_NAME_SIZE 64
+
+/**
+ * Count the timers armed for a task and spelling and get the deadline of the last one found.
+ *
+ * @param taskName  The name of the task.
+ * @param timerStr  The spelling of the timer.
+ * @param next      Return pointer for the deadline on `CLOCK_BOOTTIME`, may be NULL.
+ *
+ * @return the number of matching timers in the TimerDB
+ */
+size_t crinitTimerDBTestCount(const char *taskName, const char *timerStr, struct timespec *next);
+/**
+ * Wait for the timer thread to fulfill an `@timer:after:` dependency.
+ *
+ * @param taskName   Return buffer for the name of the task of #CRINIT_UTEST_TIMERDB_NAME_SIZE bytes.
+ * @param timerStr   Return buffer for the spelling of the timer of #CRINIT_UTEST_TIMERDB_NAME_SIZE bytes.
+ * @param timeoutMs  How long to wait at most.
+ *
+ * @return 0 once a dependency has been fulfilled, -1 on timeout
+ */
+int crinitTimerDBTestWaitFulfilled(char *taskName, char *timerStr, long timeoutMs);
+
+/**
+ * Unit test for crinitTimerDBArmTaskTimer(), arming a timer again resets its deadline.
+ *
+ * @param state  unused
+ */
+void crinitTimerDBArmTaskTimerTestRearm(void **state);
+/**
+ * Unit test for crinitTimerDBArmTaskTimer() and crinitTimerDBDisarmTaskTimer(), timers are not shared between tasks.
+ *
+ * @param state  unused
+ */
+void crinitTimerDBArmTaskTimerTestPerTask(void **state);
+/**
+ * Unit test for crinitTimerDBArmTaskTimer(), an expired timer fulfills the dependency of its task once.
+ *
+ * @param state  unused
+ */
+void crinitTimerDBArmTaskTimerTestExpire(void **state);
+/**
+ * Unit test for crinitTimerDBArmTaskTimer() and crinitTimerDBDisarmTaskTimer(), handling of NULL input.
+ *
+ * @param state  unused
+ */
+void crinitTimerDBArmTaskTimerTestNullInput(void **state);
+
+#endif /* __UTEST_TIMERDB_ARM_TASK_TIMER_H__ */
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-clock-step.c
+ * @brief Unit test for crinitTimerDBClockSet(), only timers which have really missed an expiration are caught up on.
+ */
+
+#include "common.h"
+#include "timerdb.h"
+#include "unit_test.h"
+#include "utest-crinit-timerdb-clock-set.h"
+
+/** 2030-06-15 12:00:00 UTC. **/
+#define CRINIT_UTEST_FIRST_SET 1907755200
+/** 2030-06-20 12:00:00 UTC. **/
+#define CRINIT_UTEST_SECOND_SET 1908187200
+
+void crinitTimerDBClockSetTestClockStep(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char early[] = "*-*-*-11:30:00";
+    char late[] = "*-*-*-18:00:00";
+    char daily[] = "daily";
+    struct timespec bootAdded, next;
+    assert_int_equal(clock_gettime(CLOCK_BOOTTIME, &bootAdded), 0);
+    crinitTimerDBAddTimer(early);
+    crinitTimerDBAddTimer(late);
+    crinitTimerDBAddTimer(daily);
+
+    crinitTimerDBStats_t before, after;
+    assert_int_equal(crinitTimerDBGetStats(&before), 0);
+
+    // Years of expirations are skipped over, but only 11:30 has really passed within the hour since the timers have
+    // been added.
+    struct timespec now = {.tv_sec = CRINIT_UTEST_FIRST_SET, .tv_nsec = 0};
+    struct timespec bootNow = {.tv_sec = bootAdded.tv_sec + 3600, .tv_nsec = bootAdded.tv_nsec};
+    crinitTimerDBClockSet(&now, &bootNow);
+    assert_int_equal(crinitTimerDBGetStats(&after), 0);
+    assert_int_equal(after.clockSets, before.clockSets + 1);
+    assert_int_equal(after.catchUps, before.catchUps + 1);
+    assert_int_equal(crinitTimerDBTestNext(early, &next), 0);
+    assert_int_equal(next.tv_sec, now.tv_sec);
+    assert_int_equal(crinitTimerDBTestNext(late, &next), 0);
+    assert_int_equal(next.tv_sec, CRINIT_UTEST_FIRST_SET + 6 * 3600);
+    assert_int_equal(crinitTimerDBTestNext(daily, &next), 0);
+    assert_int_equal(next.tv_sec, CRINIT_UTEST_FIRST_SET + 12 * 3600);
+
+    // A day has passed without any of them expiring, each has missed several expirations and is caught up on once.
+    before = after;
+    now.tv_sec = CRINIT_UTEST_SECOND_SET;
+    bootNow.tv_sec = bootAdded.tv_sec + 25 * 3600;
+    crinitTimerDBClockSet(&now, &bootNow);
+    assert_int_equal(crinitTimerDBGetStats(&after), 0);
+    assert_int_equal(after.clockSets, before.clockSets + 1);
+    assert_int_equal(after.catchUps, before.catchUps + 3);
+    assert_int_equal(crinitTimerDBTestNext(early, &next), 0);
+    assert_int_equal(next.tv_sec, now.tv_sec);
+    assert_int_equal(crinitTimerDBTestNext(late, &next), 0);
+    assert_int_equal(next.tv_sec, now.tv_sec);
+    assert_int_equal(crinitTimerDBTestNext(daily, &next), 0);
+    assert_int_equal(next.tv_sec, now.tv_sec);
+
+    crinitTimerDBRemoveTimer(early);
+    crinitTimerDBRemoveTimer(late);
+    crinitTimerDBRemoveTimer(daily);
+    assert_int_equal(crinitTimerDBTestNext(daily, &next), -1);
+}
@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitTimerDBClockSet(), handling of NULL input.
+ */
+
+#include "common.h"
+#include "timerdb.h"
+#include "unit_test.h"
+#include "utest-crinit-timerdb-clock-set.h"
+
+void crinitTimerDBClockSetTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTimerDBStats_t before, after;
+    struct timespec ts = {0};
+    assert_int_equal(crinitTimerDBGetStats(&before), 0);
+    crinitTimerDBClockSet(NULL, &ts);
+    crinitTimerDBClockSet(&ts, NULL);
+    crinitTimerDBClockSet(NULL, NULL);
+    assert_int_equal(crinitTimerDBGetStats(&after), 0);
+    assert_int_equal(after.clockSets, before.clockSets);
+    assert_int_equal(after.catchUps, before.catchUps);
+}
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timerdb-clock-set.c
+ * @brief Implementation of the unit test group for rescheduling the calendar timers after the system time has been set.
+ */
+
+#include "utest-crinit-timerdb-clock-set.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include "common.h"
+#include "globopt.h"
+#include "taskdb.h"
+#include "timerdb.h"
+#include "unit_test.h"
+
+extern crinitTimerDB_t crinitTimerPool;
+
+static crinitTaskDB_t crinitTestTaskDB;
+
+/**
+ * Stub replacing the TaskDB, the timer thread is not started.
+ */
+int crinitTaskDBFulfillDeps(crinitTaskDB_t *ctx, const crinitTaskDep_t *deps, size_t numDeps) {
+    CRINIT_PARAM_UNUSED(ctx);
+    CRINIT_PARAM_UNUSED(deps);
+    CRINIT_PARAM_UNUSED(numDeps);
+    return 0;
+}
+
+/**
+ * Stub replacing the TaskDB, the timer thread is not started.
+ */
+int crinitTaskDBReleaseRespawn(crinitTaskDB_t *ctx, const char *taskName) {
+    CRINIT_PARAM_UNUSED(ctx);
+    CRINIT_PARAM_UNUSED(taskName);
+    return 0;
+}
+
+/**
+ * Stub replacing the TaskDB, the timer thread is not started.
+ */
+int crinitTaskDBRemoveDepFromTask(crinitTaskDB_t *ctx, const crinitTaskDep_t *dep, const char *taskName) {
+    CRINIT_PARAM_UNUSED(ctx);
+    CRINIT_PARAM_UNUSED(dep);
+    CRINIT_PARAM_UNUSED(taskName);
+    return 0;
+}
+
+int crinitTimerDBTestNext(const char *name, struct timespec *next) {
+    int res = -1;
+    pthread_mutex_lock(&crinitTimerPool.lock);
+    const crinitTimerHeap_t *h = &crinitTimerPool.calendar.heap;
+    for (size_t i = 0; i < h->size; i++) {
+        if (strcmp(h->timers[i].name, name) == 0) {
+            *next = h->timers[i].next.it_value;
+            res = 0;
+        }
+    }
+    pthread_mutex_unlock(&crinitTimerPool.lock);
+    return res;
+}
+
+/**
+ * Initializes the TimerDB once for all tests of the group. The timer thread is not started, so timers only change
+ * through the functions under test.
+ */
+static int crinitTimerDBTestGroupSetup(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+    if (crinitGlobOptInitDefault() == -1) {
+        return -1;
+    }
+    return crinitTimerDBInit(&crinitTestTaskDB);
+}
+
+/**
+ * Runs the unit test group for rescheduling the calendar timers after the system time has been set using the cmocka
+ * API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTimerDBClockSetTestClockStep),
+        cmocka_unit_test(crinitTimerDBClockSetTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, crinitTimerDBTestGroupSetup, NULL);
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-timerdb-clock-set.h
+ * @brief Header declaring the unit tests for rescheduling the calendar timers after the system time has been set.
+ */
+#ifndef __UTEST_TIMERDB_CLOCK_SET_H__
+#define __UTEST_TIMERDB_CLOCK_SET_H__
+
+#include <time.h>
+
+/**
+ * Get the next expiration of a calendar timer in the TimerDB.
+ *
+ * @param name  The name of the timer.
+ * @param next  Return pointer for the next expiration.
+ *
+ * @return 0 on success, -1 if there is no such timer
+ */
+int crinitTimerDBTestNext(const char *name, struct timespec *next);
+
+/**
+ * Unit test for crinitTimerDBClockSet(), only timers which have really missed an expiration are caught up on, once.
+ *
+ * @param state  unused
+ */
+void crinitTimerDBClockSetTestClockStep(void **state);
+/**
+ * Unit test for crinitTimerDBClockSet(), handling of NULL input.
+ *
+ * @param state  unused
+ */
+void crinitTimerDBClockSetTestNullInput(void **state);
+
+#endif /* __UTEST_TIMERDB_CLOCK_SET_H__ */
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitTraceRead(), NULL pointer input.
+ */
+
+#include "common.h"
+#include "trace.h"
+#include "unit_test.h"
+#include "utest-crinit-trace-read.h"
+
+void crinitTraceReadTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    crinitTraceRecord_t rec;
+    uint64_t seq = 0, dropped = 0;
+    assert_int_equal(crinitTraceRead(NULL, 1, &seq, &dropped), 0);
+    assert_int_equal(crinitTraceRead(&rec, 1, NULL, &dropped), 0);
+    assert_int_equal(crinitTraceRead(&rec, 1, &seq, NULL), 0);
+}
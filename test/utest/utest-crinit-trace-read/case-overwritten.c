@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-overwritten.c
+ * @brief Unit test for crinitTraceRead(), reading records which have been overwritten.
+ */
+
+#include "common.h"
+#include "trace.h"
+#include "unit_test.h"
+#include "utest-crinit-trace-read.h"
+
+void crinitTraceReadTestOverwritten(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    // Continues after the four records of crinitTraceReadTestSuccess().
+    for (int64_t i = 0; i < CRINIT_TRACE_RECORDS + 10; i++) {
+        crinitTraceInstant(CRINIT_TRACE_LOCK_WAIT, i, "lock");
+    }
+
+    crinitTraceRecord_t rec;
+    uint64_t seq = 0, dropped = 0;
+    assert_int_equal(crinitTraceRead(&rec, 1, &seq, &dropped), 1);
+    assert_int_equal(dropped, 14);
+    assert_int_equal(seq, 15);
+    assert_int_equal(rec.arg, 10);
+
+    seq = CRINIT_TRACE_RECORDS + 13;
+    assert_int_equal(crinitTraceRead(&rec, 1, &seq, &dropped), 1);
+    assert_int_equal(dropped, 0);
+    assert_int_equal(rec.arg, CRINIT_TRACE_RECORDS + 9);
+}
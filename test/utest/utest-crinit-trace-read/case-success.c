@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitTraceRead(), successful execution.
+ */
+
+#include <string.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "trace.h"
+#include "unit_test.h"
+#include "utest-crinit-trace-read.h"
+
+void crinitTraceReadTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    uint64_t start = crinitTraceNow();
+    crinitTraceInstant(CRINIT_TRACE_TASK_INSERT, 0, "%s", "task_a");
+    crinitTraceSpan(CRINIT_TRACE_CMD_EXEC, start, 42, "%s", "task_a");
+    crinitTraceInstant(CRINIT_TRACE_DEP_FULFILL, 0, "%s:%s", "task_a", "spawn\n");
+    crinitTraceInstant(CRINIT_TRACE_STATE_CHANGE, CRINIT_TASK_STATE_RUNNING, "%s",
+                       "a_task_name_which_is_too_long_for_the_record");
+
+    crinitTraceRecord_t recs[3];
+    uint64_t seq = 0, dropped = 1;
+    assert_int_equal(crinitTraceRead(recs, 3, &seq, &dropped), 3);
+    assert_int_equal(seq, 3);
+    assert_int_equal(dropped, 0);
+
+    assert_int_equal(recs[0].type, CRINIT_TRACE_TASK_INSERT);
+    assert_string_equal(recs[0].name, "task_a");
+    assert_int_equal(recs[0].dur, 0);
+    assert_int_equal(recs[0].tid, getpid());
+
+    assert_int_equal(recs[1].type, CRINIT_TRACE_CMD_EXEC);
+    assert_int_equal(recs[1].ts, start);
+    assert_int_equal(recs[1].arg, 42);
+    assert_true(recs[1].ts + recs[1].dur >= recs[0].ts);
+
+    assert_int_equal(recs[2].type, CRINIT_TRACE_DEP_FULFILL);
+    assert_string_equal(recs[2].name, "task_a:spawn ");
+
+    assert_int_equal(crinitTraceRead(recs, 3, &seq, &dropped), 1);
+    assert_int_equal(seq, 4);
+    assert_int_equal(recs[0].type, CRINIT_TRACE_STATE_CHANGE);
+    assert_int_equal(recs[0].arg, CRINIT_TASK_STATE_RUNNING);
+    assert_int_equal(strlen(recs[0].name), CRINIT_TRACE_NAME_MAX - 1);
+    assert_memory_equal(recs[0].name, "a_task_name_which_is_too_long_f", CRINIT_TRACE_NAME_MAX - 1);
+
+    // Caught up with the trace.
+    assert_int_equal(crinitTraceRead(recs, 3, &seq, &dropped), 0);
+    assert_int_equal(seq, 4);
+}
@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-trace-read.c
+ * @brief Implementation of the crinitTraceRead() unit test group.
+ */
+
+#include "utest-crinit-trace-read.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitTraceRead() using the cmocka API.
+ *
+ * The tests share the trace ring buffer and need to run in this order.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitTraceReadTestSuccess),
+        cmocka_unit_test(crinitTraceReadTestOverwritten),
+        cmocka_unit_test(crinitTraceReadTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
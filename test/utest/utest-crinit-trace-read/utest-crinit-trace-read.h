@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-crinit-trace-read.h
+ * @brief Header declaring the unit tests for crinitTraceRead().
+ */
+#ifndef __UTEST_CRINIT_TRACE_READ_H__
+#define __UTEST_CRINIT_TRACE_READ_H__
+
+/**
+ * Tests reading back recorded events in chunks.
+ */
+void crinitTraceReadTestSuccess(void **state);
+/**
+ * Tests reading from a sequence number which has already been overwritten.
+ */
+void crinitTraceReadTestOverwritten(void **state);
+/**
+ * Tests detection of NULL pointer input.
+ */
+void crinitTraceReadTestNullInput(void **state);
+
+#endif /* __UTEST_CRINIT_TRACE_READ_H__ */
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-null-input.c
+ * @brief Unit test for crinitGlobOptSnapshotAcquire() and crinitGlobOptGetString(), NULL pointer input.
+ */
+
+#include <stddef.h>
+
+#include "common.h"
+#include "globopt.h"
+#include "unit_test.h"
+#include "utest-globopt-snapshot.h"
+
+void crinitGlobOptSnapshotTestNullInput(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    crinitGlobOptSnapshotRelease(NULL);
+    assert_int_equal(crinitGlobOptGetString(offsetof(crinitGlobOptStore_t, CRINIT_GLOBOPT_INCLDIR), NULL), -1);
+
+    // An unset optional string is NULL in the snapshot.
+    const crinitGlobOptStore_t *snap = crinitGlobOptSnapshotAcquire();
+    assert_non_null(snap);
+    assert_null(snap->timerStateFile);
+    crinitGlobOptSnapshotRelease(snap);
+    crinitGlobOptDestroy();
+}
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-other-thread.c
+ * @brief Unit test for crinitGlobOptSnapshotAcquire(), an option set before is seen by another thread.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "globopt.h"
+#include "unit_test.h"
+#include "utest-globopt-snapshot.h"
+
+/** Number of times an option is set and then read from another thread. **/
+#define CRINIT_UTEST_SNAPSHOT_ROUNDS 1000
+
+/** Number of threads acquiring snapshots in the background. **/
+#define CRINIT_UTEST_SNAPSHOT_BACKGROUND 4
+
+/** Tells the threads acquiring snapshots in the background to stop. **/
+static atomic_bool crinitTestStop = false;
+
+/**
+ * Keeps acquiring and releasing snapshots, so some of them race with the one under test.
+ */
+static void *crinitTestBackgroundReader(void *args) {
+    CRINIT_PARAM_UNUSED(args);
+    while (!atomic_load(&crinitTestStop)) {
+        crinitGlobOptSnapshotRelease(crinitGlobOptSnapshotAcquire());
+    }
+    return NULL;
+}
+
+/**
+ * Acquires a snapshot and returns its shutdown grace period.
+ */
+static void *crinitTestReader(void *args) {
+    CRINIT_PARAM_UNUSED(args);
+    const crinitGlobOptStore_t *snap = crinitGlobOptSnapshotAcquire();
+    if (snap == NULL) {
+        return NULL;
+    }
+    uintptr_t shdGraceP = snap->shdGraceP;
+    crinitGlobOptSnapshotRelease(snap);
+    return (void *)shdGraceP;
+}
+
+void crinitGlobOptSnapshotTestOtherThread(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    pthread_t background[CRINIT_UTEST_SNAPSHOT_BACKGROUND];
+    atomic_store(&crinitTestStop, false);
+    for (size_t i = 0; i < CRINIT_UTEST_SNAPSHOT_BACKGROUND; i++) {
+        assert_int_equal(pthread_create(&background[i], NULL, crinitTestBackgroundReader, NULL), 0);
+    }
+
+    for (unsigned long long i = 1; i <= CRINIT_UTEST_SNAPSHOT_ROUNDS; i++) {
+        assert_int_equal(crinitGlobOptSet(CRINIT_GLOBOPT_SHDGRACEP, i), 0);
+        pthread_t reader;
+        void *shdGraceP = NULL;
+        assert_int_equal(pthread_create(&reader, NULL, crinitTestReader, NULL), 0);
+        assert_int_equal(pthread_join(reader, &shdGraceP), 0);
+        // A snapshot acquired after the option has been set must contain it, even if another thread is just
+        // rebuilding the snapshot.
+        assert_int_equal((uintptr_t)shdGraceP, i);
+    }
+
+    atomic_store(&crinitTestStop, true);
+    for (size_t i = 0; i < CRINIT_UTEST_SNAPSHOT_BACKGROUND; i++) {
+        assert_int_equal(pthread_join(background[i], NULL), 0);
+    }
+    crinitGlobOptDestroy();
+}
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitGlobOptSnapshotAcquire(), successful execution.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "confparse.h"
+#include "globopt.h"
+#include "unit_test.h"
+#include "utest-globopt-snapshot.h"
+
+void crinitGlobOptSnapshotTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitGlobOptSet(CRINIT_GLOBOPT_INCLDIR, "/etc/crinit/incl"), 0);
+    assert_int_equal(crinitGlobOptSet(CRINIT_GLOBOPT_SHDGRACEP, 42ULL), 0);
+    assert_int_equal(crinitGlobOptSet(CRINIT_GLOBOPT_USE_SYSLOG, true), 0);
+
+    const crinitGlobOptStore_t *snap = crinitGlobOptSnapshotAcquire();
+    assert_non_null(snap);
+    assert_string_equal(snap->inclDir, "/etc/crinit/incl");
+    assert_string_equal(snap->inclSuffix, CRINIT_CONFIG_DEFAULT_INCL_SUFFIX);
+    assert_int_equal(snap->shdGraceP, 42);
+    assert_true(snap->useSyslog);
+    assert_null(snap->tasks);
+    assert_null(snap->globEnv.envp);
+
+    // Without a change in between, the same snapshot is handed out again.
+    const crinitGlobOptStore_t *again = crinitGlobOptSnapshotAcquire();
+    assert_ptr_equal(snap, again);
+    crinitGlobOptSnapshotRelease(again);
+    crinitGlobOptSnapshotRelease(snap);
+
+    crinitGlobOptDestroy();
+}
+
+void crinitGlobOptSnapshotTestOldSnapshotValid(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    assert_int_equal(crinitGlobOptInitDefault(), 0);
+    assert_int_equal(crinitGlobOptSet(CRINIT_GLOBOPT_LAUNCHER_CMD, "/usr/bin/old-launcher"), 0);
+
+    const crinitGlobOptStore_t *oldSnap = crinitGlobOptSnapshotAcquire();
+    assert_non_null(oldSnap);
+
+    assert_int_equal(crinitGlobOptSet(CRINIT_GLOBOPT_LAUNCHER_CMD, "/usr/bin/new-launcher"), 0);
+    const crinitGlobOptStore_t *newSnap = crinitGlobOptSnapshotAcquire();
+    assert_non_null(newSnap);
+    assert_ptr_not_equal(oldSnap, newSnap);
+    assert_string_equal(newSnap->launcherCmd, "/usr/bin/new-launcher");
+    assert_string_equal(oldSnap->launcherCmd, "/usr/bin/old-launcher");
+
+    char *launcherCmd = NULL;
+    assert_int_equal(crinitGlobOptGet(CRINIT_GLOBOPT_LAUNCHER_CMD, &launcherCmd), 0);
+    assert_string_equal(launcherCmd, "/usr/bin/new-launcher");
+    free(launcherCmd);
+
+    crinitGlobOptSnapshotRelease(oldSnap);
+    crinitGlobOptSnapshotRelease(newSnap);
+
+    // A snapshot held across crinitGlobOptDestroy() stays valid until released.
+    const crinitGlobOptStore_t *held = crinitGlobOptSnapshotAcquire();
+    assert_non_null(held);
+    crinitGlobOptDestroy();
+    assert_string_equal(held->launcherCmd, "/usr/bin/new-launcher");
+    crinitGlobOptSnapshotRelease(held);
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-globopt-snapshot.c
+ * @brief Implementation of the crinitGlobOptSnapshotAcquire() unit test group.
+ */
+
+#include "utest-globopt-snapshot.h"
+
+#include "unit_test.h"
+
+/**
+ * Runs the unit test group for crinitGlobOptSnapshotAcquire() using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitGlobOptSnapshotTestSuccess),
+        cmocka_unit_test(crinitGlobOptSnapshotTestOldSnapshotValid),
+        cmocka_unit_test(crinitGlobOptSnapshotTestOtherThread),
+        cmocka_unit_test(crinitGlobOptSnapshotTestNullInput),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-globopt-snapshot.h
+ * @brief Header declaring the unit tests for crinitGlobOptSnapshotAcquire() and crinitGlobOptSnapshotRelease().
+ */
+#ifndef __UTEST_GLOBOPT_SNAPSHOT_H__
+#define __UTEST_GLOBOPT_SNAPSHOT_H__
+
+/**
+ * Tests that a snapshot contains the current option values and strings.
+ */
+void crinitGlobOptSnapshotTestSuccess(void **state);
+/**
+ * Tests that a snapshot stays valid and unchanged after the options have been changed.
+ */
+void crinitGlobOptSnapshotTestOldSnapshotValid(void **state);
+/**
+ * Tests that a snapshot acquired by another thread after an option has been set contains the new value.
+ */
+void crinitGlobOptSnapshotTestOtherThread(void **state);
+/**
+ * Tests handling of NULL pointer input.
+ */
+void crinitGlobOptSnapshotTestNullInput(void **state);
+
+#endif /* __UTEST_GLOBOPT_SNAPSHOT_H__ */
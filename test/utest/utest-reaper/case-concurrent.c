@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-concurrent.c
+ * @brief Unit test for concurrent calls of crinitReaperSpawn() and crinitReaperWait().
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/wait.h>
+
+#include "common.h"
+#include "reaper.h"
+#include "unit_test.h"
+#include "utest-reaper.h"
+
+/** Number of threads spawning processes at the same time. **/
+#define CRINIT_UTEST_REAPER_THREADS 8
+/** Number of processes spawned by each thread. **/
+#define CRINIT_UTEST_REAPER_SPAWNS 20
+
+/**
+ * Spawns processes exiting immediately with an exit code depending on the thread and checks their exit statuses.
+ *
+ * @param args  Pointer to the index of the thread.
+ *
+ * @return  NULL if all exit statuses were correct, \a args otherwise
+ */
+static void *crinitReaperTestSpawnThread(void *args) {
+    int idx = *(int *)args;
+    char exitCmd[16];
+    snprintf(exitCmd, sizeof(exitCmd), "exit %d", idx);
+    char *const envp[] = {NULL};
+    char *const argv[] = {CRINIT_UTEST_REAPER_SHELL, "-c", exitCmd, NULL};
+
+    for (int i = 0; i < CRINIT_UTEST_REAPER_SPAWNS; i++) {
+        pid_t pid = -1;
+        siginfo_t status;
+        if (crinitReaperSpawn(&pid, CRINIT_UTEST_REAPER_SHELL, NULL, NULL, argv, envp) == -1 ||
+            crinitReaperWait(pid, &status, NULL) == -1 || status.si_pid != pid || status.si_code != CLD_EXITED ||
+            status.si_status != idx) {
+            return args;
+        }
+    }
+    return NULL;
+}
+
+void crinitReaperTestConcurrent(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    pthread_t threads[CRINIT_UTEST_REAPER_THREADS];
+    int idx[CRINIT_UTEST_REAPER_THREADS];
+    for (int i = 0; i < CRINIT_UTEST_REAPER_THREADS; i++) {
+        idx[i] = i;
+        assert_int_equal(pthread_create(&threads[i], NULL, crinitReaperTestSpawnThread, &idx[i]), 0);
+    }
+    for (int i = 0; i < CRINIT_UTEST_REAPER_THREADS; i++) {
+        void *ret = &idx[i];
+        assert_int_equal(pthread_join(threads[i], &ret), 0);
+        assert_null(ret);
+    }
+}
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-failure.c
+ * @brief Unit test for crinitReaperSpawn() and crinitReaperWait(), error handling.
+ */
+
+#include <errno.h>
+
+#include "common.h"
+#include "reaper.h"
+#include "unit_test.h"
+#include "utest-reaper.h"
+
+void crinitReaperTestFailure(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char *const envp[] = {NULL};
+    char *const argv[] = {"/nonexistent/crinit-utest-reaper", NULL};
+    pid_t pid = -1;
+
+    assert_int_equal(crinitReaperSpawn(NULL, argv[0], NULL, NULL, argv, envp), -1);
+    assert_int_equal(crinitReaperSpawn(&pid, NULL, NULL, NULL, argv, envp), -1);
+    assert_int_equal(crinitReaperSpawn(&pid, argv[0], NULL, NULL, NULL, envp), -1);
+    assert_int_equal(crinitReaperSpawn(&pid, argv[0], NULL, NULL, argv, NULL), -1);
+
+    assert_int_equal(crinitReaperSpawn(&pid, argv[0], NULL, NULL, argv, envp), -1);
+    assert_int_equal(errno, ENOENT);
+
+    // PID 1 can never be a child process of the test.
+    assert_int_equal(crinitReaperWait(1, NULL, NULL), -1);
+    assert_int_equal(errno, ECHILD);
+}
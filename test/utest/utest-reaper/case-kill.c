@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-kill.c
+ * @brief Unit test for crinitReaperKill().
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "common.h"
+#include "reaper.h"
+#include "unit_test.h"
+#include "utest-reaper.h"
+
+void crinitReaperTestKill(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char *const envp[] = {NULL};
+    char *const argv[] = {CRINIT_UTEST_REAPER_SHELL, "-c", "while true; do :; done", NULL};
+    pid_t pid = -1;
+    siginfo_t status;
+    struct rusage ru;
+
+    assert_int_equal(crinitReaperSpawn(&pid, CRINIT_UTEST_REAPER_SHELL, NULL, NULL, argv, envp), 0);
+    assert_true(pid > 0);
+
+    assert_int_equal(crinitReaperKill(pid, SIGKILL), 0);
+    assert_int_equal(crinitReaperWait(pid, &status, &ru), 0);
+    assert_int_equal(status.si_pid, pid);
+    assert_int_equal(status.si_code, CLD_KILLED);
+    assert_int_equal(status.si_status, SIGKILL);
+    // The busy loop must have consumed some memory, the resource usage is reported along with the exit status.
+    assert_true(ru.ru_maxrss > 0);
+}
+
+void crinitReaperTestKillCollected(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char *const envp[] = {NULL};
+    char *const argv[] = {CRINIT_UTEST_REAPER_SHELL, "-c", "exit 0", NULL};
+    pid_t pid = -1;
+
+    assert_int_equal(crinitReaperSpawn(&pid, CRINIT_UTEST_REAPER_SHELL, NULL, NULL, argv, envp), 0);
+    assert_int_equal(crinitReaperWait(pid, NULL, NULL), 0);
+
+    // Collected but not yet released, the PID may already have been reused.
+    errno = 0;
+    assert_int_equal(crinitReaperKill(pid, 0), -1);
+    assert_int_equal(errno, ESRCH);
+
+    assert_int_equal(crinitReaperRelease(pid), 0);
+    assert_int_equal(crinitReaperRelease(pid), -1);
+    assert_int_equal(errno, ECHILD);
+
+    // Processes which are not children of ours are never signalled.
+    errno = 0;
+    assert_int_equal(crinitReaperKill(getppid(), 0), -1);
+    assert_int_equal(errno, ESRCH);
+}
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-orphan.c
+ * @brief Unit test for the reaping of child processes which are not watched by the reaper.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "reaper.h"
+#include "unit_test.h"
+#include "utest-reaper.h"
+
+/** Time to wait between checks if the child has been reaped. **/
+#define CRINIT_UTEST_REAPER_POLL_NS 10000000L
+/** Maximum number of checks if the child has been reaped. **/
+#define CRINIT_UTEST_REAPER_POLL_MAX 500
+
+void crinitReaperTestOrphan(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    pid_t pid = fork();
+    assert_true(pid != -1);
+    if (pid == 0) {
+        _exit(EXIT_SUCCESS);
+    }
+
+    // As soon as the reaper thread has reaped the child, it is no longer waitable by anyone else.
+    const struct timespec pollInterval = {.tv_sec = 0, .tv_nsec = CRINIT_UTEST_REAPER_POLL_NS};
+    int ret = 0;
+    for (int i = 0; i < CRINIT_UTEST_REAPER_POLL_MAX; i++) {
+        siginfo_t status = {0};
+        ret = waitid(P_PID, pid, &status, WEXITED | WNOHANG | WNOWAIT);
+        if (ret == -1) {
+            break;
+        }
+        nanosleep(&pollInterval, NULL);
+    }
+    assert_int_equal(ret, -1);
+    assert_int_equal(errno, ECHILD);
+}
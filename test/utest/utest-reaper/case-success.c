@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-success.c
+ * @brief Unit test for crinitReaperSpawn() and crinitReaperWait(), successful execution.
+ */
+
+#include <errno.h>
+#include <sys/wait.h>
+
+#include "common.h"
+#include "reaper.h"
+#include "unit_test.h"
+#include "utest-reaper.h"
+
+void crinitReaperTestSuccess(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char *const envp[] = {NULL};
+    char *const argvFail[] = {CRINIT_UTEST_REAPER_SHELL, "-c", "exit 3", NULL};
+    char *const argvOk[] = {CRINIT_UTEST_REAPER_SHELL, "-c", "exit 0", NULL};
+    pid_t pidFail = -1, pidOk = -1;
+    siginfo_t status;
+
+    assert_int_equal(crinitReaperSpawn(&pidFail, CRINIT_UTEST_REAPER_SHELL, NULL, NULL, argvFail, envp), 0);
+    assert_true(pidFail > 0);
+    assert_int_equal(crinitReaperSpawn(&pidOk, CRINIT_UTEST_REAPER_SHELL, NULL, NULL, argvOk, envp), 0);
+    assert_true(pidOk > 0);
+
+    // Collect in reverse order, both statuses must be kept regardless of which process terminates first.
+    assert_int_equal(crinitReaperWait(pidOk, &status, NULL), 0);
+    assert_int_equal(status.si_pid, pidOk);
+    assert_int_equal(status.si_code, CLD_EXITED);
+    assert_int_equal(status.si_status, 0);
+
+    assert_int_equal(crinitReaperWait(pidFail, &status, NULL), 0);
+    assert_int_equal(status.si_pid, pidFail);
+    assert_int_equal(status.si_code, CLD_EXITED);
+    assert_int_equal(status.si_status, 3);
+
+    // A process can only be collected once.
+    assert_int_equal(crinitReaperWait(pidFail, NULL, NULL), -1);
+    assert_int_equal(errno, ECHILD);
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file case-wait-all.c
+ * @brief Unit test for crinitReaperWaitAll().
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <time.h>
+
+#include "common.h"
+#include "reaper.h"
+#include "unit_test.h"
+#include "utest-reaper.h"
+
+/** Timeout in seconds for crinitReaperWaitAll() if the child processes terminate on their own. **/
+#define CRINIT_UTEST_REAPER_WAIT_ALL_TIMEOUT_S 10
+/** Timeout in nanoseconds for crinitReaperWaitAll() if a child process is still running. **/
+#define CRINIT_UTEST_REAPER_WAIT_ALL_SHORT_NS 50000000L
+
+void crinitReaperTestWaitAll(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+
+    char *const envp[] = {NULL};
+    char *const argvShort[] = {CRINIT_UTEST_REAPER_SHELL, "-c", "exit 0", NULL};
+    char *const argvLong[] = {CRINIT_UTEST_REAPER_SHELL, "-c", "while true; do :; done", NULL};
+    pid_t pidShort = -1, pidLong = -1;
+    siginfo_t status;
+    struct timespec deadline;
+
+    // Times out while a child is still running.
+    assert_int_equal(crinitReaperSpawn(&pidLong, CRINIT_UTEST_REAPER_SHELL, NULL, NULL, argvLong, envp), 0);
+    assert_int_equal(clock_gettime(CLOCK_MONOTONIC, &deadline), 0);
+    deadline.tv_nsec += CRINIT_UTEST_REAPER_WAIT_ALL_SHORT_NS;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    assert_int_equal(crinitReaperWaitAll(&deadline), -1);
+    assert_int_equal(errno, ETIMEDOUT);
+
+    // Returns well before the deadline once all children have terminated, exit statuses are kept.
+    assert_int_equal(crinitReaperSpawn(&pidShort, CRINIT_UTEST_REAPER_SHELL, NULL, NULL, argvShort, envp), 0);
+    assert_int_equal(crinitReaperKill(pidLong, SIGKILL), 0);
+    assert_int_equal(clock_gettime(CLOCK_MONOTONIC, &deadline), 0);
+    deadline.tv_sec += CRINIT_UTEST_REAPER_WAIT_ALL_TIMEOUT_S;
+    assert_int_equal(crinitReaperWaitAll(&deadline), 0);
+
+    assert_int_equal(crinitReaperWait(pidShort, &status, NULL), 0);
+    assert_int_equal(status.si_code, CLD_EXITED);
+    assert_int_equal(crinitReaperWait(pidLong, &status, NULL), 0);
+    assert_int_equal(status.si_code, CLD_KILLED);
+
+    // Nothing left to wait for.
+    assert_int_equal(crinitReaperWaitAll(&deadline), 0);
+    assert_int_equal(crinitReaperWaitAll(NULL), -1);
+}
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-reaper.c
+ * @brief Implementation of the unit test group for the reaper of child processes.
+ */
+
+#include "utest-reaper.h"
+
+#include "common.h"
+#include "reaper.h"
+#include "unit_test.h"
+
+/**
+ * Starts the reaper once for all tests of the group.
+ */
+static int crinitReaperTestGroupSetup(void **state) {
+    CRINIT_PARAM_UNUSED(state);
+    return crinitReaperInit();
+}
+
+/**
+ * Runs the unit test group for the reaper of child processes using the cmocka API.
+ */
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(crinitReaperTestSuccess),
+        cmocka_unit_test(crinitReaperTestKill),
+        cmocka_unit_test(crinitReaperTestKillCollected),
+        cmocka_unit_test(crinitReaperTestOrphan),
+        cmocka_unit_test(crinitReaperTestFailure),
+        cmocka_unit_test(crinitReaperTestWaitAll),
+        cmocka_unit_test(crinitReaperTestConcurrent),
+    };
+
+    return cmocka_run_group_tests(tests, crinitReaperTestGroupSetup, NULL);
+}
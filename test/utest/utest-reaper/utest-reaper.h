@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file utest-reaper.h
+ * @brief Header declaring the unit tests for the reaper of child processes.
+ */
+#ifndef __UTEST_REAPER_H__
+#define __UTEST_REAPER_H__
+
+/** Path of the shell used to run the child processes of the tests. **/
+#define CRINIT_UTEST_REAPER_SHELL "/bin/sh"
+
+/**
+ * Tests that the exit status of a spawned process is delivered by crinitReaperWait().
+ */
+void crinitReaperTestSuccess(void **state);
+/**
+ * Tests that crinitReaperKill() signals a running process and that the signal is reported by crinitReaperWait().
+ */
+void crinitReaperTestKill(void **state);
+/**
+ * Tests that crinitReaperKill() refuses to signal collected processes until they are released, and processes which are
+ * not children of Crinit.
+ */
+void crinitReaperTestKillCollected(void **state);
+/**
+ * Tests that child processes not spawned via crinitReaperSpawn() are reaped.
+ */
+void crinitReaperTestOrphan(void **state);
+/**
+ * Tests error handling of crinitReaperSpawn() and crinitReaperWait().
+ */
+void crinitReaperTestFailure(void **state);
+/**
+ * Tests that crinitReaperWaitAll() returns as soon as all child processes have terminated and times out otherwise.
+ */
+void crinitReaperTestWaitAll(void **state);
+/**
+ * Tests that exit statuses are delivered correctly while several threads spawn and wait for processes at the same time.
+ */
+void crinitReaperTestConcurrent(void **state);
+
+#endif /* __UTEST_REAPER_H__ */
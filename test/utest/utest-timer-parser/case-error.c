@@ -39,6 +39,19 @@ void crinitTimerParserTestError(void **state) {
         "somethin else",
         "*-",
         "yesterday",
+        "every:",
+        "every:0s",
+        "every:0ms0us",
+        "every:5x",
+        "every:-1s",
+        "every:1.5s",
+        "every:5m",
+        "every:1s 2s",
+        "every:366d1us",
+        "every:9999999999s",
+        "after:",
+        "every",
+        "every:after:1s",
     };
     for (size_t i = 0; i < ARRAY_SIZE(s); i++) {
         crinitCheckTimerParse(s[i]);
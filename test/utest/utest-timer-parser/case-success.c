@@ -30,6 +30,8 @@ static void crinitCheckTimer(crinitTimerDef_t *a, crinitTimerDef_t *b) {
     uint8_t wDayA = a->wDay & 0x7f;
     uint8_t wDayB = b->wDay & 0x7f;
     assert_int_equal(wDayA, wDayB);
+    assert_int_equal(a->intervalNs, b->intervalNs);
+    assert_int_equal(a->sinceArmed, b->sinceArmed);
 }
 
 static void crinitCheckTimerParse(char *s, crinitTimerDef_t *timer) {
@@ -243,4 +245,42 @@ void crinitTimerParserTestSuccess(void **state) {
     for (size_t i = 0; i < ARRAY_SIZE(s11); i++) {
         crinitCheckTimerParse(s11[i], &timer);
     }
+
+    crinitTimerSetDefault(&timer);
+    timer.intervalNs = 250000000;
+    char *s12[] = {
+        "every:250ms",
+        "EVERY:250MS",
+        "every:250000us",
+        "every:0s250ms",
+        "every:100ms150ms",
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(s12); i++) {
+        crinitCheckTimerParse(s12[i], &timer);
+    }
+
+    crinitTimerSetDefault(&timer);
+    timer.intervalNs = UINT64_C(5400) * 1000000000;
+    timer.sinceArmed = true;
+    char *s13[] = {
+        "after:5400",
+        "after:5400s",
+        "after:90min",
+        "after:1h30min",
+        "After:1H30MIN",
+        "after:1h29min60s",
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(s13); i++) {
+        crinitCheckTimerParse(s13[i], &timer);
+    }
+
+    crinitTimerSetDefault(&timer);
+    timer.intervalNs = CRINIT_TIMER_INTERVAL_MAX_NS;
+    char *s14[] = {
+        "every:366d",
+        "every:365d24h",
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(s14); i++) {
+        crinitCheckTimerParse(s14[i], &timer);
+    }
 }